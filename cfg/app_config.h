@@ -7,5 +7,12 @@
 #define _APP_CONFIG_H_
 
 #include "app_config_tasks_prio.h"
+#include "app_config_audio.h"
+#include "app_config_net.h"
+#include "app_config_bgserv.h"
+#include "app_config_msg.h"
+#include "app_config_buttons.h"
+#include "app_config_settings.h"
+#include "app_config_prof.h"
 
 #endif // _APP_CONFIG_H_
\ No newline at end of file
@@ -0,0 +1,40 @@
+/**************************************************************************//**
+* @file    app_config_audio.h
+* @brief   Config header file for the application audio.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_AUDIO_H_
+#define _APP_CONFIG_AUDIO_H_
+
+//------------------------------------------------------------------------------
+// Audio stream buffers pool (reserved once at the application init).
+#define APP_AUDIO_BUF_POOL_MEMORY           OS_MEM_RAM_EXT_SRAM
+// DMA-safe block alignment (bytes).
+#define APP_AUDIO_BUF_POOL_ALIGN            (32)
+// Pool classes { block size, blocks count } in ascending block size order.
+#define APP_AUDIO_BUF_POOL_CLASSES          { { 0x1000, 1 }, { 0x2400, 2 } }
+
+// MP3 codec (Helix decoder sources; the host build has none).
+#ifndef APP_AUDIO_CODEC_MP3_ENABLED
+#define APP_AUDIO_CODEC_MP3_ENABLED         (1)
+#endif // APP_AUDIO_CODEC_MP3_ENABLED
+
+// Player control: max file path/URL length (with the terminator).
+#define APP_MMPLAY_CTL_PATH_LEN             (128)
+// Player WAV output: max file path length (with the terminator).
+#define APP_AUDIO_OUT_PATH_LEN              (64)
+
+// Player EQ (cascaded biquads).
+// Filters state and the work buffer (CPU access only).
+#define APP_AUDIO_EQ_MEMORY                 OS_MEM_RAM_INT_CCM
+#define APP_AUDIO_EQ_BANDS_MAX              (8)
+// Frames per processing block (work buffer: x channels x 4 bytes).
+#define APP_AUDIO_EQ_BLOCK_FRAMES           (128)
+// Speaker correction preset is applied on the init.
+#define APP_AUDIO_EQ_PRESET_ENABLED         (0)
+// { type, frequency (Hz), Q (x100), gain (dB x10) }
+#define APP_AUDIO_EQ_PRESET                 { { AUDIO_EQ_BAND_LOW_SHELF,   120,    71,     30 }, \
+                                              { AUDIO_EQ_BAND_PEAK,        2500,   200,   -20 }, \
+                                              { AUDIO_EQ_BAND_HIGH_SHELF,  10000,  71,    -15 } }
+
+#endif // _APP_CONFIG_AUDIO_H_
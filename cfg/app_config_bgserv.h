@@ -0,0 +1,71 @@
+/**************************************************************************//**
+* @file    app_config_bgserv.h
+* @brief   Config header file for the application background services.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_BGSERV_H_
+#define _APP_CONFIG_BGSERV_H_
+
+//------------------------------------------------------------------------------
+// BgServ poll period while the work is pending (ms).
+#define APP_BGSERV_POLL_PERIOD              (10)
+
+// Media integrity index.
+#define APP_MEDIA_INDEX_MEMORY              OS_MEM_RAM_EXT_SRAM
+#define APP_MEDIA_INDEX_FILE                "1:/media.idx"
+// Directory scanned for the media files.
+#define APP_MEDIA_INDEX_DIR                 "1:"
+#define APP_MEDIA_INDEX_ITEMS_MAX           (64)
+#define APP_MEDIA_INDEX_PATH_LEN            (96)
+// Idle verification sequential read size.
+#define APP_MEDIA_INDEX_READ_SIZE           (0x4000)
+// Idle verification sweep period (ms).
+#define APP_MEDIA_INDEX_SWEEP_PERIOD        (60 * 60 * 1000)
+
+// Images verification (CRC32 trailer: the last 4 bytes of the image).
+#define APP_IMAGE_VERIFY_MEMORY             OS_MEM_HEAP_APP
+// File images read size.
+#define APP_IMAGE_VERIFY_CHUNK_SIZE         (0x4000)
+// Memory mapped images CRC block size.
+#define APP_IMAGE_VERIFY_BLOCK_SIZE         (0x10000)
+// Work time slice per step (ms).
+#define APP_IMAGE_VERIFY_SLICE_MS           (5)
+// Resume state file (saved on the power down).
+#define APP_IMAGE_VERIFY_STATE_FILE         "1:/imgvrfy.st"
+// Firmware image start (its size and CRC32 trailer are at the linker __checksum symbol).
+#define APP_IMAGE_VERIFY_FW_ADDR            (0x08000000)
+#define APP_IMAGE_VERIFY_UPDATE_FILE        "1:/update.bin"
+
+// Media files offline conversion.
+#define APP_MEDIA_CONVERT_MEMORY            OS_MEM_RAM_EXT_SRAM
+#define APP_MEDIA_CONVERT_PATH_LEN          (96)
+// Input read size (not above the PCM buffer size).
+#define APP_MEDIA_CONVERT_READ_SIZE         (0x2000)
+// Decoded PCM buffer size (at least 2 MP3 frames).
+#define APP_MEDIA_CONVERT_PCM_SIZE          (0x4800)
+// Output write size (multiple of the storage sector size).
+#define APP_MEDIA_CONVERT_WRITE_SIZE        (0x4000)
+// IMA ADPCM block size per channel.
+#define APP_MEDIA_CONVERT_ADPCM_BLOCK_SIZE  (512)
+// Work time slice per step (ms).
+#define APP_MEDIA_CONVERT_SLICE_MS          (20)
+
+// Deferred log (formatted by BgServ).
+// Records above the level are removed at compile time.
+#if (OS_DEBUG_ENABLED)
+#define APP_DLOG_LEVEL                      D_DEBUG
+#else
+#define APP_DLOG_LEVEL                      D_WARNING
+#endif //(OS_DEBUG_ENABLED)
+// Ring records count (power of 2, 32 bytes each).
+#define APP_DLOG_RECORDS_COUNT              (128)
+// Formatted line length.
+#define APP_DLOG_LINE_LEN                   (96)
+// Records formatted per step.
+#define APP_DLOG_STEP_RECORDS               (16)
+// Ring poll period (ms).
+#define APP_DLOG_DRAIN_PERIOD               (100)
+// Default module records rate limit (per second).
+#define APP_DLOG_RATE_DEFAULT               (50)
+
+#endif // _APP_CONFIG_BGSERV_H_
@@ -0,0 +1,28 @@
+/**************************************************************************//**
+* @file    app_config_buttons.h
+* @brief   Config header file for the application buttons.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_BUTTONS_H_
+#define _APP_CONFIG_BUTTONS_H_
+
+//------------------------------------------------------------------------------
+// Debounce timer period while any button is active (ms).
+#define APP_BUTTON_POLL_PERIOD              (5)
+// Level is stable after no edges for (ms).
+#define APP_BUTTON_DEBOUNCE_MS              (10)
+// Tamper input is edge only: further edges are ignored for (ms).
+#define APP_BUTTON_TAMPER_LOCK_MS           (100)
+// Long press and then repeat periods (ms).
+#define APP_BUTTON_LONG_MS                  (1000)
+#define APP_BUTTON_REPEAT_MS                (500)
+// Wakeup button hold time to power off (ms).
+#define APP_BUTTON_POWER_OFF_MS             (4000)
+
+//------------------------------------------------------------------------------
+// USB HID coalesced motion delivery period (ms). Button transitions are not delayed.
+#define APP_USB_HID_DELIVERY_MS             (20)
+// USB HID mice (pending states records).
+#define APP_USB_HID_MICE_MAX                (2)
+
+#endif // _APP_CONFIG_BUTTONS_H_
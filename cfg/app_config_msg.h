@@ -0,0 +1,15 @@
+/**************************************************************************//**
+* @file    app_config_msg.h
+* @brief   Config header file for the application messages.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_MSG_H_
+#define _APP_CONFIG_MSG_H_
+
+//------------------------------------------------------------------------------
+// Inter-task messages pool (reserved once at the application init).
+#define APP_MSG_POOL_MEMORY                 OS_MEM_HEAP_APP
+// Pool classes { payload size, blocks count } in ascending payload size order.
+#define APP_MSG_POOL_CLASSES                { { 32, 16 }, { 192, 4 } }
+
+#endif // _APP_CONFIG_MSG_H_
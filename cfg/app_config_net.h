@@ -0,0 +1,60 @@
+/**************************************************************************//**
+* @file    app_config_net.h
+* @brief   Config header file for the application network services.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_NET_H_
+#define _APP_CONFIG_NET_H_
+
+//------------------------------------------------------------------------------
+// NetServ sockets poll period (ms).
+#define APP_NETSERV_POLL_PERIOD             (5)
+
+// Network audio stream ingest.
+#define APP_NET_STREAM_BUF_MEMORY           OS_MEM_RAM_EXT_SRAM
+#define APP_NET_STREAM_BUF_SIZE             (0x10000)
+#define APP_NET_STREAM_RECV_CHUNK_SIZE      (0x800)
+#define APP_NET_STREAM_URL_LEN              (128)
+#define APP_NET_STREAM_CONNECT_TIMEOUT      (3000)
+// Stream start probed for the format detection.
+#define APP_NET_STREAM_PROBE_SIZE           (0x1000)
+#define APP_NET_STREAM_PROBE_TIMEOUT        (5000)
+// Jitter buffer target depth limits (ms).
+#define APP_NET_STREAM_DEPTH_MIN            (200)
+#define APP_NET_STREAM_DEPTH_MAX            (2000)
+// Byte rate assumed until the stream format is known (128 kbps).
+#define APP_NET_STREAM_BYTE_RATE_DEFAULT    (16000)
+
+// Binary control and telemetry protocol.
+#define APP_NET_CTRL_PORT                   (5000)
+#define APP_NET_CTRL_CLIENTS_MAX            (2)
+#define APP_NET_CTRL_RX_BUF_SIZE            (1024)
+#define APP_NET_CTRL_TX_BUF_SIZE            (2048)
+// Listen socket poll period while no client is connected (ms).
+#define APP_NET_CTRL_ACCEPT_POLL_PERIOD     (100)
+#define APP_NET_CTRL_TELEMETRY_PERIOD_MIN   (10)
+#define APP_NET_CTRL_TELEMETRY_BATCH_MAX    (8)
+
+// RTP/UDP L16 stream output.
+#define APP_RTP_SINK_MEMORY                 OS_MEM_RAM_EXT_SRAM
+#define APP_RTP_SINK_PACKETS                (24)
+#define APP_RTP_SINK_PAYLOAD_MAX            (1440)
+#define APP_RTP_SINK_PTIME_DEFAULT          (5)
+#define APP_RTP_SINK_PT_DYNAMIC             (96)
+#define APP_RTP_SINK_MCAST_TTL              (4)
+// Packets pacing poll period (ms).
+#define APP_RTP_SINK_POLL_PERIOD            (2)
+
+// File transfer service.
+#define APP_NET_FILE_PORT                   (5001)
+#define APP_NET_FILE_CLIENTS_MAX            (2)
+#define APP_NET_FILE_BUF_MEMORY             OS_MEM_RAM_EXT_SRAM
+#define APP_NET_FILE_TX_BUF_SIZE            (0x1000)
+#define APP_NET_FILE_CHUNK_SIZE             (0x400)
+#define APP_NET_FILE_PATH_LEN               (128)
+// Client credit limit (DATA frames).
+#define APP_NET_FILE_CREDIT_MAX             (64)
+// DATA frames per poll shared by all the transfers.
+#define APP_NET_FILE_POLL_CHUNKS_MAX        (4)
+
+#endif // _APP_CONFIG_NET_H_
@@ -0,0 +1,16 @@
+/**************************************************************************//**
+* @file    app_config_prof.h
+* @brief   Config header file for the application profiler.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_PROF_H_
+#define _APP_CONFIG_PROF_H_
+
+//------------------------------------------------------------------------------
+// Code regions profiler (no code if disabled).
+#define APP_PROF_ENABLED                    (OS_DEBUG_ENABLED)
+// Histogram: bin N counts the times of [2^(N + SHIFT), 2^(N + SHIFT + 1)) cycles.
+#define APP_PROF_HIST_BINS                  (16)
+#define APP_PROF_HIST_SHIFT                 (10)
+
+#endif // _APP_CONFIG_PROF_H_
@@ -0,0 +1,25 @@
+/**************************************************************************//**
+* @file    app_config_settings.h
+* @brief   Config header file for the application settings store.
+* @author  A. Filyanov
+******************************************************************************/
+#ifndef _APP_CONFIG_SETTINGS_H_
+#define _APP_CONFIG_SETTINGS_H_
+
+//------------------------------------------------------------------------------
+#define APP_SETTINGS_STORE_MEMORY           OS_MEM_RAM_EXT_SRAM
+// Binary log files (the newest valid one is used, the other is the compaction target).
+#define APP_SETTINGS_STORE_FILE_A           "1:/settings.0"
+#define APP_SETTINGS_STORE_FILE_B           "1:/settings.1"
+// In-RAM index size (power of 2).
+#define APP_SETTINGS_STORE_ITEMS_MAX        (64)
+// "Section/key" and value max length (with the terminator).
+#define APP_SETTINGS_STORE_KEY_LEN          (32)
+#define APP_SETTINGS_STORE_VALUE_LEN        (64)
+#define APP_SETTINGS_STORE_SUBSCRIBERS_MAX  (4)
+// Compaction: the log is larger than this and has more dead records than live ones.
+#define APP_SETTINGS_STORE_COMPACT_SIZE     (0x1000)
+// INI file ("config_file" environment variable) import max size.
+#define APP_SETTINGS_STORE_IMPORT_SIZE      (0x1000)
+
+#endif // _APP_CONFIG_SETTINGS_H_
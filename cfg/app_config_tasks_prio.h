@@ -10,13 +10,17 @@
 // runtime (initial) priority
 #define APP_PRIO_TASK_A_KO                   (80)
 #define APP_PRIO_TASK_B_KO                   (80)
-#define APP_PRIO_TASK_MMPLAY                 (100)
+#define APP_PRIO_TASK_MMPLAY                 (120)
+#define APP_PRIO_TASK_MMPLAY_CTL             (125)
 #define APP_PRIO_TASK_NETSERV                (110)
+#define APP_PRIO_TASK_BGSERV                 (10)
 
 // power priority
 #define APP_PRIO_PWR_TASK_A_KO               (OS_PWR_PRIO_DEFAULT + 5)
 #define APP_PRIO_PWR_TASK_B_KO               (OS_PWR_PRIO_DEFAULT + 3)
 #define APP_PRIO_PWR_TASK_MMPLAY             (OS_PWR_PRIO_DEFAULT + 7)
+#define APP_PRIO_PWR_TASK_MMPLAY_CTL         (OS_PWR_PRIO_DEFAULT + 7)
 #define APP_PRIO_PWR_TASK_NETSERV            (OS_PWR_PRIO_DEFAULT + 7)
+#define APP_PRIO_PWR_TASK_BGSERV             (OS_PWR_PRIO_DEFAULT + 1)
 
 #endif // _APP_CONFIG_TASKS_PRIO_H_
\ No newline at end of file
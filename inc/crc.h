@@ -0,0 +1,94 @@
+/***************************************************************************//**
+* @file    crc.h
+* @brief   Generic table driven CRC engine.
+* @author  A. Filyanov
+* @details Model is parameterised by width (8..32), polynomial, reflection and
+*          initial/final XOR. The register is 32-bit for every width: reflected
+*          models keep it right-aligned, normal ones left-aligned, so a single
+*          byte update form serves them all. Lookup tables are generated at
+*          compile time by CRC_TABLE_R()/CRC_TABLE_N().
+*******************************************************************************/
+#ifndef _CRC_H_
+#define _CRC_H_
+
+#if defined (__cplusplus)
+extern "C"
+{
+#endif
+
+#include "typedefs.h"
+
+//-----------------------------------------------------------------------------
+// Compile-time table generation.
+// Reflected register: poly is the reflected polynomial.
+#define CRC_STEP_R(c, p)        (((c) >> 1) ^ ((p) & (0U - ((c) & 1U))))
+// Normal register (left-aligned): poly is (polynomial << (32 - width)).
+#define CRC_STEP_N(c, p)        ((U32)((c) << 1) ^ ((p) & (0U - ((c) >> 31))))
+
+#define CRC_BYTE_R(c, p)        CRC_STEP_R(CRC_STEP_R(CRC_STEP_R(CRC_STEP_R(\
+                                CRC_STEP_R(CRC_STEP_R(CRC_STEP_R(CRC_STEP_R((U32)(c), p), p), p), p), p), p), p), p)
+#define CRC_BYTE_N(c, p)        CRC_STEP_N(CRC_STEP_N(CRC_STEP_N(CRC_STEP_N(\
+                                CRC_STEP_N(CRC_STEP_N(CRC_STEP_N(CRC_STEP_N((U32)(c) << 24, p), p), p), p), p), p), p), p)
+
+#define CRC_TABLE_4(f, p, i)    f((i) + 0, p), f((i) + 1, p), f((i) + 2, p), f((i) + 3, p)
+#define CRC_TABLE_16(f, p, i)   CRC_TABLE_4(f, p, (i) + 0),  CRC_TABLE_4(f, p, (i) + 4),\
+                                CRC_TABLE_4(f, p, (i) + 8),  CRC_TABLE_4(f, p, (i) + 12)
+#define CRC_TABLE_64(f, p, i)   CRC_TABLE_16(f, p, (i) + 0), CRC_TABLE_16(f, p, (i) + 16),\
+                                CRC_TABLE_16(f, p, (i) + 32),CRC_TABLE_16(f, p, (i) + 48)
+#define CRC_TABLE_256(f, p)     CRC_TABLE_64(f, p, 0),       CRC_TABLE_64(f, p, 64),\
+                                CRC_TABLE_64(f, p, 128),     CRC_TABLE_64(f, p, 192)
+
+/// @brief      Reflected model table initializer (256 x U32).
+#define CRC_TABLE_R(poly)       CRC_TABLE_256(CRC_BYTE_R, (U32)(poly))
+/// @brief      Normal model table initializer (256 x U32).
+#define CRC_TABLE_N(poly, width)CRC_TABLE_256(CRC_BYTE_N, ((U32)(poly) << (32 - (width))))
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    const U32*      table_p;
+    U32             (*update_fp)(U8* data_p, Size size, U32 crc); // Optional accelerated register update.
+    U32             init;
+    U32             xor_out;
+    U8              width;
+    Bool            is_reflected;
+} CrcModel;
+
+typedef struct {
+    const CrcModel* model_p;
+    U32             crc;                // Register.
+} CrcContext;
+
+extern const CrcModel crc_model_8;          // CRC-8/MAXIM (Dallas 1-Wire).
+extern const CrcModel crc_model_16_ccitt;   // CRC-16/CCITT-FALSE.
+extern const CrcModel crc_model_32;         // CRC-32 (IEEE 802.3), see crc32.h.
+extern const CrcModel crc_model_32c;        // CRC-32C (Castagnoli).
+
+/*****************************************************************************/
+/// @brief      Start CRC computation.
+/// @param[out] ctx_p      Context.
+/// @param[in]  model_p    Model.
+void            CrcInit(CrcContext* ctx_p, const CrcModel* model_p);
+
+/// @brief      Add data to CRC computation.
+/// @param[in]  ctx_p      Context.
+/// @param[in]  data_p     Input data.
+/// @param[in]  size       Input data size.
+void            CrcUpdate(CrcContext* ctx_p, U8* data_p, Size size);
+
+/// @brief      Get CRC of the data added.
+/// @param[in]  ctx_p      Context.
+/// @return     CRC.
+U32             CrcFinal(const CrcContext* ctx_p);
+
+/// @brief      CRC computation.
+/// @param[in]  model_p    Model.
+/// @param[in]  data_p     Input data.
+/// @param[in]  size       Input data size.
+/// @return     CRC.
+U32             CrcCompute(const CrcModel* model_p, U8* data_p, Size size);
+
+#if defined (__cplusplus)
+}
+#endif // __cplusplus
+
+#endif // _CRC_H_
@@ -16,7 +16,18 @@ extern "C"
 //-----------------------------------------------------------------------------
 #define CRC32_POLYNOMIAL        0xFFFFFFFFU
 
+typedef enum {
+    CRC32_IMPL_BYTEWISE,
+    CRC32_IMPL_SLICING_8,
+    CRC32_IMPL_PCLMUL,                  // Carry-less multiply folding (x86 host builds).
+    CRC32_IMPL_LAST
+} Crc32Impl;
+
 /*****************************************************************************/
+/// @brief      Init CRC32 (generate the slicing-by-8 tables).
+/// @details    CRC32 is byte-wise till the init.
+void            Crc32Init(void);
+
 /// @brief      CRC32 computation.
 /// @param[in]  data_p     Input data.
 /// @param[in]  size       Input data size.
@@ -30,6 +41,26 @@ U32             Crc32(U8* data_p, Size size);
 /// @return     CRC32.
 U32             Crc32Delta(U8* data_p, Size size, U32 init_poly);
 
+/// @brief      Combine CRC32 of two consecutive blocks.
+/// @param[in]  crc_1      First block CRC32 (as Crc32()).
+/// @param[in]  crc_2      Second block CRC32 (as Crc32()).
+/// @param[in]  size_2     Second block size.
+/// @return     CRC32 of the both blocks.
+U32             Crc32Combine(const U32 crc_1, const U32 crc_2, Size size_2);
+
+/// @brief      Is CRC32 implementation available.
+/// @param[in]  impl       Implementation.
+/// @return     Is available (the build and the CPU support it).
+Bool            Crc32ImplIsAvailable(const Crc32Impl impl);
+
+/// @brief      CRC32 delta computation by the implementation (tests, benchmarks).
+/// @param[in]  impl       Implementation.
+/// @param[in]  data_p     Input data.
+/// @param[in]  size       Input data size.
+/// @param[in]  init_poly  Input polynom.
+/// @return     CRC32 (init_poly if the implementation is not available).
+U32             Crc32DeltaImpl(const Crc32Impl impl, U8* data_p, Size size, U32 init_poly);
+
 #if defined (__cplusplus)
 }
 #endif // __cplusplus
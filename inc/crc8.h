@@ -1,6 +1,6 @@
 /***************************************************************************//**
 * @file    crc8.h
-* @brief   CRC8.
+* @brief   CRC8 (CRC-8/MAXIM).
 * @author  A. Filyanov
 *******************************************************************************/
 #ifndef _CRC8_H_
@@ -18,7 +18,7 @@ extern "C"
 /// @param[in]  data_p     Input data.
 /// @param[in]  size       Input data size.
 /// @return     CRC8.
-U8              Crc8(U8* data_p, U16 size);
+U8              Crc8(U8* data_p, Size size);
 
 /// @brief      CRC8 delta computation.
 /// @param[in]  value      Input value.
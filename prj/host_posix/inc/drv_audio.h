@@ -0,0 +1,41 @@
+/***************************************************************************//**
+* @file    drv_audio.h
+* @brief   Audio driver: the simulated output device (host POSIX port).
+* @author  A. Filyanov
+* @details The device "plays" a buffer part (the half in the circular DMA
+*          mode) when the DMA clock leaves it: the sink gets the part at that
+*          moment, so a part which was not refilled in time is played again.
+*******************************************************************************/
+#ifndef _DRV_AUDIO_H_
+#define _DRV_AUDIO_H_
+
+#include "os_common.h"
+#include "os_audio.h"
+
+#if (OS_AUDIO_ENABLED)
+//------------------------------------------------------------------------------
+typedef void    (*DrvAudioSinkFunc)(const U8* data_p, const Size size, void* args_p);
+
+typedef struct {
+    U32                         plays;          // OS_AudioPlay() calls.
+    U32                         parts;          // Played buffer parts.
+    U32                         stalls;         // Normal mode: the buffer ended before the next play.
+    U64                         bytes;
+} DrvAudioStats;
+
+//------------------------------------------------------------------------------
+/// @brief      Set the output sink (the played data consumer).
+/// @param[in]  func           Sink (OS_NULL - none).
+/// @param[in]  args_p         Sink arguments.
+void            DrvAudioSinkSet(const DrvAudioSinkFunc func, void* args_p);
+
+/// @brief      Get the output device statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          DrvAudioStatsGet(DrvAudioStats* stats_p);
+
+/// @brief      Reset the output device statistics.
+void            DrvAudioStatsReset(void);
+
+#endif //(OS_AUDIO_ENABLED)
+#endif // _DRV_AUDIO_H_
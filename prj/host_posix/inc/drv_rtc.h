@@ -0,0 +1,31 @@
+/***************************************************************************//**
+* @file    drv_rtc.h
+* @brief   RTC driver (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _DRV_RTC_H_
+#define _DRV_RTC_H_
+
+#include "os_driver.h"
+
+//------------------------------------------------------------------------------
+enum {
+    DRV_ID_RTC,
+    DRV_ID_RTC_LAST
+};
+
+enum {
+    DRV_REQ_RTC_UNDEF = DRV_REQ_STD_LAST,
+    // The tamper button edges are ignored while disabled.
+    DRV_REQ_BUTTON_TAMPER_DISABLE,
+    DRV_REQ_BUTTON_TAMPER_ENABLE,
+    DRV_REQ_RTC_BKUP_REG_WRITE,
+    DRV_REQ_RTC_LAST
+};
+
+typedef struct {
+    U32                         reg;
+    U32                         val;
+} HAL_RTC_BackupRegWrite;
+
+#endif // _DRV_RTC_H_
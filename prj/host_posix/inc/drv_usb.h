@@ -0,0 +1,29 @@
+/***************************************************************************//**
+* @file    drv_usb.h
+* @brief   USB driver: HID reports (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _DRV_USB_H_
+#define _DRV_USB_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+enum {
+    OS_USB_HID_MOUSE_BUTTON_LEFT,
+    OS_USB_HID_MOUSE_BUTTON_RIGHT,
+    OS_USB_HID_MOUSE_BUTTON_MIDDLE,
+    OS_USB_HID_MOUSE_BUTTON_LAST
+};
+
+typedef struct {
+    U8                          buttons_bm;
+    S16                         x;
+    S16                         y;
+} OS_UsbHidMouseData;
+
+// Mouse report handler given to the USB HID driver Open (ISR context); with no
+// handler the reports are posted as OS_MSG_USB_HID_MOUSE messages.
+typedef void (*OS_UsbHidMouseIsrHandler)(const U8 device, const OS_UsbHidMouseData* report_p);
+
+#endif // _DRV_USB_H_
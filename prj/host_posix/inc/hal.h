@@ -0,0 +1,87 @@
+/***************************************************************************//**
+* @file    hal.h
+* @brief   Hardware abstraction layer (host POSIX port).
+* @author  A. Filyanov
+* @details The board is simulated: the buttons edges are injected by
+*          HAL_HostButtonEdge(), the USB HID mouse reports by
+*          HAL_HostUsbHidMouseReport(), the LEDs levels are read back by
+*          HAL_HostLedLevelGet().
+*******************************************************************************/
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#include "os_common.h"
+#include "os_debug.h"
+#include "drv_usb.h"
+
+//------------------------------------------------------------------------------
+#define HAL_LOG(level, ...)         OS_LOG(level, __VA_ARGS__)
+#define HAL_ASSERT(e)               OS_ASSERT(e)
+#define HAL_DEBUG_PIN1_TOGGLE()     do {} while (0)
+
+//------------------------------------------------------------------------------
+typedef struct {
+    Status  (*Init)(void* args_p);
+    Status  (*DeInit)(void* args_p);
+    Status  (*Open)(void* args_p);
+    Status  (*Close)(void* args_p);
+    Status  (*Read)(void* data_in_p, Size size, void* args_p);
+    Status  (*Write)(void* data_out_p, Size size, void* args_p);
+    Status  (*IoCtl)(const U32 request_id, void* args_p);
+} HAL_DriverItf;
+
+enum {
+    DRV_ID_BUTTON_TAMPER,
+    DRV_ID_BUTTON_WAKEUP,
+    DRV_ID_BUTTON_LAST
+};
+
+enum {
+    DRV_ID_LED_USER,
+    DRV_ID_LED_LAST
+};
+
+enum {
+    DRV_ID_USB_HID_MOUSE,
+    DRV_ID_USB_HID_LAST
+};
+
+extern HAL_DriverItf* drv_button_v[];
+extern HAL_DriverItf* drv_led_v[];
+extern HAL_DriverItf* drv_usb_hid_v[];
+extern HAL_DriverItf* drv_rtc_v[];
+
+// System clock: the cycles are nanoseconds on the host.
+extern U32 SystemCoreClock;
+
+//------------------------------------------------------------------------------
+/// @brief      Init the hardware.
+/// @return     #Status.
+Status          HAL_Init_(void);
+
+/// @brief      Set memory (before the OS init).
+/// @param[in]  dst_p          Memory.
+/// @param[in]  value          Value.
+/// @param[in]  size           Size.
+/// @return     Memory.
+void*           HAL_MemSet(void* dst_p, const Int value, const Size size);
+
+/// @brief      Inject the button edge (host): the button ISR handler is called
+///             if the button is open.
+/// @param[in]  drv_id         Button (DRV_ID_BUTTON_*).
+/// @return     #Status.
+Status          HAL_HostButtonEdge(const U32 drv_id);
+
+/// @brief      Inject the USB HID mouse report (the driver ISR handler is
+///             called in the caller thread).
+/// @param[in]  device         Mouse index.
+/// @param[in]  report_p       Report.
+/// @return     #Status.
+Status          HAL_HostUsbHidMouseReport(const U8 device, const OS_UsbHidMouseData* report_p);
+
+/// @brief      Get the LED level (host).
+/// @param[in]  drv_id         LED (DRV_ID_LED_*).
+/// @return     Level.
+U8              HAL_HostLedLevelGet(const U32 drv_id);
+
+#endif // _HAL_H_
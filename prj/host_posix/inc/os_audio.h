@@ -0,0 +1,116 @@
+/***************************************************************************//**
+* @file    os_audio.h
+* @brief   OS audio devices (host POSIX port).
+* @author  A. Filyanov
+* @details The default output device is simulated: its DMA thread "plays"
+*          the buffer at the sample rate (see #OS_AUDIO_CLOCK_MUL_ENV) and
+*          calls the device callback on the buffer (halves) done as the DMA
+*          ISR does.
+*******************************************************************************/
+#ifndef _OS_AUDIO_H_
+#define _OS_AUDIO_H_
+
+#include "os_common.h"
+
+#if (OS_AUDIO_ENABLED)
+//------------------------------------------------------------------------------
+#define OS_AUDIO_VOLUME_MAX     (100)
+
+typedef struct OS_AudioDeviceCb* OS_AudioDeviceHd;
+typedef U8                      OS_AudioBits;
+typedef U8                      OS_AudioVolume;
+typedef U32                     OS_AudioSampleRate;
+
+typedef enum {
+    OS_AUDIO_CHANNELS_UNDEF,
+    OS_AUDIO_CHANNELS_MONO,
+    OS_AUDIO_CHANNELS_STEREO,
+    OS_AUDIO_CHANNELS_LAST
+} OS_AudioChannels;
+
+typedef enum {
+    OS_AUDIO_DMA_MODE_NORMAL,
+    OS_AUDIO_DMA_MODE_CIRCULAR,
+    OS_AUDIO_DMA_MODE_LAST
+} OS_AudioDmaMode;
+
+typedef struct {
+    OS_AudioSampleRate          sample_rate;
+    OS_AudioBits                sample_bits;
+    OS_AudioChannels            channels;
+} OS_AudioInfo;
+
+typedef struct {
+    OS_AudioInfo                info;
+    OS_AudioDmaMode             dma_mode;
+    OS_AudioVolume              volume;
+} OS_AudioDeviceIoSetupArgs;
+
+typedef struct {
+    OS_QueueHd                  slot_qhd;
+    OS_SignalId                 signal_id;      // OS_SIG_AUDIO_*
+} OS_AudioDeviceCallbackArgs;
+
+typedef struct {
+    OS_QueueHd                  slot_qhd;
+    void                        (*isr_callback_func)(OS_AudioDeviceCallbackArgs* args_p);
+} OS_AudioDeviceArgsOpen;
+
+//------------------------------------------------------------------------------
+/// @brief      Get the default audio device.
+/// @param[in]  dir            Direction (only #DIR_OUT on the host).
+/// @return     #OS_AudioDeviceHd (OS_NULL - none).
+OS_AudioDeviceHd OS_AudioDeviceDefaultGet(const Direction dir);
+
+/// @brief      Set up the audio device.
+/// @param[in]  dev_hd         Device.
+/// @param[in]  args_p         Arguments.
+/// @param[in]  dir            Direction.
+/// @return     #Status.
+Status          OS_AudioDeviceIoSetup(const OS_AudioDeviceHd dev_hd, const OS_AudioDeviceIoSetupArgs* args_p,
+                                      const Direction dir);
+
+/// @brief      Open the audio device.
+/// @param[in]  dev_hd         Device.
+/// @param[in]  args_p         Arguments (#OS_AudioDeviceArgsOpen).
+/// @return     #Status.
+Status          OS_AudioDeviceOpen(const OS_AudioDeviceHd dev_hd, void* args_p);
+
+/// @brief      Close the audio device (stopped).
+/// @param[in]  dev_hd         Device.
+/// @return     #Status.
+Status          OS_AudioDeviceClose(const OS_AudioDeviceHd dev_hd);
+
+/// @brief      Play the buffer (circular DMA mode: till the stop).
+/// @param[in]  dev_hd         Device.
+/// @param[in]  data_p         Buffer.
+/// @param[in]  size           Size.
+/// @return     #Status.
+Status          OS_AudioPlay(const OS_AudioDeviceHd dev_hd, void* data_p, const Size size);
+
+/// @brief      Pause the playback.
+/// @param[in]  dev_hd         Device.
+/// @return     #Status.
+Status          OS_AudioPause(const OS_AudioDeviceHd dev_hd);
+
+/// @brief      Resume the playback.
+/// @param[in]  dev_hd         Device.
+/// @return     #Status.
+Status          OS_AudioResume(const OS_AudioDeviceHd dev_hd);
+
+/// @brief      Stop the playback.
+/// @param[in]  dev_hd         Device.
+/// @return     #Status.
+Status          OS_AudioStop(const OS_AudioDeviceHd dev_hd);
+
+/// @brief      Get the output volume.
+/// @return     #OS_AudioVolume.
+OS_AudioVolume  OS_VolumeGet(void);
+
+/// @brief      Set the output volume.
+/// @param[in]  volume         Volume.
+/// @return     #Status.
+Status          OS_VolumeSet(const OS_AudioVolume volume);
+
+#endif //(OS_AUDIO_ENABLED)
+#endif // _OS_AUDIO_H_
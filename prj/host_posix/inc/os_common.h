@@ -0,0 +1,114 @@
+/***************************************************************************//**
+* @file    os_common.h
+* @brief   OS common definitions (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_COMMON_H_
+#define _OS_COMMON_H_
+
+#include "typedefs.h"
+#include "status.h"
+#include "os_config.h"
+
+//------------------------------------------------------------------------------
+// Time.
+typedef U32                     OS_TimeMs;
+typedef U32                     OS_Tick;
+
+#define OS_BLOCK                ((OS_TimeMs)U32_MAX)
+#define OS_NO_BLOCK             ((OS_TimeMs)0)
+// 1 ms tick.
+#define OS_TICKS_TO_MS(ticks)   (ticks)
+#define OS_MS_TO_TICKS(ms)      (ms)
+
+//------------------------------------------------------------------------------
+// Power.
+typedef enum {
+    PWR_UNDEF,
+    PWR_STARTUP,
+    PWR_ON,
+    PWR_OFF,
+    PWR_SLEEP,
+    PWR_STOP,
+    PWR_HIBERNATE,
+    PWR_SHUTDOWN,
+    PWR_LAST
+} OS_PowerState;
+
+typedef U8                      OS_PowerPrio;
+
+//------------------------------------------------------------------------------
+// Tasks and queues.
+typedef struct OS_TaskCb*       OS_TaskHd;
+typedef struct OS_QueueCb*      OS_QueueHd;
+
+//------------------------------------------------------------------------------
+// Messages.
+typedef U16                     OS_MessageId;
+typedef U32                     OS_MessageSrc;
+
+typedef struct {
+    OS_MessageId                id;
+    U16                         size;
+    OS_MessageSrc               src;
+    U8                          data[];
+} OS_Message;
+
+typedef enum {
+    OS_MSG_PRIO_LOW,
+    OS_MSG_PRIO_NORMAL,
+    OS_MSG_PRIO_HIGH
+} OS_MessagePrio;
+
+enum {
+    OS_MSG_UNDEF,
+    OS_MSG_SYS,
+    OS_MSG_USB_HID_MOUSE,
+    OS_MSG_USB_HID_KEYBOARD,
+    OS_MSG_APP = 0x100,
+};
+
+//------------------------------------------------------------------------------
+// Signals: the queue items with the signal tag (messages are aligned).
+typedef uintptr_t               OS_Signal;
+typedef U16                     OS_SignalId;
+typedef U32                     OS_SignalData;
+typedef U16                     OS_SignalSrc;
+
+enum {
+    OS_SIG_UNDEF,
+    OS_SIG_SYS,
+    OS_SIG_DRV,
+    OS_SIG_TIMER,
+    OS_SIG_EVENT,
+    OS_SIG_PWR,
+    OS_SIG_PWR_ACK,
+    OS_SIG_SHUTDOWN,
+    OS_SIG_REBOOT,
+    OS_SIG_AUDIO_TX_COMPLETE,
+    OS_SIG_AUDIO_TX_COMPLETE_HALF,
+    OS_SIG_AUDIO_RX_COMPLETE,
+    OS_SIG_AUDIO_RX_COMPLETE_HALF,
+    OS_SIG_AUDIO_ERROR,
+    OS_SIG_AUDIO_LAST,
+    OS_SIG_APP = 0x100,
+};
+
+//------------------------------------------------------------------------------
+// Memory and strings functions.
+void*           OS_MemSet(void* dst_p, const Int value, const Size size);
+void*           OS_MemCpy(void* dst_p, const void* src_p, const Size size);
+void*           OS_MemMov(void* dst_p, const void* src_p, const Size size);
+Int             OS_MemCmp(const void* buf1_p, const void* buf2_p, const Size size);
+
+Size            OS_StrLen(ConstStrP str_p);
+Int             OS_StrCmp(ConstStrP str1_p, ConstStrP str2_p);
+Int             OS_StrNCmp(ConstStrP str1_p, ConstStrP str2_p, const Size size);
+StrP            OS_StrCpy(StrP dst_p, ConstStrP src_p);
+StrP            OS_StrNCpy(StrP dst_p, ConstStrP src_p, const Size size);
+StrP            OS_StrCat(StrP dst_p, ConstStrP src_p);
+StrP            OS_StrChr(ConstStrP str_p, const Int c);
+StrP            OS_StrRChr(ConstStrP str_p, const Int c);
+U32             OS_StrToUL(ConstStrP str_p, StrP* end_pp, const Int base);
+
+#endif // _OS_COMMON_H_
@@ -0,0 +1,68 @@
+/***************************************************************************//**
+* @file    os_config.h
+* @brief   OS config (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_CONFIG_H_
+#define _OS_CONFIG_H_
+
+//------------------------------------------------------------------------------
+// Features.
+#define OS_DEBUG_ENABLED                    (1)
+#define OS_AUDIO_ENABLED                    (1)
+#define OS_NETWORK_ENABLED                  (1)
+#define OS_TEST_ENABLED                     (0)
+
+// Tasks.
+#define OS_TASK_NAME_LEN                    (16)
+#define OS_TASKS_MAX                        (16)
+#define OS_STACK_SIZE_MIN                   (256)
+#define OS_STDIN_LEN                        (16)
+// Supervisor queue length.
+#define OS_SV_STDIN_LEN                     (8)
+
+// Timeouts (ms).
+#define OS_TIMEOUT_DEFAULT                  (100)
+#define OS_TIMEOUT_MUTEX_LOCK               (100)
+
+// Power.
+#define OS_PWR_PRIO_DEFAULT                 (10)
+
+// Drivers.
+#define OS_DRIVER_NAME_LEN                  (8)
+#define OS_DRIVERS_MAX                      (8)
+
+// Timers.
+#define OS_TIMER_NAME_LEN                   (16)
+#define OS_TIMERS_MAX                       (16)
+
+// File system.
+#define OS_FILE_NAME_LEN                    (64)
+#define OS_FILE_PATH_LEN                    (256)
+#define OS_FILE_SYSTEM_WORD_ACCESS          (0)
+// Volumes root directory (the volume N: is the N subdirectory).
+#define OS_FILE_SYSTEM_ROOT_ENV             "DIOS_FS_ROOT"
+#define OS_FILE_SYSTEM_ROOT_DEFAULT         "./fs"
+
+// Shell.
+#define OS_SHELL_COMMANDS_MAX               (64)
+#define OS_SHELL_CL_LEN                     (256)
+#define OS_SHELL_ARGS_MAX                   (8)
+
+// Log (the level may be set by the environment).
+#define OS_LOG_LEVEL_ENV                    "DIOS_LOG_LEVEL"
+#define OS_LOG_LEVEL_DEFAULT                D_INFO
+
+// Memory heaps capacities (bytes) as on the target.
+#define OS_MEM_RAM_INT_SRAM_SIZE            (0x10000)
+#define OS_MEM_RAM_INT_CCM_SIZE             (0x10000)
+#define OS_MEM_RAM_EXT_SRAM_SIZE            (0x100000)
+#define OS_MEM_HEAP_SYS_SIZE                (0x8000)
+#define OS_MEM_HEAP_APP_SIZE                (0x18000)
+
+// Audio device: simulated DMA clock speed (x real-time, 1 and up).
+#define OS_AUDIO_CLOCK_MUL_ENV              "DIOS_AUDIO_CLOCK_MUL"
+#define OS_AUDIO_CLOCK_MUL_DEFAULT          (1)
+#define OS_AUDIO_VOLUME_DEFAULT             (100)
+
+#endif // _OS_CONFIG_H_
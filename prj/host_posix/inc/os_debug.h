@@ -0,0 +1,66 @@
+/***************************************************************************//**
+* @file    os_debug.h
+* @brief   OS debug: log and asserts (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_DEBUG_H_
+#define _OS_DEBUG_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+typedef enum {
+    D_NONE,
+    D_CRITICAL,
+    D_WARNING,
+    D_INFO,
+    D_DEBUG,
+    D_LAST
+} OS_LogLevel;
+
+// Module status items (a module redefines it for its own statuses).
+#define MDL_STATUS_ITEMS        OS_NULL
+
+//------------------------------------------------------------------------------
+#if (OS_DEBUG_ENABLED)
+#define OS_LOG(level, ...)      OS_Log(level, __FILE__, __VA_ARGS__)
+#define OS_LOG_S(level, s)      OS_LogS(level, __FILE__, __LINE__, s)
+#define OS_ASSERT(e)            do { if (!(e)) { OS_Assert(__FILE__, __LINE__, #e); } } while (0)
+#define OS_ASSERT_VALUE(e)      OS_ASSERT(e)
+#else
+#define OS_LOG(level, ...)      do {} while (0)
+#define OS_LOG_S(level, s)      ((void)(s))
+#define OS_ASSERT(e)            ((void)(e))
+#define OS_ASSERT_VALUE(e)      ((void)(e))
+#endif //(OS_DEBUG_ENABLED)
+
+//------------------------------------------------------------------------------
+/// @brief      Log the formatted record.
+/// @param[in]  level          Level (#OS_LogLevel).
+/// @param[in]  file_p         Source file.
+/// @param[in]  format_str_p   Format.
+void            OS_Log(const OS_LogLevel level, ConstStrP file_p, ConstStrP format_str_p, ...)
+                    __attribute__((format(printf, 3, 4)));
+
+/// @brief      Log the status.
+/// @param[in]  level          Level (#OS_LogLevel).
+/// @param[in]  file_p         Source file.
+/// @param[in]  line           Source line.
+/// @param[in]  s              Status.
+void            OS_LogS(const OS_LogLevel level, ConstStrP file_p, const U32 line, const Status s);
+
+/// @brief      Set the log level.
+/// @param[in]  level          Level (#OS_LogLevel).
+void            OS_LogLevelSet(const OS_LogLevel level);
+
+/// @brief      Get the log level.
+/// @return     #OS_LogLevel.
+OS_LogLevel     OS_LogLevelGet(void);
+
+/// @brief      Assertion failure: the process is aborted.
+/// @param[in]  file_p         Source file.
+/// @param[in]  line           Source line.
+/// @param[in]  expr_p         Expression.
+void            OS_Assert(ConstStrP file_p, const U32 line, ConstStrP expr_p) __attribute__((noreturn));
+
+#endif // _OS_DEBUG_H_
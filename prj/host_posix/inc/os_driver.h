@@ -0,0 +1,91 @@
+/***************************************************************************//**
+* @file    os_driver.h
+* @brief   OS drivers (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_DRIVER_H_
+#define _OS_DRIVER_H_
+
+#include "os_common.h"
+#include "hal.h"
+
+//------------------------------------------------------------------------------
+typedef struct OS_DriverCb*     OS_DriverHd;
+
+typedef struct {
+    ConstStrP                   name;
+    HAL_DriverItf*              itf_p;
+    OS_PowerPrio                prio_power;
+} OS_DriverConfig;
+
+// Driver requests (the drivers ones start at #DRV_REQ_STD_LAST).
+enum {
+    DRV_REQ_STD_UNDEF,
+    DRV_REQ_STD_POWER_SET,
+    DRV_REQ_STD_LAST = 0x100
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Create driver.
+/// @param[in]  cfg_p          Config.
+/// @param[out] dhd_p          Driver.
+/// @return     #Status.
+Status          OS_DriverCreate(const OS_DriverConfig* cfg_p, OS_DriverHd* dhd_p);
+
+/// @brief      Delete driver.
+/// @param[in]  dhd            Driver.
+/// @return     #Status.
+Status          OS_DriverDelete(const OS_DriverHd dhd);
+
+/// @brief      Init driver.
+/// @param[in]  dhd            Driver.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status (#S_INITED - already).
+Status          OS_DriverInit(const OS_DriverHd dhd, void* args_p);
+
+/// @brief      Deinit driver.
+/// @param[in]  dhd            Driver.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status (#S_INIT - not inited).
+Status          OS_DriverDeInit(const OS_DriverHd dhd, void* args_p);
+
+/// @brief      Open driver.
+/// @param[in]  dhd            Driver.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status.
+Status          OS_DriverOpen(const OS_DriverHd dhd, void* args_p);
+
+/// @brief      Close driver.
+/// @param[in]  dhd            Driver.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status (#S_INIT - not inited).
+Status          OS_DriverClose(const OS_DriverHd dhd, void* args_p);
+
+/// @brief      Read driver.
+/// @param[in]  dhd            Driver.
+/// @param[out] data_in_p      Data.
+/// @param[in]  size           Size.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status.
+Status          OS_DriverRead(const OS_DriverHd dhd, void* data_in_p, const Size size, void* args_p);
+
+/// @brief      Write driver.
+/// @param[in]  dhd            Driver.
+/// @param[in]  data_out_p     Data.
+/// @param[in]  size           Size.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status.
+Status          OS_DriverWrite(const OS_DriverHd dhd, void* data_out_p, const Size size, void* args_p);
+
+/// @brief      Driver IO control.
+/// @param[in]  dhd            Driver.
+/// @param[in]  request_id     Request.
+/// @param[in]  args_p         Arguments.
+/// @return     #Status.
+Status          OS_DriverIoCtl(const OS_DriverHd dhd, const U32 request_id, void* args_p);
+
+/// @brief      Get the system RTC driver.
+/// @return     #OS_DriverHd.
+OS_DriverHd     OS_DriverRtcGet(void);
+
+#endif // _OS_DRIVER_H_
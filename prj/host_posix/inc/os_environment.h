@@ -0,0 +1,24 @@
+/***************************************************************************//**
+* @file    os_environment.h
+* @brief   OS environment variables (host POSIX port).
+* @author  A. Filyanov
+* @details The variables are the process environment ones.
+*******************************************************************************/
+#ifndef _OS_ENVIRONMENT_H_
+#define _OS_ENVIRONMENT_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+/// @brief      Get variable value.
+/// @param[in]  name_p         Name.
+/// @return     Value (OS_NULL - undefined).
+ConstStrP       OS_EnvVariableGet(ConstStrP name_p);
+
+/// @brief      Set variable value.
+/// @param[in]  name_p         Name.
+/// @param[in]  value_p        Value.
+/// @return     #Status.
+Status          OS_EnvVariableSet(ConstStrP name_p, ConstStrP value_p);
+
+#endif // _OS_ENVIRONMENT_H_
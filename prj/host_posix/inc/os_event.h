@@ -0,0 +1,36 @@
+/***************************************************************************//**
+* @file    os_event.h
+* @brief   OS events: the data items bound to the event timers (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_EVENT_H_
+#define _OS_EVENT_H_
+
+#include "os_common.h"
+#include "os_timer.h"
+
+//------------------------------------------------------------------------------
+typedef struct {
+    void*                       data_p;
+    Size                        size;
+    void*                       mutex_p;
+} OS_EventItem;
+
+//------------------------------------------------------------------------------
+/// @brief      Get event item by the event timer id.
+/// @param[in]  timer_id       Timer id.
+/// @return     Item (OS_NULL - none).
+OS_EventItem*   OS_EventItemByTimerIdGet(const OS_TimerId timer_id);
+
+/// @brief      Lock event item.
+/// @param[in]  item_p         Item.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_EventItemLock(OS_EventItem* item_p, const OS_TimeMs timeout);
+
+/// @brief      Unlock event item.
+/// @param[in]  item_p         Item.
+/// @return     #Status.
+Status          OS_EventItemUnlock(OS_EventItem* item_p);
+
+#endif // _OS_EVENT_H_
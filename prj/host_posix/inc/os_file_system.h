@@ -0,0 +1,129 @@
+/***************************************************************************//**
+* @file    os_file_system.h
+* @brief   OS file system (host POSIX port).
+* @author  A. Filyanov
+* @details The volumes are the root directory subdirectories: the path
+*          "N:/dir/file" is "<root>/N/dir/file" (see #OS_FILE_SYSTEM_ROOT_ENV).
+*******************************************************************************/
+#ifndef _OS_FILE_SYSTEM_H_
+#define _OS_FILE_SYSTEM_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+typedef struct OS_FileCb*       OS_FileHd;
+typedef struct OS_DirCb*        OS_DirHd;
+typedef U32                     OS_FileOpenMode;
+
+enum {
+    OS_FS_FILE_OP_MODE_OPEN_EXISTS,
+    OS_FS_FILE_OP_MODE_OPEN_NEW,                // Open or create.
+    OS_FS_FILE_OP_MODE_CREATE_NEW,              // Fails if exists.
+    OS_FS_FILE_OP_MODE_CREATE_ALWAYS,           // Truncated if exists.
+    OS_FS_FILE_OP_MODE_READ,
+    OS_FS_FILE_OP_MODE_WRITE,
+    OS_FS_FILE_OP_MODE_LAST
+};
+
+enum {
+    OS_FS_FILE_ATTR_RDO     = BIT(0),
+    OS_FS_FILE_ATTR_HID     = BIT(1),
+    OS_FS_FILE_ATTR_SYS     = BIT(2),
+    OS_FS_FILE_ATTR_DIR     = BIT(4),
+    OS_FS_FILE_ATTR_ARC     = BIT(5),
+};
+
+typedef struct {
+    U32                         size;
+    U8                          attrs;
+    Str                         name[OS_FILE_NAME_LEN];
+} OS_FileStats;
+
+//------------------------------------------------------------------------------
+/// @brief      Open file.
+/// @param[out] fhd_p          File.
+/// @param[in]  path_p         Path.
+/// @param[in]  op_mode        Open mode (OS_FS_FILE_OP_MODE_* bits).
+/// @return     #Status.
+Status          OS_FileOpen(OS_FileHd* fhd_p, ConstStrP path_p, const OS_FileOpenMode op_mode);
+
+/// @brief      Close file.
+/// @param[in,out] fhd_p       File (OS_NULL on the return).
+/// @return     #Status.
+Status          OS_FileClose(OS_FileHd* fhd_p);
+
+/// @brief      Read file.
+/// @param[in]  fhd            File.
+/// @param[out] data_in_p      Data.
+/// @param[in]  size           Size.
+/// @return     #Status (#S_FS_EOF - the file ended before the size read).
+Status          OS_FileRead(const OS_FileHd fhd, void* data_in_p, const U32 size);
+
+/// @brief      Write file.
+/// @param[in]  fhd            File.
+/// @param[in]  data_out_p     Data.
+/// @param[in]  size           Size.
+/// @return     #Status.
+Status          OS_FileWrite(const OS_FileHd fhd, const void* data_out_p, const U32 size);
+
+/// @brief      Set file position.
+/// @param[in]  fhd            File.
+/// @param[in]  offset         Offset (from the file start).
+/// @return     #Status.
+Status          OS_FileLSeek(const OS_FileHd fhd, const U32 offset);
+
+/// @brief      Get file position.
+/// @param[in]  fhd            File.
+/// @return     Offset.
+U32             OS_FileTell(const OS_FileHd fhd);
+
+/// @brief      Get file size.
+/// @param[in]  fhd            File.
+/// @return     Size.
+U32             OS_FileSizeGet(const OS_FileHd fhd);
+
+/// @brief      Flush file.
+/// @param[in]  fhd            File.
+/// @return     #Status.
+Status          OS_FileSync(const OS_FileHd fhd);
+
+/// @brief      Truncate file at the position.
+/// @param[in]  fhd            File.
+/// @return     #Status.
+Status          OS_FileTruncate(const OS_FileHd fhd);
+
+/// @brief      Delete file.
+/// @param[in]  path_p         Path.
+/// @return     #Status.
+Status          OS_FileDelete(ConstStrP path_p);
+
+//------------------------------------------------------------------------------
+/// @brief      Open directory.
+/// @param[in]  path_p         Path.
+/// @param[out] dhd_p          Directory.
+/// @return     #Status.
+Status          OS_DirOpen(ConstStrP path_p, OS_DirHd* dhd_p);
+
+/// @brief      Close directory.
+/// @param[in]  dhd            Directory.
+/// @return     #Status.
+Status          OS_DirClose(const OS_DirHd dhd);
+
+/// @brief      Read directory item ("." and ".." are skipped).
+/// @param[in]  dhd            Directory.
+/// @param[out] stats_p        Item (the empty name - the end).
+/// @return     #Status.
+Status          OS_DirRead(const OS_DirHd dhd, OS_FileStats* stats_p);
+
+/// @brief      Create directory.
+/// @param[in]  path_p         Path.
+/// @return     #Status.
+Status          OS_DirCreate(ConstStrP path_p);
+
+/// @brief      Get the host path of the file system path (host).
+/// @param[in]  path_p         Path.
+/// @param[out] host_path_p    Host path (#OS_FILE_PATH_LEN).
+/// @return     #Status.
+Status          OS_FileSystemHostPathGet(ConstStrP path_p, StrP host_path_p);
+
+#endif // _OS_FILE_SYSTEM_H_
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+* @file    os_mailbox.h
+* @brief   OS messages and queues (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_MAILBOX_H_
+#define _OS_MAILBOX_H_
+
+#include "os_common.h"
+#include "os_signal.h"
+
+//------------------------------------------------------------------------------
+typedef struct {
+    Size                        len;            // Items (messages and signals).
+} OS_QueueConfig;
+
+typedef struct {
+    U32                         sends;
+    U32                         receives;
+    U32                         fails;          // Sends to the full queue.
+    U16                         depth_max;
+} OS_QueueStats;
+
+//------------------------------------------------------------------------------
+/// @brief      Create queue.
+/// @param[in]  cfg_p          Config.
+/// @param[in]  parent_thd     Owner task (OS_NULL - none).
+/// @param[out] qhd_p          Queue.
+/// @return     #Status.
+Status          OS_QueueCreate(const OS_QueueConfig* cfg_p, const OS_TaskHd parent_thd, OS_QueueHd* qhd_p);
+
+/// @brief      Delete queue (the queued messages are deleted).
+/// @param[in]  qhd            Queue.
+/// @return     #Status.
+Status          OS_QueueDelete(const OS_QueueHd qhd);
+
+/// @brief      Clear queue (the queued messages are deleted).
+/// @param[in]  qhd            Queue.
+/// @return     #Status.
+Status          OS_QueueClear(const OS_QueueHd qhd);
+
+/// @brief      Get queued items count.
+/// @param[in]  qhd            Queue.
+/// @return     Items count.
+U32             OS_QueueItemsCountGet(const OS_QueueHd qhd);
+
+/// @brief      Get queue statistics.
+/// @param[in]  qhd            Queue.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          OS_QueueStatsGet(const OS_QueueHd qhd, OS_QueueStats* stats_p);
+
+/// @brief      Reset queue statistics.
+/// @param[in]  qhd            Queue.
+void            OS_QueueStatsReset(const OS_QueueHd qhd);
+
+//------------------------------------------------------------------------------
+/// @brief      Create message (OS heap).
+/// @param[in]  id             Message id.
+/// @param[in]  size           Data size.
+/// @param[in]  timeout        Allocation timeout.
+/// @param[in]  data_p         Data (copied; OS_NULL - none).
+/// @return     Message or OS_NULL.
+OS_Message*     OS_MessageCreate(const OS_MessageId id, const Size size, const OS_TimeMs timeout, const void* data_p);
+
+/// @brief      Delete message.
+/// @param[in]  msg_p          Message.
+/// @return     #Status.
+Status          OS_MessageDelete(OS_Message* msg_p);
+
+/// @brief      Send message.
+/// @param[in]  qhd            Queue.
+/// @param[in]  msg_p          Message (the receiver deletes it).
+/// @param[in]  timeout        Full queue wait timeout.
+/// @param[in]  prio           Priority (#OS_MSG_PRIO_HIGH - to the queue front).
+/// @return     #Status.
+Status          OS_MessageSend(const OS_QueueHd qhd, const OS_Message* msg_p, const OS_TimeMs timeout,
+                               const OS_MessagePrio prio);
+
+/// @brief      Send message (ISR).
+/// @param[in]  qhd            Queue.
+/// @param[in]  msg_p          Message.
+/// @param[in]  prio           Priority.
+/// @return     1 - a higher priority task is woken, 0 - sent, -1 - the queue is full.
+Int             OS_ISR_MessageSend(const OS_QueueHd qhd, const OS_Message* msg_p, const OS_MessagePrio prio);
+
+/// @brief      Receive message or signal.
+/// @param[in]  qhd            Queue.
+/// @param[out] msg_pp         Message or signal (see OS_SignalIs()).
+/// @param[in]  timeout        Empty queue wait timeout.
+/// @return     #Status.
+Status          OS_MessageReceive(const OS_QueueHd qhd, OS_Message** msg_pp, const OS_TimeMs timeout);
+
+#endif // _OS_MAILBOX_H_
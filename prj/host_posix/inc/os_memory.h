@@ -0,0 +1,72 @@
+/***************************************************************************//**
+* @file    os_memory.h
+* @brief   OS memory: heaps and the memory functions (host POSIX port).
+* @author  A. Filyanov
+* @details Every memory type is a heap with the target capacity: the
+*          allocations are accounted against it (the block headers
+*          excluded), so an out of memory case comes at the same load as on
+*          the target.
+*******************************************************************************/
+#ifndef _OS_MEMORY_H_
+#define _OS_MEMORY_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+typedef enum {
+    OS_MEM_RAM_INT_SRAM,
+    OS_MEM_RAM_INT_CCM,
+    OS_MEM_RAM_EXT_SRAM,
+    OS_MEM_HEAP_SYS,
+    OS_MEM_HEAP_APP,
+    OS_MEM_LAST,
+    OS_MEM_UNDEF
+} OS_MemoryType;
+
+typedef struct {
+    ConstStrP                   name_p;
+    Size                        size;
+    Size                        used;
+    Size                        used_max;
+    U32                         allocs;
+    U32                         frees;
+    U32                         fails;
+} OS_MemoryStats;
+
+//------------------------------------------------------------------------------
+/// @brief      Init memory heaps.
+/// @return     #Status.
+Status          OS_MemoryInit(void);
+
+/// @brief      Allocate memory (system heap).
+/// @param[in]  size           Size.
+/// @return     Memory or OS_NULL.
+void*           OS_Malloc(const Size size);
+
+/// @brief      Free memory (system heap).
+/// @param[in]  addr_p         Memory.
+void            OS_Free(void* addr_p);
+
+/// @brief      Allocate memory.
+/// @param[in]  size           Size.
+/// @param[in]  mem_type       Memory type.
+/// @return     Memory or OS_NULL.
+void*           OS_MallocEx(const Size size, const OS_MemoryType mem_type);
+
+/// @brief      Free memory.
+/// @param[in]  addr_p         Memory.
+/// @param[in]  mem_type       Memory type (of the allocation).
+void            OS_FreeEx(void* addr_p, const OS_MemoryType mem_type);
+
+/// @brief      Get free memory size.
+/// @param[in]  mem_type       Memory type.
+/// @return     Size.
+Size            OS_MemoryFreeGet(const OS_MemoryType mem_type);
+
+/// @brief      Get memory statistics.
+/// @param[in]  mem_type       Memory type.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          OS_MemoryStatsGet(const OS_MemoryType mem_type, OS_MemoryStats* stats_p);
+
+#endif // _OS_MEMORY_H_
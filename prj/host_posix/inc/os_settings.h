@@ -0,0 +1,16 @@
+/***************************************************************************//**
+* @file    os_settings.h
+* @brief   OS settings (host POSIX port).
+* @author  A. Filyanov
+* @details The OS INI settings are not ported: the application settings
+*          store (settings_store.h) replaces them.
+*******************************************************************************/
+#ifndef _OS_SETTINGS_H_
+#define _OS_SETTINGS_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+#define OS_SETTINGS_VALUE_LEN   (64)
+
+#endif // _OS_SETTINGS_H_
@@ -0,0 +1,51 @@
+/***************************************************************************//**
+* @file    os_shell.h
+* @brief   OS shell (host POSIX port).
+* @author  A. Filyanov
+* @details The shell reads the command lines from stdin (OS_ShellStart()).
+*******************************************************************************/
+#ifndef _OS_SHELL_H_
+#define _OS_SHELL_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+typedef U32                     OS_ShellCommandOptions;
+
+enum {
+    OS_SHELL_OPT_UNDEF,
+    OS_SHELL_OPT_LAST
+};
+
+/// @brief      Command handler.
+/// @param[in]  argc           Arguments count.
+/// @param[in]  argv           Arguments (the command excluded).
+/// @return     #Status.
+typedef Status  (*OS_ShellCommandHandler)(const U32 argc, ConstStrP argv[]);
+
+typedef struct {
+    ConstStrP                   command;
+    ConstStrP                   help_brief;
+    ConstStrP                   help_detail;
+    OS_ShellCommandHandler      handler;
+    U8                          argc_min;
+    U8                          argc_max;
+    OS_ShellCommandOptions      options;
+} OS_ShellCommandConfig;
+
+//------------------------------------------------------------------------------
+/// @brief      Create (register) command.
+/// @param[in]  cfg_p          Config.
+/// @return     #Status.
+Status          OS_ShellCommandCreate(const OS_ShellCommandConfig* cfg_p);
+
+/// @brief      Execute command line.
+/// @param[in]  cl_p           Command line.
+/// @return     #Status.
+Status          OS_ShellCommandExecute(ConstStrP cl_p);
+
+/// @brief      Start the stdin shell (the end of stdin is the shutdown).
+/// @return     #Status.
+Status          OS_ShellStart(void);
+
+#endif // _OS_SHELL_H_
@@ -0,0 +1,64 @@
+/***************************************************************************//**
+* @file    os_signal.h
+* @brief   OS signals (host POSIX port).
+* @author  A. Filyanov
+* @details A signal is a queue item with no memory behind it: the tag bit
+*          (0), the source (1..15), the id (16..31) and the data (32..63).
+*******************************************************************************/
+#ifndef _OS_SIGNAL_H_
+#define _OS_SIGNAL_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+#define OS_SIGNAL_EMIT(qhd, signal, prio)   OS_SignalSend(qhd, signal, prio)
+
+//------------------------------------------------------------------------------
+/// @brief      Create signal.
+/// @param[in]  id             Signal id.
+/// @param[in]  data           Signal data.
+/// @return     #OS_Signal.
+OS_Signal       OS_SignalCreate(const OS_SignalId id, const OS_SignalData data);
+
+/// @brief      Create signal (ISR).
+/// @param[in]  src            Signal source.
+/// @param[in]  id             Signal id.
+/// @param[in]  data           Signal data.
+/// @return     #OS_Signal.
+OS_Signal       OS_ISR_SignalCreate(const OS_SignalSrc src, const OS_SignalId id, const OS_SignalData data);
+
+/// @brief      Send signal (no block).
+/// @param[in]  qhd            Queue.
+/// @param[in]  signal         Signal.
+/// @param[in]  prio           Priority (#OS_MSG_PRIO_HIGH - to the queue front).
+/// @return     #Status.
+Status          OS_SignalSend(const OS_QueueHd qhd, const OS_Signal signal, const OS_MessagePrio prio);
+
+/// @brief      Send signal (ISR).
+/// @param[in]  qhd            Queue.
+/// @param[in]  signal         Signal.
+/// @param[in]  prio           Priority.
+/// @return     1 - a higher priority task is woken, 0 - sent, -1 - the queue is full.
+Int             OS_ISR_SignalSend(const OS_QueueHd qhd, const OS_Signal signal, const OS_MessagePrio prio);
+
+/// @brief      Check the received item is a signal.
+/// @param[in]  msg_p          Received item.
+/// @return     Is signal.
+Bool            OS_SignalIs(const OS_Message* msg_p);
+
+/// @brief      Get signal id.
+/// @param[in]  msg_p          Received signal.
+/// @return     #OS_SignalId.
+OS_SignalId     OS_SignalIdGet(const OS_Message* msg_p);
+
+/// @brief      Get signal data.
+/// @param[in]  msg_p          Received signal.
+/// @return     #OS_SignalData.
+OS_SignalData   OS_SignalDataGet(const OS_Message* msg_p);
+
+/// @brief      Get signal source.
+/// @param[in]  msg_p          Received signal.
+/// @return     #OS_SignalSrc.
+OS_SignalSrc    OS_SignalSrcGet(const OS_Message* msg_p);
+
+#endif // _OS_SIGNAL_H_
@@ -0,0 +1,18 @@
+/***************************************************************************//**
+* @file    os_startup.h
+* @brief   OS startup tasks (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_STARTUP_H_
+#define _OS_STARTUP_H_
+
+#include "os_common.h"
+#include "os_task.h"
+
+//------------------------------------------------------------------------------
+/// @brief      Add task to create at the scheduler start.
+/// @param[in]  cfg_p          Task config.
+/// @return     #Status.
+Status          OS_StartupTaskAdd(const OS_TaskConfig* cfg_p);
+
+#endif // _OS_STARTUP_H_
@@ -0,0 +1,39 @@
+/***************************************************************************//**
+* @file    os_supervise.h
+* @brief   OS supervisor (host POSIX port).
+* @author  A. Filyanov
+* @details The supervisor runs in the OS_SchedulerStart() caller thread and
+*          serves the system power requests (#OS_SIG_SHUTDOWN).
+*******************************************************************************/
+#ifndef _OS_SUPERVISE_H_
+#define _OS_SUPERVISE_H_
+
+#include "os_common.h"
+#include "os_task.h"
+
+//------------------------------------------------------------------------------
+/// @brief      Get supervisor stdin queue.
+/// @return     #OS_QueueHd.
+OS_QueueHd      OS_TaskSvStdInGet(void);
+
+/// @brief      Get system power state.
+/// @return     #OS_PowerState.
+OS_PowerState   OS_PowerStateGet(void);
+
+/// @brief      Set system power state (the tasks power callbacks are called).
+/// @param[in]  state          Power state.
+/// @return     #Status.
+Status          OS_PowerStateSet(const OS_PowerState state);
+
+/// @brief      Force context switch.
+void            OS_ContextSwitchForce(void);
+
+/// @brief      Start scheduler: the startup tasks are created and run (the
+///             supervisor loop; returns on the shutdown).
+void            OS_SchedulerStart(void);
+
+/// @brief      Check the scheduler is started (host).
+/// @return     Is started.
+Bool            OS_SchedulerIsRunning(void);
+
+#endif // _OS_SUPERVISE_H_
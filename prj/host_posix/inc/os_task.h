@@ -0,0 +1,117 @@
+/***************************************************************************//**
+* @file    os_task.h
+* @brief   OS tasks (host POSIX port).
+* @author  A. Filyanov
+* @details A task is a thread with the stdin queue. The power callback runs in
+*          the thread that changes the power state, with the task current
+*          (#OS_THIS_TASK). The priorities are not applied on the host.
+*******************************************************************************/
+#ifndef _OS_TASK_H_
+#define _OS_TASK_H_
+
+#include "os_common.h"
+#include "os_time.h"
+#include "os_signal.h"
+#include "os_mailbox.h"
+
+//------------------------------------------------------------------------------
+#define OS_THIS_TASK            OS_NULL
+
+typedef U8                      OS_TaskPrio;
+typedef U32                     OS_TaskAttrs;
+
+enum {
+    OS_TASK_ATTR_RECREATE,
+    OS_TASK_ATTR_SINGLE,
+    OS_TASK_ATTR_LAST
+};
+
+typedef enum {
+    OS_STDIO_IN,
+    OS_STDIO_OUT,
+    OS_STDIO_LAST
+} OS_StdIo;
+
+typedef struct {
+    void*                       args_p;         // OS_TaskCreate() arguments.
+    void*                       stor_p;         // Task storage (zeroed).
+} OS_TaskArgs;
+
+typedef struct {
+    ConstStrP                   name;
+    void                        (*func_main)(OS_TaskArgs* args_p);
+    Status                      (*func_power)(OS_TaskArgs* args_p, const OS_PowerState state);
+    void*                       args_p;
+    OS_TaskAttrs                attrs;
+    U32                         timeout;
+    OS_TaskPrio                 prio_init;
+    OS_PowerPrio                prio_power;
+    Size                        storage_size;
+    Size                        stack_size;
+    Size                        stdin_len;
+} OS_TaskConfig;
+
+//------------------------------------------------------------------------------
+//Task module functions (every task module defines them; the app is built with
+//-Wno-unused-function for the rest of the modules).
+static Status   OS_TaskInit(OS_TaskArgs* args_p);
+static void     OS_TaskMain(OS_TaskArgs* args_p);
+static Status   OS_TaskPower(OS_TaskArgs* args_p, const OS_PowerState state);
+
+//------------------------------------------------------------------------------
+/// @brief      Create task.
+/// @param[in]  args_p         Arguments (OS_NULL - the config ones).
+/// @param[in]  cfg_p          Config.
+/// @param[out] thd_p          Task (OS_NULL - not needed).
+/// @return     #Status.
+Status          OS_TaskCreate(const void* args_p, const OS_TaskConfig* cfg_p, OS_TaskHd* thd_p);
+
+/// @brief      Delete task.
+/// @param[in]  thd            Task (#OS_THIS_TASK - the caller; does not return).
+/// @return     #Status.
+Status          OS_TaskDelete(const OS_TaskHd thd);
+
+/// @brief      Delay the caller task.
+/// @param[in]  timeout        Delay.
+void            OS_TaskDelay(const OS_TimeMs timeout);
+
+/// @brief      Yield the caller task.
+void            OS_TaskYield(void);
+
+/// @brief      Get the caller task.
+/// @return     #OS_TaskHd (OS_NULL - not a task).
+OS_TaskHd       OS_TaskGet(void);
+
+/// @brief      Get task by name.
+/// @param[in]  name_p         Name.
+/// @return     #OS_TaskHd (OS_NULL - none).
+OS_TaskHd       OS_TaskByNameGet(ConstStrP name_p);
+
+/// @brief      Get task name.
+/// @param[in]  thd            Task.
+/// @return     Name.
+ConstStrP       OS_TaskNameGet(const OS_TaskHd thd);
+
+/// @brief      Get task stdin queue.
+/// @param[in]  thd            Task.
+/// @return     #OS_QueueHd.
+OS_QueueHd      OS_TaskStdInGet(const OS_TaskHd thd);
+
+/// @brief      Get task stdio queue.
+/// @param[in]  thd            Task.
+/// @param[in]  stdio          Stream.
+/// @return     #OS_QueueHd (the tasks have no stdout on the host).
+OS_QueueHd      OS_TaskStdIoGet(const OS_TaskHd thd, const OS_StdIo stdio);
+
+/// @brief      Set task priority (ignored on the host).
+/// @param[in]  thd            Task.
+/// @param[in]  prio           Priority.
+/// @return     #Status.
+Status          OS_TaskPrioritySet(const OS_TaskHd thd, const OS_TaskPrio prio);
+
+/// @brief      Get task CPU time (host).
+/// @param[in]  thd            Task.
+/// @return     CPU time (us).
+U64             OS_TaskCpuTimeGet(const OS_TaskHd thd);
+
+#endif // _OS_TASK_H_
@@ -0,0 +1,13 @@
+/***************************************************************************//**
+* @file    os_task_audio.h
+* @brief   OS audio task interface (host POSIX port).
+* @author  A. Filyanov
+* @details The audio devices are served by the device DMA thread on the host:
+*          no audio system task.
+*******************************************************************************/
+#ifndef _OS_TASK_AUDIO_H_
+#define _OS_TASK_AUDIO_H_
+
+#include "os_audio.h"
+
+#endif // _OS_TASK_AUDIO_H_
@@ -0,0 +1,20 @@
+/***************************************************************************//**
+* @file    os_time.h
+* @brief   OS time (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_TIME_H_
+#define _OS_TIME_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+/// @brief      Get the system tick count (1 ms, from the OS init).
+/// @return     #OS_Tick.
+OS_Tick         OS_TickCountGet(void);
+
+/// @brief      Get the system time (us, from the OS init).
+/// @return     Time.
+U64             OS_TimeUsGet(void);
+
+#endif // _OS_TIME_H_
@@ -0,0 +1,81 @@
+/***************************************************************************//**
+* @file    os_timer.h
+* @brief   OS timers (host POSIX port).
+* @author  A. Filyanov
+* @details The timers expire in the timer thread: the signal #OS_SIG_TIMER
+*          (#OS_SIG_EVENT for the event timers) with the timer id as the
+*          data is sent to the timer slot without blocking.
+*******************************************************************************/
+#ifndef _OS_TIMER_H_
+#define _OS_TIMER_H_
+
+#include "os_common.h"
+
+//------------------------------------------------------------------------------
+typedef struct OS_TimerCb*      OS_TimerHd;
+typedef U32                     OS_TimerId;
+typedef U32                     OS_TimerOptions;
+
+enum {
+    OS_TIM_OPT_PERIODIC,
+    OS_TIM_OPT_EVENT,
+    OS_TIM_OPT_LAST
+};
+
+typedef struct {
+    ConstStrP                   name_p;
+    OS_QueueHd                  slot;
+    OS_TimerId                  id;
+    OS_TimeMs                   period;
+    OS_TimerOptions             options;
+} OS_TimerConfig;
+
+//------------------------------------------------------------------------------
+/// @brief      Create timer (stopped).
+/// @param[in]  cfg_p          Config.
+/// @param[out] timer_hd_p     Timer.
+/// @return     #Status.
+Status          OS_TimerCreate(const OS_TimerConfig* cfg_p, OS_TimerHd* timer_hd_p);
+
+/// @brief      Delete timer.
+/// @param[in]  timer_hd       Timer.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TimerDelete(const OS_TimerHd timer_hd, const OS_TimeMs timeout);
+
+/// @brief      Start timer (the period is restarted).
+/// @param[in]  timer_hd       Timer.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TimerStart(const OS_TimerHd timer_hd, const OS_TimeMs timeout);
+
+/// @brief      Stop timer.
+/// @param[in]  timer_hd       Timer.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TimerStop(const OS_TimerHd timer_hd, const OS_TimeMs timeout);
+
+/// @brief      Reset timer (started).
+/// @param[in]  timer_hd       Timer.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TimerReset(const OS_TimerHd timer_hd, const OS_TimeMs timeout);
+
+/// @brief      Set timer period (started).
+/// @param[in]  timer_hd       Timer.
+/// @param[in]  period         Period.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TimerPeriodSet(const OS_TimerHd timer_hd, const OS_TimeMs period, const OS_TimeMs timeout);
+
+/// @brief      Get timer id.
+/// @param[in]  timer_hd       Timer.
+/// @return     #OS_TimerId.
+OS_TimerId      OS_TimerIdGet(const OS_TimerHd timer_hd);
+
+/// @brief      Check the timer is started.
+/// @param[in]  timer_hd       Timer.
+/// @return     Is started.
+Bool            OS_TimerIsActive(const OS_TimerHd timer_hd);
+
+#endif // _OS_TIMER_H_
@@ -0,0 +1,52 @@
+/***************************************************************************//**
+* @file    os_trigger.h
+* @brief   OS triggers: the event timers with the data items (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_TRIGGER_H_
+#define _OS_TRIGGER_H_
+
+#include "os_common.h"
+#include "os_event.h"
+
+//------------------------------------------------------------------------------
+typedef OS_EventItem            OS_TriggerItem;
+typedef struct OS_TriggerCb*    OS_TriggerHd;
+
+typedef enum {
+    OS_TRIGGER_STATE_UNDEF,
+    OS_TRIGGER_STATE_LAST
+} OS_TriggerState;
+
+typedef struct {
+    const OS_TimerConfig*       timer_cfg_p;    // Event timer (#OS_TIM_OPT_EVENT is set).
+    OS_TriggerItem*             item_p;
+    OS_TriggerState             state;
+} OS_TriggerConfig;
+
+//------------------------------------------------------------------------------
+/// @brief      Create trigger item.
+/// @param[in]  data_p         Data (not copied).
+/// @param[in]  size           Data size.
+/// @param[out] item_pp        Item.
+/// @return     #Status.
+Status          OS_TriggerItemCreate(void* data_p, const Size size, OS_TriggerItem** item_pp);
+
+/// @brief      Delete trigger item.
+/// @param[in]  item_p         Item.
+/// @return     #Status.
+Status          OS_TriggerItemDelete(OS_TriggerItem* item_p);
+
+/// @brief      Create trigger (the timer is started).
+/// @param[in]  cfg_p          Config.
+/// @param[out] trigger_hd_p   Trigger.
+/// @return     #Status.
+Status          OS_TriggerCreate(const OS_TriggerConfig* cfg_p, OS_TriggerHd* trigger_hd_p);
+
+/// @brief      Delete trigger (the item is not deleted).
+/// @param[in]  trigger_hd     Trigger.
+/// @param[in]  timeout        Timeout.
+/// @return     #Status.
+Status          OS_TriggerDelete(const OS_TriggerHd trigger_hd, const OS_TimeMs timeout);
+
+#endif // _OS_TRIGGER_H_
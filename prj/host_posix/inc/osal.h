@@ -0,0 +1,20 @@
+/***************************************************************************//**
+* @file    osal.h
+* @brief   OS abstraction layer (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OSAL_H_
+#define _OSAL_H_
+
+#include "os_common.h"
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_time.h"
+#include "os_task.h"
+
+//------------------------------------------------------------------------------
+/// @brief      Init the OS.
+/// @return     #Status.
+Status          OSAL_Init(void);
+
+#endif // _OSAL_H_
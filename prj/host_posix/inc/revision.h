@@ -0,0 +1,17 @@
+/***************************************************************************//**
+* @file    revision.h
+* @brief   Build revision (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _REVISION_H_
+#define _REVISION_H_
+
+//------------------------------------------------------------------------------
+#ifndef BUILD
+#define BUILD                   0
+#endif // BUILD
+#ifndef REVISION
+#define REVISION                "host"
+#endif // REVISION
+
+#endif // _REVISION_H_
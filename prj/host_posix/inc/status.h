@@ -0,0 +1,66 @@
+/***************************************************************************//**
+* @file    status.h
+* @brief   Status codes (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _STATUS_H_
+#define _STATUS_H_
+
+#include "typedefs.h"
+
+//------------------------------------------------------------------------------
+typedef S32 Status;
+
+/// @brief   Status codes.
+/// @details Modules codes start at #S_MODULE (see MDL_STATUS_ITEMS).
+enum {
+    S_OK,
+    S_UNDEF,
+    S_INIT,
+    S_INITED,
+    S_INVALID_PTR,
+    S_INVALID_SIZE,
+    S_INVALID_VALUE,
+    S_INVALID_STATE,
+    S_INVALID_SIGNAL,
+    S_INVALID_MESSAGE,
+    S_INVALID_QUEUE,
+    S_INVALID_TASK,
+    S_INVALID_TIMER,
+    S_INVALID_DRIVER,
+    S_INVALID_REQ_ID,
+    S_INVALID_ARG,
+    S_INVALID_COMMAND,
+    S_OUT_OF_MEMORY,
+    S_TIMEOUT,
+    S_OVERFLOW,
+    S_BUSY,
+    S_HARDWARE_ERROR,
+    S_UNDEF_MSG,
+    S_UNDEF_SIG,
+    S_UNDEF_REQ_ID,
+    S_UNDEF_COMMAND,
+    S_FS_EOF,
+    S_FS_UNDEF,
+    S_FS_NO_FILE,
+    S_FS_EXIST,
+    S_FS_DENIED,
+    S_APP_MODULE,
+    S_LAST,
+    S_MODULE = 0x80
+};
+
+typedef struct {
+    ConstStrP                   str;
+} StatusItem;
+
+//------------------------------------------------------------------------------
+#define IF_OK(s)                if (S_OK == (s))
+#define IF_STATUS(s)            if (S_OK != (s))
+
+/// @brief      Get the OS status description.
+/// @param[in]  s              Status.
+/// @return     Description (OS_NULL - a module status).
+ConstStrP       StatusStringGet(const Status s);
+
+#endif // _STATUS_H_
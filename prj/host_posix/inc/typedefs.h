@@ -0,0 +1,73 @@
+/***************************************************************************//**
+* @file    typedefs.h
+* @brief   Common type definitions (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _TYPEDEFS_H_
+#define _TYPEDEFS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+typedef uint8_t                 U8;
+typedef uint16_t                U16;
+typedef uint32_t                U32;
+typedef uint64_t                U64;
+typedef int8_t                  S8;
+typedef int16_t                 S16;
+typedef int32_t                 S32;
+typedef int64_t                 S64;
+typedef size_t                  Size;
+typedef int                     Int;
+typedef unsigned int            UInt;
+typedef U8                      Bool;
+typedef float                   Float;
+typedef double                  Double;
+typedef char                    Str;
+typedef char*                   StrP;
+typedef const char              ConstStr;
+typedef const char*             ConstStrP;
+
+typedef enum {
+    OFF,
+    ON
+} State;
+
+typedef enum {
+    DIR_IN,
+    DIR_OUT
+} Direction;
+
+typedef struct {
+    U8                          maj;
+    U8                          min;
+    U16                         bld;
+    ConstStrP                   rev;
+    U8                          lbl;
+} Version;
+
+//------------------------------------------------------------------------------
+#define OS_NULL                 ((void*)0)
+#define OS_TRUE                 (1)
+#define OS_FALSE                (0)
+
+#define U8_MAX                  UINT8_MAX
+#define U16_MAX                 UINT16_MAX
+#define U32_MAX                 UINT32_MAX
+#define S8_MAX                  INT8_MAX
+#define S8_MIN                  INT8_MIN
+#define S16_MAX                 INT16_MAX
+#define S16_MIN                 INT16_MIN
+#define S32_MAX                 INT32_MAX
+#define S32_MIN                 INT32_MIN
+
+#define BIT(b)                  (1UL << (b))
+#define BIT_TEST(v, m)          ((v) & (m))
+#define BIT_SET(v, m)           ((v) |= (m))
+#define BIT_CLEAR(v, m)         ((v) &= ~(m))
+#define BIT_SHIFT_LEFT(v, n)    ((v) << (n))
+#define BIT_SHIFT_RIGHT(v, n)   ((v) >> (n))
+#define ITEMS_COUNT_GET(a, t)   (sizeof(a) / sizeof(t))
+
+#endif // _TYPEDEFS_H_
@@ -0,0 +1,196 @@
+/***************************************************************************//**
+* @file    hal.c
+* @brief   HAL: the simulated buttons, LED and RTC (host POSIX port).
+* @author  A. Filyanov
+* @details The button edges are injected by HAL_HostButtonEdge() and the USB
+*          HID mouse reports by HAL_HostUsbHidMouseReport(): the ISR handler
+*          given to the driver Open is called in the caller thread.
+*******************************************************************************/
+#include <string.h>
+#include "hal.h"
+#include "drv_rtc.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "hal"
+
+#define RTC_BKUP_REGS_COUNT     20
+
+typedef void (*ButtonIsrHandler)(void);
+
+//------------------------------------------------------------------------------
+static Status   ButtonTamperOpen(void* args_p);
+static Status   ButtonTamperClose(void* args_p);
+static Status   ButtonWakeupOpen(void* args_p);
+static Status   ButtonWakeupClose(void* args_p);
+static Status   UsbHidMouseOpen(void* args_p);
+static Status   UsbHidMouseClose(void* args_p);
+static Status   LedUserWrite(void* data_out_p, Size size, void* args_p);
+static Status   RtcIoCtl(const U32 request_id, void* args_p);
+
+//------------------------------------------------------------------------------
+U32 SystemCoreClock = 1000000000UL;
+
+static volatile ButtonIsrHandler button_isr_v[DRV_ID_BUTTON_LAST];
+static volatile OS_UsbHidMouseIsrHandler usb_hid_mouse_isr;
+static volatile Bool is_tamper_disabled;
+static volatile U8 led_level_v[DRV_ID_LED_LAST];
+static U32 rtc_bkup_regs_v[RTC_BKUP_REGS_COUNT];
+
+static HAL_DriverItf drv_button_tamper = {
+    .Open   = ButtonTamperOpen,
+    .Close  = ButtonTamperClose
+};
+
+static HAL_DriverItf drv_button_wakeup = {
+    .Open   = ButtonWakeupOpen,
+    .Close  = ButtonWakeupClose
+};
+
+static HAL_DriverItf drv_usb_hid_mouse = {
+    .Open   = UsbHidMouseOpen,
+    .Close  = UsbHidMouseClose
+};
+
+static HAL_DriverItf drv_led_user = {
+    .Write  = LedUserWrite
+};
+
+static HAL_DriverItf drv_rtc = {
+    .IoCtl  = RtcIoCtl
+};
+
+HAL_DriverItf* drv_button_v[DRV_ID_BUTTON_LAST] = {
+    [DRV_ID_BUTTON_TAMPER]  = &drv_button_tamper,
+    [DRV_ID_BUTTON_WAKEUP]  = &drv_button_wakeup
+};
+
+HAL_DriverItf* drv_led_v[DRV_ID_LED_LAST] = {
+    [DRV_ID_LED_USER]       = &drv_led_user
+};
+
+HAL_DriverItf* drv_usb_hid_v[DRV_ID_USB_HID_LAST] = {
+    [DRV_ID_USB_HID_MOUSE]  = &drv_usb_hid_mouse
+};
+
+HAL_DriverItf* drv_rtc_v[DRV_ID_RTC_LAST] = {
+    [DRV_ID_RTC]            = &drv_rtc
+};
+
+/******************************************************************************/
+Status HAL_Init_(void)
+{
+    return S_OK;
+}
+
+/******************************************************************************/
+void* HAL_MemSet(void* dst_p, const Int value, const Size size)
+{
+    return memset(dst_p, value, size);
+}
+
+/******************************************************************************/
+Status ButtonTamperOpen(void* args_p)
+{
+    button_isr_v[DRV_ID_BUTTON_TAMPER] = (ButtonIsrHandler)args_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status ButtonTamperClose(void* args_p)
+{
+    (void)args_p;
+    button_isr_v[DRV_ID_BUTTON_TAMPER] = OS_NULL;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status ButtonWakeupOpen(void* args_p)
+{
+    button_isr_v[DRV_ID_BUTTON_WAKEUP] = (ButtonIsrHandler)args_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status ButtonWakeupClose(void* args_p)
+{
+    (void)args_p;
+    button_isr_v[DRV_ID_BUTTON_WAKEUP] = OS_NULL;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status UsbHidMouseOpen(void* args_p)
+{
+    usb_hid_mouse_isr = (OS_UsbHidMouseIsrHandler)args_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status UsbHidMouseClose(void* args_p)
+{
+    (void)args_p;
+    usb_hid_mouse_isr = OS_NULL;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status LedUserWrite(void* data_out_p, Size size, void* args_p)
+{
+    (void)args_p;
+    if ((OS_NULL == data_out_p) || (0 == size)) { return S_INVALID_PTR; }
+    led_level_v[DRV_ID_LED_USER] = *(U8*)data_out_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status RtcIoCtl(const U32 request_id, void* args_p)
+{
+Status s = S_OK;
+    switch (request_id) {
+        case DRV_REQ_BUTTON_TAMPER_DISABLE:
+            is_tamper_disabled = OS_TRUE;
+            break;
+        case DRV_REQ_BUTTON_TAMPER_ENABLE:
+            is_tamper_disabled = OS_FALSE;
+            break;
+        case DRV_REQ_RTC_BKUP_REG_WRITE: {
+            const HAL_RTC_BackupRegWrite* wr_p = (HAL_RTC_BackupRegWrite*)args_p;
+            if (OS_NULL == wr_p) { return S_INVALID_PTR; }
+            if (RTC_BKUP_REGS_COUNT <= wr_p->reg) { return S_INVALID_VALUE; }
+            rtc_bkup_regs_v[wr_p->reg] = wr_p->val;
+            }
+            break;
+        default:
+            s = S_UNDEF_REQ_ID;
+            break;
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status HAL_HostButtonEdge(const U32 drv_id)
+{
+ButtonIsrHandler handler;
+    if (DRV_ID_BUTTON_LAST <= drv_id) { return S_INVALID_VALUE; }
+    if ((DRV_ID_BUTTON_TAMPER == drv_id) && (OS_TRUE == is_tamper_disabled)) { return S_OK; }
+    handler = button_isr_v[drv_id];
+    if (OS_NULL == handler) { return S_INVALID_STATE; }
+    handler();
+    return S_OK;
+}
+
+/******************************************************************************/
+Status HAL_HostUsbHidMouseReport(const U8 device, const OS_UsbHidMouseData* report_p)
+{
+const OS_UsbHidMouseIsrHandler handler = usb_hid_mouse_isr;
+    if (OS_NULL == report_p) { return S_INVALID_PTR; }
+    if (OS_NULL == handler) { return S_INVALID_STATE; }
+    handler(device, report_p);
+    return S_OK;
+}
+
+/******************************************************************************/
+U8 HAL_HostLedLevelGet(const U32 drv_id)
+{
+    return (DRV_ID_LED_LAST > drv_id) ? led_level_v[drv_id] : 0;
+}
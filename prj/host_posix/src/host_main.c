@@ -0,0 +1,22 @@
+/***************************************************************************//**
+* @file    host_main.c
+* @brief   Host process entry (host POSIX port).
+* @author  A. Filyanov
+* @details The firmware main() is built as AppMain() on the host. The shell
+*          runs on the process stdin: its end is the system shutdown.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "os_shell.h"
+
+//------------------------------------------------------------------------------
+void AppMain(void);
+
+/******************************************************************************/
+int main(void)
+{
+    IF_STATUS(OS_ShellStart()) { return EXIT_FAILURE; }
+    //Does not return: the shutdown exits the process.
+    AppMain();
+    return EXIT_FAILURE;
+}
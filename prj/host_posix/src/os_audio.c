@@ -0,0 +1,362 @@
+/***************************************************************************//**
+* @file    os_audio.c
+* @brief   OS audio: the simulated output device (host POSIX port).
+* @author  A. Filyanov
+* @details The device DMA thread walks the played buffer on the sample clock
+*          (the rate is multiplied by #OS_AUDIO_CLOCK_MUL_ENV) and calls the
+*          device callback at the part ends as the DMA ISR does: the halves in
+*          the circular mode, the whole buffer in the normal one.
+*******************************************************************************/
+#include <stdlib.h>
+#include "os_debug.h"
+#include "os_audio.h"
+#include "drv_audio.h"
+#include "os_host.h"
+
+#if (OS_AUDIO_ENABLED)
+//------------------------------------------------------------------------------
+#define MDL_NAME                "audio"
+
+#define NS_IN_SEC               1000000000ULL
+// Normal mode: the late play tolerance before the stall is counted.
+#define DMA_STALL_TOLERANCE_NS  1000000ULL
+
+typedef enum {
+    DMA_STATE_IDLE,
+    DMA_STATE_PLAY,
+    DMA_STATE_PAUSE
+} DmaState;
+
+struct OS_AudioDeviceCb {
+    pthread_mutex_t             mutex;
+    pthread_cond_t              cond;
+    pthread_t                   thread;
+    OS_AudioDeviceIoSetupArgs   io_args;
+    OS_AudioDeviceArgsOpen      open_args;
+    U32                         clock_mul;
+    U8*                         data_p;
+    Size                        size;
+    Size                        part_size;
+    U64                         part_ns;
+    U64                         deadline_ns;    // Current part end.
+    U64                         remain_ns;      // Paused.
+    U8                          part_idx;
+    DmaState                    state;
+    Bool                        is_open;
+    Bool                        is_quit;
+};
+
+typedef struct OS_AudioDeviceCb AudioDeviceCb;
+
+//------------------------------------------------------------------------------
+static void*    DmaThread(void* args_p);
+static U64      DmaTimeNsGet(void);
+static U32      DmaByteRateGet(const OS_AudioInfo* info_p);
+
+//------------------------------------------------------------------------------
+static AudioDeviceCb audio_dev_out;
+static DrvAudioStats audio_stats;
+static DrvAudioSinkFunc audio_sink_func;
+static void* audio_sink_args_p;
+static OS_AudioVolume audio_volume = OS_AUDIO_VOLUME_DEFAULT;
+
+/******************************************************************************/
+Status OS_AudioInit(void)
+{
+ConstStrP clock_mul_p = getenv(OS_AUDIO_CLOCK_MUL_ENV);
+Int clock_mul = OS_AUDIO_CLOCK_MUL_DEFAULT;
+    if (OS_NULL != clock_mul_p) {
+        clock_mul = atoi(clock_mul_p);
+        //The circular DMA can't run free: the clock is needed.
+        if (1 > clock_mul) {
+            OS_LOG(D_WARNING, "%s: %s", OS_AUDIO_CLOCK_MUL_ENV, clock_mul_p);
+            clock_mul = OS_AUDIO_CLOCK_MUL_DEFAULT;
+        }
+    }
+    pthread_mutex_init(&audio_dev_out.mutex, OS_NULL);
+    OS_HostCondInit(&audio_dev_out.cond);
+    audio_dev_out.clock_mul = (U32)clock_mul;
+    return S_OK;
+}
+
+/******************************************************************************/
+U64 DmaTimeNsGet(void)
+{
+struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((U64)ts.tv_sec * NS_IN_SEC) + (U64)ts.tv_nsec;
+}
+
+/******************************************************************************/
+U32 DmaByteRateGet(const OS_AudioInfo* info_p)
+{
+U32 container_size;
+    //The samples containers size.
+    if (8 >= info_p->sample_bits) {
+        container_size = 1;
+    } else if (16 >= info_p->sample_bits) {
+        container_size = 2;
+    } else {
+        container_size = 4;
+    }
+    return info_p->sample_rate * (U32)info_p->channels * container_size;
+}
+
+/******************************************************************************/
+void* DmaThread(void* args_p)
+{
+AudioDeviceCb* dev_p = (AudioDeviceCb*)args_p;
+struct timespec deadline;
+
+    pthread_mutex_lock(&dev_p->mutex);
+    while (OS_TRUE != dev_p->is_quit) {
+        if (DMA_STATE_PLAY != dev_p->state) {
+            pthread_cond_wait(&dev_p->cond, &dev_p->mutex);
+            continue;
+        }
+        if (DmaTimeNsGet() < dev_p->deadline_ns) {
+            deadline.tv_sec = (time_t)(dev_p->deadline_ns / NS_IN_SEC);
+            deadline.tv_nsec= (long)(dev_p->deadline_ns % NS_IN_SEC);
+            pthread_cond_timedwait(&dev_p->cond, &dev_p->mutex, &deadline);
+            continue;
+        }
+        //The part end.
+        {
+            const Bool is_circular = (OS_AUDIO_DMA_MODE_CIRCULAR == dev_p->io_args.dma_mode);
+            const U8* part_p = dev_p->data_p + (dev_p->part_idx * dev_p->part_size);
+            const Size part_size = dev_p->part_size;
+            const DrvAudioSinkFunc sink_func = audio_sink_func;
+            void* sink_args_p = audio_sink_args_p;
+            OS_AudioDeviceCallbackArgs cb_args = {
+                .slot_qhd   = dev_p->open_args.slot_qhd,
+                .signal_id  = OS_SIG_AUDIO_TX_COMPLETE
+            };
+            if (OS_TRUE == is_circular) {
+                if (0 == dev_p->part_idx) { cb_args.signal_id = OS_SIG_AUDIO_TX_COMPLETE_HALF; }
+                dev_p->part_idx ^= 1;
+                //Absolute schedule: no drift on the late wakeups.
+                dev_p->deadline_ns += dev_p->part_ns;
+            } else {
+                dev_p->state = DMA_STATE_IDLE;
+            }
+            ++audio_stats.parts;
+            audio_stats.bytes += part_size;
+            pthread_mutex_unlock(&dev_p->mutex);
+            if (OS_NULL != sink_func) { sink_func(part_p, part_size, sink_args_p); }
+            if (OS_NULL != dev_p->open_args.isr_callback_func) { dev_p->open_args.isr_callback_func(&cb_args); }
+            pthread_mutex_lock(&dev_p->mutex);
+        }
+    }
+    pthread_mutex_unlock(&dev_p->mutex);
+    return OS_NULL;
+}
+
+/******************************************************************************/
+OS_AudioDeviceHd OS_AudioDeviceDefaultGet(const Direction dir)
+{
+    return (DIR_OUT == dir) ? &audio_dev_out : OS_NULL;
+}
+
+/******************************************************************************/
+Status OS_AudioDeviceIoSetup(const OS_AudioDeviceHd dev_hd, const OS_AudioDeviceIoSetupArgs* args_p,
+                             const Direction dir)
+{
+Status s = S_OK;
+    if ((OS_NULL == dev_hd) || (OS_NULL == args_p)) { return S_INVALID_PTR; }
+    if (DIR_OUT != dir) { return S_INVALID_VALUE; }
+    if ((0 == args_p->info.sample_rate) || (0 == args_p->info.sample_bits) ||
+        (OS_AUDIO_CHANNELS_UNDEF == args_p->info.channels) || (OS_AUDIO_CHANNELS_LAST <= args_p->info.channels) ||
+        (OS_AUDIO_DMA_MODE_LAST <= args_p->dma_mode)) {
+        return S_INVALID_VALUE;
+    }
+    pthread_mutex_lock(&dev_hd->mutex);
+    if (DMA_STATE_IDLE != dev_hd->state) {
+        s = S_BUSY;
+    } else {
+        dev_hd->io_args = *args_p;
+    }
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_AudioDeviceOpen(const OS_AudioDeviceHd dev_hd, void* args_p)
+{
+Status s = S_OK;
+    if ((OS_NULL == dev_hd) || (OS_NULL == args_p)) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    if (OS_TRUE == dev_hd->is_open) {
+        s = S_INVALID_STATE;
+    } else {
+        dev_hd->open_args   = *(OS_AudioDeviceArgsOpen*)args_p;
+        dev_hd->state       = DMA_STATE_IDLE;
+        dev_hd->is_quit     = OS_FALSE;
+        dev_hd->deadline_ns = 0;
+        if (0 != pthread_create(&dev_hd->thread, OS_NULL, DmaThread, dev_hd)) {
+            s = S_OUT_OF_MEMORY;
+        } else {
+            dev_hd->is_open = OS_TRUE;
+        }
+    }
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_AudioDeviceClose(const OS_AudioDeviceHd dev_hd)
+{
+    if (OS_NULL == dev_hd) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    if (OS_TRUE != dev_hd->is_open) {
+        pthread_mutex_unlock(&dev_hd->mutex);
+        return S_INVALID_STATE;
+    }
+    dev_hd->state   = DMA_STATE_IDLE;
+    dev_hd->is_quit = OS_TRUE;
+    dev_hd->is_open = OS_FALSE;
+    pthread_cond_broadcast(&dev_hd->cond);
+    pthread_mutex_unlock(&dev_hd->mutex);
+    //The callback in progress is completed.
+    pthread_join(dev_hd->thread, OS_NULL);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_AudioPlay(const OS_AudioDeviceHd dev_hd, void* data_p, const Size size)
+{
+const U64 now = DmaTimeNsGet();
+Bool is_circular;
+U32 byte_rate;
+Status s = S_OK;
+
+    if ((OS_NULL == dev_hd) || (OS_NULL == data_p)) { return S_INVALID_PTR; }
+    if (0 == size) { return S_INVALID_SIZE; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    is_circular = (OS_AUDIO_DMA_MODE_CIRCULAR == dev_hd->io_args.dma_mode);
+    byte_rate   = DmaByteRateGet(&dev_hd->io_args.info);
+    if (OS_TRUE != dev_hd->is_open) {
+        s = S_INVALID_STATE;
+    } else if (DMA_STATE_IDLE != dev_hd->state) {
+        s = S_BUSY;
+    } else if ((OS_TRUE == is_circular) && (0 != (size % 2))) {
+        s = S_INVALID_SIZE;
+    } else {
+        U64 start_ns = now;
+        dev_hd->data_p      = (U8*)data_p;
+        dev_hd->size        = size;
+        dev_hd->part_size   = (OS_TRUE == is_circular) ? (size / 2) : size;
+        dev_hd->part_idx    = 0;
+        dev_hd->part_ns     = ((U64)dev_hd->part_size * NS_IN_SEC) / ((U64)byte_rate * dev_hd->clock_mul);
+        if ((OS_TRUE != is_circular) && (0 != dev_hd->deadline_ns)) {
+            //Normal mode: the next buffer continues the previous one if in time.
+            if (now > (dev_hd->deadline_ns + DMA_STALL_TOLERANCE_NS)) {
+                ++audio_stats.stalls;
+            } else {
+                start_ns = dev_hd->deadline_ns;
+            }
+        }
+        dev_hd->deadline_ns = start_ns + dev_hd->part_ns;
+        dev_hd->state       = DMA_STATE_PLAY;
+        ++audio_stats.plays;
+        pthread_cond_broadcast(&dev_hd->cond);
+    }
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_AudioPause(const OS_AudioDeviceHd dev_hd)
+{
+const U64 now = DmaTimeNsGet();
+Status s = S_OK;
+    if (OS_NULL == dev_hd) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    if (DMA_STATE_PLAY != dev_hd->state) {
+        s = S_INVALID_STATE;
+    } else {
+        dev_hd->remain_ns = (dev_hd->deadline_ns > now) ? (dev_hd->deadline_ns - now) : 0;
+        dev_hd->state     = DMA_STATE_PAUSE;
+        pthread_cond_broadcast(&dev_hd->cond);
+    }
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_AudioResume(const OS_AudioDeviceHd dev_hd)
+{
+Status s = S_OK;
+    if (OS_NULL == dev_hd) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    if (DMA_STATE_PAUSE != dev_hd->state) {
+        s = S_INVALID_STATE;
+    } else {
+        //The schedule is re-based on the resume.
+        dev_hd->deadline_ns = DmaTimeNsGet() + dev_hd->remain_ns;
+        dev_hd->state       = DMA_STATE_PLAY;
+        pthread_cond_broadcast(&dev_hd->cond);
+    }
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_AudioStop(const OS_AudioDeviceHd dev_hd)
+{
+    if (OS_NULL == dev_hd) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&dev_hd->mutex);
+    dev_hd->state       = DMA_STATE_IDLE;
+    dev_hd->deadline_ns = 0;
+    pthread_cond_broadcast(&dev_hd->cond);
+    pthread_mutex_unlock(&dev_hd->mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+OS_AudioVolume OS_VolumeGet(void)
+{
+    return __atomic_load_n(&audio_volume, __ATOMIC_RELAXED);
+}
+
+/******************************************************************************/
+Status OS_VolumeSet(const OS_AudioVolume volume)
+{
+    if (OS_AUDIO_VOLUME_MAX < volume) { return S_INVALID_VALUE; }
+    __atomic_store_n(&audio_volume, volume, __ATOMIC_RELAXED);
+    return S_OK;
+}
+
+/******************************************************************************/
+void DrvAudioSinkSet(const DrvAudioSinkFunc func, void* args_p)
+{
+    pthread_mutex_lock(&audio_dev_out.mutex);
+    audio_sink_func  = func;
+    audio_sink_args_p= args_p;
+    pthread_mutex_unlock(&audio_dev_out.mutex);
+}
+
+/******************************************************************************/
+Status DrvAudioStatsGet(DrvAudioStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&audio_dev_out.mutex);
+    *stats_p = audio_stats;
+    pthread_mutex_unlock(&audio_dev_out.mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+void DrvAudioStatsReset(void)
+{
+    pthread_mutex_lock(&audio_dev_out.mutex);
+    OS_MemSet(&audio_stats, 0, sizeof(audio_stats));
+    pthread_mutex_unlock(&audio_dev_out.mutex);
+}
+
+#else
+/******************************************************************************/
+Status OS_AudioInit(void)
+{
+    return S_OK;
+}
+#endif //(OS_AUDIO_ENABLED)
@@ -0,0 +1,147 @@
+/***************************************************************************//**
+* @file    os_debug.c
+* @brief   OS debug: log and asserts (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include "os_debug.h"
+#include "os_environment.h"
+#include "os_time.h"
+
+//------------------------------------------------------------------------------
+static const StatusItem status_v[S_LAST] = {
+    [S_OK]                  = { "Ok" },
+    [S_UNDEF]               = { "Undefined" },
+    [S_INIT]                = { "Not inited" },
+    [S_INITED]              = { "Already inited" },
+    [S_INVALID_PTR]         = { "Invalid pointer" },
+    [S_INVALID_SIZE]        = { "Invalid size" },
+    [S_INVALID_VALUE]       = { "Invalid value" },
+    [S_INVALID_STATE]       = { "Invalid state" },
+    [S_INVALID_SIGNAL]      = { "Invalid signal" },
+    [S_INVALID_MESSAGE]     = { "Invalid message" },
+    [S_INVALID_QUEUE]       = { "Invalid queue" },
+    [S_INVALID_TASK]        = { "Invalid task" },
+    [S_INVALID_TIMER]       = { "Invalid timer" },
+    [S_INVALID_DRIVER]      = { "Invalid driver" },
+    [S_INVALID_REQ_ID]      = { "Invalid request id" },
+    [S_INVALID_ARG]         = { "Invalid argument" },
+    [S_INVALID_COMMAND]     = { "Invalid command" },
+    [S_OUT_OF_MEMORY]       = { "Out of memory" },
+    [S_TIMEOUT]             = { "Timeout" },
+    [S_OVERFLOW]            = { "Overflow" },
+    [S_BUSY]                = { "Busy" },
+    [S_HARDWARE_ERROR]      = { "Hardware error" },
+    [S_UNDEF_MSG]           = { "Undefined message" },
+    [S_UNDEF_SIG]           = { "Undefined signal" },
+    [S_UNDEF_REQ_ID]        = { "Undefined request id" },
+    [S_UNDEF_COMMAND]       = { "Undefined command" },
+    [S_FS_EOF]              = { "End of file" },
+    [S_FS_UNDEF]            = { "File system error" },
+    [S_FS_NO_FILE]          = { "No file" },
+    [S_FS_EXIST]            = { "File exists" },
+    [S_FS_DENIED]           = { "Access denied" },
+    [S_APP_MODULE]          = { "Application module error" },
+};
+
+static const char log_levels_v[D_LAST] = { ' ', 'C', 'W', 'I', 'D' };
+
+static OS_LogLevel log_level = OS_LOG_LEVEL_DEFAULT;
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+
+//------------------------------------------------------------------------------
+static void     LogLevelInit(void);
+static void     LogHeaderPrint(const OS_LogLevel level, ConstStrP file_p);
+
+/******************************************************************************/
+void LogLevelInit(void)
+{
+ConstStrP level_p = OS_EnvVariableGet(OS_LOG_LEVEL_ENV);
+    if (OS_NULL != level_p) {
+        const U32 level = OS_StrToUL(level_p, OS_NULL, 10);
+        log_level = (D_LAST > level) ? (OS_LogLevel)level : D_DEBUG;
+    }
+}
+
+/******************************************************************************/
+Status OS_DebugInit(void)
+{
+    pthread_once(&log_once, LogLevelInit);
+    return S_OK;
+}
+
+/******************************************************************************/
+ConstStrP StatusStringGet(const Status s)
+{
+    if ((0 > s) || (S_LAST <= s)) { return OS_NULL; }
+    return status_v[s].str;
+}
+
+/******************************************************************************/
+void OS_LogLevelSet(const OS_LogLevel level)
+{
+    pthread_once(&log_once, LogLevelInit);
+    if (D_LAST > level) { log_level = level; }
+}
+
+/******************************************************************************/
+OS_LogLevel OS_LogLevelGet(void)
+{
+    pthread_once(&log_once, LogLevelInit);
+    return log_level;
+}
+
+/******************************************************************************/
+void LogHeaderPrint(const OS_LogLevel level, ConstStrP file_p)
+{
+ConstStrP name_p = OS_StrRChr(file_p, '/');
+const OS_Tick tick = OS_TickCountGet();
+    name_p = (OS_NULL != name_p) ? (name_p + 1) : file_p;
+    //Module name is the source file one.
+    printf("\n%6u.%03u %c %.*s: ", tick / 1000, tick % 1000, log_levels_v[level],
+           (int)strcspn(name_p, "."), name_p);
+}
+
+/******************************************************************************/
+void OS_Log(const OS_LogLevel level, ConstStrP file_p, ConstStrP format_str_p, ...)
+{
+va_list args;
+    if ((D_NONE == level) || (OS_LogLevelGet() < level)) { return; }
+    pthread_mutex_lock(&log_mutex);
+    LogHeaderPrint(level, file_p);
+    va_start(args, format_str_p);
+    vprintf(format_str_p, args);
+    va_end(args);
+    fflush(stdout);
+    pthread_mutex_unlock(&log_mutex);
+}
+
+/******************************************************************************/
+void OS_LogS(const OS_LogLevel level, ConstStrP file_p, const U32 line, const Status s)
+{
+ConstStrP str_p = StatusStringGet(s);
+    if ((D_NONE == level) || (OS_LogLevelGet() < level)) { return; }
+    pthread_mutex_lock(&log_mutex);
+    LogHeaderPrint(level, file_p);
+    if (OS_NULL != str_p) {
+        printf("%s (line %u)", str_p, line);
+    } else {
+        //Module statuses: the module items are not indexed by the host.
+        printf("module status 0x%X (line %u)", (unsigned)s, line);
+    }
+    fflush(stdout);
+    pthread_mutex_unlock(&log_mutex);
+}
+
+/******************************************************************************/
+void OS_Assert(ConstStrP file_p, const U32 line, ConstStrP expr_p)
+{
+    fflush(stdout);
+    fprintf(stderr, "\nAssertion failed: %s (%s:%u)\n", expr_p, file_p, line);
+    abort();
+}
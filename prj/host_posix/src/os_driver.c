@@ -0,0 +1,163 @@
+/***************************************************************************//**
+* @file    os_driver.c
+* @brief   OS drivers (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <pthread.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_driver.h"
+#include "drv_rtc.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "driver"
+
+struct OS_DriverCb {
+    Str                         name[OS_DRIVER_NAME_LEN];
+    HAL_DriverItf*              itf_p;
+    OS_PowerPrio                prio_power;
+    pthread_mutex_t             mutex;
+    Bool                        is_init;
+    Bool                        is_open;
+};
+
+//------------------------------------------------------------------------------
+static OS_DriverHd drv_rtc;
+
+/******************************************************************************/
+Status OS_DriverInit_(void)
+{
+const OS_DriverConfig drv_cfg = {
+    .name       = "RTC",
+    .itf_p      = drv_rtc_v[DRV_ID_RTC],
+    .prio_power = OS_PWR_PRIO_DEFAULT
+};
+Status s;
+    IF_OK(s = OS_DriverCreate(&drv_cfg, &drv_rtc)) {
+        s = OS_DriverInit(drv_rtc, OS_NULL);
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DriverCreate(const OS_DriverConfig* cfg_p, OS_DriverHd* dhd_p)
+{
+struct OS_DriverCb* cb_p;
+    if ((OS_NULL == cfg_p) || (OS_NULL == cfg_p->itf_p) || (OS_NULL == dhd_p)) { return S_INVALID_PTR; }
+    cb_p = OS_Malloc(sizeof(*cb_p));
+    if (OS_NULL == cb_p) { return S_OUT_OF_MEMORY; }
+    OS_MemSet(cb_p, 0, sizeof(*cb_p));
+    if (OS_NULL != cfg_p->name) {
+        OS_StrNCpy(cb_p->name, cfg_p->name, sizeof(cb_p->name) - 1);
+    }
+    cb_p->itf_p     = cfg_p->itf_p;
+    cb_p->prio_power= cfg_p->prio_power;
+    pthread_mutex_init(&cb_p->mutex, OS_NULL);
+    *dhd_p = cb_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_DriverDelete(const OS_DriverHd dhd)
+{
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    if (OS_TRUE == dhd->is_init) { return S_INVALID_STATE; }
+    pthread_mutex_destroy(&dhd->mutex);
+    OS_Free(dhd);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_DriverInit(const OS_DriverHd dhd, void* args_p)
+{
+Status s = S_OK;
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    pthread_mutex_lock(&dhd->mutex);
+    if (OS_TRUE == dhd->is_init) {
+        s = S_INITED;
+    } else {
+        if (OS_NULL != dhd->itf_p->Init) { s = dhd->itf_p->Init(args_p); }
+        IF_OK(s) { dhd->is_init = OS_TRUE; }
+    }
+    pthread_mutex_unlock(&dhd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DriverDeInit(const OS_DriverHd dhd, void* args_p)
+{
+Status s = S_OK;
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    pthread_mutex_lock(&dhd->mutex);
+    if (OS_TRUE != dhd->is_init) {
+        s = S_INIT;
+    } else {
+        if (OS_NULL != dhd->itf_p->DeInit) { s = dhd->itf_p->DeInit(args_p); }
+        IF_OK(s) { dhd->is_init = OS_FALSE; }
+    }
+    pthread_mutex_unlock(&dhd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DriverOpen(const OS_DriverHd dhd, void* args_p)
+{
+Status s = S_OK;
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    pthread_mutex_lock(&dhd->mutex);
+    if (OS_TRUE != dhd->is_init) {
+        s = S_INIT;
+    } else {
+        if (OS_NULL != dhd->itf_p->Open) { s = dhd->itf_p->Open(args_p); }
+        IF_OK(s) { dhd->is_open = OS_TRUE; }
+    }
+    pthread_mutex_unlock(&dhd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DriverClose(const OS_DriverHd dhd, void* args_p)
+{
+Status s = S_OK;
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    pthread_mutex_lock(&dhd->mutex);
+    if (OS_TRUE != dhd->is_init) {
+        s = S_INIT;
+    } else {
+        if (OS_NULL != dhd->itf_p->Close) { s = dhd->itf_p->Close(args_p); }
+        IF_OK(s) { dhd->is_open = OS_FALSE; }
+    }
+    pthread_mutex_unlock(&dhd->mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DriverRead(const OS_DriverHd dhd, void* data_in_p, const Size size, void* args_p)
+{
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    if (OS_NULL == dhd->itf_p->Read) { return S_UNDEF_REQ_ID; }
+    return dhd->itf_p->Read(data_in_p, size, args_p);
+}
+
+/******************************************************************************/
+Status OS_DriverWrite(const OS_DriverHd dhd, void* data_out_p, const Size size, void* args_p)
+{
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    if (OS_NULL == dhd->itf_p->Write) { return S_UNDEF_REQ_ID; }
+    return dhd->itf_p->Write(data_out_p, size, args_p);
+}
+
+/******************************************************************************/
+Status OS_DriverIoCtl(const OS_DriverHd dhd, const U32 request_id, void* args_p)
+{
+    if (OS_NULL == dhd) { return S_INVALID_DRIVER; }
+    if (OS_NULL == dhd->itf_p->IoCtl) { return S_UNDEF_REQ_ID; }
+    return dhd->itf_p->IoCtl(request_id, args_p);
+}
+
+/******************************************************************************/
+OS_DriverHd OS_DriverRtcGet(void)
+{
+    return drv_rtc;
+}
@@ -0,0 +1,21 @@
+/***************************************************************************//**
+* @file    os_environment.c
+* @brief   OS environment variables (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdlib.h>
+#include "os_environment.h"
+
+/******************************************************************************/
+ConstStrP OS_EnvVariableGet(ConstStrP name_p)
+{
+    if (OS_NULL == name_p) { return OS_NULL; }
+    return getenv(name_p);
+}
+
+/******************************************************************************/
+Status OS_EnvVariableSet(ConstStrP name_p, ConstStrP value_p)
+{
+    if ((OS_NULL == name_p) || (OS_NULL == value_p)) { return S_INVALID_PTR; }
+    return (0 == setenv(name_p, value_p, 1)) ? S_OK : S_INVALID_VALUE;
+}
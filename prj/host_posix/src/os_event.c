@@ -0,0 +1,94 @@
+/***************************************************************************//**
+* @file    os_event.c
+* @brief   OS events (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <errno.h>
+#include "os_debug.h"
+#include "os_event.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "event"
+
+typedef struct {
+    OS_TimerId                  timer_id;
+    OS_EventItem*               item_p;
+} EventBind;
+
+//------------------------------------------------------------------------------
+static EventBind events_v[OS_TIMERS_MAX];
+static pthread_mutex_t events_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/******************************************************************************/
+Status OS_HostEventItemBind(const OS_TimerId timer_id, OS_EventItem* item_p)
+{
+Status s = S_OUT_OF_MEMORY;
+    pthread_mutex_lock(&events_mutex);
+    for (Size i = 0; i < OS_TIMERS_MAX; ++i) {
+        if (OS_NULL == events_v[i].item_p) {
+            events_v[i].timer_id= timer_id;
+            events_v[i].item_p  = item_p;
+            s = S_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&events_mutex);
+    return s;
+}
+
+/******************************************************************************/
+void OS_HostEventItemUnbind(const OS_TimerId timer_id)
+{
+    pthread_mutex_lock(&events_mutex);
+    for (Size i = 0; i < OS_TIMERS_MAX; ++i) {
+        if ((OS_NULL != events_v[i].item_p) && (timer_id == events_v[i].timer_id)) {
+            events_v[i].item_p = OS_NULL;
+        }
+    }
+    pthread_mutex_unlock(&events_mutex);
+}
+
+/******************************************************************************/
+OS_EventItem* OS_EventItemByTimerIdGet(const OS_TimerId timer_id)
+{
+OS_EventItem* item_p = OS_NULL;
+    pthread_mutex_lock(&events_mutex);
+    for (Size i = 0; i < OS_TIMERS_MAX; ++i) {
+        if ((OS_NULL != events_v[i].item_p) && (timer_id == events_v[i].timer_id)) {
+            item_p = events_v[i].item_p;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&events_mutex);
+    return item_p;
+}
+
+/******************************************************************************/
+Status OS_EventItemLock(OS_EventItem* item_p, const OS_TimeMs timeout)
+{
+struct timespec deadline;
+Int res;
+    if ((OS_NULL == item_p) || (OS_NULL == item_p->mutex_p)) { return S_INVALID_PTR; }
+    if (OS_BLOCK == timeout) {
+        res = pthread_mutex_lock(item_p->mutex_p);
+    } else {
+        //The timed lock has the realtime clock deadline.
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec+= (long)(timeout % 1000) * 1000000L;
+        if (1000000000L <= deadline.tv_nsec) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec-= 1000000000L;
+        }
+        res = pthread_mutex_timedlock(item_p->mutex_p, &deadline);
+    }
+    return (0 == res) ? S_OK : ((ETIMEDOUT == res) ? S_TIMEOUT : S_INVALID_STATE);
+}
+
+/******************************************************************************/
+Status OS_EventItemUnlock(OS_EventItem* item_p)
+{
+    if ((OS_NULL == item_p) || (OS_NULL == item_p->mutex_p)) { return S_INVALID_PTR; }
+    return (0 == pthread_mutex_unlock(item_p->mutex_p)) ? S_OK : S_INVALID_STATE;
+}
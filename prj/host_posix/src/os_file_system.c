@@ -0,0 +1,292 @@
+/***************************************************************************//**
+* @file    os_file_system.c
+* @brief   OS file system on the host directory (host POSIX port).
+* @author  A. Filyanov
+* @details The volume "N:" is the N subdirectory of the root directory
+*          (#OS_FILE_SYSTEM_ROOT_ENV).
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "fs"
+
+#define FS_FILE_MODE            0644
+#define FS_DIR_MODE             0755
+
+struct OS_FileCb {
+    Int                         fd;
+};
+
+struct OS_DirCb {
+    DIR*                        dir_p;
+    Str                         path[OS_FILE_PATH_LEN];
+};
+
+//------------------------------------------------------------------------------
+static Status   FsErrnoStatus(const Int err);
+static ConstStrP FsRootGet(void);
+
+/******************************************************************************/
+ConstStrP FsRootGet(void)
+{
+ConstStrP root_p = getenv(OS_FILE_SYSTEM_ROOT_ENV);
+    return ((OS_NULL != root_p) && ('\0' != *root_p)) ? root_p : OS_FILE_SYSTEM_ROOT_DEFAULT;
+}
+
+/******************************************************************************/
+Status FsErrnoStatus(const Int err)
+{
+    switch (err) {
+        case ENOENT:
+        case ENOTDIR:   return S_FS_NO_FILE;
+        case EEXIST:
+        case ENOTEMPTY: return S_FS_EXIST;
+        case EACCES:
+        case EPERM:
+        case EISDIR:    return S_FS_DENIED;
+        default:        return S_FS_UNDEF;
+    }
+}
+
+/******************************************************************************/
+Status OS_FileSystemInit(void)
+{
+Str path[OS_FILE_PATH_LEN];
+    if ((0 != mkdir(FsRootGet(), FS_DIR_MODE)) && (EEXIST != errno)) { return FsErrnoStatus(errno); }
+    //Default volume.
+    IF_STATUS(OS_FileSystemHostPathGet("1:", path)) { return S_INVALID_SIZE; }
+    if ((0 != mkdir(path, FS_DIR_MODE)) && (EEXIST != errno)) { return FsErrnoStatus(errno); }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileSystemHostPathGet(ConstStrP path_p, StrP host_path_p)
+{
+ConstStrP volume_end_p;
+Int len;
+    if ((OS_NULL == path_p) || (OS_NULL == host_path_p)) { return S_INVALID_PTR; }
+    volume_end_p = OS_StrChr(path_p, ':');
+    if (OS_NULL == volume_end_p) {
+        //No volume: the default one.
+        len = snprintf(host_path_p, OS_FILE_PATH_LEN, "%s/1/%s", FsRootGet(), path_p);
+    } else {
+        ConstStrP rest_p = volume_end_p + 1;
+        while ('/' == *rest_p) { ++rest_p; }
+        len = snprintf(host_path_p, OS_FILE_PATH_LEN, "%s/%.*s%s%s", FsRootGet(),
+                       (Int)(volume_end_p - path_p), path_p, ('\0' != *rest_p) ? "/" : "", rest_p);
+    }
+    return ((0 > len) || (OS_FILE_PATH_LEN <= len)) ? S_INVALID_SIZE : S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileOpen(OS_FileHd* fhd_p, ConstStrP path_p, const OS_FileOpenMode op_mode)
+{
+Str path[OS_FILE_PATH_LEN];
+struct OS_FileCb* cb_p;
+Int flags;
+Int fd;
+Status s;
+
+    if (OS_NULL == fhd_p) { return S_INVALID_PTR; }
+    *fhd_p = OS_NULL;
+    IF_STATUS(s = OS_FileSystemHostPathGet(path_p, path)) { return s; }
+    if (BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_READ)) && BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        flags = O_RDWR;
+    } else if (BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        flags = O_WRONLY;
+    } else {
+        flags = O_RDONLY;
+    }
+    if (BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_CREATE_NEW))) {
+        flags |= O_CREAT | O_EXCL;
+    } else if (BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS))) {
+        flags |= O_CREAT | O_TRUNC;
+    } else if (BIT_TEST(op_mode, BIT(OS_FS_FILE_OP_MODE_OPEN_NEW))) {
+        flags |= O_CREAT;
+    }
+    fd = open(path, flags | O_CLOEXEC, FS_FILE_MODE);
+    if (0 > fd) { return FsErrnoStatus(errno); }
+    cb_p = OS_Malloc(sizeof(*cb_p));
+    if (OS_NULL == cb_p) {
+        close(fd);
+        return S_OUT_OF_MEMORY;
+    }
+    cb_p->fd = fd;
+    *fhd_p = cb_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileClose(OS_FileHd* fhd_p)
+{
+Status s = S_OK;
+    if ((OS_NULL == fhd_p) || (OS_NULL == *fhd_p)) { return S_INVALID_PTR; }
+    if (0 != close((*fhd_p)->fd)) { s = FsErrnoStatus(errno); }
+    OS_Free(*fhd_p);
+    *fhd_p = OS_NULL;
+    return s;
+}
+
+/******************************************************************************/
+Status OS_FileRead(const OS_FileHd fhd, void* data_in_p, const U32 size)
+{
+U8* data_p = (U8*)data_in_p;
+U32 count = 0;
+    if ((OS_NULL == fhd) || (OS_NULL == data_in_p)) { return S_INVALID_PTR; }
+    while (size > count) {
+        const ssize_t res = read(fhd->fd, data_p + count, size - count);
+        if (0 > res) {
+            if (EINTR == errno) { continue; }
+            return FsErrnoStatus(errno);
+        }
+        if (0 == res) { return S_FS_EOF; }
+        count += (U32)res;
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileWrite(const OS_FileHd fhd, const void* data_out_p, const U32 size)
+{
+const U8* data_p = (const U8*)data_out_p;
+U32 count = 0;
+    if ((OS_NULL == fhd) || (OS_NULL == data_out_p)) { return S_INVALID_PTR; }
+    while (size > count) {
+        const ssize_t res = write(fhd->fd, data_p + count, size - count);
+        if (0 > res) {
+            if (EINTR == errno) { continue; }
+            return FsErrnoStatus(errno);
+        }
+        count += (U32)res;
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileLSeek(const OS_FileHd fhd, const U32 offset)
+{
+    if (OS_NULL == fhd) { return S_INVALID_PTR; }
+    return (0 > lseek(fhd->fd, (off_t)offset, SEEK_SET)) ? FsErrnoStatus(errno) : S_OK;
+}
+
+/******************************************************************************/
+U32 OS_FileTell(const OS_FileHd fhd)
+{
+off_t offset;
+    if (OS_NULL == fhd) { return 0; }
+    offset = lseek(fhd->fd, 0, SEEK_CUR);
+    return (0 > offset) ? 0 : (U32)offset;
+}
+
+/******************************************************************************/
+U32 OS_FileSizeGet(const OS_FileHd fhd)
+{
+struct stat st;
+    if ((OS_NULL == fhd) || (0 != fstat(fhd->fd, &st))) { return 0; }
+    return (U32)st.st_size;
+}
+
+/******************************************************************************/
+Status OS_FileSync(const OS_FileHd fhd)
+{
+    if (OS_NULL == fhd) { return S_INVALID_PTR; }
+    return (0 != fsync(fhd->fd)) ? FsErrnoStatus(errno) : S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileTruncate(const OS_FileHd fhd)
+{
+off_t offset;
+    if (OS_NULL == fhd) { return S_INVALID_PTR; }
+    offset = lseek(fhd->fd, 0, SEEK_CUR);
+    if (0 > offset) { return FsErrnoStatus(errno); }
+    return (0 != ftruncate(fhd->fd, offset)) ? FsErrnoStatus(errno) : S_OK;
+}
+
+/******************************************************************************/
+Status OS_FileDelete(ConstStrP path_p)
+{
+Str path[OS_FILE_PATH_LEN];
+struct stat st;
+Status s;
+    IF_STATUS(s = OS_FileSystemHostPathGet(path_p, path)) { return s; }
+    if (0 != stat(path, &st)) { return FsErrnoStatus(errno); }
+    if (0 != (S_ISDIR(st.st_mode) ? rmdir(path) : unlink(path))) { return FsErrnoStatus(errno); }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_DirOpen(ConstStrP path_p, OS_DirHd* dhd_p)
+{
+struct OS_DirCb* cb_p;
+Status s;
+    if (OS_NULL == dhd_p) { return S_INVALID_PTR; }
+    *dhd_p = OS_NULL;
+    cb_p = OS_Malloc(sizeof(*cb_p));
+    if (OS_NULL == cb_p) { return S_OUT_OF_MEMORY; }
+    IF_OK(s = OS_FileSystemHostPathGet(path_p, cb_p->path)) {
+        cb_p->dir_p = opendir(cb_p->path);
+        if (OS_NULL == cb_p->dir_p) { s = FsErrnoStatus(errno); }
+    }
+    IF_STATUS(s) {
+        OS_Free(cb_p);
+        return s;
+    }
+    *dhd_p = cb_p;
+    return s;
+}
+
+/******************************************************************************/
+Status OS_DirClose(const OS_DirHd dhd)
+{
+    if (OS_NULL == dhd) { return S_INVALID_PTR; }
+    closedir(dhd->dir_p);
+    OS_Free(dhd);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_DirRead(const OS_DirHd dhd, OS_FileStats* stats_p)
+{
+struct dirent* item_p;
+struct stat st;
+
+    if ((OS_NULL == dhd) || (OS_NULL == stats_p)) { return S_INVALID_PTR; }
+    OS_MemSet(stats_p, 0, sizeof(*stats_p));
+    do {
+        errno = 0;
+        item_p = readdir(dhd->dir_p);
+        if (OS_NULL == item_p) {
+            //The end: the empty name.
+            return (0 != errno) ? FsErrnoStatus(errno) : S_OK;
+        }
+    } while ((0 == OS_StrCmp(item_p->d_name, ".")) || (0 == OS_StrCmp(item_p->d_name, "..")));
+    OS_StrNCpy(stats_p->name, item_p->d_name, sizeof(stats_p->name) - 1);
+    if (0 == fstatat(dirfd(dhd->dir_p), item_p->d_name, &st, 0)) {
+        if (S_ISDIR(st.st_mode)) {
+            stats_p->attrs = OS_FS_FILE_ATTR_DIR;
+        } else {
+            stats_p->size = (U32)st.st_size;
+        }
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_DirCreate(ConstStrP path_p)
+{
+Str path[OS_FILE_PATH_LEN];
+Status s;
+    IF_STATUS(s = OS_FileSystemHostPathGet(path_p, path)) { return s; }
+    return (0 != mkdir(path, FS_DIR_MODE)) ? FsErrnoStatus(errno) : S_OK;
+}
@@ -0,0 +1,78 @@
+/***************************************************************************//**
+* @file    os_host.h
+* @brief   OS host (POSIX) port internals.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _OS_HOST_H_
+#define _OS_HOST_H_
+
+#include <pthread.h>
+#include <time.h>
+#include "os_common.h"
+#include "os_event.h"
+
+//------------------------------------------------------------------------------
+#define MS_TO_US(ms)            ((U64)(ms) * 1000ULL)
+#define US_TO_NS(us)            ((U64)(us) * 1000ULL)
+
+//------------------------------------------------------------------------------
+// Modules init (OSAL_Init()).
+Status          OS_TimeInit(void);
+Status          OS_DebugInit(void);
+Status          OS_TaskInit_(void);
+Status          OS_TimerInit(void);
+Status          OS_DriverInit_(void);
+Status          OS_FileSystemInit(void);
+Status          OS_AudioInit(void);
+
+// Time.
+/// @brief      Init the condition variable on the monotonic clock.
+/// @param[out] cond_p         Condition variable.
+void            OS_HostCondInit(pthread_cond_t* cond_p);
+
+/// @brief      Get the monotonic clock deadline.
+/// @param[in]  timeout_us     Timeout (us from now).
+/// @param[out] ts_p           Deadline.
+void            OS_HostDeadlineGet(const U64 timeout_us, struct timespec* ts_p);
+
+/// @brief      Wait the condition till the timeout.
+/// @param[in]  cond_p         Condition variable.
+/// @param[in]  mutex_p        Locked mutex.
+/// @param[in]  timeout        Timeout (#OS_BLOCK - infinite).
+/// @param[in]  ts_p           Deadline (of the timeout).
+/// @return     #Status (#S_TIMEOUT - the deadline is passed).
+Status          OS_HostCondWait(pthread_cond_t* cond_p, pthread_mutex_t* mutex_p, const OS_TimeMs timeout,
+                                const struct timespec* ts_p);
+
+// Tasks.
+/// @brief      Set the task to wake up on the deletion (the blocking calls).
+/// @param[in]  cond_p         Condition variable the caller task waits on.
+/// @param[in]  mutex_p        Its mutex (locked by the caller).
+/// @return     The caller task is being deleted.
+Bool            OS_HostTaskWaitSet(pthread_cond_t* cond_p, pthread_mutex_t* mutex_p);
+
+/// @brief      Exit the caller task if it is being deleted (no locks are held).
+void            OS_HostTaskExitCheck(void);
+
+// Queues.
+/// @brief      Send the queue item (message or signal).
+/// @param[in]  qhd            Queue.
+/// @param[in]  item_p         Item.
+/// @param[in]  timeout        Full queue wait timeout.
+/// @param[in]  prio           Priority.
+/// @return     #Status.
+Status          OS_HostItemSend(const OS_QueueHd qhd, const void* item_p, const OS_TimeMs timeout,
+                                const OS_MessagePrio prio);
+
+// Events.
+/// @brief      Bind the event item to the event timer.
+/// @param[in]  timer_id       Timer id.
+/// @param[in]  item_p         Item.
+/// @return     #Status.
+Status          OS_HostEventItemBind(const OS_TimerId timer_id, OS_EventItem* item_p);
+
+/// @brief      Unbind the event timer item.
+/// @param[in]  timer_id       Timer id.
+void            OS_HostEventItemUnbind(const OS_TimerId timer_id);
+
+#endif // _OS_HOST_H_
@@ -0,0 +1,235 @@
+/***************************************************************************//**
+* @file    os_mailbox.c
+* @brief   OS messages and queues (host POSIX port).
+* @author  A. Filyanov
+* @details A queue is a ring of the items (the messages pointers and the
+*          signals) under the mutex. The items of a cleared or deleted queue
+*          are dropped as on the target (the messages may be the pool ones).
+*******************************************************************************/
+#include <stdlib.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_mailbox.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "mailbox"
+
+struct OS_QueueCb {
+    pthread_mutex_t             mutex;
+    pthread_cond_t              items_cond;     // Not empty.
+    pthread_cond_t              space_cond;     // Not full.
+    const void**                items_v;
+    Size                        len;
+    Size                        head;
+    Size                        count;
+    OS_QueueStats               stats;
+    OS_TaskHd                   parent_thd;
+    Bool                        is_deleted;
+};
+
+//------------------------------------------------------------------------------
+static Status   ItemPut(struct OS_QueueCb* q_p, const void* item_p, const OS_MessagePrio prio);
+
+/******************************************************************************/
+Status OS_QueueCreate(const OS_QueueConfig* cfg_p, const OS_TaskHd parent_thd, OS_QueueHd* qhd_p)
+{
+struct OS_QueueCb* q_p;
+
+    if ((OS_NULL == cfg_p) || (OS_NULL == qhd_p)) { return S_INVALID_PTR; }
+    if (0 == cfg_p->len) { return S_INVALID_SIZE; }
+    q_p = calloc(1, sizeof(*q_p));
+    if (OS_NULL == q_p) { return S_OUT_OF_MEMORY; }
+    q_p->items_v = calloc(cfg_p->len, sizeof(void*));
+    if (OS_NULL == q_p->items_v) {
+        free(q_p);
+        return S_OUT_OF_MEMORY;
+    }
+    q_p->len        = cfg_p->len;
+    q_p->parent_thd = parent_thd;
+    pthread_mutex_init(&q_p->mutex, OS_NULL);
+    OS_HostCondInit(&q_p->items_cond);
+    OS_HostCondInit(&q_p->space_cond);
+    *qhd_p = q_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_QueueDelete(const OS_QueueHd qhd)
+{
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    //The senders may still hold the handle (as on the target): the queue is
+    //only marked deleted and is never reused.
+    pthread_mutex_lock(&qhd->mutex);
+    qhd->is_deleted = OS_TRUE;
+    qhd->count      = 0;
+    pthread_cond_broadcast(&qhd->space_cond);
+    pthread_mutex_unlock(&qhd->mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_QueueClear(const OS_QueueHd qhd)
+{
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    pthread_mutex_lock(&qhd->mutex);
+    qhd->count = 0;
+    pthread_cond_broadcast(&qhd->space_cond);
+    pthread_mutex_unlock(&qhd->mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+U32 OS_QueueItemsCountGet(const OS_QueueHd qhd)
+{
+U32 count;
+    if (OS_NULL == qhd) { return 0; }
+    pthread_mutex_lock(&qhd->mutex);
+    count = (U32)qhd->count;
+    pthread_mutex_unlock(&qhd->mutex);
+    return count;
+}
+
+/******************************************************************************/
+Status OS_QueueStatsGet(const OS_QueueHd qhd, OS_QueueStats* stats_p)
+{
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    pthread_mutex_lock(&qhd->mutex);
+    *stats_p = qhd->stats;
+    pthread_mutex_unlock(&qhd->mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+void OS_QueueStatsReset(const OS_QueueHd qhd)
+{
+    if (OS_NULL == qhd) { return; }
+    pthread_mutex_lock(&qhd->mutex);
+    OS_MemSet(&qhd->stats, 0, sizeof(qhd->stats));
+    pthread_mutex_unlock(&qhd->mutex);
+}
+
+/******************************************************************************/
+Status ItemPut(struct OS_QueueCb* q_p, const void* item_p, const OS_MessagePrio prio)
+{
+    //Locked by the caller.
+    if (OS_TRUE == q_p->is_deleted) { return S_INVALID_QUEUE; }
+    if (q_p->len == q_p->count) { return S_OVERFLOW; }
+    if (OS_MSG_PRIO_HIGH == prio) {
+        q_p->head = (0 == q_p->head) ? (q_p->len - 1) : (q_p->head - 1);
+        q_p->items_v[q_p->head] = item_p;
+    } else {
+        q_p->items_v[(q_p->head + q_p->count) % q_p->len] = item_p;
+    }
+    ++q_p->count;
+    ++q_p->stats.sends;
+    if (q_p->stats.depth_max < q_p->count) { q_p->stats.depth_max = (U16)q_p->count; }
+    pthread_cond_signal(&q_p->items_cond);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_HostItemSend(const OS_QueueHd qhd, const void* item_p, const OS_TimeMs timeout,
+                       const OS_MessagePrio prio)
+{
+struct timespec deadline;
+Status s;
+
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    if ((OS_NO_BLOCK != timeout) && (OS_BLOCK != timeout)) {
+        OS_HostDeadlineGet(MS_TO_US(timeout), &deadline);
+    }
+    pthread_mutex_lock(&qhd->mutex);
+    for (;;) {
+        s = ItemPut(qhd, item_p, prio);
+        if ((S_OVERFLOW != s) || (OS_NO_BLOCK == timeout)) { break; }
+        if (OS_TRUE == OS_HostTaskWaitSet(&qhd->space_cond, &qhd->mutex)) { break; }
+        IF_STATUS(OS_HostCondWait(&qhd->space_cond, &qhd->mutex, timeout, &deadline)) {
+            s = S_TIMEOUT;
+            //Last chance: the space may be freed with the timeout.
+            IF_OK(ItemPut(qhd, item_p, prio)) { s = S_OK; }
+            break;
+        }
+    }
+    OS_HostTaskWaitSet(OS_NULL, OS_NULL);
+    if ((S_OVERFLOW == s) || (S_TIMEOUT == s)) { ++qhd->stats.fails; }
+    pthread_mutex_unlock(&qhd->mutex);
+    OS_HostTaskExitCheck();
+    return s;
+}
+
+/******************************************************************************/
+OS_Message* OS_MessageCreate(const OS_MessageId id, const Size size, const OS_TimeMs timeout, const void* data_p)
+{
+OS_Message* msg_p;
+    (void)timeout;
+    if (U16_MAX < size) { return OS_NULL; }
+    msg_p = OS_Malloc(sizeof(OS_Message) + size);
+    if (OS_NULL != msg_p) {
+        msg_p->id   = id;
+        msg_p->size = (U16)size;
+        msg_p->src  = 0;
+        if ((OS_NULL != data_p) && (0 != size)) {
+            OS_MemCpy(msg_p->data, data_p, size);
+        }
+    }
+    return msg_p;
+}
+
+/******************************************************************************/
+Status OS_MessageDelete(OS_Message* msg_p)
+{
+    if (OS_NULL == msg_p) { return S_INVALID_PTR; }
+    if (OS_SignalIs(msg_p)) { return S_INVALID_MESSAGE; }
+    OS_Free(msg_p);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_MessageSend(const OS_QueueHd qhd, const OS_Message* msg_p, const OS_TimeMs timeout,
+                      const OS_MessagePrio prio)
+{
+    if (OS_NULL == msg_p) { return S_INVALID_PTR; }
+    return OS_HostItemSend(qhd, msg_p, timeout, prio);
+}
+
+/******************************************************************************/
+Int OS_ISR_MessageSend(const OS_QueueHd qhd, const OS_Message* msg_p, const OS_MessagePrio prio)
+{
+    //No preemption by the ISR on the host: a task is never woken "higher".
+    return (S_OK == OS_HostItemSend(qhd, msg_p, OS_NO_BLOCK, prio)) ? 0 : -1;
+}
+
+/******************************************************************************/
+Status OS_MessageReceive(const OS_QueueHd qhd, OS_Message** msg_pp, const OS_TimeMs timeout)
+{
+struct timespec deadline;
+Status s = S_OK;
+
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    if (OS_NULL == msg_pp) { return S_INVALID_PTR; }
+    if ((OS_NO_BLOCK != timeout) && (OS_BLOCK != timeout)) {
+        OS_HostDeadlineGet(MS_TO_US(timeout), &deadline);
+    }
+    pthread_mutex_lock(&qhd->mutex);
+    while (0 == qhd->count) {
+        if (OS_NO_BLOCK == timeout) { s = S_TIMEOUT; break; }
+        if (OS_TRUE == OS_HostTaskWaitSet(&qhd->items_cond, &qhd->mutex)) { s = S_INVALID_STATE; break; }
+        IF_STATUS(OS_HostCondWait(&qhd->items_cond, &qhd->mutex, timeout, &deadline)) {
+            s = (0 == qhd->count) ? S_TIMEOUT : S_OK;
+            break;
+        }
+    }
+    OS_HostTaskWaitSet(OS_NULL, OS_NULL);
+    IF_OK(s) {
+        *msg_pp = (OS_Message*)qhd->items_v[qhd->head];
+        qhd->head = (qhd->head + 1) % qhd->len;
+        --qhd->count;
+        ++qhd->stats.receives;
+        pthread_cond_signal(&qhd->space_cond);
+    }
+    pthread_mutex_unlock(&qhd->mutex);
+    OS_HostTaskExitCheck();
+    return s;
+}
@@ -0,0 +1,205 @@
+/***************************************************************************//**
+* @file    os_memory.c
+* @brief   OS memory: heaps and the memory functions (host POSIX port).
+* @author  A. Filyanov
+* @details The blocks are the host heap ones (valgrind sees every block) with
+*          the header of the accounting.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "os_debug.h"
+#include "os_memory.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "memory"
+
+#define BLOCK_MAGIC             0xD105ABCDUL
+
+// Keeps the user block aligned as malloc() does.
+typedef union {
+    struct {
+        Size                    size;
+        U32                     type;
+        U32                     magic;
+    };
+    max_align_t                 align;
+} BlockHeader;
+
+typedef struct {
+    OS_MemoryStats              stats;
+    pthread_mutex_t             mutex;
+} Heap;
+
+//------------------------------------------------------------------------------
+static Heap heaps_v[OS_MEM_LAST] = {
+    [OS_MEM_RAM_INT_SRAM]   = { { "int sram",   OS_MEM_RAM_INT_SRAM_SIZE }, PTHREAD_MUTEX_INITIALIZER },
+    [OS_MEM_RAM_INT_CCM]    = { { "int ccm",    OS_MEM_RAM_INT_CCM_SIZE  }, PTHREAD_MUTEX_INITIALIZER },
+    [OS_MEM_RAM_EXT_SRAM]   = { { "ext sram",   OS_MEM_RAM_EXT_SRAM_SIZE }, PTHREAD_MUTEX_INITIALIZER },
+    [OS_MEM_HEAP_SYS]       = { { "heap sys",   OS_MEM_HEAP_SYS_SIZE     }, PTHREAD_MUTEX_INITIALIZER },
+    [OS_MEM_HEAP_APP]       = { { "heap app",   OS_MEM_HEAP_APP_SIZE     }, PTHREAD_MUTEX_INITIALIZER },
+};
+
+/******************************************************************************/
+Status OS_MemoryInit(void)
+{
+    return S_OK;
+}
+
+/******************************************************************************/
+void* OS_Malloc(const Size size)
+{
+    return OS_MallocEx(size, OS_MEM_HEAP_SYS);
+}
+
+/******************************************************************************/
+void OS_Free(void* addr_p)
+{
+    OS_FreeEx(addr_p, OS_MEM_HEAP_SYS);
+}
+
+/******************************************************************************/
+void* OS_MallocEx(const Size size, const OS_MemoryType mem_type)
+{
+Heap* heap_p;
+BlockHeader* hdr_p = OS_NULL;
+
+    if (OS_MEM_LAST <= mem_type) { return OS_NULL; }
+    heap_p = &heaps_v[mem_type];
+    pthread_mutex_lock(&heap_p->mutex);
+    if ((0 != size) && (size <= (heap_p->stats.size - heap_p->stats.used))) {
+        hdr_p = malloc(sizeof(BlockHeader) + size);
+    }
+    if (OS_NULL != hdr_p) {
+        hdr_p->size = size;
+        hdr_p->type = mem_type;
+        hdr_p->magic= BLOCK_MAGIC;
+        heap_p->stats.used += size;
+        if (heap_p->stats.used_max < heap_p->stats.used) {
+            heap_p->stats.used_max = heap_p->stats.used;
+        }
+        ++heap_p->stats.allocs;
+    } else {
+        ++heap_p->stats.fails;
+    }
+    pthread_mutex_unlock(&heap_p->mutex);
+    return (OS_NULL != hdr_p) ? (void*)(hdr_p + 1) : OS_NULL;
+}
+
+/******************************************************************************/
+void OS_FreeEx(void* addr_p, const OS_MemoryType mem_type)
+{
+BlockHeader* hdr_p = (BlockHeader*)addr_p - 1;
+Heap* heap_p;
+
+    if (OS_NULL == addr_p) { return; }
+    //Wrong memory type is the target heap corruption.
+    OS_ASSERT((BLOCK_MAGIC == hdr_p->magic) && (mem_type == hdr_p->type));
+    heap_p = &heaps_v[mem_type];
+    pthread_mutex_lock(&heap_p->mutex);
+    heap_p->stats.used -= hdr_p->size;
+    ++heap_p->stats.frees;
+    pthread_mutex_unlock(&heap_p->mutex);
+    hdr_p->magic = 0;
+    free(hdr_p);
+}
+
+/******************************************************************************/
+Size OS_MemoryFreeGet(const OS_MemoryType mem_type)
+{
+Size size;
+    if (OS_MEM_LAST <= mem_type) { return 0; }
+    pthread_mutex_lock(&heaps_v[mem_type].mutex);
+    size = heaps_v[mem_type].stats.size - heaps_v[mem_type].stats.used;
+    pthread_mutex_unlock(&heaps_v[mem_type].mutex);
+    return size;
+}
+
+/******************************************************************************/
+Status OS_MemoryStatsGet(const OS_MemoryType mem_type, OS_MemoryStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    if (OS_MEM_LAST <= mem_type) { return S_INVALID_VALUE; }
+    pthread_mutex_lock(&heaps_v[mem_type].mutex);
+    *stats_p = heaps_v[mem_type].stats;
+    pthread_mutex_unlock(&heaps_v[mem_type].mutex);
+    return S_OK;
+}
+
+/******************************************************************************/
+void* OS_MemSet(void* dst_p, const Int value, const Size size)
+{
+    return memset(dst_p, value, size);
+}
+
+/******************************************************************************/
+void* OS_MemCpy(void* dst_p, const void* src_p, const Size size)
+{
+    return memcpy(dst_p, src_p, size);
+}
+
+/******************************************************************************/
+void* OS_MemMov(void* dst_p, const void* src_p, const Size size)
+{
+    return memmove(dst_p, src_p, size);
+}
+
+/******************************************************************************/
+Int OS_MemCmp(const void* buf1_p, const void* buf2_p, const Size size)
+{
+    return memcmp(buf1_p, buf2_p, size);
+}
+
+/******************************************************************************/
+Size OS_StrLen(ConstStrP str_p)
+{
+    return strlen(str_p);
+}
+
+/******************************************************************************/
+Int OS_StrCmp(ConstStrP str1_p, ConstStrP str2_p)
+{
+    return strcmp(str1_p, str2_p);
+}
+
+/******************************************************************************/
+Int OS_StrNCmp(ConstStrP str1_p, ConstStrP str2_p, const Size size)
+{
+    return strncmp(str1_p, str2_p, size);
+}
+
+/******************************************************************************/
+StrP OS_StrCpy(StrP dst_p, ConstStrP src_p)
+{
+    return strcpy(dst_p, src_p);
+}
+
+/******************************************************************************/
+StrP OS_StrNCpy(StrP dst_p, ConstStrP src_p, const Size size)
+{
+    return strncpy(dst_p, src_p, size);
+}
+
+/******************************************************************************/
+StrP OS_StrCat(StrP dst_p, ConstStrP src_p)
+{
+    return strcat(dst_p, src_p);
+}
+
+/******************************************************************************/
+StrP OS_StrChr(ConstStrP str_p, const Int c)
+{
+    return strchr(str_p, c);
+}
+
+/******************************************************************************/
+StrP OS_StrRChr(ConstStrP str_p, const Int c)
+{
+    return strrchr(str_p, c);
+}
+
+/******************************************************************************/
+U32 OS_StrToUL(ConstStrP str_p, StrP* end_pp, const Int base)
+{
+    return (U32)strtoul(str_p, end_pp, base);
+}
@@ -0,0 +1,147 @@
+/***************************************************************************//**
+* @file    os_shell.c
+* @brief   OS shell on the process stdin (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "os_debug.h"
+#include "os_signal.h"
+#include "os_supervise.h"
+#include "os_shell.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "shell"
+
+#define SHELL_PROMPT            "\n> "
+#define SHELL_DELIMITERS        " \t\r\n"
+
+//------------------------------------------------------------------------------
+static void*    ShellThread(void* args_p);
+static Status   ShellCmdHelpHandler(const U32 argc, ConstStrP argv[]);
+static const OS_ShellCommandConfig* ShellCommandGet(ConstStrP command_p);
+
+//------------------------------------------------------------------------------
+static const OS_ShellCommandConfig* commands_v[OS_SHELL_COMMANDS_MAX];
+static Size commands_count;
+static pthread_mutex_t commands_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t shell_thread;
+
+static const OS_ShellCommandConfig cmd_cfg_help = {
+    "help", "Commands help.", "help [command]", ShellCmdHelpHandler, 0, 1, OS_SHELL_OPT_UNDEF
+};
+
+/******************************************************************************/
+Status OS_ShellCommandCreate(const OS_ShellCommandConfig* cfg_p)
+{
+Status s = S_OK;
+    if ((OS_NULL == cfg_p) || (OS_NULL == cfg_p->command) || (OS_NULL == cfg_p->handler)) { return S_INVALID_PTR; }
+    if (cfg_p->argc_min > cfg_p->argc_max) { return S_INVALID_VALUE; }
+    pthread_mutex_lock(&commands_mutex);
+    if (0 == commands_count) { commands_v[commands_count++] = &cmd_cfg_help; }
+    if (OS_NULL != ShellCommandGet(cfg_p->command)) {
+        s = S_INVALID_COMMAND;
+    } else if (OS_SHELL_COMMANDS_MAX <= commands_count) {
+        s = S_OUT_OF_MEMORY;
+    } else {
+        commands_v[commands_count++] = cfg_p;
+    }
+    pthread_mutex_unlock(&commands_mutex);
+    return s;
+}
+
+/******************************************************************************/
+const OS_ShellCommandConfig* ShellCommandGet(ConstStrP command_p)
+{
+    //Locked by the caller.
+    for (Size i = 0; i < commands_count; ++i) {
+        if (0 == OS_StrCmp(commands_v[i]->command, command_p)) { return commands_v[i]; }
+    }
+    return OS_NULL;
+}
+
+/******************************************************************************/
+Status OS_ShellCommandExecute(ConstStrP cl_p)
+{
+Str cl[OS_SHELL_CL_LEN];
+ConstStrP argv[OS_SHELL_ARGS_MAX + 1];
+const OS_ShellCommandConfig* cmd_cfg_p;
+StrP save_p = OS_NULL;
+StrP token_p;
+U32 argc = 0;
+
+    if (OS_NULL == cl_p) { return S_INVALID_PTR; }
+    if (sizeof(cl) <= OS_StrLen(cl_p)) { return S_INVALID_SIZE; }
+    OS_StrCpy(cl, cl_p);
+    token_p = strtok_r(cl, SHELL_DELIMITERS, &save_p);
+    if (OS_NULL == token_p) { return S_OK; }
+    pthread_mutex_lock(&commands_mutex);
+    cmd_cfg_p = ShellCommandGet(token_p);
+    pthread_mutex_unlock(&commands_mutex);
+    if (OS_NULL == cmd_cfg_p) { return S_UNDEF_COMMAND; }
+    //The arguments: the command excluded.
+    while (OS_NULL != (token_p = strtok_r(OS_NULL, SHELL_DELIMITERS, &save_p))) {
+        if (OS_SHELL_ARGS_MAX <= argc) { return S_INVALID_ARG; }
+        argv[argc++] = token_p;
+    }
+    argv[argc] = OS_NULL;
+    if ((cmd_cfg_p->argc_min > argc) || (cmd_cfg_p->argc_max < argc)) { return S_INVALID_ARG; }
+    return cmd_cfg_p->handler(argc, argv);
+}
+
+/******************************************************************************/
+Status ShellCmdHelpHandler(const U32 argc, ConstStrP argv[])
+{
+Status s = S_OK;
+    pthread_mutex_lock(&commands_mutex);
+    if (0 == argc) {
+        for (Size i = 0; i < commands_count; ++i) {
+            printf("\n%-12s %s", commands_v[i]->command, commands_v[i]->help_brief);
+        }
+    } else {
+        const OS_ShellCommandConfig* cmd_cfg_p = ShellCommandGet(argv[0]);
+        if (OS_NULL == cmd_cfg_p) {
+            s = S_UNDEF_COMMAND;
+        } else {
+            printf("\n%s\n%s", cmd_cfg_p->help_brief, cmd_cfg_p->help_detail);
+        }
+    }
+    pthread_mutex_unlock(&commands_mutex);
+    return s;
+}
+
+/******************************************************************************/
+void* ShellThread(void* args_p)
+{
+Str cl[OS_SHELL_CL_LEN];
+Status s;
+    (void)args_p;
+    while (OS_TRUE != OS_SchedulerIsRunning()) {
+        OS_TaskDelay(10);
+    }
+    for (;;) {
+        printf(SHELL_PROMPT);
+        fflush(stdout);
+        if (OS_NULL == fgets(cl, sizeof(cl), stdin)) { break; }
+        IF_STATUS(s = OS_ShellCommandExecute(cl)) {
+            OS_LOG_S(D_WARNING, s);
+        }
+        fflush(stdout);
+    }
+    //The stdin end: the system shutdown.
+    OS_SignalSend(OS_TaskSvStdInGet(), OS_SignalCreate(OS_SIG_SHUTDOWN, 0), OS_MSG_PRIO_HIGH);
+    return OS_NULL;
+}
+
+/******************************************************************************/
+Status OS_ShellStart(void)
+{
+pthread_attr_t attr;
+Status s = S_OK;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (0 != pthread_create(&shell_thread, &attr, ShellThread, OS_NULL)) { s = S_OUT_OF_MEMORY; }
+    pthread_attr_destroy(&attr);
+    return s;
+}
@@ -0,0 +1,70 @@
+/***************************************************************************//**
+* @file    os_signal.c
+* @brief   OS signals (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_signal.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define SIGNAL_TAG              (1ULL)
+#define SIGNAL_SRC_SHIFT        1
+#define SIGNAL_SRC_MASK         0x7FFFULL
+#define SIGNAL_ID_SHIFT         16
+#define SIGNAL_ID_MASK          0xFFFFULL
+#define SIGNAL_DATA_SHIFT       32
+#define SIGNAL_DATA_MASK        0xFFFFFFFFULL
+
+_Static_assert(sizeof(OS_Signal) >= sizeof(U64), "The signal data needs a 64-bit queue item.");
+
+/******************************************************************************/
+OS_Signal OS_SignalCreate(const OS_SignalId id, const OS_SignalData data)
+{
+    return OS_ISR_SignalCreate(0, id, data);
+}
+
+/******************************************************************************/
+OS_Signal OS_ISR_SignalCreate(const OS_SignalSrc src, const OS_SignalId id, const OS_SignalData data)
+{
+    return (OS_Signal)(SIGNAL_TAG |
+                       (((U64)src  & SIGNAL_SRC_MASK)  << SIGNAL_SRC_SHIFT) |
+                       (((U64)id   & SIGNAL_ID_MASK)   << SIGNAL_ID_SHIFT)  |
+                       (((U64)data & SIGNAL_DATA_MASK) << SIGNAL_DATA_SHIFT));
+}
+
+/******************************************************************************/
+Status OS_SignalSend(const OS_QueueHd qhd, const OS_Signal signal, const OS_MessagePrio prio)
+{
+    return OS_HostItemSend(qhd, (const void*)signal, OS_NO_BLOCK, prio);
+}
+
+/******************************************************************************/
+Int OS_ISR_SignalSend(const OS_QueueHd qhd, const OS_Signal signal, const OS_MessagePrio prio)
+{
+    //No preemption by the ISR on the host: a task is never woken "higher".
+    return (S_OK == OS_HostItemSend(qhd, (const void*)signal, OS_NO_BLOCK, prio)) ? 0 : -1;
+}
+
+/******************************************************************************/
+Bool OS_SignalIs(const OS_Message* msg_p)
+{
+    return (SIGNAL_TAG & (OS_Signal)msg_p) ? OS_TRUE : OS_FALSE;
+}
+
+/******************************************************************************/
+OS_SignalId OS_SignalIdGet(const OS_Message* msg_p)
+{
+    return (OS_SignalId)(((OS_Signal)msg_p >> SIGNAL_ID_SHIFT) & SIGNAL_ID_MASK);
+}
+
+/******************************************************************************/
+OS_SignalData OS_SignalDataGet(const OS_Message* msg_p)
+{
+    return (OS_SignalData)(((U64)(OS_Signal)msg_p >> SIGNAL_DATA_SHIFT) & SIGNAL_DATA_MASK);
+}
+
+/******************************************************************************/
+OS_SignalSrc OS_SignalSrcGet(const OS_Message* msg_p)
+{
+    return (OS_SignalSrc)(((OS_Signal)msg_p >> SIGNAL_SRC_SHIFT) & SIGNAL_SRC_MASK);
+}
@@ -0,0 +1,478 @@
+/***************************************************************************//**
+* @file    os_task.c
+* @brief   OS tasks, startup and supervisor (host POSIX port).
+* @author  A. Filyanov
+* @details A task is a detached thread. The deleted task exits in its own
+*          thread: the deleter wakes it up from the blocking OS call. The
+*          deleted tasks control blocks and queues are kept (never reused),
+*          so the stale handles stay safe as the target ones do.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_task.h"
+#include "os_supervise.h"
+#include "os_startup.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "task"
+
+// Deleted task exit wait (the wakeups are repeated).
+#define TASK_DELETE_WAKEUP_MS   10
+#define TASK_DELETE_TIMEOUT_MS  (OS_TIMEOUT_DEFAULT * 10)
+
+struct OS_TaskCb {
+    Str                         name[OS_TASK_NAME_LEN];
+    OS_TaskConfig               cfg;
+    OS_TaskArgs                 args;
+    OS_QueueHd                  stdin_qhd;
+    pthread_t                   thread;
+    pthread_mutex_t             mutex;          // Delay.
+    pthread_cond_t              cond;
+    pthread_cond_t*             wait_cond_p;    // The blocking call one.
+    pthread_mutex_t*            wait_mutex_p;
+    int                         is_deleting;
+    Bool                        is_thread;
+    struct OS_TaskCb*           next_p;         // Deleted tasks.
+};
+
+typedef struct OS_TaskCb TaskCb;
+
+//------------------------------------------------------------------------------
+static Status   TaskPowerCall(TaskCb* cb_p, const OS_PowerState state);
+static void*    TaskThread(void* args_p);
+static void     TaskExit(TaskCb* cb_p) __attribute__((noreturn));
+static Bool     TaskIsRegistered(const TaskCb* cb_p);
+static TaskCb*  TaskByNameGet(ConstStrP name_p);
+
+//------------------------------------------------------------------------------
+static TaskCb* tasks_v[OS_TASKS_MAX];
+static TaskCb* tasks_deleted_p;
+static pthread_mutex_t tasks_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tasks_cond;               // Task deleted, scheduler started.
+static pthread_mutex_t power_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const OS_TaskConfig* startup_v[OS_TASKS_MAX];
+static Size startup_count;
+static OS_QueueHd sv_stdin_qhd;
+static OS_PowerState power_state = PWR_STARTUP;
+static Bool is_running;
+//The current task (OS_THIS_TASK): the power callbacks run in the caller thread.
+static __thread TaskCb* task_curr_p;
+//The thread own task.
+static __thread TaskCb* task_self_p;
+
+/******************************************************************************/
+Status OS_TaskInit_(void)
+{
+const OS_QueueConfig sv_cfg = { .len = OS_SV_STDIN_LEN };
+    OS_HostCondInit(&tasks_cond);
+    return OS_QueueCreate(&sv_cfg, OS_NULL, &sv_stdin_qhd);
+}
+
+/******************************************************************************/
+Status TaskPowerCall(TaskCb* cb_p, const OS_PowerState state)
+{
+TaskCb* prev_p = task_curr_p;
+Status s = S_OK;
+    if (OS_NULL != cb_p->cfg.func_power) {
+        task_curr_p = cb_p;
+        s = cb_p->cfg.func_power(&cb_p->args, state);
+        task_curr_p = prev_p;
+    }
+    return s;
+}
+
+/******************************************************************************/
+Bool TaskIsRegistered(const TaskCb* cb_p)
+{
+    //Locked by the caller.
+    for (Size i = 0; i < OS_TASKS_MAX; ++i) {
+        if (cb_p == tasks_v[i]) { return OS_TRUE; }
+    }
+    return OS_FALSE;
+}
+
+/******************************************************************************/
+TaskCb* TaskByNameGet(ConstStrP name_p)
+{
+    //Locked by the caller.
+    for (Size i = 0; i < OS_TASKS_MAX; ++i) {
+        if ((OS_NULL != tasks_v[i]) && (0 == OS_StrCmp(tasks_v[i]->name, name_p))) { return tasks_v[i]; }
+    }
+    return OS_NULL;
+}
+
+/******************************************************************************/
+Status OS_TaskCreate(const void* args_p, const OS_TaskConfig* cfg_p, OS_TaskHd* thd_p)
+{
+const OS_QueueConfig stdin_cfg = { .len = (0 != cfg_p->stdin_len) ? cfg_p->stdin_len : OS_STDIN_LEN };
+TaskCb* cb_p;
+Size idx = OS_TASKS_MAX;
+Status s;
+
+    if ((OS_NULL == cfg_p) || (OS_NULL == cfg_p->name) || (OS_NULL == cfg_p->func_main)) { return S_INVALID_PTR; }
+    if (OS_NULL != thd_p) { *thd_p = OS_NULL; }
+    cb_p = calloc(1, sizeof(*cb_p));
+    if (OS_NULL == cb_p) { return S_OUT_OF_MEMORY; }
+    OS_StrNCpy(cb_p->name, cfg_p->name, sizeof(cb_p->name) - 1);
+    cb_p->cfg           = *cfg_p;
+    cb_p->cfg.name      = cb_p->name;
+    cb_p->args.args_p   = (OS_NULL != args_p) ? (void*)args_p : cfg_p->args_p;
+    if (0 != cfg_p->storage_size) {
+        cb_p->args.stor_p = calloc(1, cfg_p->storage_size);
+        if (OS_NULL == cb_p->args.stor_p) {
+            free(cb_p);
+            return S_OUT_OF_MEMORY;
+        }
+    }
+    pthread_mutex_init(&cb_p->mutex, OS_NULL);
+    OS_HostCondInit(&cb_p->cond);
+    IF_STATUS(s = OS_QueueCreate(&stdin_cfg, cb_p, &cb_p->stdin_qhd)) {
+        free(cb_p->args.stor_p);
+        free(cb_p);
+        return s;
+    }
+    pthread_mutex_lock(&tasks_mutex);
+    if ((BIT_TEST(cfg_p->attrs, BIT(OS_TASK_ATTR_SINGLE))) && (OS_NULL != TaskByNameGet(cb_p->name))) {
+        s = S_INVALID_STATE;
+    } else {
+        for (idx = 0; idx < OS_TASKS_MAX; ++idx) {
+            if (OS_NULL == tasks_v[idx]) {
+                //Registered before the power callbacks (OS_TaskByNameGet() of itself).
+                tasks_v[idx] = cb_p;
+                break;
+            }
+        }
+        s = (OS_TASKS_MAX > idx) ? S_OK : S_OUT_OF_MEMORY;
+    }
+    pthread_mutex_unlock(&tasks_mutex);
+    IF_OK(s) {
+        IF_OK(s = TaskPowerCall(cb_p, PWR_STARTUP)) {
+            //The system is on: the task is powered on at once.
+            if ((OS_TRUE == OS_SchedulerIsRunning()) && (PWR_ON == OS_PowerStateGet())) {
+                s = TaskPowerCall(cb_p, PWR_ON);
+            }
+        }
+        IF_OK(s) {
+            pthread_attr_t attr;
+            pthread_attr_init(&attr);
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+            if (0 != pthread_create(&cb_p->thread, &attr, TaskThread, cb_p)) {
+                s = S_OUT_OF_MEMORY;
+            } else {
+                __atomic_store_n(&cb_p->is_thread, OS_TRUE, __ATOMIC_RELEASE);
+            }
+            pthread_attr_destroy(&attr);
+        }
+        IF_STATUS(s) {
+            pthread_mutex_lock(&tasks_mutex);
+            tasks_v[idx] = OS_NULL;
+            pthread_mutex_unlock(&tasks_mutex);
+        }
+    }
+    IF_STATUS(s) {
+        OS_QueueDelete(cb_p->stdin_qhd);
+        free(cb_p->args.stor_p);
+        cb_p->args.stor_p = OS_NULL;
+        //The queue is kept with the deleted tasks.
+        pthread_mutex_lock(&tasks_mutex);
+        cb_p->next_p    = tasks_deleted_p;
+        tasks_deleted_p = cb_p;
+        pthread_mutex_unlock(&tasks_mutex);
+        return s;
+    }
+    if (OS_NULL != thd_p) { *thd_p = cb_p; }
+    return s;
+}
+
+/******************************************************************************/
+void* TaskThread(void* args_p)
+{
+TaskCb* cb_p = (TaskCb*)args_p;
+
+    task_self_p = cb_p;
+    task_curr_p = cb_p;
+    pthread_mutex_lock(&tasks_mutex);
+    while ((OS_TRUE != OS_SchedulerIsRunning()) && (0 == __atomic_load_n(&cb_p->is_deleting, __ATOMIC_SEQ_CST))) {
+        pthread_cond_wait(&tasks_cond, &tasks_mutex);
+    }
+    pthread_mutex_unlock(&tasks_mutex);
+    if (0 == __atomic_load_n(&cb_p->is_deleting, __ATOMIC_SEQ_CST)) {
+        cb_p->cfg.func_main(&cb_p->args);
+    }
+    TaskExit(cb_p);
+}
+
+/******************************************************************************/
+void TaskExit(TaskCb* cb_p)
+{
+    //The task own thread.
+    TaskPowerCall(cb_p, PWR_SHUTDOWN);
+    pthread_mutex_lock(&tasks_mutex);
+    for (Size i = 0; i < OS_TASKS_MAX; ++i) {
+        if (cb_p == tasks_v[i]) { tasks_v[i] = OS_NULL; }
+    }
+    cb_p->next_p    = tasks_deleted_p;
+    tasks_deleted_p = cb_p;
+    OS_QueueDelete(cb_p->stdin_qhd);
+    free(cb_p->args.stor_p);
+    cb_p->args.stor_p = OS_NULL;
+    pthread_cond_broadcast(&tasks_cond);
+    pthread_mutex_unlock(&tasks_mutex);
+    pthread_exit(OS_NULL);
+}
+
+/******************************************************************************/
+Status OS_TaskDelete(const OS_TaskHd thd)
+{
+TaskCb* cb_p = (OS_THIS_TASK == thd) ? task_curr_p : thd;
+struct timespec deadline;
+OS_TimeMs wait_ms = 0;
+Status s = S_OK;
+
+    if (OS_NULL == cb_p) { return S_INVALID_TASK; }
+    if (task_self_p == cb_p) { TaskExit(cb_p); }
+    __atomic_store_n(&cb_p->is_deleting, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&tasks_mutex);
+    while (OS_TRUE == TaskIsRegistered(cb_p)) {
+        pthread_mutex_t* wait_mutex_p = __atomic_load_n(&cb_p->wait_mutex_p, __ATOMIC_SEQ_CST);
+        pthread_cond_t* wait_cond_p = __atomic_load_n(&cb_p->wait_cond_p, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&tasks_mutex);
+        //Wake up the task blocked in the OS call.
+        pthread_mutex_lock(&cb_p->mutex);
+        pthread_cond_broadcast(&cb_p->cond);
+        pthread_mutex_unlock(&cb_p->mutex);
+        if ((OS_NULL != wait_mutex_p) && (OS_NULL != wait_cond_p)) {
+            pthread_mutex_lock(wait_mutex_p);
+            pthread_cond_broadcast(wait_cond_p);
+            pthread_mutex_unlock(wait_mutex_p);
+        }
+        pthread_mutex_lock(&tasks_mutex);
+        pthread_cond_broadcast(&tasks_cond);
+        if (TASK_DELETE_TIMEOUT_MS <= wait_ms) {
+            s = S_TIMEOUT;
+            break;
+        }
+        OS_HostDeadlineGet(MS_TO_US(TASK_DELETE_WAKEUP_MS), &deadline);
+        pthread_cond_timedwait(&tasks_cond, &tasks_mutex, &deadline);
+        wait_ms += TASK_DELETE_WAKEUP_MS;
+    }
+    pthread_mutex_unlock(&tasks_mutex);
+    return s;
+}
+
+/******************************************************************************/
+Bool OS_HostTaskWaitSet(pthread_cond_t* cond_p, pthread_mutex_t* mutex_p)
+{
+TaskCb* cb_p = task_self_p;
+    if (OS_NULL == cb_p) { return OS_FALSE; }
+    __atomic_store_n(&cb_p->wait_cond_p, cond_p, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&cb_p->wait_mutex_p, mutex_p, __ATOMIC_SEQ_CST);
+    return (0 != __atomic_load_n(&cb_p->is_deleting, __ATOMIC_SEQ_CST)) ? OS_TRUE : OS_FALSE;
+}
+
+/******************************************************************************/
+void OS_HostTaskExitCheck(void)
+{
+TaskCb* cb_p = task_self_p;
+    if ((OS_NULL != cb_p) && (0 != __atomic_load_n(&cb_p->is_deleting, __ATOMIC_SEQ_CST))) {
+        TaskExit(cb_p);
+    }
+}
+
+/******************************************************************************/
+void OS_TaskDelay(const OS_TimeMs timeout)
+{
+TaskCb* cb_p = task_self_p;
+struct timespec deadline;
+
+    OS_HostDeadlineGet(MS_TO_US(timeout), &deadline);
+    if (OS_NULL == cb_p) {
+        //Not a task thread.
+        while (0 != clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, OS_NULL)) {}
+        return;
+    }
+    pthread_mutex_lock(&cb_p->mutex);
+    while (OS_TRUE != OS_HostTaskWaitSet(&cb_p->cond, &cb_p->mutex)) {
+        IF_STATUS(OS_HostCondWait(&cb_p->cond, &cb_p->mutex, timeout, &deadline)) { break; }
+    }
+    OS_HostTaskWaitSet(OS_NULL, OS_NULL);
+    pthread_mutex_unlock(&cb_p->mutex);
+    OS_HostTaskExitCheck();
+}
+
+/******************************************************************************/
+void OS_TaskYield(void)
+{
+    sched_yield();
+}
+
+/******************************************************************************/
+void OS_ContextSwitchForce(void)
+{
+    sched_yield();
+}
+
+/******************************************************************************/
+OS_TaskHd OS_TaskGet(void)
+{
+    return task_curr_p;
+}
+
+/******************************************************************************/
+OS_TaskHd OS_TaskByNameGet(ConstStrP name_p)
+{
+TaskCb* cb_p;
+    if (OS_NULL == name_p) { return OS_NULL; }
+    pthread_mutex_lock(&tasks_mutex);
+    cb_p = TaskByNameGet(name_p);
+    pthread_mutex_unlock(&tasks_mutex);
+    return cb_p;
+}
+
+/******************************************************************************/
+ConstStrP OS_TaskNameGet(const OS_TaskHd thd)
+{
+const TaskCb* cb_p = (OS_THIS_TASK == thd) ? task_curr_p : thd;
+    return (OS_NULL != cb_p) ? cb_p->name : OS_NULL;
+}
+
+/******************************************************************************/
+OS_QueueHd OS_TaskStdInGet(const OS_TaskHd thd)
+{
+const TaskCb* cb_p = (OS_THIS_TASK == thd) ? task_curr_p : thd;
+    return (OS_NULL != cb_p) ? cb_p->stdin_qhd : OS_NULL;
+}
+
+/******************************************************************************/
+OS_QueueHd OS_TaskStdIoGet(const OS_TaskHd thd, const OS_StdIo stdio)
+{
+    return (OS_STDIO_IN == stdio) ? OS_TaskStdInGet(thd) : OS_NULL;
+}
+
+/******************************************************************************/
+Status OS_TaskPrioritySet(const OS_TaskHd thd, const OS_TaskPrio prio)
+{
+TaskCb* cb_p = (OS_THIS_TASK == thd) ? task_curr_p : thd;
+    if (OS_NULL == cb_p) { return S_INVALID_TASK; }
+    cb_p->cfg.prio_init = prio;
+    return S_OK;
+}
+
+/******************************************************************************/
+U64 OS_TaskCpuTimeGet(const OS_TaskHd thd)
+{
+const TaskCb* cb_p = (OS_THIS_TASK == thd) ? task_curr_p : thd;
+clockid_t clock_id;
+struct timespec ts;
+    if ((OS_NULL == cb_p) || (OS_TRUE != __atomic_load_n(&cb_p->is_thread, __ATOMIC_ACQUIRE))) { return 0; }
+    if (0 != pthread_getcpuclockid(cb_p->thread, &clock_id)) { return 0; }
+    if (0 != clock_gettime(clock_id, &ts)) { return 0; }
+    return ((U64)ts.tv_sec * 1000000ULL) + ((U64)ts.tv_nsec / 1000);
+}
+
+/******************************************************************************/
+Status OS_StartupTaskAdd(const OS_TaskConfig* cfg_p)
+{
+    if (OS_NULL == cfg_p) { return S_INVALID_PTR; }
+    if (OS_TASKS_MAX <= startup_count) { return S_OUT_OF_MEMORY; }
+    startup_v[startup_count++] = cfg_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+OS_QueueHd OS_TaskSvStdInGet(void)
+{
+    return sv_stdin_qhd;
+}
+
+/******************************************************************************/
+OS_PowerState OS_PowerStateGet(void)
+{
+    return __atomic_load_n(&power_state, __ATOMIC_SEQ_CST);
+}
+
+/******************************************************************************/
+Status OS_PowerStateSet(const OS_PowerState state)
+{
+TaskCb* snapshot_v[OS_TASKS_MAX];
+Size count = 0;
+Status s = S_OK;
+
+    if ((PWR_UNDEF == state) || (PWR_LAST <= state)) { return S_INVALID_VALUE; }
+    pthread_mutex_lock(&power_mutex);
+    pthread_mutex_lock(&tasks_mutex);
+    for (Size i = 0; i < OS_TASKS_MAX; ++i) {
+        if (OS_NULL != tasks_v[i]) { snapshot_v[count++] = tasks_v[i]; }
+    }
+    pthread_mutex_unlock(&tasks_mutex);
+    //Higher power priority goes first.
+    for (Size i = 1; i < count; ++i) {
+        TaskCb* cb_p = snapshot_v[i];
+        Size j = i;
+        for (; (0 < j) && (snapshot_v[j - 1]->cfg.prio_power < cb_p->cfg.prio_power); --j) {
+            snapshot_v[j] = snapshot_v[j - 1];
+        }
+        snapshot_v[j] = cb_p;
+    }
+    for (Size i = 0; i < count; ++i) {
+        const Status res = TaskPowerCall(snapshot_v[i], state);
+        IF_STATUS(res) {
+            OS_LOG(D_WARNING, "%s: power state %u", snapshot_v[i]->name, state);
+            if (S_OK == s) { s = res; }
+        }
+    }
+    __atomic_store_n(&power_state, state, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&power_mutex);
+    return s;
+}
+
+/******************************************************************************/
+Bool OS_SchedulerIsRunning(void)
+{
+    return __atomic_load_n(&is_running, __ATOMIC_SEQ_CST);
+}
+
+/******************************************************************************/
+void OS_SchedulerStart(void)
+{
+OS_Message* msg_p;
+Status s;
+
+    for (Size i = 0; i < startup_count; ++i) {
+        IF_STATUS(s = OS_TaskCreate(OS_NULL, startup_v[i], OS_NULL)) {
+            OS_LOG(D_CRITICAL, "%s: create", startup_v[i]->name);
+            OS_LOG_S(D_CRITICAL, s);
+        }
+    }
+    OS_PowerStateSet(PWR_ON);
+    pthread_mutex_lock(&tasks_mutex);
+    __atomic_store_n(&is_running, OS_TRUE, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&tasks_cond);
+    pthread_mutex_unlock(&tasks_mutex);
+    //Supervisor.
+    for (;;) {
+        IF_OK(OS_MessageReceive(sv_stdin_qhd, &msg_p, OS_BLOCK)) {
+            if (OS_SignalIs(msg_p)) {
+                switch (OS_SignalIdGet(msg_p)) {
+                    case OS_SIG_SHUTDOWN:
+                    case OS_SIG_REBOOT:
+                        OS_LOG(D_INFO, "Shutdown...");
+                        OS_PowerStateSet(PWR_SHUTDOWN);
+                        fflush(stdout);
+                        exit(EXIT_SUCCESS);
+                        break;
+                    default:
+                        OS_LOG_S(D_DEBUG, S_UNDEF_SIG);
+                        break;
+                }
+            } else {
+                OS_LOG_S(D_DEBUG, S_UNDEF_MSG);
+                OS_MessageDelete(msg_p);
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+* @file    os_time.c
+* @brief   OS time (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <errno.h>
+#include "os_time.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+static struct timespec time_start;
+static pthread_once_t time_once = PTHREAD_ONCE_INIT;
+
+static void     TimeStart(void);
+
+/******************************************************************************/
+void TimeStart(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &time_start);
+}
+
+/******************************************************************************/
+Status OS_TimeInit(void)
+{
+    pthread_once(&time_once, TimeStart);
+    return S_OK;
+}
+
+/******************************************************************************/
+U64 OS_TimeUsGet(void)
+{
+struct timespec ts;
+    pthread_once(&time_once, TimeStart);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (U64)((((S64)(ts.tv_sec - time_start.tv_sec) * 1000000000LL) +
+                  ((S64)ts.tv_nsec - (S64)time_start.tv_nsec)) / 1000);
+}
+
+/******************************************************************************/
+OS_Tick OS_TickCountGet(void)
+{
+    return (OS_Tick)(OS_TimeUsGet() / 1000);
+}
+
+/******************************************************************************/
+void OS_HostCondInit(pthread_cond_t* cond_p)
+{
+pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond_p, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/******************************************************************************/
+void OS_HostDeadlineGet(const U64 timeout_us, struct timespec* ts_p)
+{
+U64 ns;
+    clock_gettime(CLOCK_MONOTONIC, ts_p);
+    ns = (U64)ts_p->tv_nsec + US_TO_NS(timeout_us);
+    ts_p->tv_sec += (time_t)(ns / 1000000000ULL);
+    ts_p->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+/******************************************************************************/
+Status OS_HostCondWait(pthread_cond_t* cond_p, pthread_mutex_t* mutex_p, const OS_TimeMs timeout,
+                       const struct timespec* ts_p)
+{
+    if (OS_BLOCK == timeout) {
+        pthread_cond_wait(cond_p, mutex_p);
+        return S_OK;
+    }
+    return (ETIMEDOUT == pthread_cond_timedwait(cond_p, mutex_p, ts_p)) ? S_TIMEOUT : S_OK;
+}
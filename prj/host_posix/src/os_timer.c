@@ -0,0 +1,222 @@
+/***************************************************************************//**
+* @file    os_timer.c
+* @brief   OS timers (host POSIX port).
+* @author  A. Filyanov
+* @details The timers are served by one thread waiting for the nearest
+*          deadline. The expired timer sends the signal to its slot queue
+*          with no block, as the target timer service does.
+*******************************************************************************/
+#include <stdlib.h>
+#include "os_debug.h"
+#include "os_time.h"
+#include "os_signal.h"
+#include "os_timer.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "timer"
+
+struct OS_TimerCb {
+    Str                         name[OS_TIMER_NAME_LEN];
+    OS_TimerConfig              cfg;
+    U64                         deadline;       // us.
+    Bool                        is_active;
+    Bool                        is_deleted;
+    struct OS_TimerCb*          next_p;
+};
+
+typedef struct OS_TimerCb TimerCb;
+
+//------------------------------------------------------------------------------
+static void*    TimersThread(void* args_p);
+static void     TimerFire(TimerCb* cb_p, const U64 now);
+static void     TimerArm(TimerCb* cb_p);
+
+//------------------------------------------------------------------------------
+//The deleted timers are kept (stale handles are safe).
+static TimerCb* timers_p;
+static pthread_mutex_t timers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timers_cond;
+static pthread_t timers_thread;
+
+/******************************************************************************/
+Status OS_TimerInit(void)
+{
+pthread_attr_t attr;
+Status s = S_OK;
+    OS_HostCondInit(&timers_cond);
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (0 != pthread_create(&timers_thread, &attr, TimersThread, OS_NULL)) { s = S_OUT_OF_MEMORY; }
+    pthread_attr_destroy(&attr);
+    return s;
+}
+
+/******************************************************************************/
+void* TimersThread(void* args_p)
+{
+struct timespec deadline;
+    (void)args_p;
+    pthread_mutex_lock(&timers_mutex);
+    for (;;) {
+        TimerCb* next_p = OS_NULL;
+        const U64 now = OS_TimeUsGet();
+        for (TimerCb* cb_p = timers_p; OS_NULL != cb_p; cb_p = cb_p->next_p) {
+            if (OS_TRUE != cb_p->is_active) { continue; }
+            if (now >= cb_p->deadline) {
+                TimerFire(cb_p, now);
+                if (OS_TRUE != cb_p->is_active) { continue; }
+            }
+            if ((OS_NULL == next_p) || (next_p->deadline > cb_p->deadline)) { next_p = cb_p; }
+        }
+        if (OS_NULL == next_p) {
+            pthread_cond_wait(&timers_cond, &timers_mutex);
+        } else {
+            OS_HostDeadlineGet(next_p->deadline - now, &deadline);
+            pthread_cond_timedwait(&timers_cond, &timers_mutex, &deadline);
+        }
+    }
+    return OS_NULL;
+}
+
+/******************************************************************************/
+void TimerFire(TimerCb* cb_p, const U64 now)
+{
+const Bool is_event = BIT_TEST(cb_p->cfg.options, BIT(OS_TIM_OPT_EVENT)) ? OS_TRUE : OS_FALSE;
+const OS_Signal signal = OS_SignalCreate((OS_TRUE == is_event) ? OS_SIG_EVENT : OS_SIG_TIMER, cb_p->cfg.id);
+    //Locked by the caller.
+    if (OS_NULL != cb_p->cfg.slot) {
+        IF_STATUS(OS_SignalSend(cb_p->cfg.slot, signal, OS_MSG_PRIO_NORMAL)) {
+            OS_LOG(D_DEBUG, "%s: slot is full", cb_p->name);
+        }
+    }
+    if (BIT_TEST(cb_p->cfg.options, BIT(OS_TIM_OPT_PERIODIC))) {
+        cb_p->deadline += MS_TO_US(cb_p->cfg.period);
+        //Late for the whole periods: the missed ones are skipped.
+        if (now >= cb_p->deadline) {
+            cb_p->deadline = now + MS_TO_US(cb_p->cfg.period);
+        }
+    } else {
+        cb_p->is_active = OS_FALSE;
+    }
+}
+
+/******************************************************************************/
+void TimerArm(TimerCb* cb_p)
+{
+    //Locked by the caller.
+    cb_p->deadline  = OS_TimeUsGet() + MS_TO_US(cb_p->cfg.period);
+    cb_p->is_active = OS_TRUE;
+    pthread_cond_signal(&timers_cond);
+}
+
+/******************************************************************************/
+Status OS_TimerCreate(const OS_TimerConfig* cfg_p, OS_TimerHd* timer_hd_p)
+{
+TimerCb* cb_p;
+    if ((OS_NULL == cfg_p) || (OS_NULL == timer_hd_p)) { return S_INVALID_PTR; }
+    if (0 == cfg_p->period) { return S_INVALID_VALUE; }
+    cb_p = calloc(1, sizeof(*cb_p));
+    if (OS_NULL == cb_p) { return S_OUT_OF_MEMORY; }
+    if (OS_NULL != cfg_p->name_p) {
+        OS_StrNCpy(cb_p->name, cfg_p->name_p, sizeof(cb_p->name) - 1);
+    }
+    cb_p->cfg           = *cfg_p;
+    cb_p->cfg.name_p    = cb_p->name;
+    pthread_mutex_lock(&timers_mutex);
+    cb_p->next_p = timers_p;
+    timers_p     = cb_p;
+    pthread_mutex_unlock(&timers_mutex);
+    *timer_hd_p = cb_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_TimerDelete(const OS_TimerHd timer_hd, const OS_TimeMs timeout)
+{
+Status s = S_OK;
+    (void)timeout;
+    if (OS_NULL == timer_hd) { return S_INVALID_TIMER; }
+    pthread_mutex_lock(&timers_mutex);
+    if (OS_TRUE == timer_hd->is_deleted) {
+        s = S_INVALID_TIMER;
+    } else {
+        timer_hd->is_active  = OS_FALSE;
+        timer_hd->is_deleted = OS_TRUE;
+    }
+    pthread_mutex_unlock(&timers_mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_TimerStart(const OS_TimerHd timer_hd, const OS_TimeMs timeout)
+{
+Status s = S_OK;
+    (void)timeout;
+    if (OS_NULL == timer_hd) { return S_INVALID_TIMER; }
+    pthread_mutex_lock(&timers_mutex);
+    if (OS_TRUE == timer_hd->is_deleted) {
+        s = S_INVALID_TIMER;
+    } else {
+        TimerArm(timer_hd);
+    }
+    pthread_mutex_unlock(&timers_mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_TimerStop(const OS_TimerHd timer_hd, const OS_TimeMs timeout)
+{
+Status s = S_OK;
+    (void)timeout;
+    if (OS_NULL == timer_hd) { return S_INVALID_TIMER; }
+    pthread_mutex_lock(&timers_mutex);
+    if (OS_TRUE == timer_hd->is_deleted) {
+        s = S_INVALID_TIMER;
+    } else {
+        timer_hd->is_active = OS_FALSE;
+    }
+    pthread_mutex_unlock(&timers_mutex);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_TimerReset(const OS_TimerHd timer_hd, const OS_TimeMs timeout)
+{
+    return OS_TimerStart(timer_hd, timeout);
+}
+
+/******************************************************************************/
+Status OS_TimerPeriodSet(const OS_TimerHd timer_hd, const OS_TimeMs period, const OS_TimeMs timeout)
+{
+Status s = S_OK;
+    (void)timeout;
+    if (OS_NULL == timer_hd) { return S_INVALID_TIMER; }
+    if (0 == period) { return S_INVALID_VALUE; }
+    pthread_mutex_lock(&timers_mutex);
+    if (OS_TRUE == timer_hd->is_deleted) {
+        s = S_INVALID_TIMER;
+    } else {
+        timer_hd->cfg.period = period;
+        TimerArm(timer_hd);
+    }
+    pthread_mutex_unlock(&timers_mutex);
+    return s;
+}
+
+/******************************************************************************/
+OS_TimerId OS_TimerIdGet(const OS_TimerHd timer_hd)
+{
+    return (OS_NULL != timer_hd) ? timer_hd->cfg.id : 0;
+}
+
+/******************************************************************************/
+Bool OS_TimerIsActive(const OS_TimerHd timer_hd)
+{
+Bool is_active;
+    if (OS_NULL == timer_hd) { return OS_FALSE; }
+    pthread_mutex_lock(&timers_mutex);
+    is_active = timer_hd->is_active;
+    pthread_mutex_unlock(&timers_mutex);
+    return is_active;
+}
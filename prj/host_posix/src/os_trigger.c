@@ -0,0 +1,87 @@
+/***************************************************************************//**
+* @file    os_trigger.c
+* @brief   OS triggers (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdlib.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_trigger.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "trigger"
+
+struct OS_TriggerCb {
+    OS_TimerHd                  timer_hd;
+    OS_TriggerItem*             item_p;
+    OS_TriggerState             state;
+};
+
+/******************************************************************************/
+Status OS_TriggerItemCreate(void* data_p, const Size size, OS_TriggerItem** item_pp)
+{
+OS_TriggerItem* item_p;
+pthread_mutex_t* mutex_p;
+    if (OS_NULL == item_pp) { return S_INVALID_PTR; }
+    item_p  = OS_Malloc(sizeof(*item_p));
+    mutex_p = OS_Malloc(sizeof(*mutex_p));
+    if ((OS_NULL == item_p) || (OS_NULL == mutex_p)) {
+        OS_Free(item_p);
+        OS_Free(mutex_p);
+        return S_OUT_OF_MEMORY;
+    }
+    pthread_mutex_init(mutex_p, OS_NULL);
+    item_p->data_p  = data_p;
+    item_p->size    = size;
+    item_p->mutex_p = mutex_p;
+    *item_pp = item_p;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_TriggerItemDelete(OS_TriggerItem* item_p)
+{
+    if (OS_NULL == item_p) { return S_INVALID_PTR; }
+    pthread_mutex_destroy(item_p->mutex_p);
+    OS_Free(item_p->mutex_p);
+    OS_Free(item_p);
+    return S_OK;
+}
+
+/******************************************************************************/
+Status OS_TriggerCreate(const OS_TriggerConfig* cfg_p, OS_TriggerHd* trigger_hd_p)
+{
+struct OS_TriggerCb* cb_p;
+Status s;
+    if ((OS_NULL == cfg_p) || (OS_NULL == cfg_p->timer_cfg_p) || (OS_NULL == trigger_hd_p)) { return S_INVALID_PTR; }
+    *trigger_hd_p = OS_NULL;
+    cb_p = OS_Malloc(sizeof(*cb_p));
+    if (OS_NULL == cb_p) { return S_OUT_OF_MEMORY; }
+    cb_p->item_p= cfg_p->item_p;
+    cb_p->state = cfg_p->state;
+    IF_OK(s = OS_TimerCreate(cfg_p->timer_cfg_p, &cb_p->timer_hd)) {
+        IF_OK(s = OS_HostEventItemBind(cfg_p->timer_cfg_p->id, cfg_p->item_p)) {
+            IF_OK(s = OS_TimerStart(cb_p->timer_hd, OS_NO_BLOCK)) {
+                *trigger_hd_p = cb_p;
+                return s;
+            }
+            OS_HostEventItemUnbind(cfg_p->timer_cfg_p->id);
+        }
+        OS_TimerDelete(cb_p->timer_hd, OS_NO_BLOCK);
+    }
+    OS_Free(cb_p);
+    return s;
+}
+
+/******************************************************************************/
+Status OS_TriggerDelete(const OS_TriggerHd trigger_hd, const OS_TimeMs timeout)
+{
+Status s;
+    if (OS_NULL == trigger_hd) { return S_INVALID_PTR; }
+    OS_HostEventItemUnbind(OS_TimerIdGet(trigger_hd->timer_hd));
+    IF_OK(s = OS_TimerDelete(trigger_hd->timer_hd, timeout)) {
+        OS_Free(trigger_hd);
+    }
+    return s;
+}
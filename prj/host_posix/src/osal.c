@@ -0,0 +1,25 @@
+/***************************************************************************//**
+* @file    osal.c
+* @brief   OS abstraction layer init (host POSIX port).
+* @author  A. Filyanov
+*******************************************************************************/
+#include "osal.h"
+#include "os_host.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "osal"
+
+/******************************************************************************/
+Status OSAL_Init(void)
+{
+Status s;
+    IF_STATUS(s = OS_TimeInit())        { return s; }
+    IF_STATUS(s = OS_MemoryInit())      { return s; }
+    IF_STATUS(s = OS_DebugInit())       { return s; }
+    IF_STATUS(s = OS_TaskInit_())       { return s; }
+    IF_STATUS(s = OS_TimerInit())       { return s; }
+    IF_STATUS(s = OS_DriverInit_())     { return s; }
+    IF_STATUS(s = OS_FileSystemInit())  { return s; }
+    IF_STATUS(s = OS_AudioInit())       { return s; }
+    return s;
+}
@@ -0,0 +1,260 @@
+/***************************************************************************//**
+* @file    host_test.c
+* @brief   Host tests harness.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "os_time.h"
+#include "os_task.h"
+#include "os_supervise.h"
+#include "os_file_system.h"
+#include "os_mailbox.h"
+#include "audio_codec.h"
+#include "crc32.h"
+#include "msg_pool.h"
+#include "task_mmplay.h"
+#include "task_mmplay_ctl.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define HOST_TEST_START_TIMEOUT_MS  5000
+#define HOST_TEST_CONNECT_TIMEOUT_MS 3000
+#define HOST_TEST_PLAY_TIMEOUT_MS   5000
+#define HOST_TEST_WAV_HEADER_SIZE   44
+
+//------------------------------------------------------------------------------
+void AppMain(void);
+
+static void*    AppThread(void* args_p);
+static Int      U32Compare(const void* a_p, const void* b_p);
+
+//------------------------------------------------------------------------------
+static U32 checks_count;
+static U32 fails_count;
+
+/******************************************************************************/
+void* AppThread(void* args_p)
+{
+    (void)args_p;
+    AppMain();
+    return OS_NULL;
+}
+
+/******************************************************************************/
+Status HostTestStart(void)
+{
+pthread_t app_thread;
+U32 wait_ms = 0;
+    setvbuf(stdout, OS_NULL, _IOLBF, 0);
+    if (0 != pthread_create(&app_thread, OS_NULL, AppThread, OS_NULL)) { return S_OUT_OF_MEMORY; }
+    pthread_detach(app_thread);
+    //The codecs are inited by BgServ (the deferred init).
+    while ((OS_TRUE != OS_SchedulerIsRunning()) || (OS_NULL == AudioCodecGet(AUDIO_FORMAT_WAV))) {
+        if (HOST_TEST_START_TIMEOUT_MS <= wait_ms) { return S_TIMEOUT; }
+        usleep(10000);
+        wait_ms += 10;
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Bool HostTestCheck(const Bool is_ok, ConstStrP file_p, const U32 line, ConstStrP expr_p)
+{
+    ++checks_count;
+    if (OS_TRUE != is_ok) {
+        ++fails_count;
+        printf("\nFAIL %s:%u: %s", file_p, line, expr_p);
+    }
+    return is_ok;
+}
+
+/******************************************************************************/
+Int HostTestEnd(void)
+{
+    printf("\n%s: %u checks, %u failed\n", (0 == fails_count) ? "PASS" : "FAIL", checks_count, fails_count);
+    fflush(stdout);
+    return (0 == fails_count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/******************************************************************************/
+Int U32Compare(const void* a_p, const void* b_p)
+{
+const U32 a = *(const U32*)a_p;
+const U32 b = *(const U32*)b_p;
+    return (a > b) - (a < b);
+}
+
+/******************************************************************************/
+U32 HostTestPercentileGet(U32* values_p, const Size count, const U32 percent)
+{
+Size idx;
+    if ((OS_NULL == values_p) || (0 == count)) { return 0; }
+    qsort(values_p, count, sizeof(U32), U32Compare);
+    idx = (Size)(((U64)(count - 1) * percent) / 100);
+    return values_p[idx];
+}
+
+/******************************************************************************/
+Status HostTestFileWrite(ConstStrP path_p, const void* data_p, const U32 size)
+{
+OS_FileHd file_hd;
+Status s;
+    IF_OK(s = OS_FileOpen(&file_hd, path_p, BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        s = OS_FileWrite(file_hd, data_p, size);
+        OS_FileClose(&file_hd);
+    }
+    return s;
+}
+
+/******************************************************************************/
+U8* HostTestWavRampBuild(const U32 sample_rate, const U16 channels, const U32 frames, U32* size_p)
+{
+const U32 data_size = frames * channels * sizeof(S16);
+const U32 fields_v[] = {
+    0x46464952, 36 + data_size, 0x45564157,                 // "RIFF", size, "WAVE"
+    0x20746D66, 16,                                         // "fmt ", size
+    1 | ((U32)channels << 16), sample_rate,                 // PCM, channels, sample rate
+    sample_rate * channels * sizeof(S16),                   // Byte rate
+    (channels * sizeof(S16)) | (16 << 16),                  // Block align, bits
+    0x61746164, data_size                                   // "data", size
+};
+U8* file_p = malloc(HOST_TEST_WAV_HEADER_SIZE + data_size);
+S16* sample_p = (S16*)(file_p + HOST_TEST_WAV_HEADER_SIZE);
+    if (OS_NULL == file_p) { return OS_NULL; }
+    OS_MemCpy(file_p, fields_v, sizeof(fields_v));
+    for (U32 i = 0; i < frames; ++i) {
+        for (U16 ch = 0; ch < channels; ++ch) {
+            *sample_p++ = (S16)(i & HOST_TEST_RAMP_MASK);
+        }
+    }
+    *size_p = HOST_TEST_WAV_HEADER_SIZE + data_size;
+    return file_p;
+}
+
+/******************************************************************************/
+Status HostTestWavRampWrite(ConstStrP path_p, const U32 sample_rate, const U16 channels, const U32 frames)
+{
+U32 size;
+U8* file_p = HostTestWavRampBuild(sample_rate, channels, frames, &size);
+Status s;
+    if (OS_NULL == file_p) { return S_OUT_OF_MEMORY; }
+    s = HostTestFileWrite(path_p, file_p, size);
+    free(file_p);
+    return s;
+}
+
+/******************************************************************************/
+Status HostTestPlayStart(ConstStrP path_p)
+{
+const OS_TaskHd mmplay_ctl_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY_CTL);
+OS_Message* msg_p;
+U32 wait_ms = 0;
+Status s;
+    if (OS_NULL == mmplay_ctl_thd) { return S_INVALID_STATE; }
+    //The player is started by the control task (as by the shell).
+    msg_p = MsgPoolCreate(OS_MSG_MMPLAY_CTL_OPEN, OS_StrLen(path_p) + 1, OS_NO_BLOCK, path_p);
+    if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+    IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(mmplay_ctl_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+        MsgPoolDelete(msg_p);
+        return s;
+    }
+    while (OS_NULL == OS_TaskByNameGet(APP_TASK_NAME_MMPLAY)) {
+        if (HOST_TEST_PLAY_TIMEOUT_MS <= wait_ms) { return S_TIMEOUT; }
+        usleep(1000);
+        ++wait_ms;
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status HostTestPlayEndWait(const U32 timeout_ms)
+{
+U32 wait_ms = 0;
+    while (OS_NULL != OS_TaskByNameGet(APP_TASK_NAME_MMPLAY)) {
+        if (timeout_ms <= wait_ms) { return S_TIMEOUT; }
+        usleep(10000);
+        wait_ms += 10;
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+Int HostTestConnect(const U16 port)
+{
+struct sockaddr_in addr = {
+    .sin_family = AF_INET,
+    .sin_port   = htons(port),
+};
+const Int on = 1;
+U32 wait_ms = 0;
+Int sd;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    //The service may still be starting.
+    while (HOST_TEST_CONNECT_TIMEOUT_MS > wait_ms) {
+        sd = socket(AF_INET, SOCK_STREAM, 0);
+        if (0 > sd) { return -1; }
+        if (0 == connect(sd, (struct sockaddr*)&addr, sizeof(addr))) {
+            setsockopt(sd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            return sd;
+        }
+        close(sd);
+        usleep(10000);
+        wait_ms += 10;
+    }
+    return -1;
+}
+
+/******************************************************************************/
+Status HostTestFrameSend(const Int sd, const U8 type, const U16 seq, const void* payload_p, const U16 len,
+                         const Bool is_crc_bad)
+{
+U8 frame_v[sizeof(NetCtrlHdr) + NET_CTRL_PAYLOAD_MAX + sizeof(U32)];
+const NetCtrlHdr hdr = {
+    .sync   = NET_CTRL_SYNC,
+    .type   = type,
+    .seq    = seq,
+    .len    = len
+};
+const Size size = sizeof(hdr) + len + sizeof(U32);
+U32 crc;
+    if (NET_CTRL_PAYLOAD_MAX < len) { return S_INVALID_SIZE; }
+    OS_MemCpy(frame_v, &hdr, sizeof(hdr));
+    OS_MemCpy(frame_v + sizeof(hdr), payload_p, len);
+    crc = Crc32(frame_v, sizeof(hdr) + len);
+    if (OS_TRUE == is_crc_bad) { crc = ~crc; }
+    OS_MemCpy(frame_v + sizeof(hdr) + len, &crc, sizeof(crc));
+    if ((ssize_t)size != send(sd, frame_v, size, 0)) { return S_HARDWARE_ERROR; }
+    return S_OK;
+}
+
+/******************************************************************************/
+Status HostTestFrameReceive(const Int sd, NetCtrlHdr* hdr_p, U8* payload_p, const Size payload_max,
+                            Bool* is_crc_ok_p)
+{
+U32 crc;
+U32 crc_calc;
+    if (sizeof(NetCtrlHdr) != recv(sd, hdr_p, sizeof(NetCtrlHdr), MSG_WAITALL)) { return S_TIMEOUT; }
+    if ((NET_CTRL_SYNC != hdr_p->sync) || (payload_max < hdr_p->len)) { return S_INVALID_VALUE; }
+    if ((ssize_t)hdr_p->len != recv(sd, payload_p, hdr_p->len, MSG_WAITALL)) { return S_TIMEOUT; }
+    if (sizeof(crc) != recv(sd, &crc, sizeof(crc), MSG_WAITALL)) { return S_TIMEOUT; }
+    //CRC32 covers the header and the payload.
+    crc_calc = Crc32((U8*)hdr_p, sizeof(NetCtrlHdr));
+    if (0 != hdr_p->len) {
+        crc_calc = Crc32Combine(crc_calc, Crc32(payload_p, hdr_p->len), hdr_p->len);
+    }
+    *is_crc_ok_p = (crc == crc_calc);
+    return S_OK;
+}
+
+/******************************************************************************/
+U64 HostTestTimeUsGet(void)
+{
+    return OS_TimeUsGet();
+}
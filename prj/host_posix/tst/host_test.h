@@ -0,0 +1,109 @@
+/***************************************************************************//**
+* @file    host_test.h
+* @brief   Host tests harness.
+* @author  A. Filyanov
+* @details The firmware runs in the test process: AppMain() in its own thread,
+*          the test in the process main thread.
+*******************************************************************************/
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+
+#include "os_common.h"
+#include "net_ctrl.h"
+
+//------------------------------------------------------------------------------
+#define HOST_TEST_RAMP_MASK     0x7FFF
+
+#define HOST_TEST_CHECK(e)      HostTestCheck((e) ? OS_TRUE : OS_FALSE, __FILE__, __LINE__, #e)
+
+//------------------------------------------------------------------------------
+/// @brief      Start the firmware and wait it is ready (the tasks are run and
+///             the deferred init is done).
+/// @return     #Status.
+Status          HostTestStart(void);
+
+/// @brief      Check the test condition (the failure is logged and counted).
+/// @param[in]  is_ok          Condition.
+/// @param[in]  file_p         Source file.
+/// @param[in]  line           Source line.
+/// @param[in]  expr_p         Condition expression.
+/// @return     Condition.
+Bool            HostTestCheck(const Bool is_ok, ConstStrP file_p, const U32 line, ConstStrP expr_p);
+
+/// @brief      End the test.
+/// @return     Process exit code.
+Int             HostTestEnd(void);
+
+/// @brief      Get the percentile of the values (sorted in place).
+/// @param[in,out] values_p    Values.
+/// @param[in]  count          Values count.
+/// @param[in]  percent        Percentile (0..100).
+/// @return     Value.
+U32             HostTestPercentileGet(U32* values_p, const Size count, const U32 percent);
+
+/// @brief      Write the file to the firmware file system.
+/// @param[in]  path_p         Path ("N:/...").
+/// @param[in]  data_p         Data.
+/// @param[in]  size           Size.
+/// @return     #Status.
+Status          HostTestFileWrite(ConstStrP path_p, const void* data_p, const U32 size);
+
+/// @brief      Build the WAV file image (PCM S16) of the ramp: every channel
+///             sample of the frame N is (N & HOST_TEST_RAMP_MASK).
+/// @param[in]  sample_rate    Sample rate.
+/// @param[in]  channels       Channels.
+/// @param[in]  frames         Sample frames.
+/// @param[out] size_p         Image size.
+/// @return     Image (free() by the caller) or OS_NULL.
+U8*             HostTestWavRampBuild(const U32 sample_rate, const U16 channels, const U32 frames, U32* size_p);
+
+/// @brief      Write the WAV file (PCM S16) of the ramp: every channel sample of
+///             the frame N is (N & HOST_TEST_RAMP_MASK).
+/// @param[in]  path_p         Path ("N:/...").
+/// @param[in]  sample_rate    Sample rate.
+/// @param[in]  channels       Channels.
+/// @param[in]  frames         Sample frames.
+/// @return     #Status.
+Status          HostTestWavRampWrite(ConstStrP path_p, const U32 sample_rate, const U16 channels, const U32 frames);
+
+/// @brief      Open the file by the player control task and wait the player is started.
+/// @param[in]  path_p         Path ("N:/...").
+/// @return     #Status.
+Status          HostTestPlayStart(ConstStrP path_p);
+
+/// @brief      Wait the player ends (on the file end).
+/// @param[in]  timeout_ms     Timeout.
+/// @return     #Status.
+Status          HostTestPlayEndWait(const U32 timeout_ms);
+
+/// @brief      Connect TCP client to the loopback port.
+/// @param[in]  port           Port.
+/// @return     Socket (-1 - failed).
+Int             HostTestConnect(const U16 port);
+
+/// @brief      Send the control protocol frame (net_ctrl.h).
+/// @param[in]  sd             Socket.
+/// @param[in]  type           Type.
+/// @param[in]  seq            Sequence number.
+/// @param[in]  payload_p      Payload.
+/// @param[in]  len            Payload length (< NET_CTRL_PAYLOAD_MAX).
+/// @param[in]  is_crc_bad     Corrupt the CRC32.
+/// @return     #Status.
+Status          HostTestFrameSend(const Int sd, const U8 type, const U16 seq, const void* payload_p, const U16 len,
+                                  const Bool is_crc_bad);
+
+/// @brief      Receive the control protocol frame (net_ctrl.h).
+/// @param[in]  sd             Socket.
+/// @param[out] hdr_p          Header.
+/// @param[out] payload_p      Payload.
+/// @param[in]  payload_max    Payload buffer size.
+/// @param[out] is_crc_ok_p    CRC32 is valid.
+/// @return     #Status.
+Status          HostTestFrameReceive(const Int sd, NetCtrlHdr* hdr_p, U8* payload_p, const Size payload_max,
+                                     Bool* is_crc_ok_p);
+
+/// @brief      Get the time (us).
+/// @return     Time.
+U64             HostTestTimeUsGet(void);
+
+#endif // _HOST_TEST_H_
@@ -0,0 +1,97 @@
+/***************************************************************************//**
+* @file    test_audio_dma.c
+* @brief   MMPlay circular DMA refill on the simulated audio device: a WAV
+*          ramp is played at real-time and the device output is checked for
+*          the continuity with the underrun counters.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include "os_task.h"
+#include "drv_audio.h"
+#include "task_mmplay.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_audio_dma"
+
+#define TEST_FILE_PATH          "1:/ramp.wav"
+#define TEST_SAMPLE_RATE        48000
+#define TEST_CHANNELS           2
+#define TEST_FRAMES             (TEST_SAMPLE_RATE * 2)  // 2 s.
+// MMPlay WAV output buffer half (frames).
+#define TEST_HALF_FRAMES        (0x1000 / (TEST_CHANNELS * sizeof(S16)))
+#define TEST_PLAY_END_TIMEOUT_MS 5000
+
+typedef struct {
+    U32                         frames;         // Ramp frames played in order.
+    U32                         breaks;         // Ramp discontinuities (a part played twice or skipped).
+    S32                         value_last;     // -1: the ramp is not started.
+} SinkCheck;
+
+//------------------------------------------------------------------------------
+static void     DrvAudioSink(const U8* data_p, const Size size, void* args_p);
+
+/******************************************************************************/
+void DrvAudioSink(const U8* data_p, const Size size, void* args_p)
+{
+SinkCheck* check_p = (SinkCheck*)args_p;
+const S16* frame_p = (const S16*)data_p;
+    for (Size i = 0; i < (size / (TEST_CHANNELS * sizeof(S16))); ++i, frame_p += TEST_CHANNELS) {
+        const S32 value = frame_p[0];
+        if (0 > check_p->value_last) {
+            //The ramp start (the leading silence is skipped).
+            if (0 == value) { continue; }
+            if (1 != value) { ++check_p->breaks; }
+        } else if (TEST_FRAMES <= check_p->frames) {
+            //The tail after the ramp end.
+            break;
+        } else if (((check_p->value_last + 1) & HOST_TEST_RAMP_MASK) != value) {
+            ++check_p->breaks;
+        }
+        if (frame_p[1] != value) { ++check_p->breaks; }
+        check_p->value_last = value;
+        ++check_p->frames;
+    }
+}
+
+/******************************************************************************/
+int main(void)
+{
+SinkCheck check = { .value_last = -1 };
+MMPlayStats stats;
+SpscRingStats events_stats;
+DrvAudioStats dev_stats;
+U64 time_us;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    HOST_TEST_CHECK(S_OK == HostTestWavRampWrite(TEST_FILE_PATH, TEST_SAMPLE_RATE, TEST_CHANNELS, TEST_FRAMES));
+    DrvAudioSinkSet(DrvAudioSink, &check);
+    DrvAudioStatsReset();
+    time_us = HostTestTimeUsGet();
+    HOST_TEST_CHECK(S_OK == HostTestPlayStart(TEST_FILE_PATH));
+    //The player task ends on the file end.
+    HOST_TEST_CHECK(S_OK == HostTestPlayEndWait(TEST_PLAY_END_TIMEOUT_MS));
+    time_us = HostTestTimeUsGet() - time_us;
+    DrvAudioSinkSet(OS_NULL, OS_NULL);
+    HOST_TEST_CHECK(S_OK == MMPlayStatsGet(&stats));
+    HOST_TEST_CHECK(S_OK == MMPlayAudioEventsStatsGet(&events_stats));
+    HOST_TEST_CHECK(S_OK == DrvAudioStatsGet(&dev_stats));
+    printf("\nplayed: %u ms, parts: %u, ramp frames: %u/%u, breaks: %u",
+           (U32)(time_us / 1000), dev_stats.parts, check.frames, TEST_FRAMES, check.breaks);
+    printf("\ndecodes: %u, decode max ms: %u, underruns: %u, dma late: %u, events max %u, overflows: %u",
+           stats.decode_count, stats.decode_time_max_ms, stats.underruns, stats.dma_late,
+           events_stats.depth_max, events_stats.overflows);
+    //Every half is refilled before the DMA comes back to it.
+    HOST_TEST_CHECK(0 == stats.dma_late);
+    HOST_TEST_CHECK(0 == stats.underruns);
+    HOST_TEST_CHECK(0 == events_stats.overflows);
+    HOST_TEST_CHECK(0 == dev_stats.stalls);
+    //The device output is the whole ramp in order (the player ends on the file end
+    //with the last two parts still in the buffer).
+    HOST_TEST_CHECK(0 == check.breaks);
+    HOST_TEST_CHECK((TEST_FRAMES - 2 * TEST_HALF_FRAMES) <= check.frames);
+    return HostTestEnd();
+}
@@ -0,0 +1,72 @@
+/***************************************************************************//**
+* @file    test_audio_out.c
+* @brief   Paced null output: a WAV is played at x1 and x8 of the real-time
+*          clock with the part period off the integer milliseconds; the real-
+*          time factor must not drift from the clock multiplier.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include "os_task.h"
+#include "audio_out.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_audio_out"
+
+#define TEST_FILE_PATH          "1:/ramp.wav"
+// The output half is 1024 frames: 23.22 ms.
+#define TEST_SAMPLE_RATE        44100
+#define TEST_CHANNELS           2
+#define TEST_FRAMES             (TEST_SAMPLE_RATE * 3)  // 3 s.
+#define TEST_PLAY_END_TIMEOUT_MS 10000
+
+typedef struct {
+    U16                         clock_mul;
+    U32                         rtf_error_max_x10000;   // |RTF / mul - 1| (x10000).
+} TestCase;
+
+//------------------------------------------------------------------------------
+static const TestCase test_cases_v[] = {
+    { 1,    50 },
+    { 8,    100 },
+};
+
+static void     PacedPlayCheck(const TestCase* case_p);
+
+/******************************************************************************/
+void PacedPlayCheck(const TestCase* case_p)
+{
+const AudioOutConfig cfg = { .type = AUDIO_OUT_NULL, .clock_mul = case_p->clock_mul, .path = "" };
+AudioOutStats stats;
+U32 rtf_x10000;
+U32 error_x10000;
+
+    HOST_TEST_CHECK(S_OK == AudioOutConfigSet(&cfg));
+    HOST_TEST_CHECK(S_OK == HostTestPlayStart(TEST_FILE_PATH));
+    HOST_TEST_CHECK(S_OK == HostTestPlayEndWait(TEST_PLAY_END_TIMEOUT_MS));
+    HOST_TEST_CHECK(S_OK == AudioOutStatsGet(&stats));
+    HOST_TEST_CHECK((AUDIO_OUT_NULL == stats.type) && (0 < stats.buffers) && (0 != stats.wall_ms));
+    if (0 == stats.wall_ms) { return; }
+    rtf_x10000 = (U32)(((U64)stats.audio_ms * 10000) / stats.wall_ms / case_p->clock_mul);
+    error_x10000 = (10000 < rtf_x10000) ? (rtf_x10000 - 10000) : (10000 - rtf_x10000);
+    printf("\nx%u: %u ms of audio in %u ms, error %u.%02u%%", case_p->clock_mul, stats.audio_ms, stats.wall_ms,
+           error_x10000 / 100, error_x10000 % 100);
+    HOST_TEST_CHECK(case_p->rtf_error_max_x10000 >= error_x10000);
+}
+
+/******************************************************************************/
+int main(void)
+{
+const AudioOutConfig cfg_device = { .type = AUDIO_OUT_DEVICE, .clock_mul = 0, .path = "" };
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    HOST_TEST_CHECK(S_OK == HostTestWavRampWrite(TEST_FILE_PATH, TEST_SAMPLE_RATE, TEST_CHANNELS, TEST_FRAMES));
+    for (Size i = 0; i < ITEMS_COUNT_GET(test_cases_v, TestCase); ++i) {
+        PacedPlayCheck(&test_cases_v[i]);
+    }
+    HOST_TEST_CHECK(S_OK == AudioOutConfigSet(&cfg_device));
+    return HostTestEnd();
+}
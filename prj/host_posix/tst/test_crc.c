@@ -0,0 +1,135 @@
+/***************************************************************************//**
+* @file    test_crc.c
+* @brief   CRC32 implementations: the bit-exactness of every available one
+*          against the byte-wise reference (the sizes and the misalignments),
+*          the slicing-by-8 tables generated by Crc32Init(), Crc32Combine()
+*          against the Crc32Delta() continuation and the throughput (MB/s and
+*          bytes per TSC cycle) of every implementation.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "os_common.h"
+#include "crc32.h"
+#include "host_test.h"
+#if (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define TEST_CYCLES_GET()       __rdtsc()
+#else
+#define TEST_CYCLES_GET()       0
+#endif
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_crc"
+
+#define TEST_CHECK_STR          "123456789"
+#define TEST_CHECK_CRC          0xCBF43926U     // CRC-32 (IEEE 802.3) check value.
+#define TEST_SIZE_MAX           300             // Every size up to (all the tails and the folding blocks).
+#define TEST_OFFSET_MAX         16              // Every misalignment up to.
+#define TEST_BUF_SIZE           (1024 * 1024)
+#define TEST_COMBINE_SPLITS     64
+#define TEST_BENCH_TIME_US      200000
+
+//------------------------------------------------------------------------------
+static ConstStrP impl_names_v[CRC32_IMPL_LAST] = { "bytewise", "slicing-8", "pclmul" };
+
+static U32      RandGet(U32* seed_p);
+static U32      ImplCheck(const Crc32Impl impl, U8* buf_p);
+static U32      CombineCheck(U8* buf_p);
+static void     ImplBench(const Crc32Impl impl, U8* buf_p);
+
+/******************************************************************************/
+U32 RandGet(U32* seed_p)
+{
+    *seed_p = *seed_p * 1103515245 + 12345;
+    return *seed_p >> 8;
+}
+
+/******************************************************************************/
+U32 ImplCheck(const Crc32Impl impl, U8* buf_p)
+{
+U32 errors = 0;
+    for (Size offset = 0; offset < TEST_OFFSET_MAX; ++offset) {
+        for (Size size = 0; size <= TEST_SIZE_MAX; ++size) {
+            const U32 crc_ref = Crc32DeltaImpl(CRC32_IMPL_BYTEWISE, buf_p + offset, size, CRC32_POLYNOMIAL);
+            if (crc_ref != Crc32DeltaImpl(impl, buf_p + offset, size, CRC32_POLYNOMIAL)) { ++errors; }
+        }
+    }
+    //The long run: every folding and slicing loop iterates.
+    if (Crc32DeltaImpl(CRC32_IMPL_BYTEWISE, buf_p + 1, TEST_BUF_SIZE - 1, CRC32_POLYNOMIAL) !=
+        Crc32DeltaImpl(impl, buf_p + 1, TEST_BUF_SIZE - 1, CRC32_POLYNOMIAL)) {
+        ++errors;
+    }
+    return errors;
+}
+
+/******************************************************************************/
+U32 CombineCheck(U8* buf_p)
+{
+U32 seed = 7;
+U32 errors = 0;
+    for (Size i = 0; i < TEST_COMBINE_SPLITS; ++i) {
+        const Size size   = 1 + RandGet(&seed) % (64 * 1024);
+        const Size size_1 = RandGet(&seed) % (size + 1);
+        const Size size_2 = size - size_1;
+        //The second block CRC is continued from the first one's register.
+        const U32 crc_delta = Crc32Delta(buf_p + size_1, size_2, Crc32Delta(buf_p, size_1, CRC32_POLYNOMIAL)) ^ CRC32_POLYNOMIAL;
+        const U32 crc_combine = Crc32Combine(Crc32(buf_p, size_1), Crc32(buf_p + size_1, size_2), size_2);
+        if ((crc_delta != crc_combine) || (Crc32(buf_p, size) != crc_combine)) { ++errors; }
+    }
+    return errors;
+}
+
+/******************************************************************************/
+void ImplBench(const Crc32Impl impl, U8* buf_p)
+{
+const U64 start_us = HostTestTimeUsGet();
+const U64 start_cycles = TEST_CYCLES_GET();
+volatile U32 crc = CRC32_POLYNOMIAL;
+U64 bytes = 0;
+U64 cycles;
+U64 time_us;
+    do {
+        crc = Crc32DeltaImpl(impl, buf_p, TEST_BUF_SIZE, crc);
+        bytes += TEST_BUF_SIZE;
+        time_us = HostTestTimeUsGet() - start_us;
+    } while (TEST_BENCH_TIME_US > time_us);
+    cycles = TEST_CYCLES_GET() - start_cycles;
+    //Bytes per cycle x1000 (0 - no cycle counter).
+    printf("\n%-10s %6u MB/s, %u.%03u B/cycle", impl_names_v[impl], (U32)(bytes / (time_us ? time_us : 1)),
+           (U32)(cycles ? (bytes / cycles) : 0), (U32)(cycles ? (((bytes * 1000) / cycles) % 1000) : 0));
+}
+
+/******************************************************************************/
+int main(void)
+{
+U8* buf_p = malloc(TEST_BUF_SIZE);
+U32 seed = 1;
+
+    HOST_TEST_CHECK(OS_NULL != buf_p);
+    if (OS_NULL == buf_p) { return HostTestEnd(); }
+    for (Size i = 0; i < TEST_BUF_SIZE; ++i) {
+        buf_p[i] = (U8)RandGet(&seed);
+    }
+    //Byte-wise till the tables are generated.
+    HOST_TEST_CHECK(OS_TRUE != Crc32ImplIsAvailable(CRC32_IMPL_SLICING_8));
+    HOST_TEST_CHECK(TEST_CHECK_CRC == Crc32((U8*)TEST_CHECK_STR, sizeof(TEST_CHECK_STR) - 1));
+    Crc32Init();
+    HOST_TEST_CHECK(OS_TRUE == Crc32ImplIsAvailable(CRC32_IMPL_SLICING_8));
+    HOST_TEST_CHECK(TEST_CHECK_CRC == Crc32((U8*)TEST_CHECK_STR, sizeof(TEST_CHECK_STR) - 1));
+    for (Crc32Impl impl = CRC32_IMPL_BYTEWISE; impl < CRC32_IMPL_LAST; ++impl) {
+        if (OS_TRUE != Crc32ImplIsAvailable(impl)) {
+            printf("\n%-10s not available", impl_names_v[impl]);
+            continue;
+        }
+        const U32 errors = ImplCheck(impl, buf_p);
+        printf("\n%-10s errors: %u", impl_names_v[impl], errors);
+        HOST_TEST_CHECK(0 == errors);
+    }
+    HOST_TEST_CHECK(0 == CombineCheck(buf_p));
+    for (Crc32Impl impl = CRC32_IMPL_BYTEWISE; impl < CRC32_IMPL_LAST; ++impl) {
+        if (OS_TRUE == Crc32ImplIsAvailable(impl)) { ImplBench(impl, buf_p); }
+    }
+    free(buf_p);
+    return HostTestEnd();
+}
@@ -0,0 +1,144 @@
+/***************************************************************************//**
+* @file    test_hid_replay.c
+* @brief   USB HID 1 kHz mouse reports replay: the per-report messages (no
+*          coalescing) against the reports coalesced in the driver ISR
+*          handler. B-ko queue depth, wakeups and CPU time are compared; no
+*          buttons transition is lost.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <time.h>
+#include "os_task.h"
+#include "os_mailbox.h"
+#include "os_signal.h"
+#include "msg_pool.h"
+#include "hal.h"
+#include "task_b_ko.h"
+#include "app_config.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_hid_replay"
+
+#define REPLAY_PERIOD_US        1000    // 1 kHz.
+#define REPLAY_CLICK_REPORTS    125     // Buttons transition every 125 ms.
+#define REPLAY_CLICK_PARTS      17      // Odd: the replay ends with the buttons released.
+#define REPLAY_REPORTS          (REPLAY_CLICK_REPORTS * REPLAY_CLICK_PARTS)
+#define REPLAY_EDGES            (REPLAY_CLICK_PARTS - 1)
+
+typedef enum {
+    REPLAY_MESSAGES,                    // OS_MSG_USB_HID_MOUSE per report, coalescing off.
+    REPLAY_COALESCED,                   // USB HID driver ISR handler, coalescing on.
+    REPLAY_LAST
+} ReplayMode;
+
+typedef struct {
+    UsbHidStats     hid;
+    OS_QueueStats   queue;
+    U64             cpu_us;
+    U32             drops;
+} ReplayResult;
+
+//------------------------------------------------------------------------------
+static void     Replay(const OS_TaskHd b_ko_thd, const ReplayMode mode, ReplayResult* result_p);
+static void     ReplayWait(const U64 time_us);
+
+/******************************************************************************/
+void ReplayWait(const U64 time_us)
+{
+const U64 now_us = HostTestTimeUsGet();
+struct timespec ts;
+    if (time_us <= now_us) { return; }
+    ts.tv_sec  = (time_us - now_us) / 1000000;
+    ts.tv_nsec = ((time_us - now_us) % 1000000) * 1000;
+    nanosleep(&ts, OS_NULL);
+}
+
+/******************************************************************************/
+void Replay(const OS_TaskHd b_ko_thd, const ReplayMode mode, ReplayResult* result_p)
+{
+const OS_QueueHd b_ko_qhd = OS_TaskStdInGet(b_ko_thd);
+const OS_Signal signal = OS_SignalCreate(OS_SIG_B_KO_HID_COALESCE, (REPLAY_COALESCED == mode));
+U64 cpu_us;
+U64 time_us;
+
+    OS_MemSet(result_p, 0, sizeof(*result_p));
+    OS_SignalSend(b_ko_qhd, signal, OS_MSG_PRIO_NORMAL);
+    OS_TaskDelay(APP_USB_HID_DELIVERY_MS * 2);
+    BKoHidStatsReset();
+    OS_QueueStatsReset(b_ko_qhd);
+    cpu_us  = OS_TaskCpuTimeGet(b_ko_thd);
+    time_us = HostTestTimeUsGet();
+    //Mouse-like stream: steady motion and a click every 250 ms (as the shell "hid replay").
+    for (U32 i = 0; i < REPLAY_REPORTS; ++i) {
+        const OS_UsbHidMouseData report = {
+            .buttons_bm = (0 == ((i / REPLAY_CLICK_REPORTS) % 2)) ? 0 : BIT(OS_USB_HID_MOUSE_BUTTON_LEFT),
+            .x          = 1 + (i % 4),
+            .y          = -(S16)(i % 2)
+        };
+        if (REPLAY_MESSAGES == mode) {
+            OS_Message* msg_p = MsgPoolCreate(OS_MSG_USB_HID_MOUSE, sizeof(report), OS_NO_BLOCK, &report);
+            if (OS_NULL == msg_p) {
+                ++result_p->drops;
+            } else {
+                IF_STATUS(OS_MessageSend(b_ko_qhd, msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+                    MsgPoolDelete(msg_p);
+                    ++result_p->drops;
+                }
+            }
+        } else {
+            IF_STATUS(HAL_HostUsbHidMouseReport(0, &report)) { ++result_p->drops; }
+        }
+        time_us += REPLAY_PERIOD_US;
+        ReplayWait(time_us);
+    }
+    //Let the last motion be delivered.
+    OS_TaskDelay(APP_USB_HID_DELIVERY_MS * 3);
+    result_p->cpu_us = OS_TaskCpuTimeGet(b_ko_thd) - cpu_us;
+    BKoHidStatsGet(&result_p->hid);
+    OS_QueueStatsGet(b_ko_qhd, &result_p->queue);
+}
+
+/******************************************************************************/
+int main(void)
+{
+static ConstStrP mode_names_v[REPLAY_LAST] = { "messages", "coalesced" };
+extern const OS_TaskConfig task_b_ko_cfg;
+ReplayResult results_v[REPLAY_LAST];
+OS_TaskHd b_ko_thd = OS_NULL;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    HOST_TEST_CHECK(S_OK == OS_TaskCreate(OS_NULL, &task_b_ko_cfg, &b_ko_thd));
+    HOST_TEST_CHECK(OS_NULL != b_ko_thd);
+    if (OS_NULL == b_ko_thd) { return HostTestEnd(); }
+    for (ReplayMode mode = REPLAY_MESSAGES; mode < REPLAY_LAST; ++mode) {
+        ReplayResult* result_p = &results_v[mode];
+        Replay(b_ko_thd, mode, result_p);
+        printf("\n%-10s reports: %u, wakeups: %u, deliveries: %u, edges: %u, states max: %u, overflows: %u,"
+               " queue max: %u, fails: %u, cpu: %u us, drops: %u",
+               mode_names_v[mode], result_p->hid.reports, result_p->hid.wakeups, result_p->hid.deliveries,
+               result_p->hid.edges, result_p->hid.states_max, result_p->hid.overflows,
+               result_p->queue.depth_max, result_p->queue.fails, (U32)result_p->cpu_us, result_p->drops);
+    }
+    //The per-report baseline floods the queue: its drops and depth are the "before" figures.
+    {
+        const ReplayResult* result_p = &results_v[REPLAY_COALESCED];
+        //Every report is taken and every buttons transition gets its own state.
+        HOST_TEST_CHECK(0 == result_p->drops);
+        HOST_TEST_CHECK(REPLAY_REPORTS == result_p->hid.reports);
+        HOST_TEST_CHECK(REPLAY_EDGES == result_p->hid.edges);
+        HOST_TEST_CHECK(0 == result_p->hid.overflows);
+        HOST_TEST_CHECK(0 == result_p->queue.fails);
+        HOST_TEST_CHECK((REPLAY_EDGES + 1) <= result_p->hid.deliveries);
+        //The coalesced input wakes the task per delivery tick and per click only:
+        //a single wakeup per device is in the queue.
+        HOST_TEST_CHECK(result_p->hid.wakeups < (REPLAY_REPORTS / 10));
+        HOST_TEST_CHECK(result_p->hid.deliveries < (REPLAY_REPORTS / 10));
+        HOST_TEST_CHECK(result_p->queue.sends < (REPLAY_REPORTS / 10));
+        HOST_TEST_CHECK(APP_USB_HID_MICE_MAX >= result_p->queue.depth_max);
+    }
+    return HostTestEnd();
+}
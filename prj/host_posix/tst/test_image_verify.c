@@ -0,0 +1,138 @@
+/***************************************************************************//**
+* @file    test_image_verify.c
+* @brief   Images integrity verification: the good and the corrupt update
+*          image, the pass interrupted (suspended) and resumed from the saved
+*          state and the image replaced while the pass is suspended (restarted,
+*          not resumed with the stale CRC).
+* @author  A. Filyanov
+* @details The module is driven by the test itself (no firmware is run).
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "os_common.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "image_verify.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_image_verify"
+
+#define TEST_IMAGE_SIZE         (32 * 1024 * 1024)  // Many time slices.
+#define TEST_IMAGE_IDX          1                   // "update".
+#define TEST_FW_IDX             0                   // "firmware": not mapped on the host.
+
+//------------------------------------------------------------------------------
+static U32      RandGet(U32* seed_p);
+static Status   ImageWrite(U8* image_p, const Bool is_corrupt);
+static ImageVerifyResult PassComplete(void);
+static ImageVerifyResult ResultGet(const Size idx);
+
+/******************************************************************************/
+U32 RandGet(U32* seed_p)
+{
+    *seed_p = *seed_p * 1103515245 + 12345;
+    return *seed_p >> 8;
+}
+
+/******************************************************************************/
+Status ImageWrite(U8* image_p, const Bool is_corrupt)
+{
+const U32 data_size = TEST_IMAGE_SIZE - sizeof(U32);
+const U32 crc = Crc32(image_p, data_size);
+Status s;
+    OS_MemCpy(image_p + data_size, &crc, sizeof(crc));
+    //The trailer of the original data.
+    if (OS_TRUE == is_corrupt) { image_p[data_size / 2] ^= 0x10; }
+    s = HostTestFileWrite(APP_IMAGE_VERIFY_UPDATE_FILE, image_p, TEST_IMAGE_SIZE);
+    if (OS_TRUE == is_corrupt) { image_p[data_size / 2] ^= 0x10; }
+    return s;
+}
+
+/******************************************************************************/
+ImageVerifyResult PassComplete(void)
+{
+    while (OS_TRUE == ImageVerifyStep()) {}
+    return ResultGet(TEST_IMAGE_IDX);
+}
+
+/******************************************************************************/
+ImageVerifyResult ResultGet(const Size idx)
+{
+ConstStrP name_p;
+ImageVerifyResult result = IMAGE_VERIFY_RESULT_LAST;
+    IF_STATUS(ImageVerifyResultGet(idx, &name_p, &result)) { return IMAGE_VERIFY_RESULT_LAST; }
+    return result;
+}
+
+/******************************************************************************/
+int main(void)
+{
+U8* image_p = malloc(TEST_IMAGE_SIZE);
+ImageVerifyStats stats;
+U32 seed = 1;
+U32 bytes_suspended;
+
+    HOST_TEST_CHECK(OS_NULL != image_p);
+    if (OS_NULL == image_p) { return HostTestEnd(); }
+    HOST_TEST_CHECK(S_OK == OS_FileSystemInit());
+    Crc32Init();
+    for (Size i = 0; i < TEST_IMAGE_SIZE; ++i) {
+        image_p[i] = (U8)RandGet(&seed);
+    }
+    //No saved state: nothing is resumed.
+    OS_FileDelete(APP_IMAGE_VERIFY_STATE_FILE);
+    HOST_TEST_CHECK(S_OK == ImageVerifyInit());
+    HOST_TEST_CHECK((S_OK == ImageVerifyStatsGet(&stats)) && (OS_TRUE != stats.is_active) && (0 == stats.resumes));
+
+    //Good image.
+    HOST_TEST_CHECK(S_OK == ImageWrite(image_p, OS_FALSE));
+    HOST_TEST_CHECK(S_OK == ImageVerifyStart());
+    HOST_TEST_CHECK(IMAGE_VERIFY_RESULT_OK == PassComplete());
+    HOST_TEST_CHECK(IMAGE_VERIFY_RESULT_NO_CRC == ResultGet(TEST_FW_IDX));
+    HOST_TEST_CHECK((S_OK == ImageVerifyStatsGet(&stats)) && (OS_TRUE != stats.is_active) && (1 == stats.passes));
+    HOST_TEST_CHECK((TEST_IMAGE_SIZE - sizeof(U32)) == stats.bytes);
+    printf("\ngood: %u KB/s", stats.rate_kbs);
+
+    //Corrupt image.
+    HOST_TEST_CHECK(S_OK == ImageWrite(image_p, OS_TRUE));
+    HOST_TEST_CHECK(S_OK == ImageVerifyStart());
+    HOST_TEST_CHECK(IMAGE_VERIFY_RESULT_MISMATCH == PassComplete());
+
+    //Interrupted and resumed: the image is read once in total.
+    HOST_TEST_CHECK(S_OK == ImageWrite(image_p, OS_FALSE));
+    HOST_TEST_CHECK(S_OK == ImageVerifyStart());
+    HOST_TEST_CHECK(OS_TRUE == ImageVerifyStep());
+    HOST_TEST_CHECK(S_OK == ImageVerifySuspend());
+    HOST_TEST_CHECK(S_OK == ImageVerifyStatsGet(&stats));
+    bytes_suspended = stats.bytes;
+    HOST_TEST_CHECK((0 < bytes_suspended) && ((TEST_IMAGE_SIZE - sizeof(U32)) > bytes_suspended));
+    HOST_TEST_CHECK(S_OK == ImageVerifyInit());
+    HOST_TEST_CHECK((S_OK == ImageVerifyStatsGet(&stats)) && (OS_TRUE == stats.is_active) && (1 == stats.resumes));
+    HOST_TEST_CHECK(IMAGE_VERIFY_RESULT_OK == PassComplete());
+    HOST_TEST_CHECK(S_OK == ImageVerifyStatsGet(&stats));
+    HOST_TEST_CHECK((TEST_IMAGE_SIZE - sizeof(U32)) == stats.bytes);
+    printf("\nresumed at: %u", bytes_suspended);
+
+    //Replaced (same size) while suspended: restarted from the image start.
+    HOST_TEST_CHECK(S_OK == ImageVerifyStart());
+    HOST_TEST_CHECK(OS_TRUE == ImageVerifyStep());
+    HOST_TEST_CHECK(S_OK == ImageVerifySuspend());
+    HOST_TEST_CHECK(S_OK == ImageVerifyStatsGet(&stats));
+    bytes_suspended = stats.bytes;
+    image_p[0] ^= 0x01;
+    HOST_TEST_CHECK(S_OK == ImageWrite(image_p, OS_FALSE));
+    HOST_TEST_CHECK(S_OK == ImageVerifyInit());
+    HOST_TEST_CHECK((S_OK == ImageVerifyStatsGet(&stats)) && (2 == stats.resumes));
+    HOST_TEST_CHECK(IMAGE_VERIFY_RESULT_OK == PassComplete());
+    HOST_TEST_CHECK(S_OK == ImageVerifyStatsGet(&stats));
+    HOST_TEST_CHECK((bytes_suspended + TEST_IMAGE_SIZE - sizeof(U32)) == stats.bytes);
+    //The state is used once.
+    HOST_TEST_CHECK(S_OK == ImageVerifyInit());
+    HOST_TEST_CHECK((S_OK == ImageVerifyStatsGet(&stats)) && (2 == stats.resumes));
+
+    OS_FileDelete(APP_IMAGE_VERIFY_UPDATE_FILE);
+    free(image_p);
+    return HostTestEnd();
+}
@@ -0,0 +1,144 @@
+/***************************************************************************//**
+* @file    test_msg_pool.c
+* @brief   Messages pool stress bench: many producers to one consumer queue,
+*          the pool messages vs the OS heap ones (msg/s and tail latency).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "os_memory.h"
+#include "os_mailbox.h"
+#include "msg_pool.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_msg_pool"
+
+#define BENCH_PRODUCERS         8
+#define BENCH_MESSAGES          20000   // Per producer.
+// The messages in flight (the queue, one per producer and the consumer one)
+// fit the pool class: no heap fallback.
+#define BENCH_QUEUE_LEN         7
+
+typedef struct {
+    U64                         send_us;
+    U32                         producer;
+    U32                         seq;
+} BenchData;
+
+typedef struct {
+    OS_QueueHd                  qhd;
+    U32                         producer;
+    Bool                        is_heap;
+} ProducerArgs;
+
+//------------------------------------------------------------------------------
+static void*    ProducerThread(void* args_p);
+static Bool     BenchRun(const OS_QueueHd qhd, const Bool is_heap);
+
+//------------------------------------------------------------------------------
+static U32 latencies_v[BENCH_PRODUCERS * BENCH_MESSAGES];
+static U32 create_fails;
+
+/******************************************************************************/
+void* ProducerThread(void* args_p)
+{
+const ProducerArgs* prod_args_p = (ProducerArgs*)args_p;
+BenchData data = { .producer = prod_args_p->producer };
+    for (U32 i = 0; i < BENCH_MESSAGES; ++i) {
+        OS_Message* msg_p;
+        data.seq    = i;
+        data.send_us= HostTestTimeUsGet();
+        msg_p = (OS_TRUE == prod_args_p->is_heap) ? OS_MessageCreate(OS_MSG_APP, sizeof(data), OS_BLOCK, &data) :
+                                                   MsgPoolCreate(OS_MSG_APP, sizeof(data), OS_BLOCK, &data);
+        if (OS_NULL == msg_p) {
+            __atomic_add_fetch(&create_fails, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        IF_STATUS(OS_MessageSend(prod_args_p->qhd, msg_p, OS_BLOCK, OS_MSG_PRIO_NORMAL)) {
+            MsgPoolDelete(msg_p);
+        }
+    }
+    return OS_NULL;
+}
+
+/******************************************************************************/
+Bool BenchRun(const OS_QueueHd qhd, const Bool is_heap)
+{
+pthread_t producers_v[BENCH_PRODUCERS];
+ProducerArgs args_v[BENCH_PRODUCERS];
+U32 seq_next_v[BENCH_PRODUCERS] = { 0 };
+Bool is_ordered = OS_TRUE;
+U32 count = 0;
+U64 start_us;
+U64 time_us;
+U32 p50, p99, p999;
+OS_Message* msg_p;
+
+    create_fails = 0;
+    start_us = HostTestTimeUsGet();
+    for (U32 i = 0; i < BENCH_PRODUCERS; ++i) {
+        args_v[i] = (ProducerArgs){ .qhd = qhd, .producer = i, .is_heap = is_heap };
+        pthread_create(&producers_v[i], OS_NULL, ProducerThread, &args_v[i]);
+    }
+    while (ITEMS_COUNT_GET(latencies_v, U32) > count) {
+        IF_STATUS(OS_MessageReceive(qhd, &msg_p, 1000)) { break; }
+        {
+            const BenchData* data_p = (BenchData*)msg_p->data;
+            latencies_v[count++] = (U32)(HostTestTimeUsGet() - data_p->send_us);
+            //FIFO per producer.
+            if (seq_next_v[data_p->producer] != data_p->seq) { is_ordered = OS_FALSE; }
+            seq_next_v[data_p->producer] = data_p->seq + 1;
+        }
+        MsgPoolDelete(msg_p);
+    }
+    time_us = HostTestTimeUsGet() - start_us;
+    for (U32 i = 0; i < BENCH_PRODUCERS; ++i) {
+        pthread_join(producers_v[i], OS_NULL);
+    }
+    if (0 == time_us) { time_us = 1; }
+    p50 = HostTestPercentileGet(latencies_v, count, 50);
+    p99 = HostTestPercentileGet(latencies_v, count, 99);
+    //Sorted.
+    p999= latencies_v[(Size)(((U64)(count - 1) * 999) / 1000)];
+    printf("\n%-4s %u producers: %u msg/s, latency us p50 %u, p99 %u, p99.9 %u, max %u",
+           (OS_TRUE == is_heap) ? "heap" : "pool", BENCH_PRODUCERS, (U32)(((U64)count * 1000000) / time_us),
+           p50, p99, p999, latencies_v[count - 1]);
+    HOST_TEST_CHECK(0 == create_fails);
+    HOST_TEST_CHECK(OS_TRUE == is_ordered);
+    return HOST_TEST_CHECK(ITEMS_COUNT_GET(latencies_v, U32) == count);
+}
+
+/******************************************************************************/
+int main(void)
+{
+const OS_QueueConfig queue_cfg = { .len = BENCH_QUEUE_LEN };
+OS_MemoryStats heap_before;
+OS_MemoryStats heap_after;
+MemPoolStats stats;
+OS_QueueHd qhd;
+U32 fallbacks;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    HOST_TEST_CHECK(S_OK == OS_QueueCreate(&queue_cfg, OS_NULL, &qhd));
+    OS_MemoryStatsGet(OS_MEM_HEAP_SYS, &heap_before);
+    MsgPoolStatsReset();
+    BenchRun(qhd, OS_FALSE);
+    fallbacks = MsgPoolFallbacksGet();
+    IF_OK(MsgPoolStatsGet(0, &stats)) {
+        printf("\npool: blocks %u, used max %u, heap fallbacks %u", stats.blocks_count, stats.blocks_used_max, fallbacks);
+        //All the pool blocks are back.
+        HOST_TEST_CHECK(0 == stats.blocks_used);
+        HOST_TEST_CHECK(stats.blocks_count >= stats.blocks_used_max);
+        HOST_TEST_CHECK(0 == fallbacks);
+    }
+    BenchRun(qhd, OS_TRUE);
+    //No message is leaked in the OS heap.
+    OS_MemoryStatsGet(OS_MEM_HEAP_SYS, &heap_after);
+    HOST_TEST_CHECK(heap_before.used == heap_after.used);
+    return HostTestEnd();
+}
@@ -0,0 +1,290 @@
+/***************************************************************************//**
+* @file    test_net_ctrl.c
+* @brief   Control protocol loopback client: pipelined ping and control frames
+*          at thousands per second; the responses type, sequence, status and
+*          CRC32 are checked and the round trip latency is measured.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "os_task.h"
+#include "drv_audio.h"
+#include "net_ctrl.h"
+#include "task_mmplay.h"
+#include "app_config.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_net_ctrl"
+
+#define CTRL_FRAMES             20000
+#define CTRL_WINDOW             32      // Frames in flight.
+#define CTRL_CMD_EVERY          4       // Every 4th frame is a control command (PAUSE).
+#define CTRL_RECV_TIMEOUT_MS    2000
+#define CTRL_RATE_MIN           2000    // Frames/s.
+#define PLAY_FILE_PATH          "1:/ctrl.wav"
+// The 65.536 s seek position truncation would land half the ramp period away.
+#define PLAY_SAMPLE_RATE        12250
+#define PLAY_CHANNELS           1
+#define PLAY_SEEK_MS            66000
+#define PLAY_FRAMES             ((PLAY_SEEK_MS / 1000 + 2) * PLAY_SAMPLE_RATE)
+// MMPlay WAV output buffer half (frames): the output part after the seek starts there.
+#define PLAY_HALF_FRAMES        (0x1000 / (PLAY_CHANNELS * sizeof(S16)))
+#define PLAY_STATE_TIMEOUT_MS   1000
+#define PLAY_END_TIMEOUT_MS     5000
+#define TM_PERIOD_MS            20
+#define TM_BATCH                4
+
+typedef struct {
+    U32             pushes;
+    U32             snapshots;
+    U32             errors;             // Type, length, CRC32, time order.
+    U32             time_last_ms;
+    U8              mmplay_state_last;
+} TelemetryCheck;
+
+typedef struct {
+    volatile S32    target;             // Ramp value expected at the output part start (-1: none).
+    volatile Bool   is_found;
+} SeekCheck;
+
+typedef struct {
+    NetCtrlHdr      hdr;
+    U8              payload_v[NET_CTRL_PAYLOAD_MAX];
+    Bool            is_crc_ok;
+} CtrlFrame;
+
+//------------------------------------------------------------------------------
+static Status   FrameReceive(const Int sd, CtrlFrame* frame_p);
+static Bool     FrameIsCmd(const U16 seq);
+static Status   ResponseReceive(const Int sd, const U16 seq, CtrlFrame* frame_p, TelemetryCheck* tm_p);
+static Status   CommandSend(const Int sd, const U8 type, const U16 seq, const void* payload_p, const U16 len,
+                            TelemetryCheck* tm_p);
+static Bool     StateWait(const Int sd, const U8 state, TelemetryCheck* tm_p);
+static void     TelemetryPushCheck(const CtrlFrame* frame_p, TelemetryCheck* tm_p);
+static void     DrvAudioSink(const U8* data_p, const Size size, void* args_p);
+static void     PlayerTest(const Int sd);
+
+/******************************************************************************/
+Status FrameReceive(const Int sd, CtrlFrame* frame_p)
+{
+    return HostTestFrameReceive(sd, &frame_p->hdr, frame_p->payload_v, sizeof(frame_p->payload_v), &frame_p->is_crc_ok);
+}
+
+/******************************************************************************/
+Bool FrameIsCmd(const U16 seq)
+{
+    return (0 == (seq % CTRL_CMD_EVERY));
+}
+
+/******************************************************************************/
+void TelemetryPushCheck(const CtrlFrame* frame_p, TelemetryCheck* tm_p)
+{
+const NetCtrlTelemetry* snapshot_p = (const NetCtrlTelemetry*)frame_p->payload_v;
+    ++tm_p->pushes;
+    if ((OS_TRUE != frame_p->is_crc_ok) || (S_OK != frame_p->hdr.status) ||
+        ((TM_BATCH * sizeof(NetCtrlTelemetry)) != frame_p->hdr.len)) {
+        ++tm_p->errors;
+        return;
+    }
+    for (Size i = 0; i < TM_BATCH; ++i, ++snapshot_p) {
+        //A late sample shortens the next interval only.
+        if ((0 != tm_p->snapshots) && (0 >= (S32)(snapshot_p->time_ms - tm_p->time_last_ms))) {
+            ++tm_p->errors;
+        }
+        tm_p->time_last_ms      = snapshot_p->time_ms;
+        tm_p->mmplay_state_last = snapshot_p->mmplay_state;
+        ++tm_p->snapshots;
+    }
+}
+
+/******************************************************************************/
+Status ResponseReceive(const Int sd, const U16 seq, CtrlFrame* frame_p, TelemetryCheck* tm_p)
+{
+Status s;
+    //The telemetry pushes (seq = 0) come in between.
+    for (;;) {
+        IF_STATUS(s = FrameReceive(sd, frame_p)) { return s; }
+        if ((0 == frame_p->hdr.seq) &&
+            ((NET_CTRL_MSG_TELEMETRY_SUBSCRIBE | NET_CTRL_MSG_RESPONSE) == frame_p->hdr.type)) {
+            TelemetryPushCheck(frame_p, tm_p);
+            if (0 == seq) { return S_OK; }
+            continue;
+        }
+        if ((seq != frame_p->hdr.seq) || (OS_TRUE != frame_p->is_crc_ok)) { return S_INVALID_VALUE; }
+        return (U16)S_OK == frame_p->hdr.status ? S_OK : (Status)(S16)frame_p->hdr.status;
+    }
+}
+
+/******************************************************************************/
+Status CommandSend(const Int sd, const U8 type, const U16 seq, const void* payload_p, const U16 len,
+                   TelemetryCheck* tm_p)
+{
+CtrlFrame frame;
+Status s;
+    IF_OK(s = HostTestFrameSend(sd, type, seq, payload_p, len, OS_FALSE)) {
+        IF_OK(s = ResponseReceive(sd, seq, &frame, tm_p)) {
+            if ((type | NET_CTRL_MSG_RESPONSE) != frame.hdr.type) { s = S_INVALID_VALUE; }
+        }
+    }
+    return s;
+}
+
+/******************************************************************************/
+Bool StateWait(const Int sd, const U8 state, TelemetryCheck* tm_p)
+{
+const U64 start_us = HostTestTimeUsGet();
+CtrlFrame frame;
+    //The state is reported by the telemetry push.
+    while ((PLAY_STATE_TIMEOUT_MS * 1000ULL) > (HostTestTimeUsGet() - start_us)) {
+        IF_STATUS(ResponseReceive(sd, 0, &frame, tm_p)) { return OS_FALSE; }
+        if (state == tm_p->mmplay_state_last) { return OS_TRUE; }
+    }
+    return OS_FALSE;
+}
+
+/******************************************************************************/
+void DrvAudioSink(const U8* data_p, const Size size, void* args_p)
+{
+SeekCheck* check_p = (SeekCheck*)args_p;
+const S32 value = ((const S16*)data_p)[0];
+    (void)size;
+    if (0 > check_p->target) { return; }
+    if (((U32)(value - check_p->target) & HOST_TEST_RAMP_MASK) < PLAY_HALF_FRAMES) {
+        check_p->is_found = OS_TRUE;
+    }
+}
+
+/******************************************************************************/
+void PlayerTest(const Int sd)
+{
+static SeekCheck seek_check = { .target = -1 };
+TelemetryCheck tm = { 0 };
+const NetCtrlSubscribe sub = { .period_ms = TM_PERIOD_MS, .batch = TM_BATCH };
+const NetCtrlSubscribe unsub = { .period_ms = 0 };
+const NetCtrlCmdSeek seek = { .timestamp = 1, .position_ms = PLAY_SEEK_MS };
+const NetCtrlCmd cmd = { .timestamp = 1 };
+MMPlayStats stats;
+U32 wait_ms = 0;
+U16 seq = 100;
+
+    HOST_TEST_CHECK(S_OK == HostTestWavRampWrite(PLAY_FILE_PATH, PLAY_SAMPLE_RATE, PLAY_CHANNELS, PLAY_FRAMES));
+    DrvAudioSinkSet(DrvAudioSink, &seek_check);
+    HOST_TEST_CHECK(S_OK == HostTestPlayStart(PLAY_FILE_PATH));
+    HOST_TEST_CHECK(S_OK == CommandSend(sd, NET_CTRL_MSG_TELEMETRY_SUBSCRIBE, ++seq, &sub, sizeof(sub), &tm));
+    HOST_TEST_CHECK(OS_TRUE == StateWait(sd, MMPLAY_STATE_PLAY, &tm));
+    //Pause/resume.
+    HOST_TEST_CHECK(S_OK == CommandSend(sd, NET_CTRL_MSG_PAUSE, ++seq, &cmd, sizeof(cmd), &tm));
+    HOST_TEST_CHECK(OS_TRUE == StateWait(sd, MMPLAY_STATE_PAUSE, &tm));
+    HOST_TEST_CHECK((S_OK == MMPlayStatsGet(&stats)) && (MMPLAY_STATE_PAUSE == stats.state));
+    HOST_TEST_CHECK(S_OK == CommandSend(sd, NET_CTRL_MSG_RESUME, ++seq, &cmd, sizeof(cmd), &tm));
+    HOST_TEST_CHECK(OS_TRUE == StateWait(sd, MMPLAY_STATE_PLAY, &tm));
+    //Seek past 65.535 s: the output goes on from the position.
+    seek_check.target = (S32)((((U64)PLAY_SEEK_MS * PLAY_SAMPLE_RATE) / 1000) & HOST_TEST_RAMP_MASK);
+    HOST_TEST_CHECK(S_OK == CommandSend(sd, NET_CTRL_MSG_SEEK, ++seq, &seek, sizeof(seek), &tm));
+    while ((OS_TRUE != seek_check.is_found) && (PLAY_STATE_TIMEOUT_MS > wait_ms)) {
+        usleep(10000);
+        wait_ms += 10;
+    }
+    HOST_TEST_CHECK(OS_TRUE == seek_check.is_found);
+    HOST_TEST_CHECK(S_OK == CommandSend(sd, NET_CTRL_MSG_TELEMETRY_SUBSCRIBE, ++seq, &unsub, sizeof(unsub), &tm));
+    //The player ends on the file end.
+    HOST_TEST_CHECK(S_OK == HostTestPlayEndWait(PLAY_END_TIMEOUT_MS));
+    DrvAudioSinkSet(OS_NULL, OS_NULL);
+    HOST_TEST_CHECK(S_OK == MMPlayStatsGet(&stats));
+    printf("\nplayer: commands: %u, latency max: %u ms, seek found in %u ms",
+           stats.commands, stats.ctl_latency_max_ms, wait_ms);
+    printf("\ntelemetry: pushes: %u, snapshots: %u, errors: %u", tm.pushes, tm.snapshots, tm.errors);
+    HOST_TEST_CHECK(0 != tm.pushes);
+    HOST_TEST_CHECK((tm.pushes * TM_BATCH) == tm.snapshots);
+    HOST_TEST_CHECK(0 == tm.errors);
+}
+
+/******************************************************************************/
+int main(void)
+{
+static U64 sent_us_v[CTRL_FRAMES];
+static U32 latencies_us_v[CTRL_FRAMES];
+const struct timeval tv = { .tv_sec = CTRL_RECV_TIMEOUT_MS / 1000 };
+U32 errors_type = 0, errors_seq = 0, errors_status = 0, errors_crc = 0, errors_payload = 0;
+U32 sent = 0, received = 0;
+CtrlFrame frame;
+U64 time_us;
+Int sd;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    sd = HostTestConnect(APP_NET_CTRL_PORT);
+    HOST_TEST_CHECK(0 <= sd);
+    if (0 > sd) { return HostTestEnd(); }
+    setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    time_us = HostTestTimeUsGet();
+    while (CTRL_FRAMES > received) {
+        //Keep the window full; the sequence numbers start from 1 (0 - telemetry push).
+        while ((CTRL_FRAMES > sent) && ((sent - received) < CTRL_WINDOW)) {
+            const U16 seq = (U16)(sent + 1);
+            Status s;
+            sent_us_v[sent] = HostTestTimeUsGet();
+            if (OS_TRUE == FrameIsCmd(seq)) {
+                const NetCtrlCmd cmd = { .timestamp = seq };
+                s = HostTestFrameSend(sd, NET_CTRL_MSG_PAUSE, seq, &cmd, sizeof(cmd), OS_FALSE);
+            } else {
+                s = HostTestFrameSend(sd, NET_CTRL_MSG_PING, seq, OS_NULL, 0, OS_FALSE);
+            }
+            IF_STATUS(s) { break; }
+            ++sent;
+        }
+        IF_STATUS(FrameReceive(sd, &frame)) { break; }
+        latencies_us_v[received] = (U32)(HostTestTimeUsGet() - sent_us_v[received]);
+        ++received;
+        //Responses come in the requests order.
+        if (OS_TRUE != frame.is_crc_ok) { ++errors_crc; }
+        if ((U16)received != frame.hdr.seq) { ++errors_seq; }
+        if (OS_TRUE == FrameIsCmd((U16)received)) {
+            NetCtrlAck ack;
+            //No player is running: the command is refused with the status.
+            if ((NET_CTRL_MSG_PAUSE | NET_CTRL_MSG_RESPONSE) != frame.hdr.type) { ++errors_type; }
+            if ((U16)S_NET_CTRL_NO_PLAYER != frame.hdr.status) { ++errors_status; }
+            OS_MemCpy(&ack, frame.payload_v, sizeof(ack));
+            if ((sizeof(ack) != frame.hdr.len) || (received != ack.timestamp)) { ++errors_payload; }
+        } else {
+            NetCtrlPong pong;
+            if ((NET_CTRL_MSG_PING | NET_CTRL_MSG_RESPONSE) != frame.hdr.type) { ++errors_type; }
+            if (S_OK != frame.hdr.status) { ++errors_status; }
+            OS_MemCpy(&pong, frame.payload_v, sizeof(pong));
+            if ((sizeof(pong) != frame.hdr.len) || (NET_CTRL_VERSION != pong.version)) { ++errors_payload; }
+        }
+    }
+    time_us = HostTestTimeUsGet() - time_us;
+    {
+        const U32 rate = (U32)((U64)received * 1000000 / (time_us ? time_us : 1));
+        const U32 p50   = HostTestPercentileGet(latencies_us_v, received, 50);
+        const U32 p99   = HostTestPercentileGet(latencies_us_v, received, 99);
+        const U32 p_max = HostTestPercentileGet(latencies_us_v, received, 100);
+        printf("\nframes: %u/%u, window: %u, rate: %u frames/s, latency p50: %u us, p99: %u us, max: %u us",
+               received, CTRL_FRAMES, CTRL_WINDOW, rate, p50, p99, p_max);
+        printf("\nerrors type: %u, seq: %u, status: %u, crc: %u, payload: %u",
+               errors_type, errors_seq, errors_status, errors_crc, errors_payload);
+        HOST_TEST_CHECK(CTRL_FRAMES == received);
+        HOST_TEST_CHECK(CTRL_RATE_MIN <= rate);
+    }
+    HOST_TEST_CHECK(0 == errors_type);
+    HOST_TEST_CHECK(0 == errors_seq);
+    HOST_TEST_CHECK(0 == errors_status);
+    HOST_TEST_CHECK(0 == errors_crc);
+    HOST_TEST_CHECK(0 == errors_payload);
+    //A corrupted frame is answered with the CRC error; the session goes on.
+    HOST_TEST_CHECK(S_OK == HostTestFrameSend(sd, NET_CTRL_MSG_PING, 1, OS_NULL, 0, OS_TRUE));
+    HOST_TEST_CHECK(S_OK == FrameReceive(sd, &frame));
+    HOST_TEST_CHECK((U16)S_NET_CTRL_CRC_ERROR == frame.hdr.status);
+    HOST_TEST_CHECK(S_OK == HostTestFrameSend(sd, NET_CTRL_MSG_PING, 2, OS_NULL, 0, OS_FALSE));
+    HOST_TEST_CHECK(S_OK == FrameReceive(sd, &frame));
+    HOST_TEST_CHECK((2 == frame.hdr.seq) && (S_OK == frame.hdr.status) && (OS_TRUE == frame.is_crc_ok));
+    PlayerTest(sd);
+    close(sd);
+    return HostTestEnd();
+}
@@ -0,0 +1,208 @@
+/***************************************************************************//**
+* @file    test_net_file.c
+* @brief   File transfer service loopback client: the directory list, the
+*          sustained credit paced read of a large file and a range read; the
+*          data and the frames are verified and the throughput is measured.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "os_common.h"
+#include "net_file.h"
+#include "app_config.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_net_file"
+
+#define TEST_DIR_PATH           "1:/"
+#define TEST_FILE_NAME          "big.bin"
+#define TEST_FILE_PATH          TEST_DIR_PATH TEST_FILE_NAME
+#define TEST_FILE_SIZE          (1024 * 1024 + 123)     // Not the chunk multiple.
+#define TEST_RANGE_OFFSET       1000
+#define TEST_RANGE_LENGTH       5000
+#define TEST_CREDIT_RETURN      16      // Chunks returned per NET_FILE_MSG_CREDIT.
+#define TEST_RECV_TIMEOUT_MS    2000
+// Sustained rate floor (bytes/s): chunks budget per the NetServ poll is the limit.
+#define TEST_RATE_MIN           (256 * 1024)
+#define TEST_PAYLOAD_MAX        (sizeof(NetFileData) + APP_NET_FILE_CHUNK_SIZE)
+
+typedef struct {
+    U32             frames;
+    U32             bytes;
+    U32             errors_frame;       // Type, sequence, status, CRC32.
+    U32             errors_offset;
+    U32             errors_data;
+} ReadCheck;
+
+//------------------------------------------------------------------------------
+static U8       PatternByteGet(const U32 offset);
+static Status   FileRead(const Int sd, const U16 seq, const U32 offset, const U32 length, const U8* file_p,
+                         NetFileReadAck* ack_p, ReadCheck* check_p);
+static Bool     FileList(const Int sd, const U16 seq, U32* size_p);
+
+/******************************************************************************/
+U8 PatternByteGet(const U32 offset)
+{
+    //Not periodic on the chunk size: a misplaced chunk does not match.
+    return (U8)((offset * 2654435761UL) >> 13);
+}
+
+/******************************************************************************/
+Bool FileList(const Int sd, const U16 seq, U32* size_p)
+{
+static const Str path_str[] = TEST_DIR_PATH;
+static U8 payload_v[TEST_PAYLOAD_MAX];
+NetCtrlHdr hdr;
+Bool is_crc_ok;
+Bool is_found = OS_FALSE;
+
+    IF_STATUS(HostTestFrameSend(sd, NET_FILE_MSG_LIST, seq, path_str, sizeof(path_str), OS_FALSE)) { return OS_FALSE; }
+    //Entries frames till the empty one.
+    for (;;) {
+        IF_STATUS(HostTestFrameReceive(sd, &hdr, payload_v, sizeof(payload_v), &is_crc_ok)) { return OS_FALSE; }
+        if (((NET_FILE_MSG_LIST | NET_CTRL_MSG_RESPONSE) != hdr.type) || (seq != hdr.seq) ||
+            (S_OK != hdr.status) || (OS_TRUE != is_crc_ok)) {
+            return OS_FALSE;
+        }
+        if (0 == hdr.len) { break; }
+        for (Size pos = 0; (pos + sizeof(NetFileEntry)) <= hdr.len;) {
+            NetFileEntry entry;
+            OS_MemCpy(&entry, payload_v + pos, sizeof(entry));
+            pos += sizeof(entry);
+            if ((sizeof(TEST_FILE_NAME) - 1 == entry.name_len) &&
+                !OS_MemCmp(payload_v + pos, TEST_FILE_NAME, entry.name_len)) {
+                *size_p  = entry.size;
+                is_found = OS_TRUE;
+            }
+            pos += entry.name_len;
+        }
+    }
+    return is_found;
+}
+
+/******************************************************************************/
+Status FileRead(const Int sd, const U16 seq, const U32 offset, const U32 length, const U8* file_p,
+                NetFileReadAck* ack_p, ReadCheck* check_p)
+{
+static const Str path_str[] = TEST_FILE_PATH;
+static U8 payload_v[TEST_PAYLOAD_MAX];
+U8 request_v[sizeof(NetFileRead) + sizeof(path_str)];
+const NetFileRead req = {
+    .offset = offset,
+    .length = length,
+    .credit = APP_NET_FILE_CREDIT_MAX
+};
+U32 credit_used = 0;
+NetCtrlHdr hdr;
+Bool is_crc_ok;
+Status s;
+
+    OS_MemSet(check_p, 0, sizeof(*check_p));
+    OS_MemCpy(request_v, &req, sizeof(req));
+    OS_MemCpy(request_v + sizeof(req), path_str, sizeof(path_str));
+    IF_STATUS(s = HostTestFrameSend(sd, NET_FILE_MSG_READ, seq, request_v, sizeof(request_v), OS_FALSE)) { return s; }
+    IF_STATUS(s = HostTestFrameReceive(sd, &hdr, (U8*)ack_p, sizeof(*ack_p), &is_crc_ok)) { return s; }
+    if (((NET_FILE_MSG_READ | NET_CTRL_MSG_RESPONSE) != hdr.type) || (seq != hdr.seq) ||
+        (S_OK != hdr.status) || (OS_TRUE != is_crc_ok) || (sizeof(*ack_p) != hdr.len)) {
+        return S_INVALID_VALUE;
+    }
+    while (check_p->bytes < ack_p->length) {
+        NetFileData data;
+        const U8* chunk_p = payload_v + sizeof(data);
+        Size chunk;
+        IF_STATUS(s = HostTestFrameReceive(sd, &hdr, payload_v, sizeof(payload_v), &is_crc_ok)) { return s; }
+        ++check_p->frames;
+        if (((NET_FILE_MSG_DATA | NET_CTRL_MSG_RESPONSE) != hdr.type) || (seq != hdr.seq) ||
+            (S_OK != hdr.status) || (OS_TRUE != is_crc_ok) || (sizeof(data) >= hdr.len)) {
+            ++check_p->errors_frame;
+            return S_INVALID_VALUE;
+        }
+        OS_MemCpy(&data, payload_v, sizeof(data));
+        chunk = hdr.len - sizeof(data);
+        //Chunks come in order and cover the range exactly.
+        if ((ack_p->offset + check_p->bytes) != data.offset) { ++check_p->errors_offset; }
+        if ((data.offset + chunk) > (ack_p->offset + ack_p->length)) {
+            ++check_p->errors_offset;
+            return S_INVALID_VALUE;
+        }
+        if (OS_MemCmp(chunk_p, file_p + data.offset, chunk)) { ++check_p->errors_data; }
+        check_p->bytes += chunk;
+        //The credit is returned in batches as the data is consumed.
+        if (TEST_CREDIT_RETURN <= ++credit_used) {
+            const NetFileCredit credit = { .chunks = credit_used };
+            IF_STATUS(s = HostTestFrameSend(sd, NET_FILE_MSG_CREDIT, seq, &credit, sizeof(credit), OS_FALSE)) { return s; }
+            credit_used = 0;
+        }
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+int main(void)
+{
+const struct timeval tv = { .tv_sec = TEST_RECV_TIMEOUT_MS / 1000 };
+NetFileReadAck ack;
+NetFileStats stats;
+ReadCheck check;
+U32 list_size = 0;
+U64 time_us;
+U8* file_p;
+Int sd;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    file_p = malloc(TEST_FILE_SIZE);
+    HOST_TEST_CHECK(OS_NULL != file_p);
+    if (OS_NULL == file_p) { return HostTestEnd(); }
+    for (U32 i = 0; i < TEST_FILE_SIZE; ++i) {
+        file_p[i] = PatternByteGet(i);
+    }
+    HOST_TEST_CHECK(S_OK == HostTestFileWrite(TEST_FILE_PATH, file_p, TEST_FILE_SIZE));
+    sd = HostTestConnect(APP_NET_FILE_PORT);
+    HOST_TEST_CHECK(0 <= sd);
+    if (0 > sd) {
+        free(file_p);
+        return HostTestEnd();
+    }
+    setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    //The file is listed with its size.
+    HOST_TEST_CHECK(OS_TRUE == FileList(sd, 1, &list_size));
+    HOST_TEST_CHECK(TEST_FILE_SIZE == list_size);
+    //Whole file: sustained credit paced transfer.
+    time_us = HostTestTimeUsGet();
+    HOST_TEST_CHECK(S_OK == FileRead(sd, 2, 0, 0, file_p, &ack, &check));
+    time_us = HostTestTimeUsGet() - time_us;
+    HOST_TEST_CHECK(S_OK == NetFileStatsGet(&stats));
+    {
+        const U32 rate = (U32)(((U64)check.bytes * 1000000) / (time_us ? time_us : 1));
+        printf("\nread: %u bytes, %u frames, %u ms, %u KB/s (server: %u KB/s), credit stalls: %u",
+               check.bytes, check.frames, (U32)(time_us / 1000), rate / 1024, stats.rate_last / 1024,
+               stats.credit_stalls);
+        printf("\nerrors frame: %u, offset: %u, data: %u", check.errors_frame, check.errors_offset, check.errors_data);
+        HOST_TEST_CHECK(TEST_RATE_MIN <= rate);
+    }
+    HOST_TEST_CHECK((TEST_FILE_SIZE == ack.file_size) && (0 == ack.offset) && (TEST_FILE_SIZE == ack.length));
+    HOST_TEST_CHECK(TEST_FILE_SIZE == check.bytes);
+    HOST_TEST_CHECK(0 == check.errors_offset);
+    HOST_TEST_CHECK(0 == check.errors_data);
+    //Range (resumed download).
+    HOST_TEST_CHECK(S_OK == FileRead(sd, 3, TEST_RANGE_OFFSET, TEST_RANGE_LENGTH, file_p, &ack, &check));
+    HOST_TEST_CHECK((TEST_RANGE_OFFSET == ack.offset) && (TEST_RANGE_LENGTH == ack.length));
+    HOST_TEST_CHECK(TEST_RANGE_LENGTH == check.bytes);
+    HOST_TEST_CHECK(0 == check.errors_offset);
+    HOST_TEST_CHECK(0 == check.errors_data);
+    //The file tail read is clipped to the file end.
+    HOST_TEST_CHECK(S_OK == FileRead(sd, 4, TEST_FILE_SIZE - 100, TEST_RANGE_LENGTH, file_p, &ack, &check));
+    HOST_TEST_CHECK((100 == ack.length) && (100 == check.bytes) && (0 == check.errors_data));
+    HOST_TEST_CHECK(S_OK == NetFileStatsGet(&stats));
+    HOST_TEST_CHECK(0 == stats.transfers_active);
+    close(sd);
+    free(file_p);
+    return HostTestEnd();
+}
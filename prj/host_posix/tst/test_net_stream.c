@@ -0,0 +1,316 @@
+/***************************************************************************//**
+* @file    test_net_stream.c
+* @brief   Network stream loopback server: a WAV ramp is served over HTTP with
+*          the injected send jitter, a stall longer than the jitter buffer and
+*          a lost part; the playback continuity and the ingest counters are
+*          checked. The rejected and the oversized response headers must
+*          close the stream socket.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include "os_task.h"
+#include "app_config.h"
+#include "drv_audio.h"
+#include "net_stream.h"
+#include "task_mmplay.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_net_stream"
+
+#define TEST_URL_FMT            "http://127.0.0.1:%u/stream.wav"
+#define TEST_REQUEST_STR        "GET /stream.wav HTTP/1.0\r\n"
+#define TEST_SAMPLE_RATE        16000
+#define TEST_CHANNELS           2
+#define TEST_FRAME_SIZE         (TEST_CHANNELS * sizeof(S16))
+#define TEST_FRAMES             (TEST_SAMPLE_RATE * 3)  // 3 s.
+#define TEST_WAV_HEADER_SIZE    44
+// Sender: 20 ms chunks on the real-time schedule with the pseudo-random jitter.
+#define TEST_CHUNK_FRAMES       (TEST_SAMPLE_RATE / 50)
+#define TEST_CHUNK_SIZE         (TEST_CHUNK_FRAMES * TEST_FRAME_SIZE)
+#define TEST_JITTER_MAX_US      15000
+#define TEST_PREFILL_MS         500
+// The stall outlasts the whole jitter buffer (1 s at this byte rate).
+#define TEST_STALL_AT_MS        1000
+#define TEST_STALL_MS           1500
+// The lost chunk: the ramp jumps over it.
+#define TEST_LOSS_AT_MS         2000
+#define TEST_LOSS_FRAMES        TEST_CHUNK_FRAMES
+// Drift compensation drops a few frames per read at most.
+#define TEST_DROP_FRAMES_MAX    8
+// MMPlay WAV output buffer half (frames): the player ends with two halves not played.
+#define TEST_HALF_FRAMES        (0x1000 / TEST_FRAME_SIZE)
+#define TEST_PLAY_TIMEOUT_MS    (((TEST_FRAMES * 1000) / TEST_SAMPLE_RATE) + TEST_STALL_MS + 5000)
+#define TEST_PEER_TIMEOUT_MS    3000
+#define TEST_CLOSE_TIMEOUT_MS   1000
+#define TEST_ACCEPT_TIMEOUT_MS  5000
+#define TEST_HDR_OVERSIZE       (2 * 512)   // Over the stream response header buffer.
+
+typedef enum {
+    SERVER_MODE_STREAM,
+    SERVER_MODE_REJECT,
+    SERVER_MODE_HDR_OVERSIZE,
+    SERVER_MODE_LAST
+} ServerMode;
+
+typedef struct {
+    Int             listen_sd;
+    ServerMode      mode;
+    Bool            is_request_ok;
+    U32             body_sent;
+    U32             close_ms;           // Peer close after the response (U32_MAX - not closed).
+} StreamServer;
+
+typedef struct {
+    S32             value_last;         // -1: the ramp is not started.
+    U32             pos;                // Ramp position (unwrapped).
+    U32             silences;           // Underrun fill frames.
+    U32             repeats;
+    U32             drops;
+    U32             losses;
+    U32             breaks;             // Ramp discontinuities of no kind above.
+    U32             frames;             // Frames played.
+} SinkCheck;
+
+//------------------------------------------------------------------------------
+static void*    ServerThread(void* args_p);
+static Bool     RequestReceive(const Int sd);
+static void     StreamSend(const Int sd, StreamServer* server_p);
+static U32      PeerCloseWait(const Int sd);
+static Status   StreamPlay(StreamServer* server_p, const ServerMode mode);
+static void     DrvAudioSink(const U8* data_p, const Size size, void* args_p);
+
+/******************************************************************************/
+Bool RequestReceive(const Int sd)
+{
+Str request_v[512];
+Size len = 0;
+    while ((sizeof(request_v) - 1) > len) {
+        const ssize_t rd = recv(sd, request_v + len, sizeof(request_v) - 1 - len, 0);
+        if (0 >= rd) { return OS_FALSE; }
+        len += rd;
+        request_v[len] = '\0';
+        if (OS_NULL != strstr(request_v, "\r\n\r\n")) {
+            return (!OS_StrNCmp(request_v, TEST_REQUEST_STR, OS_StrLen(TEST_REQUEST_STR))) ? OS_TRUE : OS_FALSE;
+        }
+    }
+    return OS_FALSE;
+}
+
+/******************************************************************************/
+void StreamSend(const Int sd, StreamServer* server_p)
+{
+static const Str response_str[] = "HTTP/1.0 200 OK\r\nContent-Type: audio/wav\r\n\r\n";
+U32 wav_size;
+U8* wav_p = HostTestWavRampBuild(TEST_SAMPLE_RATE, TEST_CHANNELS, TEST_FRAMES, &wav_size);
+U64 start_us;
+U32 seed = 1;
+U32 pos;
+    if (OS_NULL == wav_p) { return; }
+    send(sd, response_str, OS_StrLen(response_str), MSG_NOSIGNAL);
+    if (TEST_WAV_HEADER_SIZE == send(sd, wav_p, TEST_WAV_HEADER_SIZE, MSG_NOSIGNAL)) {
+        server_p->body_sent += TEST_WAV_HEADER_SIZE;
+    }
+    start_us = HostTestTimeUsGet();
+    for (pos = TEST_WAV_HEADER_SIZE; pos < wav_size; pos += TEST_CHUNK_SIZE) {
+        const U32 size = ((wav_size - pos) < TEST_CHUNK_SIZE) ? (wav_size - pos) : TEST_CHUNK_SIZE;
+        const U32 chunk_ms = (((pos - TEST_WAV_HEADER_SIZE) / TEST_FRAME_SIZE) * 1000) / TEST_SAMPLE_RATE;
+        U64 due_us = start_us;
+        //Real-time after the prefill, the stall pushes the rest back.
+        if (TEST_PREFILL_MS < chunk_ms) { due_us += (U64)(chunk_ms - TEST_PREFILL_MS) * 1000; }
+        if (TEST_STALL_AT_MS <= chunk_ms) { due_us += (U64)TEST_STALL_MS * 1000; }
+        seed = seed * 1103515245 + 12345;
+        due_us += (seed >> 8) % TEST_JITTER_MAX_US;
+        const U64 now_us = HostTestTimeUsGet();
+        if (due_us > now_us) { usleep((useconds_t)(due_us - now_us)); }
+        if ((TEST_LOSS_AT_MS <= chunk_ms) && ((TEST_LOSS_AT_MS + (TEST_CHUNK_FRAMES * 1000) / TEST_SAMPLE_RATE) > chunk_ms)) {
+            continue;
+        }
+        if ((ssize_t)size != send(sd, wav_p + pos, size, MSG_NOSIGNAL)) { break; }
+        server_p->body_sent += size;
+    }
+    free(wav_p);
+}
+
+/******************************************************************************/
+U32 PeerCloseWait(const Int sd)
+{
+const struct timeval tv = { .tv_usec = 10000 };
+const U64 start_us = HostTestTimeUsGet();
+U8 data_v[64];
+    setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    while ((TEST_PEER_TIMEOUT_MS * 1000ULL) > (HostTestTimeUsGet() - start_us)) {
+        if (0 == recv(sd, data_v, sizeof(data_v), 0)) {
+            return (U32)((HostTestTimeUsGet() - start_us) / 1000);
+        }
+    }
+    return U32_MAX;
+}
+
+/******************************************************************************/
+void* ServerThread(void* args_p)
+{
+static const Str reject_str[] = "HTTP/1.0 404 Not Found\r\nX-Upstream: 200 OK\r\n\r\n";
+StreamServer* server_p = (StreamServer*)args_p;
+static Str hdr_v[TEST_HDR_OVERSIZE];
+const Int sd = accept(server_p->listen_sd, OS_NULL, OS_NULL);
+    if (0 > sd) { return OS_NULL; }
+    server_p->is_request_ok = RequestReceive(sd);
+    if (SERVER_MODE_STREAM == server_p->mode) {
+        StreamSend(sd, server_p);
+    } else {
+        if (SERVER_MODE_REJECT == server_p->mode) {
+            //A "200" past the status line is not the status.
+            send(sd, reject_str, OS_StrLen(reject_str), MSG_NOSIGNAL);
+        } else {
+            //No header end within the response header buffer.
+            OS_MemCpy(hdr_v, "HTTP/1.0 200 OK\r\nX-Pad: ", 24);
+            OS_MemSet(hdr_v + 24, 'x', sizeof(hdr_v) - 24);
+            send(sd, hdr_v, sizeof(hdr_v), MSG_NOSIGNAL);
+        }
+        //The stream keeps the connection open till it gives the response up.
+        server_p->close_ms = PeerCloseWait(sd);
+    }
+    close(sd);
+    return OS_NULL;
+}
+
+/******************************************************************************/
+void DrvAudioSink(const U8* data_p, const Size size, void* args_p)
+{
+SinkCheck* check_p = (SinkCheck*)args_p;
+const S16* frame_p = (const S16*)data_p;
+    for (Size i = 0; i < (size / TEST_FRAME_SIZE); ++i, frame_p += TEST_CHANNELS) {
+        const S32 value = frame_p[0];
+        U32 delta;
+        ++check_p->frames;
+        if (frame_p[1] != value) { ++check_p->breaks; }
+        if (0 > check_p->value_last) {
+            //The ramp start (the leading silence is skipped).
+            if (0 == value) { continue; }
+            if (1 != value) { ++check_p->breaks; }
+            check_p->value_last = value;
+            check_p->pos = value;
+            continue;
+        }
+        delta = (U32)(value - check_p->value_last) & HOST_TEST_RAMP_MASK;
+        if ((0 == value) && (1 != delta)) {
+            ++check_p->silences;
+            continue;
+        }
+        if (1 == delta) {
+        } else if (0 == delta) {
+            ++check_p->repeats;
+        } else if (TEST_DROP_FRAMES_MAX >= delta) {
+            ++check_p->drops;
+        } else if ((TEST_LOSS_FRAMES < delta) && ((TEST_LOSS_FRAMES + TEST_DROP_FRAMES_MAX) >= delta)) {
+            ++check_p->losses;
+        } else {
+            ++check_p->breaks;
+        }
+        check_p->pos += delta;
+        check_p->value_last = value;
+    }
+}
+
+/******************************************************************************/
+Status StreamPlay(StreamServer* server_p, const ServerMode mode)
+{
+const struct timeval tv = { .tv_sec = TEST_ACCEPT_TIMEOUT_MS / 1000 };
+struct sockaddr_in addr = { .sin_family = AF_INET };
+socklen_t addr_len = sizeof(addr);
+Str url_str[APP_NET_STREAM_URL_LEN];
+pthread_t server_thread;
+Status s;
+
+    OS_MemSet(server_p, 0, sizeof(*server_p));
+    server_p->mode      = mode;
+    server_p->close_ms  = U32_MAX;
+    server_p->listen_sd = socket(AF_INET, SOCK_STREAM, 0);
+    if (0 > server_p->listen_sd) { return S_HARDWARE_ERROR; }
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    //The accept timeout: the server thread never outlives the test.
+    setsockopt(server_p->listen_sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if ((0 != bind(server_p->listen_sd, (struct sockaddr*)&addr, sizeof(addr))) ||
+        (0 != listen(server_p->listen_sd, 1)) ||
+        (0 != getsockname(server_p->listen_sd, (struct sockaddr*)&addr, &addr_len)) ||
+        (0 != pthread_create(&server_thread, OS_NULL, ServerThread, server_p))) {
+        close(server_p->listen_sd);
+        return S_HARDWARE_ERROR;
+    }
+    snprintf(url_str, sizeof(url_str), TEST_URL_FMT, ntohs(addr.sin_port));
+    //The rejected stream player may be gone before it is seen.
+    s = HostTestPlayStart(url_str);
+    if (SERVER_MODE_STREAM != mode) { s = S_OK; }
+    IF_OK(s) {
+        s = HostTestPlayEndWait(TEST_PLAY_TIMEOUT_MS);
+    }
+    pthread_join(server_thread, OS_NULL);
+    close(server_p->listen_sd);
+    return s;
+}
+
+/******************************************************************************/
+int main(void)
+{
+static StreamServer server;
+SinkCheck check = { .value_last = -1 };
+NetStreamStats stats_before;
+NetStreamStats stats;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    //The stream with the jitter, the stall and the loss.
+    HOST_TEST_CHECK(S_OK == NetStreamStatsGet(&stats_before));
+    DrvAudioSinkSet(DrvAudioSink, &check);
+    HOST_TEST_CHECK(S_OK == StreamPlay(&server, SERVER_MODE_STREAM));
+    DrvAudioSinkSet(OS_NULL, OS_NULL);
+    HOST_TEST_CHECK(S_OK == NetStreamStatsGet(&stats));
+    printf("\nstream: sent %u, received %u, underruns: %u, late: %u, overflows: %u, dropped: %u, repeated: %u",
+           server.body_sent, stats.jb.bytes_in - stats_before.jb.bytes_in,
+           stats.jb.underruns - stats_before.jb.underruns, stats.jb.late_packets - stats_before.jb.late_packets,
+           stats.jb.overflows - stats_before.jb.overflows,
+           stats.jb.frames_dropped - stats_before.jb.frames_dropped,
+           stats.jb.frames_repeated - stats_before.jb.frames_repeated);
+    printf("\nplayed: %u, ramp pos: %u/%u, silences: %u, repeats: %u, drops: %u, losses: %u, breaks: %u",
+           check.frames, check.pos, TEST_FRAMES, check.silences, check.repeats, check.drops, check.losses,
+           check.breaks);
+    HOST_TEST_CHECK(OS_TRUE == server.is_request_ok);
+    //Every byte sent is ingested: TCP flow control instead of the overflows.
+    HOST_TEST_CHECK(server.body_sent == (stats.jb.bytes_in - stats_before.jb.bytes_in));
+    HOST_TEST_CHECK(stats.jb.overflows == stats_before.jb.overflows);
+    //The stall drains the buffer: the playback goes on with the silence and then resumes.
+    HOST_TEST_CHECK(stats.jb.underruns > stats_before.jb.underruns);
+    HOST_TEST_CHECK(0 != check.silences);
+    //The lost part is the only ramp jump; the rest is in order up to the stream end.
+    HOST_TEST_CHECK(1 == check.losses);
+    HOST_TEST_CHECK(0 == check.breaks);
+    HOST_TEST_CHECK((TEST_FRAMES - 1 - 2 * TEST_HALF_FRAMES) <= check.pos);
+    HOST_TEST_CHECK(NET_SOCKET_UNDEF == NetStreamSocketGet());
+    //The rejected response: the stream socket is closed without the playback.
+    OS_MemSet(&check, 0, sizeof(check));
+    check.value_last = -1;
+    DrvAudioSinkSet(DrvAudioSink, &check);
+    HOST_TEST_CHECK(S_OK == StreamPlay(&server, SERVER_MODE_REJECT));
+    printf("\nreject: closed in %d ms, played: %u", (S32)server.close_ms, check.frames);
+    HOST_TEST_CHECK(OS_TRUE == server.is_request_ok);
+    HOST_TEST_CHECK(TEST_CLOSE_TIMEOUT_MS >= server.close_ms);
+    //The oversized response header.
+    HOST_TEST_CHECK(S_OK == StreamPlay(&server, SERVER_MODE_HDR_OVERSIZE));
+    DrvAudioSinkSet(OS_NULL, OS_NULL);
+    printf("\nheader oversize: closed in %d ms, played: %u", (S32)server.close_ms, check.frames);
+    HOST_TEST_CHECK(OS_TRUE == server.is_request_ok);
+    HOST_TEST_CHECK(TEST_CLOSE_TIMEOUT_MS >= server.close_ms);
+    HOST_TEST_CHECK(0 == check.frames);
+    HOST_TEST_CHECK(NET_SOCKET_UNDEF == NetStreamSocketGet());
+    return HostTestEnd();
+}
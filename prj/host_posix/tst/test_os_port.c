@@ -0,0 +1,263 @@
+/***************************************************************************//**
+* @file    test_os_port.c
+* @brief   Host port test: tasks, queues, timers, file system, heaps and the
+*          simulated audio device clock.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include "os_debug.h"
+#include "os_memory.h"
+#include "os_task.h"
+#include "os_timer.h"
+#include "os_file_system.h"
+#include "os_audio.h"
+#include "drv_audio.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_os_port"
+
+#define OS_SIG_TEST_ECHO        (OS_SIG_APP + 1)
+#define TEST_TIMER_ID           7
+#define TEST_TIMER_PERIOD       10
+#define TEST_AUDIO_BUF_SIZE     9600    // 2 x 25 ms of 48 kHz S16 stereo.
+
+//------------------------------------------------------------------------------
+static void     EchoTaskMain(OS_TaskArgs* args_p);
+static Status   EchoTaskPower(OS_TaskArgs* args_p, const OS_PowerState state);
+static void     ISR_AudioCallback(OS_AudioDeviceCallbackArgs* args_p);
+static U32      SignalsCount(const OS_QueueHd qhd, const OS_SignalId id, const OS_TimeMs timeout);
+static void     TasksTest(const OS_QueueHd qhd);
+static void     TimersTest(const OS_QueueHd qhd);
+static void     FileSystemTest(void);
+static void     HeapsTest(void);
+static void     AudioTest(const OS_QueueHd qhd);
+
+//------------------------------------------------------------------------------
+static volatile Bool is_echo_shutdown;
+static U8 audio_buf[TEST_AUDIO_BUF_SIZE];
+static OS_SignalId audio_events_v[32];
+static volatile U32 audio_events_count;
+
+static const OS_TaskConfig task_echo_cfg = {
+    .name           = "Echo",
+    .func_main      = EchoTaskMain,
+    .func_power     = EchoTaskPower,
+    .attrs          = BIT(OS_TASK_ATTR_SINGLE),
+    .stdin_len      = 4
+};
+
+/******************************************************************************/
+void EchoTaskMain(OS_TaskArgs* args_p)
+{
+const OS_QueueHd reply_qhd = (OS_QueueHd)args_p->args_p;
+OS_Message* msg_p;
+    for (;;) {
+        IF_OK(OS_MessageReceive(OS_TaskStdInGet(OS_THIS_TASK), &msg_p, OS_BLOCK)) {
+            if (OS_SignalIs(msg_p) && (OS_SIG_TEST_ECHO == OS_SignalIdGet(msg_p))) {
+                OS_SignalSend(reply_qhd, OS_SignalCreate(OS_SIG_TEST_ECHO, OS_SignalDataGet(msg_p) + 1),
+                              OS_MSG_PRIO_NORMAL);
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+Status EchoTaskPower(OS_TaskArgs* args_p, const OS_PowerState state)
+{
+    (void)args_p;
+    //The task is current in its power callback.
+    if (OS_NULL == OS_TaskGet()) { return S_INVALID_TASK; }
+    if (PWR_SHUTDOWN == state) { is_echo_shutdown = OS_TRUE; }
+    return S_OK;
+}
+
+/******************************************************************************/
+void ISR_AudioCallback(OS_AudioDeviceCallbackArgs* args_p)
+{
+    if (ITEMS_COUNT_GET(audio_events_v, OS_SignalId) > audio_events_count) {
+        audio_events_v[audio_events_count] = args_p->signal_id;
+        ++audio_events_count;
+    }
+}
+
+/******************************************************************************/
+U32 SignalsCount(const OS_QueueHd qhd, const OS_SignalId id, const OS_TimeMs timeout)
+{
+OS_Message* msg_p;
+U32 count = 0;
+    while (S_OK == OS_MessageReceive(qhd, &msg_p, timeout)) {
+        if (OS_SignalIs(msg_p) && (id == OS_SignalIdGet(msg_p))) { ++count; }
+    }
+    return count;
+}
+
+/******************************************************************************/
+void TasksTest(const OS_QueueHd qhd)
+{
+OS_TaskHd echo_thd;
+OS_TaskHd echo2_thd;
+OS_Message* msg_p;
+
+    HOST_TEST_CHECK(S_OK == OS_TaskCreate(qhd, &task_echo_cfg, &echo_thd));
+    HOST_TEST_CHECK(echo_thd == OS_TaskByNameGet("Echo"));
+    //Single instance.
+    HOST_TEST_CHECK(S_INVALID_STATE == OS_TaskCreate(qhd, &task_echo_cfg, &echo2_thd));
+    HOST_TEST_CHECK(S_OK == OS_SignalSend(OS_TaskStdInGet(echo_thd), OS_SignalCreate(OS_SIG_TEST_ECHO, 41),
+                                          OS_MSG_PRIO_NORMAL));
+    if (HOST_TEST_CHECK(S_OK == OS_MessageReceive(qhd, &msg_p, 1000))) {
+        HOST_TEST_CHECK(OS_SignalIs(msg_p) && (42 == OS_SignalDataGet(msg_p)));
+    }
+    //The task blocked in the receive is deleted.
+    HOST_TEST_CHECK(S_OK == OS_TaskDelete(echo_thd));
+    HOST_TEST_CHECK(OS_NULL == OS_TaskByNameGet("Echo"));
+    HOST_TEST_CHECK(OS_TRUE == is_echo_shutdown);
+}
+
+/******************************************************************************/
+void TimersTest(const OS_QueueHd qhd)
+{
+const OS_TimerConfig tim_cfg = {
+    .name_p = "TestT",
+    .slot   = qhd,
+    .id     = TEST_TIMER_ID,
+    .period = TEST_TIMER_PERIOD,
+    .options= (OS_TimerOptions)BIT(OS_TIM_OPT_PERIODIC)
+};
+OS_TimerHd timer_hd;
+U64 start_us;
+U32 count = 0;
+OS_Message* msg_p;
+
+    HOST_TEST_CHECK(S_OK == OS_TimerCreate(&tim_cfg, &timer_hd));
+    HOST_TEST_CHECK(S_OK == OS_TimerStart(timer_hd, OS_NO_BLOCK));
+    start_us = HostTestTimeUsGet();
+    while (10 > count) {
+        IF_STATUS(OS_MessageReceive(qhd, &msg_p, 100)) { break; }
+        if (OS_SignalIs(msg_p) && (OS_SIG_TIMER == OS_SignalIdGet(msg_p)) &&
+            (TEST_TIMER_ID == OS_SignalDataGet(msg_p))) {
+            ++count;
+        }
+    }
+    //10 periods: 100 ms (the period is kept on the absolute schedule).
+    HOST_TEST_CHECK(10 == count);
+    HOST_TEST_CHECK((HostTestTimeUsGet() - start_us) >= 95000);
+    HOST_TEST_CHECK((HostTestTimeUsGet() - start_us) < 150000);
+    HOST_TEST_CHECK(S_OK == OS_TimerStop(timer_hd, OS_NO_BLOCK));
+    SignalsCount(qhd, OS_SIG_TIMER, 20);
+    HOST_TEST_CHECK(0 == SignalsCount(qhd, OS_SIG_TIMER, 50));
+    HOST_TEST_CHECK(S_OK == OS_TimerDelete(timer_hd, OS_NO_BLOCK));
+}
+
+/******************************************************************************/
+void FileSystemTest(void)
+{
+static const U8 data_v[] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+U8 read_v[sizeof(data_v) * 2];
+OS_FileStats stats;
+OS_FileHd file_hd;
+OS_DirHd dir_hd;
+Bool is_found = OS_FALSE;
+
+    OS_DirCreate("1:/port");
+    HOST_TEST_CHECK(S_OK == HostTestFileWrite("1:/port/a.bin", data_v, sizeof(data_v)));
+    HOST_TEST_CHECK(S_FS_NO_FILE == OS_FileOpen(&file_hd, "1:/port/none.bin",
+                                                BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ)));
+    if (HOST_TEST_CHECK(S_OK == OS_FileOpen(&file_hd, "1:/port/a.bin",
+                                            BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ)))) {
+        HOST_TEST_CHECK(sizeof(data_v) == OS_FileSizeGet(file_hd));
+        HOST_TEST_CHECK(S_OK == OS_FileLSeek(file_hd, 2));
+        HOST_TEST_CHECK(S_OK == OS_FileRead(file_hd, read_v, 2));
+        HOST_TEST_CHECK(0x22 == read_v[0]);
+        HOST_TEST_CHECK(S_OK == OS_FileLSeek(file_hd, 0));
+        HOST_TEST_CHECK(S_FS_EOF == OS_FileRead(file_hd, read_v, sizeof(read_v)));
+        HOST_TEST_CHECK(0 == OS_MemCmp(read_v, data_v, sizeof(data_v)));
+        HOST_TEST_CHECK(S_OK == OS_FileClose(&file_hd));
+    }
+    if (HOST_TEST_CHECK(S_OK == OS_DirOpen("1:/port", &dir_hd))) {
+        while ((S_OK == OS_DirRead(dir_hd, &stats)) && ('\0' != stats.name[0])) {
+            if (0 == OS_StrCmp(stats.name, "a.bin")) {
+                is_found = (sizeof(data_v) == stats.size) ? OS_TRUE : OS_FALSE;
+            }
+        }
+        OS_DirClose(dir_hd);
+    }
+    HOST_TEST_CHECK(OS_TRUE == is_found);
+    HOST_TEST_CHECK(S_OK == OS_FileDelete("1:/port/a.bin"));
+}
+
+/******************************************************************************/
+void HeapsTest(void)
+{
+OS_MemoryStats stats_before;
+OS_MemoryStats stats;
+void* mem_p;
+
+    HOST_TEST_CHECK(S_OK == OS_MemoryStatsGet(OS_MEM_RAM_EXT_SRAM, &stats_before));
+    mem_p = OS_MallocEx(1000, OS_MEM_RAM_EXT_SRAM);
+    HOST_TEST_CHECK(OS_NULL != mem_p);
+    OS_MemoryStatsGet(OS_MEM_RAM_EXT_SRAM, &stats);
+    HOST_TEST_CHECK((stats.used - stats_before.used) >= 1000);
+    OS_FreeEx(mem_p, OS_MEM_RAM_EXT_SRAM);
+    OS_MemoryStatsGet(OS_MEM_RAM_EXT_SRAM, &stats);
+    HOST_TEST_CHECK(stats.used == stats_before.used);
+    //The heap capacity is the target one.
+    HOST_TEST_CHECK(OS_NULL == OS_MallocEx(stats.size + 1, OS_MEM_RAM_EXT_SRAM));
+    OS_MemoryStatsGet(OS_MEM_RAM_EXT_SRAM, &stats);
+    HOST_TEST_CHECK((stats_before.fails + 1) == stats.fails);
+}
+
+/******************************************************************************/
+void AudioTest(const OS_QueueHd qhd)
+{
+const OS_AudioDeviceIoSetupArgs io_args = {
+    .info       = { .sample_rate = 48000, .sample_bits = 16, .channels = OS_AUDIO_CHANNELS_STEREO },
+    .dma_mode   = OS_AUDIO_DMA_MODE_CIRCULAR,
+    .volume     = OS_AUDIO_VOLUME_MAX
+};
+OS_AudioDeviceArgsOpen open_args = {
+    .slot_qhd           = qhd,
+    .isr_callback_func  = ISR_AudioCallback
+};
+const OS_AudioDeviceHd dev_hd = OS_AudioDeviceDefaultGet(DIR_OUT);
+DrvAudioStats stats;
+Bool is_alternate = OS_TRUE;
+
+    DrvAudioStatsReset();
+    HOST_TEST_CHECK(OS_NULL != dev_hd);
+    HOST_TEST_CHECK(S_OK == OS_AudioDeviceIoSetup(dev_hd, &io_args, DIR_OUT));
+    HOST_TEST_CHECK(S_OK == OS_AudioDeviceOpen(dev_hd, &open_args));
+    HOST_TEST_CHECK(S_OK == OS_AudioPlay(dev_hd, audio_buf, sizeof(audio_buf)));
+    //10 halves of 25 ms.
+    OS_TaskDelay(260);
+    HOST_TEST_CHECK(S_OK == OS_AudioStop(dev_hd));
+    HOST_TEST_CHECK(S_OK == OS_AudioDeviceClose(dev_hd));
+    HOST_TEST_CHECK(S_OK == DrvAudioStatsGet(&stats));
+    printf("\naudio: %u parts in 260 ms", stats.parts);
+    HOST_TEST_CHECK((9 <= audio_events_count) && (11 >= audio_events_count));
+    HOST_TEST_CHECK(stats.parts == audio_events_count);
+    for (U32 i = 0; i < audio_events_count; ++i) {
+        const OS_SignalId id = (0 == (i % 2)) ? OS_SIG_AUDIO_TX_COMPLETE_HALF : OS_SIG_AUDIO_TX_COMPLETE;
+        if (id != audio_events_v[i]) { is_alternate = OS_FALSE; }
+    }
+    HOST_TEST_CHECK(OS_TRUE == is_alternate);
+}
+
+/******************************************************************************/
+int main(void)
+{
+const OS_QueueConfig queue_cfg = { .len = 32 };
+OS_QueueHd qhd;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    HOST_TEST_CHECK(S_OK == OS_QueueCreate(&queue_cfg, OS_NULL, &qhd));
+    TasksTest(qhd);
+    TimersTest(qhd);
+    FileSystemTest();
+    HeapsTest();
+    AudioTest(qhd);
+    return HostTestEnd();
+}
@@ -0,0 +1,233 @@
+/***************************************************************************//**
+* @file    test_rtp_sink.c
+* @brief   RTP sink loopback receiver: a WAV ramp is played with the RTP
+*          output to the test UDP socket; the sequence, timestamps, payload
+*          continuity and the packets timing against the ptime are checked.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include "os_task.h"
+#include "os_mailbox.h"
+#include "msg_pool.h"
+#include "rtp_sink.h"
+#include "task_mmplay.h"
+#include "task_netserv.h"
+#include "app_config.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_rtp_sink"
+
+#define TEST_FILE_PATH          "1:/rtp.wav"
+#define TEST_SAMPLE_RATE        48000
+#define TEST_CHANNELS           2
+#define TEST_FRAMES             (TEST_SAMPLE_RATE * 2)  // 2 s.
+#define TEST_PTIME_MS           5
+#define TEST_PACKET_FRAMES      ((TEST_SAMPLE_RATE * TEST_PTIME_MS) / 1000)
+#define TEST_PACKETS            (TEST_FRAMES / TEST_PACKET_FRAMES)
+// MMPlay WAV output buffer half (frames): the audio clock period.
+#define TEST_PERIOD_FRAMES      (0x1000 / (TEST_CHANNELS * sizeof(S16)))
+// The player ends on the file end with the last two output parts not played.
+#define TEST_PACKETS_TAIL       ((2 * TEST_PERIOD_FRAMES) / TEST_PACKET_FRAMES + 1)
+// Packets arrival spread around the median (p99): the sink clock is interpolated
+// up to the next device period event only.
+#define TEST_JITTER_MAX_US      ((TEST_PERIOD_FRAMES * 1000000) / TEST_SAMPLE_RATE)
+#define TEST_DEVIATION_BIAS_US  1000000     // Deviations are kept unsigned for the percentiles.
+#define TEST_RECV_TIMEOUT_MS    200
+#define TEST_PLAY_TIMEOUT_MS    5000
+#define RTP_HDR_SIZE            12
+#define RTP_VERSION             0x80
+#define RTP_MARKER              0x80
+#define RTP_PT_MASK             0x7F
+
+typedef struct {
+    U32             packets;
+    U32             errors_header;      // Version, payload type, SSRC, marker.
+    U32             errors_seq;
+    U32             errors_ts;
+    U32             errors_size;
+    U32             breaks;             // Payload ramp discontinuities.
+    U16             seq_last;
+    U32             ts_first;
+    U32             ts_last;
+    U32             ssrc;
+    S32             value_last;
+    U32             deviations_v[TEST_PACKETS];    // Arrival against the timestamp schedule (biased).
+    U64             arrival_first_us;
+} RtpCheck;
+
+//------------------------------------------------------------------------------
+static Status   RtpSinkCtl(const Bool is_start, const U16 port);
+static void     PacketCheck(RtpCheck* check_p, const U8* pkt_p, const Size size, const U64 arrival_us);
+static void     JitterGet(RtpCheck* check_p, U32* p99_us_p, U32* max_us_p);
+static U16      U16Get(const U8* p);
+static U32      U32Get(const U8* p);
+
+/******************************************************************************/
+U16 U16Get(const U8* p)
+{
+    return (U16)((p[0] << 8) | p[1]);
+}
+
+/******************************************************************************/
+U32 U32Get(const U8* p)
+{
+    return ((U32)p[0] << 24) | ((U32)p[1] << 16) | ((U32)p[2] << 8) | p[3];
+}
+
+/******************************************************************************/
+Status RtpSinkCtl(const Bool is_start, const U16 port)
+{
+const OS_TaskHd netserv_thd = OS_TaskByNameGet(APP_TASK_NAME_NETSERV);
+const RtpSinkConfig cfg = {
+    .addr       = htonl(INADDR_LOOPBACK),
+    .port       = port,
+    .ptime_ms   = TEST_PTIME_MS
+};
+OS_Message* msg_p;
+Status s;
+    if (OS_NULL == netserv_thd) { return S_INVALID_STATE; }
+    //As the shell "rtp" command.
+    if (OS_TRUE != is_start) {
+        return OS_SignalSend(OS_TaskStdInGet(netserv_thd), OS_SignalCreate(OS_SIG_NETSERV_RTP_SINK_STOP, 0), OS_MSG_PRIO_NORMAL);
+    }
+    msg_p = MsgPoolCreate(OS_MSG_NETSERV_RTP_SINK_START, sizeof(cfg), OS_NO_BLOCK, &cfg);
+    if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+    IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(netserv_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+        MsgPoolDelete(msg_p);
+    }
+    return s;
+}
+
+/******************************************************************************/
+void PacketCheck(RtpCheck* check_p, const U8* pkt_p, const Size size, const U64 arrival_us)
+{
+const Bool is_first = (0 == check_p->packets);
+const U16 seq = U16Get(&pkt_p[2]);
+const U32 ts  = U32Get(&pkt_p[4]);
+const U32 ssrc= U32Get(&pkt_p[8]);
+const Size frame_size = TEST_CHANNELS * sizeof(S16);
+S64 deviation_us;
+
+    if (RTP_HDR_SIZE > size) {
+        ++check_p->errors_size;
+        return;
+    }
+    //Dynamic payload type (not 44.1 kHz); the marker is on the stream start only.
+    if ((RTP_VERSION != pkt_p[0]) || (APP_RTP_SINK_PT_DYNAMIC != (pkt_p[1] & RTP_PT_MASK)) ||
+        (is_first != (0 != (pkt_p[1] & RTP_MARKER))) || (!is_first && (ssrc != check_p->ssrc))) {
+        ++check_p->errors_header;
+    }
+    if ((RTP_HDR_SIZE + TEST_PACKET_FRAMES * frame_size) != size) { ++check_p->errors_size; }
+    if (OS_TRUE == is_first) {
+        check_p->ssrc               = ssrc;
+        check_p->ts_first           = ts;
+        check_p->arrival_first_us   = arrival_us;
+    } else {
+        if ((U16)(check_p->seq_last + 1) != seq) { ++check_p->errors_seq; }
+        if ((check_p->ts_last + TEST_PACKET_FRAMES) != ts) { ++check_p->errors_ts; }
+    }
+    //Packets leave on the playback clock: the arrival follows the timestamps.
+    deviation_us = (S64)(arrival_us - check_p->arrival_first_us) -
+                   (S64)(((U64)(U32)(ts - check_p->ts_first) * 1000000) / TEST_SAMPLE_RATE);
+    if (TEST_PACKETS > check_p->packets) {
+        check_p->deviations_v[check_p->packets] = (U32)(deviation_us + TEST_DEVIATION_BIAS_US);
+    }
+    //L16 payload (network order): the ramp goes on over the packets.
+    for (Size pos = RTP_HDR_SIZE; (pos + frame_size) <= size; pos += frame_size) {
+        const S32 value = (S16)U16Get(&pkt_p[pos]);
+        const S32 value_expected = is_first && (RTP_HDR_SIZE == pos) ? 0 : ((check_p->value_last + 1) & HOST_TEST_RAMP_MASK);
+        if ((value_expected != value) || ((S16)U16Get(&pkt_p[pos + sizeof(S16)]) != value)) { ++check_p->breaks; }
+        check_p->value_last = value;
+    }
+    check_p->seq_last = seq;
+    check_p->ts_last  = ts;
+    ++check_p->packets;
+}
+
+/******************************************************************************/
+void JitterGet(RtpCheck* check_p, U32* p99_us_p, U32* max_us_p)
+{
+const Size count = (TEST_PACKETS < check_p->packets) ? TEST_PACKETS : check_p->packets;
+U32 median;
+    if (0 == count) {
+        *p99_us_p = *max_us_p = 0;
+        return;
+    }
+    median = HostTestPercentileGet(check_p->deviations_v, count, 50);
+    for (Size i = 0; i < count; ++i) {
+        const U32 value = check_p->deviations_v[i];
+        check_p->deviations_v[i] = (value > median) ? (value - median) : (median - value);
+    }
+    *p99_us_p = HostTestPercentileGet(check_p->deviations_v, count, 99);
+    *max_us_p = HostTestPercentileGet(check_p->deviations_v, count, 100);
+}
+
+/******************************************************************************/
+int main(void)
+{
+const struct timeval tv = { .tv_usec = TEST_RECV_TIMEOUT_MS * 1000 };
+struct sockaddr_in addr = { .sin_family = AF_INET };
+socklen_t addr_len = sizeof(addr);
+static U8 pkt_v[RTP_HDR_SIZE + APP_RTP_SINK_PAYLOAD_MAX + 1];
+static RtpCheck check;
+RtpSinkStats stats;
+U32 jitter_p99_us, jitter_max_us;
+U32 wait_ms = 0;
+Int sd;
+
+    IF_STATUS(HostTestStart()) {
+        HOST_TEST_CHECK(OS_FALSE);
+        return HostTestEnd();
+    }
+    //Receiver on the loopback ephemeral port.
+    sd = socket(AF_INET, SOCK_DGRAM, 0);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    HOST_TEST_CHECK(0 <= sd);
+    HOST_TEST_CHECK(0 == bind(sd, (struct sockaddr*)&addr, sizeof(addr)));
+    HOST_TEST_CHECK(0 == getsockname(sd, (struct sockaddr*)&addr, &addr_len));
+    setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    HOST_TEST_CHECK(S_OK == HostTestWavRampWrite(TEST_FILE_PATH, TEST_SAMPLE_RATE, TEST_CHANNELS, TEST_FRAMES));
+    HOST_TEST_CHECK(S_OK == RtpSinkCtl(OS_TRUE, ntohs(addr.sin_port)));
+    while ((OS_TRUE != RtpSinkIsStarted()) && (TEST_PLAY_TIMEOUT_MS > wait_ms)) {
+        usleep(1000);
+        ++wait_ms;
+    }
+    HOST_TEST_CHECK(OS_TRUE == RtpSinkIsStarted());
+    HOST_TEST_CHECK(S_OK == HostTestPlayStart(TEST_FILE_PATH));
+    //Receive till the player ends and the sink goes quiet.
+    for (wait_ms = 0; TEST_PLAY_TIMEOUT_MS > wait_ms;) {
+        const ssize_t len = recv(sd, pkt_v, sizeof(pkt_v), 0);
+        if (0 <= len) {
+            PacketCheck(&check, pkt_v, (Size)len, HostTestTimeUsGet());
+        } else {
+            if (OS_NULL == OS_TaskByNameGet(APP_TASK_NAME_MMPLAY)) { break; }
+            wait_ms += TEST_RECV_TIMEOUT_MS;
+        }
+    }
+    HOST_TEST_CHECK(S_OK == HostTestPlayEndWait(TEST_PLAY_TIMEOUT_MS));
+    HOST_TEST_CHECK(S_OK == RtpSinkCtl(OS_FALSE, 0));
+    HOST_TEST_CHECK(S_OK == RtpSinkStatsGet(&stats));
+    close(sd);
+    JitterGet(&check, &jitter_p99_us, &jitter_max_us);
+    printf("\npackets: %u/%u, sent: %u, dropped: %u, send errors: %u",
+           check.packets, TEST_PACKETS, stats.packets_sent, stats.packets_dropped, stats.send_errors);
+    printf("\nerrors header: %u, seq: %u, ts: %u, size: %u, breaks: %u, jitter p99: %u us, max: %u us",
+           check.errors_header, check.errors_seq, check.errors_ts, check.errors_size, check.breaks,
+           jitter_p99_us, jitter_max_us);
+    HOST_TEST_CHECK((TEST_PACKETS - TEST_PACKETS_TAIL) <= check.packets);
+    HOST_TEST_CHECK(stats.packets_sent == check.packets);
+    HOST_TEST_CHECK(0 == stats.packets_dropped);
+    HOST_TEST_CHECK(0 == stats.send_errors);
+    HOST_TEST_CHECK(0 == check.errors_header);
+    HOST_TEST_CHECK(0 == check.errors_seq);
+    HOST_TEST_CHECK(0 == check.errors_ts);
+    HOST_TEST_CHECK(0 == check.errors_size);
+    HOST_TEST_CHECK(0 == check.breaks);
+    HOST_TEST_CHECK(TEST_JITTER_MAX_US >= jitter_p99_us);
+    return HostTestEnd();
+}
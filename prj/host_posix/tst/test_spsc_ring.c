@@ -0,0 +1,202 @@
+/***************************************************************************//**
+* @file    test_spsc_ring.c
+* @brief   SPSC ring: the full ring overflow count, the wakeup re-arm and the
+*          producer/consumer stress (the ISR and the task as two threads): the
+*          items order and integrity, the overflow count against the items
+*          lost, the coalesced wakeups and no lost wakeup.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include "os_common.h"
+#include "spsc_ring.h"
+#include "host_test.h"
+
+//------------------------------------------------------------------------------
+#define MDL_NAME                "test_spsc_ring"
+
+#define TEST_ITEMS_COUNT        64
+#define TEST_ITEMS_TOTAL        2000000
+#define TEST_BURST_MAX          96          // Larger than the ring: the overflows.
+#define TEST_WAKEUP_TIMEOUT_MS  1000        // No items for so long: a lost wakeup.
+
+//------------------------------------------------------------------------------
+typedef struct {
+    U32             seq;
+    U32             seq_inv;            // ~seq: a torn item.
+} TestItem;
+
+typedef struct {
+    SpscRing        ring;
+    sem_t           wakeup_sem;
+    volatile Bool   is_done;            // The producer has put the last item.
+    U32             wakeups;            // Producer owned.
+    U32             received;           // Consumer owned.
+    U32             disorders;
+    U32             torn;
+    U32             wakeups_handled;
+    U32             wakeups_empty;      // Handled with the ring already drained.
+    U32             lost_wakeups;
+} TestCtx;
+
+//------------------------------------------------------------------------------
+static U32      RandGet(U32* seed_p);
+static void     OverflowCheck(void);
+static void*    ProducerThread(void* args_p);
+static void*    ConsumerThread(void* args_p);
+static void     StressCheck(void);
+
+static TestItem items_v[TEST_ITEMS_COUNT];
+
+/******************************************************************************/
+U32 RandGet(U32* seed_p)
+{
+    *seed_p = *seed_p * 1103515245 + 12345;
+    return *seed_p >> 8;
+}
+
+/******************************************************************************/
+void OverflowCheck(void)
+{
+SpscRing ring;
+SpscRingStats stats;
+TestItem item;
+U32 notifies = 0;
+
+    HOST_TEST_CHECK(S_INVALID_SIZE == SpscRingInit(&ring, items_v, sizeof(TestItem), TEST_ITEMS_COUNT - 1));
+    HOST_TEST_CHECK(S_OK == SpscRingInit(&ring, items_v, sizeof(TestItem), TEST_ITEMS_COUNT));
+    //No consumer: a single wakeup, the ring is full and the rest is dropped.
+    for (U32 i = 0; i < TEST_ITEMS_COUNT + 10; ++i) {
+        item.seq = i;
+        item.seq_inv = ~i;
+        if (OS_TRUE == SpscRingPut(&ring, &item)) { ++notifies; }
+    }
+    HOST_TEST_CHECK(S_OK == SpscRingStatsGet(&ring, &stats));
+    HOST_TEST_CHECK(1 == notifies);
+    HOST_TEST_CHECK((1 == stats.notifies) && (10 == stats.overflows));
+    HOST_TEST_CHECK((TEST_ITEMS_COUNT == stats.depth) && (TEST_ITEMS_COUNT == stats.depth_max));
+    //The oldest items stay, in order.
+    HOST_TEST_CHECK((OS_TRUE == SpscRingPeek(&ring, &item)) && (0 == item.seq));
+    for (U32 i = 0; i < TEST_ITEMS_COUNT; ++i) {
+        HOST_TEST_CHECK((OS_TRUE == SpscRingGet(&ring, &item)) && (i == item.seq));
+    }
+    HOST_TEST_CHECK(OS_TRUE != SpscRingGet(&ring, &item));
+    //Not re-armed by the consumer yet: still no wakeup.
+    HOST_TEST_CHECK(OS_TRUE != SpscRingPut(&ring, &item));
+    SpscRingNotifyClear(&ring);
+    HOST_TEST_CHECK(OS_TRUE == SpscRingPut(&ring, &item));
+    //The failed wakeup send is asked for again.
+    SpscRingNotifyCancel(&ring);
+    HOST_TEST_CHECK(OS_TRUE == SpscRingPut(&ring, &item));
+    HOST_TEST_CHECK((S_OK == SpscRingStatsGet(&ring, &stats)) && (2 == stats.notifies));
+    SpscRingFlush(&ring);
+    HOST_TEST_CHECK((S_OK == SpscRingStatsGet(&ring, &stats)) && (0 == stats.depth));
+    HOST_TEST_CHECK(OS_TRUE == SpscRingPut(&ring, &item));
+}
+
+/******************************************************************************/
+void* ProducerThread(void* args_p)
+{
+TestCtx* ctx_p = (TestCtx*)args_p;
+TestItem item;
+U32 seed = 3;
+U32 seq = 0;
+
+    while (TEST_ITEMS_TOTAL > seq) {
+        //Bursts (the ISR) and the gaps between them.
+        const U32 burst = 1 + RandGet(&seed) % TEST_BURST_MAX;
+        for (U32 i = 0; (i < burst) && (TEST_ITEMS_TOTAL > seq); ++i, ++seq) {
+            item.seq = seq;
+            item.seq_inv = ~seq;
+            if (OS_TRUE == SpscRingPut(&ctx_p->ring, &item)) {
+                ++ctx_p->wakeups;
+                sem_post(&ctx_p->wakeup_sem);
+            }
+        }
+        sched_yield();
+    }
+    ctx_p->is_done = OS_TRUE;
+    return OS_NULL;
+}
+
+/******************************************************************************/
+void* ConsumerThread(void* args_p)
+{
+TestCtx* ctx_p = (TestCtx*)args_p;
+TestItem item;
+U32 seq_next = 0;
+struct timespec deadline;
+
+    for (;;) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += TEST_WAKEUP_TIMEOUT_MS / 1000;
+        if (0 != sem_timedwait(&ctx_p->wakeup_sem, &deadline)) {
+            if (EINTR == errno) { continue; }
+            //Items are waiting with no wakeup sent.
+            if (ctx_p->ring.tail != ctx_p->ring.head) { ++ctx_p->lost_wakeups; }
+            break;
+        }
+        ++ctx_p->wakeups_handled;
+        //Re-arm first: the items put during the drain wake up again.
+        SpscRingNotifyClear(&ctx_p->ring);
+        if (OS_TRUE != SpscRingGet(&ctx_p->ring, &item)) {
+            ++ctx_p->wakeups_empty;
+            continue;
+        }
+        do {
+            if (item.seq != ~item.seq_inv) { ++ctx_p->torn; }
+            //The overflows drop the items: the gaps, never a step back.
+            if (item.seq < seq_next) { ++ctx_p->disorders; }
+            seq_next = item.seq + 1;
+            ++ctx_p->received;
+        } while (OS_TRUE == SpscRingGet(&ctx_p->ring, &item));
+        //The last items may be dropped: done once the ring is empty after the last put.
+        if ((OS_TRUE == ctx_p->is_done) && (ctx_p->ring.tail == ctx_p->ring.head)) { break; }
+    }
+    return OS_NULL;
+}
+
+/******************************************************************************/
+void StressCheck(void)
+{
+static TestCtx ctx;
+SpscRingStats stats;
+pthread_t producer_thread;
+pthread_t consumer_thread;
+Int wakeups_pending = 0;
+
+    HOST_TEST_CHECK(S_OK == SpscRingInit(&ctx.ring, items_v, sizeof(TestItem), TEST_ITEMS_COUNT));
+    HOST_TEST_CHECK(0 == sem_init(&ctx.wakeup_sem, 0, 0));
+    HOST_TEST_CHECK(0 == pthread_create(&consumer_thread, OS_NULL, ConsumerThread, &ctx));
+    HOST_TEST_CHECK(0 == pthread_create(&producer_thread, OS_NULL, ProducerThread, &ctx));
+    pthread_join(producer_thread, OS_NULL);
+    pthread_join(consumer_thread, OS_NULL);
+    //The wakeups sent during the last drain.
+    sem_getvalue(&ctx.wakeup_sem, &wakeups_pending);
+    sem_destroy(&ctx.wakeup_sem);
+    HOST_TEST_CHECK(S_OK == SpscRingStatsGet(&ctx.ring, &stats));
+    printf("\nreceived: %u, overflows: %u, wakeups: %u (empty: %u), depth max: %u",
+           ctx.received, stats.overflows, ctx.wakeups, ctx.wakeups_empty, stats.depth_max);
+    HOST_TEST_CHECK(0 == ctx.lost_wakeups);
+    HOST_TEST_CHECK(0 == ctx.torn);
+    HOST_TEST_CHECK(0 == ctx.disorders);
+    //Every item is either received or counted as the overflow.
+    HOST_TEST_CHECK(TEST_ITEMS_TOTAL == ctx.received + stats.overflows);
+    HOST_TEST_CHECK(0 < stats.overflows);
+    HOST_TEST_CHECK(0 == stats.depth);
+    //Every wakeup is handled; many items are taken with a single one.
+    HOST_TEST_CHECK((ctx.wakeups == stats.notifies) && (ctx.wakeups == ctx.wakeups_handled + (U32)wakeups_pending));
+    HOST_TEST_CHECK(ctx.wakeups < ctx.received / 2);
+}
+
+/******************************************************************************/
+int main(void)
+{
+    OverflowCheck();
+    StressCheck();
+    return HostTestEnd();
+}
@@ -6,6 +6,7 @@
 #ifndef _APP_COMMON_H_
 #define _APP_COMMON_H_
 
+#include "hal.h"
 #include "os_common.h"
 #include "os_debug.h"
 #include "os_task.h"
@@ -13,4 +14,38 @@
 #include "os_signal.h"
 #include "app_config.h"
 
+//------------------------------------------------------------------------------
+// Host (POSIX) port of the application: the target registers are not used.
+#ifndef APP_PORT_POSIX
+#define APP_PORT_POSIX                       (0)
+#endif // APP_PORT_POSIX
+
+#if (APP_PORT_POSIX)
+void AppPortCriticalEnter(void);
+void AppPortCriticalExit(void);
+void AppPortCyclesInit(void);
+U32  AppPortCyclesGet(void);
+
+// Process-wide recursive lock (the tasks are threads, no ISRs).
+#define APP_CRITICAL_SECTION_ENTER(primask)  do { (primask) = 0; AppPortCriticalEnter(); } while (0)
+#define APP_CRITICAL_SECTION_EXIT(primask)   do { (void)(primask); AppPortCriticalExit(); } while (0)
+#define APP_MEMORY_BARRIER()                 __sync_synchronize()
+// Monotonic clock in the "cycles" of 1 ns (U32, wraps like CYCCNT).
+#define APP_CYCLES_INIT()                    AppPortCyclesInit()
+#define APP_CYCLES_GET()                     AppPortCyclesGet()
+#define APP_CYCLES_PER_US                    (1000)
+#define APP_CLZ(v)                           (((v) != 0) ? (U32)__builtin_clz(v) : 32)
+#else
+// Interrupt-safe critical section (usable from both task and ISR context).
+#define APP_CRITICAL_SECTION_ENTER(primask)  do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define APP_CRITICAL_SECTION_EXIT(primask)   __set_PRIMASK(primask)
+#define APP_MEMORY_BARRIER()                 __DMB()
+// DWT cycle counter (from the power-on).
+#define APP_CYCLES_INIT()                    do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; \
+                                                  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while (0)
+#define APP_CYCLES_GET()                     (DWT->CYCCNT)
+#define APP_CYCLES_PER_US                    (SystemCoreClock / 1000000)
+#define APP_CLZ(v)                           __CLZ(v)
+#endif //(APP_PORT_POSIX)
+
 #endif // _APP_COMMON_H_
\ No newline at end of file
@@ -0,0 +1,60 @@
+/***************************************************************************//**
+* @file    app_port_posix.c
+* @brief   Application host (POSIX) port.
+* @author  A. Filyanov
+* @details The target dependent parts of the application (app_common.h) for
+*          a host build over the diOS POSIX port: the tasks are threads, so
+*          the critical section is a process-wide recursive lock and the
+*          cycle counter is the monotonic clock.
+*******************************************************************************/
+#include "app_common.h"
+
+#if (APP_PORT_POSIX)
+#include <pthread.h>
+#include <time.h>
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "app_port_posix"
+
+//-----------------------------------------------------------------------------
+static pthread_mutex_t critical_mutex;
+static pthread_once_t critical_once = PTHREAD_ONCE_INIT;
+
+/*****************************************************************************/
+static void CriticalInit(void)
+{
+pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    //Nested sections (as nested PRIMASK save/restore on the target).
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/*****************************************************************************/
+void AppPortCriticalEnter(void)
+{
+    pthread_once(&critical_once, CriticalInit);
+    pthread_mutex_lock(&critical_mutex);
+}
+
+/*****************************************************************************/
+void AppPortCriticalExit(void)
+{
+    pthread_mutex_unlock(&critical_mutex);
+}
+
+/*****************************************************************************/
+void AppPortCyclesInit(void)
+{
+}
+
+/*****************************************************************************/
+U32 AppPortCyclesGet(void)
+{
+struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (U32)((U64)ts.tv_sec * 1000000000ULL + (U64)ts.tv_nsec);
+}
+
+#endif //(APP_PORT_POSIX)
@@ -0,0 +1,96 @@
+/***************************************************************************//**
+* @file    audio_buf_pool.c
+* @brief   Audio stream buffers pool.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_memory.h"
+#include "app_common.h"
+#include "audio_buf_pool.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "audio_buf_pool"
+
+#define ALIGN_UP(v, a)      ((((v) + ((a) - 1)) / (a)) * (a))
+
+//-----------------------------------------------------------------------------
+static const AudioBufPoolClassConfig pool_cfg_v[] = APP_AUDIO_BUF_POOL_CLASSES;
+#define POOL_CLASSES_COUNT  ITEMS_COUNT_GET(pool_cfg_v, AudioBufPoolClassConfig)
+
+static MemPool pools_v[POOL_CLASSES_COUNT];
+static void* pool_mem_p;
+
+/*****************************************************************************/
+Status AudioBufPoolInit(void)
+{
+Size pool_size = 0;
+U8* block_p;
+Status s = S_UNDEF;
+    if (OS_NULL != pool_mem_p) { return S_INITED; }
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        pool_size += ALIGN_UP(pool_cfg_v[i].block_size, APP_AUDIO_BUF_POOL_ALIGN) * pool_cfg_v[i].blocks_count;
+    }
+    //Reserve once with the alignment slack.
+    pool_mem_p = OS_MallocEx(pool_size + APP_AUDIO_BUF_POOL_ALIGN, APP_AUDIO_BUF_POOL_MEMORY);
+    if (OS_NULL == pool_mem_p) { return S_OUT_OF_MEMORY; }
+    block_p = (U8*)ALIGN_UP((Size)pool_mem_p, APP_AUDIO_BUF_POOL_ALIGN);
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        const Size block_size = ALIGN_UP(pool_cfg_v[i].block_size, APP_AUDIO_BUF_POOL_ALIGN);
+        IF_STATUS(s = MemPoolInit(&pools_v[i], block_p, block_size, pool_cfg_v[i].blocks_count)) {
+            OS_FreeEx(pool_mem_p, APP_AUDIO_BUF_POOL_MEMORY);
+            pool_mem_p = OS_NULL;
+            return s;
+        }
+        block_p += block_size * pool_cfg_v[i].blocks_count;
+    }
+    OS_LOG(D_DEBUG, "Audio buffers pool: %u bytes", (U32)pool_size);
+    return s;
+}
+
+/*****************************************************************************/
+void* AudioBufAcquire(const Size size)
+{
+void* buf_p = OS_NULL;
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        if (size <= pools_v[i].block_size) {
+            buf_p = MemPoolAlloc(&pools_v[i]);
+            if (OS_NULL != buf_p) { break; }
+        }
+    }
+    return buf_p;
+}
+
+/*****************************************************************************/
+Status AudioBufRelease(void* buf_p)
+{
+    if (OS_NULL == buf_p) { return S_INVALID_PTR; }
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        if (OS_TRUE == MemPoolIsOwner(&pools_v[i], buf_p)) {
+            return MemPoolFree(&pools_v[i], buf_p);
+        }
+    }
+    return S_INVALID_PTR;
+}
+
+/*****************************************************************************/
+Size AudioBufPoolClassesCountGet(void)
+{
+    return POOL_CLASSES_COUNT;
+}
+
+/*****************************************************************************/
+Status AudioBufPoolStatsGet(const Size class_idx, MemPoolStats* stats_p)
+{
+    if (POOL_CLASSES_COUNT <= class_idx) { return S_INVALID_VALUE; }
+    return MemPoolStatsGet(&pools_v[class_idx], stats_p);
+}
+
+/*****************************************************************************/
+void AudioBufPoolStatsReset(void)
+{
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        MemPoolStatsReset(&pools_v[i]);
+    }
+}
+
+#endif //(OS_AUDIO_ENABLED)
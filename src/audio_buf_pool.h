@@ -0,0 +1,49 @@
+/***************************************************************************//**
+* @file    audio_buf_pool.h
+* @brief   Audio stream buffers pool.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _AUDIO_BUF_POOL_H_
+#define _AUDIO_BUF_POOL_H_
+
+#include "mem_pool.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+typedef struct {
+    Size            block_size;
+    U16             blocks_count;
+} AudioBufPoolClassConfig;
+
+//-----------------------------------------------------------------------------
+/// @brief      Reserve audio buffers pool memory.
+/// @return     #Status.
+Status          AudioBufPoolInit(void);
+
+/// @brief      Acquire audio buffer.
+/// @param[in]  size           Buffer size.
+/// @return     Buffer pointer (DMA-safe aligned) or OS_NULL.
+/// @details    Takes the smallest fitting class with a free block.
+void*           AudioBufAcquire(const Size size);
+
+/// @brief      Release audio buffer.
+/// @param[in]  buf_p          Buffer pointer.
+/// @return     #Status.
+Status          AudioBufRelease(void* buf_p);
+
+/// @brief      Get audio buffers pool classes count.
+/// @return     Classes count.
+Size            AudioBufPoolClassesCountGet(void);
+
+/// @brief      Get audio buffers pool class statistics.
+/// @param[in]  class_idx      Class index.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          AudioBufPoolStatsGet(const Size class_idx, MemPoolStats* stats_p);
+
+/// @brief      Reset audio buffers pool statistics.
+void            AudioBufPoolStatsReset(void);
+
+#endif //(OS_AUDIO_ENABLED)
+
+#endif // _AUDIO_BUF_POOL_H_
@@ -3,12 +3,17 @@
 * @brief   Audio format codecs.
 * @author  A. Filyanov
 *******************************************************************************/
+#include "hal.h"
 #include "os_common.h"
 #include "os_debug.h"
 #include "os_file_system.h"
+#include "app_config.h"
 #include "audio_codec.h"
 #include "audio_codec_wav.h"
+#if (APP_AUDIO_CODEC_MP3_ENABLED)
 #include "audio_codec_mp3.h"
+#endif //(APP_AUDIO_CODEC_MP3_ENABLED)
+#include "dlog.h"
 #undef malloc
 #undef free
 #include "os_memory.h"
@@ -19,6 +24,9 @@
 #undef  MDL_STATUS_ITEMS
 #define MDL_STATUS_ITEMS        &status_codec_v[0]
 
+//-----------------------------------------------------------------------------
+DLOG_MODULE_DEFINE(APP_DLOG_RATE_DEFAULT);
+
 const StatusItem status_codec_v[] = {
 //audio codec common
     {"Undefined status"},
@@ -28,7 +36,8 @@ const StatusItem status_codec_v[] = {
     {"Encode error"},
     {"Decode error"},
     {"No frame found"},
-    {"Output buffer full"}
+    {"Output buffer full"},
+    {"Codec busy"}
 };
 
 //------------------------------------------------------------------------------
@@ -43,17 +52,23 @@ const AudioCodecItf* audio_codecs_v[AUDIO_CODEC_LAST];
 Status AudioCodecInit_(void);
 Status AudioCodecInit_(void)
 {
+const AudioCodecItf* codecs_v[AUDIO_CODEC_LAST];
 Status s = S_UNDEF;
-    HAL_MemSet(audio_codecs_v, 0x0, sizeof(audio_codecs_v));
-    audio_codecs_v[AUDIO_CODEC_WAV] = &audio_codec_wav;
-    audio_codecs_v[AUDIO_CODEC_MP3] = &audio_codec_mp3;
+    HAL_MemSet(codecs_v, 0x0, sizeof(codecs_v));
+    codecs_v[AUDIO_CODEC_WAV] = &audio_codec_wav;
+#if (APP_AUDIO_CODEC_MP3_ENABLED)
+    codecs_v[AUDIO_CODEC_MP3] = &audio_codec_mp3;
+#endif //(APP_AUDIO_CODEC_MP3_ENABLED)
 
     for (Size i = 0; i < AUDIO_CODEC_LAST; ++i) {
-        OS_ASSERT_VALUE(audio_codecs_v[i]);
-        OS_ASSERT_VALUE(audio_codecs_v[i]->Init);
-        IF_STATUS(s = audio_codecs_v[i]->Init(OS_NULL)) {
+        //Disabled codec: the format is unsupported.
+        if (OS_NULL == codecs_v[i]) { continue; }
+        OS_ASSERT_VALUE(codecs_v[i]->Init);
+        IF_STATUS(s = codecs_v[i]->Init(OS_NULL)) {
             return s;
         }
+        //Codecs are inited after the scheduler start: published once ready.
+        audio_codecs_v[i] = codecs_v[i];
     }
     return s;
 }
@@ -78,29 +93,9 @@ Status s = S_UNDEF;
     if (OS_NULL == file_buf_p) { return s = S_OUT_OF_MEMORY; }
     IF_OK(s = OS_FileOpen(&file_hd, file_path_str_p,
                           BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
-        IF_OK(s = OS_FileRead(file_hd, file_buf_p, FILE_BUF_SIZE)) {
+        IF_OK(s = OS_FileRead(file_hd, file_buf_p, file_buf_size)) {
             IF_OK(s = OS_FileClose(&file_hd)) {
-                AudioCodecHd codec_hd;
-                ConstStrP file_ext_p = OS_StrChr(file_path_str_p, '.');
-                if (OS_NULL != file_ext_p) {
-                    ++file_ext_p;
-                    if (!OS_StrCmp(file_ext_p, "wav")) {
-                        codec_hd = audio_codecs_v[AUDIO_CODEC_WAV];
-                    } else if (!OS_StrCmp(file_ext_p, "mp3")) {
-                        codec_hd = audio_codecs_v[AUDIO_CODEC_MP3];
-                    } else { s = S_AUDIO_CODEC_FORMAT_UNSUPPORTED; }
-                    IF_OK(s = AudioCodecOpen(codec_hd, OS_NULL)) {
-                        IF_STATUS(s = AudioCodecIsFormat(codec_hd, file_buf_p, FILE_BUF_SIZE, info_p)) {
-                            if (S_AUDIO_CODEC_FORMAT_MISMATCH == s) {
-                                //May not enough buffer memory to find out the header format.
-                            } else if (S_INVALID_SIZE == s) {
-                            } else {
-                            }
-                            OS_LOG_S(D_WARNING, s);
-                        }
-                        IF_STATUS(AudioCodecClose(codec_hd, OS_NULL)) {}
-                    } else { OS_LOG_S(D_WARNING, s); }
-                }
+                s = AudioFormatInfoGet(file_path_str_p, file_buf_p, file_buf_size, info_p);
             }
         }
     }
@@ -108,10 +103,54 @@ Status s = S_UNDEF;
     return s;
 }
 
+/*****************************************************************************/
+Status AudioFormatInfoGet(ConstStrP name_str_p, U8* data_p, const Size size, AudioFormatInfo* info_p)
+{
+const AudioFormat format = AudioFormatByNameGet(name_str_p);
+Status s = S_AUDIO_CODEC_FORMAT_UNSUPPORTED;
+    if ((OS_NULL == data_p) || (OS_NULL == info_p)) { return s = S_INVALID_PTR; }
+    //Probe the codec by the name extension first, then the rest of them (no extension in a stream URL).
+    for (Size i = 0; i < AUDIO_CODEC_LAST; ++i) {
+        const AudioFormat probe = (AUDIO_FORMAT_UNDEF != format) ? format : (AudioFormat)i;
+        const AudioCodecHd codec_hd = audio_codecs_v[probe];
+        if (OS_NULL == codec_hd) {
+            //Not inited yet or disabled: the next one is probed.
+            if (AUDIO_FORMAT_UNDEF == format) { continue; }
+            s = S_INVALID_STATE;
+            break;
+        }
+        //No codec open: the probe never competes with a playing or converting instance.
+        IF_STATUS(s = AudioCodecIsFormat(codec_hd, data_p, size, info_p)) {
+            if (S_AUDIO_CODEC_FORMAT_MISMATCH == s) {
+                //May not enough buffer memory to find out the header format.
+            } else if (S_INVALID_SIZE == s) {
+            } else {
+            }
+            OS_LOG_S(D_WARNING, s);
+        }
+        if ((S_OK == s) || (AUDIO_FORMAT_UNDEF != format)) { break; }
+    }
+    return s;
+}
+
+/*****************************************************************************/
+AudioFormat AudioFormatByNameGet(ConstStrP name_str_p)
+{
+ConstStrP ext_p = OS_StrRChr(name_str_p, '.');
+    if ((OS_NULL == ext_p) || (OS_NULL != OS_StrChr(ext_p, '/'))) { return AUDIO_FORMAT_UNDEF; }
+    ++ext_p;
+    if (!OS_StrCmp(ext_p, "wav")) {
+        return AUDIO_FORMAT_WAV;
+    } else if (!OS_StrCmp(ext_p, "mp3")) {
+        return AUDIO_FORMAT_MP3;
+    }
+    return AUDIO_FORMAT_UNDEF;
+}
+
 /*****************************************************************************/
 Status AudioCodecInit(const AudioCodecHd codec_hd, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec init");
+    DLOG(D_DEBUG, "Audio codec init");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->Init);
     return ((AudioCodecItf*)codec_hd)->Init(args_p);
@@ -120,7 +159,7 @@ Status AudioCodecInit(const AudioCodecHd codec_hd, void* args_p)
 /*****************************************************************************/
 Status AudioCodecDeInit(const AudioCodecHd codec_hd, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec deinit");
+    DLOG(D_DEBUG, "Audio codec deinit");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->DeInit);
     return ((AudioCodecItf*)codec_hd)->DeInit(args_p);
@@ -129,7 +168,7 @@ Status AudioCodecDeInit(const AudioCodecHd codec_hd, void* args_p)
 /*****************************************************************************/
 Status AudioCodecOpen(const AudioCodecHd codec_hd, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec open");
+    DLOG(D_DEBUG, "Audio codec open");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->Open);
     return ((AudioCodecItf*)codec_hd)->Open(args_p);
@@ -138,7 +177,7 @@ Status AudioCodecOpen(const AudioCodecHd codec_hd, void* args_p)
 /*****************************************************************************/
 Status AudioCodecClose(const AudioCodecHd codec_hd, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec close");
+    DLOG(D_DEBUG, "Audio codec close");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->Close);
     return ((AudioCodecItf*)codec_hd)->Close(args_p);
@@ -147,7 +186,7 @@ Status AudioCodecClose(const AudioCodecHd codec_hd, void* args_p)
 /*****************************************************************************/
 Status AudioCodecEncode(const AudioCodecHd codec_hd, U8* data_in_p, Size size, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec encode");
+    DLOG(D_DEBUG, "Audio codec encode");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->Encode);
     return ((AudioCodecItf*)codec_hd)->Encode(data_in_p, size, args_p);
@@ -157,7 +196,7 @@ Status AudioCodecEncode(const AudioCodecHd codec_hd, U8* data_in_p, Size size, v
 Status AudioCodecDecode(const AudioCodecHd codec_hd, U8* data_in_p, Size size_in,
                         U8* data_out_p, Size size_out, AudioFrameInfo* frame_info_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec decode");
+    DLOG(D_DEBUG, "Audio codec decode");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->Decode);
     return ((AudioCodecItf*)codec_hd)->Decode(data_in_p, size_in, data_out_p, size_out, frame_info_p);
@@ -166,7 +205,7 @@ Status AudioCodecDecode(const AudioCodecHd codec_hd, U8* data_in_p, Size size_in
 /*****************************************************************************/
 Status AudioCodecIsFormat(const AudioCodecHd codec_hd, U8* data_in_p, Size size, AudioFormatInfo* info_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec is format");
+    DLOG(D_DEBUG, "Audio codec is format");
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->IsFormat);
     return ((AudioCodecItf*)codec_hd)->IsFormat(data_in_p, size, info_p);
@@ -175,7 +214,7 @@ Status AudioCodecIsFormat(const AudioCodecHd codec_hd, U8* data_in_p, Size size,
 /*****************************************************************************/
 Status AudioCodecIoCtl(const AudioCodecHd codec_hd, const U32 request_id, void* args_p)
 {
-    OS_LOG(D_DEBUG, "Audio codec ioctl req: %u", request_id);
+    DLOG1(D_DEBUG, "Audio codec ioctl req: %u", request_id);
     OS_ASSERT_VALUE(codec_hd);
     OS_ASSERT_VALUE(((AudioCodecItf*)codec_hd)->IoCtl);
     return ((AudioCodecItf*)codec_hd)->IoCtl(request_id, args_p);
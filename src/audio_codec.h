@@ -21,6 +21,7 @@ enum {
     S_AUDIO_CODEC_DECODE_ERROR,
     S_AUDIO_CODEC_NO_FRAME,
     S_AUDIO_CODEC_OUTPUT_BUFFER_FULL,
+    S_AUDIO_CODEC_BUSY,                 // All the codec instances are open.
     S_AUDIO_CODEC_LAST
 };
 
@@ -50,13 +51,17 @@ typedef struct {
     void*           audio_info_ext[0];
 } AudioFormatInfo;
 
+// Stream decode state; it is the Open()/Close() args too (multi instance codecs).
 typedef struct {
     Size            buf_in_offset;
     Size            buf_out_size;
+    void*           codec_inst_p;       // Set by the open.
+    Bool            is_background;      // Not the playback (the open hint).
 //    OS_AudioInfo    audio_info;
 } AudioFrameInfo;
 
 //------------------------------------------------------------------------------
+// IsFormat() is a header parse only: it needs no open codec instance.
 typedef struct {
     Status  (*Init)(void* args_p);
     Status  (*DeInit)(void* args_p);
@@ -99,6 +104,19 @@ Status          AudioCodecIoCtl(const AudioCodecHd codec_hd, const U32 request_i
 AudioCodecHd    AudioCodecGet(const AudioFormat format);
 Status          AudioFileFormatInfoGet(ConstStrP file_path_str_p, AudioFormatInfo* info_p);
 
+/// @brief      Get audio format info of the data.
+/// @param[in]  name_str_p     File path or stream URL (format hint by the extension).
+/// @param[in]  data_p         Data (stream start).
+/// @param[in]  size           Data size.
+/// @param[out] info_p         Format info.
+/// @return     #Status.
+Status          AudioFormatInfoGet(ConstStrP name_str_p, U8* data_p, const Size size, AudioFormatInfo* info_p);
+
+/// @brief      Get audio format by the name extension.
+/// @param[in]  name_str_p     File path or stream URL.
+/// @return     Audio format.
+AudioFormat     AudioFormatByNameGet(ConstStrP name_str_p);
+
 #endif // _AUDIO_CODEC_H_
 
 #endif //(OS_AUDIO_ENABLED)
\ No newline at end of file
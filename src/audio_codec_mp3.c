@@ -6,8 +6,11 @@
 #include "os_common.h"
 #include "os_debug.h"
 #include "os_file_system.h"
+#include "os_memory.h"
+#include "app_common.h"
 #include "audio_codec_mp3.h"
 #include "mp3dec.h"
+#include "coder.h"
 
 #if (OS_AUDIO_ENABLED)
 //-----------------------------------------------------------------------------
@@ -24,12 +27,31 @@ const StatusItem status_codec_mp3_v[] = {
     {"Encode error"},
     {"Decode error"},
     {"No frame found"},
-    {"Output buffer full"}
+    {"Output buffer full"},
+    {"Codec busy"}
 //audio codec custom
 };
 
+#define STATE_ALIGN(s)          ((((s) + 7) / 8) * 8)
+#define FRAME_HDR_SIZE          4
+
 //------------------------------------------------------------------------------
-typedef MP3FrameInfo AudioFormatHeaderMp3;
+typedef enum {
+    MPEG_VERSION_1,
+    MPEG_VERSION_2,
+    MPEG_VERSION_2_5,
+    MPEG_VERSION_LAST
+} MpegVersion;
+
+typedef struct {
+    Size            size;
+    Bool            is_hot;
+} StateItemConfig;
+
+typedef struct {
+    OS_MemoryType   memory_hot;
+    OS_MemoryType   memory_cold;
+} InstanceConfig;
 
 //------------------------------------------------------------------------------
 static Status Init(void* args_p);
@@ -39,10 +61,56 @@ static Status Close(void* args_p);
 static Status Decode(U8* data_in_p, Size size_in, U8* data_out_p, Size size_out, AudioFrameInfo* frame_info_p);
 static Status IsFormat(U8* data_in_p, Size size, AudioFormatInfo* info_p);
 static Status IoCtl(const U32 request_id, void* args_p);
+static Status FrameHeaderParse(const U8* data_p, OS_AudioInfo* audio_info_p, Size* frame_size_p);
 
 //------------------------------------------------------------------------------
 static ConstStrP file_extensions_str = "mp3";
-static HMP3Decoder* mp3_decoder_hd;
+
+// Layer III frame header tables (the decoder supports Layer III only).
+static const U16 samprates_v[MPEG_VERSION_LAST][3] = {
+    { 44100, 48000, 32000 },
+    { 22050, 24000, 16000 },
+    { 11025, 12000,  8000 },
+};
+// kbps; MPEG-2.5 uses the MPEG-2 rates.
+static const U16 bitrates_v[2][15] = {
+    { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+    { 0,  8, 16, 24, 32, 40, 48, 56,  64,  80,  96, 112, 128, 144, 160 },
+};
+
+// Decoder state items in the Helix allocation order. Hot ones are touched
+// in the per-granule inner loops (bit reservoir, Huffman, dequantizer,
+// IMDCT and polyphase buffers) and are placed in CCM, cold ones are
+// accessed once per frame. Helix constant tables are left in flash.
+static const StateItemConfig state_items_cfg_v[] = {
+    { sizeof(MP3DecInfo),       OS_TRUE     },
+    { sizeof(FrameHeader),      OS_FALSE    },
+    { sizeof(SideInfo),         OS_FALSE    },
+    { sizeof(ScaleFactorInfo),  OS_FALSE    },
+    { sizeof(HuffmanInfo),      OS_TRUE     },
+    { sizeof(DequantInfo),      OS_TRUE     },
+    { sizeof(IMDCTInfo),        OS_TRUE     },
+    { sizeof(SubbandInfo),      OS_TRUE     },
+};
+#define STATE_ITEMS_COUNT       ITEMS_COUNT_GET(state_items_cfg_v, StateItemConfig)
+
+typedef struct {
+    MP3DecInfo*     decoder_p;
+    Bool            is_open;
+    U8*             arena_hot_p;
+    U8*             arena_cold_p;
+    U8*             items_v[STATE_ITEMS_COUNT];
+} Instance;
+
+// The playback instance keeps the hot state in CCM. The background one is in
+// the slow memory, so a conversion job never holds the playback decoder.
+static const InstanceConfig instances_cfg_v[CODEC_MP3_INSTANCE_LAST] = {
+    [CODEC_MP3_INSTANCE_PLAY]   = { CODEC_MP3_MEMORY_HOT,   CODEC_MP3_MEMORY_COLD   },
+    [CODEC_MP3_INSTANCE_BG]     = { CODEC_MP3_MEMORY_BG,    CODEC_MP3_MEMORY_BG     },
+};
+
+static Instance instances_v[CODEC_MP3_INSTANCE_LAST];
+static AudioCodecMp3Footprint footprint;
 
 const AudioCodecItf audio_codec_mp3 = {
     .Init           = Init,
@@ -58,7 +126,43 @@ const AudioCodecItf audio_codec_mp3 = {
 /*****************************************************************************/
 Status Init(void* args_p)
 {
+Size offset_hot = 0;
+Size offset_cold = 0;
 Status s = S_UNDEF;
+    if (OS_NULL != instances_v[0].arena_hot_p) { return S_INITED; }
+    for (Size i = 0; i < STATE_ITEMS_COUNT; ++i) {
+        if (state_items_cfg_v[i].is_hot) {
+            offset_hot  += STATE_ALIGN(state_items_cfg_v[i].size);
+        } else {
+            offset_cold += STATE_ALIGN(state_items_cfg_v[i].size);
+        }
+    }
+    footprint.ram_hot  = offset_hot;
+    footprint.ram_cold = offset_cold;
+    //Decoder state arenas are allocated once and are never returned to the heaps.
+    for (Size inst = 0; inst < CODEC_MP3_INSTANCE_LAST; ++inst) {
+        Instance* inst_p = &instances_v[inst];
+        inst_p->arena_hot_p  = OS_MallocEx(footprint.ram_hot,  instances_cfg_v[inst].memory_hot);
+        inst_p->arena_cold_p = OS_MallocEx(footprint.ram_cold, instances_cfg_v[inst].memory_cold);
+        if ((OS_NULL == inst_p->arena_hot_p) || (OS_NULL == inst_p->arena_cold_p)) {
+            DeInit(OS_NULL);
+            return s = S_OUT_OF_MEMORY;
+        }
+        offset_hot = offset_cold = 0;
+        for (Size i = 0; i < STATE_ITEMS_COUNT; ++i) {
+            if (state_items_cfg_v[i].is_hot) {
+                inst_p->items_v[i] = inst_p->arena_hot_p + offset_hot;
+                offset_hot  += STATE_ALIGN(state_items_cfg_v[i].size);
+            } else {
+                inst_p->items_v[i] = inst_p->arena_cold_p + offset_cold;
+                offset_cold += STATE_ALIGN(state_items_cfg_v[i].size);
+            }
+        }
+        inst_p->decoder_p = OS_NULL;
+        inst_p->is_open   = OS_FALSE;
+    }
+    OS_LOG(D_INFO, "Decoder RAM per instance: hot %u, cold %u (%u instances)",
+                   (U32)footprint.ram_hot, (U32)footprint.ram_cold, (U32)CODEC_MP3_INSTANCE_LAST);
     s = S_OK;
     return s;
 }
@@ -67,6 +171,15 @@ Status s = S_UNDEF;
 Status DeInit(void* args_p)
 {
 Status s = S_UNDEF;
+    for (Size inst = 0; inst < CODEC_MP3_INSTANCE_LAST; ++inst) {
+        if (OS_TRUE == instances_v[inst].is_open) { return s = S_INVALID_STATE; }
+    }
+    for (Size inst = 0; inst < CODEC_MP3_INSTANCE_LAST; ++inst) {
+        Instance* inst_p = &instances_v[inst];
+        OS_FreeEx(inst_p->arena_hot_p,  instances_cfg_v[inst].memory_hot);
+        OS_FreeEx(inst_p->arena_cold_p, instances_cfg_v[inst].memory_cold);
+        inst_p->arena_hot_p = inst_p->arena_cold_p = OS_NULL;
+    }
     s = S_OK;
     return s;
 }
@@ -74,35 +187,70 @@ Status s = S_UNDEF;
 /*****************************************************************************/
 Status Open(void* args_p)
 {
+AudioFrameInfo* frame_info_p = (AudioFrameInfo*)args_p;
+Instance* inst_p;
+MP3DecInfo* decoder_p;
+U32 primask;
 Status s = S_UNDEF;
-    mp3_decoder_hd = MP3InitDecoder(); //Currently supports only one instance!
-    if (OS_NULL != mp3_decoder_hd) {
+    if (OS_NULL == frame_info_p) { return s = S_INVALID_PTR; }
+    inst_p = &instances_v[(OS_TRUE == frame_info_p->is_background) ? CODEC_MP3_INSTANCE_BG : CODEC_MP3_INSTANCE_PLAY];
+    if (OS_NULL == inst_p->arena_hot_p) { return s = S_INVALID_STATE; }
+    //The player and BgServ tasks open their instances concurrently.
+    APP_CRITICAL_SECTION_ENTER(primask);
+    if (OS_TRUE == inst_p->is_open) {
+        s = S_AUDIO_CODEC_BUSY;
+    } else {
+        inst_p->is_open = OS_TRUE;
         s = S_OK;
-    } else { s = S_INVALID_PTR; }
+    }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    IF_STATUS(s) { return s; }
+    //Same state layout as the decoder library allocates (MP3InitDecoder()), but from the instance arenas.
+    for (Size i = 0; i < STATE_ITEMS_COUNT; ++i) {
+        OS_MemSet(inst_p->items_v[i], 0, state_items_cfg_v[i].size);
+    }
+    decoder_p = (MP3DecInfo*)inst_p->items_v[0];
+    decoder_p->FrameHeaderPS     = inst_p->items_v[1];
+    decoder_p->SideInfoPS        = inst_p->items_v[2];
+    decoder_p->ScaleFactorInfoPS = inst_p->items_v[3];
+    decoder_p->HuffmanInfoPS     = inst_p->items_v[4];
+    decoder_p->DequantInfoPS     = inst_p->items_v[5];
+    decoder_p->IMDCTInfoPS       = inst_p->items_v[6];
+    decoder_p->SubbandInfoPS     = inst_p->items_v[7];
+    inst_p->decoder_p = decoder_p;
+    frame_info_p->codec_inst_p = inst_p;
     return s;
 }
 
 /*****************************************************************************/
 Status Close(void* args_p)
 {
+AudioFrameInfo* frame_info_p = (AudioFrameInfo*)args_p;
+Instance* inst_p;
 Status s = S_UNDEF;
-    if (OS_NULL != mp3_decoder_hd) {
-        MP3FreeDecoder(mp3_decoder_hd);
-        mp3_decoder_hd = OS_NULL;
-        s = S_OK;
-    } else { s = S_INVALID_PTR; }
+    if ((OS_NULL == frame_info_p) || (OS_NULL == frame_info_p->codec_inst_p)) { return s = S_INVALID_PTR; }
+    inst_p = (Instance*)frame_info_p->codec_inst_p;
+    inst_p->decoder_p = OS_NULL;
+    frame_info_p->codec_inst_p = OS_NULL;
+    APP_MEMORY_BARRIER();
+    inst_p->is_open = OS_FALSE;
+    s = S_OK;
     return s;
 }
 
 /*****************************************************************************/
 Status Decode(U8* data_in_p, Size size_in, U8* data_out_p, Size size_out, AudioFrameInfo* frame_info_p)
 {
+const Instance* inst_p = (const Instance*)frame_info_p->codec_inst_p;
+HMP3Decoder mp3_decoder_hd;
 U8* data_in_tmp_p = data_in_p;
 U8* data_out_tmp_p= data_out_p;
 Int offset = MP3FindSyncWord(data_in_p, size_in);
 MP3FrameInfo frame_info;
 Status s = S_OK;
 
+    if ((OS_NULL == inst_p) || (OS_NULL == inst_p->decoder_p)) { return s = S_INVALID_PTR; }
+    mp3_decoder_hd = (HMP3Decoder)inst_p->decoder_p;
     while ((0 <= offset) && (0 < size_in)) {
         data_in_p += offset;
         size_in   -= offset;
@@ -154,34 +302,65 @@ Status s = S_OK;
 /*****************************************************************************/
 Status IsFormat(U8* data_in_p, Size size, AudioFormatInfo* info_p)
 {
+const Size header_size = size;
 Int offset = MP3FindSyncWord(data_in_p, size);
-Size header_size = size;
+OS_AudioInfo audio_info;
+OS_AudioInfo next_audio_info;
+Size frame_size;
+Size next_frame_size;
 
+    //Header parse only: no decoder instance (the open ones may be busy).
     while (0 <= offset) {
-        AudioFormatHeaderMp3 mp3_hdr;
         data_in_p += offset;
         size      -= offset;
-        if (ERR_MP3_NONE == MP3GetNextFrameInfo(mp3_decoder_hd, &mp3_hdr, data_in_p)) {
-            if (OS_NULL != info_p) {
-                info_p->format                  = AUDIO_FORMAT_MP3;
-                info_p->header_size             = header_size - size;
-                info_p->audio_info.sample_rate  = mp3_hdr.samprate;
-                info_p->audio_info.sample_bits  = mp3_hdr.bitsPerSample;
-                info_p->audio_info.channels     = (1 == mp3_hdr.nChans) ? OS_AUDIO_CHANNELS_MONO :
-                                                      (2 == mp3_hdr.nChans) ? OS_AUDIO_CHANNELS_STEREO :
-                                                          OS_AUDIO_CHANNELS_UNDEF;
+        if ((FRAME_HDR_SIZE <= size) && (S_OK == FrameHeaderParse(data_in_p, &audio_info, &frame_size))) {
+            //A sync word alone may be a data pattern: the next frame header has to agree (if it is in the data).
+            if ((0 == frame_size) || (size < (frame_size + FRAME_HDR_SIZE)) ||
+                ((S_OK == FrameHeaderParse(data_in_p + frame_size, &next_audio_info, &next_frame_size)) &&
+                 (next_audio_info.sample_rate == audio_info.sample_rate))) {
+                if (OS_NULL != info_p) {
+                    info_p->format      = AUDIO_FORMAT_MP3;
+                    info_p->header_size = header_size - size;
+                    info_p->audio_info  = audio_info;
+                }
                 return S_OK;
             }
-        } else {
-            //Try to find next valid frame.
-            ++data_in_p;
-            --size;
         }
+        //Try to find next valid frame.
+        ++data_in_p;
+        --size;
         offset = MP3FindSyncWord(data_in_p, size);
     }
     return S_AUDIO_CODEC_FORMAT_MISMATCH;
 }
 
+/*****************************************************************************/
+Status FrameHeaderParse(const U8* data_p, OS_AudioInfo* audio_info_p, Size* frame_size_p)
+{
+const U8 version_id     = (data_p[1] >> 3) & 0x03; // 3: MPEG-1, 2: MPEG-2, 0: MPEG-2.5
+const U8 layer_id       = (data_p[1] >> 1) & 0x03; // 1: Layer III
+const U8 bitrate_idx    = (data_p[2] >> 4) & 0x0F;
+const U8 samprate_idx   = (data_p[2] >> 2) & 0x03;
+const U8 padding        = (data_p[2] >> 1) & 0x01;
+const U8 mode           = (data_p[3] >> 6) & 0x03; // 3: mono
+MpegVersion version;
+U32 bitrate;
+
+    if ((0xFF != data_p[0]) || (0xE0 != (data_p[1] & 0xE0))) { return S_AUDIO_CODEC_FORMAT_MISMATCH; }
+    if ((1 == version_id) || (1 != layer_id) || (0x0F == bitrate_idx) || (3 == samprate_idx)) {
+        return S_AUDIO_CODEC_FORMAT_MISMATCH;
+    }
+    version = (3 == version_id) ? MPEG_VERSION_1 : (2 == version_id) ? MPEG_VERSION_2 : MPEG_VERSION_2_5;
+    audio_info_p->sample_rate   = samprates_v[version][samprate_idx];
+    audio_info_p->sample_bits   = 16;
+    audio_info_p->channels      = (3 == mode) ? OS_AUDIO_CHANNELS_MONO : OS_AUDIO_CHANNELS_STEREO;
+    //Free format (index 0): the frame size is unknown.
+    bitrate = bitrates_v[(MPEG_VERSION_1 == version) ? 0 : 1][bitrate_idx] * 1000;
+    *frame_size_p = (0 == bitrate) ? 0 :
+                    ((((MPEG_VERSION_1 == version) ? 144 : 72) * bitrate) / audio_info_p->sample_rate) + padding;
+    return S_OK;
+}
+
 /*****************************************************************************/
 Status IoCtl(const U32 request_id, void* args_p)
 {
@@ -192,6 +371,12 @@ Status s = S_UNDEF;
         case AUDIO_CODEC_REQ_MP3_TAG_ID3V2_GET:
             s = S_OK;
             break;
+        case AUDIO_CODEC_REQ_MP3_FOOTPRINT_GET:
+            if (OS_NULL != args_p) {
+                *(AudioCodecMp3Footprint*)args_p = footprint;
+                s = S_OK;
+            } else { s = S_INVALID_PTR; }
+            break;
         default:
             s = S_INVALID_REQ_ID;
             break;
@@ -199,4 +384,17 @@ Status s = S_UNDEF;
     return s;
 }
 
+/*****************************************************************************/
+void* AudioCodecMp3StateAlloc(const Size size)
+{
+    //Decoder state items come from the instance arenas (Open()).
+    OS_LOG_S(D_WARNING, S_OUT_OF_MEMORY);
+    return OS_NULL;
+}
+
+/*****************************************************************************/
+void AudioCodecMp3StateFree(void* p)
+{
+}
+
 #endif //(OS_AUDIO_ENABLED)
\ No newline at end of file
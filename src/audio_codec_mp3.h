@@ -10,11 +10,16 @@
 
 #if (OS_AUDIO_ENABLED)
 //------------------------------------------------------------------------------
+// Decoder state arena memories (allocated once at the codec init).
+#define CODEC_MP3_MEMORY_HOT    OS_MEM_RAM_INT_CCM
+#define CODEC_MP3_MEMORY_COLD   OS_MEM_HEAP_APP
+// Background instance (both the hot and the cold state).
+#define CODEC_MP3_MEMORY_BG     OS_MEM_RAM_EXT_SRAM
+
 #undef malloc
 #undef free
-#define CODEC_MP3_MEMORY    OS_MEM_RAM_INT_CCM
-#define malloc(s)           OS_MallocEx(s, CODEC_MP3_MEMORY)
-#define free(p)             OS_FreeEx(p, CODEC_MP3_MEMORY)
+#define malloc(s)           AudioCodecMp3StateAlloc(s)
+#define free(p)             AudioCodecMp3StateFree(p)
 
 enum {
     S_AUDIO_CODEC_MP3_UNDEF = S_AUDIO_CODEC_LAST,
@@ -25,12 +30,34 @@ enum {
 enum {
     AUDIO_CODEC_REQ_MP3_UNDEF = AUDIO_CODEC_REQ_STD_LAST,
     AUDIO_CODEC_REQ_MP3_TAG_ID3V2_GET,
+    AUDIO_CODEC_REQ_MP3_FOOTPRINT_GET,
     AUDIO_CODEC_REQ_MP3_LAST
 };
 
+// Decoder instances (AudioFrameInfo.is_background selects on the open).
+typedef enum {
+    CODEC_MP3_INSTANCE_PLAY,
+    CODEC_MP3_INSTANCE_BG,
+    CODEC_MP3_INSTANCE_LAST
+} AudioCodecMp3Instance;
+
+typedef struct {
+    Size            ram_hot;    // Per instance, CODEC_MP3_MEMORY_HOT (CODEC_MP3_MEMORY_BG for the background one).
+    Size            ram_cold;   // Per instance, CODEC_MP3_MEMORY_COLD (CODEC_MP3_MEMORY_BG for the background one).
+} AudioCodecMp3Footprint;
+
 //------------------------------------------------------------------------------
 extern const AudioCodecItf audio_codec_mp3;
 
+/// @brief      Decoder library allocator hook.
+/// @param[in]  size           Decoder state item size.
+/// @return     OS_NULL (the state is wired to the instance arenas on the open).
+void*           AudioCodecMp3StateAlloc(const Size size);
+
+/// @brief      Decoder library deallocator hook.
+/// @param[in]  p              Item pointer.
+void            AudioCodecMp3StateFree(void* p);
+
 #endif //(OS_AUDIO_ENABLED)
 
-#endif // _AUDIO_CODEC_MP3_H_
\ No newline at end of file
+#endif // _AUDIO_CODEC_MP3_H_
@@ -23,7 +23,8 @@ const StatusItem status_codec_wav_v[] = {
     {"Encode error"},
     {"Decode error"},
     {"No frame found"},
-    {"Output buffer full"}
+    {"Output buffer full"},
+    {"Codec busy"}
 //audio codec custom
 };
 
@@ -0,0 +1,370 @@
+/***************************************************************************//**
+* @file    audio_eq.c
+* @brief   Player parametric EQ.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <math.h>
+#include "os_memory.h"
+#include "app_common.h"
+#include "prof.h"
+#include "audio_eq.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "audio_eq"
+
+#define CHANNELS_MAX            2
+#define COEFF_ONE               (1L << (31 - AUDIO_EQ_POST_SHIFT))
+#define PRESET_COUNT            ITEMS_COUNT_GET(preset_v, AudioEqBand)
+#define FREQ_MIN                20
+#define Q_MIN                   10
+#define Q_MAX                   2000
+#define PI                      3.14159265f
+#define Q31_MAX                 0x7FFFFFFF
+#define Q31_MIN                 (-Q31_MAX - 1)
+#define PCM16_MAX               0x7FFF
+
+//-----------------------------------------------------------------------------
+//a1, a2 are negated: the accumulator is the sum of all the products.
+typedef struct {
+    S32             b0;
+    S32             b1;
+    S32             b2;
+    S32             a1;
+    S32             a2;
+} BiquadCoeffs;
+
+typedef struct {
+    S32             x1;
+    S32             x2;
+    S32             y1;
+    S32             y2;
+} BiquadState;
+
+//-----------------------------------------------------------------------------
+static Status   BandCheck(const AudioEqBand* band_p);
+static void     CoeffsPublish(void);
+static void     CoeffsCalc(const AudioEqBand* band_p, const U32 sample_rate, BiquadCoeffs* coeffs_p);
+static S32      CoeffToQ31(const Float coeff);
+static void     BiquadRun(const BiquadCoeffs* coeffs_p, BiquadState* state_p, S32* data_p, Size frames, const Size stride);
+
+//-----------------------------------------------------------------------------
+static const AudioEqBand preset_v[] = APP_AUDIO_EQ_PRESET;
+//Any context (under the critical section).
+static AudioEqBand bands_v[APP_AUDIO_EQ_BANDS_MAX];
+static BiquadCoeffs coeffs_next_v[APP_AUDIO_EQ_BANDS_MAX];
+static Size bands_next;
+static Bool is_update;
+static U32 sample_rate;
+static U32 coeffs_gen;                  // Bands snapshot generation.
+//Player context.
+static BiquadCoeffs coeffs_v[APP_AUDIO_EQ_BANDS_MAX];
+static Size bands_count;
+static BiquadState* states_p;           // [band][channel]
+static S32* work_p;
+static OS_AudioInfo audio_info;
+static Bool is_format;
+static AudioEqStats audio_eq_stats;
+
+/*****************************************************************************/
+Status AudioEqInit(void)
+{
+    OS_ASSERT_VALUE(PRESET_COUNT <= APP_AUDIO_EQ_BANDS_MAX);
+    //Per sample touched: the fast core coupled memory.
+    states_p = OS_MallocEx(sizeof(BiquadState) * APP_AUDIO_EQ_BANDS_MAX * CHANNELS_MAX, APP_AUDIO_EQ_MEMORY);
+    work_p   = OS_MallocEx(sizeof(S32) * APP_AUDIO_EQ_BLOCK_FRAMES * CHANNELS_MAX, APP_AUDIO_EQ_MEMORY);
+    if ((OS_NULL == states_p) || (OS_NULL == work_p)) {
+        OS_FreeEx(states_p, APP_AUDIO_EQ_MEMORY);
+        OS_FreeEx(work_p,   APP_AUDIO_EQ_MEMORY);
+        states_p = OS_NULL;
+        work_p   = OS_NULL;
+        return S_OUT_OF_MEMORY;
+    }
+    return AudioEqPresetSet((APP_AUDIO_EQ_PRESET_ENABLED) ? OS_TRUE : OS_FALSE);
+}
+
+/*****************************************************************************/
+Status AudioEqFormatSet(const OS_AudioInfo* info_p)
+{
+U32 primask;
+
+    is_format = OS_FALSE;
+    if (OS_NULL == info_p) { return S_OK; }
+    if ((0 == info_p->channels) || (CHANNELS_MAX < info_p->channels)) { return S_INVALID_VALUE; }
+    if ((16 != info_p->sample_bits) && (24 != info_p->sample_bits) && (32 != info_p->sample_bits)) {
+        return S_INVALID_VALUE;
+    }
+    if (OS_NULL == states_p) { return S_INVALID_STATE; }
+    audio_info  = *info_p;
+    //New stream: no history.
+    OS_MemSet(states_p, 0, sizeof(BiquadState) * APP_AUDIO_EQ_BANDS_MAX * CHANNELS_MAX);
+    APP_CRITICAL_SECTION_ENTER(primask);
+    sample_rate = info_p->sample_rate;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    CoeffsPublish();
+    is_format = OS_TRUE;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioEqBandSet(const Size idx, const AudioEqBand* band_p)
+{
+U32 primask;
+Status s = S_UNDEF;
+
+    if (OS_NULL == band_p) { return S_INVALID_PTR; }
+    if (APP_AUDIO_EQ_BANDS_MAX <= idx) { return S_INVALID_VALUE; }
+    IF_STATUS(s = BandCheck(band_p)) { return s; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    bands_v[idx] = *band_p;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    CoeffsPublish();
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioEqBandGet(const Size idx, AudioEqBand* band_p)
+{
+U32 primask;
+
+    if (OS_NULL == band_p) { return S_INVALID_PTR; }
+    if (APP_AUDIO_EQ_BANDS_MAX <= idx) { return S_INVALID_VALUE; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    *band_p = bands_v[idx];
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioEqPresetSet(const Bool is_on)
+{
+const AudioEqBand band_off = { AUDIO_EQ_BAND_OFF, 0, 0, 0 };
+U32 primask;
+Status s = S_OK;
+
+    if (OS_TRUE == is_on) {
+        for (Size i = 0; i < PRESET_COUNT; ++i) {
+            IF_STATUS(s = BandCheck(&preset_v[i])) { return s; }
+        }
+    }
+    //All the bands at once: a single retune.
+    APP_CRITICAL_SECTION_ENTER(primask);
+    for (Size i = 0; i < APP_AUDIO_EQ_BANDS_MAX; ++i) {
+        bands_v[i] = ((OS_TRUE == is_on) && (PRESET_COUNT > i)) ? preset_v[i] : band_off;
+    }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    CoeffsPublish();
+    return s;
+}
+
+/*****************************************************************************/
+void AudioEqApply(U8* data_p, const Size size)
+{
+const U32 cycles_start = APP_CYCLES_GET();
+const Size channels = audio_info.channels;
+Size frames;
+U32 primask;
+
+    //Block start: the retuned coefficients are taken at once.
+    if (OS_TRUE == is_update) {
+        APP_CRITICAL_SECTION_ENTER(primask);
+        OS_MemCpy(coeffs_v, coeffs_next_v, sizeof(coeffs_v));
+        bands_count = bands_next;
+        is_update   = OS_FALSE;
+        APP_CRITICAL_SECTION_EXIT(primask);
+    }
+    if ((OS_TRUE != is_format) || (0 == bands_count)) { return; }
+PROF_ENTER(PROF_REGION_EQ_APPLY);
+    if (16 == audio_info.sample_bits) {
+        S16* data_16p = (S16*)data_p;
+        frames = size / (channels * sizeof(S16));
+        while (0 != frames) {
+            const Size len = (APP_AUDIO_EQ_BLOCK_FRAMES < frames) ? APP_AUDIO_EQ_BLOCK_FRAMES : frames;
+            const Size samples = len * channels;
+            for (Size i = 0; i < samples; ++i) {
+                work_p[i] = (S32)data_16p[i] << 16;
+            }
+            for (Size band = 0; band < bands_count; ++band) {
+                for (Size ch = 0; ch < channels; ++ch) {
+                    BiquadRun(&coeffs_v[band], &states_p[(band * CHANNELS_MAX) + ch], work_p + ch, len, channels);
+                }
+            }
+            for (Size i = 0; i < samples; ++i) {
+                //Rounded; the saturated Q31 can't overflow it.
+                const S32 sample = (work_p[i] >> 16) + ((work_p[i] >> 15) & 1);
+                data_16p[i] = (S16)((PCM16_MAX < sample) ? PCM16_MAX : sample);
+            }
+            data_16p += samples;
+            frames   -= len;
+        }
+    } else {
+        //Filtered in place.
+        S32* data_32p = (S32*)data_p;
+        frames = size / (channels * sizeof(S32));
+        for (Size band = 0; band < bands_count; ++band) {
+            for (Size ch = 0; ch < channels; ++ch) {
+                BiquadRun(&coeffs_v[band], &states_p[(band * CHANNELS_MAX) + ch], data_32p + ch, frames, channels);
+            }
+        }
+    }
+PROF_EXIT(PROF_REGION_EQ_APPLY);
+    frames = size / (channels * ((16 == audio_info.sample_bits) ? sizeof(S16) : sizeof(S32)));
+    ++audio_eq_stats.blocks;
+    audio_eq_stats.samples      += frames * channels;
+    audio_eq_stats.band_samples += frames * channels * bands_count;
+    audio_eq_stats.cycles       += APP_CYCLES_GET() - cycles_start;
+    audio_eq_stats.samples_rate  = audio_info.sample_rate * channels;
+    audio_eq_stats.bands         = (U8)bands_count;
+}
+
+/*****************************************************************************/
+Status AudioEqStatsGet(AudioEqStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = audio_eq_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void AudioEqStatsReset(void)
+{
+    OS_MemSet(&audio_eq_stats, 0, sizeof(audio_eq_stats));
+}
+
+/*****************************************************************************/
+Status BandCheck(const AudioEqBand* band_p)
+{
+    if (AUDIO_EQ_BAND_OFF != band_p->type) {
+        if ((AUDIO_EQ_BAND_LAST <= band_p->type) || (FREQ_MIN > band_p->freq) ||
+            (Q_MIN > band_p->q_x100) || (Q_MAX < band_p->q_x100) ||
+            (AUDIO_EQ_GAIN_MAX < band_p->gain_x10) || (-AUDIO_EQ_GAIN_MAX > band_p->gain_x10)) {
+            return S_INVALID_VALUE;
+        }
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+void CoeffsPublish(void)
+{
+BiquadCoeffs coeffs_local_v[APP_AUDIO_EQ_BANDS_MAX];
+AudioEqBand bands_local_v[APP_AUDIO_EQ_BANDS_MAX];
+U32 sample_rate_local;
+U32 gen;
+Size bands = 0;
+U32 primask;
+
+    APP_CRITICAL_SECTION_ENTER(primask);
+    OS_MemCpy(bands_local_v, bands_v, sizeof(bands_local_v));
+    sample_rate_local = sample_rate;
+    gen = ++coeffs_gen;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    //Out of the critical section: the float math.
+    for (Size i = 0; i < APP_AUDIO_EQ_BANDS_MAX; ++i) {
+        CoeffsCalc(&bands_local_v[i], sample_rate_local, &coeffs_local_v[i]);
+        //Bands to the last active one (the off ones in between pass through).
+        if (AUDIO_EQ_BAND_OFF != bands_local_v[i].type) { bands = i + 1; }
+    }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    //Shell and player publish concurrently: a newer snapshot wins.
+    if (gen == coeffs_gen) {
+        OS_MemCpy(coeffs_next_v, coeffs_local_v, sizeof(coeffs_next_v));
+        bands_next = bands;
+        is_update  = OS_TRUE;
+    }
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
+
+/*****************************************************************************/
+void CoeffsCalc(const AudioEqBand* band_p, const U32 sample_rate, BiquadCoeffs* coeffs_p)
+{
+const Float a      = powf(10.0f, (Float)band_p->gain_x10 / 400.0f);
+const Float w0     = 2.0f * PI * (Float)band_p->freq / (Float)sample_rate;
+const Float cos_w0 = cosf(w0);
+const Float alpha  = sinf(w0) / (2.0f * ((Float)band_p->q_x100 / 100.0f));
+const Float sq     = 2.0f * sqrtf(a) * alpha;
+Float b0, b1, b2, a0, a1, a2;
+
+    //Pass through: off or not representable at the sample rate.
+    coeffs_p->b0 = COEFF_ONE;
+    coeffs_p->b1 = coeffs_p->b2 = coeffs_p->a1 = coeffs_p->a2 = 0;
+    if ((0 == sample_rate) || ((sample_rate / 2) <= band_p->freq)) { return; }
+    switch (band_p->type) {
+        case AUDIO_EQ_BAND_PEAK:
+            b0 = 1.0f + (alpha * a);
+            b1 = -2.0f * cos_w0;
+            b2 = 1.0f - (alpha * a);
+            a0 = 1.0f + (alpha / a);
+            a1 = -2.0f * cos_w0;
+            a2 = 1.0f - (alpha / a);
+            break;
+        case AUDIO_EQ_BAND_LOW_SHELF:
+            b0 = a * ((a + 1.0f) - ((a - 1.0f) * cos_w0) + sq);
+            b1 = 2.0f * a * ((a - 1.0f) - ((a + 1.0f) * cos_w0));
+            b2 = a * ((a + 1.0f) - ((a - 1.0f) * cos_w0) - sq);
+            a0 = (a + 1.0f) + ((a - 1.0f) * cos_w0) + sq;
+            a1 = -2.0f * ((a - 1.0f) + ((a + 1.0f) * cos_w0));
+            a2 = (a + 1.0f) + ((a - 1.0f) * cos_w0) - sq;
+            break;
+        case AUDIO_EQ_BAND_HIGH_SHELF:
+            b0 = a * ((a + 1.0f) + ((a - 1.0f) * cos_w0) + sq);
+            b1 = -2.0f * a * ((a - 1.0f) + ((a + 1.0f) * cos_w0));
+            b2 = a * ((a + 1.0f) + ((a - 1.0f) * cos_w0) - sq);
+            a0 = (a + 1.0f) - ((a - 1.0f) * cos_w0) + sq;
+            a1 = 2.0f * ((a - 1.0f) - ((a + 1.0f) * cos_w0));
+            a2 = (a + 1.0f) - ((a - 1.0f) * cos_w0) - sq;
+            break;
+        default:
+            return;
+    }
+    coeffs_p->b0 = CoeffToQ31(b0 / a0);
+    coeffs_p->b1 = CoeffToQ31(b1 / a0);
+    coeffs_p->b2 = CoeffToQ31(b2 / a0);
+    coeffs_p->a1 = CoeffToQ31(-a1 / a0);
+    coeffs_p->a2 = CoeffToQ31(-a2 / a0);
+}
+
+/*****************************************************************************/
+S32 CoeffToQ31(const Float coeff)
+{
+//Gains are limited by AUDIO_EQ_GAIN_MAX: the coefficients are in range.
+const Float q = coeff * (Float)COEFF_ONE;
+    if ((Float)Q31_MAX <= q) { return Q31_MAX; }
+    if ((Float)Q31_MIN >= q) { return Q31_MIN; }
+    return (S32)((0.0f <= q) ? (q + 0.5f) : (q - 0.5f));
+}
+
+/*****************************************************************************/
+void BiquadRun(const BiquadCoeffs* coeffs_p, BiquadState* state_p, S32* data_p, Size frames, const Size stride)
+{
+const S32 b0 = coeffs_p->b0;
+const S32 b1 = coeffs_p->b1;
+const S32 b2 = coeffs_p->b2;
+const S32 a1 = coeffs_p->a1;
+const S32 a2 = coeffs_p->a2;
+S32 x1 = state_p->x1;
+S32 x2 = state_p->x2;
+S32 y1 = state_p->y1;
+S32 y2 = state_p->y2;
+
+    while (frames--) {
+        const S32 x0 = *data_p;
+        //Multiply-accumulates to 64 bits (SMLAL).
+        S64 acc = ((S64)b0 * x0) + ((S64)b1 * x1) + ((S64)b2 * x2) + ((S64)a1 * y1) + ((S64)a2 * y2);
+        S32 y0;
+        acc >>= (31 - AUDIO_EQ_POST_SHIFT);
+        y0 = (Q31_MAX < acc) ? Q31_MAX : ((Q31_MIN > acc) ? Q31_MIN : (S32)acc);
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+        *data_p = y0;
+        data_p += stride;
+    }
+    state_p->x1 = x1;
+    state_p->x2 = x2;
+    state_p->y1 = y1;
+    state_p->y2 = y2;
+}
+
+#endif //(OS_AUDIO_ENABLED)
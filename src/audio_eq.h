@@ -0,0 +1,88 @@
+/***************************************************************************//**
+* @file    audio_eq.h
+* @brief   Player parametric EQ.
+* @author  A. Filyanov
+* @details Cascade of the Direct Form I biquads: Q31 coefficients (scaled
+*          down by 2^AUDIO_EQ_POST_SHIFT), 64-bit accumulators. Coefficients
+*          are computed from the band frequency, Q and gain (RBJ cookbook)
+*          and are taken by the player on a block start; DF1 state is the
+*          signal history, so the retuning keeps it. Cost is published as
+*          the cycles per sample (one channel) per band.
+*******************************************************************************/
+#ifndef _AUDIO_EQ_H_
+#define _AUDIO_EQ_H_
+
+#include "os_audio.h"
+#include "app_config.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define AUDIO_EQ_POST_SHIFT     2       // Coefficients range: [-4, 4).
+#define AUDIO_EQ_GAIN_MAX       120     // dB x10
+
+typedef enum {
+    AUDIO_EQ_BAND_OFF,
+    AUDIO_EQ_BAND_PEAK,
+    AUDIO_EQ_BAND_LOW_SHELF,
+    AUDIO_EQ_BAND_HIGH_SHELF,
+    AUDIO_EQ_BAND_LAST
+} AudioEqBandType;
+
+typedef struct {
+    U8              type;               // #AudioEqBandType
+    U16             freq;               // Hz
+    U16             q_x100;
+    S16             gain_x10;           // dB
+} AudioEqBand;
+
+typedef struct {
+    U32             blocks;
+    U64             samples;            // Channel samples.
+    U64             band_samples;       // Channel samples x bands.
+    U64             cycles;
+    U32             samples_rate;       // Channel samples per second.
+    U8              bands;              // Active ones.
+} AudioEqStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init EQ (allocate the state, apply the preset).
+/// @return     #Status.
+Status          AudioEqInit(void);
+
+/// @brief      Set the stream format and reset the filters (player context).
+/// @param[in]  info_p         Audio info; OS_NULL - stream end.
+/// @return     #Status.
+Status          AudioEqFormatSet(const OS_AudioInfo* info_p);
+
+/// @brief      Set the band (taken on the next block).
+/// @param[in]  idx            Band index.
+/// @param[in]  band_p         Band.
+/// @return     #Status.
+Status          AudioEqBandSet(const Size idx, const AudioEqBand* band_p);
+
+/// @brief      Get the band.
+/// @param[in]  idx            Band index.
+/// @param[out] band_p         Band.
+/// @return     #Status.
+Status          AudioEqBandGet(const Size idx, AudioEqBand* band_p);
+
+/// @brief      Apply the preset (APP_AUDIO_EQ_PRESET) or turn all bands off.
+/// @param[in]  is_on          Preset is applied.
+/// @return     #Status.
+Status          AudioEqPresetSet(const Bool is_on);
+
+/// @brief      Filter decoded PCM in place (player context).
+/// @param[in]  data_p         PCM.
+/// @param[in]  size           Size.
+void            AudioEqApply(U8* data_p, const Size size);
+
+/// @brief      Get EQ statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          AudioEqStatsGet(AudioEqStats* stats_p);
+
+/// @brief      Reset EQ statistics.
+void            AudioEqStatsReset(void);
+
+#endif //(OS_AUDIO_ENABLED)
+#endif // _AUDIO_EQ_H_
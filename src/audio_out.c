@@ -0,0 +1,349 @@
+/***************************************************************************//**
+* @file    audio_out.c
+* @brief   Player audio outputs.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_time.h"
+#include "os_timer.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "audio_out.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "audio_out"
+
+#define WAV_HEADER_SIZE     44
+//Buffer sample size: 24-bit samples are left-justified in S32 containers (as the EQ takes them).
+#define SAMPLE_SIZE_GET(bits)   ((16 >= (bits)) ? ((bits) / 8) : sizeof(S32))
+//Paced null output: the timer ticks per part (the part is done at most a tick late).
+#define PACE_TICKS_PER_PART 4
+//Paced null output: the frames due are counted in 1/(tick rate) frame units (no tick to ms rounding).
+#define PACE_FRAME_UNITS    ((U64)OS_MS_TO_TICKS(1000))
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    AudioOutConfig      cfg;            // Of the open output.
+    OS_AudioDeviceHd    dev_hd;
+    OS_FileHd           file_hd;
+    OS_TimerHd          timer_hd;
+    OS_QueueHd          slot_qhd;
+    OS_SignalId         next_signal_id;
+    OS_AudioDmaMode     dma_mode;
+    OS_AudioInfo        info;
+    U32                 byte_rate;
+    U8*                 buf_p;
+    Size                buf_size;
+    U32                 part_frames;
+    U64                 frames_due;     // Paced: the frames due (#PACE_FRAME_UNITS, the fractions kept).
+    U8                  half_idx;
+    Bool                is_pending;     // Buffer is not done (normal DMA mode).
+    Bool                is_playing;
+    Bool                is_signal_sent; // Free run: the request is in the queue.
+    OS_Tick             tick_last;
+    OS_Tick             tick_due;       // Paced: the frames due are counted up to.
+} AudioOut;
+
+//-----------------------------------------------------------------------------
+static Status   Kick(void);
+static Bool     IsPartDue(void);
+static Status   WavHeaderWrite(const U32 data_size);
+static void     Put16(U8* p, const U16 v);
+static void     Put32(U8* p, const U32 v);
+
+//-----------------------------------------------------------------------------
+static AudioOutConfig audio_out_cfg = { AUDIO_OUT_DEVICE, 0, "" };
+static AudioOut audio_out;
+static AudioOutStats audio_out_stats;
+
+/*****************************************************************************/
+Status AudioOutConfigSet(const AudioOutConfig* cfg_p)
+{
+    if (OS_NULL == cfg_p) { return S_INVALID_PTR; }
+    if (AUDIO_OUT_LAST <= cfg_p->type) { return S_INVALID_VALUE; }
+    audio_out_cfg = *cfg_p;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioOutConfigGet(AudioOutConfig* cfg_p)
+{
+    if (OS_NULL == cfg_p) { return S_INVALID_PTR; }
+    *cfg_p = audio_out_cfg;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioOutOpen(const OS_AudioDeviceIoSetupArgs* io_args_p, const OS_AudioDeviceArgsOpen* open_args_p,
+                    const OS_SignalId next_signal_id)
+{
+const OS_AudioInfo* info_p = &io_args_p->info;
+Status s = S_UNDEF;
+
+    OS_MemSet(&audio_out, 0, sizeof(audio_out));
+    OS_MemSet(&audio_out_stats, 0, sizeof(audio_out_stats));
+    audio_out.cfg           = audio_out_cfg;
+    audio_out.slot_qhd      = open_args_p->slot_qhd;
+    audio_out.next_signal_id= next_signal_id;
+    audio_out.dma_mode      = io_args_p->dma_mode;
+    audio_out.info          = *info_p;
+    audio_out.byte_rate     = info_p->sample_rate * info_p->channels * SAMPLE_SIZE_GET(info_p->sample_bits);
+    audio_out_stats.type    = audio_out.cfg.type;
+    if (0 == audio_out.byte_rate) { return S_INVALID_VALUE; }
+    switch (audio_out.cfg.type) {
+        case AUDIO_OUT_DEVICE:
+            audio_out.dev_hd = OS_AudioDeviceDefaultGet(DIR_OUT);
+            if (OS_NULL == audio_out.dev_hd) { return S_INVALID_PTR; }
+            IF_OK(s = OS_AudioDeviceIoSetup(audio_out.dev_hd, io_args_p, DIR_OUT)) {
+                s = OS_AudioDeviceOpen(audio_out.dev_hd, (void*)open_args_p);
+            }
+            return s;
+        case AUDIO_OUT_WAV:
+            IF_STATUS(s = OS_FileOpen(&audio_out.file_hd, audio_out.cfg.path,
+                                      BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+                return s;
+            }
+            //Sizes are set on the close.
+            IF_STATUS(s = WavHeaderWrite(0)) {
+                OS_FileClose(&audio_out.file_hd);
+                return s;
+            }
+            //Free run only.
+            audio_out.cfg.clock_mul = 0;
+            break;
+        case AUDIO_OUT_NULL:
+            break;
+        default:
+            return S_INVALID_VALUE;
+    }
+    if (0 != audio_out.cfg.clock_mul) {
+        //The period is set on the play.
+        const OS_TimerConfig tim_cfg = {
+            .name_p = "AudioOut",
+            .slot   = audio_out.slot_qhd,
+            .id     = AUDIO_OUT_TIMER_ID,
+            .period = 1,
+            .options= (OS_TimerOptions)BIT(OS_TIM_OPT_PERIODIC)
+        };
+        s = OS_TimerCreate(&tim_cfg, &audio_out.timer_hd);
+    } else { s = S_OK; }
+    return s;
+}
+
+/*****************************************************************************/
+Status AudioOutClose(void)
+{
+Status s = S_OK;
+
+    switch (audio_out.cfg.type) {
+        case AUDIO_OUT_DEVICE:
+            s = OS_AudioDeviceClose(audio_out.dev_hd);
+            audio_out.dev_hd = OS_NULL;
+            break;
+        case AUDIO_OUT_WAV:
+            if (OS_NULL != audio_out.file_hd) {
+                IF_OK(s = OS_FileLSeek(audio_out.file_hd, 0)) {
+                    s = WavHeaderWrite(audio_out_stats.bytes);
+                }
+                OS_FileClose(&audio_out.file_hd);
+                audio_out.file_hd = OS_NULL;
+            }
+            break;
+        default:
+            break;
+    }
+    if (AUDIO_OUT_DEVICE != audio_out.cfg.type) {
+        AudioOutStats stats;
+        AudioOutStatsGet(&stats);
+        if (0 != stats.wall_ms) {
+            const U32 rtf_x100 = (U32)(((U64)stats.audio_ms * 100) / stats.wall_ms);
+            OS_LOG(D_INFO, "%u ms of audio in %u ms: RTF %u.%02u", stats.audio_ms, stats.wall_ms,
+                   rtf_x100 / 100, rtf_x100 % 100);
+        }
+    }
+    if (OS_NULL != audio_out.timer_hd) {
+        OS_TimerDelete(audio_out.timer_hd, OS_TIMEOUT_DEFAULT);
+        audio_out.timer_hd = OS_NULL;
+    }
+    audio_out.is_playing = OS_FALSE;
+    return s;
+}
+
+/*****************************************************************************/
+Status AudioOutPlay(U8* data_p, const Size size)
+{
+    if (AUDIO_OUT_DEVICE == audio_out.cfg.type) { return OS_AudioPlay(audio_out.dev_hd, data_p, size); }
+    audio_out.buf_p     = data_p;
+    audio_out.buf_size  = size;
+    audio_out.half_idx  = 0;
+    audio_out.is_pending= OS_TRUE;
+    if (OS_TRUE != audio_out.is_playing) {
+        audio_out.is_playing= OS_TRUE;
+        audio_out.tick_last = OS_TickCountGet();
+        if (0 != audio_out.cfg.clock_mul) {
+            const Size part_size = (OS_AUDIO_DMA_MODE_CIRCULAR == audio_out.dma_mode) ? (size / 2) : size;
+            //The integer period only wakes up the pacing: it does not set the rate.
+            const U32 period_ms = (U32)(((U64)part_size * 1000) / audio_out.byte_rate / audio_out.cfg.clock_mul /
+                                        PACE_TICKS_PER_PART);
+            Status s;
+            audio_out.part_frames       = (U32)(((U64)part_size * audio_out.info.sample_rate) / audio_out.byte_rate);
+            audio_out.frames_due        = 0;
+            audio_out.tick_due          = audio_out.tick_last;
+            IF_STATUS(s = OS_TimerPeriodSet(audio_out.timer_hd, (0 != period_ms) ? period_ms : 1, OS_NO_BLOCK)) {
+                return s;
+            }
+        }
+        return Kick();
+    }
+    //Normal DMA mode: the next buffer.
+    if (0 == audio_out.cfg.clock_mul) { return Kick(); }
+    //Paced: the transfer starts on the submit (as the DMA does).
+    audio_out.frames_due= 0;
+    audio_out.tick_due  = OS_TickCountGet();
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioOutPause(void)
+{
+    if (AUDIO_OUT_DEVICE == audio_out.cfg.type) { return OS_AudioPause(audio_out.dev_hd); }
+    audio_out.is_playing = OS_FALSE;
+    if (OS_NULL != audio_out.timer_hd) { return OS_TimerStop(audio_out.timer_hd, OS_NO_BLOCK); }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status AudioOutResume(void)
+{
+    if (AUDIO_OUT_DEVICE == audio_out.cfg.type) { return OS_AudioResume(audio_out.dev_hd); }
+    audio_out.is_playing= OS_TRUE;
+    audio_out.tick_last = OS_TickCountGet();
+    audio_out.tick_due  = audio_out.tick_last;
+    return Kick();
+}
+
+/*****************************************************************************/
+Status AudioOutStop(void)
+{
+    if (AUDIO_OUT_DEVICE == audio_out.cfg.type) { return OS_AudioStop(audio_out.dev_hd); }
+    audio_out.is_playing = OS_FALSE;
+    audio_out.is_pending = OS_FALSE;
+    if (OS_NULL != audio_out.timer_hd) { return OS_TimerStop(audio_out.timer_hd, OS_NO_BLOCK); }
+    return S_OK;
+}
+
+/*****************************************************************************/
+OS_SignalId AudioOutEventNext(void)
+{
+OS_SignalId event_id = OS_SIG_AUDIO_TX_COMPLETE;
+OS_Tick tick;
+U8* data_p = audio_out.buf_p;
+Size size = audio_out.buf_size;
+
+    audio_out.is_signal_sent = OS_FALSE;
+    if ((AUDIO_OUT_DEVICE == audio_out.cfg.type) ||
+        (OS_TRUE != audio_out.is_playing) || (OS_TRUE != audio_out.is_pending)) {
+        return OS_SIG_UNDEF;
+    }
+    if ((0 != audio_out.cfg.clock_mul) && (OS_TRUE != IsPartDue())) { return OS_SIG_UNDEF; }
+    if (OS_AUDIO_DMA_MODE_CIRCULAR == audio_out.dma_mode) {
+        size /= 2;
+        data_p += audio_out.half_idx * size;
+        event_id = (0 == audio_out.half_idx) ? OS_SIG_AUDIO_TX_COMPLETE_HALF : OS_SIG_AUDIO_TX_COMPLETE;
+        audio_out.half_idx ^= 1;
+    } else {
+        audio_out.is_pending = OS_FALSE;
+    }
+    //The part is played before the player refills it.
+    if (AUDIO_OUT_WAV == audio_out.cfg.type) {
+        IF_STATUS(OS_FileWrite(audio_out.file_hd, data_p, size)) { ++audio_out_stats.write_errors; }
+    }
+    tick = OS_TickCountGet();
+    audio_out_stats.wall_ms += OS_TICKS_TO_MS(tick - audio_out.tick_last);
+    audio_out.tick_last = tick;
+    audio_out_stats.bytes += size;
+    ++audio_out_stats.buffers;
+    if (0 != audio_out.cfg.clock_mul) {
+        //Behind the clock (a fast clock or a late tick): the next part at once.
+        if (((audio_out.part_frames * PACE_FRAME_UNITS) <= audio_out.frames_due) &&
+            (OS_AUDIO_DMA_MODE_CIRCULAR == audio_out.dma_mode)) {
+            OS_SignalSend(audio_out.slot_qhd, OS_SignalCreate(audio_out.next_signal_id, 0), OS_MSG_PRIO_NORMAL);
+        }
+    } else if (OS_AUDIO_DMA_MODE_CIRCULAR == audio_out.dma_mode) {
+        Kick();
+    }
+    return event_id;
+}
+
+/*****************************************************************************/
+Status AudioOutStatsGet(AudioOutStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = audio_out_stats;
+    if (0 != audio_out.byte_rate) {
+        stats_p->audio_ms = (U32)(((U64)audio_out_stats.bytes * 1000) / audio_out.byte_rate);
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status Kick(void)
+{
+    if (0 != audio_out.cfg.clock_mul) { return OS_TimerStart(audio_out.timer_hd, OS_NO_BLOCK); }
+    //Free run: the next buffer right after the queued messages.
+    if (OS_TRUE == audio_out.is_signal_sent) { return S_OK; }
+    audio_out.is_signal_sent = OS_TRUE;
+    return OS_SignalSend(audio_out.slot_qhd, OS_SignalCreate(audio_out.next_signal_id, 0), OS_MSG_PRIO_NORMAL);
+}
+
+/*****************************************************************************/
+Bool IsPartDue(void)
+{
+const OS_Tick tick = OS_TickCountGet();
+const U64 part_units = audio_out.part_frames * PACE_FRAME_UNITS;
+    //Frames due = elapsed x rate x mul: the fraction is carried over, so the parts do not drift.
+    audio_out.frames_due += (U64)(tick - audio_out.tick_due) * audio_out.info.sample_rate * audio_out.cfg.clock_mul;
+    audio_out.tick_due = tick;
+    if (part_units > audio_out.frames_due) { return OS_FALSE; }
+    audio_out.frames_due -= part_units;
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Status WavHeaderWrite(const U32 data_size)
+{
+const U16 sample_size = SAMPLE_SIZE_GET(audio_out.info.sample_bits);
+const U16 block_align = audio_out.info.channels * sample_size;
+U8 hdr[WAV_HEADER_SIZE];
+
+    //The buffers are written as is: the containers are the PCM samples (24 in 32 bits -> 32-bit PCM).
+    OS_MemCpy(&hdr[0], "RIFF", 4);
+    Put32(&hdr[4], WAV_HEADER_SIZE - 8 + data_size);
+    OS_MemCpy(&hdr[8], "WAVEfmt ", 8);
+    Put32(&hdr[16], 16);
+    Put16(&hdr[20], 1); //PCM
+    Put16(&hdr[22], audio_out.info.channels);
+    Put32(&hdr[24], audio_out.info.sample_rate);
+    Put32(&hdr[28], audio_out.byte_rate);
+    Put16(&hdr[32], block_align);
+    Put16(&hdr[34], sample_size * 8);
+    OS_MemCpy(&hdr[36], "data", 4);
+    Put32(&hdr[40], data_size);
+    return OS_FileWrite(audio_out.file_hd, hdr, sizeof(hdr));
+}
+
+/*****************************************************************************/
+void Put16(U8* p, const U16 v)
+{
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+}
+
+/*****************************************************************************/
+void Put32(U8* p, const U32 v)
+{
+    Put16(p, (U16)v);
+    Put16(p + 2, (U16)(v >> 16));
+}
+
+#endif //(OS_AUDIO_ENABLED)
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+* @file    audio_out.h
+* @brief   Player audio outputs.
+* @author  A. Filyanov
+* @details The default audio device or a simulated one with the same
+*          open/play/pause/resume/stop/close interface:
+*          - null: the buffers are done at once (free run) or at a multiple
+*            of the real-time clock;
+*          - WAV: the buffers are written to a WAV file (free run).
+*          A simulated output asks the player for the next buffer event with
+*          the signal given on the open (free run) or the OS timer
+*          (OS_SIG_TIMER, data: #AUDIO_OUT_TIMER_ID); the player then takes
+*          the event with AudioOutEventNext(). The played audio to the wall
+*          time ratio is the real-time factor.
+*******************************************************************************/
+#ifndef _AUDIO_OUT_H_
+#define _AUDIO_OUT_H_
+
+#include "os_audio.h"
+#include "app_config.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define AUDIO_OUT_TIMER_ID      20
+
+typedef enum {
+    AUDIO_OUT_DEVICE,
+    AUDIO_OUT_NULL,
+    AUDIO_OUT_WAV,
+    AUDIO_OUT_LAST
+} AudioOutType;
+
+typedef struct {
+    AudioOutType    type;
+    U16             clock_mul;          // Null output: x real-time (0 - free run).
+    Str             path[APP_AUDIO_OUT_PATH_LEN]; // WAV output file.
+} AudioOutConfig;
+
+typedef struct {
+    U8              type;               // #AudioOutType
+    U32             buffers;
+    U32             bytes;
+    U32             audio_ms;           // Played audio time.
+    U32             wall_ms;            // Playback time (pauses excluded).
+    U32             write_errors;
+} AudioOutStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Set the output for the next open.
+/// @param[in]  cfg_p          Config.
+/// @return     #Status.
+Status          AudioOutConfigSet(const AudioOutConfig* cfg_p);
+
+/// @brief      Get the output config.
+/// @param[out] cfg_p          Config.
+/// @return     #Status.
+Status          AudioOutConfigGet(AudioOutConfig* cfg_p);
+
+/// @brief      Open the output.
+/// @param[in]  io_args_p      Audio format and DMA mode.
+/// @param[in]  open_args_p    Player slot and the device ISR callback.
+/// @param[in]  next_signal_id Next buffer event request (simulated outputs).
+/// @return     #Status.
+Status          AudioOutOpen(const OS_AudioDeviceIoSetupArgs* io_args_p, const OS_AudioDeviceArgsOpen* open_args_p,
+                             const OS_SignalId next_signal_id);
+
+/// @brief      Close the output.
+/// @return     #Status.
+Status          AudioOutClose(void);
+
+/// @brief      Play the buffer (circular DMA mode: loop over it).
+/// @param[in]  data_p         Buffer.
+/// @param[in]  size           Size.
+/// @return     #Status.
+Status          AudioOutPlay(U8* data_p, const Size size);
+
+/// @brief      Pause the output.
+/// @return     #Status.
+Status          AudioOutPause(void);
+
+/// @brief      Resume the output.
+/// @return     #Status.
+Status          AudioOutResume(void);
+
+/// @brief      Stop the output.
+/// @return     #Status.
+Status          AudioOutStop(void);
+
+/// @brief      Take the next buffer event of the simulated output.
+/// @return     OS_SIG_AUDIO_TX_COMPLETE(_HALF) or OS_SIG_UNDEF (nothing is playing).
+OS_SignalId     AudioOutEventNext(void);
+
+/// @brief      Get output statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          AudioOutStatsGet(AudioOutStats* stats_p);
+
+#endif //(OS_AUDIO_ENABLED)
+#endif // _AUDIO_OUT_H_
@@ -0,0 +1,64 @@
+/***************************************************************************//**
+* @file    boot_timeline.c
+* @brief   Boot timeline.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "app_common.h"
+#include "boot_timeline.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "boot_timeline"
+
+#define MARKS_MAX           24
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    ConstStrP       name_p;
+    U32             time_us;
+} BootMarkItem;
+
+//-----------------------------------------------------------------------------
+static BootMarkItem marks_v[MARKS_MAX];
+static Size marks_count;
+//Timeline up to the last mark (the core clock may change in between).
+static U32 cycles_last;
+static U32 time_us_last;
+
+/*****************************************************************************/
+void BootTimelineInit(void)
+{
+    APP_CYCLES_INIT();
+    //The counter is not reset by the system (soft) reset.
+    cycles_last = APP_CYCLES_GET();
+    time_us_last= 0;
+    marks_count = 0;
+}
+
+/*****************************************************************************/
+void BootMark(ConstStrP name_p)
+{
+const U32 cycles_per_us = (0 != APP_CYCLES_PER_US) ? APP_CYCLES_PER_US : 1;
+U32 primask;
+
+    APP_CRITICAL_SECTION_ENTER(primask);
+    if (MARKS_MAX > marks_count) {
+        //The span from the last mark is converted at the current core clock.
+        const U32 cycles = APP_CYCLES_GET() - cycles_last;
+        time_us_last += cycles / cycles_per_us;
+        cycles_last  += cycles - (cycles % cycles_per_us);
+        marks_v[marks_count].name_p = name_p;
+        marks_v[marks_count].time_us= time_us_last;
+        ++marks_count;
+    }
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
+
+/*****************************************************************************/
+Status BootMarkGet(const Size idx, ConstStrP* name_pp, U32* time_us_p)
+{
+    if ((OS_NULL == name_pp) || (OS_NULL == time_us_p)) { return S_INVALID_PTR; }
+    if (marks_count <= idx) { return S_INVALID_VALUE; }
+    *name_pp    = marks_v[idx].name_p;
+    *time_us_p  = marks_v[idx].time_us;
+    return S_OK;
+}
@@ -0,0 +1,33 @@
+/***************************************************************************//**
+* @file    boot_timeline.h
+* @brief   Boot timeline.
+* @author  A. Filyanov
+* @details Init steps mark their end time (APP_CYCLES_GET() from the
+*          power-on).
+*          Each mark converts the cycles since the previous one at the core
+*          clock of its own time, so the steps before the system clock setup
+*          (HAL) are counted at the reset clock; a step spanning the clock
+*          switch is approximate.
+*******************************************************************************/
+#ifndef _BOOT_TIMELINE_H_
+#define _BOOT_TIMELINE_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+/// @brief      Init boot timeline (start the cycle counter).
+void            BootTimelineInit(void);
+
+/// @brief      Mark the init step end.
+/// @param[in]  name_p         Step name (constant string).
+/// @details    Any task; extra marks are dropped.
+void            BootMark(ConstStrP name_p);
+
+/// @brief      Get boot timeline mark.
+/// @param[in]  idx            Mark index.
+/// @param[out] name_pp        Step name.
+/// @param[out] time_us_p      Time from the power-on (us).
+/// @return     #Status.
+Status          BootMarkGet(const Size idx, ConstStrP* name_pp, U32* time_us_p);
+
+#endif // _BOOT_TIMELINE_H_
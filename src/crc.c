@@ -0,0 +1,89 @@
+/***************************************************************************//**
+* @file    crc.c
+* @brief   Generic table driven CRC engine.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "crc.h"
+
+//-----------------------------------------------------------------------------
+static const U32 crc_8_tbl[256]         = { CRC_TABLE_R(0x8C) };
+static const U32 crc_16_ccitt_tbl[256]  = { CRC_TABLE_N(0x1021, 16) };
+static const U32 crc_32c_tbl[256]       = { CRC_TABLE_R(0x82F63B78) };
+
+const CrcModel crc_model_8 = {
+    .table_p        = crc_8_tbl,
+    .update_fp      = OS_NULL,
+    .init           = 0x00,
+    .xor_out        = 0x00,
+    .width          = 8,
+    .is_reflected   = OS_TRUE
+};
+
+const CrcModel crc_model_16_ccitt = {
+    .table_p        = crc_16_ccitt_tbl,
+    .update_fp      = OS_NULL,
+    .init           = 0xFFFF,
+    .xor_out        = 0x0000,
+    .width          = 16,
+    .is_reflected   = OS_FALSE
+};
+
+const CrcModel crc_model_32c = {
+    .table_p        = crc_32c_tbl,
+    .update_fp      = OS_NULL,
+    .init           = 0xFFFFFFFF,
+    .xor_out        = 0xFFFFFFFF,
+    .width          = 32,
+    .is_reflected   = OS_TRUE
+};
+
+/*****************************************************************************/
+void CrcInit(CrcContext* ctx_p, const CrcModel* model_p)
+{
+    ctx_p->model_p  = model_p;
+    ctx_p->crc      = (OS_TRUE == model_p->is_reflected) ? model_p->init : (model_p->init << (32 - model_p->width));
+}
+
+/*****************************************************************************/
+void CrcUpdate(CrcContext* ctx_p, U8* data_p, Size size)
+{
+const U32* tbl_p = ctx_p->model_p->table_p;
+U32 crc = ctx_p->crc;
+
+    if (OS_NULL != ctx_p->model_p->update_fp) {
+        ctx_p->crc = ctx_p->model_p->update_fp(data_p, size, crc);
+        return;
+    }
+    if (OS_TRUE == ctx_p->model_p->is_reflected) {
+        while (0 != size) {
+            crc = tbl_p[(crc ^ *data_p) & 0xFF] ^ (crc >> 8);
+            ++data_p;
+            --size;
+        }
+    } else {
+        while (0 != size) {
+            crc = tbl_p[(crc >> 24) ^ *data_p] ^ (crc << 8);
+            ++data_p;
+            --size;
+        }
+    }
+    ctx_p->crc = crc;
+}
+
+/*****************************************************************************/
+U32 CrcFinal(const CrcContext* ctx_p)
+{
+const CrcModel* model_p = ctx_p->model_p;
+const U32 mask = (32 == model_p->width) ? 0xFFFFFFFF : ((1UL << model_p->width) - 1);
+const U32 crc = (OS_TRUE == model_p->is_reflected) ? ctx_p->crc : (ctx_p->crc >> (32 - model_p->width));
+    return ((crc ^ model_p->xor_out) & mask);
+}
+
+/*****************************************************************************/
+U32 CrcCompute(const CrcModel* model_p, U8* data_p, Size size)
+{
+CrcContext ctx;
+    CrcInit(&ctx, model_p);
+    CrcUpdate(&ctx, data_p, size);
+    return CrcFinal(&ctx);
+}
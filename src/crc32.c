@@ -3,60 +3,271 @@
 * @brief   CRC32.
 * @author  A. Filyanov
 *******************************************************************************/
+#include "crc.h"
 #include "crc32.h"
 
 //-----------------------------------------------------------------------------
-static const U32 crc_32_tbl[256] =
-{
-    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
-    0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
-    0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
-    0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
-    0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-    0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
-    0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
-    0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
-    0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
-    0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-    0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
-    0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
-    0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
-    0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
-    0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
-    0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
-    0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
-    0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
-    0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-    0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
-    0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
-    0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+#define CRC32_POLY_REFLECTED    0xEDB88320U
+//Carry-less multiply folding: x86 host builds, dispatched on the CPU support.
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#   define CRC32_PCLMUL_ENABLED (1)
+#   include <immintrin.h>
+#else
+#   define CRC32_PCLMUL_ENABLED (0)
+#endif
+#define CRC32_PCLMUL_BLOCK      64
+#define CRC32_PCLMUL_LANE       16
+
+//-----------------------------------------------------------------------------
+static U32      Crc32MulModP(U32 a, U32 b);
+static U32      Crc32Bytewise(U8* data_p, Size size, U32 crc_32);
+static U32      Crc32Slicing8(U8* data_p, Size size, U32 crc_32);
+#if (CRC32_PCLMUL_ENABLED)
+static U32      Crc32Pclmul(U8* data_p, Size size, U32 crc_32);
+#endif //(CRC32_PCLMUL_ENABLED)
+
+//-----------------------------------------------------------------------------
+//Slicing-by-8: row k is the CRC of a byte followed by k zero bytes.
+//Row 0 is generated at compile time; rows 1..7 are derived from it by Crc32Init().
+static U32 crc_32_tbl[8][256] =
+{
+    { CRC_TABLE_R(CRC32_POLY_REFLECTED) }
+};
+static volatile Bool is_crc_32_tbl_ready = OS_FALSE;
+
+//x^(2^n) modulo the polynomial (reflected), n = 0..31.
+static const U32 crc_32_x2n_tbl[32] =
+{
+    0x40000000, 0x20000000, 0x08000000, 0x00800000, 0x00008000, 0xEDB88320, 0xB1E6B092, 0xA06A2517,
+    0xED627DAE, 0x88D14467, 0xD7BBFE6A, 0xEC447F11, 0x8E7EA170, 0x6427800E, 0x4D47BAE0, 0x09FE548F,
+    0x83852D0F, 0x30362F1A, 0x7B5A9CC3, 0x31FEC169, 0x9FEC022A, 0x6C8DEDC4, 0x15D6874D, 0x5FDE7A4E,
+    0xBAD90E37, 0x2E4E5EEF, 0x4EABA214, 0xA8A472C0, 0x429A969E, 0x148D302A, 0xC40BA6D0, 0xC4E22C3C
+};
+
+const CrcModel crc_model_32 = {
+    .table_p        = crc_32_tbl[0],
+    .update_fp      = Crc32Delta,
+    .init           = CRC32_POLYNOMIAL,
+    .xor_out        = CRC32_POLYNOMIAL,
+    .width          = 32,
+    .is_reflected   = OS_TRUE
 };
 
 /*****************************************************************************/
-U32 Crc32(U8* data_p, U32 size)
+void Crc32Init(void)
 {
-    return (Crc32Delta(data_p, size, CRC32_POLYNOMIAL) ^ CRC32_POLYNOMIAL);
+    if (OS_TRUE == is_crc_32_tbl_ready) { return; }
+    //Row k: the row k-1 entry followed by a zero byte.
+    for (Size k = 1; k < 8; ++k) {
+        for (Size i = 0; i < 256; ++i) {
+            const U32 crc_32 = crc_32_tbl[k - 1][i];
+            crc_32_tbl[k][i] = crc_32_tbl[0][crc_32 & 0xFF] ^ (crc_32 >> 8);
+        }
+    }
+    is_crc_32_tbl_ready = OS_TRUE;
 }
 
 /*****************************************************************************/
-U32 Crc32Delta(U8* data_p, U32 size, U32 init_poly)
+U32 Crc32(U8* data_p, Size size)
 {
-U32 crc_32 = init_poly;
+    return CrcCompute(&crc_model_32, data_p, size);
+}
 
+/*****************************************************************************/
+U32 Crc32Delta(U8* data_p, Size size, U32 init_poly)
+{
+#if (CRC32_PCLMUL_ENABLED)
+    if ((CRC32_PCLMUL_BLOCK <= size) && (OS_TRUE == Crc32ImplIsAvailable(CRC32_IMPL_PCLMUL))) {
+        //Whole lanes are folded, the tail is sliced.
+        const Size size_fold = size & ~(Size)(CRC32_PCLMUL_LANE - 1);
+        init_poly = Crc32Pclmul(data_p, size_fold, init_poly);
+        data_p += size_fold;
+        size   -= size_fold;
+    }
+#endif //(CRC32_PCLMUL_ENABLED)
+    return Crc32Slicing8(data_p, size, init_poly);
+}
+
+/*****************************************************************************/
+Bool Crc32ImplIsAvailable(const Crc32Impl impl)
+{
+    switch (impl) {
+        case CRC32_IMPL_BYTEWISE:
+            return OS_TRUE;
+        case CRC32_IMPL_SLICING_8:
+            return is_crc_32_tbl_ready;
+#if (CRC32_PCLMUL_ENABLED)
+        case CRC32_IMPL_PCLMUL:
+            return (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) ? OS_TRUE : OS_FALSE;
+#endif //(CRC32_PCLMUL_ENABLED)
+        default:
+            break;
+    }
+    return OS_FALSE;
+}
+
+/*****************************************************************************/
+U32 Crc32DeltaImpl(const Crc32Impl impl, U8* data_p, Size size, U32 init_poly)
+{
+    if (OS_TRUE != Crc32ImplIsAvailable(impl)) { return init_poly; }
+    switch (impl) {
+        case CRC32_IMPL_BYTEWISE:
+            return Crc32Bytewise(data_p, size, init_poly);
+        case CRC32_IMPL_SLICING_8:
+            return Crc32Slicing8(data_p, size, init_poly);
+        case CRC32_IMPL_PCLMUL:
+            return Crc32Delta(data_p, size, init_poly);
+        default:
+            break;
+    }
+    return init_poly;
+}
+
+/*****************************************************************************/
+U32 Crc32Bytewise(U8* data_p, Size size, U32 crc_32)
+{
     while (0 != size) {
-        crc_32 = crc_32_tbl[(crc_32 ^ *data_p) & 0xFF] ^ (crc_32 >> 8);
+        crc_32 = crc_32_tbl[0][(crc_32 ^ *data_p) & 0xFF] ^ (crc_32 >> 8);
         ++data_p;
         --size;
     }
     return crc_32;
-}
\ No newline at end of file
+}
+
+/*****************************************************************************/
+U32 Crc32Slicing8(U8* data_p, Size size, U32 crc_32)
+{
+U32 lo;
+U32 hi;
+
+    //Byte-wise till the tables are ready.
+    if (OS_TRUE != is_crc_32_tbl_ready) { return Crc32Bytewise(data_p, size, crc_32); }
+    //Byte-wise up to the word alignment.
+    while ((0 != size) && (0 != ((Size)data_p & (sizeof(U32) - 1)))) {
+        crc_32 = crc_32_tbl[0][(crc_32 ^ *data_p) & 0xFF] ^ (crc_32 >> 8);
+        ++data_p;
+        --size;
+    }
+    //Slicing-by-8 (little-endian words).
+    while (8 <= size) {
+        lo = *(const U32*)data_p ^ crc_32;
+        hi = *(const U32*)(data_p + sizeof(U32));
+        crc_32 = crc_32_tbl[7][lo & 0xFF]           ^ crc_32_tbl[6][(lo >> 8) & 0xFF] ^
+                 crc_32_tbl[5][(lo >> 16) & 0xFF]   ^ crc_32_tbl[4][lo >> 24] ^
+                 crc_32_tbl[3][hi & 0xFF]           ^ crc_32_tbl[2][(hi >> 8) & 0xFF] ^
+                 crc_32_tbl[1][(hi >> 16) & 0xFF]   ^ crc_32_tbl[0][hi >> 24];
+        data_p += 8;
+        size   -= 8;
+    }
+    return Crc32Bytewise(data_p, size, crc_32);
+}
+
+#if (CRC32_PCLMUL_ENABLED)
+/*****************************************************************************/
+//Folding by 4 x 128 bits, then Barrett reduction (Intel "Fast CRC Computation
+//for Generic Polynomials Using PCLMULQDQ", the bit-reflected constants).
+//size: CRC32_PCLMUL_BLOCK at least, CRC32_PCLMUL_LANE multiple.
+__attribute__((target("pclmul,sse4.1")))
+U32 Crc32Pclmul(U8* data_p, Size size, U32 crc_32)
+{
+static const U64 k1k2_v[2] __attribute__((aligned(16))) = { 0x0154442BD4ULL, 0x01C6E41596ULL };
+static const U64 k3k4_v[2] __attribute__((aligned(16))) = { 0x01751997D0ULL, 0x00CCAA009EULL };
+static const U64 k5k0_v[2] __attribute__((aligned(16))) = { 0x0163CD6124ULL, 0x0000000000ULL };
+static const U64 poly_v[2] __attribute__((aligned(16))) = { 0x01DB710641ULL, 0x01F7011641ULL };
+__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    x1 = _mm_loadu_si128((const __m128i*)(data_p + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*)(data_p + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*)(data_p + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*)(data_p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc_32));
+    x0 = _mm_load_si128((const __m128i*)k1k2_v);
+    data_p += CRC32_PCLMUL_BLOCK;
+    size   -= CRC32_PCLMUL_BLOCK;
+    //Four lanes in parallel.
+    while (CRC32_PCLMUL_BLOCK <= size) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data_p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data_p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data_p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data_p + 0x30)));
+        data_p += CRC32_PCLMUL_BLOCK;
+        size   -= CRC32_PCLMUL_BLOCK;
+    }
+    //Fold the lanes into one.
+    x0 = _mm_load_si128((const __m128i*)k3k4_v);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while (CRC32_PCLMUL_LANE <= size) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data_p)), x5);
+        data_p += CRC32_PCLMUL_LANE;
+        size   -= CRC32_PCLMUL_LANE;
+    }
+    //128 -> 64 bits.
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x0 = _mm_loadl_epi64((const __m128i*)k5k0_v);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x00), x2);
+    //Barrett reduction to 32 bits.
+    x0 = _mm_load_si128((const __m128i*)poly_v);
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (U32)_mm_extract_epi32(x1, 1);
+}
+#endif //(CRC32_PCLMUL_ENABLED)
+
+/*****************************************************************************/
+U32 Crc32Combine(const U32 crc_1, const U32 crc_2, Size size_2)
+{
+U32 x2n = 0x80000000;   // x^0
+Size n = 3;             // x^(8 * size_2): start from x^(2^3).
+
+    while (0 != size_2) {
+        if (size_2 & 1) {
+            x2n = Crc32MulModP(crc_32_x2n_tbl[n & 31], x2n);
+        }
+        size_2 >>= 1;
+        ++n;
+    }
+    return (Crc32MulModP(x2n, crc_1) ^ crc_2);
+}
+
+/*****************************************************************************/
+U32 Crc32MulModP(U32 a, U32 b)
+{
+U32 m = 0x80000000;
+U32 p = 0;
+
+    //Polynomials are reflected: x^0 is the top bit.
+    while (0 != m) {
+        if (a & m) {
+            p ^= b;
+            if (0 == (a & (m - 1))) { break; }
+        }
+        m >>= 1;
+        b = (b & 1) ? ((b >> 1) ^ CRC32_POLY_REFLECTED) : (b >> 1);
+    }
+    return p;
+}
@@ -0,0 +1,123 @@
+/***************************************************************************//**
+* @file    dlog.c
+* @brief   Deferred binary log.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <stdio.h>
+#include "os_time.h"
+#include "app_common.h"
+#include "spsc_ring.h"
+#include "dlog.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "dlog"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    DLogModule*     mdl_p;
+    ConstStrP       fmt_p;              // Format id.
+    OS_Tick         tick;
+    U8              level;
+    U8              args_count;
+    U32             args[DLOG_ARGS_MAX];
+} DLogRecord;
+
+//-----------------------------------------------------------------------------
+static DLogRecord records_v[APP_DLOG_RECORDS_COUNT];
+static SpscRing records_ring;
+static DLogModule* modules_p;
+static DLogModule* modules_last_p;
+static U32 formatted;
+
+/*****************************************************************************/
+Status DLogInit(void)
+{
+    return SpscRingInit(&records_ring, records_v, sizeof(DLogRecord), APP_DLOG_RECORDS_COUNT);
+}
+
+/*****************************************************************************/
+void DLogPut(DLogModule* mdl_p, const OS_LogLevel level, ConstStrP fmt_p, const U8 args_count,
+             const U32 a0, const U32 a1, const U32 a2, const U32 a3)
+{
+DLogRecord record;
+U32 primask;
+
+    record.mdl_p        = mdl_p;
+    record.fmt_p        = fmt_p;
+    record.tick         = OS_TickCountGet();
+    record.level        = (U8)level;
+    record.args_count   = args_count;
+    record.args[0]      = a0;
+    record.args[1]      = a1;
+    record.args[2]      = a2;
+    record.args[3]      = a3;
+    //Producers are serialized; the consumer drains the ring lock-free.
+    APP_CRITICAL_SECTION_ENTER(primask);
+    if (0 != mdl_p->rate_max) {
+        if (OS_MS_TO_TICKS(1000) <= (record.tick - mdl_p->window_tick)) {
+            mdl_p->window_tick  = record.tick;
+            mdl_p->rate_count   = 0;
+        }
+        if (mdl_p->rate_max <= mdl_p->rate_count) {
+            ++mdl_p->drops;
+            APP_CRITICAL_SECTION_EXIT(primask);
+            return;
+        }
+        ++mdl_p->rate_count;
+    }
+    if (OS_TRUE != mdl_p->is_linked) {
+        if (OS_NULL == modules_p) {
+            modules_p = mdl_p;
+        } else {
+            modules_last_p->next_p = mdl_p;
+        }
+        modules_last_p = mdl_p;
+        mdl_p->is_linked = OS_TRUE;
+    }
+    ++mdl_p->records;
+    //BgServ polls the ring: no wakeup is sent.
+    SpscRingPut(&records_ring, &record);
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
+
+/*****************************************************************************/
+Bool DLogStep(void)
+{
+DLogRecord record;
+Str line[APP_DLOG_LINE_LEN];
+
+    for (Size i = 0; i < APP_DLOG_STEP_RECORDS; ++i) {
+        if (OS_TRUE != SpscRingGet(&records_ring, &record)) { return OS_FALSE; }
+        snprintf(line, sizeof(line), record.fmt_p, record.args[0], record.args[1], record.args[2], record.args[3]);
+        OS_LOG((OS_LogLevel)record.level, "%u %s: %s", OS_TICKS_TO_MS(record.tick), record.mdl_p->name_p, line);
+        ++formatted;
+    }
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Status DLogStatsGet(DLogStats* stats_p)
+{
+SpscRingStats ring_stats;
+Status s = S_UNDEF;
+
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    IF_OK(s = SpscRingStatsGet(&records_ring, &ring_stats)) {
+        stats_p->records_count  = ring_stats.items_count;
+        stats_p->depth          = ring_stats.depth;
+        stats_p->depth_max      = ring_stats.depth_max;
+        stats_p->overflows      = ring_stats.overflows;
+        stats_p->formatted      = formatted;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+const DLogModule* DLogModuleGet(const Size idx)
+{
+const DLogModule* mdl_p = modules_p;
+    for (Size i = 0; (OS_NULL != mdl_p) && (i < idx); ++i) {
+        mdl_p = mdl_p->next_p;
+    }
+    return mdl_p;
+}
@@ -0,0 +1,86 @@
+/***************************************************************************//**
+* @file    dlog.h
+* @brief   Deferred binary log.
+* @author  A. Filyanov
+* @details Call site records the format string address (format id), the tick
+*          and up to 4 raw 32-bit arguments into the RAM ring; the formatting
+*          is done later by BgServ (DLogStep()). The arguments are not copied
+*          deeply: %s must point to a constant string.
+*          Levels above APP_DLOG_LEVEL are removed at compile time. Each module
+*          defines its records rate limit with DLOG_MODULE_DEFINE().
+*******************************************************************************/
+#ifndef _DLOG_H_
+#define _DLOG_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+//-----------------------------------------------------------------------------
+#define DLOG_ARGS_MAX           4
+
+typedef struct DLogModule {
+    ConstStrP       name_p;
+    U16             rate_max;           // Records per second (0 - no limit).
+    U16             rate_count;         // Records in the current second.
+    OS_Tick         window_tick;
+    U32             records;
+    U32             drops;              // Rate limited.
+    Bool            is_linked;
+    struct DLogModule* next_p;
+} DLogModule;
+
+typedef struct {
+    U16             records_count;
+    U16             depth;
+    U16             depth_max;
+    U32             overflows;          // Ring is full.
+    U32             formatted;
+} DLogStats;
+
+/// @brief      Define the module log state (MDL_NAME is the module name).
+/// @param[in]  rate_max       Records per second (0 - no limit).
+#define DLOG_MODULE_DEFINE(rate_max)    static DLogModule dlog_mdl = { MDL_NAME, (rate_max) }
+
+#define DLOG_PUT(level, fmt_p, n, a0, a1, a2, a3) \
+    do { \
+        if ((level) <= APP_DLOG_LEVEL) { \
+            DLogPut(&dlog_mdl, (level), (fmt_p), (n), (U32)(a0), (U32)(a1), (U32)(a2), (U32)(a3)); \
+        } \
+    } while (0)
+
+#define DLOG(level, fmt_p)                      DLOG_PUT(level, fmt_p, 0, 0, 0, 0, 0)
+#define DLOG1(level, fmt_p, a0)                 DLOG_PUT(level, fmt_p, 1, a0, 0, 0, 0)
+#define DLOG2(level, fmt_p, a0, a1)             DLOG_PUT(level, fmt_p, 2, a0, a1, 0, 0)
+#define DLOG3(level, fmt_p, a0, a1, a2)         DLOG_PUT(level, fmt_p, 3, a0, a1, a2, 0)
+#define DLOG4(level, fmt_p, a0, a1, a2, a3)     DLOG_PUT(level, fmt_p, 4, a0, a1, a2, a3)
+
+//-----------------------------------------------------------------------------
+/// @brief      Init deferred log.
+/// @return     #Status.
+Status          DLogInit(void);
+
+/// @brief      Put record (DLOG*() macros).
+/// @param[in]  mdl_p          Module.
+/// @param[in]  level          Level.
+/// @param[in]  fmt_p          Format string (constant).
+/// @param[in]  args_count     Arguments count.
+/// @param[in]  a0             Arguments...
+/// @details    Any context (ISR too). Constant time.
+void            DLogPut(DLogModule* mdl_p, const OS_LogLevel level, ConstStrP fmt_p, const U8 args_count,
+                        const U32 a0, const U32 a1, const U32 a2, const U32 a3);
+
+/// @brief      Format the pending records (BgServ context).
+/// @return     Records are pending.
+Bool            DLogStep(void);
+
+/// @brief      Get deferred log statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          DLogStatsGet(DLogStats* stats_p);
+
+/// @brief      Get log module.
+/// @param[in]  idx            Module index (in the first record order).
+/// @return     Module or OS_NULL.
+const DLogModule* DLogModuleGet(const Size idx);
+
+#endif // _DLOG_H_
@@ -0,0 +1,325 @@
+/***************************************************************************//**
+* @file    image_verify.c
+* @brief   Firmware/images integrity verification.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_time.h"
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "image_verify.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "image_verify"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_image_verify_v[0]
+
+#define STATE_MAGIC             0x56474D49  // "IMGV"
+#define TRAILER_SIZE            sizeof(U32)
+#define HEAD_SIZE               512         // Image identity block.
+#define IMAGES_MAX              4
+#define IMAGES_COUNT            ITEMS_COUNT_GET(images_v, ImageItem)
+
+#if (APP_PORT_POSIX)
+// No memory mapped firmware on the host.
+#define FW_IMAGE_SIZE_GET()     (0)
+#else
+// ielftool writes the firmware CRC32 to __checksum (placed last in the ROM by the linker).
+extern const U32 __checksum;
+#define FW_IMAGE_SIZE_GET()     ((U32)&__checksum + sizeof(__checksum) - APP_IMAGE_VERIFY_FW_ADDR)
+#endif //(APP_PORT_POSIX)
+
+//-----------------------------------------------------------------------------
+const StatusItem status_image_verify_v[] = {
+    {"Undefined status"},
+    {"CRC mismatch"},
+    {"No image CRC"},
+};
+
+typedef struct {
+    ConstStrP       name_p;
+    ConstStrP       path_p;             // File image; memory mapped one if OS_NULL.
+    U32             addr;
+    U32             size;               // Memory mapped firmware image size if 0.
+} ImageItem;
+
+//Resumable part.
+typedef struct {
+    U32             idx;
+    U32             pos;
+    U32             size;
+    U32             crc;                // Crc32Delta() register.
+    U32             crc_expected;
+    U32             head_crc;           // Head block CRC32 (with the size and the expected CRC: the image identity).
+    U32             bytes;
+    U32             busy_ms;
+    U8              results[IMAGES_MAX];
+} ImageVerifyState;
+
+typedef struct {
+    U32             magic;
+    U32             crc;                // State CRC32.
+    ImageVerifyState state;
+} ImageVerifyStateFile;
+
+//-----------------------------------------------------------------------------
+static Status   ImageOpen(const ImageItem* item_p);
+static Status   ImageIdentityGet(const ImageItem* item_p, const U32 size, U32* crc_expected_p, U32* head_crc_p);
+static void     ImageClose(const ImageItem* item_p);
+static Status   ImageRead(const ImageItem* item_p);
+static void     ImageEnd(const ImageVerifyResult result);
+static void     PassEnd(void);
+
+//-----------------------------------------------------------------------------
+static const ImageItem images_v[] = {
+    { "firmware",   OS_NULL,                        APP_IMAGE_VERIFY_FW_ADDR,   0 },
+    { "update",     APP_IMAGE_VERIFY_UPDATE_FILE,   0,                          0 },
+};
+static ImageVerifyState state;
+static ImageVerifyStats image_verify_stats;
+static OS_FileHd file_hd;
+static Bool is_image_open;
+static U8* buf_p;
+
+/*****************************************************************************/
+Status ImageVerifyInit(void)
+{
+ImageVerifyStateFile state_file;
+OS_FileHd state_hd;
+Status s = S_UNDEF;
+
+    OS_ASSERT_VALUE(IMAGES_COUNT <= ITEMS_COUNT_GET(state.results, U8));
+    OS_ASSERT_VALUE(HEAD_SIZE <= APP_IMAGE_VERIFY_CHUNK_SIZE);
+    IF_OK(s = OS_FileOpen(&state_hd, APP_IMAGE_VERIFY_STATE_FILE,
+                          BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        s = OS_FileRead(state_hd, &state_file, sizeof(state_file));
+        OS_FileClose(&state_hd);
+        //The state is used once.
+        OS_FileDelete(APP_IMAGE_VERIFY_STATE_FILE);
+        IF_OK(s) {
+            if ((STATE_MAGIC == state_file.magic) && (IMAGES_COUNT > state_file.state.idx) &&
+                (state_file.crc == Crc32((U8*)&state_file.state, sizeof(state_file.state)))) {
+                buf_p = OS_MallocEx(APP_IMAGE_VERIFY_CHUNK_SIZE, APP_IMAGE_VERIFY_MEMORY);
+                if (OS_NULL == buf_p) { return S_OUT_OF_MEMORY; }
+                state = state_file.state;
+                image_verify_stats.bytes    = state.bytes;
+                image_verify_stats.busy_ms  = state.busy_ms;
+                image_verify_stats.is_active= OS_TRUE;
+                ++image_verify_stats.resumes;
+                OS_LOG(D_INFO, "Resume: %s at %u", images_v[state.idx].name_p, state.pos);
+            }
+        }
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status ImageVerifyStart(void)
+{
+    if (OS_TRUE == image_verify_stats.is_active) { return S_OK; }
+    buf_p = OS_MallocEx(APP_IMAGE_VERIFY_CHUNK_SIZE, APP_IMAGE_VERIFY_MEMORY);
+    if (OS_NULL == buf_p) { return S_OUT_OF_MEMORY; }
+    OS_MemSet(&state, 0, sizeof(state));
+    state.crc = CRC32_POLYNOMIAL;
+    image_verify_stats.bytes    = 0;
+    image_verify_stats.busy_ms  = 0;
+    image_verify_stats.is_active= OS_TRUE;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool ImageVerifyStep(void)
+{
+const OS_Tick tick_start = OS_TickCountGet();
+U32 time_ms = 0;
+Status s = S_UNDEF;
+
+    if (OS_TRUE != image_verify_stats.is_active) { return OS_FALSE; }
+    //Large reads until the time slice is spent.
+    while ((IMAGES_COUNT > state.idx) && (APP_IMAGE_VERIFY_SLICE_MS > time_ms)) {
+        const ImageItem* item_p = &images_v[state.idx];
+        if (OS_TRUE != is_image_open) {
+            IF_STATUS(s = ImageOpen(item_p)) {
+                ImageEnd((S_IMAGE_VERIFY_NO_CRC == s) ? IMAGE_VERIFY_RESULT_NO_CRC : IMAGE_VERIFY_RESULT_ERROR);
+                continue;
+            }
+        }
+        IF_STATUS(s = ImageRead(item_p)) {
+            ImageClose(item_p);
+            ImageEnd(IMAGE_VERIFY_RESULT_ERROR);
+        } else if ((state.size - TRAILER_SIZE) == state.pos) {
+            ImageClose(item_p);
+            ImageEnd(((state.crc ^ CRC32_POLYNOMIAL) == state.crc_expected) ?
+                     IMAGE_VERIFY_RESULT_OK : IMAGE_VERIFY_RESULT_MISMATCH);
+        }
+        time_ms = OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+    }
+    state.busy_ms += OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+    image_verify_stats.busy_ms = state.busy_ms;
+    if (IMAGES_COUNT <= state.idx) {
+        PassEnd();
+        return OS_FALSE;
+    }
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Status ImageVerifySuspend(void)
+{
+ImageVerifyStateFile state_file;
+OS_FileHd state_hd;
+Status s = S_UNDEF;
+
+    if (OS_TRUE != image_verify_stats.is_active) { return S_OK; }
+    if (OS_TRUE == is_image_open) { ImageClose(&images_v[state.idx]); }
+    state_file.magic    = STATE_MAGIC;
+    state_file.state    = state;
+    state_file.crc      = Crc32((U8*)&state_file.state, sizeof(state_file.state));
+    IF_OK(s = OS_FileOpen(&state_hd, APP_IMAGE_VERIFY_STATE_FILE,
+                          BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        s = OS_FileWrite(state_hd, &state_file, sizeof(state_file));
+        OS_FileClose(&state_hd);
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status ImageVerifyStatsGet(ImageVerifyStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = image_verify_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status ImageVerifyResultGet(const Size idx, ConstStrP* name_pp, ImageVerifyResult* result_p)
+{
+    if ((OS_NULL == name_pp) || (OS_NULL == result_p)) { return S_INVALID_PTR; }
+    if (IMAGES_COUNT <= idx) { return S_INVALID_VALUE; }
+    *name_pp    = images_v[idx].name_p;
+    *result_p   = (ImageVerifyResult)state.results[idx];
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status ImageOpen(const ImageItem* item_p)
+{
+U32 size = item_p->size;
+U32 crc_expected;
+U32 head_crc;
+Status s = S_UNDEF;
+
+    if (OS_NULL != item_p->path_p) {
+        IF_STATUS(s = OS_FileOpen(&file_hd, item_p->path_p,
+                                  BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+            return s;
+        }
+        size = OS_FileSizeGet(file_hd);
+    } else if (0 == size) {
+        size = FW_IMAGE_SIZE_GET();
+        if (0 == size) { return S_IMAGE_VERIFY_NO_CRC; }
+    }
+    if (TRAILER_SIZE > size) {
+        s = S_INVALID_SIZE;
+    } else IF_OK(s = ImageIdentityGet(item_p, size, &crc_expected, &head_crc)) {
+        //Resumed image must be the same one (a replaced image of the same size is not).
+        if ((size != state.size) || (crc_expected != state.crc_expected) || (head_crc != state.head_crc)) {
+            state.pos = 0;
+        }
+        if (OS_NULL != item_p->path_p) { s = OS_FileLSeek(file_hd, state.pos); }
+    }
+    IF_OK(s) {
+        if (0 == state.pos) { state.crc = CRC32_POLYNOMIAL; }
+        state.size          = size;
+        state.crc_expected  = crc_expected;
+        state.head_crc      = head_crc;
+        is_image_open = OS_TRUE;
+        if (U32_MAX == state.crc_expected) { s = S_IMAGE_VERIFY_NO_CRC; }
+    }
+    IF_STATUS(s) { ImageClose(item_p); }
+    return s;
+}
+
+/*****************************************************************************/
+Status ImageIdentityGet(const ImageItem* item_p, const U32 size, U32* crc_expected_p, U32* head_crc_p)
+{
+const U32 head_size = ((size - TRAILER_SIZE) < HEAD_SIZE) ? (size - TRAILER_SIZE) : HEAD_SIZE;
+Status s = S_OK;
+
+    if (OS_NULL != item_p->path_p) {
+        IF_OK(s = OS_FileLSeek(file_hd, size - TRAILER_SIZE)) {
+            IF_OK(s = OS_FileRead(file_hd, crc_expected_p, TRAILER_SIZE)) {
+                IF_OK(s = OS_FileLSeek(file_hd, 0)) {
+                    IF_OK(s = OS_FileRead(file_hd, buf_p, head_size)) {
+                        *head_crc_p = Crc32(buf_p, head_size);
+                    }
+                }
+            }
+        }
+    } else {
+        U8* image_p = (U8*)(uintptr_t)item_p->addr;
+        OS_MemCpy(crc_expected_p, image_p + size - TRAILER_SIZE, TRAILER_SIZE);
+        *head_crc_p = Crc32(image_p, head_size);
+    }
+    return s;
+}
+
+/*****************************************************************************/
+void ImageClose(const ImageItem* item_p)
+{
+    if ((OS_NULL != item_p->path_p) && (OS_NULL != file_hd)) {
+        OS_FileClose(&file_hd);
+        file_hd = OS_NULL;
+    }
+    is_image_open = OS_FALSE;
+}
+
+/*****************************************************************************/
+Status ImageRead(const ImageItem* item_p)
+{
+const U32 remain = state.size - TRAILER_SIZE - state.pos;
+U32 len;
+Status s = S_UNDEF;
+
+    if (OS_NULL != item_p->path_p) {
+        len = (APP_IMAGE_VERIFY_CHUNK_SIZE < remain) ? APP_IMAGE_VERIFY_CHUNK_SIZE : remain;
+        IF_STATUS(s = OS_FileRead(file_hd, buf_p, len)) { return s; }
+        state.crc = Crc32Delta(buf_p, len, state.crc);
+    } else {
+        //No copy: CRC straight from the memory.
+        len = (APP_IMAGE_VERIFY_BLOCK_SIZE < remain) ? APP_IMAGE_VERIFY_BLOCK_SIZE : remain;
+        state.crc = Crc32Delta((U8*)(uintptr_t)item_p->addr + state.pos, len, state.crc);
+    }
+    state.pos   += len;
+    state.bytes += len;
+    image_verify_stats.bytes = state.bytes;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void ImageEnd(const ImageVerifyResult result)
+{
+    state.results[state.idx] = result;
+    if (IMAGE_VERIFY_RESULT_MISMATCH == result) {
+        OS_LOG_S(D_WARNING, S_IMAGE_VERIFY_MISMATCH);
+        OS_LOG(D_WARNING, "%s", images_v[state.idx].name_p);
+    }
+    ++state.idx;
+    state.pos   = 0;
+    state.size  = 0;
+    state.crc   = CRC32_POLYNOMIAL;
+}
+
+/*****************************************************************************/
+void PassEnd(void)
+{
+const U32 busy_ms = (0 == state.busy_ms) ? 1 : state.busy_ms;
+    image_verify_stats.rate_kbs = (U32)(((U64)state.bytes * 1000) / 1024 / busy_ms);
+    image_verify_stats.is_active= OS_FALSE;
+    ++image_verify_stats.passes;
+    OS_FreeEx(buf_p, APP_IMAGE_VERIFY_MEMORY);
+    buf_p = OS_NULL;
+    OS_LOG(D_INFO, "%u KB in %u ms: %u.%02u MB/s", state.bytes / 1024, state.busy_ms,
+           image_verify_stats.rate_kbs / 1024, ((image_verify_stats.rate_kbs % 1024) * 100) / 1024);
+}
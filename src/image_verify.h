@@ -0,0 +1,71 @@
+/***************************************************************************//**
+* @file    image_verify.h
+* @brief   Firmware/images integrity verification.
+* @author  A. Filyanov
+* @details Image carries its CRC32 (as Crc32(), little-endian) in the last
+*          4 bytes. Verification is done in time sliced steps (BgServ) and
+*          the partial CRC state is saved on the power down to be resumed
+*          on the next startup.
+*******************************************************************************/
+#ifndef _IMAGE_VERIFY_H_
+#define _IMAGE_VERIFY_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+//-----------------------------------------------------------------------------
+enum {
+    S_IMAGE_VERIFY_UNDEF = S_MODULE,
+    S_IMAGE_VERIFY_MISMATCH,
+    S_IMAGE_VERIFY_NO_CRC,
+    S_IMAGE_VERIFY_LAST
+};
+
+typedef enum {
+    IMAGE_VERIFY_RESULT_UNKNOWN,
+    IMAGE_VERIFY_RESULT_OK,
+    IMAGE_VERIFY_RESULT_NO_CRC,         // Trailer is erased.
+    IMAGE_VERIFY_RESULT_MISMATCH,
+    IMAGE_VERIFY_RESULT_ERROR,          // Image is absent/unreadable.
+    IMAGE_VERIFY_RESULT_LAST
+} ImageVerifyResult;
+
+typedef struct {
+    U32             bytes;
+    U32             busy_ms;            // Verification (not wall) time.
+    U32             rate_kbs;           // KB/s of the last complete pass.
+    U16             passes;
+    U16             resumes;
+    Bool            is_active;
+} ImageVerifyStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init images verification (resume the saved state).
+/// @return     #Status.
+Status          ImageVerifyInit(void);
+
+/// @brief      Start images verification pass.
+/// @return     #Status.
+Status          ImageVerifyStart(void);
+
+/// @brief      Do a time slice of the pending verification (BgServ context).
+/// @return     Work is pending.
+Bool            ImageVerifyStep(void);
+
+/// @brief      Save the pending verification state.
+/// @return     #Status.
+Status          ImageVerifySuspend(void);
+
+/// @brief      Get images verification statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          ImageVerifyStatsGet(ImageVerifyStats* stats_p);
+
+/// @brief      Get image verification result.
+/// @param[in]  idx            Image index.
+/// @param[out] name_pp        Image name.
+/// @param[out] result_p       Result.
+/// @return     #Status.
+Status          ImageVerifyResultGet(const Size idx, ConstStrP* name_pp, ImageVerifyResult* result_p);
+
+#endif // _IMAGE_VERIFY_H_
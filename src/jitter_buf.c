@@ -0,0 +1,301 @@
+/***************************************************************************//**
+* @file    jitter_buf.c
+* @brief   Adaptive jitter buffer.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "app_common.h"
+#include "jitter_buf.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "jitter_buf"
+
+// Target depth = minimum depth + JITTER_DEPTH_FACTOR * smoothed jitter.
+#define JITTER_DEPTH_FACTOR     4
+// Drift control: occupancy error dead band and ppm limits.
+#define DRIFT_DEAD_BAND_PERMILLE 50
+#define DRIFT_PPM_MAX           2000
+#define DRIFT_INTEG_MAX         (DRIFT_PPM_MAX * 64)
+#define PPM                     1000000UL
+
+//-----------------------------------------------------------------------------
+static void     RingCopyOut(const JitterBuf* jb_p, U8* data_p, const Size size);
+static void     RingProduce(JitterBuf* jb_p, const Size size);
+static void     RingConsume(JitterBuf* jb_p, const Size size);
+static void     ArrivalUpdate(JitterBuf* jb_p, const Size size, const OS_TimeMs now_ms);
+static void     DepthTargetUpdate(JitterBuf* jb_p);
+static void     DriftUpdate(JitterBuf* jb_p);
+
+/*****************************************************************************/
+Status JitterBufInit(JitterBuf* jb_p, void* mem_p, const Size size, const U32 byte_rate,
+                     const U32 depth_min_ms, const U32 depth_max_ms)
+{
+    if ((OS_NULL == jb_p) || (OS_NULL == mem_p)) { return S_INVALID_PTR; }
+    if ((0 == size) || (0 == byte_rate) || (depth_min_ms > depth_max_ms)) { return S_INVALID_VALUE; }
+    OS_MemSet(jb_p, 0, sizeof(JitterBuf));
+    jb_p->buf_p         = (U8*)mem_p;
+    jb_p->size          = size;
+    jb_p->byte_rate     = byte_rate;
+    jb_p->depth_min_ms  = depth_min_ms;
+    jb_p->depth_max_ms  = depth_max_ms;
+    JitterBufReset(jb_p);
+    return S_OK;
+}
+
+/*****************************************************************************/
+void JitterBufReset(JitterBuf* jb_p)
+{
+U32 primask;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    jb_p->rd = jb_p->wr = jb_p->level = 0;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    jb_p->jitter_ms_q4      = 0;
+    jb_p->drift_ppm         = 0;
+    jb_p->drift_integ       = 0;
+    jb_p->drift_phase       = 0;
+    jb_p->is_prebuffering   = OS_TRUE;
+    jb_p->is_arrival_valid  = OS_FALSE;
+    DepthTargetUpdate(jb_p);
+}
+
+/*****************************************************************************/
+void JitterBufDrain(JitterBuf* jb_p)
+{
+    jb_p->is_prebuffering = OS_FALSE;
+}
+
+/*****************************************************************************/
+void JitterBufByteRateSet(JitterBuf* jb_p, const U32 byte_rate)
+{
+    if (0 != byte_rate) {
+        jb_p->byte_rate = byte_rate;
+        DepthTargetUpdate(jb_p);
+    }
+}
+
+/*****************************************************************************/
+Size JitterBufWrite(JitterBuf* jb_p, const U8* data_p, const Size size, const OS_TimeMs now_ms)
+{
+Size free = JitterBufFreeGet(jb_p);
+Size wr_size = (size > free) ? free : size;
+Size chunk;
+
+    if (wr_size < size) { ++jb_p->stats.overflows; }
+    ArrivalUpdate(jb_p, size, now_ms);
+    if (0 == wr_size) { return 0; }
+    chunk = jb_p->size - jb_p->wr;
+    if (chunk > wr_size) { chunk = wr_size; }
+    OS_MemCpy(jb_p->buf_p + jb_p->wr, data_p, chunk);
+    OS_MemCpy(jb_p->buf_p, data_p + chunk, wr_size - chunk);
+    RingProduce(jb_p, wr_size);
+    return wr_size;
+}
+
+/*****************************************************************************/
+U8* JitterBufWriteReserve(JitterBuf* jb_p, Size* size_p)
+{
+const Size free = JitterBufFreeGet(jb_p);
+Size chunk = jb_p->size - jb_p->wr;
+    if (chunk > free) { chunk = free; }
+    *size_p = chunk;
+    return (jb_p->buf_p + jb_p->wr);
+}
+
+/*****************************************************************************/
+void JitterBufWriteCommit(JitterBuf* jb_p, const Size size, const OS_TimeMs now_ms)
+{
+    ArrivalUpdate(jb_p, size, now_ms);
+    RingProduce(jb_p, size);
+}
+
+/*****************************************************************************/
+Size JitterBufFreeGet(const JitterBuf* jb_p)
+{
+    return (jb_p->size - jb_p->level);
+}
+
+/*****************************************************************************/
+Size JitterBufRead(JitterBuf* jb_p, U8* data_p, const Size size)
+{
+Size rd_size = size;
+const Size level = jb_p->level;
+
+    if (jb_p->is_prebuffering) {
+        if (level < jb_p->depth_target) { return 0; }
+        jb_p->is_prebuffering = OS_FALSE;
+    }
+    if (level < rd_size) {
+        //Underrun: hand out the rest and prebuffer again.
+        ++jb_p->stats.underruns;
+        jb_p->is_prebuffering = OS_TRUE;
+        rd_size = level;
+    }
+    RingCopyOut(jb_p, data_p, rd_size);
+    RingConsume(jb_p, rd_size);
+    return rd_size;
+}
+
+/*****************************************************************************/
+Size JitterBufReadPcm(JitterBuf* jb_p, U8* data_p, const Size frames, const Size frame_size)
+{
+Size frames_in = frames;
+Size frames_out = frames;
+S32 adjust = 0;
+Size level;
+
+    if (jb_p->is_prebuffering) {
+        if (jb_p->level < jb_p->depth_target) { return 0; }
+        jb_p->is_prebuffering = OS_FALSE;
+    }
+    DriftUpdate(jb_p);
+    //The backlog of the other direction is dropped on the drift sign change.
+    if (((0 < jb_p->drift_ppm) && (0 > jb_p->drift_phase)) ||
+        ((0 > jb_p->drift_ppm) && (0 < jb_p->drift_phase))) {
+        jb_p->drift_phase = 0;
+    }
+    jb_p->drift_phase += jb_p->drift_ppm * (S32)frames;
+    //All the whole frames due are applied (at least one frame is read).
+    if (1 < frames) {
+        adjust = jb_p->drift_phase / (S32)PPM;
+        if (adjust >  ((S32)frames - 1)) { adjust =  ((S32)frames - 1); }
+        if (adjust < -((S32)frames - 1)) { adjust = -((S32)frames - 1); }
+        jb_p->drift_phase -= adjust * (S32)PPM;
+    }
+    if (jb_p->drift_phase >  (S32)PPM) { jb_p->drift_phase =  (S32)PPM; }
+    if (jb_p->drift_phase < -(S32)PPM) { jb_p->drift_phase = -(S32)PPM; }
+    frames_in += adjust;
+    level = jb_p->level / frame_size;
+    if (level < frames_in) {
+        ++jb_p->stats.underruns;
+        jb_p->is_prebuffering = OS_TRUE;
+        jb_p->drift_phase = 0;
+        frames_in = frames_out = level;
+        adjust = 0;
+    }
+    if (0 < adjust) {
+        //Drop: skip the last input sample frames.
+        RingCopyOut(jb_p, data_p, frames_out * frame_size);
+        jb_p->stats.frames_dropped += adjust;
+    } else if (0 > adjust) {
+        //Repeat: duplicate the last input sample frame.
+        RingCopyOut(jb_p, data_p, frames_in * frame_size);
+        for (Size i = frames_in; i < frames_out; ++i) {
+            OS_MemCpy(data_p + (i * frame_size), data_p + ((frames_in - 1) * frame_size), frame_size);
+        }
+        jb_p->stats.frames_repeated += -adjust;
+    } else {
+        RingCopyOut(jb_p, data_p, frames_out * frame_size);
+    }
+    RingConsume(jb_p, frames_in * frame_size);
+    return frames_out;
+}
+
+/*****************************************************************************/
+Size JitterBufPeek(const JitterBuf* jb_p, U8* data_p, const Size size)
+{
+const Size level = jb_p->level;
+const Size peek_size = (level < size) ? level : size;
+    RingCopyOut(jb_p, data_p, peek_size);
+    return peek_size;
+}
+
+/*****************************************************************************/
+Size JitterBufLevelGet(const JitterBuf* jb_p)
+{
+    return jb_p->level;
+}
+
+/*****************************************************************************/
+U32 JitterBufDepthTargetMsGet(const JitterBuf* jb_p)
+{
+    return (U32)(((U64)jb_p->depth_target * 1000) / jb_p->byte_rate);
+}
+
+/*****************************************************************************/
+Bool JitterBufIsPrebuffering(const JitterBuf* jb_p)
+{
+    return jb_p->is_prebuffering;
+}
+
+/*****************************************************************************/
+void RingCopyOut(const JitterBuf* jb_p, U8* data_p, const Size size)
+{
+Size chunk = jb_p->size - jb_p->rd;
+    if (chunk > size) { chunk = size; }
+    OS_MemCpy(data_p, jb_p->buf_p + jb_p->rd, chunk);
+    OS_MemCpy(data_p + chunk, jb_p->buf_p, size - chunk);
+}
+
+/*****************************************************************************/
+void RingProduce(JitterBuf* jb_p, const Size size)
+{
+U32 primask;
+    jb_p->wr = (jb_p->wr + size) % jb_p->size;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    jb_p->level += size;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    if (jb_p->level > jb_p->stats.level_max) { jb_p->stats.level_max = jb_p->level; }
+    jb_p->stats.bytes_in += size;
+}
+
+/*****************************************************************************/
+void RingConsume(JitterBuf* jb_p, const Size size)
+{
+U32 primask;
+    jb_p->rd = (jb_p->rd + size) % jb_p->size;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    jb_p->level -= size;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    jb_p->stats.bytes_out += size;
+}
+
+/*****************************************************************************/
+void ArrivalUpdate(JitterBuf* jb_p, const Size size, const OS_TimeMs now_ms)
+{
+    //Arrival jitter (RFC 3550 style): deviation of the inter-arrival gap
+    //from the play time of the previously arrived data.
+    if (jb_p->is_arrival_valid) {
+        const U32 gap_ms    = now_ms - jb_p->arrival_last_ms;
+        const U32 expect_ms = (U32)(((U64)jb_p->arrival_last_size * 1000) / jb_p->byte_rate);
+        const U32 dev_ms    = (gap_ms > expect_ms) ? (gap_ms - expect_ms) : (expect_ms - gap_ms);
+        jb_p->jitter_ms_q4 += (S32)((dev_ms << 4) - jb_p->jitter_ms_q4) / 16;
+        if (gap_ms > JitterBufDepthTargetMsGet(jb_p)) {
+            ++jb_p->stats.late_packets;
+        }
+        DepthTargetUpdate(jb_p);
+    }
+    jb_p->arrival_last_ms   = now_ms;
+    jb_p->arrival_last_size = size;
+    jb_p->is_arrival_valid  = OS_TRUE;
+}
+
+/*****************************************************************************/
+void DepthTargetUpdate(JitterBuf* jb_p)
+{
+U32 depth_ms = jb_p->depth_min_ms + ((JITTER_DEPTH_FACTOR * jb_p->jitter_ms_q4) >> 4);
+U32 depth;
+    if (depth_ms > jb_p->depth_max_ms) { depth_ms = jb_p->depth_max_ms; }
+    depth = (U32)(((U64)depth_ms * jb_p->byte_rate) / 1000);
+    //Leave the room for the jitter itself.
+    if (depth > ((jb_p->size * 3) / 4)) { depth = (jb_p->size * 3) / 4; }
+    jb_p->depth_target = depth;
+}
+
+/*****************************************************************************/
+void DriftUpdate(JitterBuf* jb_p)
+{
+S32 err_permille;
+    if (0 == jb_p->depth_target) { return; }
+    //Occupancy error relative to the target depth.
+    err_permille = (S32)(((S64)((S32)jb_p->level - (S32)jb_p->depth_target) * 1000) / (S32)jb_p->depth_target);
+    if ((DRIFT_DEAD_BAND_PERMILLE > err_permille) && (-DRIFT_DEAD_BAND_PERMILLE < err_permille)) {
+        err_permille = 0;
+    }
+    //PI controller: proportional part reacts to the jitter bursts,
+    //integral one tracks the steady sender/receiver clock offset.
+    jb_p->drift_integ += err_permille;
+    if (jb_p->drift_integ >  DRIFT_INTEG_MAX) { jb_p->drift_integ =  DRIFT_INTEG_MAX; }
+    if (jb_p->drift_integ < -DRIFT_INTEG_MAX) { jb_p->drift_integ = -DRIFT_INTEG_MAX; }
+    jb_p->drift_ppm = (2 * err_permille) + (jb_p->drift_integ / 64);
+    if (jb_p->drift_ppm >  DRIFT_PPM_MAX) { jb_p->drift_ppm =  DRIFT_PPM_MAX; }
+    if (jb_p->drift_ppm < -DRIFT_PPM_MAX) { jb_p->drift_ppm = -DRIFT_PPM_MAX; }
+}
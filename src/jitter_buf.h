@@ -0,0 +1,133 @@
+/***************************************************************************//**
+* @file    jitter_buf.h
+* @brief   Adaptive jitter buffer.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _JITTER_BUF_H_
+#define _JITTER_BUF_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    U32             bytes_in;
+    U32             bytes_out;
+    U32             underruns;
+    U32             late_packets;
+    U32             overflows;
+    U32             frames_dropped; // drift compensation
+    U32             frames_repeated;// drift compensation
+    U32             level_max;
+} JitterBufStats;
+
+typedef struct {
+    U8*             buf_p;
+    Size            size;
+    volatile Size   rd;
+    volatile Size   wr;
+    volatile Size   level;
+    U32             byte_rate;      // Stream bytes per second.
+    U32             depth_min_ms;
+    U32             depth_max_ms;
+    U32             depth_target;   // bytes
+    U32             jitter_ms_q4;   // Smoothed arrival jitter, Q4.
+    OS_TimeMs       arrival_last_ms;
+    Size            arrival_last_size;
+    S32             drift_ppm;      // >0 - consume faster (drop), <0 - slower (repeat).
+    S32             drift_integ;
+    S32             drift_phase;    // ppm x frames: >0 - frames to drop, <0 - to repeat.
+    Bool            is_prebuffering;
+    Bool            is_arrival_valid;
+    JitterBufStats  stats;
+} JitterBuf;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init jitter buffer.
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[in]  mem_p          Storage memory.
+/// @param[in]  size           Storage memory size.
+/// @param[in]  byte_rate      Stream byte rate (bytes per second).
+/// @param[in]  depth_min_ms   Minimum target depth (ms).
+/// @param[in]  depth_max_ms   Maximum target depth (ms).
+/// @return     #Status.
+Status          JitterBufInit(JitterBuf* jb_p, void* mem_p, const Size size, const U32 byte_rate,
+                              const U32 depth_min_ms, const U32 depth_max_ms);
+
+/// @brief      Reset jitter buffer content and adaptation state (statistics are kept).
+/// @param[in]  jb_p           Jitter buffer.
+void            JitterBufReset(JitterBuf* jb_p);
+
+/// @brief      Drain buffer: hand out the rest of the data below the target depth (end of stream).
+/// @param[in]  jb_p           Jitter buffer.
+void            JitterBufDrain(JitterBuf* jb_p);
+
+/// @brief      Set the stream byte rate.
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[in]  byte_rate      Stream byte rate (bytes per second).
+void            JitterBufByteRateSet(JitterBuf* jb_p, const U32 byte_rate);
+
+/// @brief      Write arrived data (producer side).
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[in]  data_p         Data.
+/// @param[in]  size           Data size.
+/// @param[in]  now_ms         Arrival time.
+/// @return     Written size (less than size on overflow).
+Size            JitterBufWrite(JitterBuf* jb_p, const U8* data_p, const Size size, const OS_TimeMs now_ms);
+
+/// @brief      Reserve contiguous free space for a zero-copy write (producer side).
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[out] size_p         Reserved size.
+/// @return     Write pointer.
+U8*             JitterBufWriteReserve(JitterBuf* jb_p, Size* size_p);
+
+/// @brief      Commit data written to the reserved space (producer side).
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[in]  size           Written size.
+/// @param[in]  now_ms         Arrival time.
+void            JitterBufWriteCommit(JitterBuf* jb_p, const Size size, const OS_TimeMs now_ms);
+
+/// @brief      Get free space for the producer.
+/// @param[in]  jb_p           Jitter buffer.
+/// @return     Free space size.
+Size            JitterBufFreeGet(const JitterBuf* jb_p);
+
+/// @brief      Read buffered data (consumer side).
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[out] data_p         Data.
+/// @param[in]  size           Data size.
+/// @return     Read size (0 while prebuffering).
+Size            JitterBufRead(JitterBuf* jb_p, U8* data_p, const Size size);
+
+/// @brief      Read PCM sample frames with clock-drift compensation.
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[out] data_p         Data.
+/// @param[in]  frames         Output sample frames count.
+/// @param[in]  frame_size     Sample frame size (bytes).
+/// @return     Output sample frames count.
+/// @details    Drops or repeats the whole sample frames accumulated in the
+///             drift phase when the occupancy drifts away from the target depth.
+Size            JitterBufReadPcm(JitterBuf* jb_p, U8* data_p, const Size frames, const Size frame_size);
+
+/// @brief      Peek buffered data without consuming it.
+/// @param[in]  jb_p           Jitter buffer.
+/// @param[out] data_p         Data.
+/// @param[in]  size           Data size.
+/// @return     Peeked size.
+Size            JitterBufPeek(const JitterBuf* jb_p, U8* data_p, const Size size);
+
+/// @brief      Get buffered data level.
+/// @param[in]  jb_p           Jitter buffer.
+/// @return     Level (bytes).
+Size            JitterBufLevelGet(const JitterBuf* jb_p);
+
+/// @brief      Get current target depth.
+/// @param[in]  jb_p           Jitter buffer.
+/// @return     Target depth (ms).
+U32             JitterBufDepthTargetMsGet(const JitterBuf* jb_p);
+
+/// @brief      Is buffer prebuffering up to the target depth.
+/// @param[in]  jb_p           Jitter buffer.
+/// @return     Is prebuffering.
+Bool            JitterBufIsPrebuffering(const JitterBuf* jb_p);
+
+#endif // _JITTER_BUF_H_
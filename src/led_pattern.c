@@ -0,0 +1,85 @@
+/***************************************************************************//**
+* @file    led_pattern.c
+* @brief   LED patterns engine.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "led_pattern.h"
+
+//-----------------------------------------------------------------------------
+#define LED_PATTERN_DEF(name, steps)    { name, steps, ITEMS_COUNT_GET(steps, LedStep) }
+// Software PWM frame (20 ms) of the on/off only LED.
+#define LED_PWM(on_ms)                  LED_STEP_ON(on_ms), LED_STEP_OFF(20 - (on_ms))
+
+//-----------------------------------------------------------------------------
+static U32      EdgeTimeGet(LedPatternPlayer* player_p);
+
+//-----------------------------------------------------------------------------
+static const LedStep off_v[]        = { LED_STEP_OFF(0) };
+static const LedStep on_v[]         = { LED_STEP_ON(0) };
+static const LedStep heartbeat_v[]  = { LED_STEP_ON(50), LED_STEP_OFF(1950) };
+static const LedStep blink_v[]      = { LED_STEP_ON(250), LED_STEP_OFF(250) };
+static const LedStep breathe_v[]    = { LED_PWM(2),  LED_PWM(2),  LED_PWM(4),  LED_PWM(6),  LED_PWM(8),
+                                        LED_PWM(10), LED_PWM(12), LED_PWM(14), LED_PWM(16), LED_PWM(18),
+                                        LED_STEP_ON(100),
+                                        LED_PWM(18), LED_PWM(16), LED_PWM(14), LED_PWM(12), LED_PWM(10),
+                                        LED_PWM(8),  LED_PWM(6),  LED_PWM(4),  LED_PWM(2),  LED_PWM(2),
+                                        LED_STEP_OFF(400) };
+static const LedStep code_1_v[]     = { LED_STEP_ON(200), LED_STEP_OFF(1500) };
+static const LedStep code_2_v[]     = { LED_STEP_ON(200), LED_STEP_OFF(300), LED_STEP_ON(200), LED_STEP_OFF(1500) };
+static const LedStep code_3_v[]     = { LED_STEP_ON(200), LED_STEP_OFF(300), LED_STEP_ON(200), LED_STEP_OFF(300),
+                                        LED_STEP_ON(200), LED_STEP_OFF(1500) };
+
+//Indexed by #LedPatternId.
+static const LedPattern patterns_v[] = {
+    LED_PATTERN_DEF("off",      off_v),
+    LED_PATTERN_DEF("on",       on_v),
+    LED_PATTERN_DEF("heartbeat",heartbeat_v),
+    LED_PATTERN_DEF("blink",    blink_v),
+    LED_PATTERN_DEF("breathe",  breathe_v),
+    LED_PATTERN_DEF("code1",    code_1_v),
+    LED_PATTERN_DEF("code2",    code_2_v),
+    LED_PATTERN_DEF("code3",    code_3_v),
+};
+
+/*****************************************************************************/
+const LedPattern* LedPatternGet(const LedPatternId id)
+{
+    if (ITEMS_COUNT_GET(patterns_v, LedPattern) <= id) { return OS_NULL; }
+    return &patterns_v[id];
+}
+
+/*****************************************************************************/
+U32 LedPatternStart(LedPatternPlayer* player_p, const LedPattern* pattern_p)
+{
+    player_p->pattern_p = pattern_p;
+    player_p->step_idx  = 0;
+    player_p->level     = LED_STEP_LEVEL(pattern_p->steps_p[0]);
+    return EdgeTimeGet(player_p);
+}
+
+/*****************************************************************************/
+U32 LedPatternStep(LedPatternPlayer* player_p)
+{
+const LedPattern* pattern_p = player_p->pattern_p;
+    if ((OS_NULL == pattern_p) || (0 == LED_STEP_MS(pattern_p->steps_p[player_p->step_idx]))) { return 0; }
+    player_p->step_idx = (player_p->step_idx + 1) % pattern_p->steps_count;
+    player_p->level    = LED_STEP_LEVEL(pattern_p->steps_p[player_p->step_idx]);
+    return EdgeTimeGet(player_p);
+}
+
+/*****************************************************************************/
+U32 EdgeTimeGet(LedPatternPlayer* player_p)
+{
+const LedPattern* pattern_p = player_p->pattern_p;
+U32 time_ms = LED_STEP_MS(pattern_p->steps_p[player_p->step_idx]);
+
+    //Steps of the same level are one edge (no wakeup without the level change).
+    while ((0 != time_ms) && (U16_MAX > time_ms)) {
+        const U8 idx = (player_p->step_idx + 1) % pattern_p->steps_count;
+        const LedStep step = pattern_p->steps_p[idx];
+        if ((player_p->level != LED_STEP_LEVEL(step)) || (0 == LED_STEP_MS(step))) { break; }
+        time_ms += LED_STEP_MS(step);
+        player_p->step_idx = idx;
+    }
+    return time_ms;
+}
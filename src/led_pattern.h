@@ -0,0 +1,64 @@
+/***************************************************************************//**
+* @file    led_pattern.h
+* @brief   LED patterns engine.
+* @author  A. Filyanov
+* @details Pattern is a table of steps (level + duration). The engine only
+*          tells the level and the time to the next edge, so the LED owner
+*          sleeps till the edge (no periodic polling).
+*******************************************************************************/
+#ifndef _LED_PATTERN_H_
+#define _LED_PATTERN_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+// Step: level (bit 15) and duration (ms, 0 - hold forever).
+typedef U16 LedStep;
+
+#define LED_STEP_ON(ms)         ((LedStep)(0x8000 | ((ms) & 0x7FFF)))
+#define LED_STEP_OFF(ms)        ((LedStep)((ms) & 0x7FFF))
+#define LED_STEP_LEVEL(step)    ((0x8000 & (step)) ? ON : OFF)
+#define LED_STEP_MS(step)       ((step) & 0x7FFF)
+
+typedef enum {
+    LED_PATTERN_OFF,
+    LED_PATTERN_ON,
+    LED_PATTERN_HEARTBEAT,
+    LED_PATTERN_BLINK,
+    LED_PATTERN_BREATHE,
+    LED_PATTERN_CODE_1,                 // Status codes: N flashes and a pause.
+    LED_PATTERN_CODE_2,
+    LED_PATTERN_CODE_3,
+    LED_PATTERN_LAST
+} LedPatternId;
+
+typedef struct {
+    ConstStrP       name_p;
+    const LedStep*  steps_p;
+    U8              steps_count;
+} LedPattern;
+
+typedef struct {
+    const LedPattern* pattern_p;
+    U8              step_idx;
+    State           level;
+} LedPatternPlayer;
+
+//-----------------------------------------------------------------------------
+/// @brief      Get pattern.
+/// @param[in]  id             Pattern id.
+/// @return     Pattern (OS_NULL if unknown).
+const LedPattern* LedPatternGet(const LedPatternId id);
+
+/// @brief      Start the pattern (first step).
+/// @param[out] player_p       Player.
+/// @param[in]  pattern_p      Pattern.
+/// @return     Time to the next edge (ms, 0 - none).
+U32             LedPatternStart(LedPatternPlayer* player_p, const LedPattern* pattern_p);
+
+/// @brief      Go to the next edge.
+/// @param[in]  player_p       Player.
+/// @return     Time to the next edge (ms, 0 - none).
+U32             LedPatternStep(LedPatternPlayer* player_p);
+
+#endif // _LED_PATTERN_H_
@@ -10,6 +10,13 @@
 #include "os_startup.h"
 #include "version.h"
 #include "os_shell_commands_app.h"
+#include "audio_buf_pool.h"
+#include "msg_pool.h"
+#include "crc32.h"
+#include "audio_eq.h"
+#include "dlog.h"
+#include "prof.h"
+#include "boot_timeline.h"
 #if (1 == OS_TEST_ENABLED)
 #include "test_main.h"
 #endif // OS_TEST_ENABLED
@@ -26,12 +33,19 @@ static Status       Init(void);
 /// @return         #Status.
 static Status       APP_Init(void);
 
+/// @brief          Init the device applications (deferred part).
+/// @return         #Status.
+/// @details        Is not needed before the tasks start: BgServ runs it.
+Status              APP_InitDeferred(void);
+
 /******************************************************************************/
 void main(void)
 {
+    BootTimelineInit();
     // Init the device and it's applications.
     IF_STATUS(Init()) { HAL_ASSERT(OS_FALSE); }
     HAL_LOG(D_INFO, "OS scheduler start...");
+    BootMark("Scheduler start");
     OS_SchedulerStart();
     HAL_ASSERT(OS_FALSE);
 }
@@ -42,8 +56,10 @@ Status Init(void)
 Status s;
     // Hardware init.
     IF_STATUS(s = HAL_Init_())  { return s; }
+    BootMark("HAL");
     // OS init.
     IF_STATUS(s = OSAL_Init())  { return s; }
+    BootMark("OSAL");
     // Application init.
     IF_STATUS(s = APP_Init())   { return s; }
     return s;
@@ -52,18 +68,53 @@ Status s;
 /******************************************************************************/
 Status APP_Init(void)
 {
-extern const OS_TaskConfig task_a_ko_cfg, task_b_ko_cfg, task_netserv_cfg;
-extern Status AudioCodecInit_(void);
+extern const OS_TaskConfig task_a_ko_cfg, task_b_ko_cfg, task_netserv_cfg, task_bgserv_cfg;
 Status s = S_UNDEF;
+    //Log records may be put from the very start.
+    IF_STATUS(s = DLogInit()) { return s; }
+#if (APP_PROF_ENABLED)
+    IF_STATUS(s = ProfInit()) { return s; }
+#endif //(APP_PROF_ENABLED)
+    Crc32Init();
 #if (OS_AUDIO_ENABLED)
-    IF_STATUS(s = AudioCodecInit_()) { return s; }
+extern const OS_TaskConfig task_mmplay_ctl_cfg;
+    IF_STATUS(s = AudioBufPoolInit()) { return s; }
+    BootMark("Audio buffers");
 #endif //(OS_AUDIO_ENABLED)
-    IF_STATUS(s = OS_ShellCommandsAppInit()) { return s; }
+    IF_STATUS(s = MsgPoolInit()) { return s; }
+    BootMark("Messages pool");
     // Add application tasks to the system startup.
     IF_STATUS(s = OS_StartupTaskAdd(&task_netserv_cfg)) { return s; }
+    IF_STATUS(s = OS_StartupTaskAdd(&task_bgserv_cfg)) { return s; }
+#if (OS_AUDIO_ENABLED)
+    IF_STATUS(s = OS_StartupTaskAdd(&task_mmplay_ctl_cfg)) { return s; }
+#endif //(OS_AUDIO_ENABLED)
 //    IF_STATUS(s = OS_StartupTaskAdd(&task_a_ko_cfg)) { return s; }
 //    IF_STATUS(s = OS_StartupTaskAdd(&task_b_ko_cfg)) { return s; }
+    BootMark("Tasks add");
+#if (1 == OS_TEST_ENABLED)
+    // Tests.
+    HAL_LOG(D_INFO, "Tests run...\n");
+    TestsRun();
+    HAL_LOG(D_INFO, "-------------------------------");
+    BootMark("Tests");
+#endif // OS_TEST_ENABLED
+    return s;
+}
 
+/******************************************************************************/
+Status APP_InitDeferred(void)
+{
+extern Status AudioCodecInit_(void);
+Status s = S_UNDEF;
+#if (OS_AUDIO_ENABLED)
+    //Play requests fail with S_INVALID_STATE till the codecs are ready.
+    IF_STATUS(s = AudioCodecInit_()) { return s; }
+    BootMark("Audio codecs");
+    IF_STATUS(s = AudioEqInit()) { return s; }
+#endif //(OS_AUDIO_ENABLED)
+    IF_STATUS(s = OS_ShellCommandsAppInit()) { return s; }
+    BootMark("Shell commands");
     HAL_LOG(D_INFO, "Application init...");
     HAL_LOG(D_INFO, "-------------------------------");
     HAL_LOG(D_INFO, "Firmware: v%d.%d.%d%s-%s",
@@ -74,11 +125,6 @@ Status s = S_UNDEF;
                      version.rev);
     HAL_LOG(D_INFO, "Built on: %s, %s", __DATE__, __TIME__);
     HAL_LOG(D_INFO, "-------------------------------");
-#if (1 == OS_TEST_ENABLED)
-    // Tests.
-    HAL_LOG(D_INFO, "Tests run...\n");
-    TestsRun();
-    HAL_LOG(D_INFO, "-------------------------------");
-#endif // OS_TEST_ENABLED
+    BootMark("Deferred init");
     return s;
 }
@@ -0,0 +1,567 @@
+/***************************************************************************//**
+* @file    media_convert.c
+* @brief   Media files offline conversion.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_time.h"
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "audio_codec.h"
+#include "media_convert.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "media_convert"
+
+#define CHANNELS_MAX            2
+#define WAV_HEADER_SIZE_MAX     60          // IMA ADPCM (fact chunk).
+#define WAV_FORMAT_PCM          0x0001
+#define WAV_FORMAT_IMA_ADPCM    0x0011
+#define ADPCM_INDEX_MAX         88
+#define ADPCM_PREDICTOR_MAX     32767
+#define ADPCM_PREDICTOR_MIN     (-32768)
+
+//-----------------------------------------------------------------------------
+typedef enum {
+    CONVERT_STATE_IDLE,
+    CONVERT_STATE_NEXT,                 // Next files pair.
+    CONVERT_STATE_OPEN,                 // Background codec instance may be busy.
+    CONVERT_STATE_RUN
+} ConvertState;
+
+typedef struct {
+    S32             predictor;
+    S16             index;
+} AdpcmChannel;
+
+typedef struct {
+    ConvertState    state;
+    MediaConvertJob job;
+    OS_DirHd        dir_hd;
+    Bool            is_dir;
+    Str             path_in[APP_MEDIA_CONVERT_PATH_LEN];
+    Str             path_out[APP_MEDIA_CONVERT_PATH_LEN];
+    OS_FileHd       file_in_hd;
+    OS_FileHd       file_out_hd;
+    AudioCodecHd    codec_hd;
+    AudioFormatInfo info;
+    AudioFrameInfo  frame_info;
+    U32             pos;
+    U32             size;
+    U32             data_size;          // Output data chunk size.
+    U32             samples;            // Per channel.
+    U8*             in_p;
+    U8*             pcm_p;
+    U8*             out_p;
+    Size            out_fill;
+    S16*            block_p;            // ADPCM block input samples.
+    U8*             block_out_p;        // ADPCM block.
+    Size            block_fill;         // Per channel.
+    U16             block_align;
+    U16             block_samples;      // Per channel.
+    AdpcmChannel    adpcm_v[CHANNELS_MAX];
+} MediaConvert;
+
+//-----------------------------------------------------------------------------
+static Status   FileNext(void);
+static Status   FileOpen(void);
+static Status   FileStep(Bool* is_end_p);
+static void     FileEnd(const Status s);
+static void     JobEnd(void);
+static Status   PcmPut(U8* data_p, const Size size);
+static Status   AdpcmPut(const S16* data_p, Size samples);
+static void     AdpcmBlockEncode(void);
+static U8       AdpcmSampleEncode(AdpcmChannel* ch_p, const S16 sample);
+static Status   OutPut(const U8* data_p, Size size);
+static Status   OutFlush(void);
+static Size     WavHeaderMake(U8* hdr_p);
+static void     Put16(U8* p, const U16 v);
+static void     Put32(U8* p, const U32 v);
+
+//-----------------------------------------------------------------------------
+static const S16 adpcm_steps_v[ADPCM_INDEX_MAX + 1] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,
+    19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+    876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+    5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+static const S8 adpcm_index_v[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static MediaConvert convert;
+static MediaConvertStats media_convert_stats;
+
+/*****************************************************************************/
+Status MediaConvertStart(const MediaConvertJob* job_p)
+{
+OS_FileHd file_hd;
+Status s = S_UNDEF;
+
+    if (OS_NULL == job_p) { return S_INVALID_PTR; }
+    if (MEDIA_CONVERT_FORMAT_LAST <= job_p->format) { return S_INVALID_VALUE; }
+    if (CONVERT_STATE_IDLE != convert.state) { return S_INVALID_STATE; }
+    OS_MemSet(&convert, 0, sizeof(convert));
+    convert.job = *job_p;
+    //Directory is the batch.
+    IF_OK(s = OS_FileOpen(&file_hd, convert.job.path_in,
+                          BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        OS_FileClose(&file_hd);
+    } else {
+        IF_STATUS(s = OS_DirOpen(convert.job.path_in, &convert.dir_hd)) { return s; }
+        convert.is_dir = OS_TRUE;
+    }
+    OS_MemSet(&media_convert_stats, 0, sizeof(media_convert_stats));
+    convert.in_p    = OS_MallocEx(APP_MEDIA_CONVERT_READ_SIZE,  APP_MEDIA_CONVERT_MEMORY);
+    convert.pcm_p   = OS_MallocEx(APP_MEDIA_CONVERT_PCM_SIZE,   APP_MEDIA_CONVERT_MEMORY);
+    convert.out_p   = OS_MallocEx(APP_MEDIA_CONVERT_WRITE_SIZE, APP_MEDIA_CONVERT_MEMORY);
+    if ((OS_NULL == convert.in_p) || (OS_NULL == convert.pcm_p) || (OS_NULL == convert.out_p)) {
+        JobEnd();
+        return S_OUT_OF_MEMORY;
+    }
+    media_convert_stats.is_active = OS_TRUE;
+    convert.state = CONVERT_STATE_NEXT;
+    OS_LOG(D_DEBUG, "Start: %s", convert.job.path_in);
+    return S_OK;
+}
+
+/*****************************************************************************/
+void MediaConvertStop(void)
+{
+    if (CONVERT_STATE_RUN == convert.state) { FileEnd(S_OK); }
+    if (CONVERT_STATE_IDLE != convert.state) { JobEnd(); }
+}
+
+/*****************************************************************************/
+Bool MediaConvertStep(void)
+{
+const OS_Tick tick_start = OS_TickCountGet();
+Bool is_end;
+Status s = S_UNDEF;
+
+    if (CONVERT_STATE_IDLE == convert.state) { return OS_FALSE; }
+    while (APP_MEDIA_CONVERT_SLICE_MS > OS_TICKS_TO_MS(OS_TickCountGet() - tick_start)) {
+        if (CONVERT_STATE_NEXT == convert.state) {
+            IF_STATUS(s = FileNext()) {
+                JobEnd();
+                break;
+            }
+            convert.state = CONVERT_STATE_OPEN;
+        }
+        if (CONVERT_STATE_OPEN == convert.state) {
+            s = FileOpen();
+            //The background codec instance is held: wait for it (BgServ polls).
+            if (S_AUDIO_CODEC_BUSY == s) { break; }
+            IF_STATUS(s) {
+                FileEnd(s);
+                continue;
+            }
+            convert.state = CONVERT_STATE_RUN;
+        }
+        IF_STATUS(s = FileStep(&is_end)) {
+            FileEnd(s);
+        } else if (OS_TRUE == is_end) {
+            FileEnd(S_OK);
+        }
+    }
+    media_convert_stats.busy_ms += OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+    return ((CONVERT_STATE_NEXT == convert.state) || (CONVERT_STATE_RUN == convert.state));
+}
+
+/*****************************************************************************/
+Status MediaConvertStatsGet(MediaConvertStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = media_convert_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status FileNext(void)
+{
+OS_FileStats file_stats;
+Size len;
+
+    if (OS_TRUE != convert.is_dir) {
+        //Single file: done once.
+        if (0 != media_convert_stats.files + media_convert_stats.errors) { return S_FS_EOF; }
+        OS_StrCpy(convert.path_in,  convert.job.path_in);
+        OS_StrCpy(convert.path_out, convert.job.path_out);
+        return S_OK;
+    }
+    for (;;) {
+        if ((S_OK != OS_DirRead(convert.dir_hd, &file_stats)) || ('\0' == file_stats.name[0])) { return S_FS_EOF; }
+        if (AUDIO_FORMAT_UNDEF == AudioFormatByNameGet(file_stats.name)) { continue; }
+        len = OS_StrLen(file_stats.name);
+        if (((OS_StrLen(convert.job.path_in)  + 1 + len) >= sizeof(convert.path_in)) ||
+            ((OS_StrLen(convert.job.path_out) + 1 + len) >= sizeof(convert.path_out))) { continue; }
+        OS_StrCpy(convert.path_in, convert.job.path_in);
+        OS_StrCat(convert.path_in, "/");
+        OS_StrCat(convert.path_in, file_stats.name);
+        //Same name with the WAV extension (the supported ones are 3 chars long).
+        OS_StrCpy(convert.path_out, convert.job.path_out);
+        OS_StrCat(convert.path_out, "/");
+        OS_StrCat(convert.path_out, file_stats.name);
+        OS_StrCpy(OS_StrRChr(convert.path_out, '.'), ".wav");
+        //Never overwrite the input.
+        if (!OS_StrCmp(convert.path_in, convert.path_out)) { continue; }
+        return S_OK;
+    }
+}
+
+/*****************************************************************************/
+Status FileOpen(void)
+{
+const OS_AudioInfo* audio_info_p = &convert.info.audio_info;
+const AudioFormat format = AudioFormatByNameGet(convert.path_in);
+Size channels;
+Status s = S_UNDEF;
+
+    if (AUDIO_FORMAT_UNDEF == format) { return S_AUDIO_CODEC_FORMAT_UNSUPPORTED; }
+    convert.codec_hd = AudioCodecGet(format);
+    if (OS_NULL == convert.codec_hd) { return S_INVALID_STATE; }
+    IF_STATUS(s = AudioFileFormatInfoGet(convert.path_in, &convert.info)) { return s; }
+    channels = audio_info_p->channels;
+    if ((0 == channels) || (CHANNELS_MAX < channels)) { return S_AUDIO_CODEC_FORMAT_UNSUPPORTED; }
+    if ((MEDIA_CONVERT_FORMAT_ADPCM == convert.job.format) && (16 != audio_info_p->sample_bits)) {
+        return S_AUDIO_CODEC_FORMAT_UNSUPPORTED;
+    }
+    //Own (background) codec instance: the playback is never blocked by the job.
+    //S_AUDIO_CODEC_BUSY: the background instance is in use.
+    convert.frame_info.is_background = OS_TRUE;
+    IF_STATUS(s = AudioCodecOpen(convert.codec_hd, &convert.frame_info)) { return s; }
+    IF_OK(s = OS_FileOpen(&convert.file_in_hd, convert.path_in,
+                          BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        convert.size = OS_FileSizeGet(convert.file_in_hd);
+        convert.pos  = convert.info.header_size;
+        IF_OK(s = OS_FileLSeek(convert.file_in_hd, convert.pos)) {
+            s = OS_FileOpen(&convert.file_out_hd, convert.path_out,
+                            BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_WRITE));
+        }
+        IF_STATUS(s) { OS_FileClose(&convert.file_in_hd); }
+    }
+    IF_STATUS(s) {
+        AudioCodecClose(convert.codec_hd, &convert.frame_info);
+        return s;
+    }
+    convert.data_size   = 0;
+    convert.samples     = 0;
+    convert.block_fill  = 0;
+    convert.frame_info.buf_in_offset = 0;
+    convert.frame_info.buf_out_size  = 0;
+    if (MEDIA_CONVERT_FORMAT_ADPCM == convert.job.format) {
+        convert.block_align  = APP_MEDIA_CONVERT_ADPCM_BLOCK_SIZE * channels;
+        convert.block_samples= ((APP_MEDIA_CONVERT_ADPCM_BLOCK_SIZE - 4) * 2) + 1;
+        convert.block_p = OS_MallocEx((convert.block_samples * channels * sizeof(S16)) + convert.block_align,
+                                      APP_MEDIA_CONVERT_MEMORY);
+        if (OS_NULL == convert.block_p) {
+            OS_FileClose(&convert.file_out_hd);
+            OS_FileClose(&convert.file_in_hd);
+            AudioCodecClose(convert.codec_hd, &convert.frame_info);
+            return S_OUT_OF_MEMORY;
+        }
+        convert.block_out_p = (U8*)&convert.block_p[convert.block_samples * channels];
+        OS_MemSet(convert.adpcm_v, 0, sizeof(convert.adpcm_v));
+    }
+    //Header space is reserved: the writes stay sector aligned.
+    convert.out_fill = WavHeaderMake(convert.out_p);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status FileStep(Bool* is_end_p)
+{
+const OS_AudioInfo* audio_info_p = &convert.info.audio_info;
+const Size frame_size = audio_info_p->channels * (audio_info_p->sample_bits / 8);
+const Size in_offset = convert.frame_info.buf_in_offset;
+Size len = APP_MEDIA_CONVERT_READ_SIZE - in_offset;
+Size avail;
+Size rest = 0;
+Size pcm_size = APP_MEDIA_CONVERT_PCM_SIZE;
+Status s = S_UNDEF;
+
+    *is_end_p = OS_FALSE;
+    //The file end cuts the read.
+    if ((convert.size - convert.pos) < len) { len = convert.size - convert.pos; }
+    if (0 != len) {
+        s = OS_FileRead(convert.file_in_hd, convert.in_p + in_offset, len);
+        if ((S_OK != s) && (S_FS_EOF != s)) { return s; }
+        convert.pos += len;
+        media_convert_stats.bytes_in += len;
+    }
+    avail = in_offset + len;
+    if (AUDIO_FORMAT_WAV == convert.info.format) {
+        //PCM is copied by the codec: whole sample frames only.
+        rest     = avail % frame_size;
+        avail   -= rest;
+        pcm_size = avail;
+    }
+    if (0 == avail) {
+        *is_end_p = OS_TRUE;
+        return S_OK;
+    }
+    s = AudioCodecDecode(convert.codec_hd, convert.in_p, avail, convert.pcm_p, pcm_size, &convert.frame_info);
+    if ((S_OK != s) && (S_AUDIO_CODEC_OUTPUT_BUFFER_FULL != s)) { return s; }
+    if (AUDIO_FORMAT_WAV == convert.info.format) {
+        OS_MemCpy(convert.in_p, convert.in_p + avail, rest);
+        convert.frame_info.buf_in_offset = rest;
+    }
+    pcm_size = convert.frame_info.buf_out_size;
+    if (0 == pcm_size) {
+        //Tail is not a complete frame.
+        *is_end_p = (convert.size == convert.pos);
+        return S_OK;
+    }
+    convert.samples += pcm_size / frame_size;
+    if (MEDIA_CONVERT_FORMAT_ADPCM == convert.job.format) {
+        return AdpcmPut((S16*)convert.pcm_p, pcm_size / sizeof(S16));
+    }
+    return PcmPut(convert.pcm_p, pcm_size);
+}
+
+/*****************************************************************************/
+void FileEnd(const Status s)
+{
+U8 hdr[WAV_HEADER_SIZE_MAX];
+Status res = s;
+
+    if (CONVERT_STATE_RUN == convert.state) {
+        IF_OK(res) {
+            if ((MEDIA_CONVERT_FORMAT_ADPCM == convert.job.format) && (0 != convert.block_fill)) {
+                //Last block is padded with silence.
+                const Size channels = convert.info.audio_info.channels;
+                OS_MemSet(&convert.block_p[convert.block_fill * channels], 0,
+                          (convert.block_samples - convert.block_fill) * channels * sizeof(S16));
+                AdpcmBlockEncode();
+            }
+        }
+        IF_OK(res) { res = OutFlush(); }
+        IF_OK(res) {
+            IF_OK(res = OS_FileLSeek(convert.file_out_hd, 0)) {
+                res = OS_FileWrite(convert.file_out_hd, hdr, WavHeaderMake(hdr));
+            }
+        }
+        OS_FileClose(&convert.file_out_hd);
+        OS_FileClose(&convert.file_in_hd);
+        AudioCodecClose(convert.codec_hd, &convert.frame_info);
+        OS_FreeEx(convert.block_p, APP_MEDIA_CONVERT_MEMORY);
+        convert.block_p = OS_NULL;
+        media_convert_stats.audio_ms += (U32)(((U64)convert.samples * 1000) / convert.info.audio_info.sample_rate);
+    }
+    IF_OK(res) {
+        ++media_convert_stats.files;
+        OS_LOG(D_DEBUG, "%s -> %s", convert.path_in, convert.path_out);
+    } else {
+        ++media_convert_stats.errors;
+        OS_LOG_S(D_WARNING, res);
+        OS_LOG(D_WARNING, "%s", convert.path_in);
+    }
+    convert.state = CONVERT_STATE_NEXT;
+}
+
+/*****************************************************************************/
+void JobEnd(void)
+{
+const U32 busy_ms = (0 == media_convert_stats.busy_ms) ? 1 : media_convert_stats.busy_ms;
+const U32 rate_kbs = (U32)(((U64)media_convert_stats.bytes_out * 1000) / 1024 / busy_ms);
+const U32 speed_x10 = (U32)(((U64)media_convert_stats.audio_ms * 10) / busy_ms);
+
+    if (OS_TRUE == convert.is_dir) { OS_DirClose(convert.dir_hd); }
+    OS_FreeEx(convert.in_p,  APP_MEDIA_CONVERT_MEMORY);
+    OS_FreeEx(convert.pcm_p, APP_MEDIA_CONVERT_MEMORY);
+    OS_FreeEx(convert.out_p, APP_MEDIA_CONVERT_MEMORY);
+    convert.in_p = convert.pcm_p = convert.out_p = OS_NULL;
+    convert.state = CONVERT_STATE_IDLE;
+    media_convert_stats.is_active = OS_FALSE;
+    OS_LOG(D_INFO, "%u files (%u errors), %u KB in %u ms: %u KB/s, x%u.%u real-time",
+           media_convert_stats.files, media_convert_stats.errors, media_convert_stats.bytes_out / 1024,
+           media_convert_stats.busy_ms, rate_kbs, speed_x10 / 10, speed_x10 % 10);
+}
+
+/*****************************************************************************/
+Status PcmPut(U8* data_p, const Size size)
+{
+    convert.data_size += size;
+    return OutPut(data_p, size);
+}
+
+/*****************************************************************************/
+Status AdpcmPut(const S16* data_p, Size samples)
+{
+const Size channels = convert.info.audio_info.channels;
+Status s = S_OK;
+
+    //Interleaved samples are collected into the blocks.
+    while (0 != samples) {
+        Size len = (convert.block_samples - convert.block_fill) * channels;
+        if (samples < len) { len = samples; }
+        OS_MemCpy(&convert.block_p[convert.block_fill * channels], data_p, len * sizeof(S16));
+        convert.block_fill += len / channels;
+        data_p  += len;
+        samples -= len;
+        if (convert.block_samples == convert.block_fill) {
+            AdpcmBlockEncode();
+            IF_STATUS(s = OutPut(convert.block_out_p, convert.block_align)) { break; }
+        }
+    }
+    return s;
+}
+
+/*****************************************************************************/
+void AdpcmBlockEncode(void)
+{
+const Size channels = convert.info.audio_info.channels;
+U8* p = convert.block_out_p;
+
+    //Block header: the first sample is the predictor.
+    for (Size ch = 0; ch < channels; ++ch) {
+        AdpcmChannel* ch_p = &convert.adpcm_v[ch];
+        ch_p->predictor = convert.block_p[ch];
+        Put16(p, (U16)ch_p->predictor);
+        p[2] = (U8)ch_p->index;
+        p[3] = 0;
+        p += 4;
+    }
+    //8 samples (4 bytes) per channel in turn.
+    for (Size i = 1; i < convert.block_samples; i += 8) {
+        for (Size ch = 0; ch < channels; ++ch) {
+            AdpcmChannel* ch_p = &convert.adpcm_v[ch];
+            const S16* sample_p = &convert.block_p[(i * channels) + ch];
+            for (Size j = 0; j < 4; ++j) {
+                const U8 lo = AdpcmSampleEncode(ch_p, sample_p[0]);
+                const U8 hi = AdpcmSampleEncode(ch_p, sample_p[channels]);
+                *p++ = (U8)(lo | (hi << 4));
+                sample_p += channels * 2;
+            }
+        }
+    }
+    convert.data_size += convert.block_align;
+    convert.block_fill = 0;
+}
+
+/*****************************************************************************/
+U8 AdpcmSampleEncode(AdpcmChannel* ch_p, const S16 sample)
+{
+S32 diff = sample - ch_p->predictor;
+S32 step = adpcm_steps_v[ch_p->index];
+S32 vpdiff = step >> 3;
+U8 code = 0;
+
+    if (0 > diff) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) { code |= 4; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; vpdiff += step; }
+    ch_p->predictor += (code & 8) ? -vpdiff : vpdiff;
+    if (ADPCM_PREDICTOR_MAX < ch_p->predictor) {
+        ch_p->predictor = ADPCM_PREDICTOR_MAX;
+    } else if (ADPCM_PREDICTOR_MIN > ch_p->predictor) {
+        ch_p->predictor = ADPCM_PREDICTOR_MIN;
+    }
+    ch_p->index += adpcm_index_v[code & 7];
+    if (0 > ch_p->index) {
+        ch_p->index = 0;
+    } else if (ADPCM_INDEX_MAX < ch_p->index) {
+        ch_p->index = ADPCM_INDEX_MAX;
+    }
+    return code;
+}
+
+/*****************************************************************************/
+Status OutPut(const U8* data_p, Size size)
+{
+Status s = S_OK;
+
+    while (0 != size) {
+        Size len = APP_MEDIA_CONVERT_WRITE_SIZE - convert.out_fill;
+        if (size < len) { len = size; }
+        OS_MemCpy(convert.out_p + convert.out_fill, data_p, len);
+        convert.out_fill += len;
+        data_p += len;
+        size   -= len;
+        //Full buffers only: one large write.
+        if (APP_MEDIA_CONVERT_WRITE_SIZE == convert.out_fill) {
+            IF_STATUS(s = OutFlush()) { break; }
+        }
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status OutFlush(void)
+{
+Status s = S_OK;
+
+    if (0 != convert.out_fill) {
+        s = OS_FileWrite(convert.file_out_hd, convert.out_p, convert.out_fill);
+        media_convert_stats.bytes_out += convert.out_fill;
+        convert.out_fill = 0;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Size WavHeaderMake(U8* hdr_p)
+{
+const OS_AudioInfo* audio_info_p = &convert.info.audio_info;
+const U16 channels = audio_info_p->channels;
+U8* p = hdr_p;
+
+    OS_MemCpy(p, "RIFF", 4);
+    OS_MemCpy(p + 8, "WAVEfmt ", 8);
+    p += 16;
+    if (MEDIA_CONVERT_FORMAT_ADPCM == convert.job.format) {
+        Put32(&p[0],  20);
+        Put16(&p[4],  WAV_FORMAT_IMA_ADPCM);
+        Put16(&p[6],  channels);
+        Put32(&p[8],  audio_info_p->sample_rate);
+        Put32(&p[12], (U32)(((U64)audio_info_p->sample_rate * convert.block_align) / convert.block_samples));
+        Put16(&p[16], convert.block_align);
+        Put16(&p[18], 4);
+        Put16(&p[20], 2);
+        Put16(&p[22], convert.block_samples);
+        OS_MemCpy(&p[24], "fact", 4);
+        Put32(&p[28], 4);
+        Put32(&p[32], convert.samples);
+        p += 36;
+    } else {
+        const U16 block_align = channels * (audio_info_p->sample_bits / 8);
+        Put32(&p[0],  16);
+        Put16(&p[4],  WAV_FORMAT_PCM);
+        Put16(&p[6],  channels);
+        Put32(&p[8],  audio_info_p->sample_rate);
+        Put32(&p[12], audio_info_p->sample_rate * block_align);
+        Put16(&p[16], block_align);
+        Put16(&p[18], audio_info_p->sample_bits);
+        p += 20;
+    }
+    OS_MemCpy(p, "data", 4);
+    Put32(p + 4, convert.data_size);
+    p += 8;
+    Put32(hdr_p + 4, (U32)(p - hdr_p) - 8 + convert.data_size);
+    return (Size)(p - hdr_p);
+}
+
+/*****************************************************************************/
+void Put16(U8* p, const U16 v)
+{
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+}
+
+/*****************************************************************************/
+void Put32(U8* p, const U32 v)
+{
+    Put16(p, (U16)v);
+    Put16(p + 2, (U16)(v >> 16));
+}
+
+#endif //(OS_AUDIO_ENABLED)
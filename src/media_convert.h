@@ -0,0 +1,61 @@
+/***************************************************************************//**
+* @file    media_convert.h
+* @brief   Media files offline conversion.
+* @author  A. Filyanov
+* @details Audio files (or all of them in a directory) are decoded by the
+*          player codecs (background decoder instances) and written as PCM or
+*          IMA ADPCM WAV files. The job is done by BgServ as fast as the CPU
+*          idle time allows: it is not paced by the audio device and runs
+*          beside the playback. The output goes by the large sector aligned
+*          writes (the header space is reserved and written on the file end).
+*******************************************************************************/
+#ifndef _MEDIA_CONVERT_H_
+#define _MEDIA_CONVERT_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+typedef enum {
+    MEDIA_CONVERT_FORMAT_PCM,
+    MEDIA_CONVERT_FORMAT_ADPCM,         // IMA ADPCM (16 bits input only).
+    MEDIA_CONVERT_FORMAT_LAST
+} MediaConvertFormat;
+
+typedef struct {
+    Str             path_in[APP_MEDIA_CONVERT_PATH_LEN];    // File or directory.
+    Str             path_out[APP_MEDIA_CONVERT_PATH_LEN];   // File or directory (for the input directory).
+    U8              format;             // #MediaConvertFormat
+} MediaConvertJob;
+
+typedef struct {
+    U16             files;
+    U16             errors;
+    U32             bytes_in;
+    U32             bytes_out;
+    U32             audio_ms;           // Converted audio time.
+    U32             busy_ms;            // Conversion (not wall) time.
+    Bool            is_active;
+} MediaConvertStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Start the conversion job.
+/// @param[in]  job_p          Job.
+/// @return     #Status.
+Status          MediaConvertStart(const MediaConvertJob* job_p);
+
+/// @brief      Stop the conversion job (the current output is completed).
+void            MediaConvertStop(void);
+
+/// @brief      Do a time slice of the job (BgServ context).
+/// @return     Work is ready for the next step at once.
+Bool            MediaConvertStep(void);
+
+/// @brief      Get conversion statistics (of the last job).
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MediaConvertStatsGet(MediaConvertStats* stats_p);
+
+#endif //(OS_AUDIO_ENABLED)
+#endif // _MEDIA_CONVERT_H_
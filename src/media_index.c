@@ -0,0 +1,432 @@
+/***************************************************************************//**
+* @file    media_index.c
+* @brief   Media files integrity index.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "audio_codec.h"
+#include "media_index.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "media_index"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_media_index_v[0]
+
+#define INDEX_MAGIC             0x5844494D  // "MIDX"
+#define INDEX_VERSION           1
+#define SCAN_STEP_ITEMS         8
+
+//-----------------------------------------------------------------------------
+const StatusItem status_media_index_v[] = {
+    {"Undefined status"},
+    {"Index is full"},
+    {"Index file error"},
+    {"CRC mismatch"},
+};
+
+typedef struct {
+    U32             magic;
+    U16             version;
+    U16             items;
+    U32             crc;                // Items CRC32.
+} MediaIndexFileHdr;
+
+typedef enum {
+    SWEEP_STATE_IDLE,
+    SWEEP_STATE_SCAN,
+    SWEEP_STATE_VERIFY,
+    SWEEP_STATE_SAVE
+} SweepState;
+
+typedef struct {
+    SweepState      state;
+    OS_DirHd        dir_hd;
+    OS_FileHd       file_hd;
+    Bool            is_file_open;
+    Size            idx;
+    U32             pos;
+    U32             crc_head;
+    U32             crc_body;
+    U8*             buf_p;
+} MediaIndexSweep;
+
+//-----------------------------------------------------------------------------
+static Status   IndexLoad(void);
+static Status   IndexSave(void);
+static Int      ItemFind(ConstStrP path_str_p);
+static Status   ItemAdd(ConstStrP path_str_p, const U32 size, Size* idx_p);
+static void     ItemStore(const Size idx, const MediaIndexItem* item_p);
+static void     ItemCheck(const Size idx, MediaIndexItem* item_p, const U8 flags, const U32 crc_head, const U32 crc_body);
+static void     SweepScanStep(void);
+static void     SweepVerifyStep(void);
+static void     SweepFileEnd(void);
+
+//-----------------------------------------------------------------------------
+static MediaIndexItem* items_v;
+static MediaIndexStats media_index_stats;
+static MediaIndexSweep sweep;
+static Bool is_dirty;
+
+/*****************************************************************************/
+Status MediaIndexInit(void)
+{
+Status s = S_UNDEF;
+    items_v = OS_MallocEx(sizeof(MediaIndexItem) * APP_MEDIA_INDEX_ITEMS_MAX, APP_MEDIA_INDEX_MEMORY);
+    if (OS_NULL == items_v) { return S_OUT_OF_MEMORY; }
+    media_index_stats.items = 0;
+    IF_STATUS(s = IndexLoad()) {
+        //No index yet (or it is broken): the sweep will build it.
+        OS_LOG(D_INFO, "New index");
+        media_index_stats.items = 0;
+    }
+    OS_LOG(D_INFO, "Items: %u", media_index_stats.items);
+    return S_OK;
+}
+
+/*****************************************************************************/
+void MediaIndexTrackBegin(MediaIndexTrack* track_p, ConstStrP path_str_p, const U32 size, const U32 offset)
+{
+    track_p->is_valid = (OS_StrLen(path_str_p) < sizeof(track_p->path)) && (offset <= size);
+    if (OS_TRUE != track_p->is_valid) { return; }
+    OS_StrCpy(track_p->path, path_str_p);
+    track_p->size       = size;
+    track_p->head_size  = offset;
+    track_p->pos        = offset;
+    track_p->crc        = CRC32_POLYNOMIAL;
+}
+
+/*****************************************************************************/
+Bool MediaIndexTrackUpdate(MediaIndexTrack* track_p, U8* data_p, const Size size)
+{
+Size len;
+    if (OS_TRUE != track_p->is_valid) { return OS_FALSE; }
+    //Reads past the file end are partial.
+    len = ((track_p->size - track_p->pos) < size) ? (track_p->size - track_p->pos) : size;
+    track_p->crc = Crc32Delta(data_p, len, track_p->crc);
+    track_p->pos += len;
+    return (track_p->size == track_p->pos);
+}
+
+/*****************************************************************************/
+void MediaIndexTrackAbort(MediaIndexTrack* track_p)
+{
+    track_p->is_valid = OS_FALSE;
+}
+
+/*****************************************************************************/
+Status MediaIndexTrackReport(const MediaIndexTrack* track_p)
+{
+MediaIndexItem item;
+const U32 crc_body = track_p->crc ^ CRC32_POLYNOMIAL;
+Int idx = ItemFind(track_p->path);
+Size new_idx;
+Status s = S_UNDEF;
+
+    if (0 > idx) {
+        IF_STATUS(s = ItemAdd(track_p->path, track_p->size, &new_idx)) { return s; }
+        idx = new_idx;
+    }
+    item = items_v[idx];
+    ++media_index_stats.playback_checks;
+    if ((item.size != track_p->size) || (item.head_size != track_p->head_size)) {
+        //File replaced or the body is seen first from this offset: re-key the item.
+        if (item.size != track_p->size) { item.flags = 0; }
+        item.size       = track_p->size;
+        item.head_size  = track_p->head_size;
+        item.flags     &= ~(MEDIA_INDEX_FLAG_HEAD | MEDIA_INDEX_FLAG_BODY);
+        item.flags     |= MEDIA_INDEX_FLAG_BODY;
+        item.crc_body   = crc_body;
+        item.state      = MEDIA_INDEX_STATE_UNKNOWN;
+        ItemStore(idx, &item);
+        is_dirty = OS_TRUE;
+        return S_OK;
+    }
+    ItemCheck(idx, &item, MEDIA_INDEX_FLAG_BODY, 0, crc_body);
+    return (MEDIA_INDEX_STATE_MISMATCH == item.state) ? S_MEDIA_INDEX_MISMATCH : S_OK;
+}
+
+/*****************************************************************************/
+Status MediaIndexSweepStart(void)
+{
+Status s = S_UNDEF;
+    if (SWEEP_STATE_IDLE != sweep.state) { return S_OK; }
+    if (OS_NULL == items_v) { return S_INVALID_STATE; }
+    sweep.buf_p = OS_MallocEx(APP_MEDIA_INDEX_READ_SIZE, APP_MEDIA_INDEX_MEMORY);
+    if (OS_NULL == sweep.buf_p) { return S_OUT_OF_MEMORY; }
+    IF_STATUS(s = OS_DirOpen(APP_MEDIA_INDEX_DIR, &sweep.dir_hd)) {
+        OS_FreeEx(sweep.buf_p, APP_MEDIA_INDEX_MEMORY);
+        return s;
+    }
+    sweep.state = SWEEP_STATE_SCAN;
+    media_index_stats.is_sweep = OS_TRUE;
+    OS_LOG(D_DEBUG, "Sweep start");
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool MediaIndexStep(void)
+{
+    switch (sweep.state) {
+        case SWEEP_STATE_SCAN:
+            SweepScanStep();
+            break;
+        case SWEEP_STATE_VERIFY:
+            SweepVerifyStep();
+            break;
+        case SWEEP_STATE_SAVE:
+            OS_FreeEx(sweep.buf_p, APP_MEDIA_INDEX_MEMORY);
+            sweep.state = SWEEP_STATE_IDLE;
+            media_index_stats.is_sweep = OS_FALSE;
+            OS_LOG(D_DEBUG, "Sweep end");
+            break;
+        default:
+            break;
+    }
+    if (OS_TRUE == is_dirty) {
+        IF_STATUS(IndexSave()) { OS_LOG_S(D_WARNING, S_MEDIA_INDEX_FILE_ERROR); }
+        is_dirty = OS_FALSE;
+    }
+    return (SWEEP_STATE_IDLE != sweep.state);
+}
+
+/*****************************************************************************/
+Status MediaIndexStatsGet(MediaIndexStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = media_index_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status MediaIndexItemGet(const Size idx, MediaIndexItem* item_p)
+{
+U32 primask;
+    if (OS_NULL == item_p) { return S_INVALID_PTR; }
+    if (media_index_stats.items <= idx) { return S_INVALID_VALUE; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    *item_p = items_v[idx];
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status IndexLoad(void)
+{
+MediaIndexFileHdr hdr;
+OS_FileHd file_hd;
+Status s = S_UNDEF;
+
+    IF_STATUS(s = OS_FileOpen(&file_hd, APP_MEDIA_INDEX_FILE,
+                              BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        return s;
+    }
+    IF_OK(s = OS_FileRead(file_hd, &hdr, sizeof(hdr))) {
+        if ((INDEX_MAGIC != hdr.magic) || (INDEX_VERSION != hdr.version) || (APP_MEDIA_INDEX_ITEMS_MAX < hdr.items)) {
+            s = S_MEDIA_INDEX_FILE_ERROR;
+        } else {
+            IF_OK(s = OS_FileRead(file_hd, items_v, sizeof(MediaIndexItem) * hdr.items)) {
+                if (hdr.crc == Crc32((U8*)items_v, sizeof(MediaIndexItem) * hdr.items)) {
+                    media_index_stats.items = hdr.items;
+                    for (Size i = 0; i < hdr.items; ++i) {
+                        if (MEDIA_INDEX_STATE_MISMATCH == items_v[i].state) { ++media_index_stats.mismatches; }
+                    }
+                } else { s = S_MEDIA_INDEX_FILE_ERROR; }
+            }
+        }
+    }
+    OS_FileClose(&file_hd);
+    return s;
+}
+
+/*****************************************************************************/
+Status IndexSave(void)
+{
+const Size size = sizeof(MediaIndexItem) * media_index_stats.items;
+const MediaIndexFileHdr hdr = {
+    .magic      = INDEX_MAGIC,
+    .version    = INDEX_VERSION,
+    .items      = media_index_stats.items,
+    .crc        = Crc32((U8*)items_v, size)
+};
+OS_FileHd file_hd;
+Status s = S_UNDEF;
+
+    IF_STATUS(s = OS_FileOpen(&file_hd, APP_MEDIA_INDEX_FILE,
+                              BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        return s;
+    }
+    IF_OK(s = OS_FileWrite(file_hd, &hdr, sizeof(hdr))) {
+        s = OS_FileWrite(file_hd, items_v, size);
+    }
+    OS_FileClose(&file_hd);
+    return s;
+}
+
+/*****************************************************************************/
+Int ItemFind(ConstStrP path_str_p)
+{
+    for (Size i = 0; i < media_index_stats.items; ++i) {
+        if (0 == OS_StrCmp(items_v[i].path, path_str_p)) { return i; }
+    }
+    return -1;
+}
+
+/*****************************************************************************/
+Status ItemAdd(ConstStrP path_str_p, const U32 size, Size* idx_p)
+{
+MediaIndexItem item;
+    if (APP_MEDIA_INDEX_ITEMS_MAX <= media_index_stats.items) { return S_MEDIA_INDEX_FULL; }
+    OS_MemSet(&item, 0, sizeof(item));
+    OS_StrNCpy(item.path, path_str_p, sizeof(item.path) - 1);
+    item.size   = size;
+    item.state  = MEDIA_INDEX_STATE_UNKNOWN;
+    *idx_p = media_index_stats.items;
+    ItemStore(*idx_p, &item);
+    ++media_index_stats.items;
+    is_dirty = OS_TRUE;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void ItemStore(const Size idx, const MediaIndexItem* item_p)
+{
+U32 primask;
+    //Readers are other tasks (shell).
+    APP_CRITICAL_SECTION_ENTER(primask);
+    //Mismatched items count follows the state transitions of the indexed items.
+    if (media_index_stats.items > idx) {
+        if (MEDIA_INDEX_STATE_MISMATCH == items_v[idx].state) { --media_index_stats.mismatches; }
+    }
+    if (MEDIA_INDEX_STATE_MISMATCH == item_p->state) { ++media_index_stats.mismatches; }
+    items_v[idx] = *item_p;
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
+
+/*****************************************************************************/
+void ItemCheck(const Size idx, MediaIndexItem* item_p, const U8 flags, const U32 crc_head, const U32 crc_body)
+{
+Bool is_match = OS_TRUE;
+
+    //Known parts are compared, the unknown ones are recorded.
+    if (flags & MEDIA_INDEX_FLAG_HEAD) {
+        if (item_p->flags & MEDIA_INDEX_FLAG_HEAD) {
+            is_match &= (crc_head == item_p->crc_head);
+        } else {
+            item_p->crc_head = crc_head;
+        }
+    }
+    if (flags & MEDIA_INDEX_FLAG_BODY) {
+        if (item_p->flags & MEDIA_INDEX_FLAG_BODY) {
+            is_match &= (crc_body == item_p->crc_body);
+        } else {
+            item_p->crc_body = crc_body;
+        }
+    }
+    item_p->flags |= flags;
+    if (OS_TRUE == is_match) {
+        //Mismatch sticks until the file is replaced.
+        if (MEDIA_INDEX_STATE_MISMATCH != item_p->state) { item_p->state = MEDIA_INDEX_STATE_OK; }
+    } else {
+        item_p->state = MEDIA_INDEX_STATE_MISMATCH;
+        ++item_p->mismatches;
+        OS_LOG_S(D_WARNING, S_MEDIA_INDEX_MISMATCH);
+        OS_LOG(D_WARNING, "%s", item_p->path);
+    }
+    ItemStore(idx, item_p);
+    is_dirty = OS_TRUE;
+}
+
+/*****************************************************************************/
+void SweepScanStep(void)
+{
+Str path_str[APP_MEDIA_INDEX_PATH_LEN];
+OS_FileStats file_stats;
+Size idx;
+
+    for (Size i = 0; i < SCAN_STEP_ITEMS; ++i) {
+        if ((S_OK != OS_DirRead(sweep.dir_hd, &file_stats)) || ('\0' == file_stats.name[0])) {
+            OS_DirClose(sweep.dir_hd);
+            sweep.idx   = 0;
+            sweep.state = SWEEP_STATE_VERIFY;
+            return;
+        }
+        if (AUDIO_FORMAT_UNDEF == AudioFormatByNameGet(file_stats.name)) { continue; }
+        if ((OS_StrLen(APP_MEDIA_INDEX_DIR) + 1 + OS_StrLen(file_stats.name)) >= sizeof(path_str)) { continue; }
+        OS_StrCpy(path_str, APP_MEDIA_INDEX_DIR);
+        OS_StrCat(path_str, "/");
+        OS_StrCat(path_str, file_stats.name);
+        if (0 > ItemFind(path_str)) {
+            IF_STATUS(ItemAdd(path_str, file_stats.size, &idx)) {
+                OS_LOG_S(D_WARNING, S_MEDIA_INDEX_FULL);
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+void SweepVerifyStep(void)
+{
+const MediaIndexItem* item_p;
+U32 len;
+U32 head_len;
+
+    if (media_index_stats.items <= sweep.idx) {
+        sweep.state = SWEEP_STATE_SAVE;
+        return;
+    }
+    item_p = &items_v[sweep.idx];
+    if (OS_TRUE != sweep.is_file_open) {
+        IF_STATUS(OS_FileOpen(&sweep.file_hd, item_p->path,
+                              BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+            ++sweep.idx;
+            return;
+        }
+        if (item_p->size != OS_FileSizeGet(sweep.file_hd)) {
+            //File replaced: the index item is rebuilt from scratch.
+            MediaIndexItem item = *item_p;
+            item.size   = OS_FileSizeGet(sweep.file_hd);
+            item.flags  = 0;
+            item.state  = MEDIA_INDEX_STATE_UNKNOWN;
+            if (item.head_size > item.size) { item.head_size = 0; }
+            ItemStore(sweep.idx, &item);
+        }
+        sweep.is_file_open  = OS_TRUE;
+        sweep.pos           = 0;
+        sweep.crc_head      = CRC32_POLYNOMIAL;
+        sweep.crc_body      = CRC32_POLYNOMIAL;
+    }
+    //One large sequential read per step.
+    len = item_p->size - sweep.pos;
+    if (APP_MEDIA_INDEX_READ_SIZE < len) { len = APP_MEDIA_INDEX_READ_SIZE; }
+    if (0 != len) {
+        IF_STATUS(OS_FileRead(sweep.file_hd, sweep.buf_p, len)) {
+            OS_LOG_S(D_WARNING, S_MEDIA_INDEX_FILE_ERROR);
+            SweepFileEnd();
+            return;
+        }
+    }
+    head_len = (sweep.pos < item_p->head_size) ? (item_p->head_size - sweep.pos) : 0;
+    if (head_len > len) { head_len = len; }
+    sweep.crc_head = Crc32Delta(sweep.buf_p, head_len, sweep.crc_head);
+    sweep.crc_body = Crc32Delta(sweep.buf_p + head_len, len - head_len, sweep.crc_body);
+    sweep.pos += len;
+    media_index_stats.bytes_verified += len;
+    if (item_p->size == sweep.pos) {
+        MediaIndexItem item = *item_p;
+        ++media_index_stats.idle_checks;
+        ItemCheck(sweep.idx, &item, MEDIA_INDEX_FLAG_HEAD | MEDIA_INDEX_FLAG_BODY,
+                  sweep.crc_head ^ CRC32_POLYNOMIAL, sweep.crc_body ^ CRC32_POLYNOMIAL);
+        SweepFileEnd();
+    }
+}
+
+/*****************************************************************************/
+void SweepFileEnd(void)
+{
+    OS_FileClose(&sweep.file_hd);
+    sweep.is_file_open = OS_FALSE;
+    ++sweep.idx;
+}
@@ -0,0 +1,114 @@
+/***************************************************************************//**
+* @file    media_index.h
+* @brief   Media files integrity index.
+* @author  A. Filyanov
+* @details Index item keeps CRC32 (as Crc32()) of the file head and body
+*          separately: the player sees the body only (from the format header
+*          end), the idle verification reads the whole file. Whole file CRC32
+*          is Crc32Combine(crc_head, crc_body, size - head_size).
+*******************************************************************************/
+#ifndef _MEDIA_INDEX_H_
+#define _MEDIA_INDEX_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+//-----------------------------------------------------------------------------
+enum {
+    S_MEDIA_INDEX_UNDEF = S_MODULE,
+    S_MEDIA_INDEX_FULL,
+    S_MEDIA_INDEX_FILE_ERROR,
+    S_MEDIA_INDEX_MISMATCH,
+    S_MEDIA_INDEX_LAST
+};
+
+typedef enum {
+    MEDIA_INDEX_STATE_UNKNOWN,
+    MEDIA_INDEX_STATE_OK,
+    MEDIA_INDEX_STATE_MISMATCH,
+    MEDIA_INDEX_STATE_LAST
+} MediaIndexState;
+
+enum {
+    MEDIA_INDEX_FLAG_HEAD   = BIT(0),   // crc_head is valid.
+    MEDIA_INDEX_FLAG_BODY   = BIT(1),   // crc_body is valid.
+};
+
+typedef struct {
+    Str             path[APP_MEDIA_INDEX_PATH_LEN];
+    U32             size;
+    U32             head_size;
+    U32             crc_head;
+    U32             crc_body;
+    U8              flags;
+    U8              state;
+    U16             mismatches;
+} MediaIndexItem;
+
+// Playback read tracking (player context).
+typedef struct {
+    Str             path[APP_MEDIA_INDEX_PATH_LEN];
+    U32             size;
+    U32             head_size;
+    U32             pos;
+    U32             crc;                // Crc32Delta() register.
+    Bool            is_valid;
+} MediaIndexTrack;
+
+typedef struct {
+    U16             items;
+    U16             mismatches;         // Items in the mismatch state.
+    U32             playback_checks;
+    U32             idle_checks;
+    U32             bytes_verified;
+    Bool            is_sweep;
+} MediaIndexStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init media index (load the index file).
+/// @return     #Status.
+Status          MediaIndexInit(void);
+
+/// @brief      Start tracking of the sequential file reads.
+/// @param[out] track_p        Track.
+/// @param[in]  path_str_p     File path.
+/// @param[in]  size           File size.
+/// @param[in]  offset         Reads start offset (format header size).
+void            MediaIndexTrackBegin(MediaIndexTrack* track_p, ConstStrP path_str_p, const U32 size, const U32 offset);
+
+/// @brief      Add read data to the track.
+/// @param[in]  track_p        Track.
+/// @param[in]  data_p         Data read.
+/// @param[in]  size           Read request size (the file end cuts it).
+/// @return     Track is complete (file end reached).
+Bool            MediaIndexTrackUpdate(MediaIndexTrack* track_p, U8* data_p, const Size size);
+
+/// @brief      Drop the track (reads are not sequential anymore).
+/// @param[in]  track_p        Track.
+void            MediaIndexTrackAbort(MediaIndexTrack* track_p);
+
+/// @brief      Check/record the complete track (BgServ context).
+/// @param[in]  track_p        Track.
+/// @return     #Status.
+Status          MediaIndexTrackReport(const MediaIndexTrack* track_p);
+
+/// @brief      Start the idle verification sweep (BgServ context).
+/// @return     #Status.
+Status          MediaIndexSweepStart(void);
+
+/// @brief      Do a step of the pending work (BgServ context).
+/// @return     Work is pending.
+Bool            MediaIndexStep(void);
+
+/// @brief      Get media index statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MediaIndexStatsGet(MediaIndexStats* stats_p);
+
+/// @brief      Get media index item.
+/// @param[in]  idx            Item index.
+/// @param[out] item_p         Item.
+/// @return     #Status.
+Status          MediaIndexItemGet(const Size idx, MediaIndexItem* item_p);
+
+#endif // _MEDIA_INDEX_H_
@@ -0,0 +1,102 @@
+/***************************************************************************//**
+* @file    mem_pool.c
+* @brief   Fixed-size block memory pool.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "app_common.h"
+#include "mem_pool.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "mem_pool"
+
+/*****************************************************************************/
+Status MemPoolInit(MemPool* pool_p, void* mem_p, const Size block_size, const U16 blocks_count)
+{
+U8* block_p = (U8*)mem_p;
+    if ((OS_NULL == pool_p) || (OS_NULL == mem_p)) { return S_INVALID_PTR; }
+    if ((sizeof(void*) > block_size) || (block_size % sizeof(void*)) || (0 == blocks_count)) {
+        return S_INVALID_SIZE;
+    }
+    pool_p->base_p          = block_p;
+    pool_p->block_size      = block_size;
+    pool_p->blocks_count    = blocks_count;
+    pool_p->blocks_used     = 0;
+    pool_p->blocks_used_max = 0;
+    pool_p->fails_count     = 0;
+    //Thread the free list through the blocks themselves.
+    for (U16 i = 0; i < (blocks_count - 1); ++i) {
+        *(void**)block_p = (void*)(block_p + block_size);
+        block_p += block_size;
+    }
+    *(void**)block_p = OS_NULL;
+    pool_p->free_head_p = mem_p;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void* MemPoolAlloc(MemPool* pool_p)
+{
+void* block_p;
+U32 primask;
+    OS_ASSERT_VALUE(OS_NULL != pool_p);
+    APP_CRITICAL_SECTION_ENTER(primask);
+    block_p = pool_p->free_head_p;
+    if (OS_NULL != block_p) {
+        pool_p->free_head_p = *(void**)block_p;
+        if (++pool_p->blocks_used > pool_p->blocks_used_max) {
+            pool_p->blocks_used_max = pool_p->blocks_used;
+        }
+    } else {
+        ++pool_p->fails_count;
+    }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return block_p;
+}
+
+/*****************************************************************************/
+Status MemPoolFree(MemPool* pool_p, void* block_p)
+{
+U32 primask;
+    OS_ASSERT_VALUE(OS_NULL != pool_p);
+    if (OS_TRUE != MemPoolIsOwner(pool_p, block_p)) { return S_INVALID_PTR; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    *(void**)block_p = pool_p->free_head_p;
+    pool_p->free_head_p = block_p;
+    --pool_p->blocks_used;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool MemPoolIsOwner(const MemPool* pool_p, const void* block_p)
+{
+const U8* p = (const U8*)block_p;
+    if ((p < pool_p->base_p) ||
+        (p >= (pool_p->base_p + (pool_p->block_size * pool_p->blocks_count)))) {
+        return OS_FALSE;
+    }
+    //Must point to the block start.
+    return (0 == ((Size)(p - pool_p->base_p) % pool_p->block_size)) ? OS_TRUE : OS_FALSE;
+}
+
+/*****************************************************************************/
+Status MemPoolStatsGet(const MemPool* pool_p, MemPoolStats* stats_p)
+{
+    if ((OS_NULL == pool_p) || (OS_NULL == stats_p)) { return S_INVALID_PTR; }
+    stats_p->block_size     = pool_p->block_size;
+    stats_p->blocks_count   = pool_p->blocks_count;
+    stats_p->blocks_used    = pool_p->blocks_used;
+    stats_p->blocks_used_max= pool_p->blocks_used_max;
+    stats_p->fails_count    = pool_p->fails_count;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void MemPoolStatsReset(MemPool* pool_p)
+{
+U32 primask;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    pool_p->blocks_used_max = pool_p->blocks_used;
+    pool_p->fails_count     = 0;
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
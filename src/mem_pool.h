@@ -0,0 +1,68 @@
+/***************************************************************************//**
+* @file    mem_pool.h
+* @brief   Fixed-size block memory pool.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _MEM_POOL_H_
+#define _MEM_POOL_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    U8*             base_p;
+    Size            block_size;
+    U16             blocks_count;
+    U16             blocks_used;
+    U16             blocks_used_max;
+    U32             fails_count;
+    void*           free_head_p;
+} MemPool;
+
+typedef struct {
+    Size            block_size;
+    U16             blocks_count;
+    U16             blocks_used;
+    U16             blocks_used_max;
+    U32             fails_count;
+} MemPoolStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init memory pool over the preallocated memory region.
+/// @param[in]  pool_p         Pool.
+/// @param[in]  mem_p          Memory region (blocks_count * block_size bytes).
+/// @param[in]  block_size     Block size (multiple of the pointer size).
+/// @param[in]  blocks_count   Blocks count.
+/// @return     #Status.
+Status          MemPoolInit(MemPool* pool_p, void* mem_p, const Size block_size, const U16 blocks_count);
+
+/// @brief      Allocate block from the pool.
+/// @param[in]  pool_p         Pool.
+/// @return     Block pointer or OS_NULL if the pool is exhausted.
+/// @details    Constant time. Safe to call from ISR.
+void*           MemPoolAlloc(MemPool* pool_p);
+
+/// @brief      Free block to the pool.
+/// @param[in]  pool_p         Pool.
+/// @param[in]  block_p        Block pointer.
+/// @return     #Status.
+/// @details    Constant time. Safe to call from ISR.
+Status          MemPoolFree(MemPool* pool_p, void* block_p);
+
+/// @brief      Check the block is owned by the pool.
+/// @param[in]  pool_p         Pool.
+/// @param[in]  block_p        Block pointer.
+/// @return     Is owner.
+Bool            MemPoolIsOwner(const MemPool* pool_p, const void* block_p);
+
+/// @brief      Get pool statistics.
+/// @param[in]  pool_p         Pool.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MemPoolStatsGet(const MemPool* pool_p, MemPoolStats* stats_p);
+
+/// @brief      Reset pool high-water and fails statistics.
+/// @param[in]  pool_p         Pool.
+void            MemPoolStatsReset(MemPool* pool_p);
+
+#endif // _MEM_POOL_H_
@@ -0,0 +1,132 @@
+/***************************************************************************//**
+* @file    msg_pool.c
+* @brief   Inter-task messages pool.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_memory.h"
+#include "app_common.h"
+#include "msg_pool.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "msg_pool"
+
+#define ALIGN_UP(v, a)      ((((v) + ((a) - 1)) / (a)) * (a))
+#define BLOCK_SIZE_GET(s)   ALIGN_UP(sizeof(OS_Message) + (s), sizeof(void*))
+
+//-----------------------------------------------------------------------------
+static const MsgPoolClassConfig pool_cfg_v[] = APP_MSG_POOL_CLASSES;
+#define POOL_CLASSES_COUNT  ITEMS_COUNT_GET(pool_cfg_v, MsgPoolClassConfig)
+
+//-----------------------------------------------------------------------------
+static OS_Message* PoolCreate(const OS_MessageId id, const Size size, const void* data_p);
+
+//-----------------------------------------------------------------------------
+static MemPool pools_v[POOL_CLASSES_COUNT];
+static void* pool_mem_p;
+static U32 fallbacks_count;
+
+/*****************************************************************************/
+Status MsgPoolInit(void)
+{
+Size pool_size = 0;
+U8* block_p;
+Status s = S_UNDEF;
+    if (OS_NULL != pool_mem_p) { return S_INITED; }
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        pool_size += BLOCK_SIZE_GET(pool_cfg_v[i].data_size) * pool_cfg_v[i].blocks_count;
+    }
+    pool_mem_p = OS_MallocEx(pool_size, APP_MSG_POOL_MEMORY);
+    if (OS_NULL == pool_mem_p) { return S_OUT_OF_MEMORY; }
+    block_p = (U8*)pool_mem_p;
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        const Size block_size = BLOCK_SIZE_GET(pool_cfg_v[i].data_size);
+        IF_STATUS(s = MemPoolInit(&pools_v[i], block_p, block_size, pool_cfg_v[i].blocks_count)) {
+            OS_FreeEx(pool_mem_p, APP_MSG_POOL_MEMORY);
+            pool_mem_p = OS_NULL;
+            return s;
+        }
+        block_p += block_size * pool_cfg_v[i].blocks_count;
+    }
+    OS_LOG(D_DEBUG, "Messages pool: %u bytes", (U32)pool_size);
+    return s;
+}
+
+/*****************************************************************************/
+OS_Message* MsgPoolCreate(const OS_MessageId id, const Size size, const OS_TimeMs timeout, const void* data_p)
+{
+OS_Message* msg_p = PoolCreate(id, size, data_p);
+    if (OS_NULL == msg_p) {
+        ++fallbacks_count;
+        msg_p = OS_MessageCreate(id, size, timeout, data_p);
+    }
+    return msg_p;
+}
+
+/*****************************************************************************/
+OS_Message* ISR_MsgPoolCreate(const OS_MessageId id, const Size size, const void* data_p)
+{
+    return PoolCreate(id, size, data_p);
+}
+
+/*****************************************************************************/
+Status MsgPoolDelete(OS_Message* msg_p)
+{
+    if (OS_NULL == msg_p) { return S_INVALID_PTR; }
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        if (OS_TRUE == MemPoolIsOwner(&pools_v[i], msg_p)) {
+            return MemPoolFree(&pools_v[i], msg_p);
+        }
+    }
+    return OS_MessageDelete(msg_p);
+}
+
+/*****************************************************************************/
+Size MsgPoolClassesCountGet(void)
+{
+    return POOL_CLASSES_COUNT;
+}
+
+/*****************************************************************************/
+Status MsgPoolStatsGet(const Size class_idx, MemPoolStats* stats_p)
+{
+    if (POOL_CLASSES_COUNT <= class_idx) { return S_INVALID_VALUE; }
+    return MemPoolStatsGet(&pools_v[class_idx], stats_p);
+}
+
+/*****************************************************************************/
+U32 MsgPoolFallbacksGet(void)
+{
+    return fallbacks_count;
+}
+
+/*****************************************************************************/
+void MsgPoolStatsReset(void)
+{
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        MemPoolStatsReset(&pools_v[i]);
+    }
+    fallbacks_count = 0;
+}
+
+/*****************************************************************************/
+OS_Message* PoolCreate(const OS_MessageId id, const Size size, const void* data_p)
+{
+OS_Message* msg_p = OS_NULL;
+    if (OS_NULL == pool_mem_p) { return OS_NULL; }
+    for (Size i = 0; i < POOL_CLASSES_COUNT; ++i) {
+        if (size <= pool_cfg_v[i].data_size) {
+            msg_p = MemPoolAlloc(&pools_v[i]);
+            if (OS_NULL != msg_p) { break; }
+        }
+    }
+    if (OS_NULL != msg_p) {
+        //Same layout as the OS message.
+        OS_MemSet(msg_p, 0, sizeof(OS_Message));
+        msg_p->id   = id;
+        msg_p->size = size;
+        if (OS_NULL != data_p) {
+            OS_MemCpy(msg_p->data, data_p, size);
+        }
+    }
+    return msg_p;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************//**
+* @file    msg_pool.h
+* @brief   Inter-task messages pool.
+* @author  A. Filyanov
+* @details Messages are taken from the fixed-size blocks pools and fall back
+*          to OS_MessageCreate() if the payload doesn't fit or the class is
+*          exhausted. A receiver of the pool messages must free them with
+*          MsgPoolDelete() (it takes the OS messages as well).
+*******************************************************************************/
+#ifndef _MSG_POOL_H_
+#define _MSG_POOL_H_
+
+#include "mem_pool.h"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    Size            data_size;
+    U16             blocks_count;
+} MsgPoolClassConfig;
+
+//-----------------------------------------------------------------------------
+/// @brief      Reserve messages pool memory.
+/// @return     #Status.
+Status          MsgPoolInit(void);
+
+/// @brief      Create message.
+/// @param[in]  id             Message id.
+/// @param[in]  size           Message data size.
+/// @param[in]  timeout        OS heap allocation timeout (fallback).
+/// @param[in]  data_p         Message data (copied).
+/// @return     Message or OS_NULL.
+OS_Message*     MsgPoolCreate(const OS_MessageId id, const Size size, const OS_TimeMs timeout, const void* data_p);
+
+/// @brief      Create message (ISR).
+/// @param[in]  id             Message id.
+/// @param[in]  size           Message data size.
+/// @param[in]  data_p         Message data (copied).
+/// @return     Message or OS_NULL.
+/// @details    Constant time, no OS heap fallback.
+OS_Message*     ISR_MsgPoolCreate(const OS_MessageId id, const Size size, const void* data_p);
+
+/// @brief      Delete message.
+/// @param[in]  msg_p          Message (pool or OS one).
+/// @return     #Status.
+/// @details    Constant time for the pool messages. Safe to call from ISR for them.
+Status          MsgPoolDelete(OS_Message* msg_p);
+
+/// @brief      Get messages pool classes count.
+/// @return     Classes count.
+Size            MsgPoolClassesCountGet(void);
+
+/// @brief      Get messages pool class statistics.
+/// @param[in]  class_idx      Class index.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MsgPoolStatsGet(const Size class_idx, MemPoolStats* stats_p);
+
+/// @brief      Get OS heap fallbacks count.
+/// @return     Fallbacks count.
+U32             MsgPoolFallbacksGet(void);
+
+/// @brief      Reset messages pool statistics.
+void            MsgPoolStatsReset(void);
+
+#endif // _MSG_POOL_H_
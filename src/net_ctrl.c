@@ -0,0 +1,409 @@
+/***************************************************************************//**
+* @file    net_ctrl.c
+* @brief   Binary control and telemetry protocol server.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <errno.h>
+#include "os_memory.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "audio_buf_pool.h"
+#include "net_stream.h"
+#include "task_mmplay.h"
+#include "task_mmplay_ctl.h"
+#include "net_ctrl.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "net_ctrl"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_net_ctrl_v[0]
+
+#define FRAME_OVERHEAD          (sizeof(NetCtrlHdr) + sizeof(U32))
+#define FRAME_SIZE_MAX          (FRAME_OVERHEAD + NET_CTRL_PAYLOAD_MAX)
+
+//-----------------------------------------------------------------------------
+const StatusItem status_net_ctrl_v[] = {
+    {"Undefined status"},
+    {"Frame error"},
+    {"CRC error"},
+    {"No player"},
+    {"Disconnected"},
+    {"Seek unsupported (WAV files only)"},
+};
+
+typedef struct {
+    NetSocket       sd;
+    Size            rx_len;
+    Size            tx_len;
+    OS_TimeMs       tm_period_ms;
+    OS_TimeMs       tm_next_ms;
+    U32             tm_batch;
+    U32             tm_count;
+    NetCtrlTelemetry tm_v[APP_NET_CTRL_TELEMETRY_BATCH_MAX];
+    U8              rx_buf[APP_NET_CTRL_RX_BUF_SIZE];
+    U8              tx_buf[APP_NET_CTRL_TX_BUF_SIZE];
+} NetCtrlClient;
+
+//-----------------------------------------------------------------------------
+static void     ClientsAccept(void);
+static void     ClientClose(NetCtrlClient* cl_p);
+static Status   ClientServe(NetCtrlClient* cl_p, const OS_TimeMs now_ms);
+static Status   ClientFlush(NetCtrlClient* cl_p);
+static void     FramesProcess(NetCtrlClient* cl_p, const OS_TimeMs now_ms);
+static U8*      FramePayloadGet(NetCtrlClient* cl_p);
+static void     FrameCommit(NetCtrlClient* cl_p, const U8 type, const U16 seq, const Status s, const Size len);
+static Status   RequestExecute(NetCtrlClient* cl_p, const NetCtrlHdr* hdr_p, const U8* payload_p,
+                               const OS_TimeMs now_ms, U8* resp_p, Size* resp_len_p);
+static Status   PlayerCommandSend(const OS_SignalId signal_id, const U32 data);
+static void     TelemetrySample(NetCtrlTelemetry* tm_p, const OS_TimeMs now_ms);
+
+//-----------------------------------------------------------------------------
+static NetSocket listen_sd = NET_SOCKET_UNDEF;
+static NetCtrlClient clients_v[APP_NET_CTRL_CLIENTS_MAX];
+
+/*****************************************************************************/
+Status NetCtrlInit(void)
+{
+struct sockaddr_in addr;
+int opt = 1;
+NetSocket sd;
+
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetCtrlClient); ++i) {
+        clients_v[i].sd = NET_SOCKET_UNDEF;
+    }
+    sd = socket(AF_INET, SOCK_STREAM, 0);
+    if (0 > sd) { return S_OUT_OF_MEMORY; }
+    OS_MemSet(&addr, 0, sizeof(addr));
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons(APP_NET_CTRL_PORT);
+    addr.sin_addr.s_addr    = htonl(INADDR_ANY);
+    setsockopt(sd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    NET_SOCKET_IOCTL(sd, FIONBIO, &opt);
+    if ((0 != bind(sd, (const struct sockaddr*)&addr, sizeof(addr))) ||
+        (0 != listen(sd, APP_NET_CTRL_CLIENTS_MAX))) {
+        NET_SOCKET_CLOSE(sd);
+        return S_INVALID_STATE;
+    }
+    listen_sd = sd;
+    OS_LOG(D_INFO, "Control port: %u", APP_NET_CTRL_PORT);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status NetCtrlPoll(const OS_TimeMs now_ms)
+{
+Status s = S_OK;
+    if (NET_SOCKET_UNDEF == listen_sd) { return s; }
+    ClientsAccept();
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetCtrlClient); ++i) {
+        NetCtrlClient* cl_p = &clients_v[i];
+        if (NET_SOCKET_UNDEF != cl_p->sd) {
+            IF_STATUS(s = ClientServe(cl_p, now_ms)) {
+                ClientClose(cl_p);
+            }
+        }
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+OS_TimeMs NetCtrlPollPeriodGet(void)
+{
+    if (NET_SOCKET_UNDEF == listen_sd) { return OS_BLOCK; }
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetCtrlClient); ++i) {
+        if (NET_SOCKET_UNDEF != clients_v[i].sd) { return APP_NETSERV_POLL_PERIOD; }
+    }
+    return APP_NET_CTRL_ACCEPT_POLL_PERIOD;
+}
+
+/*****************************************************************************/
+void ClientsAccept(void)
+{
+int opt = 1;
+NetSocket sd;
+
+    while (0 <= (sd = accept(listen_sd, OS_NULL, OS_NULL))) {
+        NetCtrlClient* cl_p = OS_NULL;
+        for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetCtrlClient); ++i) {
+            if (NET_SOCKET_UNDEF == clients_v[i].sd) {
+                cl_p = &clients_v[i];
+                break;
+            }
+        }
+        if (OS_NULL == cl_p) {
+            OS_LOG(D_WARNING, "Control clients limit");
+            NET_SOCKET_CLOSE(sd);
+            continue;
+        }
+        NET_SOCKET_IOCTL(sd, FIONBIO, &opt);
+        setsockopt(sd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+        cl_p->sd            = sd;
+        cl_p->rx_len        = 0;
+        cl_p->tx_len        = 0;
+        cl_p->tm_period_ms  = 0;
+        cl_p->tm_count      = 0;
+        OS_LOG(D_DEBUG, "Control client: %d", sd);
+    }
+}
+
+/*****************************************************************************/
+void ClientClose(NetCtrlClient* cl_p)
+{
+    OS_LOG(D_DEBUG, "Control client close: %d", cl_p->sd);
+    NET_SOCKET_CLOSE(cl_p->sd);
+    cl_p->sd = NET_SOCKET_UNDEF;
+}
+
+/*****************************************************************************/
+Status ClientServe(NetCtrlClient* cl_p, const OS_TimeMs now_ms)
+{
+Int len;
+Status s = S_UNDEF;
+
+    IF_STATUS(s = ClientFlush(cl_p)) { return s; }
+    //Drain the socket; many small requests are handled per poll.
+    while (sizeof(cl_p->rx_buf) > cl_p->rx_len) {
+        len = recv(cl_p->sd, cl_p->rx_buf + cl_p->rx_len, sizeof(cl_p->rx_buf) - cl_p->rx_len, MSG_DONTWAIT);
+        if (0 < len) {
+            cl_p->rx_len += len;
+            FramesProcess(cl_p, now_ms);
+            //Stop on the response backpressure; the rest stays in the socket.
+            if (FRAME_SIZE_MAX > (sizeof(cl_p->tx_buf) - cl_p->tx_len)) { break; }
+        } else if (0 == len) {
+            return S_NET_CTRL_DISCONNECTED;
+        } else {
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) { return S_NET_CTRL_FRAME_ERROR; }
+            break;
+        }
+    }
+    //Telemetry push.
+    if ((0 != cl_p->tm_period_ms) && ((S32)(now_ms - cl_p->tm_next_ms) >= 0)) {
+        cl_p->tm_next_ms += cl_p->tm_period_ms;
+        if ((S32)(now_ms - cl_p->tm_next_ms) >= 0) { cl_p->tm_next_ms = now_ms + cl_p->tm_period_ms; }
+        TelemetrySample(&cl_p->tm_v[cl_p->tm_count], now_ms);
+        if (cl_p->tm_batch <= ++cl_p->tm_count) {
+            if (FRAME_SIZE_MAX <= (sizeof(cl_p->tx_buf) - cl_p->tx_len)) {
+                const Size tm_len = cl_p->tm_count * sizeof(NetCtrlTelemetry);
+                OS_MemCpy(FramePayloadGet(cl_p), cl_p->tm_v, tm_len);
+                FrameCommit(cl_p, NET_CTRL_MSG_TELEMETRY_SUBSCRIBE | NET_CTRL_MSG_RESPONSE, 0, S_OK, tm_len);
+            }
+            cl_p->tm_count = 0;
+        }
+    }
+    return ClientFlush(cl_p);
+}
+
+/*****************************************************************************/
+Status ClientFlush(NetCtrlClient* cl_p)
+{
+Int len;
+    if (0 == cl_p->tx_len) { return S_OK; }
+    len = send(cl_p->sd, cl_p->tx_buf, cl_p->tx_len, MSG_DONTWAIT);
+    if (0 > len) {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? S_OK : S_NET_CTRL_FRAME_ERROR;
+    }
+    cl_p->tx_len -= len;
+    if (0 != cl_p->tx_len) {
+        OS_MemMov(cl_p->tx_buf, cl_p->tx_buf + len, cl_p->tx_len);
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+void FramesProcess(NetCtrlClient* cl_p, const OS_TimeMs now_ms)
+{
+NetCtrlHdr hdr;
+Size resp_len;
+Size pos = 0;
+U32 crc;
+Status s;
+
+    while ((cl_p->rx_len - pos) >= sizeof(NetCtrlHdr)) {
+        const U8* frame_p = cl_p->rx_buf + pos;
+        Size frame_size;
+        OS_MemCpy(&hdr, frame_p, sizeof(hdr));
+        if ((NET_CTRL_SYNC != hdr.sync) || (NET_CTRL_PAYLOAD_MAX < hdr.len)) {
+            //Resync on the next byte.
+            ++pos;
+            continue;
+        }
+        frame_size = FRAME_OVERHEAD + hdr.len;
+        if ((cl_p->rx_len - pos) < frame_size) { break; }
+        if (FRAME_SIZE_MAX > (sizeof(cl_p->tx_buf) - cl_p->tx_len)) { break; }
+        OS_MemCpy(&crc, frame_p + sizeof(hdr) + hdr.len, sizeof(crc));
+        resp_len = 0;
+        if (crc != Crc32((U8*)frame_p, sizeof(hdr) + hdr.len)) {
+            s = S_NET_CTRL_CRC_ERROR;
+        } else {
+            //Response payload is built in place in the transmit buffer.
+            s = RequestExecute(cl_p, &hdr, frame_p + sizeof(hdr), now_ms, FramePayloadGet(cl_p), &resp_len);
+        }
+        FrameCommit(cl_p, hdr.type | NET_CTRL_MSG_RESPONSE, hdr.seq, s, resp_len);
+        pos += frame_size;
+    }
+    cl_p->rx_len -= pos;
+    if ((0 != pos) && (0 != cl_p->rx_len)) {
+        OS_MemMov(cl_p->rx_buf, cl_p->rx_buf + pos, cl_p->rx_len);
+    }
+}
+
+/*****************************************************************************/
+U8* FramePayloadGet(NetCtrlClient* cl_p)
+{
+    return (cl_p->tx_buf + cl_p->tx_len + sizeof(NetCtrlHdr));
+}
+
+/*****************************************************************************/
+void FrameCommit(NetCtrlClient* cl_p, const U8 type, const U16 seq, const Status s, const Size len)
+{
+U8* frame_p = cl_p->tx_buf + cl_p->tx_len;
+const NetCtrlHdr hdr = {
+    .sync   = NET_CTRL_SYNC,
+    .type   = type,
+    .seq    = seq,
+    .len    = (U16)len,
+    .status = (U16)s
+};
+U32 crc;
+    OS_MemCpy(frame_p, &hdr, sizeof(hdr));
+    crc = Crc32(frame_p, sizeof(hdr) + len);
+    OS_MemCpy(frame_p + sizeof(hdr) + len, &crc, sizeof(crc));
+    cl_p->tx_len += FRAME_OVERHEAD + len;
+}
+
+/*****************************************************************************/
+Status RequestExecute(NetCtrlClient* cl_p, const NetCtrlHdr* hdr_p, const U8* payload_p,
+                      const OS_TimeMs now_ms, U8* resp_p, Size* resp_len_p)
+{
+NetCtrlAck ack = { .time_ms = now_ms };
+Status s = S_UNDEF;
+
+    switch (hdr_p->type) {
+        case NET_CTRL_MSG_PING: {
+            const NetCtrlPong pong = { .version = NET_CTRL_VERSION, .time_ms = now_ms };
+            OS_MemCpy(resp_p, &pong, sizeof(pong));
+            *resp_len_p = sizeof(pong);
+            return S_OK;
+            }
+        case NET_CTRL_MSG_PLAY:
+        case NET_CTRL_MSG_PAUSE:
+        case NET_CTRL_MSG_RESUME:
+        case NET_CTRL_MSG_STOP: {
+#if (OS_AUDIO_ENABLED)
+            static const OS_SignalId signals_v[] = {
+                OS_SIG_MMPLAY_PLAY, OS_SIG_MMPLAY_PAUSE, OS_SIG_MMPLAY_RESUME, OS_SIG_MMPLAY_STOP
+            };
+            NetCtrlCmd cmd;
+            if (sizeof(cmd) > hdr_p->len) { return S_INVALID_SIZE; }
+            OS_MemCpy(&cmd, payload_p, sizeof(cmd));
+            ack.timestamp = cmd.timestamp;
+            s = PlayerCommandSend(signals_v[hdr_p->type - NET_CTRL_MSG_PLAY], 0);
+#else
+            s = S_NET_CTRL_NO_PLAYER;
+#endif //(OS_AUDIO_ENABLED)
+            }
+            break;
+        case NET_CTRL_MSG_SEEK: {
+#if (OS_AUDIO_ENABLED)
+            NetCtrlCmdSeek cmd;
+            MMPlayStats mmplay_stats;
+            if (sizeof(cmd) > hdr_p->len) { return S_INVALID_SIZE; }
+            OS_MemCpy(&cmd, payload_p, sizeof(cmd));
+            ack.timestamp = cmd.timestamp;
+            //The player seeks constant byte rate files only; report it to the client.
+            IF_OK(s = MMPlayStatsGet(&mmplay_stats)) {
+                if (OS_TRUE == mmplay_stats.is_seekable) {
+                    s = PlayerCommandSend(OS_SIG_MMPLAY_SEEK, cmd.position_ms);
+                } else { s = S_NET_CTRL_SEEK_UNSUPPORTED; }
+            }
+#else
+            s = S_NET_CTRL_NO_PLAYER;
+#endif //(OS_AUDIO_ENABLED)
+            }
+            break;
+        case NET_CTRL_MSG_TELEMETRY_GET:
+            TelemetrySample((NetCtrlTelemetry*)resp_p, now_ms);
+            *resp_len_p = sizeof(NetCtrlTelemetry);
+            return S_OK;
+        case NET_CTRL_MSG_TELEMETRY_SUBSCRIBE: {
+            NetCtrlSubscribe sub;
+            if (sizeof(sub) > hdr_p->len) { return S_INVALID_SIZE; }
+            OS_MemCpy(&sub, payload_p, sizeof(sub));
+            if ((0 != sub.period_ms) && (APP_NET_CTRL_TELEMETRY_PERIOD_MIN > sub.period_ms)) {
+                sub.period_ms = APP_NET_CTRL_TELEMETRY_PERIOD_MIN;
+            }
+            if (0 == sub.batch) { sub.batch = 1; }
+            if (APP_NET_CTRL_TELEMETRY_BATCH_MAX < sub.batch) { sub.batch = APP_NET_CTRL_TELEMETRY_BATCH_MAX; }
+            cl_p->tm_period_ms  = sub.period_ms;
+            cl_p->tm_batch      = sub.batch;
+            cl_p->tm_count      = 0;
+            cl_p->tm_next_ms    = now_ms + sub.period_ms;
+            s = S_OK;
+            }
+            break;
+        default:
+            return S_INVALID_VALUE;
+    }
+    OS_MemCpy(resp_p, &ack, sizeof(ack));
+    *resp_len_p = sizeof(ack);
+    return s;
+}
+
+/*****************************************************************************/
+Status PlayerCommandSend(const OS_SignalId signal_id, const U32 data)
+{
+#if (OS_AUDIO_ENABLED)
+const OS_TaskHd mmplay_ctl_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY_CTL);
+    if (OS_NULL == OS_TaskByNameGet(APP_TASK_NAME_MMPLAY)) { return S_NET_CTRL_NO_PLAYER; }
+    if (OS_NULL == mmplay_ctl_thd) { return S_INVALID_STATE; }
+    //Control front-end passes it to the player; the seek position doesn't fit the signal data.
+    if (OS_SIG_MMPLAY_SEEK == signal_id) { return MMPlayCtlSeek(data); }
+    return OS_SignalSend(OS_TaskStdInGet(mmplay_ctl_thd), OS_SignalCreate(signal_id, 0), OS_MSG_PRIO_NORMAL);
+#else
+    return S_NET_CTRL_NO_PLAYER;
+#endif //(OS_AUDIO_ENABLED)
+}
+
+/*****************************************************************************/
+void TelemetrySample(NetCtrlTelemetry* tm_p, const OS_TimeMs now_ms)
+{
+NetStreamStats stream_stats;
+#if (OS_AUDIO_ENABLED)
+const OS_TaskHd mmplay_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY);
+MMPlayStats mmplay_stats;
+MemPoolStats pool_stats;
+#endif //(OS_AUDIO_ENABLED)
+
+    OS_MemSet(tm_p, 0, sizeof(NetCtrlTelemetry));
+    tm_p->time_ms               = now_ms;
+    tm_p->heap_app_free         = OS_MemoryFreeGet(OS_MEM_HEAP_APP);
+    tm_p->heap_sys_free         = OS_MemoryFreeGet(OS_MEM_HEAP_SYS);
+    tm_p->ram_ext_free          = OS_MemoryFreeGet(OS_MEM_RAM_EXT_SRAM);
+    tm_p->netserv_queue_depth   = OS_QueueItemsCountGet(OS_TaskStdInGet(OS_THIS_TASK));
+#if (OS_AUDIO_ENABLED)
+    if (OS_NULL != mmplay_thd) {
+        tm_p->mmplay_queue_depth = OS_QueueItemsCountGet(OS_TaskStdInGet(mmplay_thd));
+    }
+    IF_OK(MMPlayStatsGet(&mmplay_stats)) {
+        tm_p->mmplay_state          = mmplay_stats.state;
+        tm_p->decode_count          = mmplay_stats.decode_count;
+        tm_p->decode_time_last_ms   = mmplay_stats.decode_time_last_ms;
+        tm_p->decode_time_max_ms    = mmplay_stats.decode_time_max_ms;
+        tm_p->decode_underruns      = mmplay_stats.underruns;
+    }
+    for (Size i = 0; i < AudioBufPoolClassesCountGet(); ++i) {
+        IF_OK(AudioBufPoolStatsGet(i, &pool_stats)) {
+            tm_p->audio_bufs_used  += pool_stats.blocks_used;
+            tm_p->audio_bufs_fails += pool_stats.fails_count;
+        }
+    }
+#endif //(OS_AUDIO_ENABLED)
+    IF_OK(NetStreamStatsGet(&stream_stats)) {
+        tm_p->stream_state      = stream_stats.state;
+        tm_p->stream_level      = stream_stats.level;
+        tm_p->stream_underruns  = stream_stats.jb.underruns;
+    }
+}
+
+#endif //(OS_NETWORK_ENABLED)
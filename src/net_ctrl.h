@@ -0,0 +1,112 @@
+/***************************************************************************//**
+* @file    net_ctrl.h
+* @brief   Binary control and telemetry protocol server.
+* @author  A. Filyanov
+* @details Frame (little-endian):
+*          | NetCtrlHdr (8) | payload (len) | CRC32 (4) |
+*          CRC32 (IEEE 802.3, as Crc32()) covers the header and the payload.
+*          A response carries the request type ORed with NET_CTRL_MSG_RESPONSE
+*          and the request sequence number; the telemetry push has seq = 0.
+*******************************************************************************/
+#ifndef _NET_CTRL_H_
+#define _NET_CTRL_H_
+
+#include "net_socket.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+#define NET_CTRL_SYNC           0xD5
+#define NET_CTRL_VERSION        1
+#define NET_CTRL_PAYLOAD_MAX    (512)
+
+enum {
+    S_NET_CTRL_UNDEF = S_MODULE,
+    S_NET_CTRL_FRAME_ERROR,
+    S_NET_CTRL_CRC_ERROR,
+    S_NET_CTRL_NO_PLAYER,
+    S_NET_CTRL_DISCONNECTED,
+    S_NET_CTRL_SEEK_UNSUPPORTED,
+    S_NET_CTRL_LAST
+};
+
+typedef enum {
+    NET_CTRL_MSG_PING,                  // -> -, <- NetCtrlPong
+    NET_CTRL_MSG_PLAY,                  // -> NetCtrlCmd, <- NetCtrlAck
+    NET_CTRL_MSG_PAUSE,                 // -> NetCtrlCmd, <- NetCtrlAck
+    NET_CTRL_MSG_RESUME,                // -> NetCtrlCmd, <- NetCtrlAck
+    NET_CTRL_MSG_STOP,                  // -> NetCtrlCmd, <- NetCtrlAck
+    NET_CTRL_MSG_SEEK,                  // -> NetCtrlCmdSeek, <- NetCtrlAck (S_NET_CTRL_SEEK_UNSUPPORTED if not a WAV file)
+    NET_CTRL_MSG_TELEMETRY_GET,         // -> -, <- NetCtrlTelemetry[1]
+    NET_CTRL_MSG_TELEMETRY_SUBSCRIBE,   // -> NetCtrlSubscribe, <- NetCtrlAck; push <- NetCtrlTelemetry[batch]
+    NET_CTRL_MSG_LAST,
+    NET_CTRL_MSG_RESPONSE   = 0x80
+} NetCtrlMsgType;
+
+typedef struct {
+    U8              sync;
+    U8              type;
+    U16             seq;
+    U16             len;
+    U16             status;             // Response: request status.
+} NetCtrlHdr;
+
+typedef struct {
+    U32             timestamp;          // Client time; echoed in the response.
+} NetCtrlCmd;
+
+typedef struct {
+    U32             timestamp;
+    U32             position_ms;        // Rounded down to a sample frame.
+} NetCtrlCmdSeek;
+
+typedef struct {
+    U32             period_ms;          // Sampling period; 0 - unsubscribe.
+    U32             batch;              // Snapshots per push frame.
+} NetCtrlSubscribe;
+
+typedef struct {
+    U32             timestamp;          // Echoed request timestamp.
+    U32             time_ms;            // Device time of the execution.
+} NetCtrlAck;
+
+typedef struct {
+    U32             version;
+    U32             time_ms;
+} NetCtrlPong;
+
+typedef struct {
+    U32             time_ms;
+    U32             heap_app_free;
+    U32             heap_sys_free;
+    U32             ram_ext_free;
+    U16             mmplay_queue_depth;
+    U16             netserv_queue_depth;
+    U8              mmplay_state;
+    U8              stream_state;
+    U16             audio_bufs_used;
+    U32             audio_bufs_fails;
+    U32             decode_count;
+    U32             decode_time_last_ms;
+    U32             decode_time_max_ms;
+    U32             decode_underruns;
+    U32             stream_level;
+    U32             stream_underruns;
+} NetCtrlTelemetry;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init control server (listen on APP_NET_CTRL_PORT).
+/// @return     #Status.
+Status          NetCtrlInit(void);
+
+/// @brief      Serve control clients (NetServ context).
+/// @param[in]  now_ms         Current time.
+/// @return     #Status.
+Status          NetCtrlPoll(const OS_TimeMs now_ms);
+
+/// @brief      Get the poll period the server needs.
+/// @return     Period (ms).
+OS_TimeMs       NetCtrlPollPeriodGet(void);
+
+#endif //(OS_NETWORK_ENABLED)
+
+#endif // _NET_CTRL_H_
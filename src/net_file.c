@@ -0,0 +1,480 @@
+/***************************************************************************//**
+* @file    net_file.c
+* @brief   File transfer server (list, range read, resumable download).
+* @author  A. Filyanov
+*******************************************************************************/
+#include <errno.h>
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "net_file.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "net_file"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_net_file_v[0]
+
+#define FRAME_OVERHEAD          (sizeof(NetCtrlHdr) + sizeof(U32))
+#define FRAME_SIZE_MAX          (FRAME_OVERHEAD + sizeof(NetFileData) + APP_NET_FILE_CHUNK_SIZE)
+#define REQUEST_SIZE_MAX        (FRAME_OVERHEAD + sizeof(NetFileRead) + APP_NET_FILE_PATH_LEN)
+
+//-----------------------------------------------------------------------------
+const StatusItem status_net_file_v[] = {
+    {"Undefined status"},
+    {"Frame error"},
+    {"Disconnected"},
+    {"Path invalid"},
+};
+
+typedef enum {
+    NET_FILE_STATE_IDLE,
+    NET_FILE_STATE_LIST,
+    NET_FILE_STATE_LIST_END,
+    NET_FILE_STATE_READ
+} NetFileState;
+
+typedef struct {
+    NetSocket       sd;
+    NetFileState    state;
+    U16             seq;                // Request of the active transfer.
+    OS_FileHd       file_hd;
+    OS_DirHd        dir_hd;
+    U32             pos;
+    U32             end;
+    U32             credit;
+    U32             start_offset;
+    OS_TimeMs       start_ms;
+    Size            rx_len;
+    Size            tx_pos;
+    Size            tx_len;
+    U8*             tx_buf_p;
+    U8              rx_buf[REQUEST_SIZE_MAX];
+} NetFileClient;
+
+//-----------------------------------------------------------------------------
+static void     ClientsAccept(void);
+static void     ClientClose(NetFileClient* cl_p);
+static Status   ClientReceive(NetFileClient* cl_p, const OS_TimeMs now_ms);
+static Status   ClientFlush(NetFileClient* cl_p);
+static Bool     ClientProduce(NetFileClient* cl_p, const OS_TimeMs now_ms);
+static void     TransferEnd(NetFileClient* cl_p);
+static void     FramesProcess(NetFileClient* cl_p, const OS_TimeMs now_ms);
+static U8*      FramePayloadGet(NetFileClient* cl_p);
+static void     FrameCommit(NetFileClient* cl_p, const U8 type, const U16 seq, const Status s, const Size len);
+static Status   RequestExecute(NetFileClient* cl_p, const NetCtrlHdr* hdr_p, const U8* payload_p, const OS_TimeMs now_ms);
+static Status   PathGet(const U8* payload_p, const Size len, Str* path_str_p);
+
+//-----------------------------------------------------------------------------
+static NetSocket listen_sd = NET_SOCKET_UNDEF;
+static NetFileClient clients_v[APP_NET_FILE_CLIENTS_MAX];
+static Size client_next;
+static NetFileStats net_file_stats;
+
+/*****************************************************************************/
+Status NetFileInit(void)
+{
+struct sockaddr_in addr;
+int opt = 1;
+NetSocket sd;
+
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetFileClient); ++i) {
+        NetFileClient* cl_p = &clients_v[i];
+        cl_p->sd        = NET_SOCKET_UNDEF;
+        cl_p->tx_buf_p  = OS_MallocEx(APP_NET_FILE_TX_BUF_SIZE, APP_NET_FILE_BUF_MEMORY);
+        if (OS_NULL == cl_p->tx_buf_p) { return S_OUT_OF_MEMORY; }
+    }
+    sd = socket(AF_INET, SOCK_STREAM, 0);
+    if (0 > sd) { return S_OUT_OF_MEMORY; }
+    OS_MemSet(&addr, 0, sizeof(addr));
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons(APP_NET_FILE_PORT);
+    addr.sin_addr.s_addr    = htonl(INADDR_ANY);
+    setsockopt(sd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    NET_SOCKET_IOCTL(sd, FIONBIO, &opt);
+    if ((0 != bind(sd, (const struct sockaddr*)&addr, sizeof(addr))) ||
+        (0 != listen(sd, APP_NET_FILE_CLIENTS_MAX))) {
+        NET_SOCKET_CLOSE(sd);
+        return S_INVALID_STATE;
+    }
+    listen_sd = sd;
+    OS_LOG(D_INFO, "File port: %u", APP_NET_FILE_PORT);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status NetFilePoll(const OS_TimeMs now_ms)
+{
+Size budget = APP_NET_FILE_POLL_CHUNKS_MAX;
+Bool is_progress = OS_TRUE;
+
+    if (NET_SOCKET_UNDEF == listen_sd) { return S_OK; }
+    ClientsAccept();
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetFileClient); ++i) {
+        NetFileClient* cl_p = &clients_v[i];
+        if (NET_SOCKET_UNDEF != cl_p->sd) {
+            IF_STATUS(ClientReceive(cl_p, now_ms)) {
+                ClientClose(cl_p);
+            }
+        }
+    }
+    //The chunk budget is shared round-robin: the poll time is bounded however many
+    //transfers run, so the lower priority player keeps its CPU and SD card share.
+    while ((0 != budget) && (OS_TRUE == is_progress)) {
+        is_progress = OS_FALSE;
+        for (Size i = 0; (i < ITEMS_COUNT_GET(clients_v, NetFileClient)) && (0 != budget); ++i) {
+            NetFileClient* cl_p = &clients_v[(client_next + i) % APP_NET_FILE_CLIENTS_MAX];
+            if ((NET_SOCKET_UNDEF != cl_p->sd) && (OS_TRUE == ClientProduce(cl_p, now_ms))) {
+                is_progress = OS_TRUE;
+                --budget;
+            }
+        }
+    }
+    ++client_next;
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetFileClient); ++i) {
+        NetFileClient* cl_p = &clients_v[i];
+        if (NET_SOCKET_UNDEF != cl_p->sd) {
+            IF_STATUS(ClientFlush(cl_p)) {
+                ClientClose(cl_p);
+            }
+        }
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+OS_TimeMs NetFilePollPeriodGet(void)
+{
+    if (NET_SOCKET_UNDEF == listen_sd) { return OS_BLOCK; }
+    for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetFileClient); ++i) {
+        if (NET_SOCKET_UNDEF != clients_v[i].sd) { return APP_NETSERV_POLL_PERIOD; }
+    }
+    return APP_NET_CTRL_ACCEPT_POLL_PERIOD;
+}
+
+/*****************************************************************************/
+Status NetFileStatsGet(NetFileStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = net_file_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void ClientsAccept(void)
+{
+int opt = 1;
+NetSocket sd;
+
+    while (0 <= (sd = accept(listen_sd, OS_NULL, OS_NULL))) {
+        NetFileClient* cl_p = OS_NULL;
+        for (Size i = 0; i < ITEMS_COUNT_GET(clients_v, NetFileClient); ++i) {
+            if (NET_SOCKET_UNDEF == clients_v[i].sd) {
+                cl_p = &clients_v[i];
+                break;
+            }
+        }
+        if (OS_NULL == cl_p) {
+            OS_LOG(D_WARNING, "File clients limit");
+            NET_SOCKET_CLOSE(sd);
+            continue;
+        }
+        NET_SOCKET_IOCTL(sd, FIONBIO, &opt);
+        cl_p->sd        = sd;
+        cl_p->state     = NET_FILE_STATE_IDLE;
+        cl_p->rx_len    = 0;
+        cl_p->tx_pos    = 0;
+        cl_p->tx_len    = 0;
+        OS_LOG(D_DEBUG, "File client: %d", sd);
+    }
+}
+
+/*****************************************************************************/
+void ClientClose(NetFileClient* cl_p)
+{
+    OS_LOG(D_DEBUG, "File client close: %d", cl_p->sd);
+    TransferEnd(cl_p);
+    NET_SOCKET_CLOSE(cl_p->sd);
+    cl_p->sd = NET_SOCKET_UNDEF;
+}
+
+/*****************************************************************************/
+Status ClientReceive(NetFileClient* cl_p, const OS_TimeMs now_ms)
+{
+Int len;
+    //Frames held back by a full response buffer: no more data may come to retry them.
+    if (0 != cl_p->rx_len) { FramesProcess(cl_p, now_ms); }
+    while (sizeof(cl_p->rx_buf) > cl_p->rx_len) {
+        //Requests wait in the socket until there is room for the response.
+        if (REQUEST_SIZE_MAX > (APP_NET_FILE_TX_BUF_SIZE - cl_p->tx_len)) { break; }
+        len = recv(cl_p->sd, cl_p->rx_buf + cl_p->rx_len, sizeof(cl_p->rx_buf) - cl_p->rx_len, MSG_DONTWAIT);
+        if (0 < len) {
+            cl_p->rx_len += len;
+            FramesProcess(cl_p, now_ms);
+        } else if (0 == len) {
+            return S_NET_FILE_DISCONNECTED;
+        } else {
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) { return S_NET_FILE_FRAME_ERROR; }
+            break;
+        }
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status ClientFlush(NetFileClient* cl_p)
+{
+Int len;
+    if (cl_p->tx_pos == cl_p->tx_len) { return S_OK; }
+    len = send(cl_p->sd, cl_p->tx_buf_p + cl_p->tx_pos, cl_p->tx_len - cl_p->tx_pos, MSG_DONTWAIT);
+    if (0 > len) {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? S_OK : S_NET_FILE_FRAME_ERROR;
+    }
+    cl_p->tx_pos += len;
+    //The buffer is rewound only when drained: the frames are never moved.
+    if (cl_p->tx_pos == cl_p->tx_len) {
+        cl_p->tx_pos = 0;
+        cl_p->tx_len = 0;
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool ClientProduce(NetFileClient* cl_p, const OS_TimeMs now_ms)
+{
+U8* payload_p;
+Status s;
+
+    if (FRAME_SIZE_MAX > (APP_NET_FILE_TX_BUF_SIZE - cl_p->tx_len)) { return OS_FALSE; }
+    payload_p = FramePayloadGet(cl_p);
+    switch (cl_p->state) {
+        case NET_FILE_STATE_READ: {
+            const Size chunk = ((cl_p->end - cl_p->pos) > APP_NET_FILE_CHUNK_SIZE) ? APP_NET_FILE_CHUNK_SIZE : (cl_p->end - cl_p->pos);
+            const NetFileData data = { .offset = cl_p->pos };
+            if (0 == cl_p->credit) {
+                ++net_file_stats.credit_stalls;
+                return OS_FALSE;
+            }
+            OS_MemCpy(payload_p, &data, sizeof(data));
+            //File system reads straight into the outgoing frame.
+            IF_STATUS(s = OS_FileRead(cl_p->file_hd, payload_p + sizeof(data), chunk)) {
+                FrameCommit(cl_p, NET_FILE_MSG_DATA | NET_CTRL_MSG_RESPONSE, cl_p->seq, s, 0);
+                TransferEnd(cl_p);
+                return OS_TRUE;
+            }
+            FrameCommit(cl_p, NET_FILE_MSG_DATA | NET_CTRL_MSG_RESPONSE, cl_p->seq, S_OK, sizeof(data) + chunk);
+            --cl_p->credit;
+            cl_p->pos += chunk;
+            net_file_stats.bytes_sent += chunk;
+            if (cl_p->end == cl_p->pos) {
+                const OS_TimeMs time_ms = now_ms - cl_p->start_ms;
+                net_file_stats.rate_last = (U32)(((U64)(cl_p->end - cl_p->start_offset) * 1000) / ((0 == time_ms) ? 1 : time_ms));
+                TransferEnd(cl_p);
+            }
+            }
+            return OS_TRUE;
+        case NET_FILE_STATE_LIST: {
+            OS_FileStats file_stats;
+            Size len = 0;
+            while ((sizeof(NetFileEntry) + OS_FILE_NAME_LEN) <= (APP_NET_FILE_CHUNK_SIZE - len)) {
+                NetFileEntry entry = { 0 };
+                s = OS_DirRead(cl_p->dir_hd, &file_stats);
+                if ((S_OK != s) || ('\0' == file_stats.name[0])) {
+                    cl_p->state = NET_FILE_STATE_LIST_END;
+                    break;
+                }
+                entry.size      = file_stats.size;
+                entry.attrs     = file_stats.attrs;
+                entry.name_len  = (U8)OS_StrLen(file_stats.name);
+                OS_MemCpy(payload_p + len, &entry, sizeof(entry));
+                OS_MemCpy(payload_p + len + sizeof(entry), file_stats.name, entry.name_len);
+                len += sizeof(entry) + entry.name_len;
+            }
+            if (0 != len) {
+                FrameCommit(cl_p, NET_FILE_MSG_LIST | NET_CTRL_MSG_RESPONSE, cl_p->seq, S_OK, len);
+                return OS_TRUE;
+            }
+            }
+            //Empty response - list end.
+            FrameCommit(cl_p, NET_FILE_MSG_LIST | NET_CTRL_MSG_RESPONSE, cl_p->seq, S_OK, 0);
+            TransferEnd(cl_p);
+            return OS_TRUE;
+        case NET_FILE_STATE_LIST_END:
+            FrameCommit(cl_p, NET_FILE_MSG_LIST | NET_CTRL_MSG_RESPONSE, cl_p->seq, S_OK, 0);
+            TransferEnd(cl_p);
+            return OS_TRUE;
+        default:
+            break;
+    }
+    return OS_FALSE;
+}
+
+/*****************************************************************************/
+void TransferEnd(NetFileClient* cl_p)
+{
+    switch (cl_p->state) {
+        case NET_FILE_STATE_READ:
+            OS_FileClose(&cl_p->file_hd);
+            --net_file_stats.transfers_active;
+            break;
+        case NET_FILE_STATE_LIST:
+        case NET_FILE_STATE_LIST_END:
+            OS_DirClose(cl_p->dir_hd);
+            break;
+        default:
+            break;
+    }
+    cl_p->state = NET_FILE_STATE_IDLE;
+}
+
+/*****************************************************************************/
+void FramesProcess(NetFileClient* cl_p, const OS_TimeMs now_ms)
+{
+NetCtrlHdr hdr;
+Size pos = 0;
+U32 crc;
+Status s;
+
+    while ((cl_p->rx_len - pos) >= sizeof(NetCtrlHdr)) {
+        const U8* frame_p = cl_p->rx_buf + pos;
+        Size frame_size;
+        OS_MemCpy(&hdr, frame_p, sizeof(hdr));
+        if ((NET_CTRL_SYNC != hdr.sync) || ((REQUEST_SIZE_MAX - FRAME_OVERHEAD) < hdr.len)) {
+            //Resync on the next byte.
+            ++pos;
+            continue;
+        }
+        frame_size = FRAME_OVERHEAD + hdr.len;
+        if ((cl_p->rx_len - pos) < frame_size) { break; }
+        if (REQUEST_SIZE_MAX > (APP_NET_FILE_TX_BUF_SIZE - cl_p->tx_len)) { break; }
+        OS_MemCpy(&crc, frame_p + sizeof(hdr) + hdr.len, sizeof(crc));
+        if (crc != Crc32((U8*)frame_p, sizeof(hdr) + hdr.len)) {
+            FrameCommit(cl_p, hdr.type | NET_CTRL_MSG_RESPONSE, hdr.seq, S_NET_FILE_FRAME_ERROR, 0);
+        } else {
+            s = RequestExecute(cl_p, &hdr, frame_p + sizeof(hdr), now_ms);
+            //Requests with the data response commit it themselves.
+            if ((S_OK != s) || (NET_FILE_MSG_CANCEL == hdr.type)) {
+                FrameCommit(cl_p, hdr.type | NET_CTRL_MSG_RESPONSE, hdr.seq, s, 0);
+            }
+        }
+        pos += frame_size;
+    }
+    cl_p->rx_len -= pos;
+    if ((0 != pos) && (0 != cl_p->rx_len)) {
+        OS_MemMov(cl_p->rx_buf, cl_p->rx_buf + pos, cl_p->rx_len);
+    }
+}
+
+/*****************************************************************************/
+U8* FramePayloadGet(NetFileClient* cl_p)
+{
+    return (cl_p->tx_buf_p + cl_p->tx_len + sizeof(NetCtrlHdr));
+}
+
+/*****************************************************************************/
+void FrameCommit(NetFileClient* cl_p, const U8 type, const U16 seq, const Status s, const Size len)
+{
+U8* frame_p = cl_p->tx_buf_p + cl_p->tx_len;
+const NetCtrlHdr hdr = {
+    .sync   = NET_CTRL_SYNC,
+    .type   = type,
+    .seq    = seq,
+    .len    = (U16)len,
+    .status = (U16)s
+};
+U32 crc;
+    OS_MemCpy(frame_p, &hdr, sizeof(hdr));
+    crc = Crc32(frame_p, sizeof(hdr) + len);
+    OS_MemCpy(frame_p + sizeof(hdr) + len, &crc, sizeof(crc));
+    cl_p->tx_len += FRAME_OVERHEAD + len;
+}
+
+/*****************************************************************************/
+Status RequestExecute(NetFileClient* cl_p, const NetCtrlHdr* hdr_p, const U8* payload_p, const OS_TimeMs now_ms)
+{
+Str path_str[APP_NET_FILE_PATH_LEN];
+Status s = S_UNDEF;
+
+    switch (hdr_p->type) {
+        case NET_FILE_MSG_LIST:
+            TransferEnd(cl_p);
+            IF_OK(s = PathGet(payload_p, hdr_p->len, path_str)) {
+                IF_OK(s = OS_DirOpen(path_str, &cl_p->dir_hd)) {
+                    cl_p->seq   = hdr_p->seq;
+                    cl_p->state = NET_FILE_STATE_LIST;
+                }
+            }
+            break;
+        case NET_FILE_MSG_READ: {
+            NetFileRead req;
+            NetFileReadAck ack;
+            U32 file_size;
+            if (sizeof(req) > hdr_p->len) { return S_INVALID_SIZE; }
+            OS_MemCpy(&req, payload_p, sizeof(req));
+            TransferEnd(cl_p);
+            IF_STATUS(s = PathGet(payload_p + sizeof(req), hdr_p->len - sizeof(req), path_str)) { return s; }
+            IF_STATUS(s = OS_FileOpen(&cl_p->file_hd, path_str,
+                                      BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+                return s;
+            }
+            file_size = OS_FileSizeGet(cl_p->file_hd);
+            if (req.offset > file_size) { req.offset = file_size; }
+            if ((0 == req.length) || (req.length > (file_size - req.offset))) {
+                req.length = file_size - req.offset;
+            }
+            IF_STATUS(s = OS_FileLSeek(cl_p->file_hd, req.offset)) {
+                OS_FileClose(&cl_p->file_hd);
+                return s;
+            }
+            cl_p->seq       = hdr_p->seq;
+            cl_p->pos       = req.offset;
+            cl_p->start_offset = req.offset;
+            cl_p->end       = req.offset + req.length;
+            cl_p->credit    = (APP_NET_FILE_CREDIT_MAX < req.credit) ? APP_NET_FILE_CREDIT_MAX : req.credit;
+            cl_p->start_ms  = now_ms;
+            cl_p->state     = NET_FILE_STATE_READ;
+            ++net_file_stats.transfers;
+            ++net_file_stats.transfers_active;
+            ack.file_size   = file_size;
+            ack.offset      = req.offset;
+            ack.length      = req.length;
+            OS_MemCpy(FramePayloadGet(cl_p), &ack, sizeof(ack));
+            FrameCommit(cl_p, NET_FILE_MSG_READ | NET_CTRL_MSG_RESPONSE, hdr_p->seq, S_OK, sizeof(ack));
+            //Zero length read completes with the response.
+            if (cl_p->pos == cl_p->end) { TransferEnd(cl_p); }
+            }
+            break;
+        case NET_FILE_MSG_CREDIT: {
+            NetFileCredit credit;
+            if (sizeof(credit) > hdr_p->len) { return S_INVALID_SIZE; }
+            OS_MemCpy(&credit, payload_p, sizeof(credit));
+            cl_p->credit = ((APP_NET_FILE_CREDIT_MAX - cl_p->credit) < credit.chunks) ? APP_NET_FILE_CREDIT_MAX :
+                                                                                       (cl_p->credit + credit.chunks);
+            s = S_OK;
+            }
+            break;
+        case NET_FILE_MSG_CANCEL:
+            TransferEnd(cl_p);
+            s = S_OK;
+            break;
+        default:
+            s = S_INVALID_VALUE;
+            break;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status PathGet(const U8* payload_p, const Size len, Str* path_str_p)
+{
+Size path_len = len;
+    //Accept the path with or without the terminator.
+    if ((0 != path_len) && ('\0' == payload_p[path_len - 1])) { --path_len; }
+    if ((0 == path_len) || (APP_NET_FILE_PATH_LEN <= path_len)) { return S_NET_FILE_PATH_INVALID; }
+    OS_MemCpy(path_str_p, payload_p, path_len);
+    path_str_p[path_len] = '\0';
+    return S_OK;
+}
+
+#endif //(OS_NETWORK_ENABLED)
@@ -0,0 +1,90 @@
+/***************************************************************************//**
+* @file    net_file.h
+* @brief   File transfer server (list, range read, resumable download).
+* @author  A. Filyanov
+* @details Frames are the control protocol ones (see net_ctrl.h) on their own
+*          port. A read is paced by the client credit: every DATA frame takes
+*          one credit, NET_FILE_MSG_CREDIT adds more. A download is resumed
+*          by a read from the offset of the last byte received.
+*******************************************************************************/
+#ifndef _NET_FILE_H_
+#define _NET_FILE_H_
+
+#include "net_ctrl.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+enum {
+    S_NET_FILE_UNDEF = S_MODULE,
+    S_NET_FILE_FRAME_ERROR,
+    S_NET_FILE_DISCONNECTED,
+    S_NET_FILE_PATH_INVALID,
+    S_NET_FILE_LAST
+};
+
+typedef enum {
+    NET_FILE_MSG_LIST,                  // -> path, <- NetFileEntry[] ... <- (empty: list end)
+    NET_FILE_MSG_READ,                  // -> NetFileRead + path, <- NetFileReadAck; DATA <- NetFileData + data
+    NET_FILE_MSG_CREDIT,                // -> NetFileCredit (no response)
+    NET_FILE_MSG_CANCEL,                // -> -, <- -
+    NET_FILE_MSG_DATA,
+    NET_FILE_MSG_LAST
+} NetFileMsgType;
+
+typedef struct {
+    U32             size;
+    U8              attrs;
+    U8              name_len;           // Name (no terminator) follows.
+    U16             reserved;
+} NetFileEntry;
+
+typedef struct {
+    U32             offset;
+    U32             length;             // 0 - up to the file end.
+    U32             credit;             // DATA frames allowed in flight.
+} NetFileRead;
+
+typedef struct {
+    U32             file_size;
+    U32             offset;
+    U32             length;
+} NetFileReadAck;
+
+typedef struct {
+    U32             chunks;
+} NetFileCredit;
+
+typedef struct {
+    U32             offset;             // File offset of the data.
+} NetFileData;
+
+typedef struct {
+    U32             transfers;
+    U32             transfers_active;
+    U32             bytes_sent;
+    U32             credit_stalls;      // Chunks held back by the client credit.
+    U32             rate_last;          // Last completed transfer throughput (bytes/s).
+} NetFileStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init file server (listen on APP_NET_FILE_PORT).
+/// @return     #Status.
+Status          NetFileInit(void);
+
+/// @brief      Serve file clients (NetServ context).
+/// @param[in]  now_ms         Current time.
+/// @return     #Status.
+Status          NetFilePoll(const OS_TimeMs now_ms);
+
+/// @brief      Get the poll period the server needs.
+/// @return     Period (ms).
+OS_TimeMs       NetFilePollPeriodGet(void);
+
+/// @brief      Get file server statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          NetFileStatsGet(NetFileStats* stats_p);
+
+#endif //(OS_NETWORK_ENABLED)
+
+#endif // _NET_FILE_H_
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+* @file    net_socket.h
+* @brief   BSD sockets API selection.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _NET_SOCKET_H_
+#define _NET_SOCKET_H_
+
+#include "os_common.h"
+
+#if (OS_NETWORK_ENABLED)
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#define NET_SOCKET_CLOSE(sd)            close(sd)
+#define NET_SOCKET_IOCTL(sd, cmd, arg)  ioctl(sd, cmd, arg)
+#else
+#include "lwip/sockets.h"
+#define NET_SOCKET_CLOSE(sd)            lwip_close(sd)
+#define NET_SOCKET_IOCTL(sd, cmd, arg)  lwip_ioctl(sd, cmd, arg)
+#endif // defined(__linux__)
+
+//-----------------------------------------------------------------------------
+#define NET_SOCKET_UNDEF                (-1)
+
+typedef int NetSocket;
+
+#endif //(OS_NETWORK_ENABLED)
+
+#endif // _NET_SOCKET_H_
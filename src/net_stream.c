@@ -0,0 +1,448 @@
+/***************************************************************************//**
+* @file    net_stream.c
+* @brief   Network audio stream ingest.
+* @author  A. Filyanov
+*******************************************************************************/
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include "os_time.h"
+#include "os_memory.h"
+#include "app_common.h"
+#include "net_stream.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "net_stream"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_net_stream_v[0]
+
+#define URL_HTTP_STR            "http://"
+#define URL_TCP_STR             "tcp://"
+#define HTTP_PORT_DEFAULT       80
+#define HTTP_HDR_SIZE           512
+#define HTTP_HDR_END_STR        "\r\n\r\n"
+
+//-----------------------------------------------------------------------------
+const StatusItem status_net_stream_v[] = {
+    {"Undefined status"},
+    {"Invalid URL"},
+    {"Connect error"},
+    {"Request error"},
+    {"Response error"},
+    {"Probe timeout"},
+};
+
+typedef struct {
+    JitterBuf       jb;
+    NetSocket       sd;
+    volatile NetStreamState state;
+    OS_TimeMs       connect_start_ms;
+    Bool            is_http;
+    Size            hdr_len;            // Request length till the connect, then the response one.
+    char            hdr_buf[HTTP_HDR_SIZE];
+    U8*             probe_buf_p;
+    Size            probe_size;
+    Status          probe_s;            // S_UNDEF while pending.
+    OS_TimeMs       probe_start_ms;
+    OS_QueueHd      probe_qhd;          // OS_NULL once signalled.
+    OS_SignalId     probe_signal_id;
+} NetStream;
+
+//-----------------------------------------------------------------------------
+static Status   UrlParse(ConstStrP url_str_p, struct sockaddr_in* addr_p, Str* path_str_p, Bool* is_http_p);
+static Status   Connect(const struct sockaddr_in* addr_p);
+static Status   ConnectPoll(const OS_TimeMs now_ms);
+static Status   HeadersReceive(const OS_TimeMs now_ms);
+static void     ProbeCheck(const OS_TimeMs now_ms);
+
+//-----------------------------------------------------------------------------
+static NetStream net_stream = { .sd = NET_SOCKET_UNDEF, .state = NET_STREAM_STATE_IDLE };
+
+/*****************************************************************************/
+Status NetStreamInit(void)
+{
+void* buf_p = OS_MallocEx(APP_NET_STREAM_BUF_SIZE, APP_NET_STREAM_BUF_MEMORY);
+    if (OS_NULL == buf_p) { return S_OUT_OF_MEMORY; }
+    //Reused by every stream: no allocations per play.
+    net_stream.probe_buf_p = OS_MallocEx(APP_NET_STREAM_PROBE_SIZE, APP_NET_STREAM_BUF_MEMORY);
+    if (OS_NULL == net_stream.probe_buf_p) {
+        OS_FreeEx(buf_p, APP_NET_STREAM_BUF_MEMORY);
+        return S_OUT_OF_MEMORY;
+    }
+    net_stream.sd    = NET_SOCKET_UNDEF;
+    net_stream.state = NET_STREAM_STATE_IDLE;
+    return JitterBufInit(&net_stream.jb, buf_p, APP_NET_STREAM_BUF_SIZE, APP_NET_STREAM_BYTE_RATE_DEFAULT,
+                         APP_NET_STREAM_DEPTH_MIN, APP_NET_STREAM_DEPTH_MAX);
+}
+
+/*****************************************************************************/
+Bool NetStreamIsUrl(ConstStrP str_p)
+{
+    if (OS_NULL == str_p) { return OS_FALSE; }
+    return (!OS_StrNCmp(str_p, URL_HTTP_STR, OS_StrLen(URL_HTTP_STR)) ||
+            !OS_StrNCmp(str_p, URL_TCP_STR,  OS_StrLen(URL_TCP_STR))) ? OS_TRUE : OS_FALSE;
+}
+
+/*****************************************************************************/
+Status NetStreamOpen(const NetStreamOpenArgs* args_p)
+{
+ConstStrP url_str_p = args_p->url_str;
+struct sockaddr_in addr;
+Str path_str[APP_NET_STREAM_URL_LEN];
+Status s = S_UNDEF;
+
+    //A new stream supersedes the active one.
+    NetStreamClose();
+    net_stream.probe_size       = 0;
+    net_stream.probe_s          = S_UNDEF;
+    net_stream.probe_start_ms   = OS_TICKS_TO_MS(OS_TickCountGet());
+    net_stream.probe_signal_id  = args_p->probe_signal_id;
+    net_stream.probe_qhd        = args_p->probe_qhd;
+    IF_OK(s = UrlParse(url_str_p, &addr, path_str, &net_stream.is_http)) {
+        JitterBufReset(&net_stream.jb);
+        JitterBufByteRateSet(&net_stream.jb, APP_NET_STREAM_BYTE_RATE_DEFAULT);
+        net_stream.hdr_len = 0;
+        if (OS_TRUE == net_stream.is_http) {
+            //Sent once connected.
+            const Int len = snprintf(net_stream.hdr_buf, sizeof(net_stream.hdr_buf),
+                                     "GET %s HTTP/1.0\r\nIcy-MetaData: 0\r\n\r\n", path_str);
+            if ((0 > len) || (sizeof(net_stream.hdr_buf) <= (Size)len)) {
+                s = S_NET_STREAM_REQUEST_ERROR;
+            } else {
+                net_stream.hdr_len = len;
+            }
+        }
+        IF_OK(s) {
+            //Completed by NetStreamReceive().
+            s = Connect(&addr);
+        }
+    }
+    IF_STATUS(s) {
+        net_stream.state = NET_STREAM_STATE_ERROR;
+        net_stream.probe_s = s;
+        ProbeCheck(net_stream.probe_start_ms);
+        OS_LOG_S(D_WARNING, s);
+    } else {
+        OS_LOG(D_INFO, "Stream open: %s", url_str_p);
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status NetStreamClose(void)
+{
+    if (NET_SOCKET_UNDEF != net_stream.sd) {
+        NET_SOCKET_CLOSE(net_stream.sd);
+        net_stream.sd = NET_SOCKET_UNDEF;
+    }
+    net_stream.state = NET_STREAM_STATE_IDLE;
+    //The consumer has gone: no probe end signal.
+    net_stream.probe_qhd = OS_NULL;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status NetStreamReceive(const OS_TimeMs now_ms)
+{
+Size size;
+U8* data_p;
+Int len;
+Status s = S_OK;
+
+    if (NET_STREAM_STATE_CONNECTING == net_stream.state) {
+        s = ConnectPoll(now_ms);
+        ProbeCheck(now_ms);
+        return s;
+    }
+    if (NET_STREAM_STATE_HEADERS == net_stream.state) {
+        s = HeadersReceive(now_ms);
+        ProbeCheck(now_ms);
+        return s;
+    }
+    if (NET_STREAM_STATE_STREAMING != net_stream.state) {
+        ProbeCheck(now_ms);
+        return s;
+    }
+    //Zero-copy receive straight into the jitter buffer storage.
+    //A full buffer leaves data in the socket, so TCP flow control throttles the sender.
+    for (;;) {
+        data_p = JitterBufWriteReserve(&net_stream.jb, &size);
+        if (0 == size) { break; }
+        if (APP_NET_STREAM_RECV_CHUNK_SIZE < size) { size = APP_NET_STREAM_RECV_CHUNK_SIZE; }
+        len = recv(net_stream.sd, data_p, size, MSG_DONTWAIT);
+        if (0 > len) {
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+                OS_LOG(D_WARNING, "Stream error: %d", errno);
+                net_stream.state = NET_STREAM_STATE_ERROR;
+                NET_SOCKET_CLOSE(net_stream.sd);
+                net_stream.sd = NET_SOCKET_UNDEF;
+            }
+            break;
+        } else if (0 == len) {
+            OS_LOG(D_INFO, "Stream end");
+            net_stream.state = NET_STREAM_STATE_EOS;
+            NET_SOCKET_CLOSE(net_stream.sd);
+            net_stream.sd = NET_SOCKET_UNDEF;
+            break;
+        }
+        JitterBufWriteCommit(&net_stream.jb, (Size)len, now_ms);
+        if ((Size)len < size) { break; }
+    }
+    ProbeCheck(now_ms);
+    return s;
+}
+
+/*****************************************************************************/
+Status NetStreamProbeGet(const U8** data_pp, Size* size_p)
+{
+    if ((OS_NULL == data_pp) || (OS_NULL == size_p)) { return S_INVALID_PTR; }
+    *data_pp = net_stream.probe_buf_p;
+    *size_p  = net_stream.probe_size;
+    return net_stream.probe_s;
+}
+
+/*****************************************************************************/
+Bool NetStreamIsProbing(void)
+{
+    return (OS_NULL != net_stream.probe_qhd) ? OS_TRUE : OS_FALSE;
+}
+
+/*****************************************************************************/
+NetSocket NetStreamSocketGet(void)
+{
+    return net_stream.sd;
+}
+
+/*****************************************************************************/
+NetStreamState NetStreamStateGet(void)
+{
+    return net_stream.state;
+}
+
+/*****************************************************************************/
+void NetStreamByteRateSet(const U32 byte_rate)
+{
+    JitterBufByteRateSet(&net_stream.jb, byte_rate);
+}
+
+/*****************************************************************************/
+Size NetStreamRead(U8* data_p, const Size size)
+{
+    if (NET_STREAM_STATE_STREAMING < net_stream.state) { JitterBufDrain(&net_stream.jb); }
+    return JitterBufRead(&net_stream.jb, data_p, size);
+}
+
+/*****************************************************************************/
+Size NetStreamReadPcm(U8* data_p, const Size frames, const Size frame_size)
+{
+Size frames_rd;
+    if (NET_STREAM_STATE_STREAMING < net_stream.state) {
+        JitterBufDrain(&net_stream.jb);
+        frames_rd = JitterBufReadPcm(&net_stream.jb, data_p, frames, frame_size);
+        //Drop the trailing partial sample frame.
+        if (0 == frames_rd) { JitterBufReset(&net_stream.jb); }
+        return frames_rd;
+    }
+    return JitterBufReadPcm(&net_stream.jb, data_p, frames, frame_size);
+}
+
+/*****************************************************************************/
+Size NetStreamPeek(U8* data_p, const Size size)
+{
+    return JitterBufPeek(&net_stream.jb, data_p, size);
+}
+
+/*****************************************************************************/
+Bool NetStreamIsEnd(void)
+{
+    return (((NET_STREAM_STATE_EOS   == net_stream.state) ||
+             (NET_STREAM_STATE_ERROR == net_stream.state)) &&
+            (0 == JitterBufLevelGet(&net_stream.jb))) ? OS_TRUE : OS_FALSE;
+}
+
+/*****************************************************************************/
+Status NetStreamStatsGet(NetStreamStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    stats_p->state          = net_stream.state;
+    stats_p->level          = JitterBufLevelGet(&net_stream.jb);
+    stats_p->depth_target_ms= JitterBufDepthTargetMsGet(&net_stream.jb);
+    stats_p->drift_ppm      = net_stream.jb.drift_ppm;
+    stats_p->jb             = net_stream.jb.stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status UrlParse(ConstStrP url_str_p, struct sockaddr_in* addr_p, Str* path_str_p, Bool* is_http_p)
+{
+Str host_str[16];
+ConstStrP host_p;
+ConstStrP path_p;
+ConstStrP port_p;
+Size host_len;
+U32 port;
+
+    if (!OS_StrNCmp(url_str_p, URL_HTTP_STR, OS_StrLen(URL_HTTP_STR))) {
+        host_p      = url_str_p + OS_StrLen(URL_HTTP_STR);
+        port        = HTTP_PORT_DEFAULT;
+        *is_http_p  = OS_TRUE;
+    } else if (!OS_StrNCmp(url_str_p, URL_TCP_STR, OS_StrLen(URL_TCP_STR))) {
+        host_p      = url_str_p + OS_StrLen(URL_TCP_STR);
+        port        = 0;
+        *is_http_p  = OS_FALSE;
+    } else { return S_NET_STREAM_URL_INVALID; }
+    path_p = OS_StrChr(host_p, '/');
+    if (OS_NULL == path_p) { path_p = host_p + OS_StrLen(host_p); }
+    port_p = OS_StrChr(host_p, ':');
+    if ((OS_NULL != port_p) && (port_p < path_p)) {
+        port = OS_StrToUL(port_p + 1, OS_NULL, 10);
+    } else {
+        port_p = path_p;
+    }
+    host_len = port_p - host_p;
+    if ((0 == host_len) || (sizeof(host_str) <= host_len)) { return S_NET_STREAM_URL_INVALID; }
+    if ((0 == port) || (U16_MAX < port)) { return S_NET_STREAM_URL_INVALID; }
+    if (APP_NET_STREAM_URL_LEN <= OS_StrLen(path_p)) { return S_INVALID_SIZE; }
+    OS_MemCpy(host_str, host_p, host_len);
+    host_str[host_len] = '\0';
+    OS_MemSet(addr_p, 0, sizeof(*addr_p));
+    addr_p->sin_family      = AF_INET;
+    addr_p->sin_port        = htons((U16)port);
+    //IPv4 address literals only (no resolver).
+    addr_p->sin_addr.s_addr = inet_addr(host_str);
+    if (INADDR_NONE == addr_p->sin_addr.s_addr) { return S_NET_STREAM_URL_INVALID; }
+    OS_StrCpy(path_str_p, ('\0' == *path_p) ? "/" : path_p);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status Connect(const struct sockaddr_in* addr_p)
+{
+int opt = 1;
+NetSocket sd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (0 > sd) { return S_NET_STREAM_CONNECT_ERROR; }
+    //Non-blocking connect: NetServ polls it, so the other services are not stalled.
+    NET_SOCKET_IOCTL(sd, FIONBIO, &opt);
+    setsockopt(sd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    if ((0 != connect(sd, (const struct sockaddr*)addr_p, sizeof(*addr_p))) && (EINPROGRESS != errno)) {
+        NET_SOCKET_CLOSE(sd);
+        return S_NET_STREAM_CONNECT_ERROR;
+    }
+    net_stream.sd               = sd;
+    net_stream.connect_start_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+    net_stream.state            = NET_STREAM_STATE_CONNECTING;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status ConnectPoll(const OS_TimeMs now_ms)
+{
+struct timeval tv = { .tv_sec = 0, .tv_usec = 0 };
+fd_set wr_set;
+int err = 0;
+socklen_t err_len = sizeof(err);
+Int ready;
+Status s = S_OK;
+
+    FD_ZERO(&wr_set);
+    FD_SET(net_stream.sd, &wr_set);
+    ready = select(net_stream.sd + 1, OS_NULL, &wr_set, OS_NULL, &tv);
+    if (0 == ready) {
+        if (APP_NET_STREAM_CONNECT_TIMEOUT > (now_ms - net_stream.connect_start_ms)) { return S_OK; }
+        s = S_NET_STREAM_CONNECT_ERROR;
+    } else if ((0 > ready) || (0 != getsockopt(net_stream.sd, SOL_SOCKET, SO_ERROR, &err, &err_len)) || (0 != err)) {
+        s = S_NET_STREAM_CONNECT_ERROR;
+    } else if (OS_TRUE == net_stream.is_http) {
+        //The request fits the empty socket send buffer.
+        if ((Int)net_stream.hdr_len != send(net_stream.sd, net_stream.hdr_buf, net_stream.hdr_len, 0)) {
+            s = S_NET_STREAM_REQUEST_ERROR;
+        } else {
+            net_stream.hdr_len  = 0;
+            net_stream.state    = NET_STREAM_STATE_HEADERS;
+        }
+    } else {
+        net_stream.state = NET_STREAM_STATE_STREAMING;
+    }
+    IF_STATUS(s) {
+        NET_SOCKET_CLOSE(net_stream.sd);
+        net_stream.sd       = NET_SOCKET_UNDEF;
+        net_stream.state    = NET_STREAM_STATE_ERROR;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status HeadersReceive(const OS_TimeMs now_ms)
+{
+const Size room = sizeof(net_stream.hdr_buf) - 1 - net_stream.hdr_len;
+ConstStrP end_p;
+ConstStrP code_p;
+Size body_len;
+Int len;
+Status s = S_OK;
+
+    if (0 == room) {
+        s = S_NET_STREAM_RESPONSE_ERROR;
+    } else {
+        len = recv(net_stream.sd, net_stream.hdr_buf + net_stream.hdr_len, room, MSG_DONTWAIT);
+        if (0 == len) {
+            s = S_NET_STREAM_RESPONSE_ERROR;
+        } else if (0 > len) {
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) { return S_OK; }
+            s = S_NET_STREAM_RESPONSE_ERROR;
+        } else {
+            net_stream.hdr_len += len;
+            net_stream.hdr_buf[net_stream.hdr_len] = '\0';
+            end_p = strstr(net_stream.hdr_buf, HTTP_HDR_END_STR);
+            if (OS_NULL == end_p) { return S_OK; }
+            //Status line: "HTTP/1.x 200 OK" or "ICY 200 OK" (the status code is its second token).
+            code_p = OS_StrChr(net_stream.hdr_buf, ' ');
+            if ((OS_NULL == code_p) || (strstr(net_stream.hdr_buf, "\r\n") < code_p) ||
+                OS_StrNCmp(code_p, " 200 ", OS_StrLen(" 200 "))) {
+                OS_LOG(D_WARNING, "Stream rejected: %.32s", net_stream.hdr_buf);
+                s = S_NET_STREAM_RESPONSE_ERROR;
+            } else {
+                end_p += OS_StrLen(HTTP_HDR_END_STR);
+                body_len = net_stream.hdr_len - (end_p - net_stream.hdr_buf);
+                if (0 != body_len) {
+                    JitterBufWrite(&net_stream.jb, (const U8*)end_p, body_len, now_ms);
+                }
+                net_stream.state = NET_STREAM_STATE_STREAMING;
+            }
+        }
+    }
+    IF_STATUS(s) {
+        NET_SOCKET_CLOSE(net_stream.sd);
+        net_stream.sd       = NET_SOCKET_UNDEF;
+        net_stream.state    = NET_STREAM_STATE_ERROR;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+void ProbeCheck(const OS_TimeMs now_ms)
+{
+    if (OS_NULL == net_stream.probe_qhd) { return; }
+    if (S_UNDEF == net_stream.probe_s) {
+        if (NET_STREAM_STATE_ERROR == net_stream.state) {
+            net_stream.probe_s = S_NET_STREAM_RESPONSE_ERROR;
+        } else if ((NET_STREAM_STATE_EOS == net_stream.state) ||
+                   ((NET_STREAM_STATE_STREAMING == net_stream.state) &&
+                    (APP_NET_STREAM_PROBE_SIZE <= JitterBufLevelGet(&net_stream.jb)))) {
+            //The consumer doesn't read till the signal, so the head stays put.
+            net_stream.probe_size = JitterBufPeek(&net_stream.jb, net_stream.probe_buf_p, APP_NET_STREAM_PROBE_SIZE);
+            net_stream.probe_s    = S_OK;
+        } else if (APP_NET_STREAM_PROBE_TIMEOUT <= (now_ms - net_stream.probe_start_ms)) {
+            net_stream.probe_s = S_NET_STREAM_PROBE_TIMEOUT;
+        } else { return; }
+    }
+    //A full consumer queue: retried on the next poll.
+    const OS_Signal signal = OS_SignalCreate(net_stream.probe_signal_id, 0);
+    IF_OK(OS_SignalSend(net_stream.probe_qhd, signal, OS_MSG_PRIO_NORMAL)) {
+        net_stream.probe_qhd = OS_NULL;
+    }
+}
+
+#endif //(OS_NETWORK_ENABLED)
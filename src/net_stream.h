@@ -0,0 +1,126 @@
+/***************************************************************************//**
+* @file    net_stream.h
+* @brief   Network audio stream ingest.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _NET_STREAM_H_
+#define _NET_STREAM_H_
+
+#include "jitter_buf.h"
+#include "net_socket.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+enum {
+    S_NET_STREAM_UNDEF = S_MODULE,
+    S_NET_STREAM_URL_INVALID,
+    S_NET_STREAM_CONNECT_ERROR,
+    S_NET_STREAM_REQUEST_ERROR,
+    S_NET_STREAM_RESPONSE_ERROR,
+    S_NET_STREAM_PROBE_TIMEOUT,
+    S_NET_STREAM_LAST
+};
+
+typedef enum {
+    NET_STREAM_STATE_IDLE,
+    NET_STREAM_STATE_CONNECTING,
+    NET_STREAM_STATE_HEADERS,
+    NET_STREAM_STATE_STREAMING,
+    NET_STREAM_STATE_EOS,
+    NET_STREAM_STATE_ERROR,
+    NET_STREAM_STATE_LAST
+} NetStreamState;
+
+typedef struct {
+    NetStreamState  state;
+    Size            level;
+    U32             depth_target_ms;
+    S32             drift_ppm;
+    JitterBufStats  jb;
+} NetStreamStats;
+
+typedef struct {
+    OS_QueueHd      probe_qhd;          // Probe end signal receiver.
+    OS_SignalId     probe_signal_id;
+    Str             url_str[APP_NET_STREAM_URL_LEN];
+} NetStreamOpenArgs;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init network stream (reserve the jitter buffer memory).
+/// @return     #Status.
+Status          NetStreamInit(void);
+
+/// @brief      Check the string is a network stream URL.
+/// @param[in]  str_p          String.
+/// @return     Is URL ("http://host[:port]/path" or "tcp://host:port[/name]").
+Bool            NetStreamIsUrl(ConstStrP str_p);
+
+/// @brief      Open network stream (NetServ context).
+/// @param[in]  args_p         Stream URL (IPv4 host address) and the probe end signal.
+/// @return     #Status.
+/// @details    Connect is completed by NetStreamReceive() polls. The probe end signal is sent
+///             once the stream head is buffered (or the stream has failed); see NetStreamProbeGet().
+Status          NetStreamOpen(const NetStreamOpenArgs* args_p);
+
+/// @brief      Close network stream (NetServ context).
+/// @return     #Status.
+Status          NetStreamClose(void);
+
+/// @brief      Receive pending stream data into the jitter buffer (NetServ context).
+/// @param[in]  now_ms         Current time.
+/// @return     #Status.
+Status          NetStreamReceive(const OS_TimeMs now_ms);
+
+/// @brief      Get the stream head for the format detection (consumer context).
+/// @param[out] data_pp        Stream head data.
+/// @param[out] size_p         Stream head size.
+/// @return     #Status (S_UNDEF while the probe is pending).
+Status          NetStreamProbeGet(const U8** data_pp, Size* size_p);
+
+/// @brief      Is the probe end signal pending.
+/// @return     Is pending.
+Bool            NetStreamIsProbing(void);
+
+/// @brief      Get network stream socket.
+/// @return     Socket or NET_SOCKET_UNDEF.
+NetSocket       NetStreamSocketGet(void);
+
+/// @brief      Get network stream state.
+/// @return     State.
+NetStreamState  NetStreamStateGet(void);
+
+/// @brief      Set the stream byte rate (known after the format detection).
+/// @param[in]  byte_rate      Byte rate (bytes per second).
+void            NetStreamByteRateSet(const U32 byte_rate);
+
+/// @brief      Read stream data (consumer context).
+/// @param[out] data_p         Data.
+/// @param[in]  size           Data size.
+/// @return     Read size.
+Size            NetStreamRead(U8* data_p, const Size size);
+
+/// @brief      Read stream PCM sample frames with clock-drift compensation (consumer context).
+/// @param[out] data_p         Data.
+/// @param[in]  frames         Sample frames count.
+/// @param[in]  frame_size     Sample frame size.
+/// @return     Read sample frames count.
+Size            NetStreamReadPcm(U8* data_p, const Size frames, const Size frame_size);
+
+/// @brief      Peek stream data (consumer context).
+/// @param[out] data_p         Data.
+/// @param[in]  size           Data size.
+/// @return     Peeked size.
+Size            NetStreamPeek(U8* data_p, const Size size);
+
+/// @brief      Is stream ended and drained.
+/// @return     Is end.
+Bool            NetStreamIsEnd(void);
+
+/// @brief      Get network stream statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          NetStreamStatsGet(NetStreamStats* stats_p);
+
+#endif //(OS_NETWORK_ENABLED)
+
+#endif // _NET_STREAM_H_
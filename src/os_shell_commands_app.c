@@ -3,23 +3,49 @@
 * @brief   OS shell application commands.
 * @author  A. Filyanov
 ******************************************************************************/
+#include <stdio.h>
 #include "osal.h"
 #include "os_shell_commands_app.h"
 #include "os_shell.h"
+#include "app_common.h"
+#include "crc.h"
+#include "crc32.h"
+#include "audio_buf_pool.h"
+#include "msg_pool.h"
+#include "net_stream.h"
+#include "net_file.h"
+#include "rtp_sink.h"
+#include "media_index.h"
+#include "image_verify.h"
+#include "media_convert.h"
+#include "audio_out.h"
+#include "audio_eq.h"
 #include "task_mmplay.h"
+#include "task_mmplay_ctl.h"
+#include "task_netserv.h"
+#include "task_bgserv.h"
+#include "task_a_ko.h"
+#include "task_b_ko.h"
+#include "led_pattern.h"
+#include "settings_store.h"
+#include "dlog.h"
+#include "prof.h"
+#include "boot_timeline.h"
 
-//-----------------------------------------------------------------------------
-static OS_TaskHd mmplay_thd;
+//------------------------------------------------------------------------------
+#define SETTINGS_CHECK_POLL_MS      10
+#define SETTINGS_CHECK_TIMEOUT_MS   1000
 
 #if (OS_AUDIO_ENABLED)
 //------------------------------------------------------------------------------
 static ConstStr cmd_mmplay[]            = "mmplay";
-static ConstStr cmd_help_brief_mmplay[] = "Play a multimedia file.";
+static ConstStr cmd_help_brief_mmplay[] = "Play a multimedia file or network stream.";
+static ConstStr cmd_help_detail_mmplay[]= "<file | http://ip[:port]/path | tcp://ip:port[/name]> | play | pause | resume | stop | seek <s> | stats | out [dev | null [x] | wav <file>] | convert [<in> <out> [pcm | adpcm] | stop]";
 /******************************************************************************/
 static Status OS_ShellCmdMMPlayHandler(const U32 argc, ConstStrP argv[]);
 Status OS_ShellCmdMMPlayHandler(const U32 argc, ConstStrP argv[])
 {
-static OS_QueueHd mmplay_stdin_qhd;
+const OS_TaskHd mmplay_ctl_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY_CTL);
 const char* file_path_str_p = (char*)argv[0];
 OS_SignalId signal_id = OS_SIG_UNDEF;
 Status s = S_UNDEF;
@@ -32,19 +58,734 @@ Status s = S_UNDEF;
     } else if (!OS_StrCmp("stop", file_path_str_p)) {
         signal_id = OS_SIG_MMPLAY_STOP;
     } else if (!OS_StrCmp("seek", file_path_str_p)) {
-        signal_id = OS_SIG_MMPLAY_SEEK;
-    } else {
-        IF_OK(s = OS_TaskCreate(file_path_str_p, &task_mmplay_cfg, &mmplay_thd)) {
-            mmplay_stdin_qhd = OS_TaskStdInGet(mmplay_thd);
-            if (OS_NULL == mmplay_stdin_qhd) {
-                OS_TaskDelete(mmplay_thd);
-                s = S_INVALID_QUEUE;
+        //Seek position is given in seconds.
+        s = MMPlayCtlSeek((2 == argc) ? (OS_StrToUL(argv[1], OS_NULL, 10) * 1000) : 0);
+    } else if (!OS_StrCmp("stats", file_path_str_p)) {
+        MMPlayStats stats;
+        SpscRingStats events_stats;
+        IF_OK(s = MMPlayStatsGet(&stats)) {
+            printf("\nstate: %u, decodes: %u, decode ms: %u (max %u), underruns: %u, dma late: %u",
+                   stats.state, stats.decode_count, stats.decode_time_last_ms, stats.decode_time_max_ms,
+                   stats.underruns, stats.dma_late);
+            printf("\ncommands: %u, latency ms: %u (max %u)",
+                   stats.commands, stats.ctl_latency_last_ms, stats.ctl_latency_max_ms);
+        }
+        IF_OK(s = MMPlayAudioEventsStatsGet(&events_stats)) {
+            printf("\naudio events: %u/%u (max %u), wakeups: %u, overflows: %u",
+                   events_stats.depth, events_stats.items_count, events_stats.depth_max,
+                   events_stats.notifies, events_stats.overflows);
+        }
+        AudioOutStats out_stats;
+        IF_OK(s = AudioOutStatsGet(&out_stats)) {
+            if (AUDIO_OUT_DEVICE != out_stats.type) {
+                const U32 rtf_x100 = (0 != out_stats.wall_ms) ? (U32)(((U64)out_stats.audio_ms * 100) / out_stats.wall_ms) : 0;
+                printf("\nout: %u buffers, %u bytes, audio ms: %u, wall ms: %u, write errors: %u",
+                       out_stats.buffers, out_stats.bytes, out_stats.audio_ms, out_stats.wall_ms, out_stats.write_errors);
+                //Decode CPU share at the real-time playback (free run output).
+                printf("\nRTF: %u.%02u, real-time CPU: %u%%", rtf_x100 / 100, rtf_x100 % 100,
+                       (0 != rtf_x100) ? (10000 / rtf_x100) : 0);
             }
         }
-    }
+    } else if (!OS_StrCmp("convert", file_path_str_p)) {
+        //File or directory (batch) conversion by BgServ.
+        const OS_TaskHd bgserv_thd = OS_TaskByNameGet(APP_TASK_NAME_BGSERV);
+        MediaConvertJob job;
+        MediaConvertStats stats;
+        if (1 == argc) {
+            IF_OK(s = MediaConvertStatsGet(&stats)) {
+                const U32 busy_ms = (0 == stats.busy_ms) ? 1 : stats.busy_ms;
+                const U32 speed_x10 = (U32)(((U64)stats.audio_ms * 10) / busy_ms);
+                printf("\nactive: %u, files: %u, errors: %u, in: %u KB, out: %u KB",
+                       stats.is_active, stats.files, stats.errors, stats.bytes_in / 1024, stats.bytes_out / 1024);
+                printf("\n%u ms of audio in %u ms: %u KB/s, x%u.%u real-time", stats.audio_ms, stats.busy_ms,
+                       (U32)(((U64)stats.bytes_out * 1000) / 1024 / busy_ms), speed_x10 / 10, speed_x10 % 10);
+            }
+            return s;
+        }
+        if (OS_NULL == bgserv_thd) { return S_INVALID_STATE; }
+        if ((2 == argc) && !OS_StrCmp("stop", argv[1])) {
+            const OS_Signal signal = OS_SignalCreate(OS_SIG_BGSERV_CONVERT_STOP, 0);
+            return OS_SignalSend(OS_TaskStdInGet(bgserv_thd), signal, OS_MSG_PRIO_NORMAL);
+        }
+        if ((3 > argc) || (sizeof(job.path_in) <= OS_StrLen(argv[1])) || (sizeof(job.path_out) <= OS_StrLen(argv[2]))) {
+            return S_INVALID_VALUE;
+        }
+        OS_StrCpy(job.path_in,  argv[1]);
+        OS_StrCpy(job.path_out, argv[2]);
+        job.format = MEDIA_CONVERT_FORMAT_PCM;
+        if (4 == argc) {
+            if (!OS_StrCmp("adpcm", argv[3])) {
+                job.format = MEDIA_CONVERT_FORMAT_ADPCM;
+            } else if (OS_StrCmp("pcm", argv[3])) { return S_INVALID_VALUE; }
+        }
+        OS_Message* msg_p = MsgPoolCreate(OS_MSG_BGSERV_CONVERT, sizeof(job), OS_NO_BLOCK, &job);
+        if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+        IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(bgserv_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+            MsgPoolDelete(msg_p);
+        }
+    } else if (!OS_StrCmp("out", file_path_str_p)) {
+        //Next file open output.
+        AudioOutConfig cfg;
+        IF_OK(s = AudioOutConfigGet(&cfg)) {
+            if (2 > argc) {
+                printf("\nout: %s, x%u %s", (AUDIO_OUT_NULL == cfg.type) ? "null" : (AUDIO_OUT_WAV == cfg.type) ? "wav" : "dev",
+                       cfg.clock_mul, cfg.path);
+                return s;
+            }
+            cfg.clock_mul = 0;
+            if (!OS_StrCmp("dev", argv[1])) {
+                cfg.type = AUDIO_OUT_DEVICE;
+            } else if (!OS_StrCmp("null", argv[1])) {
+                cfg.type = AUDIO_OUT_NULL;
+                if (3 == argc) { cfg.clock_mul = (U16)OS_StrToUL(argv[2], OS_NULL, 10); }
+            } else if (!OS_StrCmp("wav", argv[1]) && (3 == argc) && (sizeof(cfg.path) > OS_StrLen(argv[2]))) {
+                cfg.type = AUDIO_OUT_WAV;
+                OS_StrCpy(cfg.path, argv[2]);
+            } else { return S_INVALID_VALUE; }
+            s = AudioOutConfigSet(&cfg);
+        }
+    } else if (OS_NULL != mmplay_ctl_thd) {
+        //Player task is started by the control task.
+        OS_Message* msg_p = MsgPoolCreate(OS_MSG_MMPLAY_CTL_OPEN, OS_StrLen(file_path_str_p) + 1, OS_NO_BLOCK, file_path_str_p);
+        if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+        IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(mmplay_ctl_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+            MsgPoolDelete(msg_p);
+        }
+    } else { s = S_INVALID_STATE; }
     if (OS_SIG_UNDEF != signal_id) {
         const OS_Signal signal = OS_SignalCreate(signal_id, 0);
-        IF_STATUS(s = OS_SignalSend(mmplay_stdin_qhd, signal, OS_MSG_PRIO_NORMAL)) {}
+        if (OS_NULL == mmplay_ctl_thd) { return S_INVALID_STATE; }
+        IF_STATUS(s = OS_SignalSend(OS_TaskStdInGet(mmplay_ctl_thd), signal, OS_MSG_PRIO_NORMAL)) {}
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_audbuf[]            = "audbuf";
+static ConstStr cmd_help_brief_audbuf[] = "Audio buffers pool statistics.";
+static ConstStr cmd_help_detail_audbuf[]= "[reset]";
+/******************************************************************************/
+static Status OS_ShellCmdAudBufHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdAudBufHandler(const U32 argc, ConstStrP argv[])
+{
+MemPoolStats stats;
+    if ((1 == argc) && !OS_StrCmp("reset", argv[0])) {
+        AudioBufPoolStatsReset();
+        return S_OK;
+    }
+    printf("\n%-8s %-6s %-6s %-6s %-6s", "size", "count", "used", "max", "fails");
+    for (Size i = 0; i < AudioBufPoolClassesCountGet(); ++i) {
+        IF_OK(AudioBufPoolStatsGet(i, &stats)) {
+            printf("\n0x%-6X %-6u %-6u %-6u %-6u",
+                   (U32)stats.block_size, stats.blocks_count, stats.blocks_used, stats.blocks_used_max, stats.fails_count);
+        }
+    }
+    return S_OK;
+}
+#endif //(OS_AUDIO_ENABLED)
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_msgpool[]           = "msgpool";
+static ConstStr cmd_help_brief_msgpool[]= "Messages pool statistics.";
+static ConstStr cmd_help_detail_msgpool[]= "[reset | bench [count]]";
+/******************************************************************************/
+static Status OS_ShellCmdMsgPoolHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdMsgPoolHandler(const U32 argc, ConstStrP argv[])
+{
+MemPoolStats stats;
+    if ((1 == argc) && !OS_StrCmp("reset", argv[0])) {
+        MsgPoolStatsReset();
+        return S_OK;
+    }
+    if ((1 <= argc) && !OS_StrCmp("bench", argv[0])) {
+        //Create/delete round trip: pool vs OS heap.
+        const U32 count = (2 == argc) ? OS_StrToUL(argv[1], OS_NULL, 10) : 10000;
+        U32 data_v[4] = { 0 };
+        for (U8 is_heap = 0; is_heap < 2; ++is_heap) {
+            const OS_Tick tick_start = OS_TickCountGet();
+            U32 time_ms;
+            for (U32 i = 0; i < count; ++i) {
+                OS_Message* msg_p = (is_heap) ? OS_MessageCreate(OS_MSG_APP, sizeof(data_v), OS_NO_BLOCK, data_v) :
+                                                MsgPoolCreate(OS_MSG_APP, sizeof(data_v), OS_NO_BLOCK, data_v);
+                if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+                MsgPoolDelete(msg_p);
+            }
+            time_ms = OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+            if (0 == time_ms) { time_ms = 1; }
+            printf("\n%-5s %u msg/s", (is_heap) ? "heap" : "pool", (U32)(((U64)count * 1000) / time_ms));
+        }
+        return S_OK;
+    }
+    if (0 != argc) { return S_INVALID_VALUE; }
+    printf("\n%-8s %-6s %-6s %-6s %-6s", "data", "count", "used", "max", "fails");
+    for (Size i = 0; i < MsgPoolClassesCountGet(); ++i) {
+        IF_OK(MsgPoolStatsGet(i, &stats)) {
+            printf("\n%-8u %-6u %-6u %-6u %-6u", (U32)(stats.block_size - sizeof(OS_Message)),
+                   stats.blocks_count, stats.blocks_used, stats.blocks_used_max, stats.fails_count);
+        }
+    }
+    printf("\nheap fallbacks: %u", MsgPoolFallbacksGet());
+    return S_OK;
+}
+
+#if (OS_NETWORK_ENABLED)
+//------------------------------------------------------------------------------
+static ConstStr cmd_nstream[]            = "nstream";
+static ConstStr cmd_help_brief_nstream[] = "Network stream statistics.";
+/******************************************************************************/
+static Status OS_ShellCmdNStreamHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdNStreamHandler(const U32 argc, ConstStrP argv[])
+{
+static ConstStrP state_str_v[] = { "idle", "connecting", "headers", "streaming", "eos", "error" };
+NetStreamStats stats;
+Status s = S_UNDEF;
+    IF_OK(s = NetStreamStatsGet(&stats)) {
+        printf("\nstate: %s, level: %u, depth: %u ms, drift: %d ppm",
+               state_str_v[stats.state], (U32)stats.level, stats.depth_target_ms, stats.drift_ppm);
+        printf("\nin: %u, out: %u, max: %u",
+               stats.jb.bytes_in, stats.jb.bytes_out, stats.jb.level_max);
+        printf("\nunderruns: %u, late: %u, overflows: %u, dropped: %u, repeated: %u",
+               stats.jb.underruns, stats.jb.late_packets, stats.jb.overflows,
+               stats.jb.frames_dropped, stats.jb.frames_repeated);
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_nfile[]             = "nfile";
+static ConstStr cmd_help_brief_nfile[]  = "Network file server statistics.";
+/******************************************************************************/
+static Status OS_ShellCmdNFileHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdNFileHandler(const U32 argc, ConstStrP argv[])
+{
+NetFileStats stats;
+Status s = S_UNDEF;
+    IF_OK(s = NetFileStatsGet(&stats)) {
+        printf("\ntransfers: %u, active: %u, sent: %u bytes",
+               stats.transfers, stats.transfers_active, stats.bytes_sent);
+        printf("\ncredit stalls: %u, last rate: %u bytes/s",
+               stats.credit_stalls, stats.rate_last);
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_rtp[]               = "rtp";
+static ConstStr cmd_help_brief_rtp[]    = "RTP stream output.";
+static ConstStr cmd_help_detail_rtp[]   = "[<ip> <port> [ptime ms] | off]";
+/******************************************************************************/
+static Status OS_ShellCmdRtpHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdRtpHandler(const U32 argc, ConstStrP argv[])
+{
+const OS_TaskHd netserv_thd = OS_TaskByNameGet(APP_TASK_NAME_NETSERV);
+OS_QueueHd netserv_stdin_qhd;
+RtpSinkStats stats;
+Status s = S_UNDEF;
+    if (0 == argc) {
+        IF_OK(s = RtpSinkStatsGet(&stats)) {
+            printf("\nstarted: %u, seq: %u, queue: %u",
+                   RtpSinkIsStarted(), stats.seq, stats.queue_depth);
+            printf("\nsent: %u (%u bytes), dropped: %u, errors: %u",
+                   stats.packets_sent, stats.bytes_sent, stats.packets_dropped, stats.send_errors);
+        }
+        return s;
+    }
+    if (OS_NULL == netserv_thd) { return S_INVALID_PTR; }
+    netserv_stdin_qhd = OS_TaskStdInGet(netserv_thd);
+    if (OS_NULL == netserv_stdin_qhd) { return S_INVALID_QUEUE; }
+    if (!OS_StrCmp("off", argv[0])) {
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_NETSERV_RTP_SINK_STOP, 0);
+        IF_STATUS(s = OS_SignalSend(netserv_stdin_qhd, signal, OS_MSG_PRIO_NORMAL)) {}
+    } else if (2 <= argc) {
+        RtpSinkConfig cfg;
+        cfg.addr    = inet_addr(argv[0]);
+        cfg.port    = (U16)OS_StrToUL(argv[1], OS_NULL, 10);
+        cfg.ptime_ms= (3 == argc) ? (U16)OS_StrToUL(argv[2], OS_NULL, 10) : APP_RTP_SINK_PTIME_DEFAULT;
+        OS_Message* msg_p = MsgPoolCreate(OS_MSG_NETSERV_RTP_SINK_START, sizeof(cfg), OS_BLOCK, &cfg);
+        if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+        IF_STATUS(s = OS_MessageSend(netserv_stdin_qhd, msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+            MsgPoolDelete(msg_p);
+        }
+    } else {
+        s = S_INVALID_VALUE;
+    }
+    return s;
+}
+#endif //(OS_NETWORK_ENABLED)
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_crc[]               = "crc";
+static ConstStr cmd_help_brief_crc[]    = "CRC self-test and throughput.";
+static ConstStr cmd_help_detail_crc[]   = "[size KB]";
+
+typedef enum {
+    CRC_BENCH_MODEL,
+    CRC_BENCH_CRC32_BYTE_WISE,
+    CRC_BENCH_CRC32_COMBINE
+} CrcBenchMode;
+
+typedef struct {
+    ConstStrP       name_p;
+    const CrcModel* model_p;
+    CrcBenchMode    mode;
+    U32             check;              // "123456789" CRC.
+    U32             loops;
+} CrcBenchItem;
+/******************************************************************************/
+static U32 CrcBenchRun(const CrcBenchItem* item_p, U8* buf_p, const Size size);
+U32 CrcBenchRun(const CrcBenchItem* item_p, U8* buf_p, const Size size)
+{
+const Size chunk = size / 4;
+U32 crc = 0;
+    switch (item_p->mode) {
+        case CRC_BENCH_CRC32_BYTE_WISE:
+            crc = CRC32_POLYNOMIAL;
+            for (Size i = 0; i < size; ++i) {
+                crc = Crc32Delta(&buf_p[i], 1, crc);
+            }
+            crc ^= CRC32_POLYNOMIAL;
+            break;
+        case CRC_BENCH_CRC32_COMBINE:
+            crc = Crc32(buf_p, chunk);
+            for (Size i = chunk; i < size; i += chunk) {
+                const Size len = ((size - i) < chunk) ? (size - i) : chunk;
+                crc = Crc32Combine(crc, Crc32(&buf_p[i], len), len);
+            }
+            break;
+        default:
+            crc = CrcCompute(item_p->model_p, buf_p, size);
+            break;
+    }
+    return crc;
+}
+
+/******************************************************************************/
+static Status OS_ShellCmdCrcHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdCrcHandler(const U32 argc, ConstStrP argv[])
+{
+static const CrcBenchItem items_v[] = {
+    { "crc-32/byte",    &crc_model_32,          CRC_BENCH_CRC32_BYTE_WISE,  0xCBF43926, 1   },
+    { "crc-32",         &crc_model_32,          CRC_BENCH_MODEL,            0xCBF43926, 16  },
+    { "crc-32/comb4",   &crc_model_32,          CRC_BENCH_CRC32_COMBINE,    0xCBF43926, 16  },
+    { "crc-8",          &crc_model_8,           CRC_BENCH_MODEL,            0xA1,       4   },
+    { "crc-16/ccitt",   &crc_model_16_ccitt,    CRC_BENCH_MODEL,            0x29B1,     4   },
+    { "crc-32c",        &crc_model_32c,         CRC_BENCH_MODEL,            0xE3069283, 4   },
+};
+const Size size = ((1 == argc) ? OS_StrToUL(argv[0], OS_NULL, 10) : 16) * 1024;
+const U32 cycles_per_ms = SystemCoreClock / 1000;
+U8 check_v[] = "123456789";
+U8* buf_p;
+U32 crc_ref = 0;
+
+    if (0 == size) { return S_INVALID_VALUE; }
+    buf_p = OS_MallocEx(size, OS_MEM_HEAP_APP);
+    if (OS_NULL == buf_p) { return S_OUT_OF_MEMORY; }
+    for (Size i = 0; i < size; ++i) {
+        buf_p[i] = (U8)((i * 2654435761UL) >> 13);
+    }
+    printf("\n%-14s %-5s %-10s %-10s %-8s", "model", "check", "crc", "KB/s", "cyc/B");
+    for (Size v = 0; v < ITEMS_COUNT_GET(items_v, CrcBenchItem); ++v) {
+        const CrcBenchItem* item_p = &items_v[v];
+        //CRC-32 variants are also checked bit-exact against the byte-wise one.
+        const Bool is_ok = (item_p->check == CrcCompute(item_p->model_p, check_v, sizeof(check_v) - 1));
+        const OS_Tick tick_start = OS_TickCountGet();
+        U32 time_ms;
+        U32 cycles_x10;
+        U32 crc = 0;
+        for (U32 l = 0; l < item_p->loops; ++l) {
+            crc = CrcBenchRun(item_p, buf_p, size);
+        }
+        time_ms = OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+        if (0 == time_ms) { time_ms = 1; }
+        cycles_x10 = (U32)(((U64)time_ms * cycles_per_ms * 10) / ((U64)size * item_p->loops));
+        if (CRC_BENCH_CRC32_BYTE_WISE == item_p->mode) { crc_ref = crc; }
+        printf("\n%-14s %-5s 0x%08X %-10u %u.%u", item_p->name_p,
+               (is_ok && ((&crc_model_32 != item_p->model_p) || (crc_ref == crc))) ? "ok" : "FAIL", crc,
+               (U32)(((U64)size * item_p->loops * 1000) / 1024 / time_ms), cycles_x10 / 10, cycles_x10 % 10);
+    }
+    OS_FreeEx(buf_p, OS_MEM_HEAP_APP);
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_mindex[]            = "mindex";
+static ConstStr cmd_help_brief_mindex[] = "Media integrity index.";
+static ConstStr cmd_help_detail_mindex[]= "[all | sweep]";
+/******************************************************************************/
+static Status OS_ShellCmdMIndexHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdMIndexHandler(const U32 argc, ConstStrP argv[])
+{
+static ConstStrP state_str_v[] = { "unknown", "ok", "MISMATCH" };
+const Bool is_all = (1 == argc) && !OS_StrCmp("all", argv[0]);
+MediaIndexStats stats;
+MediaIndexItem item;
+Status s = S_UNDEF;
+
+    if ((1 == argc) && !OS_StrCmp("sweep", argv[0])) {
+        const OS_TaskHd bgserv_thd = OS_TaskByNameGet(APP_TASK_NAME_BGSERV);
+        if (OS_NULL == bgserv_thd) { return S_INVALID_PTR; }
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_BGSERV_MEDIA_SWEEP, 0);
+        return OS_SignalSend(OS_TaskStdInGet(bgserv_thd), signal, OS_MSG_PRIO_NORMAL);
+    }
+    if ((1 == argc) && (OS_TRUE != is_all)) { return S_INVALID_VALUE; }
+    IF_STATUS(s = MediaIndexStatsGet(&stats)) { return s; }
+    printf("\nitems: %u, mismatches: %u, sweep: %u", stats.items, stats.mismatches, stats.is_sweep);
+    printf("\nplayback checks: %u, idle checks: %u, verified: %u KB",
+           stats.playback_checks, stats.idle_checks, stats.bytes_verified / 1024);
+    for (Size i = 0; i < stats.items; ++i) {
+        IF_STATUS(MediaIndexItemGet(i, &item)) { break; }
+        if ((OS_TRUE != is_all) && (MEDIA_INDEX_STATE_MISMATCH != item.state)) { continue; }
+        printf("\n%-8s %10u 0x%08X %s", state_str_v[item.state], item.size,
+               Crc32Combine(item.crc_head, item.crc_body, item.size - item.head_size), item.path);
+    }
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_imgvrfy[]           = "imgvrfy";
+static ConstStr cmd_help_brief_imgvrfy[]= "Images verification.";
+static ConstStr cmd_help_detail_imgvrfy[]= "[start]";
+/******************************************************************************/
+static Status OS_ShellCmdImgVrfyHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdImgVrfyHandler(const U32 argc, ConstStrP argv[])
+{
+static ConstStrP result_str_v[] = { "unknown", "ok", "no crc", "MISMATCH", "error" };
+ImageVerifyStats stats;
+ImageVerifyResult result;
+ConstStrP name_p;
+Status s = S_UNDEF;
+
+    if (1 == argc) {
+        const OS_TaskHd bgserv_thd = OS_TaskByNameGet(APP_TASK_NAME_BGSERV);
+        if (OS_StrCmp("start", argv[0])) { return S_INVALID_VALUE; }
+        if (OS_NULL == bgserv_thd) { return S_INVALID_PTR; }
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_BGSERV_IMAGE_VERIFY, 0);
+        return OS_SignalSend(OS_TaskStdInGet(bgserv_thd), signal, OS_MSG_PRIO_NORMAL);
+    }
+    IF_STATUS(s = ImageVerifyStatsGet(&stats)) { return s; }
+    printf("\nactive: %u, passes: %u, resumes: %u", stats.is_active, stats.passes, stats.resumes);
+    printf("\n%u KB in %u ms, last: %u.%02u MB/s", stats.bytes / 1024, stats.busy_ms,
+           stats.rate_kbs / 1024, ((stats.rate_kbs % 1024) * 100) / 1024);
+    for (Size i = 0; S_OK == ImageVerifyResultGet(i, &name_p, &result); ++i) {
+        printf("\n%-10s %s", name_p, result_str_v[result]);
+    }
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_buttons[]           = "buttons";
+static ConstStr cmd_help_brief_buttons[]= "Buttons statistics.";
+/******************************************************************************/
+static Status OS_ShellCmdButtonsHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdButtonsHandler(const U32 argc, ConstStrP argv[])
+{
+AKoButtonStats stats;
+ConstStrP name_p;
+    printf("\n%-8s %-8s %-6s %-8s %-8s %-10s", "name", "presses", "longs", "repeats", "bounces", "latency ms");
+    for (Size i = 0; S_OK == AKoButtonStatsGet(i, &name_p, &stats); ++i) {
+        printf("\n%-8s %-8u %-6u %-8u %-8u %u (max %u)", name_p, stats.presses, stats.longs, stats.repeats,
+               stats.bounces, stats.latency_last_ms, stats.latency_max_ms);
+    }
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_led[]               = "led";
+static ConstStr cmd_help_brief_led[]    = "User LED pattern and wakeups statistics.";
+static ConstStr cmd_help_detail_led[]   = "[off | on | heartbeat | blink | breathe | code1..3 | reset]";
+/******************************************************************************/
+static Status OS_ShellCmdLedHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdLedHandler(const U32 argc, ConstStrP argv[])
+{
+BKoLedStats stats;
+Status s = S_UNDEF;
+
+    if (1 == argc) {
+        const OS_TaskHd b_ko_thd = OS_TaskByNameGet(APP_TASK_NAME_B_KO);
+        if (!OS_StrCmp("reset", argv[0])) {
+            BKoLedStatsReset();
+            return S_OK;
+        }
+        if (OS_NULL == b_ko_thd) { return S_INVALID_STATE; }
+        for (Size id = 0; id < LED_PATTERN_LAST; ++id) {
+            if (!OS_StrCmp(LedPatternGet((LedPatternId)id)->name_p, argv[0])) {
+                const OS_Signal signal = OS_SignalCreate(OS_SIG_B_KO_LED_PATTERN, id);
+                return OS_SignalSend(OS_TaskStdInGet(b_ko_thd), signal, OS_MSG_PRIO_NORMAL);
+            }
+        }
+        return S_INVALID_VALUE;
+    }
+    IF_OK(s = BKoLedStatsGet(&stats)) {
+        const U32 time_ms = OS_TICKS_TO_MS(OS_TickCountGet() - stats.tick_reset);
+        printf("\npattern: %s, wakeups: %u, edges: %u in %u ms",
+               (OS_NULL != stats.pattern_name_p) ? stats.pattern_name_p : "none", stats.wakeups, stats.edges, time_ms);
+        if (0 != time_ms) {
+            printf("\nwakeups/s: %u.%02u", (stats.wakeups * 1000) / time_ms, ((stats.wakeups * 100000) / time_ms) % 100);
+        }
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_settings[]          = "settings";
+static ConstStr cmd_help_brief_settings[]= "Settings store.";
+static ConstStr cmd_help_detail_settings[]= "[get <section> <key> | set <section> <key> <value> | del <section> <key> | check]";
+/******************************************************************************/
+static Status OS_ShellCmdSettingsHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdSettingsHandler(const U32 argc, ConstStrP argv[])
+{
+SettingsStoreStats stats;
+SettingsStoreItem item;
+Status s = S_UNDEF;
+
+    if ((3 == argc) && !OS_StrCmp("get", argv[0])) {
+        Str value[APP_SETTINGS_STORE_VALUE_LEN];
+        IF_OK(s = SettingsStoreGet(argv[1], argv[2], value, sizeof(value))) {
+            printf("\n%s", value);
+        }
+        return s;
+    } else if ((4 == argc) && !OS_StrCmp("set", argv[0])) {
+        return SettingsStoreSet(argv[1], argv[2], argv[3]);
+    } else if ((3 == argc) && !OS_StrCmp("del", argv[0])) {
+        return SettingsStoreSet(argv[1], argv[2], OS_NULL);
+    } else if ((1 == argc) && !OS_StrCmp("check", argv[0])) {
+        //Set -> delete -> reload: the log must load the key as deleted.
+        Str value[APP_SETTINGS_STORE_VALUE_LEN];
+        for (U8 step = 0; step < 2; ++step) {
+            const Bool is_delete = (1 == step) ? OS_TRUE : OS_FALSE;
+            OS_TimeMs wait_ms = 0;
+            IF_STATUS(s = SettingsStoreSet("Check", "probe", (OS_TRUE == is_delete) ? OS_NULL : "1")) { return s; }
+            //Till BgServ appends the record.
+            do {
+                OS_TaskDelay(SETTINGS_CHECK_POLL_MS);
+                wait_ms += SETTINGS_CHECK_POLL_MS;
+                s = SettingsStoreLogGet("Check", "probe", value, sizeof(value));
+            } while ((((OS_TRUE == is_delete) && (S_OK == s)) || ((OS_TRUE != is_delete) && ((S_OK != s) || OS_StrCmp("1", value)))) &&
+                     (SETTINGS_CHECK_TIMEOUT_MS > wait_ms));
+            printf("\n%s: %s (%u ms)", (OS_TRUE == is_delete) ? "delete" : "set",
+                   (S_OK == s) ? value : "<not found>", wait_ms);
+        }
+        if (S_SETTINGS_STORE_NOT_FOUND != s) {
+            printf("\nFAILED: deleted key is reloaded");
+            return (S_OK == s) ? S_INVALID_STATE : s;
+        }
+        printf("\nOK");
+        return S_OK;
+    } else if (0 != argc) {
+        return S_INVALID_VALUE;
+    }
+    IF_STATUS(s = SettingsStoreStatsGet(&stats)) { return s; }
+    printf("\nloaded: %u in %u ms%s, items: %u, records: %u, log: %u bytes (gen %u), compactions: %u",
+           stats.is_loaded, stats.load_ms, (OS_TRUE == stats.is_imported) ? " (INI import)" : "",
+           stats.items, stats.records, stats.log_size, stats.generation, stats.compactions);
+    for (Size i = 0; S_INVALID_VALUE != (s = SettingsStoreItemGet(i, &item)); ++i) {
+        IF_OK(s) {
+            printf("\n%c %-31s %s", BIT_TEST(item.flags, SETTINGS_STORE_FLAG_DIRTY) ? '*' : ' ', item.key, item.value);
+        } else if (S_SETTINGS_STORE_NOT_FOUND != s) { return s; }
+    }
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_hid[]               = "hid";
+static ConstStr cmd_help_brief_hid[]    = "USB HID input coalescing statistics.";
+static ConstStr cmd_help_detail_hid[]   = "[on | off | reset | replay [count]]";
+/******************************************************************************/
+static Status OS_ShellCmdHidHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdHidHandler(const U32 argc, ConstStrP argv[])
+{
+const OS_TaskHd b_ko_thd = OS_TaskByNameGet(APP_TASK_NAME_B_KO);
+UsbHidStats stats;
+U32 drops = 0;
+Status s = S_UNDEF;
+
+    if (OS_NULL == b_ko_thd) { return S_INVALID_STATE; }
+    if ((1 == argc) && (!OS_StrCmp("on", argv[0]) || !OS_StrCmp("off", argv[0]))) {
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_B_KO_HID_COALESCE, !OS_StrCmp("on", argv[0]));
+        return OS_SignalSend(OS_TaskStdInGet(b_ko_thd), signal, OS_MSG_PRIO_NORMAL);
+    } else if ((1 == argc) && !OS_StrCmp("reset", argv[0])) {
+        BKoHidStatsReset();
+        return S_OK;
+    } else if ((0 != argc) && !OS_StrCmp("replay", argv[0])) {
+        //Mouse-like 1 kHz reports stream: steady motion and a click every 250 ms.
+        const U32 count = (2 == argc) ? OS_StrToUL((const char*)argv[1], OS_NULL, 10) : 1000;
+        BKoHidStatsReset();
+        for (U32 i = 0; i < count; ++i) {
+            const OS_UsbHidMouseData report = {
+                .buttons_bm = (0 == ((i / 125) % 2)) ? 0 : BIT(OS_USB_HID_MOUSE_BUTTON_LEFT),
+                .x          = 1 + (i % 4),
+                .y          = -(S16)(i % 2)
+            };
+            IF_STATUS(BKoMouseReportPut(0, &report)) { ++drops; }
+            OS_TaskDelay(1);
+        }
+        //Let the last motion be delivered.
+        OS_TaskDelay(APP_USB_HID_DELIVERY_MS * 2);
+    } else if (0 != argc) {
+        return S_INVALID_VALUE;
+    }
+    IF_OK(s = BKoHidStatsGet(&stats)) {
+        printf("\nreports: %u, wakeups: %u, deliveries: %u, edges: %u, states max: %u, overflows: %u, busy: %u ms, drops: %u",
+               stats.reports, stats.wakeups, stats.deliveries, stats.edges, stats.states_max, stats.overflows,
+               stats.busy_ms, drops);
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_dlog[]              = "dlog";
+static ConstStr cmd_help_brief_dlog[]   = "Deferred log statistics.";
+static ConstStr cmd_help_detail_dlog[]  = "[bench [count]]";
+static DLogModule dlog_mdl              = { "shell", 0 };
+/******************************************************************************/
+static Status OS_ShellCmdDLogHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdDLogHandler(const U32 argc, ConstStrP argv[])
+{
+const DLogModule* mdl_p;
+DLogStats stats;
+Status s = S_UNDEF;
+
+    if ((0 != argc) && !OS_StrCmp("bench", argv[0])) {
+        //Cycles per call: the deferred record vs the formatted log.
+        const U32 count = (2 == argc) ? OS_StrToUL((const char*)argv[1], OS_NULL, 10) : 16;
+        U32 cycles_dlog, cycles_log;
+        if ((0 == count) || (APP_DLOG_RECORDS_COUNT < count)) { return S_INVALID_VALUE; }
+        APP_CYCLES_INIT();
+        cycles_dlog = APP_CYCLES_GET();
+        for (U32 i = 0; i < count; ++i) {
+            DLOG1(D_DEBUG, "Bench: %u", i);
+        }
+        cycles_dlog = APP_CYCLES_GET() - cycles_dlog;
+        cycles_log = APP_CYCLES_GET();
+        for (U32 i = 0; i < count; ++i) {
+            OS_LOG(D_DEBUG, "Bench: %u", i);
+        }
+        cycles_log = APP_CYCLES_GET() - cycles_log;
+        printf("\ncycles per call: dlog %u, log %u", cycles_dlog / count, cycles_log / count);
+    } else if (0 != argc) {
+        return S_INVALID_VALUE;
+    }
+    IF_STATUS(s = DLogStatsGet(&stats)) { return s; }
+    printf("\nlevel: %u, ring: %u/%u (max %u), overflows: %u, formatted: %u",
+           APP_DLOG_LEVEL, stats.depth, stats.records_count, stats.depth_max, stats.overflows, stats.formatted);
+    printf("\n%-16s %-8s %-10s %-8s", "module", "rate/s", "records", "drops");
+    for (Size i = 0; OS_NULL != (mdl_p = DLogModuleGet(i)); ++i) {
+        printf("\n%-16s %-8u %-10u %-8u", mdl_p->name_p, mdl_p->rate_max, mdl_p->records, mdl_p->drops);
+    }
+    return S_OK;
+}
+
+#if (APP_PROF_ENABLED)
+//------------------------------------------------------------------------------
+static ConstStr cmd_prof[]              = "prof";
+static ConstStr cmd_help_brief_prof[]   = "Code regions profile.";
+static ConstStr cmd_help_detail_prof[]  = "[reset]";
+/******************************************************************************/
+static Status OS_ShellCmdProfHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdProfHandler(const U32 argc, ConstStrP argv[])
+{
+const U32 cycles_per_us = ProfCyclesPerUsGet();
+ConstStrP name_p;
+ProfRegionStats stats;
+
+    if (1 == argc) {
+        if (OS_StrCmp("reset", argv[0])) { return S_INVALID_VALUE; }
+        ProfReset();
+        return S_OK;
+    }
+    printf("\n%-18s %-8s %-8s %-8s %-8s %-10s", "region", "count", "min us", "avg us", "max us", "total ms");
+    for (Size id = 0; id < PROF_REGION_LAST; ++id) {
+        IF_STATUS(ProfRegionStatsGet((ProfRegionId)id, &name_p, &stats)) { continue; }
+        if (0 == stats.count) {
+            printf("\n%-18s 0", name_p);
+            continue;
+        }
+        printf("\n%-18s %-8u %-8u %-8u %-8u %-10u", name_p, stats.count, stats.min / cycles_per_us,
+               (U32)(stats.total / stats.count) / cycles_per_us, stats.max / cycles_per_us,
+               (U32)(stats.total / cycles_per_us / 1000));
+        //Histogram: non-empty bins with their lower bound.
+        printf("\n  ");
+        for (Size bin = 0; bin < APP_PROF_HIST_BINS; ++bin) {
+            if (0 != stats.hist[bin]) {
+                printf(" >=%uus:%u", (U32)(1UL << (bin + APP_PROF_HIST_SHIFT)) / cycles_per_us, stats.hist[bin]);
+            }
+        }
+    }
+    return S_OK;
+}
+#endif //(APP_PROF_ENABLED)
+
+//------------------------------------------------------------------------------
+static ConstStr cmd_boot[]              = "boot";
+static ConstStr cmd_help_brief_boot[]   = "Boot timeline.";
+/******************************************************************************/
+static Status OS_ShellCmdBootHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdBootHandler(const U32 argc, ConstStrP argv[])
+{
+ConstStrP name_p;
+U32 time_us;
+U32 time_prev_us = 0;
+
+    printf("\n%-18s %-10s %-10s", "step", "at us", "step us");
+    for (Size i = 0; S_OK == BootMarkGet(i, &name_p, &time_us); ++i) {
+        printf("\n%-18s %-10u %-10u", name_p, time_us, time_us - time_prev_us);
+        time_prev_us = time_us;
+    }
+    return S_OK;
+}
+
+#if (OS_AUDIO_ENABLED)
+//------------------------------------------------------------------------------
+static ConstStr cmd_eq[]                = "eq";
+static ConstStr cmd_help_brief_eq[]     = "Player parametric EQ.";
+static ConstStr cmd_help_detail_eq[]    = "[on | off | reset | <band> off | <band> peak|low|high <Hz> <Q x100> <dB x10>]";
+/******************************************************************************/
+static Status OS_ShellCmdEqHandler(const U32 argc, ConstStrP argv[]);
+Status OS_ShellCmdEqHandler(const U32 argc, ConstStrP argv[])
+{
+static ConstStrP type_str_v[] = { "off", "peak", "low", "high" };
+AudioEqBand band;
+AudioEqStats stats;
+Status s = S_UNDEF;
+
+    if (1 == argc) {
+        if (!OS_StrCmp("on", argv[0])) {
+            return AudioEqPresetSet(OS_TRUE);
+        } else if (!OS_StrCmp("off", argv[0])) {
+            return AudioEqPresetSet(OS_FALSE);
+        } else if (!OS_StrCmp("reset", argv[0])) {
+            AudioEqStatsReset();
+            return S_OK;
+        }
+        return S_INVALID_VALUE;
+    } else if (1 < argc) {
+        const Size idx = OS_StrToUL(argv[0], OS_NULL, 10);
+        OS_MemSet(&band, 0, sizeof(band));
+        for (band.type = AUDIO_EQ_BAND_OFF; band.type < AUDIO_EQ_BAND_LAST; ++band.type) {
+            if (!OS_StrCmp(type_str_v[band.type], argv[1])) { break; }
+        }
+        if (AUDIO_EQ_BAND_LAST == band.type) { return S_INVALID_VALUE; }
+        if (AUDIO_EQ_BAND_OFF != band.type) {
+            if (5 != argc) { return S_INVALID_VALUE; }
+            band.freq       = (U16)OS_StrToUL(argv[2], OS_NULL, 10);
+            band.q_x100     = (U16)OS_StrToUL(argv[3], OS_NULL, 10);
+            band.gain_x10   = ('-' == argv[4][0]) ? -(S16)OS_StrToUL(&argv[4][1], OS_NULL, 10) :
+                                                 (S16)OS_StrToUL(argv[4], OS_NULL, 10);
+        }
+        return AudioEqBandSet(idx, &band);
+    }
+    for (Size i = 0; S_OK == AudioEqBandGet(i, &band); ++i) {
+        const U16 gain_x10 = (0 > band.gain_x10) ? -band.gain_x10 : band.gain_x10;
+        if (AUDIO_EQ_BAND_OFF == band.type) { continue; }
+        printf("\n%u: %-4s %5u Hz, Q %u.%02u, %s%u.%u dB", (U32)i, type_str_v[band.type], band.freq,
+               band.q_x100 / 100, band.q_x100 % 100, (0 > band.gain_x10) ? "-" : "", gain_x10 / 10, gain_x10 % 10);
+    }
+    IF_OK(s = AudioEqStatsGet(&stats)) {
+        //Cycles per channel sample per band and its CPU share at the stream rate.
+        const U32 cycles_x100 = (0 != stats.band_samples) ? (U32)((stats.cycles * 100) / stats.band_samples) : 0;
+        const U32 load_x100 = (U32)(((U64)cycles_x100 * stats.samples_rate) / (APP_CYCLES_PER_US * 10000UL));
+        printf("\nbands: %u, blocks: %u, cycles/sample/band: %u.%02u, CPU/band: %u.%02u%%",
+               stats.bands, stats.blocks, cycles_x100 / 100, cycles_x100 % 100, load_x100 / 100, load_x100 % 100);
     }
     return s;
 }
@@ -53,9 +794,29 @@ Status s = S_UNDEF;
 //------------------------------------------------------------------------------
 static ConstStr empty_str[] = "";
 static const OS_ShellCommandConfig cmd_cfg_app[] = {
+    { cmd_crc,      cmd_help_brief_crc,     cmd_help_detail_crc,    OS_ShellCmdCrcHandler,          0,    1,      OS_SHELL_OPT_UNDEF  },
+    { cmd_msgpool,  cmd_help_brief_msgpool, cmd_help_detail_msgpool,OS_ShellCmdMsgPoolHandler,      0,    2,      OS_SHELL_OPT_UNDEF  },
+    { cmd_imgvrfy,  cmd_help_brief_imgvrfy, cmd_help_detail_imgvrfy,OS_ShellCmdImgVrfyHandler,      0,    1,      OS_SHELL_OPT_UNDEF  },
+    { cmd_mindex,   cmd_help_brief_mindex,  cmd_help_detail_mindex, OS_ShellCmdMIndexHandler,       0,    1,      OS_SHELL_OPT_UNDEF  },
+    { cmd_buttons,  cmd_help_brief_buttons, empty_str,              OS_ShellCmdButtonsHandler,      0,    0,      OS_SHELL_OPT_UNDEF  },
+    { cmd_led,      cmd_help_brief_led,     cmd_help_detail_led,    OS_ShellCmdLedHandler,          0,    1,      OS_SHELL_OPT_UNDEF  },
+    { cmd_settings, cmd_help_brief_settings,cmd_help_detail_settings,OS_ShellCmdSettingsHandler,    0,    4,      OS_SHELL_OPT_UNDEF  },
+    { cmd_hid,      cmd_help_brief_hid,     cmd_help_detail_hid,    OS_ShellCmdHidHandler,          0,    2,      OS_SHELL_OPT_UNDEF  },
+    { cmd_dlog,     cmd_help_brief_dlog,    cmd_help_detail_dlog,   OS_ShellCmdDLogHandler,         0,    2,      OS_SHELL_OPT_UNDEF  },
+    { cmd_boot,     cmd_help_brief_boot,    empty_str,              OS_ShellCmdBootHandler,         0,    0,      OS_SHELL_OPT_UNDEF  },
+#if (APP_PROF_ENABLED)
+    { cmd_prof,     cmd_help_brief_prof,    cmd_help_detail_prof,   OS_ShellCmdProfHandler,         0,    1,      OS_SHELL_OPT_UNDEF  },
+#endif //(APP_PROF_ENABLED)
 #if (OS_AUDIO_ENABLED)
-    { cmd_mmplay,   cmd_help_brief_mmplay,  empty_str,              OS_ShellCmdMMPlayHandler,       1,    2,      OS_SHELL_OPT_UNDEF  },
+    { cmd_mmplay,   cmd_help_brief_mmplay,  cmd_help_detail_mmplay, OS_ShellCmdMMPlayHandler,       1,    4,      OS_SHELL_OPT_UNDEF  },
+    { cmd_audbuf,   cmd_help_brief_audbuf,  cmd_help_detail_audbuf, OS_ShellCmdAudBufHandler,       0,    1,      OS_SHELL_OPT_UNDEF  },
+    { cmd_eq,       cmd_help_brief_eq,      cmd_help_detail_eq,     OS_ShellCmdEqHandler,           0,    5,      OS_SHELL_OPT_UNDEF  },
 #endif //(OS_AUDIO_ENABLED)
+#if (OS_NETWORK_ENABLED)
+    { cmd_nstream,  cmd_help_brief_nstream, empty_str,              OS_ShellCmdNStreamHandler,      0,    0,      OS_SHELL_OPT_UNDEF  },
+    { cmd_nfile,    cmd_help_brief_nfile,   empty_str,              OS_ShellCmdNFileHandler,        0,    0,      OS_SHELL_OPT_UNDEF  },
+    { cmd_rtp,      cmd_help_brief_rtp,     cmd_help_detail_rtp,    OS_ShellCmdRtpHandler,          0,    3,      OS_SHELL_OPT_UNDEF  },
+#endif //(OS_NETWORK_ENABLED)
     OS_NULL
 };
 
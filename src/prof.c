@@ -0,0 +1,72 @@
+/***************************************************************************//**
+* @file    prof.c
+* @brief   Code regions cycle profiler.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "app_common.h"
+#include "prof.h"
+
+#if (APP_PROF_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "prof"
+
+//-----------------------------------------------------------------------------
+static ConstStrP region_names_v[PROF_REGION_LAST] = {
+    "FrameReadDecode",
+    "SourceRead",
+    "AudioCodecDecode",
+    "VolumeApply",
+    "AudioEqApply",
+};
+static ProfRegionStats regions_v[PROF_REGION_LAST];
+
+/*****************************************************************************/
+Status ProfInit(void)
+{
+    //Not reset: the boot timeline counts from the power-on.
+    APP_CYCLES_INIT();
+    ProfReset();
+    return S_OK;
+}
+
+/*****************************************************************************/
+void ProfRegionAdd(const ProfRegionId id, const U32 cycles)
+{
+ProfRegionStats* region_p = &regions_v[id];
+//Bin is log2(cycles) - shift.
+S32 bin = (S32)(31 - APP_CLZ(cycles | 1)) - APP_PROF_HIST_SHIFT;
+
+    bin = (0 > bin) ? 0 : ((APP_PROF_HIST_BINS <= bin) ? (APP_PROF_HIST_BINS - 1) : bin);
+    ++region_p->count;
+    region_p->total += cycles;
+    if (region_p->min > cycles) { region_p->min = cycles; }
+    if (region_p->max < cycles) { region_p->max = cycles; }
+    ++region_p->hist[bin];
+}
+
+/*****************************************************************************/
+Status ProfRegionStatsGet(const ProfRegionId id, ConstStrP* name_pp, ProfRegionStats* stats_p)
+{
+    if ((OS_NULL == name_pp) || (OS_NULL == stats_p)) { return S_INVALID_PTR; }
+    if (PROF_REGION_LAST <= id) { return S_INVALID_VALUE; }
+    *name_pp = region_names_v[id];
+    *stats_p = regions_v[id];
+    return S_OK;
+}
+
+/*****************************************************************************/
+void ProfReset(void)
+{
+    OS_MemSet(regions_v, 0, sizeof(regions_v));
+    for (Size i = 0; i < PROF_REGION_LAST; ++i) {
+        regions_v[i].min = U32_MAX;
+    }
+}
+
+/*****************************************************************************/
+U32 ProfCyclesPerUsGet(void)
+{
+    return APP_CYCLES_PER_US;
+}
+
+#endif //(APP_PROF_ENABLED)
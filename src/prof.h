@@ -0,0 +1,69 @@
+/***************************************************************************//**
+* @file    prof.h
+* @brief   Code regions cycle profiler.
+* @author  A. Filyanov
+* @details PROF_ENTER()/PROF_EXIT() pair (in the same scope) adds the region
+*          time to its count, total, min, max and log2 histogram. The cycles
+*          are taken from APP_CYCLES_GET() (DWT CYCCNT or the host clock).
+*          Region is updated by one task at a time.
+*          The markers are empty if APP_PROF_ENABLED is 0.
+*******************************************************************************/
+#ifndef _PROF_H_
+#define _PROF_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+//-----------------------------------------------------------------------------
+typedef enum {
+    PROF_REGION_FRAME_READ_DECODE,
+    PROF_REGION_SOURCE_READ,
+    PROF_REGION_CODEC_DECODE,
+    PROF_REGION_VOLUME_APPLY,
+    PROF_REGION_EQ_APPLY,
+    PROF_REGION_LAST
+} ProfRegionId;
+
+typedef struct {
+    U32             count;
+    U64             total;              // Cycles.
+    U32             min;
+    U32             max;
+    U32             hist[APP_PROF_HIST_BINS];
+} ProfRegionStats;
+
+#if (APP_PROF_ENABLED)
+#define PROF_ENTER(id)          const U32 prof_start_##id = APP_CYCLES_GET()
+#define PROF_EXIT(id)           ProfRegionAdd((id), APP_CYCLES_GET() - prof_start_##id)
+#else
+#define PROF_ENTER(id)
+#define PROF_EXIT(id)
+#endif //(APP_PROF_ENABLED)
+
+//-----------------------------------------------------------------------------
+#if (APP_PROF_ENABLED)
+/// @brief      Init profiler (start the cycle counter).
+/// @return     #Status.
+Status          ProfInit(void);
+
+/// @brief      Add region time.
+/// @param[in]  id             Region id.
+/// @param[in]  cycles         Time.
+void            ProfRegionAdd(const ProfRegionId id, const U32 cycles);
+
+/// @brief      Get region statistics.
+/// @param[in]  id             Region id.
+/// @param[out] name_pp        Region name.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          ProfRegionStatsGet(const ProfRegionId id, ConstStrP* name_pp, ProfRegionStats* stats_p);
+
+/// @brief      Reset all regions statistics.
+void            ProfReset(void);
+
+/// @brief      Get profiler clock rate.
+/// @return     Cycles per microsecond.
+U32             ProfCyclesPerUsGet(void);
+#endif //(APP_PROF_ENABLED)
+
+#endif // _PROF_H_
@@ -0,0 +1,331 @@
+/***************************************************************************//**
+* @file    rtp_sink.c
+* @brief   RTP/UDP L16 PCM stream output.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_time.h"
+#include "os_memory.h"
+#include "app_common.h"
+#include "mem_pool.h"
+#include "spsc_ring.h"
+#include "rtp_sink.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "rtp_sink"
+
+#define RTP_HDR_SIZE            12
+#define RTP_VERSION             0x80
+#define RTP_MARKER              0x80
+#define RTP_PT_L16_STEREO       10          // RFC 3551: 44100 Hz, 2 channels.
+#define RTP_PT_L16_MONO         11          // RFC 3551: 44100 Hz, 1 channel.
+#define QUEUE_COUNT             32          // Power of 2, not less than the packets count (never overflows).
+
+#if (QUEUE_COUNT < APP_RTP_SINK_PACKETS)
+#error "rtp_sink: QUEUE_COUNT is less than APP_RTP_SINK_PACKETS!"
+#endif
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    U32             release_pos;            // Audio clock position of the first sample frame.
+    U32             epoch;
+    Size            size;                   // Header + payload.
+    U8              data[RTP_HDR_SIZE + APP_RTP_SINK_PAYLOAD_MAX];
+} RtpPacket;
+
+typedef struct {
+    MemPool         pool;
+    SpscRing        queue;                  // Player -> NetServ packets.
+    RtpPacket*      queue_v[QUEUE_COUNT];
+    //NetServ side.
+    NetSocket       sd;
+    struct sockaddr_in dest;
+    volatile U16    ptime_ms;
+    volatile Bool   is_started;
+    //Player side (NetServ reads the epoch only).
+    volatile U32    epoch;
+    Bool            is_active;              // Started, as taken over by RtpSinkSync().
+    U16             ptime_ms_curr;
+    RtpPacket*      pkt_p;
+    Size            pkt_size;
+    Size            frame_size;
+    U32             sample_rate;
+    U32             write_pos;
+    U32             ssrc;
+    U16             seq;
+    U8              pt;
+    Bool            is_marker;
+    //Audio clock.
+    U32             clock_pos;
+    OS_TimeMs       clock_ms;
+    U32             clock_period;
+    volatile Bool   is_clock_run;
+    RtpSinkStats    stats;
+} RtpSink;
+
+//-----------------------------------------------------------------------------
+static void     PacketBegin(RtpPacket* pkt_p);
+static void     L16Copy(U8* dst_p, const U8* src_p, Size size);
+static U32      ClockPositionGet(const OS_TimeMs now_ms);
+static void     U16Put(U8* p, const U16 value);
+static void     U32Put(U8* p, const U32 value);
+
+//-----------------------------------------------------------------------------
+static RtpSink rtp_sink = { .sd = NET_SOCKET_UNDEF };
+
+/*****************************************************************************/
+Status RtpSinkInit(void)
+{
+void* mem_p = OS_MallocEx(sizeof(RtpPacket) * APP_RTP_SINK_PACKETS, APP_RTP_SINK_MEMORY);
+    if (OS_NULL == mem_p) { return S_OUT_OF_MEMORY; }
+    rtp_sink.sd         = NET_SOCKET_UNDEF;
+    rtp_sink.ptime_ms   = APP_RTP_SINK_PTIME_DEFAULT;
+    rtp_sink.ptime_ms_curr = APP_RTP_SINK_PTIME_DEFAULT;
+    SpscRingInit(&rtp_sink.queue, rtp_sink.queue_v, sizeof(RtpPacket*), QUEUE_COUNT);
+    return MemPoolInit(&rtp_sink.pool, mem_p, sizeof(RtpPacket), APP_RTP_SINK_PACKETS);
+}
+
+/*****************************************************************************/
+Status RtpSinkStart(const RtpSinkConfig* cfg_p)
+{
+const U8 ttl = APP_RTP_SINK_MCAST_TTL;
+NetSocket sd;
+
+    if (OS_NULL == cfg_p) { return S_INVALID_PTR; }
+    if ((0 == cfg_p->ptime_ms) || (0 == cfg_p->port)) { return S_INVALID_VALUE; }
+    RtpSinkStop();
+    sd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (0 > sd) { return S_OUT_OF_MEMORY; }
+    if (IN_MULTICAST(ntohl(cfg_p->addr))) {
+        setsockopt(sd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    }
+    OS_MemSet(&rtp_sink.dest, 0, sizeof(rtp_sink.dest));
+    rtp_sink.dest.sin_family        = AF_INET;
+    rtp_sink.dest.sin_port          = htons(cfg_p->port);
+    rtp_sink.dest.sin_addr.s_addr   = cfg_p->addr;
+    rtp_sink.sd         = sd;
+    rtp_sink.ptime_ms   = cfg_p->ptime_ms;
+    rtp_sink.is_started = OS_TRUE;
+    OS_LOG(D_INFO, "Start: %s:%u, ptime: %u ms", inet_ntoa(rtp_sink.dest.sin_addr), cfg_p->port, cfg_p->ptime_ms);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status RtpSinkStop(void)
+{
+    rtp_sink.is_started = OS_FALSE;
+    if (NET_SOCKET_UNDEF != rtp_sink.sd) {
+        NET_SOCKET_CLOSE(rtp_sink.sd);
+        rtp_sink.sd = NET_SOCKET_UNDEF;
+        OS_LOG(D_INFO, "Stop");
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool RtpSinkIsStarted(void)
+{
+    return rtp_sink.is_started;
+}
+
+/*****************************************************************************/
+Status RtpSinkPoll(const OS_TimeMs now_ms)
+{
+const U32 epoch = rtp_sink.epoch;
+const U32 pos = ClockPositionGet(now_ms);
+RtpPacket* pkt_p;
+Int len;
+
+    while (OS_TRUE == SpscRingPeek(&rtp_sink.queue, &pkt_p)) {
+        //Packets of the previous stream (stop/seek) and the stopped sink ones are dropped.
+        if ((OS_TRUE == rtp_sink.is_started) && (epoch == pkt_p->epoch)) {
+            //Paced by the playback clock: a packet leaves when its samples start to play locally.
+            if ((OS_TRUE != rtp_sink.is_clock_run) || ((S32)(pkt_p->release_pos - pos) > 0)) { break; }
+            len = sendto(rtp_sink.sd, pkt_p->data, pkt_p->size, 0,
+                         (const struct sockaddr*)&rtp_sink.dest, sizeof(rtp_sink.dest));
+            if (len == (Int)pkt_p->size) {
+                ++rtp_sink.stats.packets_sent;
+                rtp_sink.stats.bytes_sent += len;
+            } else {
+                ++rtp_sink.stats.send_errors;
+            }
+        }
+        SpscRingGet(&rtp_sink.queue, &pkt_p);
+        MemPoolFree(&rtp_sink.pool, pkt_p);
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status RtpSinkFormatSet(const OS_AudioInfo* info_p, const Size period_size)
+{
+U32 primask;
+    RtpSinkSync();
+    rtp_sink.frame_size = 0;
+    if (OS_NULL == info_p) { return S_OK; }
+    if (16 != info_p->sample_bits) { return S_INVALID_VALUE; }
+    rtp_sink.frame_size = info_p->channels * sizeof(S16);
+    rtp_sink.sample_rate= info_p->sample_rate;
+    if (44100 == info_p->sample_rate) {
+        rtp_sink.pt = (2 == info_p->channels) ? RTP_PT_L16_STEREO :
+                      (1 == info_p->channels) ? RTP_PT_L16_MONO : APP_RTP_SINK_PT_DYNAMIC;
+    } else {
+        rtp_sink.pt = APP_RTP_SINK_PT_DYNAMIC;
+    }
+    rtp_sink.ssrc       = (rtp_sink.ssrc * 1103515245UL) + OS_TickCountGet() + 12345;
+    rtp_sink.write_pos  = 0;
+    rtp_sink.is_marker  = OS_TRUE;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    rtp_sink.clock_pos      = 0;
+    rtp_sink.clock_period   = period_size / rtp_sink.frame_size;
+    rtp_sink.is_clock_run   = OS_FALSE;
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return S_OK;
+}
+
+/*****************************************************************************/
+void RtpSinkSync(void)
+{
+    //The partial packet is the player's: it is dropped here, never by NetServ.
+    if (OS_NULL != rtp_sink.pkt_p) {
+        MemPoolFree(&rtp_sink.pool, rtp_sink.pkt_p);
+        rtp_sink.pkt_p = OS_NULL;
+    }
+    //The queued packets of the previous config are dropped by NetServ.
+    ++rtp_sink.epoch;
+    rtp_sink.is_active      = rtp_sink.is_started;
+    rtp_sink.ptime_ms_curr  = rtp_sink.ptime_ms;
+    rtp_sink.is_marker      = OS_TRUE;
+}
+
+/*****************************************************************************/
+void RtpSinkWrite(const U8* data_p, const Size size)
+{
+const Size frame_size = rtp_sink.frame_size;
+Size frames;
+Size chunk;
+
+    if (0 == frame_size) { return; }
+    frames = size / frame_size;
+    if (OS_TRUE != rtp_sink.is_active) {
+        //Keep the stream position for the sink start in the middle of a track.
+        rtp_sink.write_pos += frames;
+        return;
+    }
+    while (0 != frames) {
+        RtpPacket* pkt_p = rtp_sink.pkt_p;
+        if (OS_NULL == pkt_p) {
+            pkt_p = MemPoolAlloc(&rtp_sink.pool);
+            if (OS_NULL == pkt_p) {
+                ++rtp_sink.stats.packets_dropped;
+                rtp_sink.write_pos += frames;
+                return;
+            }
+            PacketBegin(pkt_p);
+            rtp_sink.pkt_p = pkt_p;
+        }
+        chunk = (rtp_sink.pkt_size - pkt_p->size) / frame_size;
+        if (chunk > frames) { chunk = frames; }
+        //Decoder output goes straight into the packet (byte swap to the network order on the way).
+        L16Copy(pkt_p->data + pkt_p->size, data_p, chunk * frame_size);
+        pkt_p->size         += chunk * frame_size;
+        data_p              += chunk * frame_size;
+        frames              -= chunk;
+        rtp_sink.write_pos  += chunk;
+        if (rtp_sink.pkt_size == pkt_p->size) {
+            //The ring holds all the pool packets and NetServ polls it (no wakeup).
+            (void)SpscRingPut(&rtp_sink.queue, &pkt_p);
+            rtp_sink.pkt_p = OS_NULL;
+        }
+    }
+}
+
+/*****************************************************************************/
+void RtpSinkClockAdvance(const Size size)
+{
+const OS_TimeMs now_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+U32 primask;
+    if (0 == rtp_sink.frame_size) { return; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    rtp_sink.clock_pos     += size / rtp_sink.frame_size;
+    rtp_sink.clock_ms       = now_ms;
+    rtp_sink.is_clock_run   = OS_TRUE;
+    APP_CRITICAL_SECTION_EXIT(primask);
+}
+
+/*****************************************************************************/
+Status RtpSinkStatsGet(RtpSinkStats* stats_p)
+{
+SpscRingStats queue_stats;
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    SpscRingStatsGet(&rtp_sink.queue, &queue_stats);
+    *stats_p = rtp_sink.stats;
+    stats_p->seq        = rtp_sink.seq;
+    stats_p->queue_depth= queue_stats.depth;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void PacketBegin(RtpPacket* pkt_p)
+{
+Size frames = (rtp_sink.sample_rate * rtp_sink.ptime_ms_curr) / 1000;
+    if (0 == frames) { frames = 1; }
+    if ((frames * rtp_sink.frame_size) > APP_RTP_SINK_PAYLOAD_MAX) {
+        frames = APP_RTP_SINK_PAYLOAD_MAX / rtp_sink.frame_size;
+    }
+    rtp_sink.pkt_size   = RTP_HDR_SIZE + (frames * rtp_sink.frame_size);
+    pkt_p->release_pos  = rtp_sink.write_pos;
+    pkt_p->epoch        = rtp_sink.epoch;
+    pkt_p->size         = RTP_HDR_SIZE;
+    pkt_p->data[0]      = RTP_VERSION;
+    pkt_p->data[1]      = rtp_sink.pt | (rtp_sink.is_marker ? RTP_MARKER : 0);
+    U16Put(&pkt_p->data[2], rtp_sink.seq++);
+    U32Put(&pkt_p->data[4], rtp_sink.ssrc + rtp_sink.write_pos); //Random timestamp base.
+    U32Put(&pkt_p->data[8], rtp_sink.ssrc);
+    rtp_sink.is_marker  = OS_FALSE;
+}
+
+/*****************************************************************************/
+void L16Copy(U8* dst_p, const U8* src_p, Size size)
+{
+    size /= sizeof(S16);
+    while (size--) {
+        dst_p[0] = src_p[1];
+        dst_p[1] = src_p[0];
+        dst_p += sizeof(S16);
+        src_p += sizeof(S16);
+    }
+}
+
+/*****************************************************************************/
+U32 ClockPositionGet(const OS_TimeMs now_ms)
+{
+U32 pos;
+U32 delta;
+U32 primask;
+    APP_CRITICAL_SECTION_ENTER(primask);
+    pos     = rtp_sink.clock_pos;
+    delta   = (U32)(((U64)(now_ms - rtp_sink.clock_ms) * rtp_sink.sample_rate) / 1000);
+    //Interpolate between the device period events, never beyond the next one.
+    if (delta > rtp_sink.clock_period) { delta = rtp_sink.clock_period; }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    return (pos + delta);
+}
+
+/*****************************************************************************/
+void U16Put(U8* p, const U16 value)
+{
+    p[0] = (U8)(value >> 8);
+    p[1] = (U8)value;
+}
+
+/*****************************************************************************/
+void U32Put(U8* p, const U32 value)
+{
+    p[0] = (U8)(value >> 24);
+    p[1] = (U8)(value >> 16);
+    p[2] = (U8)(value >> 8);
+    p[3] = (U8)value;
+}
+
+#endif //(OS_NETWORK_ENABLED)
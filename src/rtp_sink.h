@@ -0,0 +1,85 @@
+/***************************************************************************//**
+* @file    rtp_sink.h
+* @brief   RTP/UDP L16 PCM stream output.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _RTP_SINK_H_
+#define _RTP_SINK_H_
+
+#include "os_audio.h"
+#include "net_socket.h"
+
+#if (OS_NETWORK_ENABLED)
+//-----------------------------------------------------------------------------
+typedef struct {
+    U32             addr;               // IPv4 address (network order), unicast or multicast.
+    U16             port;
+    U16             ptime_ms;           // Packet time.
+} RtpSinkConfig;
+
+typedef struct {
+    U32             packets_sent;
+    U32             packets_dropped;    // Packet pool exhausted.
+    U32             send_errors;
+    U32             bytes_sent;
+    U16             seq;
+    U16             queue_depth;
+} RtpSinkStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init RTP sink (reserve the packet pool).
+/// @return     #Status.
+Status          RtpSinkInit(void);
+
+/// @brief      Start RTP sink to the destination (NetServ context).
+/// @param[in]  cfg_p          Config.
+/// @return     #Status.
+/// @details    The player takes the change over by RtpSinkSync().
+Status          RtpSinkStart(const RtpSinkConfig* cfg_p);
+
+/// @brief      Stop RTP sink (NetServ context).
+/// @return     #Status.
+/// @details    The player takes the change over by RtpSinkSync().
+Status          RtpSinkStop(void);
+
+/// @brief      Is RTP sink started.
+/// @return     Is started.
+Bool            RtpSinkIsStarted(void);
+
+/// @brief      Send the packets due on the audio clock (NetServ context).
+/// @param[in]  now_ms         Current time.
+/// @return     #Status.
+Status          RtpSinkPoll(const OS_TimeMs now_ms);
+
+/// @brief      Set the stream format and restart the audio clock (player context).
+/// @param[in]  info_p         Audio info (16-bit PCM only); OS_NULL - stream end.
+/// @param[in]  period_size    Audio device buffer period size (bytes).
+/// @return     #Status.
+Status          RtpSinkFormatSet(const OS_AudioInfo* info_p, const Size period_size);
+
+/// @brief      Take over the sink start/stop (player context).
+/// @details    Drops the partial packet and the queued ones of the previous config.
+void            RtpSinkSync(void);
+
+/// @brief      Packetise decoded PCM (player context).
+/// @param[in]  data_p         PCM data (little-endian S16).
+/// @param[in]  size           Data size.
+void            RtpSinkWrite(const U8* data_p, const Size size);
+
+/// @brief      Advance the audio clock by the played data (player context).
+/// @param[in]  size           Played data size (0 - playback start).
+void            RtpSinkClockAdvance(const Size size);
+
+/// @brief      Get RTP sink statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          RtpSinkStatsGet(RtpSinkStats* stats_p);
+
+#else
+#define RtpSinkFormatSet(info_p, period_size)   (S_OK)
+#define RtpSinkSync()
+#define RtpSinkWrite(data_p, size)
+#define RtpSinkClockAdvance(size)
+#endif //(OS_NETWORK_ENABLED)
+
+#endif // _RTP_SINK_H_
@@ -0,0 +1,606 @@
+/***************************************************************************//**
+* @file    settings_store.c
+* @brief   Binary settings store.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "os_time.h"
+#include "os_memory.h"
+#include "os_file_system.h"
+#include "os_environment.h"
+#include "app_common.h"
+#include "crc32.h"
+#include "settings_store.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME                "settings_store"
+#undef  MDL_STATUS_ITEMS
+#define MDL_STATUS_ITEMS        &status_settings_store_v[0]
+
+#define LOG_MAGIC               0x47544553  // "SETG"
+#define RECORD_SYNC             0xA55A
+#define RECORD_DELETED          0xFF        // value_len of the delete record.
+#define RECORD_DATA_MAX         (APP_SETTINGS_STORE_KEY_LEN + APP_SETTINGS_STORE_VALUE_LEN)
+#define ITEMS_MASK              (APP_SETTINGS_STORE_ITEMS_MAX - 1)
+
+//-----------------------------------------------------------------------------
+const StatusItem status_settings_store_v[] = {
+    {"Undefined status"},
+    {"Setting is not found"},
+    {"Settings store is full"},
+    {"Settings log error"},
+};
+
+typedef struct {
+    U32             magic;              // 0 - the log is being written (compaction).
+    U32             generation;
+    U32             crc;                // Header CRC32.
+} LogHdr;
+
+typedef struct {
+    U16             sync;
+    U8              key_len;
+    U8              value_len;
+    U32             crc;                // Lengths and data CRC32.
+} RecordHdr;
+
+typedef struct {
+    OS_QueueHd      qhd;
+    OS_SignalId     signal_id;
+} Subscriber;
+
+//-----------------------------------------------------------------------------
+static Status   KeyMake(ConstStrP section_p, ConstStrP key_p, StrP key_buf_p);
+static U32      KeyHash(ConstStrP key_p);
+static Int      ItemFind(ConstStrP key_p, const U32 hash);
+static Status   ItemPut(ConstStrP key_p, ConstStrP value_p, const U8 flags, Size* idx_p);
+static void     Notify(const U16 idx);
+static Status   LogOpen(const U8 idx, U32* generation_p);
+static Status   LogLoad(void);
+static Status   LogRecordRead(OS_FileHd file_hd, const U32 pos, const U32 size, U8* buf_p,
+                              StrP key_p, StrP value_p, U8* flags_p, Size* record_size_p);
+static Status   LogAppend(OS_FileHd file_hd, const SettingsStoreItem* item_p);
+static U32      RecordCrc(const RecordHdr* hdr_p, U8* data_p);
+static Status   LogCompact(void);
+static Status   IniImport(void);
+static StrP     Trim(StrP str_p);
+
+//-----------------------------------------------------------------------------
+static ConstStrP log_files_v[] = { APP_SETTINGS_STORE_FILE_A, APP_SETTINGS_STORE_FILE_B };
+static SettingsStoreItem* items_v;
+static SettingsStoreStats settings_store_stats;
+static Subscriber subscribers_v[APP_SETTINGS_STORE_SUBSCRIBERS_MAX];
+static OS_FileHd log_hd;
+static U8 log_idx;
+static Bool is_dirty;
+static U8 record_buf[sizeof(RecordHdr) + RECORD_DATA_MAX];
+
+/*****************************************************************************/
+Status SettingsStoreInit(void)
+{
+const OS_Tick tick_start = OS_TickCountGet();
+U32 generation_v[ITEMS_COUNT_GET(log_files_v, ConstStrP)];
+Status s = S_UNDEF;
+
+    items_v = OS_MallocEx(sizeof(SettingsStoreItem) * APP_SETTINGS_STORE_ITEMS_MAX, APP_SETTINGS_STORE_MEMORY);
+    if (OS_NULL == items_v) { return S_OUT_OF_MEMORY; }
+    OS_MemSet(items_v, 0, sizeof(SettingsStoreItem) * APP_SETTINGS_STORE_ITEMS_MAX);
+    //The newest valid log.
+    for (U8 i = 0; i < ITEMS_COUNT_GET(log_files_v, ConstStrP); ++i) {
+        generation_v[i] = 0;
+        IF_OK(LogOpen(i, &generation_v[i])) {
+            OS_FileClose(&log_hd);
+        }
+    }
+    if (generation_v[0] | generation_v[1]) {
+        log_idx = (generation_v[0] < generation_v[1]) ? 1 : 0;
+        settings_store_stats.generation = generation_v[log_idx];
+        IF_OK(s = LogOpen(log_idx, &settings_store_stats.generation)) {
+            s = LogLoad();
+        }
+    } else {
+        //First start: the INI settings are the initial ones.
+        IF_OK(s = IniImport()) {
+            settings_store_stats.is_imported = OS_TRUE;
+        } else { OS_LOG_S(D_WARNING, s); }
+        log_idx = 1; //Compaction target: 0.
+        s = LogCompact();
+    }
+    IF_OK(s) {
+        settings_store_stats.load_ms = OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+        APP_MEMORY_BARRIER();
+        settings_store_stats.is_loaded = OS_TRUE;
+        OS_LOG(D_INFO, "Items: %u, records: %u, loaded in %u ms%s", settings_store_stats.items,
+               settings_store_stats.records, settings_store_stats.load_ms,
+               (OS_TRUE == settings_store_stats.is_imported) ? " (INI import)" : "");
+        Notify(SETTINGS_STORE_IDX_ALL);
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status SettingsStoreGet(ConstStrP section_p, ConstStrP key_p, StrP value_p, const Size size)
+{
+Str key[APP_SETTINGS_STORE_KEY_LEN];
+Int idx;
+Status s = S_UNDEF;
+
+    if (OS_NULL == value_p) { return S_INVALID_PTR; }
+    if (OS_TRUE != settings_store_stats.is_loaded) { return S_INVALID_STATE; }
+    IF_STATUS(s = KeyMake(section_p, key_p, key)) { return s; }
+    idx = ItemFind(key, KeyHash(key));
+    if ((0 > idx) || (BIT_TEST(items_v[idx].flags, SETTINGS_STORE_FLAG_DELETED)) ||
+        !(BIT_TEST(items_v[idx].flags, SETTINGS_STORE_FLAG_USED))) {
+        return S_SETTINGS_STORE_NOT_FOUND;
+    }
+    {
+        const SettingsStoreItem* item_p = &items_v[idx];
+        U32 primask;
+        APP_CRITICAL_SECTION_ENTER(primask);
+        if (OS_StrLen(item_p->value) < size) {
+            OS_StrCpy(value_p, item_p->value);
+            s = S_OK;
+        } else { s = S_INVALID_SIZE; }
+        APP_CRITICAL_SECTION_EXIT(primask);
+    }
+    return s;
+}
+
+/*****************************************************************************/
+Status SettingsStoreSet(ConstStrP section_p, ConstStrP key_p, ConstStrP value_p)
+{
+Str key[APP_SETTINGS_STORE_KEY_LEN];
+Size idx;
+Status s = S_UNDEF;
+
+    if (OS_TRUE != settings_store_stats.is_loaded) { return S_INVALID_STATE; }
+    IF_STATUS(s = KeyMake(section_p, key_p, key)) { return s; }
+    if (OS_NULL == value_p) {
+        const Int found_idx = ItemFind(key, KeyHash(key));
+        if ((0 > found_idx) || !(BIT_TEST(items_v[found_idx].flags, SETTINGS_STORE_FLAG_USED))) {
+            return S_SETTINGS_STORE_NOT_FOUND;
+        }
+        IF_STATUS(s = ItemPut(key, "", SETTINGS_STORE_FLAG_DELETED | SETTINGS_STORE_FLAG_DIRTY, &idx)) { return s; }
+    } else {
+        IF_STATUS(s = ItemPut(key, value_p, SETTINGS_STORE_FLAG_DIRTY, &idx)) { return s; }
+    }
+    is_dirty = OS_TRUE;
+    Notify(idx);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status SettingsStoreSubscribe(const OS_QueueHd qhd, const OS_SignalId signal_id)
+{
+    if (OS_NULL == qhd) { return S_INVALID_QUEUE; }
+    for (Size i = 0; i < ITEMS_COUNT_GET(subscribers_v, Subscriber); ++i) {
+        Subscriber* subscriber_p = &subscribers_v[i];
+        if (qhd == subscriber_p->qhd) { return S_OK; }
+        if (OS_NULL == subscriber_p->qhd) {
+            subscriber_p->signal_id = signal_id;
+            APP_MEMORY_BARRIER();
+            subscriber_p->qhd = qhd;
+            return S_OK;
+        }
+    }
+    return S_OUT_OF_MEMORY;
+}
+
+/*****************************************************************************/
+Bool SettingsStoreStep(void)
+{
+SettingsStoreItem item;
+Bool is_append = OS_FALSE;
+Status s = S_OK;
+
+    if ((OS_TRUE != settings_store_stats.is_loaded) || (OS_TRUE != is_dirty)) { return OS_FALSE; }
+    is_dirty = OS_FALSE;
+    IF_STATUS(s = OS_FileLSeek(log_hd, settings_store_stats.log_size)) { return OS_FALSE; }
+    for (Size i = 0; i < APP_SETTINGS_STORE_ITEMS_MAX; ++i) {
+        U32 primask;
+        if (!BIT_TEST(items_v[i].flags, SETTINGS_STORE_FLAG_DIRTY)) { continue; }
+        //Item is copied out: a change while it is written marks it again.
+        APP_CRITICAL_SECTION_ENTER(primask);
+        items_v[i].flags &= ~SETTINGS_STORE_FLAG_DIRTY;
+        item = items_v[i];
+        APP_CRITICAL_SECTION_EXIT(primask);
+        IF_STATUS(s = LogAppend(log_hd, &item)) { break; }
+        is_append = OS_TRUE;
+    }
+    if (OS_TRUE == is_append) { OS_FileSync(log_hd); }
+    IF_STATUS(s) {
+        OS_LOG_S(D_WARNING, S_SETTINGS_STORE_FILE_ERROR);
+        is_dirty = OS_TRUE;
+        return OS_FALSE;
+    }
+    //Dead records outweigh the live ones.
+    if ((APP_SETTINGS_STORE_COMPACT_SIZE < settings_store_stats.log_size) &&
+        (settings_store_stats.records > (settings_store_stats.items * 2))) {
+        IF_STATUS(LogCompact()) { OS_LOG_S(D_WARNING, S_SETTINGS_STORE_FILE_ERROR); }
+    }
+    return is_dirty;
+}
+
+/*****************************************************************************/
+Status SettingsStoreStatsGet(SettingsStoreStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = settings_store_stats;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status SettingsStoreItemGet(const Size idx, SettingsStoreItem* item_p)
+{
+U32 primask;
+    if (OS_NULL == item_p) { return S_INVALID_PTR; }
+    if (OS_NULL == items_v) { return S_INVALID_STATE; }
+    if (APP_SETTINGS_STORE_ITEMS_MAX <= idx) { return S_INVALID_VALUE; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    *item_p = items_v[idx];
+    APP_CRITICAL_SECTION_EXIT(primask);
+    if (!BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_USED) || BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_DELETED)) {
+        return S_SETTINGS_STORE_NOT_FOUND;
+    }
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status SettingsStoreLogGet(ConstStrP section_p, ConstStrP key_p, StrP value_p, const Size size)
+{
+//Own buffers: BgServ appends with record_buf.
+U8 buf[sizeof(RecordHdr) + RECORD_DATA_MAX];
+Str key[APP_SETTINGS_STORE_KEY_LEN];
+Str record_key[APP_SETTINGS_STORE_KEY_LEN];
+Str record_value[APP_SETTINGS_STORE_VALUE_LEN];
+OS_FileHd file_hd;
+U32 file_size;
+U32 pos = sizeof(LogHdr);
+Size record_size;
+U8 flags;
+Status s = S_UNDEF;
+
+    if (OS_NULL == value_p) { return S_INVALID_PTR; }
+    if (OS_TRUE != settings_store_stats.is_loaded) { return S_INVALID_STATE; }
+    IF_STATUS(s = KeyMake(section_p, key_p, key)) { return s; }
+    IF_STATUS(s = OS_FileOpen(&file_hd, log_files_v[log_idx],
+                              BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        return s;
+    }
+    file_size = OS_FileSizeGet(file_hd);
+    //The last record of the key wins (as on the load).
+    s = S_SETTINGS_STORE_NOT_FOUND;
+    IF_OK(OS_FileLSeek(file_hd, pos)) {
+        while (S_OK == LogRecordRead(file_hd, pos, file_size, buf, record_key, record_value, &flags, &record_size)) {
+            if (!OS_StrCmp(key, record_key)) {
+                if (BIT_TEST(flags, SETTINGS_STORE_FLAG_DELETED)) {
+                    s = S_SETTINGS_STORE_NOT_FOUND;
+                } else if (OS_StrLen(record_value) < size) {
+                    OS_StrCpy(value_p, record_value);
+                    s = S_OK;
+                } else { s = S_INVALID_SIZE; }
+            }
+            pos += record_size;
+        }
+    }
+    OS_FileClose(&file_hd);
+    return s;
+}
+
+/*****************************************************************************/
+Status KeyMake(ConstStrP section_p, ConstStrP key_p, StrP key_buf_p)
+{
+Size section_len, key_len;
+    if ((OS_NULL == section_p) || (OS_NULL == key_p)) { return S_INVALID_PTR; }
+    section_len = OS_StrLen(section_p);
+    key_len     = OS_StrLen(key_p);
+    if ((0 == key_len) || ((section_len + 1 + key_len) >= APP_SETTINGS_STORE_KEY_LEN)) { return S_INVALID_SIZE; }
+    OS_MemCpy(key_buf_p, section_p, section_len);
+    key_buf_p[section_len] = '/';
+    OS_MemCpy(&key_buf_p[section_len + 1], key_p, key_len + 1);
+    return S_OK;
+}
+
+/*****************************************************************************/
+U32 KeyHash(ConstStrP key_p)
+{
+//FNV-1a.
+U32 hash = 0x811C9DC5;
+    while ('\0' != *key_p) {
+        hash ^= (U8)*key_p++;
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+/*****************************************************************************/
+Int ItemFind(ConstStrP key_p, const U32 hash)
+{
+Size idx = hash & ITEMS_MASK;
+    //Linear probing: the items are never removed (delete is a flag).
+    for (Size i = 0; i < APP_SETTINGS_STORE_ITEMS_MAX; ++i) {
+        const SettingsStoreItem* item_p = &items_v[idx];
+        if (!BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_USED)) { return idx; }
+        if ((hash == item_p->hash) && !OS_StrCmp(key_p, item_p->key)) { return idx; }
+        idx = (idx + 1) & ITEMS_MASK;
+    }
+    return -1;
+}
+
+/*****************************************************************************/
+Status ItemPut(ConstStrP key_p, ConstStrP value_p, const U8 flags, Size* idx_p)
+{
+const U32 hash = KeyHash(key_p);
+SettingsStoreItem* item_p;
+Int idx;
+U32 primask;
+
+    if (APP_SETTINGS_STORE_VALUE_LEN <= OS_StrLen(value_p)) { return S_INVALID_SIZE; }
+    //Slot claim and fill are atomic against the other writers.
+    APP_CRITICAL_SECTION_ENTER(primask);
+    idx = ItemFind(key_p, hash);
+    if (0 > idx) {
+        APP_CRITICAL_SECTION_EXIT(primask);
+        return S_SETTINGS_STORE_FULL;
+    }
+    item_p = &items_v[idx];
+    if (!BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_USED)) {
+        item_p->hash = hash;
+        OS_StrCpy(item_p->key, key_p);
+    }
+    if (BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_USED) && !BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_DELETED)) {
+        --settings_store_stats.items;
+    }
+    OS_StrCpy(item_p->value, value_p);
+    item_p->flags = SETTINGS_STORE_FLAG_USED | flags;
+    if (!BIT_TEST(flags, SETTINGS_STORE_FLAG_DELETED)) { ++settings_store_stats.items; }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    *idx_p = idx;
+    return S_OK;
+}
+
+/*****************************************************************************/
+void Notify(const U16 idx)
+{
+    for (Size i = 0; i < ITEMS_COUNT_GET(subscribers_v, Subscriber); ++i) {
+        const Subscriber* subscriber_p = &subscribers_v[i];
+        if (OS_NULL == subscriber_p->qhd) { break; }
+        IF_STATUS(OS_SignalSend(subscriber_p->qhd, OS_SignalCreate(subscriber_p->signal_id, idx), OS_MSG_PRIO_NORMAL)) {
+            OS_LOG_S(D_DEBUG, S_INVALID_QUEUE);
+        }
+    }
+}
+
+/*****************************************************************************/
+Status LogOpen(const U8 idx, U32* generation_p)
+{
+LogHdr hdr;
+Status s = S_UNDEF;
+
+    IF_STATUS(s = OS_FileOpen(&log_hd, log_files_v[idx],
+                              BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ) |
+                              BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        return s;
+    }
+    IF_OK(s = OS_FileRead(log_hd, &hdr, sizeof(hdr))) {
+        if ((LOG_MAGIC == hdr.magic) && (hdr.crc == Crc32((U8*)&hdr, sizeof(hdr) - sizeof(hdr.crc)))) {
+            *generation_p = hdr.generation;
+        } else { s = S_SETTINGS_STORE_FILE_ERROR; }
+    }
+    IF_STATUS(s) { OS_FileClose(&log_hd); }
+    return s;
+}
+
+/*****************************************************************************/
+Status LogLoad(void)
+{
+const U32 size = OS_FileSizeGet(log_hd);
+U32 pos = sizeof(LogHdr);
+Str key[APP_SETTINGS_STORE_KEY_LEN];
+Str value[APP_SETTINGS_STORE_VALUE_LEN];
+Size record_size;
+U8 flags;
+Size idx;
+
+    settings_store_stats.records = 0;
+    while (S_OK == LogRecordRead(log_hd, pos, size, record_buf, key, value, &flags, &record_size)) {
+        IF_STATUS(ItemPut(key, value, flags, &idx)) {
+            OS_LOG_S(D_WARNING, S_SETTINGS_STORE_FULL);
+        }
+        pos += record_size;
+        ++settings_store_stats.records;
+    }
+    if (pos != size) {
+        //Torn tail (power loss while appending): the next append overwrites it.
+        OS_LOG(D_WARNING, "Log tail dropped: %u bytes", size - pos);
+        IF_OK(OS_FileLSeek(log_hd, pos)) { OS_FileTruncate(log_hd); }
+    }
+    settings_store_stats.log_size = pos;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status LogRecordRead(OS_FileHd file_hd, const U32 pos, const U32 size, U8* buf_p,
+                     StrP key_p, StrP value_p, U8* flags_p, Size* record_size_p)
+{
+const RecordHdr* hdr_p = (RecordHdr*)buf_p;
+U8* data_p = &buf_p[sizeof(RecordHdr)];
+Size value_len;
+Status s = S_UNDEF;
+
+    //Sequential read: pos is the file position.
+    if ((pos + sizeof(RecordHdr)) > size) { return S_SETTINGS_STORE_NOT_FOUND; }
+    IF_STATUS(s = OS_FileRead(file_hd, buf_p, sizeof(RecordHdr))) { return s; }
+    value_len = (RECORD_DELETED == hdr_p->value_len) ? 0 : hdr_p->value_len;
+    if ((RECORD_SYNC != hdr_p->sync) || (0 == hdr_p->key_len) ||
+        (APP_SETTINGS_STORE_KEY_LEN <= hdr_p->key_len) || (APP_SETTINGS_STORE_VALUE_LEN <= value_len) ||
+        ((pos + sizeof(RecordHdr) + hdr_p->key_len + value_len) > size)) {
+        return S_SETTINGS_STORE_FILE_ERROR;
+    }
+    IF_STATUS(s = OS_FileRead(file_hd, data_p, hdr_p->key_len + value_len)) { return s; }
+    if (hdr_p->crc != RecordCrc(hdr_p, data_p)) { return S_SETTINGS_STORE_FILE_ERROR; }
+    OS_MemCpy(key_p, data_p, hdr_p->key_len);
+    key_p[hdr_p->key_len] = '\0';
+    OS_MemCpy(value_p, &data_p[hdr_p->key_len], value_len);
+    value_p[value_len] = '\0';
+    *flags_p        = (RECORD_DELETED == hdr_p->value_len) ? SETTINGS_STORE_FLAG_DELETED : 0;
+    *record_size_p  = sizeof(RecordHdr) + hdr_p->key_len + value_len;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status LogAppend(OS_FileHd file_hd, const SettingsStoreItem* item_p)
+{
+RecordHdr* hdr_p = (RecordHdr*)record_buf;
+U8* data_p = &record_buf[sizeof(RecordHdr)];
+const Size key_len = OS_StrLen(item_p->key);
+const Bool is_deleted = (0 != BIT_TEST(item_p->flags, SETTINGS_STORE_FLAG_DELETED)) ? OS_TRUE : OS_FALSE;
+const Size value_len = (OS_TRUE == is_deleted) ? 0 : OS_StrLen(item_p->value);
+const Size size = sizeof(RecordHdr) + key_len + value_len;
+Status s = S_UNDEF;
+
+    hdr_p->sync     = RECORD_SYNC;
+    hdr_p->key_len  = key_len;
+    hdr_p->value_len= (OS_TRUE == is_deleted) ? RECORD_DELETED : value_len;
+    OS_MemCpy(data_p, item_p->key, key_len);
+    OS_MemCpy(&data_p[key_len], item_p->value, value_len);
+    hdr_p->crc      = RecordCrc(hdr_p, data_p);
+    IF_OK(s = OS_FileWrite(file_hd, record_buf, size)) {
+        settings_store_stats.log_size += size;
+        ++settings_store_stats.records;
+    }
+    return s;
+}
+
+/*****************************************************************************/
+U32 RecordCrc(const RecordHdr* hdr_p, U8* data_p)
+{
+const Size value_len = (RECORD_DELETED == hdr_p->value_len) ? 0 : hdr_p->value_len;
+U32 crc = Crc32Delta((U8*)&hdr_p->key_len, sizeof(hdr_p->key_len) + sizeof(hdr_p->value_len), CRC32_POLYNOMIAL);
+    crc = Crc32Delta(data_p, hdr_p->key_len + value_len, crc);
+    return (crc ^ CRC32_POLYNOMIAL);
+}
+
+/*****************************************************************************/
+Status LogCompact(void)
+{
+const U8 new_idx = log_idx ^ 1;
+LogHdr hdr = { 0, settings_store_stats.generation + 1, 0 };
+OS_FileHd new_hd;
+SettingsStoreItem item;
+Status s = S_UNDEF;
+
+    IF_STATUS(s = OS_FileOpen(&new_hd, log_files_v[new_idx],
+                              BIT(OS_FS_FILE_OP_MODE_CREATE_ALWAYS) | BIT(OS_FS_FILE_OP_MODE_READ) |
+                              BIT(OS_FS_FILE_OP_MODE_WRITE))) {
+        return s;
+    }
+    settings_store_stats.log_size   = sizeof(hdr);
+    settings_store_stats.records    = 0;
+    //Invalid header till all the live items are written.
+    IF_OK(s = OS_FileWrite(new_hd, &hdr, sizeof(hdr))) {
+        for (Size i = 0; i < APP_SETTINGS_STORE_ITEMS_MAX; ++i) {
+            U32 primask;
+            APP_CRITICAL_SECTION_ENTER(primask);
+            items_v[i].flags &= ~SETTINGS_STORE_FLAG_DIRTY;
+            item = items_v[i];
+            APP_CRITICAL_SECTION_EXIT(primask);
+            if (!BIT_TEST(item.flags, SETTINGS_STORE_FLAG_USED) || BIT_TEST(item.flags, SETTINGS_STORE_FLAG_DELETED)) {
+                continue;
+            }
+            IF_STATUS(s = LogAppend(new_hd, &item)) { break; }
+        }
+    }
+    IF_OK(s) {
+        IF_OK(s = OS_FileSync(new_hd)) {
+            hdr.magic   = LOG_MAGIC;
+            hdr.crc     = Crc32((U8*)&hdr, sizeof(hdr) - sizeof(hdr.crc));
+            IF_OK(s = OS_FileLSeek(new_hd, 0)) {
+                IF_OK(s = OS_FileWrite(new_hd, &hdr, sizeof(hdr))) {
+                    s = OS_FileSync(new_hd);
+                }
+            }
+        }
+    }
+    IF_STATUS(s) {
+        OS_FileClose(&new_hd);
+        return s;
+    }
+    //The new log is valid: the old one goes.
+    if (OS_NULL != log_hd) { OS_FileClose(&log_hd); }
+    OS_FileDelete(log_files_v[log_idx]);
+    log_hd  = new_hd;
+    log_idx = new_idx;
+    settings_store_stats.generation = hdr.generation;
+    ++settings_store_stats.compactions;
+    OS_LOG(D_DEBUG, "Compacted: %u records, %u bytes", settings_store_stats.records, settings_store_stats.log_size);
+    return S_OK;
+}
+
+/*****************************************************************************/
+Status IniImport(void)
+{
+ConstStrP path_p = OS_EnvVariableGet("config_file");
+Str section[APP_SETTINGS_STORE_KEY_LEN] = "";
+Str key[APP_SETTINGS_STORE_KEY_LEN];
+OS_FileHd file_hd;
+StrP text_p;
+StrP line_p;
+StrP end_p;
+Size size;
+Size idx;
+Status s = S_UNDEF;
+
+    if (OS_NULL == path_p) { return S_INVALID_PTR; }
+    IF_STATUS(s = OS_FileOpen(&file_hd, path_p, BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
+        return s;
+    }
+    size = OS_FileSizeGet(file_hd);
+    size = (APP_SETTINGS_STORE_IMPORT_SIZE < size) ? APP_SETTINGS_STORE_IMPORT_SIZE : size;
+    text_p = OS_MallocEx(size + 1, APP_SETTINGS_STORE_MEMORY);
+    if (OS_NULL == text_p) {
+        OS_FileClose(&file_hd);
+        return S_OUT_OF_MEMORY;
+    }
+    s = OS_FileRead(file_hd, text_p, size);
+    OS_FileClose(&file_hd);
+    IF_OK(s) {
+        text_p[size] = '\0';
+        end_p = &text_p[size];
+        //[Section] and key=value lines; ';' and '#' are comments.
+        for (line_p = text_p; line_p < end_p; ) {
+            StrP eol_p = line_p;
+            StrP sep_p;
+            while ((eol_p < end_p) && ('\n' != *eol_p)) { ++eol_p; }
+            *eol_p = '\0';
+            line_p = Trim(line_p);
+            if ('[' == *line_p) {
+                sep_p = line_p;
+                while (('\0' != *sep_p) && (']' != *sep_p)) { ++sep_p; }
+                *sep_p = '\0';
+                if (OS_StrLen(&line_p[1]) < sizeof(section)) { OS_StrCpy(section, &line_p[1]); }
+            } else if ((';' != *line_p) && ('#' != *line_p)) {
+                for (sep_p = line_p; ('\0' != *sep_p) && ('=' != *sep_p); ++sep_p) {};
+                if ('=' == *sep_p) {
+                    *sep_p = '\0';
+                    IF_OK(KeyMake(section, Trim(line_p), key)) {
+                        IF_STATUS(ItemPut(key, Trim(&sep_p[1]), 0, &idx)) { OS_LOG(D_WARNING, "Skipped: %s", key); }
+                    }
+                }
+            }
+            line_p = eol_p + 1;
+        }
+    }
+    OS_FreeEx(text_p, APP_SETTINGS_STORE_MEMORY);
+    return s;
+}
+
+/*****************************************************************************/
+StrP Trim(StrP str_p)
+{
+StrP end_p;
+    while ((' ' == *str_p) || ('\t' == *str_p)) { ++str_p; }
+    end_p = str_p + OS_StrLen(str_p);
+    while ((end_p > str_p) && ((' ' == end_p[-1]) || ('\t' == end_p[-1]) || ('\r' == end_p[-1]))) { --end_p; }
+    *end_p = '\0';
+    return str_p;
+}
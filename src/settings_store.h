@@ -0,0 +1,102 @@
+/***************************************************************************//**
+* @file    settings_store.h
+* @brief   Binary settings store.
+* @author  A. Filyanov
+* @details Settings are kept in the append-only log of CRC32 protected records
+*          ("Section/key" = value) and loaded once into the hashed in-RAM
+*          index, so a read is a memory lookup. Changes are appended and the
+*          log is compacted by BgServ. The INI settings file is imported if
+*          there is no log yet.
+*******************************************************************************/
+#ifndef _SETTINGS_STORE_H_
+#define _SETTINGS_STORE_H_
+
+#include "os_common.h"
+#include "app_config.h"
+
+//-----------------------------------------------------------------------------
+#define SETTINGS_STORE_IDX_ALL  U16_MAX  // Notification data: all the items (load).
+
+enum {
+    S_SETTINGS_STORE_UNDEF = S_MODULE,
+    S_SETTINGS_STORE_NOT_FOUND,
+    S_SETTINGS_STORE_FULL,
+    S_SETTINGS_STORE_FILE_ERROR,
+    S_SETTINGS_STORE_LAST
+};
+
+enum {
+    SETTINGS_STORE_FLAG_USED    = BIT(0),
+    SETTINGS_STORE_FLAG_DELETED = BIT(1),
+    SETTINGS_STORE_FLAG_DIRTY   = BIT(2), // Not in the log yet.
+};
+
+typedef struct {
+    U32             hash;
+    Str             key[APP_SETTINGS_STORE_KEY_LEN];
+    Str             value[APP_SETTINGS_STORE_VALUE_LEN];
+    U8              flags;
+} SettingsStoreItem;
+
+typedef struct {
+    U16             items;
+    U16             records;            // Log records (live and dead).
+    U32             log_size;
+    U32             generation;
+    U32             load_ms;            // Startup load (and import) time.
+    U16             compactions;
+    Bool            is_loaded;
+    Bool            is_imported;
+} SettingsStoreStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init settings store (load the log or import the INI file).
+/// @return     #Status.
+Status          SettingsStoreInit(void);
+
+/// @brief      Get setting value.
+/// @param[in]  section_p      Section.
+/// @param[in]  key_p          Key.
+/// @param[out] value_p        Value.
+/// @param[in]  size           Value buffer size.
+/// @return     #Status.
+Status          SettingsStoreGet(ConstStrP section_p, ConstStrP key_p, StrP value_p, const Size size);
+
+/// @brief      Set setting value (the log is appended by BgServ).
+/// @param[in]  section_p      Section.
+/// @param[in]  key_p          Key.
+/// @param[in]  value_p        Value (OS_NULL - delete).
+/// @return     #Status.
+Status          SettingsStoreSet(ConstStrP section_p, ConstStrP key_p, ConstStrP value_p);
+
+/// @brief      Subscribe to the settings changes.
+/// @param[in]  qhd            Subscriber queue.
+/// @param[in]  signal_id      Signal (data: item index or #SETTINGS_STORE_IDX_ALL).
+/// @return     #Status.
+Status          SettingsStoreSubscribe(const OS_QueueHd qhd, const OS_SignalId signal_id);
+
+/// @brief      Append the changes and compact the log (BgServ context).
+/// @return     Work is pending.
+Bool            SettingsStoreStep(void);
+
+/// @brief      Get settings store statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          SettingsStoreStatsGet(SettingsStoreStats* stats_p);
+
+/// @brief      Get settings store item.
+/// @param[in]  idx            Item index.
+/// @param[out] item_p         Item.
+/// @return     #Status.
+Status          SettingsStoreItemGet(const Size idx, SettingsStoreItem* item_p);
+
+/// @brief      Get setting value from the log (as it is loaded on the next startup).
+/// @param[in]  section_p      Section.
+/// @param[in]  key_p          Key.
+/// @param[out] value_p        Value.
+/// @param[in]  size           Value buffer size.
+/// @return     #Status.
+/// @details    The changes are in the log once BgServ has appended them.
+Status          SettingsStoreLogGet(ConstStrP section_p, ConstStrP key_p, StrP value_p, const Size size);
+
+#endif // _SETTINGS_STORE_H_
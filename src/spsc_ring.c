@@ -0,0 +1,108 @@
+/***************************************************************************//**
+* @file    spsc_ring.c
+* @brief   Lock-free single producer/single consumer ring.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "app_common.h"
+#include "spsc_ring.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "spsc_ring"
+
+/*****************************************************************************/
+Status SpscRingInit(SpscRing* ring_p, void* mem_p, const U16 item_size, const U16 items_count)
+{
+    if ((OS_NULL == ring_p) || (OS_NULL == mem_p)) { return S_INVALID_PTR; }
+    if ((0 == item_size) || (0 == items_count) || (items_count & (items_count - 1))) {
+        return S_INVALID_SIZE;
+    }
+    ring_p->buf_p       = (U8*)mem_p;
+    ring_p->item_size   = item_size;
+    ring_p->mask        = items_count - 1;
+    ring_p->head        = 0;
+    ring_p->tail        = 0;
+    ring_p->is_notified = OS_FALSE;
+    ring_p->overflows   = 0;
+    ring_p->notifies    = 0;
+    ring_p->depth_max   = 0;
+    return S_OK;
+}
+
+/*****************************************************************************/
+Bool SpscRingPut(SpscRing* ring_p, const void* item_p)
+{
+const U32 head = ring_p->head;
+const U32 depth = head - ring_p->tail;
+    if (depth > ring_p->mask) {
+        ++ring_p->overflows;
+        return OS_FALSE;
+    }
+    OS_MemCpy(&ring_p->buf_p[(head & ring_p->mask) * ring_p->item_size], item_p, ring_p->item_size);
+    //Item is in place before the consumer sees it.
+    APP_MEMORY_BARRIER();
+    ring_p->head = head + 1;
+    if (depth >= ring_p->depth_max) { ring_p->depth_max = depth + 1; }
+    //Store-load order: the head store is seen before the flag read (pairs with SpscRingNotifyClear()).
+    APP_MEMORY_BARRIER();
+    if (OS_TRUE == ring_p->is_notified) { return OS_FALSE; }
+    ring_p->is_notified = OS_TRUE;
+    ++ring_p->notifies;
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+void SpscRingNotifyCancel(SpscRing* ring_p)
+{
+    --ring_p->notifies;
+    ring_p->is_notified = OS_FALSE;
+}
+
+/*****************************************************************************/
+Bool SpscRingGet(SpscRing* ring_p, void* item_p)
+{
+const U32 tail = ring_p->tail;
+    if (tail == ring_p->head) { return OS_FALSE; }
+    APP_MEMORY_BARRIER();
+    OS_MemCpy(item_p, &ring_p->buf_p[(tail & ring_p->mask) * ring_p->item_size], ring_p->item_size);
+    //Slot is read before the producer may reuse it.
+    APP_MEMORY_BARRIER();
+    ring_p->tail = tail + 1;
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Bool SpscRingPeek(const SpscRing* ring_p, void* item_p)
+{
+const U32 tail = ring_p->tail;
+    if (tail == ring_p->head) { return OS_FALSE; }
+    APP_MEMORY_BARRIER();
+    OS_MemCpy(item_p, &ring_p->buf_p[(tail & ring_p->mask) * ring_p->item_size], ring_p->item_size);
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+void SpscRingNotifyClear(SpscRing* ring_p)
+{
+    ring_p->is_notified = OS_FALSE;
+    //The items put after this point are notified again.
+    APP_MEMORY_BARRIER();
+}
+
+/*****************************************************************************/
+void SpscRingFlush(SpscRing* ring_p)
+{
+    SpscRingNotifyClear(ring_p);
+    ring_p->tail = ring_p->head;
+}
+
+/*****************************************************************************/
+Status SpscRingStatsGet(const SpscRing* ring_p, SpscRingStats* stats_p)
+{
+    if ((OS_NULL == ring_p) || (OS_NULL == stats_p)) { return S_INVALID_PTR; }
+    stats_p->items_count= ring_p->mask + 1;
+    stats_p->depth      = (U16)(ring_p->head - ring_p->tail);
+    stats_p->depth_max  = ring_p->depth_max;
+    stats_p->overflows  = ring_p->overflows;
+    stats_p->notifies   = ring_p->notifies;
+    return S_OK;
+}
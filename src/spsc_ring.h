@@ -0,0 +1,84 @@
+/***************************************************************************//**
+* @file    spsc_ring.h
+* @brief   Lock-free single producer/single consumer ring.
+* @author  A. Filyanov
+* @details ISR to task handoff: the producer (ISR) puts the items and sends
+*          the consumer wakeup only if SpscRingPut() asks for it; the consumer
+*          calls SpscRingNotifyClear() on the wakeup and then drains the ring,
+*          so many items are taken with a single wakeup. A failed wakeup send
+*          is re-armed by SpscRingNotifyCancel().
+*******************************************************************************/
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    U8*             buf_p;
+    U16             item_size;
+    U16             mask;               // Items count - 1.
+    volatile U32    head;               // Producer owned.
+    volatile U32    tail;               // Consumer owned.
+    volatile Bool   is_notified;        // Set by the producer, cleared by the consumer.
+    U32             overflows;          // Producer owned.
+    U32             notifies;           // Producer owned.
+    U16             depth_max;          // Producer owned.
+} SpscRing;
+
+typedef struct {
+    U16             items_count;
+    U16             depth;
+    U16             depth_max;
+    U32             overflows;
+    U32             notifies;
+} SpscRingStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init ring over the preallocated memory region.
+/// @param[in]  ring_p         Ring.
+/// @param[in]  mem_p          Memory region (items_count * item_size bytes).
+/// @param[in]  item_size      Item size.
+/// @param[in]  items_count    Items count (power of 2).
+/// @return     #Status.
+Status          SpscRingInit(SpscRing* ring_p, void* mem_p, const U16 item_size, const U16 items_count);
+
+/// @brief      Put item to the ring (producer).
+/// @param[in]  ring_p         Ring.
+/// @param[in]  item_p         Item.
+/// @return     Consumer wakeup is needed.
+/// @details    Full ring drops the item and counts the overflow.
+Bool            SpscRingPut(SpscRing* ring_p, const void* item_p);
+
+/// @brief      Re-arm the wakeup after its send has failed (producer).
+/// @param[in]  ring_p         Ring.
+/// @details    The next SpscRingPut() asks for the wakeup again.
+void            SpscRingNotifyCancel(SpscRing* ring_p);
+
+/// @brief      Get item from the ring (consumer).
+/// @param[in]  ring_p         Ring.
+/// @param[out] item_p         Item.
+/// @return     Item is got.
+Bool            SpscRingGet(SpscRing* ring_p, void* item_p);
+
+/// @brief      Peek the oldest item, it stays in the ring (consumer).
+/// @param[in]  ring_p         Ring.
+/// @param[out] item_p         Item.
+/// @return     Item is peeked.
+Bool            SpscRingPeek(const SpscRing* ring_p, void* item_p);
+
+/// @brief      Re-arm the producer wakeup (consumer, before the drain).
+/// @param[in]  ring_p         Ring.
+void            SpscRingNotifyClear(SpscRing* ring_p);
+
+/// @brief      Drop all the items and re-arm the wakeup (consumer).
+/// @param[in]  ring_p         Ring.
+void            SpscRingFlush(SpscRing* ring_p);
+
+/// @brief      Get ring statistics.
+/// @param[in]  ring_p         Ring.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          SpscRingStatsGet(const SpscRing* ring_p, SpscRingStats* stats_p);
+
+#endif // _SPSC_RING_H_
@@ -14,6 +14,8 @@
 #include "os_environment.h"
 #include "drv_rtc.h"
 #include "app_common.h"
+#include "msg_pool.h"
+#include "spsc_ring.h"
 #include "task_a_ko.h"
 
 //------------------------------------------------------------------------------
@@ -22,6 +24,27 @@ enum {
     OS_EVENT_WAKEUP,
 };
 
+#define BUTTON_EVENTS_COUNT     8
+#define BUTTONS_COUNT           ITEMS_COUNT_GET(buttons_cfg_v, ButtonConfig)
+#define TIMER_DEBOUNCE_ID       16
+
+typedef enum {
+    BUTTON_STATE_IDLE,
+    BUTTON_STATE_PRESS,                 // Press debounce.
+    BUTTON_STATE_HELD,
+    BUTTON_STATE_RELEASE,               // Release debounce.
+    BUTTON_STATE_LOCK,                  // Edge only input lockout.
+    BUTTON_STATE_LAST
+} ButtonState;
+
+typedef enum {
+    BUTTON_ACTION_PRESS,
+    BUTTON_ACTION_RELEASE,
+    BUTTON_ACTION_LONG,
+    BUTTON_ACTION_REPEAT,
+    BUTTON_ACTION_LAST
+} ButtonAction;
+
 //-----------------------------------------------------------------------------
 //Task arguments
 typedef struct {
@@ -30,16 +53,52 @@ typedef struct {
     OS_DriverHd drv_rtc;
     OS_DriverHd drv_button_tamper;
     OS_DriverHd drv_button_wakeup;
-    OS_TimerHd  timer_power;
-    Bool        button_wakeup_state;
+    OS_TimerHd  timer_debounce;
+    Bool        is_debounce;
 } TaskStorage;
 
+typedef struct {
+    ConstStrP   name_p;
+    void        (*action_fp)(TaskStorage* tstor_p, const ButtonAction action, const U32 hold_ms);
+    U32         debounce_ms;
+    U32         long_ms;                // 0 - no long press/repeat.
+    U32         repeat_ms;              // 0 - no repeat.
+    Bool        is_edge_only;           // Press edge only (no release edge).
+} ButtonConfig;
+
+typedef struct {
+    OS_Tick     edge_tick;              // Last raw edge.
+    OS_Tick     trans_tick;             // First edge of the transition (latency base).
+    OS_Tick     press_tick;
+    OS_Tick     long_tick;              // Next long press/repeat.
+    U8          state;                  // #ButtonState
+    Bool        is_level;               // Raw level (edges parity).
+    Bool        is_long;
+} Button;
+
 //-----------------------------------------------------------------------------
-static void     TimerPowerHandler(TaskStorage* tstor_p);
-static void     ButtonTamperHandler(TaskStorage* tstor_p);
+static void     PowerOff(void);
+static void     ButtonEdge(TaskStorage* tstor_p, const U8 idx, const OS_Tick tick);
+static Bool     ButtonPoll(TaskStorage* tstor_p, const U8 idx, const OS_Tick tick);
+static void     ButtonActionDo(TaskStorage* tstor_p, const U8 idx, const ButtonAction action, const OS_Tick tick);
+static void     ButtonTamperAction(TaskStorage* tstor_p, const ButtonAction action, const U32 hold_ms);
+static void     ButtonWakeupAction(TaskStorage* tstor_p, const ButtonAction action, const U32 hold_ms);
 static void     ISR_ButtonTamperHandler(void);
-static void     ButtonWakeupHandler(TaskStorage* tstor_p);
 static void     ISR_ButtonWakeupHandler(void);
+static void     ISR_ButtonEventPut(const U32 drv_id, const U8 event);
+
+//------------------------------------------------------------------------------
+//Indexed by the button event.
+static const ButtonConfig buttons_cfg_v[] = {
+    { "tamper", ButtonTamperAction, APP_BUTTON_TAMPER_LOCK_MS,  0,                  0,                      OS_TRUE  },
+    { "wakeup", ButtonWakeupAction, APP_BUTTON_DEBOUNCE_MS,     APP_BUTTON_LONG_MS, APP_BUTTON_REPEAT_MS,   OS_FALSE },
+};
+static Button buttons_v[BUTTONS_COUNT];
+static AKoButtonStats buttons_stats_v[BUTTONS_COUNT];
+//Buttons events (ISR -> task).
+static SpscRing buttons_ring;
+static U8 buttons_events_v[BUTTON_EVENTS_COUNT];
+static OS_QueueHd buttons_qhd;
 
 //------------------------------------------------------------------------------
 const OS_TaskConfig task_a_ko_cfg = {
@@ -49,8 +108,8 @@ const OS_TaskConfig task_a_ko_cfg = {
     .args_p         = OS_NULL,
     .attrs          = BIT(OS_TASK_ATTR_RECREATE),
     .timeout        = 1,
-    .prio_init      = APP_TASK_PRIO_A_KO,
-    .prio_power     = APP_TASK_PRIO_PWR_A_KO,
+    .prio_init      = APP_PRIO_TASK_A_KO,
+    .prio_power     = APP_PRIO_PWR_TASK_A_KO,
     .storage_size   = sizeof(TaskStorage),
     .stack_size     = OS_STACK_SIZE_MIN,
     .stdin_len      = OS_STDIN_LEN
@@ -62,7 +121,9 @@ Status OS_TaskInit(OS_TaskArgs* args_p)
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
 Status s;
 
-    tstor_p->button_wakeup_state = OS_FALSE;
+    tstor_p->is_debounce = OS_FALSE;
+    OS_MemSet(buttons_v, 0, sizeof(buttons_v));
+    IF_STATUS(s = SpscRingInit(&buttons_ring, buttons_events_v, sizeof(U8), BUTTON_EVENTS_COUNT)) { return s; }
     {
         const OS_DriverConfig drv_cfg = {
             .name       = "BTAMPER",
@@ -99,23 +160,34 @@ U8 debug_count = (rand() % 17) + 1;
         } else {
             if (OS_SignalIs(msg_p)) {
                 switch (OS_SignalIdGet(msg_p)) {
-                    case OS_SIG_DRV:
-                        switch (OS_SignalDataGet(msg_p)) {
-                            case OS_EVENT_TAMPER:
-                                ButtonTamperHandler(tstor_p);
-                                break;
-                            case OS_EVENT_WAKEUP:
-                                ButtonWakeupHandler(tstor_p);
-                                break;
-                            default:
+                    case OS_SIG_DRV: {
+                        //Raw edges: the debounce timer does the rest.
+                        const OS_Tick tick = OS_TickCountGet();
+                        U8 event;
+                        SpscRingNotifyClear(&buttons_ring);
+                        while (OS_TRUE == SpscRingGet(&buttons_ring, &event)) {
+                            if (BUTTONS_COUNT > event) {
+                                ButtonEdge(tstor_p, event, tick);
+                            } else {
                                 OS_LOG_S(D_DEBUG, S_UNDEF_SIG);
-                                break;
+                            }
+                        }
                         }
                         break;
                     case OS_SIG_TIMER: {
-                        const OS_TimerId timer_id = OS_TimerIdGet(tstor_p->timer_power);
+                        const OS_TimerId timer_id = OS_TimerIdGet(tstor_p->timer_debounce);
                         if (timer_id == (OS_TimerId)OS_SignalDataGet(msg_p)) {
-                            TimerPowerHandler(tstor_p);
+                            const OS_Tick tick = OS_TickCountGet();
+                            Bool is_active = OS_FALSE;
+                            for (U8 i = 0; i < BUTTONS_COUNT; ++i) {
+                                is_active |= ButtonPoll(tstor_p, i, tick);
+                            }
+                            //All the buttons are idle: no polling.
+                            if ((OS_TRUE != is_active) && (OS_TRUE == tstor_p->is_debounce)) {
+                                IF_OK(OS_TimerStop(tstor_p->timer_debounce, OS_NO_BLOCK)) {
+                                    tstor_p->is_debounce = OS_FALSE;
+                                }
+                            }
                         }
                         }
                         break;
@@ -153,7 +225,7 @@ U8 debug_count = (rand() % 17) + 1;
                         OS_LOG_S(D_DEBUG, S_UNDEF_MSG);
                         break;
                 }
-                OS_MessageDelete(msg_p); // free message allocated memory
+                MsgPoolDelete(msg_p); // free message allocated memory
             }
         }
 //        if (!--debug_count) {
@@ -179,9 +251,10 @@ Status s = S_OK;
             break;
         case PWR_OFF:
         case PWR_SHUTDOWN: {
-            IF_STATUS(s = OS_TimerDelete(tstor_p->timer_power, OS_TIMEOUT_DEFAULT)) {
+            IF_STATUS(s = OS_TimerDelete(tstor_p->timer_debounce, OS_TIMEOUT_DEFAULT)) {
             }
-            tstor_p->timer_power = OS_NULL;
+            tstor_p->timer_debounce = OS_NULL;
+            tstor_p->is_debounce    = OS_FALSE;
             IF_OK(s = OS_DriverClose(tstor_p->drv_button_tamper, OS_NULL)) {
                 IF_STATUS(s = OS_DriverDeInit(tstor_p->drv_button_tamper, OS_NULL)) {
                 }
@@ -197,17 +270,18 @@ Status s = S_OK;
             }
             break;
         case PWR_ON: {
-            if (OS_NULL == tstor_p->timer_power) {
+            if (OS_NULL == tstor_p->timer_debounce) {
                 tstor_p->stdin_qhd = OS_TaskStdInGet(OS_TaskByNameGet(task_a_ko_cfg.name));
-                static ConstStrP tim_name_p = "PowerOff";
+                buttons_qhd = tstor_p->stdin_qhd;
+                static ConstStrP tim_name_p = "Debounce";
                 const OS_TimerConfig tim_cfg = {
                     .name_p = tim_name_p,
                     .slot   = tstor_p->stdin_qhd,
-                    .id     = 16,
-                    .period = 4000,
-                    .options= 0
+                    .id     = TIMER_DEBOUNCE_ID,
+                    .period = APP_BUTTON_POLL_PERIOD,
+                    .options= (OS_TimerOptions)BIT(OS_TIM_OPT_PERIODIC)
                 };
-                IF_STATUS(s = OS_TimerCreate(&tim_cfg, &tstor_p->timer_power)) {
+                IF_STATUS(s = OS_TimerCreate(&tim_cfg, &tstor_p->timer_debounce)) {
                     return s;
                 }
             }
@@ -232,21 +306,144 @@ Status s = S_OK;
 }
 
 /******************************************************************************/
-void TimerPowerHandler(TaskStorage* tstor_p)
+void PowerOff(void)
 {
 const OS_Signal signal = OS_SignalCreate(OS_SIG_SHUTDOWN, 0);
     OS_SignalSend(OS_TaskSvStdInGet(), signal, OS_MSG_PRIO_HIGH);
 }
 
 /******************************************************************************/
-void ButtonTamperHandler(TaskStorage* tstor_p)
+void ButtonEdge(TaskStorage* tstor_p, const U8 idx, const OS_Tick tick)
+{
+const ButtonConfig* cfg_p = &buttons_cfg_v[idx];
+Button* button_p = &buttons_v[idx];
+
+    button_p->edge_tick = tick;
+    button_p->is_level ^= OS_TRUE;
+    switch (button_p->state) {
+        case BUTTON_STATE_IDLE:
+            //Any edge of the idle button is a press (resync of a lost edge).
+            button_p->is_level  = OS_TRUE;
+            button_p->trans_tick= tick;
+            button_p->press_tick= tick;
+            if (OS_TRUE == cfg_p->is_edge_only) {
+                //No release edge: act at once and ignore the rest of the burst.
+                button_p->state = BUTTON_STATE_LOCK;
+                ButtonActionDo(tstor_p, idx, BUTTON_ACTION_PRESS, tick);
+            } else {
+                button_p->state = BUTTON_STATE_PRESS;
+            }
+            break;
+        case BUTTON_STATE_HELD:
+            button_p->is_level  = OS_FALSE;
+            button_p->trans_tick= tick;
+            button_p->state     = BUTTON_STATE_RELEASE;
+            break;
+        default:
+            //Edge within the debounce window restarts it.
+            ++buttons_stats_v[idx].bounces;
+            break;
+    }
+    if (OS_TRUE != tstor_p->is_debounce) {
+        IF_OK(OS_TimerStart(tstor_p->timer_debounce, OS_NO_BLOCK)) {
+            tstor_p->is_debounce = OS_TRUE;
+        } else { OS_LOG_S(D_WARNING, S_INVALID_STATE); }
+    }
+}
+
+/******************************************************************************/
+Bool ButtonPoll(TaskStorage* tstor_p, const U8 idx, const OS_Tick tick)
 {
-    OS_LOG(D_WARNING, "Tamper event detected!");
-    IF_STATUS(OS_DriverIoCtl(tstor_p->drv_rtc, DRV_REQ_BUTTON_TAMPER_DISABLE, OS_NULL)) { OS_ASSERT(OS_FALSE); }
-    //Wait for jitter to calm.
-    OS_TaskDelay(100);
-    //Remove jitter signals from the queue.
-    OS_QueueClear(tstor_p->stdin_qhd);
+const ButtonConfig* cfg_p = &buttons_cfg_v[idx];
+Button* button_p = &buttons_v[idx];
+const Bool is_stable = (OS_TICKS_TO_MS(tick - button_p->edge_tick) >= cfg_p->debounce_ms);
+
+    switch (button_p->state) {
+        case BUTTON_STATE_PRESS:
+            if (OS_TRUE == is_stable) {
+                if (OS_TRUE == button_p->is_level) {
+                    button_p->state     = BUTTON_STATE_HELD;
+                    button_p->is_long   = OS_FALSE;
+                    button_p->long_tick = button_p->press_tick + OS_MS_TO_TICKS(cfg_p->long_ms);
+                    ButtonActionDo(tstor_p, idx, BUTTON_ACTION_PRESS, tick);
+                } else {
+                    //Glitch.
+                    button_p->state = BUTTON_STATE_IDLE;
+                }
+            }
+            break;
+        case BUTTON_STATE_HELD:
+            //Nothing to time till the release edge (it restarts the timer).
+            if ((0 == cfg_p->long_ms) || ((OS_TRUE == button_p->is_long) && (0 == cfg_p->repeat_ms))) {
+                return OS_FALSE;
+            }
+            if ((S32)(tick - button_p->long_tick) >= 0) {
+                if (OS_TRUE != button_p->is_long) {
+                    button_p->is_long = OS_TRUE;
+                    ButtonActionDo(tstor_p, idx, BUTTON_ACTION_LONG, tick);
+                } else {
+                    ButtonActionDo(tstor_p, idx, BUTTON_ACTION_REPEAT, tick);
+                }
+                button_p->long_tick += OS_MS_TO_TICKS(cfg_p->repeat_ms);
+            }
+            break;
+        case BUTTON_STATE_RELEASE:
+            if (OS_TRUE == is_stable) {
+                if (OS_TRUE != button_p->is_level) {
+                    button_p->state = BUTTON_STATE_IDLE;
+                    ButtonActionDo(tstor_p, idx, BUTTON_ACTION_RELEASE, tick);
+                } else {
+                    //Bounced back.
+                    button_p->state = BUTTON_STATE_HELD;
+                }
+            }
+            break;
+        case BUTTON_STATE_LOCK:
+            if (OS_TRUE == is_stable) {
+                button_p->state = BUTTON_STATE_IDLE;
+                ButtonActionDo(tstor_p, idx, BUTTON_ACTION_RELEASE, tick);
+            }
+            break;
+        default:
+            break;
+    }
+    return (BUTTON_STATE_IDLE != button_p->state);
+}
+
+/******************************************************************************/
+void ButtonActionDo(TaskStorage* tstor_p, const U8 idx, const ButtonAction action, const OS_Tick tick)
+{
+AKoButtonStats* stats_p = &buttons_stats_v[idx];
+    buttons_cfg_v[idx].action_fp(tstor_p, action, OS_TICKS_TO_MS(tick - buttons_v[idx].press_tick));
+    switch (action) {
+        case BUTTON_ACTION_PRESS:
+        case BUTTON_ACTION_RELEASE:
+            //Input (first edge) to the action done.
+            stats_p->latency_last_ms = OS_TICKS_TO_MS(OS_TickCountGet() - buttons_v[idx].trans_tick);
+            if (stats_p->latency_max_ms < stats_p->latency_last_ms) {
+                stats_p->latency_max_ms = stats_p->latency_last_ms;
+            }
+            if (BUTTON_ACTION_PRESS == action) { ++stats_p->presses; }
+            break;
+        case BUTTON_ACTION_LONG:
+            ++stats_p->longs;
+            break;
+        case BUTTON_ACTION_REPEAT:
+            ++stats_p->repeats;
+            break;
+        default:
+            break;
+    }
+}
+
+/******************************************************************************/
+void ButtonTamperAction(TaskStorage* tstor_p, const ButtonAction action, const U32 hold_ms)
+{
+    (void)hold_ms;
+    if (BUTTON_ACTION_PRESS == action) {
+        OS_LOG(D_WARNING, "Tamper event detected!");
+        //Jitter is ignored till the lockout end.
+        IF_STATUS(OS_DriverIoCtl(tstor_p->drv_rtc, DRV_REQ_BUTTON_TAMPER_DISABLE, OS_NULL)) { OS_ASSERT(OS_FALSE); }
 //#ifndef NDEBUG
 //U32 size = 0x1000;
 //U8* data_p = OS_MallocEx(size, OS_MEM_RAM_INT_CCM);
@@ -261,55 +458,82 @@ void ButtonTamperHandler(TaskStorage* tstor_p)
 //    }
 //    OS_FreeEx(data_p, OS_MEM_RAM_INT_CCM);
 //#endif // NDEBUG
-    IF_STATUS(OS_DriverIoCtl(tstor_p->drv_rtc, DRV_REQ_BUTTON_TAMPER_ENABLE, OS_NULL)) { OS_ASSERT(OS_FALSE); }
+    } else if (BUTTON_ACTION_RELEASE == action) {
+        IF_STATUS(OS_DriverIoCtl(tstor_p->drv_rtc, DRV_REQ_BUTTON_TAMPER_ENABLE, OS_NULL)) { OS_ASSERT(OS_FALSE); }
+    }
 }
 
 /******************************************************************************/
 void ISR_ButtonTamperHandler(void)
 {
-//    if (1 == OS_ISR_SignalSend(task_args.stdin_qhd,
-//                               OS_SignalCreate(OS_SIG_DRV, OS_EVENT_TAMPER),
-//                               OS_MSG_PRIO_HIGH)) {
-//        OS_ContextSwitchForce();
-//    }
+    ISR_ButtonEventPut(DRV_ID_BUTTON_TAMPER, OS_EVENT_TAMPER);
 }
 
 /******************************************************************************/
-void ButtonWakeupHandler(TaskStorage* tstor_p)
+void ButtonWakeupAction(TaskStorage* tstor_p, const ButtonAction action, const U32 hold_ms)
 {
-    tstor_p->button_wakeup_state ^= OS_TRUE;
-    if (OS_TRUE == tstor_p->button_wakeup_state) {
-        OS_LOG(D_INFO, "Wakeup button pressed");
-    } else {
-        OS_LOG(D_INFO, "Wakeup button released");
+static OS_PowerState state_prev = PWR_UNDEF;
+static Bool is_power_off;
+    (void)tstor_p;
+    switch (action) {
+        case BUTTON_ACTION_PRESS:
+            OS_LOG(D_INFO, "Wakeup button pressed");
+            is_power_off = OS_FALSE;
+            break;
+        case BUTTON_ACTION_LONG:
+            OS_LOG(D_INFO, "Hold to power off...");
+            break;
+        case BUTTON_ACTION_REPEAT:
+            if ((APP_BUTTON_POWER_OFF_MS <= hold_ms) && (OS_TRUE != is_power_off)) {
+                is_power_off = OS_TRUE;
+                PowerOff();
+            }
+            break;
+        case BUTTON_ACTION_RELEASE:
+            OS_LOG(D_INFO, "Wakeup button released");
+            //Short press toggles the stop mode; the long one is cancelled.
+            if (APP_BUTTON_LONG_MS > hold_ms) {
+                const OS_PowerState state = OS_PowerStateGet();
+                if (PWR_STOP != state) {
+                    OS_PowerStateSet(PWR_STOP);
+                } else {
+                    OS_PowerStateSet(state_prev);
+                }
+                state_prev = state;
+            }
+            break;
+        default:
+            break;
     }
-    OS_TimerStart(tstor_p->timer_power, 4000);
-    //Wait for debounce.
-    OS_TaskDelay(10);
-    //Remove jitter signals from the queue.
-    OS_QueueClear(tstor_p->stdin_qhd);
-    // Is button released?
-    if (OS_FALSE == tstor_p->button_wakeup_state) {
-        static OS_PowerState state_prev = PWR_UNDEF;
-        const OS_PowerState state = OS_PowerStateGet();
-        IF_STATUS(OS_TimerStop(tstor_p->timer_power, OS_TIMEOUT_DEFAULT)) {
-            return;
-        }
-        if (PWR_STOP != state) {
-            OS_PowerStateSet(PWR_STOP);
-        } else {
-            OS_PowerStateSet(state_prev);
+}
+
+/******************************************************************************/
+void ISR_ButtonWakeupHandler(void)
+{
+    ISR_ButtonEventPut(DRV_ID_BUTTON_WAKEUP, OS_EVENT_WAKEUP);
+}
+
+/******************************************************************************/
+void ISR_ButtonEventPut(const U32 drv_id, const U8 event)
+{
+    //Jitter bursts are queued with a single wakeup (overflow is counted).
+    if ((OS_NULL != buttons_qhd) && (OS_TRUE == SpscRingPut(&buttons_ring, &event))) {
+        const Int res = OS_ISR_SignalSend(buttons_qhd, OS_ISR_SignalCreate(drv_id, OS_SIG_DRV, 0), OS_MSG_PRIO_HIGH);
+        if (0 > res) {
+            //Full queue: the next event retries the wakeup.
+            SpscRingNotifyCancel(&buttons_ring);
+        } else if (1 == res) {
+            OS_ContextSwitchForce();
         }
-        state_prev = state;
     }
 }
 
 /******************************************************************************/
-void ISR_ButtonWakeupHandler(void)
+Status AKoButtonStatsGet(const Size idx, ConstStrP* name_pp, AKoButtonStats* stats_p)
 {
-//    if (1 == OS_ISR_SignalSend(task_args.stdin_qhd,
-//                               OS_ISR_SignalCreate(DRV_ID_BUTTON_WAKEUP, OS_SIG_DRV, OS_EVENT_WAKEUP),
-//                               OS_MSG_PRIO_HIGH)) {
-//        OS_ContextSwitchForce();
-//    }
+    if ((OS_NULL == name_pp) || (OS_NULL == stats_p)) { return S_INVALID_PTR; }
+    if (BUTTONS_COUNT <= idx) { return S_INVALID_VALUE; }
+    *name_pp = buttons_cfg_v[idx].name_p;
+    *stats_p = buttons_stats_v[idx];
+    return S_OK;
 }
@@ -6,4 +6,24 @@
 #ifndef _TASK_A_KO_H_
 #define _TASK_A_KO_H_
 
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+typedef struct {
+    U32             presses;
+    U32             longs;
+    U32             repeats;
+    U32             bounces;            // Edges within the debounce windows.
+    U32             latency_last_ms;    // First edge to the press/release action done.
+    U32             latency_max_ms;
+} AKoButtonStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Get button statistics.
+/// @param[in]  idx            Button index.
+/// @param[out] name_pp        Button name.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          AKoButtonStatsGet(const Size idx, ConstStrP* name_pp, AKoButtonStats* stats_p);
+
 #endif // _TASK_A_KO_H_
\ No newline at end of file
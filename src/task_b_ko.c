@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "drv_usb.h"
+#include "os_supervise.h"
 #include "os_timer.h"
 #include "os_trigger.h"
 #include "os_driver.h"
@@ -14,20 +15,31 @@
 #include "os_settings.h"
 #include "os_environment.h"
 #include "app_common.h"
+#include "msg_pool.h"
+#include "led_pattern.h"
+#include "settings_store.h"
 #include "task_b_ko.h"
 
 //-----------------------------------------------------------------------------
 //Task arguments
 typedef struct {
     OS_DriverHd     drv_led_user;
+    OS_DriverHd     drv_usb_hid_mouse;
     OS_TriggerHd    trigger_hd;
     OS_QueueHd      a_ko_qhd;
     OS_TimeMs       blink_rate;
+    LedPatternPlayer led_player;
+    LedPattern      led_blink;          // Settings blink rate pattern.
+    LedStep         led_blink_steps_v[2];
+    OS_Tick         led_edge_tick;      // Current step start.
+    U32             led_edge_ms;        // Time to the next edge (0 - none).
+    OS_Tick         hid_delivery_tick;
+    Bool            is_hid_scheduled;   // Pending motion waits for the delivery tick.
 } TaskStorage;
 
 //------------------------------------------------------------------------------
 const OS_TaskConfig task_b_ko_cfg = {
-    .name           = "B-ko",
+    .name           = APP_TASK_NAME_B_KO,
     .func_main      = OS_TaskMain,
     .func_power     = OS_TaskPower,
     .args_p         = OS_NULL,
@@ -42,6 +54,21 @@ const OS_TaskConfig task_b_ko_cfg = {
 
 //------------------------------------------------------------------------------
 static Status       EventCreate(OS_QueueHd a_ko_qhd, OS_TriggerHd* trigger_hd_p);
+static void         LedPatternSet(TaskStorage* tstor_p, const LedPattern* pattern_p);
+static void         LedWrite(TaskStorage* tstor_p);
+static void         LedBlinkRateApply(TaskStorage* tstor_p);
+static void         MouseWakeup(TaskStorage* tstor_p, const U8 device);
+static Status       MouseReportPut(const U8 device, const OS_UsbHidMouseData* report_p, const Bool is_isr);
+static void         ISR_MouseReportHandler(const U8 device, const OS_UsbHidMouseData* report_p);
+static void         MouseDeliver(TaskStorage* tstor_p);
+
+//------------------------------------------------------------------------------
+static BKoLedStats led_stats;
+static UsbHidStats hid_stats;
+static Bool is_hid_coalesce = OS_TRUE;
+//Mice reports (driver -> task).
+static UsbHidMousePending hid_mice_v[APP_USB_HID_MICE_MAX];
+static OS_QueueHd hid_qhd;
 
 /******************************************************************************/
 Status OS_TaskInit(OS_TaskArgs* args_p)
@@ -49,6 +76,11 @@ Status OS_TaskInit(OS_TaskArgs* args_p)
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
 Status s;
     tstor_p->blink_rate = OS_BLOCK;
+    for (Size i = 0; i < ITEMS_COUNT_GET(hid_mice_v, UsbHidMousePending); ++i) {
+        UsbHidMousePendingInit(&hid_mice_v[i], 0);
+    }
+    tstor_p->is_hid_scheduled = OS_FALSE;
+    hid_qhd = OS_TaskStdInGet(OS_THIS_TASK);
     {
         const OS_DriverConfig drv_cfg = {
             .name       = "LED_USR",
@@ -57,6 +89,14 @@ Status s;
         };
         IF_STATUS(s = OS_DriverCreate(&drv_cfg, (OS_DriverHd*)&tstor_p->drv_led_user)) { return s; }
     }
+    {
+        const OS_DriverConfig drv_cfg = {
+            .name       = "USB_HID",
+            .itf_p      = drv_usb_hid_v[DRV_ID_USB_HID_MOUSE],
+            .prio_power = OS_PWR_PRIO_DEFAULT
+        };
+        IF_STATUS(s = OS_DriverCreate(&drv_cfg, (OS_DriverHd*)&tstor_p->drv_usb_hid_mouse)) { return s; }
+    }
     return s;
 }
 
@@ -64,7 +104,6 @@ Status s;
 void OS_TaskMain(OS_TaskArgs* args_p)
 {
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
-State led_state = OFF;
 const OS_QueueHd stdin_qhd = OS_TaskStdInGet(OS_THIS_TASK);
 OS_Message* msg_p;// = OS_MessageCreate(OS_MSG_APP, sizeof(task_args), OS_BLOCK, &task_args);
 int debug = 0;
@@ -74,9 +113,21 @@ const OS_Signal signal = OS_SignalCreate(OS_SIG_APP, 0);
 //    OS_MessageSend(a_ko_qhd, msg_p, 100, OS_MSG_PRIO_NORMAL);
 
 U8 debug_count = (rand() % 6) + 1;
-tstor_p->blink_rate = 1;
+    LedBlinkRateApply(tstor_p);
 	for(;;) {
-        IF_STATUS(OS_MessageReceive(stdin_qhd, &msg_p, tstor_p->blink_rate)) {
+        //Sleep till the next pattern edge only.
+        OS_TimeMs timeout = OS_BLOCK;
+        if (0 != tstor_p->led_edge_ms) {
+            const S32 remain = (S32)(tstor_p->led_edge_tick + OS_MS_TO_TICKS(tstor_p->led_edge_ms) - OS_TickCountGet());
+            timeout = (0 < remain) ? OS_TICKS_TO_MS(remain) : OS_NO_BLOCK;
+        }
+        if (OS_TRUE == tstor_p->is_hid_scheduled) {
+            const S32 remain = (S32)(tstor_p->hid_delivery_tick - OS_TickCountGet());
+            const OS_TimeMs hid_timeout = (0 < remain) ? OS_TICKS_TO_MS(remain) : OS_NO_BLOCK;
+            timeout = (hid_timeout < timeout) ? hid_timeout : timeout;
+        }
+        ++led_stats.wakeups;
+        IF_STATUS(OS_MessageReceive(stdin_qhd, &msg_p, timeout)) {
             //OS_LOG_S(D_WARNING, S_UNDEF_MSG);
         } else {
             if (OS_SignalIs(msg_p)) {
@@ -84,20 +135,41 @@ tstor_p->blink_rate = 1;
                     case OS_SIG_APP:
                         debug = OS_SignalDataGet(msg_p);
                         break;
+                    case OS_SIG_B_KO_SETTINGS: {
+                        //Memory lookup only.
+                        Str value[APP_SETTINGS_STORE_VALUE_LEN];
+                        IF_OK(SettingsStoreGet("Second", "blink_rate", value, sizeof(value))) {
+                            const OS_TimeMs blink_rate = OS_StrToUL((const char*)&value[0], OS_NULL, 10);
+                            if (blink_rate != tstor_p->blink_rate) {
+                                tstor_p->blink_rate = blink_rate;
+                                LedBlinkRateApply(tstor_p);
+                            }
+                        }
+                        }
+                        break;
+                    case OS_SIG_B_KO_LED_PATTERN: {
+                        const LedPattern* pattern_p = LedPatternGet((LedPatternId)OS_SignalDataGet(msg_p));
+                        if (OS_NULL != pattern_p) {
+                            LedPatternSet(tstor_p, pattern_p);
+                        } else { OS_LOG_S(D_WARNING, S_INVALID_VALUE); }
+                        }
+                        break;
+                    case OS_SIG_B_KO_HID_MOUSE:
+                        MouseWakeup(tstor_p, (U8)OS_SignalDataGet(msg_p));
+                        break;
+                    case OS_SIG_B_KO_HID_COALESCE:
+                        is_hid_coalesce = (Bool)OS_SignalDataGet(msg_p);
+                        if (OS_TRUE != is_hid_coalesce) { MouseDeliver(tstor_p); }
+                        break;
                     default:
                         OS_LOG_S(D_DEBUG, S_INVALID_SIGNAL);
                         break;
                 }
             } else {
                 switch (msg_p->id) {
-                    case OS_MSG_USB_HID_MOUSE: {
-                        const OS_UsbHidMouseData* mouse_p = (OS_UsbHidMouseData*)&(msg_p->data);
-                        const U8 l = BIT_TEST(mouse_p->buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_LEFT));
-                        const U8 r = BIT_TEST(mouse_p->buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_RIGHT));
-                        const U8 m = BIT_TEST(mouse_p->buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_MIDDLE));
-                        OS_LOG(D_DEBUG, "X:%d, Y:%d, L:%d, M:%d, R:%d",
-                                        mouse_p->x, mouse_p->y, l, m, r);
-                        }
+                    case OS_MSG_USB_HID_MOUSE:
+                        //Driver with no report handler (first mouse): coalesced as well.
+                        BKoMouseReportPut(0, (OS_UsbHidMouseData*)&(msg_p->data));
                         break;
 //                    case OS_MSG_APP:
 //                        debug = 2;
@@ -106,11 +178,20 @@ tstor_p->blink_rate = 1;
                         OS_LOG_S(D_DEBUG, S_INVALID_MESSAGE);
                         break;
                 }
-                OS_MessageDelete(msg_p); // free message allocated memory
+                MsgPoolDelete(msg_p); // free message allocated memory
             }
         }
-        led_state = (ON == led_state) ? OFF : ON;
-        OS_DriverWrite(tstor_p->drv_led_user, (void*)&led_state, 1, OS_NULL);
+        if ((0 != tstor_p->led_edge_ms) &&
+            ((S32)(OS_TickCountGet() - (tstor_p->led_edge_tick + OS_MS_TO_TICKS(tstor_p->led_edge_ms))) >= 0)) {
+            //Next step starts at the edge time (no drift).
+            tstor_p->led_edge_tick += OS_MS_TO_TICKS(tstor_p->led_edge_ms);
+            tstor_p->led_edge_ms    = LedPatternStep(&tstor_p->led_player);
+            LedWrite(tstor_p);
+        }
+        if ((OS_TRUE == tstor_p->is_hid_scheduled) &&
+            ((S32)(OS_TickCountGet() - tstor_p->hid_delivery_tick) >= 0)) {
+            MouseDeliver(tstor_p);
+        }
 //        if (!--debug_count) {
 //            while(1) {};
 //        }
@@ -139,6 +220,13 @@ Status s = S_OK;
             } else {
                 s = (S_INITED == s) ? S_OK : s;
             }
+            //Mouse reports are coalesced in the driver ISR: the queue gets a wakeup only.
+            IF_OK(s = OS_DriverInit(tstor_p->drv_usb_hid_mouse, OS_NULL)) {
+                IF_STATUS(s = OS_DriverOpen(tstor_p->drv_usb_hid_mouse, (void*)ISR_MouseReportHandler)) {
+                }
+            } else {
+                s = (S_INITED == s) ? S_OK : s;
+            }
             break;
         case PWR_OFF:
         case PWR_STOP:
@@ -155,10 +243,13 @@ Status s = S_OK;
             }
             break;
         case PWR_ON: {
-            ConstStrP config_path_p = OS_EnvVariableGet("config_file");
-            Str value[OS_SETTINGS_VALUE_LEN];
-            OS_SettingsRead(config_path_p, "Second", "blink_rate", &value[0]);
-            tstor_p->blink_rate = OS_StrToUL((const char*)&value[0], OS_NULL, 10);
+            //The blink rate is read on the settings (load) notification.
+            const OS_QueueHd stdin_qhd = OS_TaskStdInGet(OS_TaskByNameGet(APP_TASK_NAME_B_KO));
+            IF_STATUS(s = SettingsStoreSubscribe(stdin_qhd, OS_SIG_B_KO_SETTINGS)) {
+            } else {
+                const OS_Signal signal = OS_SignalCreate(OS_SIG_B_KO_SETTINGS, SETTINGS_STORE_IDX_ALL);
+                s = OS_SignalSend(stdin_qhd, signal, OS_MSG_PRIO_NORMAL);
+            }
 
 //                    OS_SettingsRead(config_path_p, "First", "Val", &value[0]);
 //                    OS_SettingsDelete(config_path_p, "Second", OS_NULL);
@@ -221,4 +312,179 @@ Status s;
         OS_LOG_S(D_WARNING, s);
     }
     return s;
-}
\ No newline at end of file
+}
+
+/******************************************************************************/
+void LedPatternSet(TaskStorage* tstor_p, const LedPattern* pattern_p)
+{
+    tstor_p->led_edge_tick  = OS_TickCountGet();
+    tstor_p->led_edge_ms    = LedPatternStart(&tstor_p->led_player, pattern_p);
+    led_stats.pattern_name_p= pattern_p->name_p;
+    LedWrite(tstor_p);
+}
+
+/******************************************************************************/
+void LedBlinkRateApply(TaskStorage* tstor_p)
+{
+    //Settings blink rate (half period) or the idle heartbeat.
+    if ((0 != tstor_p->blink_rate) && (OS_BLOCK != tstor_p->blink_rate) && (0x7FFF >= tstor_p->blink_rate)) {
+        tstor_p->led_blink_steps_v[0]   = LED_STEP_ON(tstor_p->blink_rate);
+        tstor_p->led_blink_steps_v[1]   = LED_STEP_OFF(tstor_p->blink_rate);
+        tstor_p->led_blink.name_p       = "rate";
+        tstor_p->led_blink.steps_p      = tstor_p->led_blink_steps_v;
+        tstor_p->led_blink.steps_count  = ITEMS_COUNT_GET(tstor_p->led_blink_steps_v, LedStep);
+        LedPatternSet(tstor_p, &tstor_p->led_blink);
+    } else {
+        LedPatternSet(tstor_p, LedPatternGet(LED_PATTERN_HEARTBEAT));
+    }
+}
+
+/******************************************************************************/
+void LedWrite(TaskStorage* tstor_p)
+{
+    OS_DriverWrite(tstor_p->drv_led_user, (void*)&tstor_p->led_player.level, 1, OS_NULL);
+    ++led_stats.edges;
+}
+
+/******************************************************************************/
+Status BKoMouseReportPut(const U8 device, const OS_UsbHidMouseData* report_p)
+{
+    return MouseReportPut(device, report_p, OS_FALSE);
+}
+
+/******************************************************************************/
+void ISR_MouseReportHandler(const U8 device, const OS_UsbHidMouseData* report_p)
+{
+    MouseReportPut(device, report_p, OS_TRUE);
+}
+
+/******************************************************************************/
+Status MouseReportPut(const U8 device, const OS_UsbHidMouseData* report_p, const Bool is_isr)
+{
+UsbHidMousePending* pending_p;
+U32 primask;
+Bool is_wakeup;
+Status s = S_OK;
+
+    if (OS_NULL == report_p) { return S_INVALID_PTR; }
+    if (APP_USB_HID_MICE_MAX <= device) { return S_INVALID_VALUE; }
+    if (OS_NULL == hid_qhd) { return S_INVALID_STATE; }
+    pending_p = &hid_mice_v[device];
+    APP_CRITICAL_SECTION_ENTER(primask);
+    if (pending_p->buttons_bm != report_p->buttons_bm) { ++hid_stats.edges; }
+    is_wakeup = UsbHidMousePendingPut(pending_p, report_p);
+    ++hid_stats.reports;
+    hid_stats.overflows = pending_p->overflows;
+    if (pending_p->count > hid_stats.states_max) { hid_stats.states_max = pending_p->count; }
+    APP_CRITICAL_SECTION_EXIT(primask);
+    //Motion bursts are merged with a single wakeup.
+    if (OS_TRUE == is_wakeup) {
+        if (OS_TRUE == is_isr) {
+            const OS_Signal signal = OS_ISR_SignalCreate(DRV_ID_USB_HID_MOUSE, OS_SIG_B_KO_HID_MOUSE, device);
+            const Int res = OS_ISR_SignalSend(hid_qhd, signal, OS_MSG_PRIO_NORMAL);
+            if (0 > res) {
+                s = S_OVERFLOW;
+            } else if (1 == res) {
+                OS_ContextSwitchForce();
+            }
+        } else {
+            s = OS_SignalSend(hid_qhd, OS_SignalCreate(OS_SIG_B_KO_HID_MOUSE, device), OS_MSG_PRIO_NORMAL);
+        }
+        IF_STATUS(s) {
+            //Full queue: the next report retries the wakeup.
+            APP_CRITICAL_SECTION_ENTER(primask);
+            UsbHidMousePendingNotifyCancel(pending_p);
+            APP_CRITICAL_SECTION_EXIT(primask);
+        } else {
+            APP_CRITICAL_SECTION_ENTER(primask);
+            ++hid_stats.wakeups;
+            APP_CRITICAL_SECTION_EXIT(primask);
+        }
+    }
+    return s;
+}
+
+/******************************************************************************/
+void MouseWakeup(TaskStorage* tstor_p, const U8 device)
+{
+U32 primask;
+Bool is_edge;
+
+    if (APP_USB_HID_MICE_MAX <= device) { return; }
+    APP_CRITICAL_SECTION_ENTER(primask);
+    is_edge = UsbHidMousePendingIsEdge(&hid_mice_v[device]);
+    APP_CRITICAL_SECTION_EXIT(primask);
+    //Button transitions are not delayed; motion waits for the delivery tick.
+    if ((OS_TRUE != is_hid_coalesce) || (OS_TRUE == is_edge)) {
+        MouseDeliver(tstor_p);
+    } else if (OS_TRUE != tstor_p->is_hid_scheduled) {
+        tstor_p->hid_delivery_tick  = OS_TickCountGet() + OS_MS_TO_TICKS(APP_USB_HID_DELIVERY_MS);
+        tstor_p->is_hid_scheduled   = OS_TRUE;
+    }
+}
+
+/******************************************************************************/
+void MouseDeliver(TaskStorage* tstor_p)
+{
+const OS_Tick tick_start = OS_TickCountGet();
+OS_UsbHidMouseData mouse;
+U32 primask;
+Bool is_pending = OS_FALSE;
+
+    for (Size i = 0; i < ITEMS_COUNT_GET(hid_mice_v, UsbHidMousePending); ++i) {
+        for (;;) {
+            APP_CRITICAL_SECTION_ENTER(primask);
+            const Bool is_taken = UsbHidMousePendingTake(&hid_mice_v[i], &mouse);
+            //Saturated motion rest is the last state.
+            const Bool is_rest  = (OS_TRUE == is_taken) && (1 == hid_mice_v[i].count) &&
+                                  (OS_TRUE != UsbHidMousePendingIsEdge(&hid_mice_v[i]));
+            APP_CRITICAL_SECTION_EXIT(primask);
+            if (OS_TRUE != is_taken) { break; }
+            const U8 l = BIT_TEST(mouse.buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_LEFT));
+            const U8 r = BIT_TEST(mouse.buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_RIGHT));
+            const U8 m = BIT_TEST(mouse.buttons_bm, BIT(OS_USB_HID_MOUSE_BUTTON_MIDDLE));
+            OS_LOG(D_DEBUG, "X:%d, Y:%d, L:%d, M:%d, R:%d", mouse.x, mouse.y, l, m, r);
+            ++hid_stats.deliveries;
+            if (OS_TRUE == is_rest) {
+                is_pending = OS_TRUE;
+                break;
+            }
+        }
+    }
+    //Saturated motion rest waits for the next tick.
+    tstor_p->is_hid_scheduled = is_pending;
+    if (OS_TRUE == tstor_p->is_hid_scheduled) {
+        tstor_p->hid_delivery_tick = OS_TickCountGet() + OS_MS_TO_TICKS(APP_USB_HID_DELIVERY_MS);
+    }
+    hid_stats.busy_ms += OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+}
+
+/******************************************************************************/
+Status BKoLedStatsGet(BKoLedStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = led_stats;
+    return S_OK;
+}
+
+/******************************************************************************/
+void BKoLedStatsReset(void)
+{
+    led_stats.wakeups   = 0;
+    led_stats.edges     = 0;
+    led_stats.tick_reset= OS_TickCountGet();
+}
+
+/******************************************************************************/
+Status BKoHidStatsGet(UsbHidStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = hid_stats;
+    return S_OK;
+}
+
+/******************************************************************************/
+void BKoHidStatsReset(void)
+{
+    OS_MemSet(&hid_stats, 0, sizeof(hid_stats));
+}
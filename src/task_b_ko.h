@@ -6,4 +6,52 @@
 #ifndef _TASK_B_KO_H_
 #define _TASK_B_KO_H_
 
+#include "os_common.h"
+#include "usb_hid_coalesce.h"
+
+//-----------------------------------------------------------------------------
+#define APP_TASK_NAME_B_KO      "B-ko"
+
+enum {
+    OS_SIG_B_KO_UNDEF = OS_SIG_APP,
+    OS_SIG_B_KO_LED_PATTERN,            // data: #LedPatternId
+    OS_SIG_B_KO_SETTINGS,               // Settings are changed (data: item index).
+    OS_SIG_B_KO_HID_COALESCE,           // data: USB HID input coalescing on/off.
+    OS_SIG_B_KO_HID_MOUSE,              // Mouse reports are pending (data: device).
+    OS_SIG_B_KO_LAST
+};
+
+typedef struct {
+    ConstStrP       pattern_name_p;
+    U32             wakeups;            // Task wakeups.
+    U32             edges;              // LED writes.
+    OS_Tick         tick_reset;         // Counters reset time.
+} BKoLedStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Get LED statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          BKoLedStatsGet(BKoLedStats* stats_p);
+
+/// @brief      Reset LED statistics counters.
+void            BKoLedStatsReset(void);
+
+/// @brief      Put the USB HID mouse report (task context).
+/// @param[in]  device         Mouse index (< APP_USB_HID_MICE_MAX).
+/// @param[in]  report_p       Report.
+/// @return     #Status.
+/// @details    The report is merged into the device pending state; the task
+///             is signalled only when the state becomes pending. The USB HID
+///             driver reports take the same path from its ISR handler.
+Status          BKoMouseReportPut(const U8 device, const OS_UsbHidMouseData* report_p);
+
+/// @brief      Get USB HID input statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          BKoHidStatsGet(UsbHidStats* stats_p);
+
+/// @brief      Reset USB HID input statistics.
+void            BKoHidStatsReset(void);
+
 #endif // _TASK_B_KO_H_
\ No newline at end of file
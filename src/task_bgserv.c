@@ -0,0 +1,199 @@
+/***************************************************************************//**
+* @file    task_bgserv.c
+* @brief   Background services task.
+* @author  A. Filyanov
+* @details Low priority housekeeping. The work is done in small steps while
+*          the player is idle (not playing), so the storage bandwidth and the
+*          CPU are left to the playback. The media conversion runs beside
+*          the playback: at the lowest priority it takes the idle CPU only.
+*******************************************************************************/
+#include "os_time.h"
+#include "app_common.h"
+#include "msg_pool.h"
+#include "media_index.h"
+#include "image_verify.h"
+#include "media_convert.h"
+#include "settings_store.h"
+#include "dlog.h"
+#include "boot_timeline.h"
+#include "task_mmplay.h"
+#include "task_bgserv.h"
+
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "task_bgserv"
+
+//-----------------------------------------------------------------------------
+//Task arguments
+typedef struct {
+    OS_TimeMs       sweep_next_ms;
+    Bool            is_work;
+    Bool            is_convert;         // Conversion step is ready.
+} TaskStorage;
+
+//------------------------------------------------------------------------------
+static Bool     IsPlayerIdle(void);
+
+//------------------------------------------------------------------------------
+const OS_TaskConfig task_bgserv_cfg = {
+    .name           = APP_TASK_NAME_BGSERV,
+    .func_main      = OS_TaskMain,
+    .func_power     = OS_TaskPower,
+    .args_p         = OS_NULL,
+    .attrs          = 0,
+    .timeout        = 1,
+    .prio_init      = APP_PRIO_TASK_BGSERV,
+    .prio_power     = APP_PRIO_PWR_TASK_BGSERV,
+    .storage_size   = sizeof(TaskStorage),
+    .stack_size     = OS_STACK_SIZE_MIN * 2,
+    .stdin_len      = OS_STDIN_LEN
+};
+
+/******************************************************************************/
+Status OS_TaskInit(OS_TaskArgs* args_p)
+{
+TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
+Status s = S_UNDEF;
+    OS_LOG(D_INFO, "Init");
+    tstor_p->is_work = OS_FALSE;
+    tstor_p->is_convert = OS_FALSE;
+    //Settings first: the other tasks wait for the load notification.
+    IF_STATUS(s = SettingsStoreInit()) { OS_LOG_S(D_WARNING, s); }
+    //Images are verified here, after the scheduler start, not on the boot path.
+    IF_OK(s = ImageVerifyInit()) {
+        IF_STATUS(s = ImageVerifyStart()) { OS_LOG_S(D_WARNING, s); }
+    } else { OS_LOG_S(D_WARNING, s); }
+    IF_OK(s = MediaIndexInit()) {
+        //First sweep right after the boot.
+        tstor_p->sweep_next_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+    } else { OS_LOG_S(D_WARNING, s); }
+    return s;
+}
+
+/******************************************************************************/
+void OS_TaskMain(OS_TaskArgs* args_p)
+{
+TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
+OS_Message* msg_p;
+const OS_QueueHd stdin_qhd = OS_TaskStdInGet(OS_THIS_TASK);
+Status s = S_UNDEF;
+extern Status APP_InitDeferred(void);
+
+    //Boot stage after the scheduler start (the lowest priority).
+    IF_STATUS(s = APP_InitDeferred()) { OS_LOG_S(D_WARNING, s); }
+
+    //Settings changes are appended to the log at once.
+    IF_STATUS(s = SettingsStoreSubscribe(stdin_qhd, OS_SIG_BGSERV_SETTINGS)) { OS_LOG_S(D_WARNING, s); }
+	for(;;) {
+        const OS_TimeMs now_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+        OS_TimeMs timeout = APP_BGSERV_POLL_PERIOD;
+        //Sleep until the next sweep if there is nothing to do (the player may hold a due sweep back).
+        if ((OS_TRUE != tstor_p->is_work) && ((S32)(tstor_p->sweep_next_ms - now_ms) > APP_BGSERV_POLL_PERIOD)) {
+            timeout = tstor_p->sweep_next_ms - now_ms;
+        }
+        //Log records are polled.
+        timeout = (APP_DLOG_DRAIN_PERIOD < timeout) ? APP_DLOG_DRAIN_PERIOD : timeout;
+        //Conversion goes at the full (idle CPU) speed.
+        if (OS_TRUE == tstor_p->is_convert) { timeout = OS_NO_BLOCK; }
+        IF_STATUS(s = OS_MessageReceive(stdin_qhd, &msg_p, timeout)) {
+        } else {
+            if (OS_SignalIs(msg_p)) {
+                switch (OS_SignalIdGet(msg_p)) {
+                    case OS_SIG_BGSERV_MEDIA_SWEEP:
+                        tstor_p->sweep_next_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+                        break;
+                    case OS_SIG_BGSERV_SETTINGS:
+                        //Appended below.
+                        break;
+                    case OS_SIG_BGSERV_IMAGE_VERIFY:
+                        IF_STATUS(s = ImageVerifyStart()) { OS_LOG_S(D_WARNING, s); }
+                        tstor_p->is_work = OS_TRUE;
+                        break;
+#if (OS_AUDIO_ENABLED)
+                    case OS_SIG_BGSERV_CONVERT_STOP:
+                        MediaConvertStop();
+                        break;
+#endif //(OS_AUDIO_ENABLED)
+                    default:
+                        OS_LOG_S(D_DEBUG, S_INVALID_SIGNAL);
+                        break;
+                }
+            } else {
+                switch (msg_p->id) {
+                    case OS_MSG_BGSERV_MEDIA_TRACK:
+                        IF_STATUS(s = MediaIndexTrackReport((const MediaIndexTrack*)msg_p->data)) {
+                            OS_LOG_S(D_WARNING, s);
+                        }
+                        tstor_p->is_work = OS_TRUE; //Index save.
+                        break;
+#if (OS_AUDIO_ENABLED)
+                    case OS_MSG_BGSERV_CONVERT:
+                        IF_STATUS(s = MediaConvertStart((const MediaConvertJob*)msg_p->data)) {
+                            OS_LOG_S(D_WARNING, s);
+                        }
+                        break;
+#endif //(OS_AUDIO_ENABLED)
+                    default:
+                        OS_LOG_S(D_DEBUG, S_INVALID_MESSAGE);
+                        break;
+                }
+                MsgPoolDelete(msg_p); // free message allocated memory
+            }
+        }
+        //Small appends and the log: not held back by the playback.
+        const Bool is_settings_work = SettingsStoreStep();
+        const Bool is_log_work = DLogStep();
+#if (OS_AUDIO_ENABLED)
+        tstor_p->is_convert = MediaConvertStep();
+#endif //(OS_AUDIO_ENABLED)
+        if (OS_TRUE != IsPlayerIdle()) {
+            tstor_p->is_work |= is_settings_work || is_log_work;
+            continue;
+        }
+        if ((S32)(OS_TICKS_TO_MS(OS_TickCountGet()) - tstor_p->sweep_next_ms) >= 0) {
+            tstor_p->sweep_next_ms += APP_MEDIA_INDEX_SWEEP_PERIOD;
+            IF_STATUS(s = MediaIndexSweepStart()) { OS_LOG_S(D_WARNING, s); }
+        }
+        const Bool is_image_work = ImageVerifyStep();
+        tstor_p->is_work = MediaIndexStep() || is_image_work || is_settings_work || is_log_work;
+    }
+}
+
+/******************************************************************************/
+Status OS_TaskPower(OS_TaskArgs* args_p, const OS_PowerState state)
+{
+Status s = S_UNDEF;
+    switch (state) {
+        case PWR_STARTUP:
+            IF_STATUS(s = OS_TaskInit(args_p)) {
+            }
+            break;
+        case PWR_ON:
+            s = S_OK;
+            break;
+        case PWR_STOP:
+        case PWR_SHUTDOWN:
+            //Pending verification resumes on the next startup.
+            s = ImageVerifySuspend();
+#if (OS_AUDIO_ENABLED)
+            MediaConvertStop();
+#endif //(OS_AUDIO_ENABLED)
+            SettingsStoreStep();
+            while (OS_TRUE == DLogStep()) {}
+            break;
+        default:
+            break;
+    }
+    return s;
+}
+
+/******************************************************************************/
+Bool IsPlayerIdle(void)
+{
+#if (OS_AUDIO_ENABLED)
+MMPlayStats stats;
+    IF_OK(MMPlayStatsGet(&stats)) {
+        return (MMPLAY_STATE_PLAY != stats.state);
+    }
+#endif //(OS_AUDIO_ENABLED)
+    return OS_TRUE;
+}
@@ -0,0 +1,30 @@
+/***************************************************************************//**
+* @file    task_bgserv.h
+* @brief   Background services task.
+* @author  A. Filyanov
+*******************************************************************************/
+#ifndef _TASK_BGSERV_H_
+#define _TASK_BGSERV_H_
+
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+#define APP_TASK_NAME_BGSERV    "BgServ"
+
+enum {
+    OS_MSG_BGSERV_UNDEF = OS_MSG_APP,
+    OS_MSG_BGSERV_MEDIA_TRACK,          // data: MediaIndexTrack
+    OS_MSG_BGSERV_CONVERT,              // data: MediaConvertJob
+    OS_MSG_BGSERV_LAST
+};
+
+enum {
+    OS_SIG_BGSERV_UNDEF = OS_SIG_APP,
+    OS_SIG_BGSERV_MEDIA_SWEEP,
+    OS_SIG_BGSERV_IMAGE_VERIFY,
+    OS_SIG_BGSERV_SETTINGS,             // Settings are changed (data: item index).
+    OS_SIG_BGSERV_CONVERT_STOP,
+    OS_SIG_BGSERV_LAST
+};
+
+#endif //_TASK_BGSERV_H_
@@ -4,11 +4,23 @@
 * @author  A. Filyanov
 *******************************************************************************/
 #include "drv_audio.h"
+#include "os_time.h"
 #include "os_supervise.h"
 #include "os_audio.h"
 #include "os_environment.h"
 #include "os_task_audio.h"
 #include "app_common.h"
+#include "audio_buf_pool.h"
+#include "msg_pool.h"
+#include "spsc_ring.h"
+#include "net_stream.h"
+#include "rtp_sink.h"
+#include "media_index.h"
+#include "prof.h"
+#include "audio_out.h"
+#include "audio_eq.h"
+#include "task_netserv.h"
+#include "task_bgserv.h"
 #include "task_mmplay.h"
 
 #if (OS_AUDIO_ENABLED)
@@ -17,35 +29,36 @@
 #undef  MDL_STATUS_ITEMS
 #define MDL_STATUS_ITEMS        &status_mmplay_v[0]
 
-#define AUDIO_BUF_IN_MEMORY     OS_MEM_RAM_EXT_SRAM
-#define AUDIO_BUF_OUT_MEMORY    OS_MEM_RAM_EXT_SRAM
 #define AUDIO_DMA_SIZE_MAX      U16_MAX
+#define AUDIO_EVENTS_COUNT      8
+#define COMMANDS_COUNT          8
 
 //------------------------------------------------------------------------------
 enum {
     S_MMPLAY_UNDEF = S_AUDIO_CODEC_LAST,
     S_MMPLAY_FORMAT_UNSUPPORTED,
+    S_MMPLAY_STREAM_ERROR,
+    S_MMPLAY_NO_DATA,
     S_MMPLAY_LAST
 };
 
 const StatusItem status_mmplay_v[] = {
     {"Undefined status"},
     {"Unsupported format"},
+    {"Stream error"},
+    {"No stream data"},
 };
 
-typedef enum {
-    MMPLAY_STATE_UNDEF,
-    MMPLAY_STATE_PLAY,
-    MMPLAY_STATE_PAUSE,
-    MMPLAY_STATE_STOP,
-    MMPLAY_STATE_LAST
-} MMPlayState;
-
 //Task arguments
 typedef struct {
     OS_FileHd           file_hd;
+    ConstStrP           file_path_str_p;
+    MediaIndexTrack     index_track;
+#if (OS_NETWORK_ENABLED)
+    Bool                is_net;
+    Size                net_skip_size;
+#endif //(OS_NETWORK_ENABLED)
     OS_QueueHd          stdin_qhd;
-    OS_AudioDeviceHd    audio_dev_hd;
     OS_AudioDmaMode     audio_dev_dma_mode;
     AudioCodecHd        audio_codec_hd;
     U8*                 audio_buf_in_p;
@@ -60,15 +73,39 @@ typedef struct {
 } TaskStorage;
 
 //------------------------------------------------------------------------------
+static Status   StreamOpen(TaskStorage* tstor_p);
 static Status   Play(TaskStorage* tstor_p);
 //static void AudioBitRateConvert(U8* data_in_p, U8* data_out_p, Size size,
 //                                const OS_AudioBits bit_rate_in, const OS_AudioBits bit_rate_out);
 static void     VolumeApply(U8* data_out_p, Size size, const OS_AudioBits bit_rate, const OS_AudioVolume volume);
 static Status   FrameReadDecode(TaskStorage* tstor_p, U8* audio_buf_out_p);
+static Status   Seek(TaskStorage* tstor_p, const U32 position_ms);
+static Status   SourceOpen(TaskStorage* tstor_p, ConstStrP path_str_p);
+static Status   SourceClose(TaskStorage* tstor_p);
+static Status   SourceRewind(TaskStorage* tstor_p);
+static Status   SourceRead(TaskStorage* tstor_p, U8* data_p, const Size size);
+static void     IndexTrackReport(TaskStorage* tstor_p);
+#if (OS_NETWORK_ENABLED)
+static Status   NetSourceOpen(ConstStrP url_str_p);
+static Status   NetSourceProbeEnd(TaskStorage* tstor_p);
+static Status   NetSourceRead(TaskStorage* tstor_p, U8* data_p, const Size size);
+static void     NetSourceClose(void);
+#endif //(OS_NETWORK_ENABLED)
+static Status   CommandApply(TaskStorage* tstor_p, const MMPlayCommand* cmd_p);
+static Status   AudioEventHandle(TaskStorage* tstor_p, const OS_SignalId event_id);
+static Status   HalfRefill(TaskStorage* tstor_p, const U8 half_idx);
+static void     AudioBufsRelease(TaskStorage* tstor_p);
 static void     ISR_DrvAudioDeviceCallback(OS_AudioDeviceCallbackArgs* args_p);
 
 //------------------------------------------------------------------------------
 ConstStrP mmplay_file_path_str_p;
+static MMPlayStats mmplay_stats;
+//Audio device events (ISR -> task).
+static SpscRing audio_events_ring;
+static OS_SignalId audio_events_v[AUDIO_EVENTS_COUNT];
+//Control commands (MMPlayCtl -> task).
+static SpscRing commands_ring;
+static MMPlayCommand commands_v[COMMANDS_COUNT];
 
 //------------------------------------------------------------------------------
 OS_TaskConfig task_mmplay_cfg = {
@@ -90,75 +127,101 @@ Status OS_TaskInit(OS_TaskArgs* args_p)
 {
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
 ConstStrP file_path_str_p = args_p->args_p;
-AudioFormatInfo* audio_format_info_p = &(tstor_p->audio_format_info);
 Status s = S_UNDEF;
 
     tstor_p->state = MMPLAY_STATE_UNDEF;
+    tstor_p->file_path_str_p = file_path_str_p;
+    //Commands for the previous player instance.
+    SpscRingFlush(&commands_ring);
     //Check file format.
-    IF_OK(s = AudioFileFormatInfoGet(file_path_str_p, audio_format_info_p)) {
-        if (AUDIO_FORMAT_UNDEF != audio_format_info_p->format) {
-            if (AUDIO_FORMAT_MP3 == audio_format_info_p->format) {
-                tstor_p->audio_buf_out_size = 0x2400;
-                tstor_p->audio_buf_in_size  = tstor_p->audio_buf_out_size;
-                tstor_p->audio_dev_dma_mode = OS_AUDIO_DMA_MODE_CIRCULAR; //OS_AUDIO_DMA_MODE_NORMAL;
-            } else if (AUDIO_FORMAT_WAV == audio_format_info_p->format) {
-                tstor_p->audio_buf_out_size = 0x2000;
-                tstor_p->audio_buf_in_size  = (tstor_p->audio_buf_out_size / 2);
-                tstor_p->audio_dev_dma_mode = OS_AUDIO_DMA_MODE_CIRCULAR;
-            } else { return s = S_MMPLAY_FORMAT_UNSUPPORTED; }
-            tstor_p->audio_codec_hd  = AudioCodecGet(audio_format_info_p->format);
-            tstor_p->audio_dev_hd    = OS_AudioDeviceDefaultGet(DIR_OUT);
-            if ((OS_NULL != tstor_p->audio_dev_hd) &&
-                (OS_NULL != tstor_p->audio_codec_hd)) {
-                const OS_AudioDeviceIoSetupArgs io_args = {
-                    .info       = tstor_p->audio_format_info.audio_info,
-                    .dma_mode   = tstor_p->audio_dev_dma_mode,
-                    .volume     = OS_VolumeGet(),
+#if (OS_NETWORK_ENABLED)
+    tstor_p->is_net = NetStreamIsUrl(file_path_str_p);
+    if (OS_TRUE == tstor_p->is_net) {
+        //The stream is opened on the probe end signal (NetSourceProbeEnd()).
+        s = NetSourceOpen(file_path_str_p);
+    } else
+#endif //(OS_NETWORK_ENABLED)
+    {
+        IF_OK(s = AudioFileFormatInfoGet(file_path_str_p, &tstor_p->audio_format_info)) {
+            s = StreamOpen(tstor_p);
+        }
+    }
+    IF_STATUS(s) { OS_LOG_S(D_WARNING, s); }
+    return s;
+}
+
+/******************************************************************************/
+Status StreamOpen(TaskStorage* tstor_p)
+{
+AudioFormatInfo* audio_format_info_p = &(tstor_p->audio_format_info);
+Status s = S_UNDEF;
+
+    if (AUDIO_FORMAT_UNDEF != audio_format_info_p->format) {
+        if (AUDIO_FORMAT_MP3 == audio_format_info_p->format) {
+            tstor_p->audio_buf_out_size = 0x2400;
+            tstor_p->audio_buf_in_size  = tstor_p->audio_buf_out_size;
+            tstor_p->audio_dev_dma_mode = OS_AUDIO_DMA_MODE_CIRCULAR; //OS_AUDIO_DMA_MODE_NORMAL;
+        } else if (AUDIO_FORMAT_WAV == audio_format_info_p->format) {
+            tstor_p->audio_buf_out_size = 0x2000;
+            tstor_p->audio_buf_in_size  = (tstor_p->audio_buf_out_size / 2);
+            tstor_p->audio_dev_dma_mode = OS_AUDIO_DMA_MODE_CIRCULAR;
+        } else { return s = S_MMPLAY_FORMAT_UNSUPPORTED; }
+        tstor_p->audio_codec_hd  = AudioCodecGet(audio_format_info_p->format);
+        if (OS_NULL != tstor_p->audio_codec_hd) {
+            const OS_AudioDeviceIoSetupArgs io_args = {
+                .info       = tstor_p->audio_format_info.audio_info,
+                .dma_mode   = tstor_p->audio_dev_dma_mode,
+                .volume     = OS_VolumeGet(),
+            };
+            //Acquire audio stream buffers.
+            tstor_p->audio_buf_in_p = AudioBufAcquire(tstor_p->audio_buf_in_size);
+            tstor_p->audio_buf_out_p= AudioBufAcquire(tstor_p->audio_buf_out_size);
+            if ((OS_NULL == tstor_p->audio_buf_in_p) ||
+                (OS_NULL == tstor_p->audio_buf_out_p)) {
+                AudioBufsRelease(tstor_p);
+                return s = S_OUT_OF_MEMORY;
+            }
+            IF_OK(s = SourceOpen(tstor_p, tstor_p->file_path_str_p)) {
+                SpscRingInit(&audio_events_ring, audio_events_v, sizeof(OS_SignalId), AUDIO_EVENTS_COUNT);
+                const OS_AudioDeviceArgsOpen audio_dev_open_args = {
+                    .slot_qhd           = OS_TaskStdInGet(OS_THIS_TASK),
+                    .isr_callback_func  = ISR_DrvAudioDeviceCallback
                 };
-                IF_OK(s = OS_AudioDeviceIoSetup(tstor_p->audio_dev_hd, &io_args, DIR_OUT)) {
-                    //Allocate audio stream buffers.
-                    tstor_p->audio_buf_in_p = OS_MallocEx(tstor_p->audio_buf_in_size,  AUDIO_BUF_IN_MEMORY);
-                    tstor_p->audio_buf_out_p= OS_MallocEx(tstor_p->audio_buf_out_size, AUDIO_BUF_OUT_MEMORY);
-                    if ((OS_NULL == tstor_p->audio_buf_in_p) ||
-                        (OS_NULL == tstor_p->audio_buf_out_p)) { return s = S_OUT_OF_MEMORY; }
-                    IF_OK(s = OS_FileOpen(&tstor_p->file_hd, file_path_str_p,
-                                          BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ))) {
-                        const OS_AudioDeviceArgsOpen audio_dev_open_args = {
-                            .slot_qhd           = OS_TaskStdInGet(OS_THIS_TASK),
-                            .isr_callback_func  = ISR_DrvAudioDeviceCallback
-                        };
-                        IF_OK(s = OS_AudioDeviceOpen(tstor_p->audio_dev_hd, (void*)&audio_dev_open_args)) {
-                            IF_OK(s = AudioCodecOpen(tstor_p->audio_codec_hd, OS_NULL)) {
-                                tstor_p->audio_frame_info.buf_in_offset = 0;
-                                tstor_p->audio_frame_info.buf_out_size  = 0;
-                                tstor_p->audio_buf_out_size /= 2; //Double buffer.
-                                tstor_p->audio_buf_idx       = 0; //First one.
-                                tstor_p->state = MMPLAY_STATE_STOP;
-                                const OS_Signal signal = OS_SignalCreate(OS_SIG_MMPLAY_PLAY, 0);
-                                IF_OK(s = OS_SignalSend(audio_dev_open_args.slot_qhd, signal, OS_MSG_PRIO_NORMAL)) {
-                                }
-                                IF_STATUS(s) {
-                                    IF_STATUS(s = AudioCodecClose(tstor_p->audio_codec_hd, OS_NULL)) {
-                                    }
-                                }
-                            }
-                            IF_STATUS(s) {
-                                IF_OK(s = OS_AudioDeviceClose(tstor_p->audio_dev_hd)) {}
-                            }
+                IF_OK(s = AudioOutOpen(&io_args, &audio_dev_open_args, OS_SIG_MMPLAY_AUDIO_OUT)) {
+                    tstor_p->audio_frame_info.is_background = OS_FALSE;
+                    IF_OK(s = AudioCodecOpen(tstor_p->audio_codec_hd, &tstor_p->audio_frame_info)) {
+                        tstor_p->audio_frame_info.buf_in_offset = 0;
+                        tstor_p->audio_frame_info.buf_out_size  = 0;
+                        tstor_p->audio_buf_out_size /= 2; //Double buffer (circular DMA: the buffer halves).
+                        tstor_p->audio_buf_idx       = 0; //First one.
+                        tstor_p->state = MMPLAY_STATE_STOP;
+                        mmplay_stats.is_seekable = (AUDIO_FORMAT_WAV == audio_format_info_p->format);
+#if (OS_NETWORK_ENABLED)
+                        if (OS_TRUE == tstor_p->is_net) { mmplay_stats.is_seekable = OS_FALSE; }
+#endif //(OS_NETWORK_ENABLED)
+                        RtpSinkFormatSet(&tstor_p->audio_format_info.audio_info, tstor_p->audio_buf_out_size);
+                        AudioEqFormatSet(&tstor_p->audio_format_info.audio_info);
+                        const OS_Signal signal = OS_SignalCreate(OS_SIG_MMPLAY_PLAY, 0);
+                        IF_OK(s = OS_SignalSend(audio_dev_open_args.slot_qhd, signal, OS_MSG_PRIO_NORMAL)) {
                         }
                         IF_STATUS(s) {
-                            IF_OK(s = OS_FileClose(&tstor_p->file_hd)) {}
+                            IF_STATUS(s = AudioCodecClose(tstor_p->audio_codec_hd, &tstor_p->audio_frame_info)) {
+                            }
                         }
                     }
+                    IF_STATUS(s) {
+                        IF_OK(s = AudioOutClose()) {}
+                    }
                 }
                 IF_STATUS(s) {
-                    OS_FreeEx(tstor_p->audio_buf_in_p,  AUDIO_BUF_IN_MEMORY);
-                    OS_FreeEx(tstor_p->audio_buf_out_p, AUDIO_BUF_OUT_MEMORY);
+                    IF_OK(s = SourceClose(tstor_p)) {}
                 }
-            } else { s = S_INVALID_PTR; }
-        } else { s = S_MMPLAY_FORMAT_UNSUPPORTED; }
-    }
-    IF_STATUS(s) { OS_LOG_S(D_WARNING, s); }
+            }
+            IF_STATUS(s) {
+                AudioBufsRelease(tstor_p);
+            }
+        } else { s = S_INVALID_PTR; }
+    } else { s = S_MMPLAY_FORMAT_UNSUPPORTED; }
     return s;
 }
 
@@ -167,8 +230,6 @@ void OS_TaskMain(OS_TaskArgs* args_p)
 {
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
 OS_Message* msg_p;
-U8* decode_audio_buf_out_p;
-U8* play_audio_buf_out_p;
 Status s = S_UNDEF;
 
     tstor_p->stdin_qhd = OS_TaskStdInGet(OS_THIS_TASK);
@@ -178,82 +239,61 @@ Status s = S_UNDEF;
         } else {
             if (OS_SignalIs(msg_p)) {
                 switch (OS_SignalIdGet(msg_p)) {
-                    case OS_SIG_AUDIO_TX_COMPLETE:
-#if (OS_DEBUG_ENABLED)
-{
-    HAL_DEBUG_PIN1_TOGGLE();
-}
-#endif // (OS_DEBUG_ENABLED)
-                        decode_audio_buf_out_p  = tstor_p->audio_buf_out_p;
-                        play_audio_buf_out_p    = decode_audio_buf_out_p;
-                        if (tstor_p->audio_buf_idx) {
-                            decode_audio_buf_out_p  += tstor_p->audio_buf_out_size;
-                        } else {
-                            play_audio_buf_out_p    += tstor_p->audio_buf_out_size;
+                    case OS_SIG_MMPLAY_AUDIO_EVENTS: {
+                        //Drain all the device events queued since the wakeup.
+                        OS_SignalId event_id;
+                        U32 events_count = 0;
+                        SpscRingNotifyClear(&audio_events_ring);
+                        while (OS_TRUE == SpscRingGet(&audio_events_ring, &event_id)) {
+                            ++events_count;
+                            IF_STATUS(s = AudioEventHandle(tstor_p, event_id)) { break; }
                         }
-                        if (OS_AUDIO_DMA_MODE_NORMAL == tstor_p->audio_dev_dma_mode) {
-                            IF_OK(s = OS_AudioPlay(tstor_p->audio_dev_hd, play_audio_buf_out_p, tstor_p->audio_buf_out_size_curr)) {
-                                s = FrameReadDecode(tstor_p, decode_audio_buf_out_p);
-                                VolumeApply(decode_audio_buf_out_p, tstor_p->audio_buf_out_size_curr,
-                                            tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
-                            }
-                        } else if (OS_AUDIO_DMA_MODE_CIRCULAR == tstor_p->audio_dev_dma_mode) {
-                            s = FrameReadDecode(tstor_p, decode_audio_buf_out_p);
-                            VolumeApply(decode_audio_buf_out_p, tstor_p->audio_buf_out_size_curr,
-                                        tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
-                        } else {
-                            OS_LOG_S(D_CRITICAL, S_HARDWARE_ERROR);
-                            OS_TaskDelete(OS_THIS_TASK);
+                        //More than one pending refill: the DMA has played a stale buffer part.
+                        if (1 < events_count) { mmplay_stats.dma_late += (events_count - 1); }
                         }
-                        tstor_p->audio_buf_idx ^= 1; // Switch output buffer.
-#if (OS_DEBUG_ENABLED)
-{
-    HAL_DEBUG_PIN1_TOGGLE();
-}
-#endif // (OS_DEBUG_ENABLED)
-                        break;
-                    case OS_SIG_AUDIO_TX_COMPLETE_HALF:
                         break;
-                    case OS_SIG_AUDIO_ERROR:
-                        OS_LOG_S(D_DEBUG, S_HARDWARE_ERROR);
+                    case OS_SIG_MMPLAY_CTL: {
+                        //Commands go ahead of the audio events (high priority wakeup).
+                        MMPlayCommand cmd;
+                        SpscRingNotifyClear(&commands_ring);
+                        while (OS_TRUE == SpscRingGet(&commands_ring, &cmd)) {
+                            s = CommandApply(tstor_p, &cmd);
+                            mmplay_stats.state = tstor_p->state;
+                            IF_STATUS(s) { OS_LOG_S(D_WARNING, s); }
+                        }
+                        s = S_OK;
+                        }
                         break;
-                    case OS_SIG_MMPLAY_PLAY:
-                        if (MMPLAY_STATE_STOP == tstor_p->state) {
-                            IF_OK(s = Play(tstor_p)) {
-                                tstor_p->state = MMPLAY_STATE_PLAY;
-                            }
-                        } else { s = S_INVALID_STATE; }
+                    case OS_SIG_TIMER:
+                    case OS_SIG_MMPLAY_AUDIO_OUT: {
+                        //Simulated output: the next buffer event.
+                        const OS_SignalId event_id = AudioOutEventNext();
+                        s = (OS_SIG_UNDEF != event_id) ? AudioEventHandle(tstor_p, event_id) : S_OK;
+                        }
                         break;
-                    case OS_SIG_MMPLAY_PAUSE:
-                        if (MMPLAY_STATE_PLAY == tstor_p->state) {
-                            IF_OK(s = OS_AudioPause(tstor_p->audio_dev_hd)) {
-                                tstor_p->state = MMPLAY_STATE_PAUSE;
-                            }
-                        } else { s = S_INVALID_STATE; }
+#if (OS_NETWORK_ENABLED)
+                    case OS_SIG_MMPLAY_NET_PROBE:
+                        IF_STATUS(s = NetSourceProbeEnd(tstor_p)) {
+                            OS_LOG_S(D_WARNING, s);
+                            OS_TaskDelete(OS_THIS_TASK);
+                        }
                         break;
-                    case OS_SIG_MMPLAY_RESUME:
-                        if (MMPLAY_STATE_PAUSE == tstor_p->state) {
-                            IF_OK(s = OS_AudioResume(tstor_p->audio_dev_hd)) {
-                                tstor_p->state = MMPLAY_STATE_PLAY;
-                            }
-                        } else { s = S_INVALID_STATE; }
+                    case OS_SIG_MMPLAY_RTP_SINK:
+                        RtpSinkSync();
+                        s = S_OK;
                         break;
-                    case OS_SIG_MMPLAY_STOP:
-                        if ((MMPLAY_STATE_PLAY  == tstor_p->state) ||
-                            (MMPLAY_STATE_PAUSE == tstor_p->state)) {
-                            IF_OK(s = OS_AudioStop(tstor_p->audio_dev_hd)) {
-                                IF_OK(s = OS_QueueClear(tstor_p->stdin_qhd)) {
-                                    IF_OK(s = OS_FileLSeek(tstor_p->file_hd, 0)) {
-                                        tstor_p->state = MMPLAY_STATE_STOP;
-                                    }
-                                }
-                            }
-                        } else { s = S_INVALID_STATE; }
+#endif //(OS_NETWORK_ENABLED)
+                    case OS_SIG_MMPLAY_PLAY: {
+                        //Self-start on the init.
+                        const MMPlayCommand cmd = { .id = OS_SIG_MMPLAY_PLAY, .data = 0, .tick = OS_TickCountGet() };
+                        s = CommandApply(tstor_p, &cmd);
+                        }
                         break;
                     default:
                         s = S_INVALID_SIGNAL;
                         break;
                 }
+                mmplay_stats.state = tstor_p->state;
                 IF_STATUS(s) {
                     OS_LOG_S(D_WARNING, s);
                 }
@@ -263,12 +303,132 @@ Status s = S_UNDEF;
                         OS_LOG_S(D_DEBUG, S_INVALID_MESSAGE);
                         break;
                 }
-                OS_MessageDelete(msg_p); // free message allocated memory
+                MsgPoolDelete(msg_p); // free message allocated memory
             }
         }
     }
 }
 
+/******************************************************************************/
+Status CommandApply(TaskStorage* tstor_p, const MMPlayCommand* cmd_p)
+{
+Status s = S_UNDEF;
+
+    switch (cmd_p->id) {
+        case OS_SIG_MMPLAY_PLAY:
+            if (MMPLAY_STATE_STOP == tstor_p->state) {
+                IF_OK(s = Play(tstor_p)) {
+                    tstor_p->state = MMPLAY_STATE_PLAY;
+                }
+            } else { s = S_INVALID_STATE; }
+            break;
+        case OS_SIG_MMPLAY_PAUSE:
+            if (MMPLAY_STATE_PLAY == tstor_p->state) {
+                IF_OK(s = AudioOutPause()) {
+                    tstor_p->state = MMPLAY_STATE_PAUSE;
+                }
+            } else { s = S_INVALID_STATE; }
+            break;
+        case OS_SIG_MMPLAY_RESUME:
+            if (MMPLAY_STATE_PAUSE == tstor_p->state) {
+                IF_OK(s = AudioOutResume()) {
+                    tstor_p->state = MMPLAY_STATE_PLAY;
+                }
+            } else { s = S_INVALID_STATE; }
+            break;
+        case OS_SIG_MMPLAY_SEEK:
+            if (MMPLAY_STATE_UNDEF != tstor_p->state) {
+                s = Seek(tstor_p, cmd_p->data);
+            } else { s = S_INVALID_STATE; }
+            break;
+        case OS_SIG_MMPLAY_STOP:
+            if ((MMPLAY_STATE_PLAY  == tstor_p->state) ||
+                (MMPLAY_STATE_PAUSE == tstor_p->state)) {
+                IF_OK(s = AudioOutStop()) {
+                    //Events of the stopped output only; the queue keeps the rest.
+                    SpscRingFlush(&audio_events_ring);
+                    IF_OK(s = SourceRewind(tstor_p)) {
+                        RtpSinkFormatSet(&tstor_p->audio_format_info.audio_info, tstor_p->audio_buf_out_size);
+                        AudioEqFormatSet(&tstor_p->audio_format_info.audio_info);
+                        tstor_p->state = MMPLAY_STATE_STOP;
+                    }
+                }
+            } else { s = S_INVALID_STATE; }
+            break;
+        default:
+            s = S_INVALID_SIGNAL;
+            break;
+    }
+    //Command to effect latency (from the control front-end receipt).
+    mmplay_stats.ctl_latency_last_ms = OS_TICKS_TO_MS(OS_TickCountGet() - cmd_p->tick);
+    if (mmplay_stats.ctl_latency_max_ms < mmplay_stats.ctl_latency_last_ms) {
+        mmplay_stats.ctl_latency_max_ms = mmplay_stats.ctl_latency_last_ms;
+    }
+    ++mmplay_stats.commands;
+    return s;
+}
+
+/******************************************************************************/
+Status AudioEventHandle(TaskStorage* tstor_p, const OS_SignalId event_id)
+{
+U8* decode_audio_buf_out_p;
+U8* play_audio_buf_out_p;
+Status s = S_OK;
+
+    switch (event_id) {
+        case OS_SIG_AUDIO_TX_COMPLETE:
+#if (OS_DEBUG_ENABLED)
+{
+    HAL_DEBUG_PIN1_TOGGLE();
+}
+#endif // (OS_DEBUG_ENABLED)
+            RtpSinkClockAdvance(tstor_p->audio_buf_out_size);
+            if (OS_AUDIO_DMA_MODE_CIRCULAR == tstor_p->audio_dev_dma_mode) {
+                //DMA has left the second half.
+                s = HalfRefill(tstor_p, 1);
+            } else if (OS_AUDIO_DMA_MODE_NORMAL == tstor_p->audio_dev_dma_mode) {
+                decode_audio_buf_out_p  = tstor_p->audio_buf_out_p;
+                play_audio_buf_out_p    = decode_audio_buf_out_p;
+                if (tstor_p->audio_buf_idx) {
+                    decode_audio_buf_out_p  += tstor_p->audio_buf_out_size;
+                } else {
+                    play_audio_buf_out_p    += tstor_p->audio_buf_out_size;
+                }
+                IF_OK(s = AudioOutPlay(play_audio_buf_out_p, tstor_p->audio_buf_out_size_curr)) {
+                    s = FrameReadDecode(tstor_p, decode_audio_buf_out_p);
+                    RtpSinkWrite(decode_audio_buf_out_p, tstor_p->audio_buf_out_size_curr);
+                    AudioEqApply(decode_audio_buf_out_p, tstor_p->audio_buf_out_size_curr);
+                    VolumeApply(decode_audio_buf_out_p, tstor_p->audio_buf_out_size_curr,
+                                tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
+                }
+                tstor_p->audio_buf_idx ^= 1; // Switch output buffer.
+            } else {
+                OS_LOG_S(D_CRITICAL, S_HARDWARE_ERROR);
+                OS_TaskDelete(OS_THIS_TASK);
+            }
+#if (OS_DEBUG_ENABLED)
+{
+    HAL_DEBUG_PIN1_TOGGLE();
+}
+#endif // (OS_DEBUG_ENABLED)
+            break;
+        case OS_SIG_AUDIO_TX_COMPLETE_HALF:
+            if (OS_AUDIO_DMA_MODE_CIRCULAR == tstor_p->audio_dev_dma_mode) {
+                //DMA has left the first half.
+                RtpSinkClockAdvance(tstor_p->audio_buf_out_size);
+                s = HalfRefill(tstor_p, 0);
+            }
+            break;
+        case OS_SIG_AUDIO_ERROR:
+            OS_LOG_S(D_DEBUG, S_HARDWARE_ERROR);
+            break;
+        default:
+            s = S_INVALID_SIGNAL;
+            break;
+    }
+    return s;
+}
+
 /******************************************************************************/
 Status OS_TaskPower(OS_TaskArgs* args_p, const OS_PowerState state)
 {
@@ -283,18 +443,31 @@ Status s = S_UNDEF;
         case PWR_STOP:
             break;
         case PWR_SHUTDOWN:
-            IF_OK(s = OS_AudioStop(tstor_p->audio_dev_hd)) {
-                IF_OK(s = AudioCodecClose(tstor_p->audio_codec_hd, OS_NULL)) {
+            mmplay_stats.state = MMPLAY_STATE_UNDEF;
+            mmplay_stats.is_seekable = OS_FALSE;
+            RtpSinkFormatSet(OS_NULL, 0);
+            AudioEqFormatSet(OS_NULL);
+            if (MMPLAY_STATE_UNDEF == tstor_p->state) {
+                //Network stream probe is pending: nothing is opened yet.
+                IF_OK(s = OS_QueueClear(OS_TaskStdInGet(OS_THIS_TASK))) {
+#if (OS_NETWORK_ENABLED)
+                    if (OS_TRUE == tstor_p->is_net) { NetSourceClose(); }
+#endif //(OS_NETWORK_ENABLED)
+                }
+                break;
+            }
+            IF_OK(s = AudioOutStop()) {
+                IF_OK(s = AudioCodecClose(tstor_p->audio_codec_hd, &tstor_p->audio_frame_info)) {
                     IF_OK(s = OS_QueueClear(OS_TaskStdInGet(OS_THIS_TASK))) {
-                        IF_OK(s = OS_FileClose(&tstor_p->file_hd)) {
-                            IF_OK(s = OS_AudioDeviceClose(tstor_p->audio_dev_hd)) {
+                        SpscRingFlush(&audio_events_ring);
+                        IF_OK(s = SourceClose(tstor_p)) {
+                            IF_OK(s = AudioOutClose()) {
                             }
                         }
                     }
                 }
             }
-            OS_FreeEx(tstor_p->audio_buf_in_p,  AUDIO_BUF_IN_MEMORY);
-            OS_FreeEx(tstor_p->audio_buf_out_p, AUDIO_BUF_OUT_MEMORY);
+            AudioBufsRelease(tstor_p);
             break;
         case PWR_ON:
             IF_STATUS(s = OS_TaskInit(args_p)) {}
@@ -313,13 +486,32 @@ Status Play(TaskStorage* tstor_p)
 {
 Status s = S_UNDEF;
 
-    IF_OK(s = OS_FileLSeek(tstor_p->file_hd, tstor_p->audio_format_info.header_size)) {
+    if (OS_AUDIO_DMA_MODE_CIRCULAR == tstor_p->audio_dev_dma_mode) {
+        //One contiguous buffer: both halves are filled before the start,
+        //then the half/full transfer events refill them in turn.
+        IF_OK(s = SourceRewind(tstor_p)) {
+            IF_OK(s = HalfRefill(tstor_p, 0)) {
+                IF_OK(s = HalfRefill(tstor_p, 1)) {
+                    IF_OK(s = AudioOutPlay(tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size * 2)) {
+                        RtpSinkClockAdvance(0);
+                    }
+                }
+            }
+        }
+        return s;
+    }
+    IF_OK(s = SourceRewind(tstor_p)) {
         IF_OK(s = FrameReadDecode(tstor_p, tstor_p->audio_buf_out_p)) {
+            //Network sink takes the PCM before the local EQ and volume.
+            RtpSinkWrite(tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size_curr);
+            AudioEqApply(tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size_curr);
             VolumeApply(tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size_curr,
                         tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
-            IF_OK(s = OS_AudioPlay(tstor_p->audio_dev_hd,
-                                   tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size_curr)) {
+            IF_OK(s = AudioOutPlay(tstor_p->audio_buf_out_p, tstor_p->audio_buf_out_size_curr)) {
+                RtpSinkClockAdvance(0);
                 IF_OK(s = FrameReadDecode(tstor_p, (tstor_p->audio_buf_out_p + tstor_p->audio_buf_out_size))) {
+                    RtpSinkWrite((tstor_p->audio_buf_out_p + tstor_p->audio_buf_out_size), tstor_p->audio_buf_out_size_curr);
+                    AudioEqApply((tstor_p->audio_buf_out_p + tstor_p->audio_buf_out_size), tstor_p->audio_buf_out_size_curr);
                     VolumeApply((tstor_p->audio_buf_out_p + tstor_p->audio_buf_out_size), tstor_p->audio_buf_out_size_curr,
                                 tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
                 }
@@ -329,9 +521,26 @@ Status s = S_UNDEF;
     return s;
 }
 
+/******************************************************************************/
+Status HalfRefill(TaskStorage* tstor_p, const U8 half_idx)
+{
+U8* half_p = tstor_p->audio_buf_out_p + (half_idx * tstor_p->audio_buf_out_size);
+Status s = S_UNDEF;
+
+    IF_OK(s = FrameReadDecode(tstor_p, half_p)) {
+        //Network sink takes the PCM before the local EQ and volume.
+        RtpSinkWrite(half_p, tstor_p->audio_buf_out_size_curr);
+        AudioEqApply(half_p, tstor_p->audio_buf_out_size_curr);
+        VolumeApply(half_p, tstor_p->audio_buf_out_size_curr,
+                    tstor_p->audio_format_info.audio_info.sample_bits, OS_VolumeGet());
+    }
+    return s;
+}
+
 /******************************************************************************/
 void VolumeApply(U8* data_out_p, Size size, const OS_AudioBits bit_rate, const OS_AudioVolume volume)
 {
+PROF_ENTER(PROF_REGION_VOLUME_APPLY);
     OS_ASSERT_VALUE(OS_NULL != data_out_p);
     const Float volume_pct = (Float)volume / OS_AUDIO_VOLUME_MAX;
     if (16 == bit_rate) {
@@ -348,29 +557,38 @@ void VolumeApply(U8* data_out_p, Size size, const OS_AudioBits bit_rate, const O
             *data_out_32p++ *= volume_pct;
         }
     } else { OS_LOG_S(D_WARNING, S_INVALID_VALUE); }
+    PROF_EXIT(PROF_REGION_VOLUME_APPLY);
 }
 
 /******************************************************************************/
 Status FrameReadDecode(TaskStorage* tstor_p, U8* audio_buf_out_p)
 {
+const OS_Tick tick_start = OS_TickCountGet();
 Int audio_buf_out_size = tstor_p->audio_buf_out_size;
 Status s = S_UNDEF;
+PROF_ENTER(PROF_REGION_FRAME_READ_DECODE);
 
     while ((0 < audio_buf_out_size) && (s != S_AUDIO_CODEC_OUTPUT_BUFFER_FULL)) {
-        IF_OK(s = OS_FileRead(tstor_p->file_hd,
-                              tstor_p->audio_buf_in_p    + tstor_p->audio_frame_info.buf_in_offset,
-                              tstor_p->audio_buf_in_size - tstor_p->audio_frame_info.buf_in_offset)) {
+        IF_OK(s = SourceRead(tstor_p,
+                             tstor_p->audio_buf_in_p    + tstor_p->audio_frame_info.buf_in_offset,
+                             tstor_p->audio_buf_in_size - tstor_p->audio_frame_info.buf_in_offset)) {
+            PROF_ENTER(PROF_REGION_CODEC_DECODE);
             IF_OK(s = AudioCodecDecode(tstor_p->audio_codec_hd,
                                        tstor_p->audio_buf_in_p, tstor_p->audio_buf_in_size,
                                        audio_buf_out_p, audio_buf_out_size,
                                        &tstor_p->audio_frame_info)) {
             }
+            PROF_EXIT(PROF_REGION_CODEC_DECODE);
             audio_buf_out_p     += tstor_p->audio_frame_info.buf_out_size;
             audio_buf_out_size  -= tstor_p->audio_frame_info.buf_out_size;
         } else {
             if ((S_FS_EOF == s) || (S_INVALID_SIZE == s)) {
                 OS_LOG(D_DEBUG, "End of file");
                 OS_TaskDelete(OS_THIS_TASK);
+            } else if (S_MMPLAY_NO_DATA == s) {
+                //Stream underrun: play silence while the jitter buffer refills.
+                ++mmplay_stats.underruns;
+                break;
             }
         }
     }
@@ -379,17 +597,268 @@ Status s = S_UNDEF;
         OS_MemSet(audio_buf_out_p, 0, audio_buf_out_size);
     }
     tstor_p->audio_buf_out_size_curr = (tstor_p->audio_buf_out_size - audio_buf_out_size);
+    mmplay_stats.decode_time_last_ms = OS_TICKS_TO_MS(OS_TickCountGet() - tick_start);
+    if (mmplay_stats.decode_time_max_ms < mmplay_stats.decode_time_last_ms) {
+        mmplay_stats.decode_time_max_ms = mmplay_stats.decode_time_last_ms;
+    }
+    ++mmplay_stats.decode_count;
+    PROF_EXIT(PROF_REGION_FRAME_READ_DECODE);
     s = S_OK; //Status force clear!
     return s;
 }
 
+/******************************************************************************/
+Status Seek(TaskStorage* tstor_p, const U32 position_ms)
+{
+const AudioFormatInfo* info_p = &tstor_p->audio_format_info;
+const U32 frame_size = info_p->audio_info.channels * (info_p->audio_info.sample_bits / 8);
+//Whole sample frames only.
+const U32 frames = (U32)(((U64)position_ms * info_p->audio_info.sample_rate) / 1000);
+Status s = S_UNDEF;
+
+#if (OS_NETWORK_ENABLED)
+    if (OS_TRUE == tstor_p->is_net) { return s = S_INVALID_STATE; }
+#endif //(OS_NETWORK_ENABLED)
+    //Constant byte rate formats only.
+    if (AUDIO_FORMAT_WAV != info_p->format) { return s = S_MMPLAY_FORMAT_UNSUPPORTED; }
+    IF_OK(s = OS_FileLSeek(tstor_p->file_hd,
+                           info_p->header_size + (frames * frame_size))) {
+        tstor_p->audio_frame_info.buf_in_offset = 0;
+        MediaIndexTrackAbort(&tstor_p->index_track);
+        RtpSinkFormatSet(&info_p->audio_info, tstor_p->audio_buf_out_size);
+        AudioEqFormatSet(&info_p->audio_info);
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status MMPlayStatsGet(MMPlayStats* stats_p)
+{
+    if (OS_NULL == stats_p) { return S_INVALID_PTR; }
+    *stats_p = mmplay_stats;
+    return S_OK;
+}
+
+/******************************************************************************/
+Status SourceOpen(TaskStorage* tstor_p, ConstStrP path_str_p)
+{
+#if (OS_NETWORK_ENABLED)
+    //Stream is opened by NetServ on the format detection.
+    if (OS_TRUE == tstor_p->is_net) { return S_OK; }
+#endif //(OS_NETWORK_ENABLED)
+    tstor_p->file_path_str_p = path_str_p;
+    MediaIndexTrackAbort(&tstor_p->index_track);
+    return OS_FileOpen(&tstor_p->file_hd, path_str_p,
+                       BIT(OS_FS_FILE_OP_MODE_OPEN_EXISTS) | BIT(OS_FS_FILE_OP_MODE_READ));
+}
+
+/******************************************************************************/
+Status SourceClose(TaskStorage* tstor_p)
+{
+#if (OS_NETWORK_ENABLED)
+    if (OS_TRUE == tstor_p->is_net) {
+        NetSourceClose();
+        return S_OK;
+    }
+#endif //(OS_NETWORK_ENABLED)
+    return OS_FileClose(&tstor_p->file_hd);
+}
+
+/******************************************************************************/
+Status SourceRewind(TaskStorage* tstor_p)
+{
+#if (OS_NETWORK_ENABLED)
+    //Live stream can't be rewound; the play goes on from the current position.
+    if (OS_TRUE == tstor_p->is_net) { return S_OK; }
+#endif //(OS_NETWORK_ENABLED)
+    //Sequential reads from the format header end feed the media index.
+    MediaIndexTrackBegin(&tstor_p->index_track, tstor_p->file_path_str_p,
+                         OS_FileSizeGet(tstor_p->file_hd), tstor_p->audio_format_info.header_size);
+    return OS_FileLSeek(tstor_p->file_hd, tstor_p->audio_format_info.header_size);
+}
+
+/******************************************************************************/
+Status SourceRead(TaskStorage* tstor_p, U8* data_p, const Size size)
+{
+Status s = S_UNDEF;
+#if (OS_NETWORK_ENABLED)
+    if (OS_TRUE == tstor_p->is_net) { return NetSourceRead(tstor_p, data_p, size); }
+#endif //(OS_NETWORK_ENABLED)
+    {
+        PROF_ENTER(PROF_REGION_SOURCE_READ);
+        s = OS_FileRead(tstor_p->file_hd, data_p, size);
+        PROF_EXIT(PROF_REGION_SOURCE_READ);
+    }
+    if ((S_OK == s) || (S_FS_EOF == s)) {
+        if (OS_TRUE == MediaIndexTrackUpdate(&tstor_p->index_track, data_p, size)) {
+            IndexTrackReport(tstor_p);
+        }
+    }
+    return s;
+}
+
+/******************************************************************************/
+void IndexTrackReport(TaskStorage* tstor_p)
+{
+const OS_TaskHd bgserv_thd = OS_TaskByNameGet(APP_TASK_NAME_BGSERV);
+OS_Message* msg_p = OS_NULL;
+
+    //The check is BgServ's job: never block the playback on it.
+    if (OS_NULL != bgserv_thd) {
+        msg_p = MsgPoolCreate(OS_MSG_BGSERV_MEDIA_TRACK, sizeof(tstor_p->index_track), OS_NO_BLOCK, &tstor_p->index_track);
+    }
+    MediaIndexTrackAbort(&tstor_p->index_track); //Once per pass.
+    if (OS_NULL == msg_p) { return; }
+    IF_STATUS(OS_MessageSend(OS_TaskStdInGet(bgserv_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+        MsgPoolDelete(msg_p);
+    }
+}
+
+#if (OS_NETWORK_ENABLED)
+/******************************************************************************/
+Status NetSourceOpen(ConstStrP url_str_p)
+{
+const OS_TaskHd netserv_thd = OS_TaskByNameGet(APP_TASK_NAME_NETSERV);
+NetStreamOpenArgs* open_args_p;
+OS_Message* msg_p;
+Status s = S_UNDEF;
+
+    if (OS_NULL == netserv_thd) { return s = S_INVALID_PTR; }
+    if (APP_NET_STREAM_URL_LEN <= OS_StrLen(url_str_p)) { return s = S_INVALID_SIZE; }
+    msg_p = MsgPoolCreate(OS_MSG_NETSERV_STREAM_OPEN, sizeof(NetStreamOpenArgs), OS_BLOCK, OS_NULL);
+    if (OS_NULL == msg_p) { return s = S_OUT_OF_MEMORY; }
+    open_args_p = (NetStreamOpenArgs*)msg_p->data;
+    open_args_p->probe_qhd       = OS_TaskStdInGet(OS_THIS_TASK);
+    open_args_p->probe_signal_id = OS_SIG_MMPLAY_NET_PROBE;
+    OS_StrCpy(open_args_p->url_str, url_str_p);
+    IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(netserv_thd), msg_p, OS_BLOCK, OS_MSG_PRIO_NORMAL)) {
+        MsgPoolDelete(msg_p);
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status NetSourceProbeEnd(TaskStorage* tstor_p)
+{
+AudioFormatInfo* info_p = &tstor_p->audio_format_info;
+const OS_AudioInfo* audio_info_p = &info_p->audio_info;
+const U8* probe_p;
+Size probe_size;
+Status s = S_UNDEF;
+
+    //The probe buffer is NetServ's, but it is not touched till the next stream open.
+    IF_OK(s = NetStreamProbeGet(&probe_p, &probe_size)) {
+        IF_OK(s = AudioFormatInfoGet(tstor_p->file_path_str_p, (U8*)probe_p, probe_size, info_p)) {
+            tstor_p->net_skip_size = info_p->header_size;
+            if (AUDIO_FORMAT_WAV == info_p->format) {
+                NetStreamByteRateSet(audio_info_p->sample_rate * audio_info_p->channels * (audio_info_p->sample_bits / 8));
+            }
+            s = StreamOpen(tstor_p);
+        }
+    }
+    IF_STATUS(s) { NetSourceClose(); }
+    return s;
+}
+
+/******************************************************************************/
+Status NetSourceRead(TaskStorage* tstor_p, U8* data_p, const Size size)
+{
+const OS_AudioInfo* audio_info_p = &tstor_p->audio_format_info.audio_info;
+Size rd_size;
+
+    //Skip the stream format header.
+    while (0 != tstor_p->net_skip_size) {
+        rd_size = NetStreamRead(data_p, (tstor_p->net_skip_size < size) ? tstor_p->net_skip_size : size);
+        if (0 == rd_size) {
+            return (OS_TRUE == NetStreamIsEnd()) ? S_FS_EOF : S_MMPLAY_NO_DATA;
+        }
+        tstor_p->net_skip_size -= rd_size;
+    }
+    if (AUDIO_FORMAT_WAV == tstor_p->audio_format_info.format) {
+        //PCM: compensate the sender/receiver clock drift.
+        const Size frame_size = audio_info_p->channels * (audio_info_p->sample_bits / 8);
+        rd_size = NetStreamReadPcm(data_p, size / frame_size, frame_size) * frame_size;
+    } else {
+        rd_size = NetStreamRead(data_p, size);
+    }
+    if (0 == rd_size) {
+        return (OS_TRUE == NetStreamIsEnd()) ? S_FS_EOF : S_MMPLAY_NO_DATA;
+    }
+    if (rd_size < size) {
+        OS_MemSet(data_p + rd_size, 0, size - rd_size);
+    }
+    return S_OK;
+}
+
+/******************************************************************************/
+void NetSourceClose(void)
+{
+const OS_TaskHd netserv_thd = OS_TaskByNameGet(APP_TASK_NAME_NETSERV);
+    if (OS_NULL != netserv_thd) {
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_NETSERV_STREAM_CLOSE, 0);
+        IF_STATUS(OS_SignalSend(OS_TaskStdInGet(netserv_thd), signal, OS_MSG_PRIO_NORMAL)) {
+            OS_LOG_S(D_WARNING, S_INVALID_QUEUE);
+        }
+    }
+}
+#endif //(OS_NETWORK_ENABLED)
+
+/******************************************************************************/
+void AudioBufsRelease(TaskStorage* tstor_p)
+{
+    if (OS_NULL != tstor_p->audio_buf_in_p) {
+        IF_STATUS(AudioBufRelease(tstor_p->audio_buf_in_p)) { OS_LOG_S(D_WARNING, S_INVALID_PTR); }
+        tstor_p->audio_buf_in_p = OS_NULL;
+    }
+    if (OS_NULL != tstor_p->audio_buf_out_p) {
+        IF_STATUS(AudioBufRelease(tstor_p->audio_buf_out_p)) { OS_LOG_S(D_WARNING, S_INVALID_PTR); }
+        tstor_p->audio_buf_out_p = OS_NULL;
+    }
+}
+
 /******************************************************************************/
 void ISR_DrvAudioDeviceCallback(OS_AudioDeviceCallbackArgs* args_p)
 {
-const OS_Signal signal = OS_ISR_SignalCreate(OS_SIG_DRV, args_p->signal_id, 0);
-    if (1 == OS_ISR_SignalSend(args_p->slot_qhd, signal, OS_MSG_PRIO_NORMAL)) {
-        OS_ContextSwitchForce();
+    //Only the first event since the last drain wakes the task up.
+    if (OS_TRUE == SpscRingPut(&audio_events_ring, &args_p->signal_id)) {
+        const OS_Signal signal = OS_ISR_SignalCreate(OS_SIG_DRV, OS_SIG_MMPLAY_AUDIO_EVENTS, 0);
+        const Int res = OS_ISR_SignalSend(args_p->slot_qhd, signal, OS_MSG_PRIO_NORMAL);
+        if (0 > res) {
+            //Full queue: the next event retries the wakeup.
+            SpscRingNotifyCancel(&audio_events_ring);
+        } else if (1 == res) {
+            OS_ContextSwitchForce();
+        }
+    }
+}
+
+/******************************************************************************/
+Status MMPlayCommandsInit(void)
+{
+    return SpscRingInit(&commands_ring, commands_v, sizeof(MMPlayCommand), COMMANDS_COUNT);
+}
+
+/******************************************************************************/
+Status MMPlayCommandPost(const MMPlayCommand* cmd_p)
+{
+const OS_TaskHd mmplay_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY);
+const U32 overflows = commands_ring.overflows;
+    if (OS_NULL == cmd_p) { return S_INVALID_PTR; }
+    if (OS_NULL == mmplay_thd) { return S_INVALID_STATE; }
+    if (OS_TRUE == SpscRingPut(&commands_ring, cmd_p)) {
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_MMPLAY_CTL, 0);
+        const Status s = OS_SignalSend(OS_TaskStdInGet(mmplay_thd), signal, OS_MSG_PRIO_HIGH);
+        //The command stays queued: the next post retries the wakeup.
+        IF_STATUS(s) { SpscRingNotifyCancel(&commands_ring); }
+        return s;
     }
+    return (overflows != commands_ring.overflows) ? S_INVALID_QUEUE : S_OK;
+}
+
+/******************************************************************************/
+Status MMPlayAudioEventsStatsGet(SpscRingStats* stats_p)
+{
+    return SpscRingStatsGet(&audio_events_ring, stats_p);
 }
 
 #endif //(OS_AUDIO_ENABLED)
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "os_file_system.h"
 #include "os_audio.h"
 #include "audio_codec.h"
+#include "spsc_ring.h"
 
 #if (OS_AUDIO_ENABLED)
 //-----------------------------------------------------------------------------
@@ -20,13 +21,66 @@ enum {
     OS_SIG_MMPLAY_PAUSE,
     OS_SIG_MMPLAY_RESUME,
     OS_SIG_MMPLAY_STOP,
-    OS_SIG_MMPLAY_SEEK,
+    OS_SIG_MMPLAY_SEEK,                 // Command only (OS_MSG_MMPLAY_CTL_SEEK): position (ms); seekable streams only
+    OS_SIG_MMPLAY_AUDIO_EVENTS,         // Audio device events are queued.
+    OS_SIG_MMPLAY_CTL,                  // Control commands are queued.
+    OS_SIG_MMPLAY_AUDIO_OUT,            // Simulated audio output next buffer event.
+    OS_SIG_MMPLAY_NET_PROBE,            // Network stream head is buffered (or the stream has failed).
+    OS_SIG_MMPLAY_RTP_SINK,             // RTP sink is started/stopped (RtpSinkSync()).
     OS_SIG_MMPLAY_LAST
 };
 
+typedef enum {
+    MMPLAY_STATE_UNDEF,
+    MMPLAY_STATE_PLAY,
+    MMPLAY_STATE_PAUSE,
+    MMPLAY_STATE_STOP,
+    MMPLAY_STATE_LAST
+} MMPlayState;
+
+typedef struct {
+    U8              state;              // #MMPlayState
+    U32             decode_count;
+    U32             decode_time_last_ms;
+    U32             decode_time_max_ms;
+    U32             underruns;
+    U32             dma_late;           // Output refills done after the DMA reached them.
+    U32             commands;
+    U32             ctl_latency_last_ms;// Command receipt (MMPlayCtl) to effect.
+    U32             ctl_latency_max_ms;
+    Bool            is_seekable;        // Constant byte rate file (WAV) is open.
+} MMPlayStats;
+
+// Control command (MMPlayCtl -> player).
+typedef struct {
+    OS_SignalId     id;                 // OS_SIG_MMPLAY_PLAY..OS_SIG_MMPLAY_SEEK
+    U32             data;
+    OS_Tick         tick;               // Receipt time.
+} MMPlayCommand;
+
 extern OS_TaskConfig task_mmplay_cfg;
 extern ConstStrP mmplay_file_path_str_p;
 
+//-----------------------------------------------------------------------------
+/// @brief      Get player statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MMPlayStatsGet(MMPlayStats* stats_p);
+
+/// @brief      Init player control commands ring.
+/// @return     #Status.
+Status          MMPlayCommandsInit(void);
+
+/// @brief      Post a control command to the player (single producer: MMPlayCtl).
+/// @param[in]  cmd_p          Command.
+/// @return     #Status.
+Status          MMPlayCommandPost(const MMPlayCommand* cmd_p);
+
+/// @brief      Get audio device events ring statistics.
+/// @param[out] stats_p        Statistics.
+/// @return     #Status.
+Status          MMPlayAudioEventsStatsGet(SpscRingStats* stats_p);
+
 #endif //(OS_AUDIO_ENABLED)
 
 #endif // _TASK_MMPLAY_H_
\ No newline at end of file
@@ -0,0 +1,168 @@
+/***************************************************************************//**
+* @file    task_mmplay_ctl.c
+* @brief   Multimedia player control task.
+* @author  A. Filyanov
+* @details Runs above the player task, so a control request is taken at once
+*          and the player applies it at its next wakeup (within a buffer
+*          period) while the audio events are still drained in order.
+*******************************************************************************/
+#include "os_time.h"
+#include "app_common.h"
+#include "boot_timeline.h"
+#include "msg_pool.h"
+#include "task_mmplay.h"
+#include "task_mmplay_ctl.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define MDL_NAME            "task_mmplay_ctl"
+
+//-----------------------------------------------------------------------------
+//Task arguments
+typedef struct {
+    Str             path[APP_MMPLAY_CTL_PATH_LEN]; // Player task argument.
+} TaskStorage;
+
+//------------------------------------------------------------------------------
+static Status   PlayerOpen(TaskStorage* tstor_p, ConstStrP path_str_p, const Size size);
+
+//------------------------------------------------------------------------------
+const OS_TaskConfig task_mmplay_ctl_cfg = {
+    .name           = APP_TASK_NAME_MMPLAY_CTL,
+    .func_main      = OS_TaskMain,
+    .func_power     = OS_TaskPower,
+    .args_p         = OS_NULL,
+    .attrs          = BIT(OS_TASK_ATTR_SINGLE),
+    .timeout        = 1,
+    .prio_init      = APP_PRIO_TASK_MMPLAY_CTL,
+    .prio_power     = APP_PRIO_PWR_TASK_MMPLAY_CTL,
+    .storage_size   = sizeof(TaskStorage),
+    .stack_size     = OS_STACK_SIZE_MIN,
+    .stdin_len      = OS_STDIN_LEN
+};
+
+/******************************************************************************/
+Status OS_TaskInit(OS_TaskArgs* args_p)
+{
+TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
+    OS_LOG(D_INFO, "Init");
+    tstor_p->path[0] = '\0';
+    return MMPlayCommandsInit();
+}
+
+/******************************************************************************/
+void OS_TaskMain(OS_TaskArgs* args_p)
+{
+TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
+OS_Message* msg_p;
+const OS_QueueHd stdin_qhd = OS_TaskStdInGet(OS_THIS_TASK);
+Status s = S_UNDEF;
+
+    BootMark(APP_TASK_NAME_MMPLAY_CTL);
+	for(;;) {
+        IF_STATUS(OS_MessageReceive(stdin_qhd, &msg_p, OS_BLOCK)) {
+            //OS_LOG_S(D_WARNING, S_UNDEF_MSG);
+        } else {
+            if (OS_SignalIs(msg_p)) {
+                switch (OS_SignalIdGet(msg_p)) {
+                    case OS_SIG_MMPLAY_PLAY:
+                    case OS_SIG_MMPLAY_PAUSE:
+                    case OS_SIG_MMPLAY_RESUME:
+                    case OS_SIG_MMPLAY_STOP: {
+                        //Latency is measured from here.
+                        const MMPlayCommand cmd = {
+                            .id     = OS_SignalIdGet(msg_p),
+                            .data   = OS_SignalDataGet(msg_p),
+                            .tick   = OS_TickCountGet()
+                        };
+                        s = MMPlayCommandPost(&cmd);
+                        }
+                        break;
+                    default:
+                        s = S_INVALID_SIGNAL;
+                        break;
+                }
+            } else {
+                switch (msg_p->id) {
+                    case OS_MSG_MMPLAY_CTL_OPEN:
+                        s = PlayerOpen(tstor_p, (ConstStrP)msg_p->data, msg_p->size);
+                        break;
+                    case OS_MSG_MMPLAY_CTL_SEEK: {
+                        MMPlayCommand cmd = {
+                            .id     = OS_SIG_MMPLAY_SEEK,
+                            .tick   = OS_TickCountGet()
+                        };
+                        if (sizeof(cmd.data) != msg_p->size) {
+                            s = S_INVALID_SIZE;
+                        } else {
+                            OS_MemCpy(&cmd.data, msg_p->data, sizeof(cmd.data));
+                            s = MMPlayCommandPost(&cmd);
+                        }
+                        }
+                        break;
+                    default:
+                        s = S_INVALID_MESSAGE;
+                        break;
+                }
+                MsgPoolDelete(msg_p); // free message allocated memory
+            }
+            IF_STATUS(s) { OS_LOG_S(D_WARNING, s); }
+        }
+    }
+}
+
+/******************************************************************************/
+Status OS_TaskPower(OS_TaskArgs* args_p, const OS_PowerState state)
+{
+Status s = S_UNDEF;
+    switch (state) {
+        case PWR_STARTUP:
+            IF_STATUS(s = OS_TaskInit(args_p)) {
+            }
+            break;
+        case PWR_ON:
+        case PWR_STOP:
+        case PWR_SHUTDOWN:
+            s = S_OK;
+            break;
+        default:
+            break;
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status PlayerOpen(TaskStorage* tstor_p, ConstStrP path_str_p, const Size size)
+{
+OS_TaskHd mmplay_thd = OS_NULL;
+Status s = S_UNDEF;
+    if ((0 == size) || (sizeof(tstor_p->path) < size)) { return S_INVALID_SIZE; }
+    //The path is in use by the running player.
+    if (OS_NULL != OS_TaskByNameGet(APP_TASK_NAME_MMPLAY)) { return S_INVALID_STATE; }
+    OS_MemCpy(tstor_p->path, path_str_p, size);
+    tstor_p->path[size - 1] = '\0';
+    IF_OK(s = OS_TaskCreate(tstor_p->path, &task_mmplay_cfg, &mmplay_thd)) {
+        if (OS_NULL == OS_TaskStdInGet(mmplay_thd)) {
+            OS_TaskDelete(mmplay_thd);
+            s = S_INVALID_QUEUE;
+        }
+    }
+    return s;
+}
+
+/******************************************************************************/
+Status MMPlayCtlSeek(const U32 position_ms)
+{
+const OS_TaskHd mmplay_ctl_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY_CTL);
+OS_Message* msg_p;
+Status s;
+    if (OS_NULL == mmplay_ctl_thd) { return S_INVALID_STATE; }
+    msg_p = MsgPoolCreate(OS_MSG_MMPLAY_CTL_SEEK, sizeof(position_ms), OS_NO_BLOCK, &position_ms);
+    if (OS_NULL == msg_p) { return S_OUT_OF_MEMORY; }
+    IF_STATUS(s = OS_MessageSend(OS_TaskStdInGet(mmplay_ctl_thd), msg_p, OS_NO_BLOCK, OS_MSG_PRIO_NORMAL)) {
+        MsgPoolDelete(msg_p);
+    }
+    return s;
+}
+
+#endif //(OS_AUDIO_ENABLED)
@@ -0,0 +1,35 @@
+/***************************************************************************//**
+* @file    task_mmplay_ctl.h
+* @brief   Multimedia player control task.
+* @author  A. Filyanov
+* @details Front-end of the player: takes the control requests (shell, network
+*          control) and starts the player task or passes them to it as
+*          #MMPlayCommand. Player signals (OS_SIG_MMPLAY_PLAY..STOP) are
+*          accepted as the control requests; the seek position doesn't fit
+*          the signal data, so the seek is OS_MSG_MMPLAY_CTL_SEEK.
+*******************************************************************************/
+#ifndef _TASK_MMPLAY_CTL_H_
+#define _TASK_MMPLAY_CTL_H_
+
+#include "os_common.h"
+
+#if (OS_AUDIO_ENABLED)
+//-----------------------------------------------------------------------------
+#define APP_TASK_NAME_MMPLAY_CTL "MMPlayCtl"
+
+enum {
+    OS_MSG_MMPLAY_CTL_UNDEF = OS_MSG_APP,
+    OS_MSG_MMPLAY_CTL_OPEN,             // data: file path/URL string
+    OS_MSG_MMPLAY_CTL_SEEK,             // data: U32 position (ms)
+    OS_MSG_MMPLAY_CTL_LAST
+};
+
+//-----------------------------------------------------------------------------
+/// @brief      Request the player seek.
+/// @param[in]  position_ms    Position (ms).
+/// @return     #Status.
+Status          MMPlayCtlSeek(const U32 position_ms);
+
+#endif //(OS_AUDIO_ENABLED)
+
+#endif //_TASK_MMPLAY_CTL_H_
@@ -3,7 +3,15 @@
 * @brief
 * @author
 *******************************************************************************/
+#include "os_time.h"
 #include "app_common.h"
+#include "boot_timeline.h"
+#include "msg_pool.h"
+#include "net_stream.h"
+#include "net_ctrl.h"
+#include "net_file.h"
+#include "rtp_sink.h"
+#include "task_mmplay.h"
 #include "task_netserv.h"
 
 //-----------------------------------------------------------------------------
@@ -15,9 +23,14 @@ typedef struct {
     void* args_p;
 } TaskStorage;
 
+//-----------------------------------------------------------------------------
+#if (OS_NETWORK_ENABLED)
+static void     RtpSinkPlayerNotify(void);
+#endif //(OS_NETWORK_ENABLED)
+
 //------------------------------------------------------------------------------
 const OS_TaskConfig task_netserv_cfg = {
-    .name           = "NetServ",
+    .name           = APP_TASK_NAME_NETSERV,
     .func_main      = OS_TaskMain,
     .func_power     = OS_TaskPower,
     .args_p         = OS_NULL,
@@ -26,8 +39,8 @@ const OS_TaskConfig task_netserv_cfg = {
     .prio_init      = APP_PRIO_TASK_NETSERV,
     .prio_power     = APP_PRIO_PWR_TASK_NETSERV,
     .storage_size   = sizeof(TaskStorage),
-    .stack_size     = OS_STACK_SIZE_MIN,
-    .stdin_len      = 1
+    .stack_size     = OS_STACK_SIZE_MIN * 2,
+    .stdin_len      = OS_STDIN_LEN
 };
 
 /******************************************************************************/
@@ -36,7 +49,14 @@ Status OS_TaskInit(OS_TaskArgs* args_p)
 TaskStorage* tstor_p = (TaskStorage*)args_p->stor_p;
 Status s = S_UNDEF;
     OS_LOG(D_INFO, "Init");
-s = S_OK;
+#if (OS_NETWORK_ENABLED)
+    IF_STATUS(s = NetStreamInit()) { OS_LOG_S(D_WARNING, s); }
+    IF_STATUS(s = NetCtrlInit()) { OS_LOG_S(D_WARNING, s); }
+    IF_STATUS(s = NetFileInit()) { OS_LOG_S(D_WARNING, s); }
+    IF_STATUS(s = RtpSinkInit()) { OS_LOG_S(D_WARNING, s); }
+#else
+    s = S_OK;
+#endif //(OS_NETWORK_ENABLED)
     return s;
 }
 
@@ -48,25 +68,74 @@ OS_Message* msg_p;
 const OS_QueueHd stdin_qhd = OS_TaskStdInGet(OS_THIS_TASK);
 Status s = S_UNDEF;
 
+    BootMark(APP_TASK_NAME_NETSERV);
 	for(;;) {
-        IF_STATUS(OS_MessageReceive(stdin_qhd, &msg_p, OS_BLOCK)) {
-            OS_LOG_S(D_WARNING, S_INVALID_MESSAGE);
+#if (OS_NETWORK_ENABLED)
+        //Poll the sockets while they are active, sleep on the queue otherwise.
+        const NetStreamState stream_state = NetStreamStateGet();
+        OS_TimeMs timeout = ((NET_STREAM_STATE_CONNECTING == stream_state) ||
+                             (NET_STREAM_STATE_HEADERS    == stream_state) ||
+                             (NET_STREAM_STATE_STREAMING  == stream_state) ||
+                             (OS_TRUE == NetStreamIsProbing())) ? APP_NETSERV_POLL_PERIOD : OS_BLOCK;
+        if (timeout > NetCtrlPollPeriodGet()) { timeout = NetCtrlPollPeriodGet(); }
+        if (timeout > NetFilePollPeriodGet()) { timeout = NetFilePollPeriodGet(); }
+        if ((OS_TRUE == RtpSinkIsStarted()) && (timeout > APP_RTP_SINK_POLL_PERIOD)) { timeout = APP_RTP_SINK_POLL_PERIOD; }
+#else
+        const OS_TimeMs timeout = OS_BLOCK;
+#endif //(OS_NETWORK_ENABLED)
+        IF_STATUS(s = OS_MessageReceive(stdin_qhd, &msg_p, timeout)) {
+            if (OS_BLOCK == timeout) {
+                OS_LOG_S(D_WARNING, S_INVALID_MESSAGE);
+            }
         } else {
             if (OS_SignalIs(msg_p)) {
                 switch (OS_SignalIdGet(msg_p)) {
+#if (OS_NETWORK_ENABLED)
+                    case OS_SIG_NETSERV_STREAM_CLOSE:
+                        IF_STATUS(s = NetStreamClose()) { OS_LOG_S(D_WARNING, s); }
+                        break;
+                    case OS_SIG_NETSERV_RTP_SINK_STOP:
+                        IF_STATUS(s = RtpSinkStop()) { OS_LOG_S(D_WARNING, s); }
+                        RtpSinkPlayerNotify();
+                        break;
+#endif //(OS_NETWORK_ENABLED)
                     default:
                         OS_LOG_S(D_DEBUG, S_INVALID_SIGNAL);
                         break;
                 }
             } else {
                 switch (msg_p->id) {
+#if (OS_NETWORK_ENABLED)
+                    case OS_MSG_NETSERV_STREAM_OPEN:
+                        s = NetStreamOpen((const NetStreamOpenArgs*)msg_p->data);
+                        break;
+                    case OS_MSG_NETSERV_RTP_SINK_START:
+                        IF_STATUS(s = RtpSinkStart((const RtpSinkConfig*)msg_p->data)) { OS_LOG_S(D_WARNING, s); }
+                        RtpSinkPlayerNotify();
+                        break;
+#endif //(OS_NETWORK_ENABLED)
                     default:
                         OS_LOG_S(D_DEBUG, S_INVALID_MESSAGE);
                         break;
                 }
-                OS_MessageDelete(msg_p); // free message allocated memory
+                MsgPoolDelete(msg_p); // free message allocated memory
             }
         }
+#if (OS_NETWORK_ENABLED)
+        const OS_TimeMs now_ms = OS_TICKS_TO_MS(OS_TickCountGet());
+        IF_STATUS(s = NetStreamReceive(now_ms)) {
+            OS_LOG_S(D_WARNING, s);
+        }
+        IF_STATUS(s = NetCtrlPoll(now_ms)) {
+            OS_LOG_S(D_WARNING, s);
+        }
+        IF_STATUS(s = NetFilePoll(now_ms)) {
+            OS_LOG_S(D_WARNING, s);
+        }
+        IF_STATUS(s = RtpSinkPoll(now_ms)) {
+            OS_LOG_S(D_WARNING, s);
+        }
+#endif //(OS_NETWORK_ENABLED)
     }
 }
 
@@ -86,10 +155,33 @@ Status s = S_UNDEF;
             s = S_OK;
             break;
         case PWR_SHUTDOWN:
+#if (OS_NETWORK_ENABLED)
+            RtpSinkStop();
+            s = NetStreamClose();
+#else
             s = S_OK;
+#endif //(OS_NETWORK_ENABLED)
             break;
         default:
             break;
     }
     return s;
 }
+
+#if (OS_NETWORK_ENABLED)
+/******************************************************************************/
+void RtpSinkPlayerNotify(void)
+{
+#if (OS_AUDIO_ENABLED)
+const OS_TaskHd mmplay_thd = OS_TaskByNameGet(APP_TASK_NAME_MMPLAY);
+    //The player owns the packet being filled: it takes the change over itself.
+    //No player - the next one takes it on the stream format set.
+    if (OS_NULL != mmplay_thd) {
+        const OS_Signal signal = OS_SignalCreate(OS_SIG_MMPLAY_RTP_SINK, 0);
+        IF_STATUS(OS_SignalSend(OS_TaskStdInGet(mmplay_thd), signal, OS_MSG_PRIO_NORMAL)) {
+            OS_LOG_S(D_WARNING, S_INVALID_QUEUE);
+        }
+    }
+#endif //(OS_AUDIO_ENABLED)
+}
+#endif //(OS_NETWORK_ENABLED)
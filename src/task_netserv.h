@@ -6,4 +6,23 @@
 #ifndef _TASK_NETSERV_H_
 #define _TASK_NETSERV_H_
 
-#endif //_TASK_NETSERV_H_
\ No newline at end of file
+#include "os_common.h"
+
+//-----------------------------------------------------------------------------
+#define APP_TASK_NAME_NETSERV   "NetServ"
+
+enum {
+    OS_MSG_NETSERV_UNDEF = OS_MSG_APP,
+    OS_MSG_NETSERV_STREAM_OPEN,         // data: NetStreamOpenArgs
+    OS_MSG_NETSERV_RTP_SINK_START,      // data: RtpSinkConfig
+    OS_MSG_NETSERV_LAST
+};
+
+enum {
+    OS_SIG_NETSERV_UNDEF = OS_SIG_APP,
+    OS_SIG_NETSERV_STREAM_CLOSE,
+    OS_SIG_NETSERV_RTP_SINK_STOP,
+    OS_SIG_NETSERV_LAST
+};
+
+#endif //_TASK_NETSERV_H_
@@ -0,0 +1,123 @@
+/***************************************************************************//**
+* @file    usb_hid_coalesce.c
+* @brief   USB HID input coalescing.
+* @author  A. Filyanov
+*******************************************************************************/
+#include "usb_hid_coalesce.h"
+
+//-----------------------------------------------------------------------------
+#define DELTA_MAX               0x7FFF
+#define DELTA_MIN               (-0x8000)
+#define DELTA_SATURATE(v)       (((v) > DELTA_MAX) ? DELTA_MAX : (((v) < DELTA_MIN) ? DELTA_MIN : (v)))
+
+/*****************************************************************************/
+void UsbHidMouseCoalesceInit(UsbHidMouseCoalescer* coalescer_p, const U8 buttons_bm)
+{
+    coalescer_p->x          = 0;
+    coalescer_p->y          = 0;
+    coalescer_p->buttons_bm = buttons_bm;
+    coalescer_p->is_pending = OS_FALSE;
+    coalescer_p->is_edge    = OS_FALSE;
+}
+
+/*****************************************************************************/
+Bool UsbHidMouseCoalesce(UsbHidMouseCoalescer* coalescer_p, const OS_UsbHidMouseData* report_p)
+{
+const Bool is_edge = (coalescer_p->buttons_bm != report_p->buttons_bm);
+    //One transition per delivery.
+    if ((OS_TRUE == is_edge) && (OS_TRUE == coalescer_p->is_pending)) { return OS_FALSE; }
+    coalescer_p->x         += report_p->x;
+    coalescer_p->y         += report_p->y;
+    coalescer_p->buttons_bm = report_p->buttons_bm;
+    coalescer_p->is_edge   |= is_edge;
+    coalescer_p->is_pending = OS_TRUE;
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Bool UsbHidMouseTake(UsbHidMouseCoalescer* coalescer_p, OS_UsbHidMouseData* report_p)
+{
+    if (OS_TRUE != coalescer_p->is_pending) { return OS_FALSE; }
+    report_p->x             = DELTA_SATURATE(coalescer_p->x);
+    report_p->y             = DELTA_SATURATE(coalescer_p->y);
+    report_p->buttons_bm    = coalescer_p->buttons_bm;
+    //Saturated rest is kept for the next delivery.
+    coalescer_p->x         -= report_p->x;
+    coalescer_p->y         -= report_p->y;
+    coalescer_p->is_edge    = OS_FALSE;
+    coalescer_p->is_pending = ((0 != coalescer_p->x) || (0 != coalescer_p->y));
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+void UsbHidMousePendingInit(UsbHidMousePending* pending_p, const U8 buttons_bm)
+{
+    pending_p->head         = 0;
+    pending_p->count        = 0;
+    pending_p->buttons_bm   = buttons_bm;
+    pending_p->is_notified  = OS_FALSE;
+    pending_p->overflows    = 0;
+}
+
+/*****************************************************************************/
+Bool UsbHidMousePendingPut(UsbHidMousePending* pending_p, const OS_UsbHidMouseData* report_p)
+{
+UsbHidMouseCoalescer* last_p;
+
+    if (0 == pending_p->count) {
+        UsbHidMouseCoalesceInit(&pending_p->states_v[pending_p->head], pending_p->buttons_bm);
+        pending_p->count = 1;
+    }
+    last_p = &pending_p->states_v[(pending_p->head + pending_p->count - 1) % USB_HID_MOUSE_STATES];
+    if (OS_TRUE != UsbHidMouseCoalesce(last_p, report_p)) {
+        if (USB_HID_MOUSE_STATES > pending_p->count) {
+            //Transition starts the next state.
+            UsbHidMouseCoalescer* next_p = &pending_p->states_v[(pending_p->head + pending_p->count) % USB_HID_MOUSE_STATES];
+            UsbHidMouseCoalesceInit(next_p, last_p->buttons_bm);
+            ++pending_p->count;
+            last_p = next_p;
+        } else {
+            //Full: the transition is merged into the last state.
+            last_p->is_pending = OS_FALSE;
+            ++pending_p->overflows;
+        }
+        UsbHidMouseCoalesce(last_p, report_p);
+    }
+    pending_p->buttons_bm = report_p->buttons_bm;
+    if (OS_TRUE == pending_p->is_notified) { return OS_FALSE; }
+    pending_p->is_notified = OS_TRUE;
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Bool UsbHidMousePendingTake(UsbHidMousePending* pending_p, OS_UsbHidMouseData* report_p)
+{
+UsbHidMouseCoalescer* first_p = &pending_p->states_v[pending_p->head];
+
+    if (0 == pending_p->count) {
+        pending_p->is_notified = OS_FALSE;
+        return OS_FALSE;
+    }
+    UsbHidMouseTake(first_p, report_p);
+    //Saturated rest keeps the state.
+    if (OS_TRUE != first_p->is_pending) {
+        pending_p->head = (pending_p->head + 1) % USB_HID_MOUSE_STATES;
+        --pending_p->count;
+    }
+    //Next report wakes the consumer up.
+    if (0 == pending_p->count) { pending_p->is_notified = OS_FALSE; }
+    return OS_TRUE;
+}
+
+/*****************************************************************************/
+Bool UsbHidMousePendingIsEdge(const UsbHidMousePending* pending_p)
+{
+    return ((1 < pending_p->count) ||
+            ((1 == pending_p->count) && (OS_TRUE == pending_p->states_v[pending_p->head].is_edge)));
+}
+
+/*****************************************************************************/
+void UsbHidMousePendingNotifyCancel(UsbHidMousePending* pending_p)
+{
+    pending_p->is_notified = OS_FALSE;
+}
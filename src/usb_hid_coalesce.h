@@ -0,0 +1,95 @@
+/***************************************************************************//**
+* @file    usb_hid_coalesce.h
+* @brief   USB HID input coalescing.
+* @author  A. Filyanov
+* @details Mouse reports are merged into a single pending state: x/y deltas
+*          are summed, the buttons state is taken as is. A report that changes
+*          the buttons of the pending state is refused, so the pending state
+*          is delivered first and no button transition is lost.
+*          A device pending record is a short FIFO of such states filled by
+*          the producer (driver): motion merges into the last state and a
+*          buttons transition starts the next one. The consumer is woken up
+*          only on the empty -> pending transition and takes the states at
+*          its own delivery rate, so its queue holds no per-report messages.
+*******************************************************************************/
+#ifndef _USB_HID_COALESCE_H_
+#define _USB_HID_COALESCE_H_
+
+#include "os_common.h"
+#include "drv_usb.h"
+
+//-----------------------------------------------------------------------------
+#define USB_HID_MOUSE_STATES    4       // Pending states (buttons transitions) per device.
+
+typedef struct {
+    S32             x;
+    S32             y;
+    U8              buttons_bm;
+    Bool            is_pending;
+    Bool            is_edge;            // Pending state has a buttons transition.
+} UsbHidMouseCoalescer;
+
+typedef struct {
+    UsbHidMouseCoalescer states_v[USB_HID_MOUSE_STATES]; // FIFO; motion merges into the last one.
+    U8              head;
+    U8              count;
+    U8              buttons_bm;         // Last report buttons.
+    Bool            is_notified;        // Set by the producer, cleared by the consumer.
+    U32             overflows;          // Transitions merged into a full FIFO.
+} UsbHidMousePending;
+
+typedef struct {
+    U32             reports;
+    U32             wakeups;            // Consumer wakeups (empty -> pending transitions).
+    U32             deliveries;
+    U32             edges;
+    U32             overflows;
+    U16             states_max;         // Device pending states.
+    U32             busy_ms;            // Consumer delivery time.
+} UsbHidStats;
+
+//-----------------------------------------------------------------------------
+/// @brief      Init mouse coalescer.
+/// @param[out] coalescer_p    Coalescer.
+/// @param[in]  buttons_bm     Current buttons state.
+void            UsbHidMouseCoalesceInit(UsbHidMouseCoalescer* coalescer_p, const U8 buttons_bm);
+
+/// @brief      Merge the report into the pending state.
+/// @param[in]  coalescer_p    Coalescer.
+/// @param[in]  report_p       Report.
+/// @return     Merged (OS_FALSE - deliver the pending state first).
+Bool            UsbHidMouseCoalesce(UsbHidMouseCoalescer* coalescer_p, const OS_UsbHidMouseData* report_p);
+
+/// @brief      Take the pending state.
+/// @param[in]  coalescer_p    Coalescer.
+/// @param[out] report_p       Merged report (deltas are saturated).
+/// @return     State was pending.
+Bool            UsbHidMouseTake(UsbHidMouseCoalescer* coalescer_p, OS_UsbHidMouseData* report_p);
+
+/// @brief      Init device pending states.
+/// @param[out] pending_p      Pending states.
+/// @param[in]  buttons_bm     Current buttons state.
+void            UsbHidMousePendingInit(UsbHidMousePending* pending_p, const U8 buttons_bm);
+
+/// @brief      Merge the report into the device pending states (producer).
+/// @param[in]  pending_p      Pending states.
+/// @param[in]  report_p       Report.
+/// @return     Consumer wakeup is needed.
+Bool            UsbHidMousePendingPut(UsbHidMousePending* pending_p, const OS_UsbHidMouseData* report_p);
+
+/// @brief      Take the first pending state (consumer).
+/// @param[in]  pending_p      Pending states.
+/// @param[out] report_p       Merged report (deltas are saturated).
+/// @return     State was pending.
+Bool            UsbHidMousePendingTake(UsbHidMousePending* pending_p, OS_UsbHidMouseData* report_p);
+
+/// @brief      Check for a pending buttons transition.
+/// @param[in]  pending_p      Pending states.
+/// @return     Transition is pending.
+Bool            UsbHidMousePendingIsEdge(const UsbHidMousePending* pending_p);
+
+/// @brief      Re-arm the consumer wakeup after its send has failed (producer).
+/// @param[in]  pending_p      Pending states.
+void            UsbHidMousePendingNotifyCancel(UsbHidMousePending* pending_p);
+
+#endif // _USB_HID_COALESCE_H_